@@ -65,6 +65,7 @@
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
+#include "Rinex3ObsEditor.hpp"
 
 //------------------------------------------------------------------------------
 using namespace std;
@@ -84,64 +85,8 @@ string version(string("2.4 9/23/15 rev"));
 // END TD
 
 //------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-// class to encapsulate editing commands
-class EditCmd
-{
-public:
-   enum CmdType
-   {
-      invalidCT=0,
-      ofCT,
-      daCT,
-      doCT,
-      dsCT,
-      ddCT,
-      sdCT,
-      ssCT,
-      slCT,
-      bdCT,
-      bsCT,
-      blCT,
-      bzCT,
-      countCT
-   };
-   CmdType type;     // the type of this command
-   RinexSatID sat;   // satellite
-   RinexObsID obs;   // observation type
-   CommonTime ttag;  // associated time tag
-   int sign;         // sign +1,0,-1 meaning start, one-time, stop
-   int idata;        // integer e.g. SSI or LLI
-   double data;      // data e.g. bias value
-   string field;     // OF file name
-
-   EditCmd(void) : type(invalidCT) {}       // default constructor
-   ~EditCmd(void) {}                      // destructor
-
-      /** constructor from strings, i.e. parser e.g. "DA+","t" or
-       * "BDp","SV,OT,t,s" */
-   EditCmd(const string typestr, const string arg) throw(Exception);
-      /// parse time from string
-   bool parseTime(const string arg, CommonTime& ttag) throw();
-
-      /// is it valid?
-   inline bool isValid(void) throw()
-   { return (type != invalidCT); }
-
-      /// dump, with optional message at front
-   string asString(string msg=string())
-      throw(Exception);
-
-}; // end class EditCmd
-
-
-// used for sorting
-class EditCmdLessThan
-{
-public:
-   bool operator()(const EditCmd& ec1, const EditCmd& ec2)
-   { return (ec1.ttag < ec2.ttag); }
-};
+// editing commands
+typedef Rinex3ObsEditor::EditCmd EditCmd;
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -223,7 +168,7 @@ public:
    static const string calfmt,gpsfmt,longfmt;
 
       // handle commands
-   vector<EditCmd> vecCmds, currCmds;
+   Rinex3ObsEditor editor;
    Rinex3ObsStream ostrm;        // RINEX output
 
 }; // end class Configuration
@@ -238,13 +183,9 @@ const string Configuration::longfmt = calfmt + " = " + gpsfmt + " %P";
 //------------------------------------------------------------------------------
 // prototypes
 int initialize(string& errors) throw(Exception);
-void fixEditCmdList(void) throw();
 int processFiles(void) throw(Exception);
-int processOneEpoch(Rinex3ObsHeader& Rhead, Rinex3ObsHeader& RHout,
-                    Rinex3ObsData& Rdata, Rinex3ObsData& RDout)
-   throw(Exception);
-int executeEditCmd(const vector<EditCmd>::iterator& it, Rinex3ObsHeader& Rhead,
-                   Rinex3ObsData& Rdata) throw(Exception);
+bool openOutputFile(const EditCmd& cmd, Rinex3ObsHeader& Rhead,
+                    const Rinex3ObsData& Rdata) throw(Exception);
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -333,18 +274,24 @@ int initialize(string& errors) throw(Exception)
 
          // add path to all OF
          // also if first OF command has a timetag, remove it and make that the start time
-      for(j=0, i=0; i<C.vecCmds.size(); ++i) {
-         if(C.vecCmds[i].type == EditCmd::ofCT) {
-            if(j == 0 && C.vecCmds[i].ttag != CommonTime::BEGINNING_OF_TIME) {
-               if(C.beginTime < C.vecCmds[i].ttag)
-                  C.beginTime = C.vecCmds[i].ttag;
-               C.vecCmds[i].ttag = CommonTime::BEGINNING_OF_TIME;
+      vector<EditCmd>& cmds(C.editor.getCommands());
+      for(j=0, i=0; i<cmds.size(); ++i) {
+         if(cmds[i].type == EditCmd::ofCT) {
+            if(j == 0 && cmds[i].ttag != CommonTime::BEGINNING_OF_TIME) {
+               if(C.beginTime < cmds[i].ttag)
+                  C.beginTime = cmds[i].ttag;
+               cmds[i].ttag = CommonTime::BEGINNING_OF_TIME;
             }
             j++;
-            include_path(C.OutObspath, C.vecCmds[i].field);
-               //LOG(VERBOSE) << "Full output file name is " << C.vecCmds[i].field;
+            include_path(C.OutObspath, cmds[i].field);
+               //LOG(VERBOSE) << "Full output file name is " << cmds[i].field;
          }
       }
+         // re-sort, as the first OF now starts at the beginning
+      C.editor.compile();
+      C.editor.setTimeTolerance(C.timetol);
+      C.editor.setBiasZero(C.messBZ);
+      C.editor.setOutputFileHook(openOutputFile);
 
          // ------ compute and save a reference time for decimation
       if(C.decimate > 0.0) {
@@ -383,7 +330,6 @@ int processFiles(void) throw(Exception)
       C.endTime.setTimeSystem(TimeSystem::GPS);
       int iret,nfiles;
       size_t i,nfile;
-      string tag;
       RinexSatID sat;
       ostringstream oss;
 
@@ -393,8 +339,8 @@ int processFiles(void) throw(Exception)
       for(nfiles=0,nfile=0; nfile<C.messIF.size(); nfile++)
       {
          Rinex3ObsStream istrm;
-         Rinex3ObsHeader Rhead,RHout;  // use one header for input and output
-         Rinex3ObsData Rdata,RDout;
+         Rinex3ObsHeader Rhead;
+         Rinex3ObsData Rdata,Rin;
          string filename(C.messIF[nfile]);
 
             // iret is set to 0 ok, or could not: 1 open file, 2 read header, 3 read data
@@ -444,117 +390,10 @@ int processFiles(void) throw(Exception)
                oss << " " << kt->second[i].asString();
             LOG(INFO) << oss.str();
          }
-            // we have to set the time system of all the timetags using ttag from file
-         vector<EditCmd>::iterator jt;
-         for (jt=C.vecCmds.begin(); jt != C.vecCmds.end(); ++jt)
-            jt->ttag.setTimeSystem(Rhead.firstObs.getTimeSystem());
-            // -----------------------------------------------------------------
-            // generate output header from input header and DO,DS commands
-         bool mungeData(false);
-         map<string, map<int,int> > mapSysObsIDTranslate;
-
-         RHout = Rhead;
-         vector<EditCmd>::iterator it;
-         for (it = C.vecCmds.begin(); it != C.vecCmds.end(); it++)
-         {
-            LOG(DEBUG) << "Killing " << it->asString() << " " << it->sat;
-            
-               // DO delete obs without sign
-            if (it->type == EditCmd::doCT)
-            {
-                  // if the system is defined, delete only for that system
-               string sys(asString(it->sat.systemChar()));
-
-                  // loop over systems (short-circuit if sys is defined)
-               Rinex3ObsHeader::RinexObsMap::iterator jt;
-               for (jt=RHout.mapObsTypes.begin(); jt != RHout.mapObsTypes.end(); ++jt)
-               {
-                  if (sys != string("?") && sys != jt->first)
-                     continue;
-                  RinexObsID obsid(jt->first + it->obs.asString());
-
-                     // find the OT in the output header map, and delete it
-                  Rinex3ObsHeader::RinexObsVec::iterator kt;
-                  kt = find(jt->second.begin(), jt->second.end(), obsid);
-                  if(kt == jt->second.end())
-                     continue;
-                  jt->second.erase(kt);
-                     // flag the obs types have changed so the translations need to as well
-                  mungeData = true;
-               }
-            }
-
-               // DS delete sat without sign and without time
-            else if (it->type == EditCmd::dsCT && it->sign >= 0
-                    && it->ttag == CommonTime::BEGINNING_OF_TIME)
-            {
-               if (it->sat.id == -1)
-               {
-                     // Delete all satellites with this system
-                  Rinex3ObsHeader::PRNNumObsMap::iterator i,j;
-                  for (i = RHout.numObsForSat.begin(); i != RHout.numObsForSat.end();)
-                  {
-                     j = i++;
-                     if (j->first.system == it->sat.system)
-                        RHout.numObsForSat.erase(j);
-                  }
-                  if (it->sat.system == SatID::systemGlonass)
-                     RHout.glonassFreqNo.clear();
-
-                     // Remove obs types for that system
-                  string sys(asString(it->sat.systemChar()));
-                  RHout.mapObsTypes.erase(sys);
-               }
-               else
-               {
-                     // Just delete a single satellite if its there
-                  Rinex3ObsHeader::PRNNumObsMap::iterator jt = RHout.numObsForSat.find(it->sat);
-                  if (jt != RHout.numObsForSat.end())
-                     RHout.numObsForSat.erase(jt);
-                  
-                  Rinex3ObsHeader::GLOFreqNumMap::iterator kt = RHout.glonassFreqNo.find(it->sat);
-                  if (kt != RHout.glonassFreqNo.end())
-                     RHout.glonassFreqNo.erase(kt);
-               }
-            }
-         }  // end loop over edit commands
-
-            // if mapObsTypes has changed, must make a map of indexes for translation
-            // mapSysObsIDTranslate[sys][input index] = output index
-         if (mungeData)
-         {
-            map<string, vector<RinexObsID> >::iterator jt;
-            for(jt = Rhead.mapObsTypes.begin(); jt != Rhead.mapObsTypes.end(); ++jt)
-            {
-               string sys(jt->first);
-                  // TD what if entire sys is deleted? RHout[sys] does not exist
-               vector<RinexObsID>::iterator kt;
-               for(i=0; i < jt->second.size(); i++)
-               {
-                  kt = find(RHout.mapObsTypes[sys].begin(),
-                            RHout.mapObsTypes[sys].end(), jt->second[i]);
-                  mapSysObsIDTranslate[sys][i]
-                     = (kt == RHout.mapObsTypes[sys].end()
-                        ?  -1                                     // not found
-                        : (kt - RHout.mapObsTypes[sys].begin())); // output index
-               }
-            }
 
-               // dump it
-            if(C.debug > -1)
-            {
-               for(jt = Rhead.mapObsTypes.begin(); jt != Rhead.mapObsTypes.end(); ++jt)
-               {
-                  string sys(jt->first);
-                  oss.str("");
-                  oss << "Translation map for sys " << sys;
-                  for(i=0; i < jt->second.size(); i++)
-                     oss << " " << i << ":" << mapSysObsIDTranslate[sys][i];
-                  LOG(DEBUG) << oss.str();
-               }
-            }
-         }
-         
+            // generate output header from input header and DO,DS commands
+         C.editor.reset(Rhead);
+         Rinex3ObsHeader& RHout(C.editor.getHeader());
 
          if (C.outver2)
          {
@@ -566,7 +405,7 @@ int processFiles(void) throw(Exception)
             RHout.prepareVer2Write();
          }
          
-            // NB. header will be written by executeEditCmd
+            // NB. header will be written by openOutputFile
             // -----------------------------------------------------------------
          
          if (C.debug > -1)
@@ -631,40 +470,29 @@ int processFiles(void) throw(Exception)
                }
             }
 
-               // copy data to output
-            RDout = Rdata;
-            if (mungeData)
-            {
-                  // must edit RDout.obs
-               RDout.obs.clear();
-                  // loop over satellites -----------------------------
-               Rinex3ObsData::DataMap::const_iterator kt;
-               for (kt=Rdata.obs.begin(); kt!=Rdata.obs.end(); ++kt)
-               {
-                  sat = kt->first;
-                  string sys(string(1,sat.systemChar()));
-                  for (i=0; i<Rdata.obs[sat].size(); i++)
-                     if (mapSysObsIDTranslate[sys][i] > -1)
-                        RDout.obs[sat].push_back(Rdata.obs[sat][i]);
-               }  // end loop over sats
-            }
-            
+               // if aux header data, either output or skip
+            if (Rdata.epochFlag > 1 && C.messHDda)
+               continue;
+
+               // keep the input for the debug dump; data is edited in place
+            if (C.debug > -1)
+               Rin = Rdata;
+
                // apply editing commands, including open files, write out headers
-            iret = processOneEpoch(Rhead, RHout, Rdata, RDout);
+            iret = C.editor.edit(Rdata);
             if(iret < 0) break;
-            if(iret > 0) continue;
 
                // write data out
-            try { C.ostrm << RDout; }
+            try { C.ostrm << Rdata; }
             catch(Exception& e) { GPSTK_RETHROW(e); }
 
                // debug: dump the RINEX data objects input and output
             if (C.debug > -1)
             {
                LOG(DEBUG) << "INPUT data ---------------";
-               Rdata.dump(LOGstrm,Rhead);
+               Rin.dump(LOGstrm,Rhead);
                LOG(DEBUG) << "OUTPUT data ---------------";
-               RDout.dump(LOGstrm,Rhead);
+               Rdata.dump(LOGstrm,Rhead);
             }
 
          }  // end while loop over epochs
@@ -691,333 +519,85 @@ int processFiles(void) throw(Exception)
 }  // end processFiles()
 
 //------------------------------------------------------------------------------
-// return <0 fatal; >0 skip this epoch
-int processOneEpoch(Rinex3ObsHeader& Rhead, Rinex3ObsHeader& RHout,
-                    Rinex3ObsData& Rdata, Rinex3ObsData& RDout) throw(Exception)
-{
-   try
-   {
-      Configuration& C(Configuration::Instance());
-      int iret(0);
-      RinexSatID sat;
-      CommonTime now(Rdata.time);         // TD what if its aux data w/o an epoch?
-      
-         // if aux header data, either output or skip
-      if (RDout.epochFlag > 1)
-      {           // aux header data
-         if (C.messHDda)
-            return 1;
-         return 0;
-      }
-
-      else
-      {                              // regular data
-         vector<EditCmd>::iterator it, jt;
-         vector<EditCmd> toCurr;
-         
-            // for cmds with ttag <= now either execute and delete, or move to current
-         it = C.vecCmds.begin();
-         while(it != C.vecCmds.end())
-         {
-            if (it->ttag <= now || ::fabs(it->ttag - now) < C.timetol)
-            {
-               LOG(DEBUG) << "Execute vec cmd " << it->asString();
-                  // delete one-time cmds, move others to curr and delete
-               iret = executeEditCmd(it, RHout, RDout);
-               if(iret < 0) return iret;              // fatal error
-
-                  // keep this command on the current list
-               if (iret > 0) toCurr.push_back(*it); // C.currCmds.push_back(*it);
-
-                  // if this is a '-' cmd to be deleted, find matching '+' and delete
-                  // note fixEditCmdList() forced every - to have a corresponding +
-               if (iret == 0 && it->sign == -1)
-               {
-                  for (jt = C.currCmds.begin(); jt != C.currCmds.end(); ++jt)
-                     if (jt->type==it->type && jt->sat==it->sat && jt->obs==it->obs)
-                        break;
-                  if (jt == C.currCmds.end())
-                  {
-                     Exception e(string("Execute failed to find + cmd matching ")+it->asString());
-                     GPSTK_THROW(e);
-                  }
-                  C.currCmds.erase(jt);
-               }
-
-                  // remove from vecCmds
-               it = C.vecCmds.erase(it);              // erase vector element
-            }
-            else
-               ++it;
-         }
-      
-            // apply current commands, deleting obsolete ones
-         it = C.currCmds.begin();
-         while(it != C.currCmds.end())
-         {
-            LOG(DEBUG) << "Execute current cmd " << it->asString();
-               // execute command; delete obsolete commands
-            iret = executeEditCmd(it, RHout, RDout);
-            if(iret < 0)
-               return iret;
-
-            if(iret == 0)
-               it = C.currCmds.erase(it);              // erase vector element
-            else
-               ++it;
-         }
-
-         for (it = toCurr.begin(); it != toCurr.end(); ++it)
-            C.currCmds.push_back(*it);
-      }
-
-      return 0;
-   }
-   catch(Exception& e) { GPSTK_RETHROW(e); }
-}  // end processOneEpoch()
-
-
-//------------------------------------------------------------------------------
-// return >0 to put/keep the command on the 'current' queue
-// return <0 for fatal error
-int executeEditCmd(const vector<EditCmd>::iterator& it, Rinex3ObsHeader& Rhead,
-                                                        Rinex3ObsData& Rdata)
-   throw(Exception)
+// OF command: open the output file and write the header to it
+// return false for fatal error
+bool openOutputFile(const EditCmd& cmd, Rinex3ObsHeader& Rhead,
+                    const Rinex3ObsData& Rdata) throw(Exception)
 {
    Configuration& C(Configuration::Instance());
-   size_t i,j;
-   string sys;
+   size_t i;
    vector<string> flds;
-   Rinex3ObsData::DataMap::const_iterator kt;
-   vector<RinexObsID>::iterator jt;
 
    try
    {
-      if(it->type == EditCmd::invalidCT)
-      {
-         LOG(DEBUG) << " Invalid command " << it->asString();
-         return 0;
-      }
-
-         // OF output file --------------------------------------------------------
-      else if(it->type == EditCmd::ofCT)
-      {
-            // close the old file
-         if(C.ostrm.is_open()) { C.ostrm.close(); C.ostrm.clear(); }
-
-            // open the new file
-         C.ostrm.open(it->field.c_str(),ios::out);
-         if(!C.ostrm.is_open())
-         {
-            LOG(ERROR) << "Error : could not open output file " << it->field;
-            return -1;
-         }
-         C.ostrm.exceptions(ios::failbit);
-
-         LOG(INFO) << " Opened output file " << it->field << " at time "
-                   << printTime(Rdata.time,C.longfmt);
-
-            // if this is the first file, apply the header commands
-         if(it->ttag == CommonTime::BEGINNING_OF_TIME)
-         {
-            Rhead.fileProgram = C.prgmName;
-            if(!C.messHDp.empty()) Rhead.fileProgram = C.messHDp;
-            if(!C.messHDr.empty()) Rhead.fileAgency = C.messHDr;
-            if(!C.messHDo.empty()) Rhead.observer = C.messHDo;
-            if(!C.messHDa.empty()) Rhead.agency = C.messHDa;
-            if(!C.messHDj.empty()) Rhead.recNo = C.messHDj;
-            if(!C.messHDk.empty()) Rhead.recType = C.messHDk;
-            if(!C.messHDl.empty()) Rhead.recVers = C.messHDl;            
-            if(!C.messHDs.empty()) Rhead.antNo = C.messHDs;
-            if(!C.messHDx.empty())
-            {
-               flds = split(C.messHDx,',');
-                  // TD check n==3,doubles in initialize
-               for(i=0; i<3; i++) Rhead.antennaPosition[i] = asDouble(flds[i]);
-            }
-            if(!C.messHDm.empty()) Rhead.markerName = C.messHDm;
-            if(!C.messHDn.empty())
-            {
-               Rhead.markerNumber = C.messHDn;
-               Rhead.valid |= Rinex3ObsHeader::validMarkerNumber;
-            }
-            if(!C.messHDt.empty())
-               Rhead.antType = C.messHDt;
-            if(!C.messHDh.empty())
-            {
-               flds = split(C.messHDh,',');   // TD check n==3,doubles in initialize
-               for(i=0; i<3; i++) Rhead.antennaDeltaHEN[i] = asDouble(flds[i]);
-            }
-            if(C.messHDdc)
-            {
-               Rhead.commentList.clear();
-               Rhead.valid ^= Rinex3ObsHeader::validComment;
-            }
-            if(C.messHDc.size() > 0)
-            {
-               for(i=0; i<C.messHDc.size(); i++)
-                  Rhead.commentList.push_back(C.messHDc[i]);
-               Rhead.valid |= Rinex3ObsHeader::validComment;
-            }
-         }
+         // close the old file
+      if(C.ostrm.is_open()) { C.ostrm.close(); C.ostrm.clear(); }
 
-         Rhead.firstObs = Rdata.time;
-         Rhead.valid &= ~Rinex3ObsHeader::validLastTime;    // turn off
-
-            // write the header
-         C.ostrm << Rhead;
-         return 0;
-      }
-
-         // DA delete all ---------------------------------------------------------------
-      else if(it->type == EditCmd::daCT)
+         // open the new file
+      C.ostrm.open(cmd.field.c_str(),ios::out);
+      if(!C.ostrm.is_open())
       {
-         switch(it->sign)
-         {
-            case 1: case 0:
-               Rdata.numSVs = 0;                   // clear this data, keep the cmd
-               Rdata.obs.clear();
-               if(it->sign == 0) return 0;
-               break;
-            case -1:
-               return 0;                           // delete the (-) command
-               break;
-         }
+         LOG(ERROR) << "Error : could not open output file " << cmd.field;
+         return false;
       }
+      C.ostrm.exceptions(ios::failbit);
 
-         // DO delete obs type ----------------------------------------------------------
-         // This is handled above where output header is created w/o the deleted
-         // obs type in it. The data isn't actually deleted from the obs data objects
-         // but just doesn't get written out
-      else if (it->type == EditCmd::doCT)
-         return 0;
+      LOG(INFO) << " Opened output file " << cmd.field << " at time "
+                << printTime(Rdata.time,C.longfmt);
 
-         // DS delete satellite ---------------------------------------------------------
-      else if(it->type == EditCmd::dsCT)
+         // if this is the first file, apply the header commands
+      if(cmd.ttag == CommonTime::BEGINNING_OF_TIME)
       {
-         vector<RinexSatID> sats;
-         if (it->sign == -1)
-            return 0;                 // delete the (-) command
-         
-         LOG(DEBUG) << " Delete sat " << it->asString();
-         if (it->sat.id > 0)
+         Rhead.fileProgram = C.prgmName;
+         if(!C.messHDp.empty()) Rhead.fileProgram = C.messHDp;
+         if(!C.messHDr.empty()) Rhead.fileAgency = C.messHDr;
+         if(!C.messHDo.empty()) Rhead.observer = C.messHDo;
+         if(!C.messHDa.empty()) Rhead.agency = C.messHDa;
+         if(!C.messHDj.empty()) Rhead.recNo = C.messHDj;
+         if(!C.messHDk.empty()) Rhead.recType = C.messHDk;
+         if(!C.messHDl.empty()) Rhead.recVers = C.messHDl;
+         if(!C.messHDs.empty()) Rhead.antNo = C.messHDs;
+         if(!C.messHDx.empty())
          {
-               // Find a specific satellite
-            kt = Rdata.obs.find(it->sat);
-            if (kt != Rdata.obs.end())                // found the SV
-               sats.push_back(kt->first);
-            else
-               LOG(DEBUG) << " Execute: sat " << it->sat << " not found in data";
+            flds = split(C.messHDx,',');
+               // TD check n==3,doubles in initialize
+            for(i=0; i<3; i++) Rhead.antennaPosition[i] = asDouble(flds[i]);
          }
-         else
+         if(!C.messHDm.empty()) Rhead.markerName = C.messHDm;
+         if(!C.messHDn.empty())
          {
-               // Delete all with the specified system
-            for (kt=Rdata.obs.begin(); kt!=Rdata.obs.end(); ++kt)
-               if (kt->first.system == it->sat.system)
-                  sats.push_back(kt->first);
-         }
-         
-         LOG(DEBUG) << " sats.size() " << sats.size() << " Rdata.obs.size() " << Rdata.obs.size();
-         
-         for (j=0; j<sats.size(); j++)
-            Rdata.obs.erase(sats[j]);
-         
-         Rdata.numSVs = Rdata.obs.size();
-         
-         if (it->sign == 0)
-            return 0;                  // delete the one-time command
-      }
-
-         // -----------------------------------------------------------------------------
-         // the rest require that we find satellite and obsid in Rdata.obs
-      else
-      {
-         vector<RinexSatID> sats;
-
-         if(it->sign == -1) return 0;                 // delete the (-) command
-
-         sys = asString(it->sat.systemChar());        // find the system
-
-            // find the OT in the header map, and get index into vector
-         jt = find(Rhead.mapObsTypes[sys].begin(),
-                   Rhead.mapObsTypes[sys].end(), it->obs);
-         if (jt == Rhead.mapObsTypes[sys].end()) {     // ObsID not found
-               // TD message? user error: ask to delete one that's not there
-            LOG(DEBUG) << " Execute: obstype " << it->obs << " not found in header";
-            return 0;                                 // delete the cmd
+            Rhead.markerNumber = C.messHDn;
+            Rhead.valid |= Rinex3ObsHeader::validMarkerNumber;
          }
-
-         i = (jt - Rhead.mapObsTypes[sys].begin());   // index into vector
-
-            // find the sat
-         if(it->sat.id > 0)
+         if(!C.messHDt.empty())
+            Rhead.antType = C.messHDt;
+         if(!C.messHDh.empty())
          {
-            if(Rdata.obs.find(it->sat)==Rdata.obs.end())
-            { // sat not found
-               LOG(DEBUG) << " Execute: sat " << it->sat << " not found in data";
-            }
-            else
-               sats.push_back(it->sat);
+            flds = split(C.messHDh,',');   // TD check n==3,doubles in initialize
+            for(i=0; i<3; i++) Rhead.antennaDeltaHEN[i] = asDouble(flds[i]);
          }
-         else
+         if(C.messHDdc)
          {
-            for(kt=Rdata.obs.begin(); kt!=Rdata.obs.end(); ++kt)
-            {
-               if(kt->first.system == it->sat.system)
-                  sats.push_back(kt->first);
-            }
+            Rhead.commentList.clear();
+            Rhead.valid ^= Rinex3ObsHeader::validComment;
          }
-
-         for(j=0; j<sats.size(); j++)
+         if(C.messHDc.size() > 0)
          {
-            switch(it->type)
-            {
-                  // DD delete data -----------------------------------------------------
-               case EditCmd::ddCT:
-                  Rdata.obs[sats[j]][i].data = 0.0;
-                  Rdata.obs[sats[j]][i].ssi = 0;
-                  Rdata.obs[sats[j]][i].lli = 0;
-                  break;
-                     // SD set data --------------------------------------------------------
-               case EditCmd::sdCT:
-                  Rdata.obs[sats[j]][i].data = it->data;
-                  break;
-                     // SS set SSI ---------------------------------------------------------
-               case EditCmd::ssCT:
-                  Rdata.obs[sats[j]][i].ssi = it->idata;
-                  break;
-                     // SL set LLI ---------------------------------------------------------
-               case EditCmd::slCT:
-                  Rdata.obs[sats[j]][i].lli = it->idata;
-                  break;
-                     // BD bias data -------------------------------------------------------
-               case EditCmd::bdCT:     // do not bias
-                  if(Rdata.obs[sats[j]][i].data != 0.0 || C.messBZ)
-                     Rdata.obs[sats[j]][i].data += it->data;
-                  break;
-                     // BS bias SSI --------------------------------------------------------
-               case EditCmd::bsCT:
-                  Rdata.obs[sats[j]][i].ssi += it->idata;
-                  break;
-                     // BL bias LLI --------------------------------------------------------
-               case EditCmd::blCT:
-                  Rdata.obs[sats[j]][i].lli += it->idata;
-                  break;
-                     // never reached ------------------------------------------------------
-               default:
-                     // message?
-                  break;
-            }
+            for(i=0; i<C.messHDc.size(); i++)
+               Rhead.commentList.push_back(C.messHDc[i]);
+            Rhead.valid |= Rinex3ObsHeader::validComment;
          }
-
-         if(it->sign == 0)
-            return 0;                  // delete the one-time command
       }
 
-      return 1;
+      Rhead.firstObs = Rdata.time;
+      Rhead.valid &= ~Rinex3ObsHeader::validLastTime;    // turn off
+
+         // write the header
+      C.ostrm << Rhead;
+      return true;
    }
    catch(Exception& e) { GPSTK_RETHROW(e); }
-}  // end executeEditCmd()
+}  // end openOutputFile()
 
 
 //------------------------------------------------------------------------------
@@ -1339,16 +919,16 @@ int Configuration::extraProcessing(string& errors, string& extras) throw()
 
       // dump commands for debug
       //TEMP if(debug > -1)
-      //for(i=0; i<vecCmds.size(); i++)
-      //LOG(INFO) << vecCmds[i].asString(" Input Edit cmd:");
+      //for(i=0; i<editor.getCommands().size(); i++)
+      //LOG(INFO) << editor.getCommands()[i].asString(" Input Edit cmd:");
 
       // 'fix up' list of edit cmds: sort, add -(+) for unmatched +(-), find + > -
-   fixEditCmdList();
+   editor.compile();
 
       // dump final list of commands
    if(verbose)
-      for(i=0; i<vecCmds.size(); i++)
-         ossx << vecCmds[i].asString(" Edit cmd:") << endl;
+      for(i=0; i<editor.getCommands().size(); i++)
+         ossx << editor.getCommands()[i].asString(" Edit cmd:") << endl;
 
       // open the log file (so warnings, configuration summary, etc can go there) -----
    if(!logfile.empty()) {
@@ -1378,232 +958,8 @@ void Configuration::parseEditCmds(vector<string>& vec, const string lab,
                                                            ostringstream& os) throw()
 {
    for(size_t i=0; i<vec.size(); i++) {
-      EditCmd ec(lab,vec[i]);
-      if(ec.isValid()) vecCmds.push_back(ec);
-      else os << "Error: invalid argument in " << lab << " cmd: >" << vec[i] << "<\n";
-   }
-}
-
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-// constructor from strings, i.e. parser e.g. "DA+","t" or "BDp","SV,OT,t,s"
-EditCmd::EditCmd(const string intypestr, const string inarg) throw(Exception)
-{
-   try {
-      string tag(upperCase(intypestr)), arg(inarg);
-      vector<string> flds;
-
-      type = invalidCT;                                 // defaults
-      ttag = CommonTime::BEGINNING_OF_TIME;
-      sign = idata = 0;
-      data = 0.0;
-
-      if(tag.size() == 2) sign = 0;                   // pull off sign
-      else if(tag[2] == '+') sign = 1;
-      else if(tag[2] == '-') sign = -1;
-      else return;
-      tag = tag.substr(0,2);
-
-      flds = split(arg,',');                          // split arg
-      const size_t n(flds.size());                       // number of args
-
-      if(tag == "OF") {
-         if(n != 1 && n != 3 && n != 7) return;
-         field = flds[0];
-         if(n != 1) {
-            stripLeading(arg,field+",");
-            if(!parseTime(arg,ttag)) return;
-         }
-         type = ofCT;
-      }
-      else if(tag == "DA") {
-         if(!parseTime(arg,ttag)) return;
-         type = daCT;
-      }
-      else if(tag == "DO") {
-         if(sign != 0) return;                        // no DO+ or DO-
-
-         if(arg.size() == 4)                          // get sys
-            sat.fromString(string(1,arg[0]));
-            // else sat sys is unknown
-         if(isValidRinexObsID(arg)) obs = RinexObsID(arg);
-         else return;
-         type = doCT;
-      }
-      else if(tag == "DS") {
-         if(n != 1 && n != 3 && n != 7) return;    // DS DS,w,sow and DS,y,m,d,h,m,s
-         try { sat.fromString(flds[0]); } catch(Exception) { return; }
-         if(n != 1) {                              // time for DS is BeginTime
-            stripLeading(arg,flds[0]+",");
-            if(!parseTime(arg,ttag)) return;
-         }
-         if(sign == 0 && n == 1) sign = 1;
-         type = dsCT;
-      }
-      else {
-            // args are SV,OT,t[,d or s or l]
-         if(n < 4) return;                            // at minimum SV,OT,week,sow
-
-         stripLeading(arg,flds[0]+","+flds[1]+",");   // remove 'SV,OT,' from arg
-
-         string dat;
-         if(tag != "DD") {                            // strip and save last arg (dsl)
-            dat = flds[flds.size()-1];
-            stripTrailing(arg,string(",")+dat);
-         }
-         if(!parseTime(arg,ttag)) return;             // get the time
-
-            // parse satellite
-         try { sat.fromString(flds[0]); } catch(Exception) { return; }
-
-            // add system char to obs string
-         if(flds[1].size() == 3 && sat.systemChar() != '?')
-            flds[1] = string(1,sat.systemChar()) + flds[1];
-            // parse obs type
-         if(isValidRinexObsID(flds[1])) obs = RinexObsID(flds[1]); else return;
-
-         if(tag == "DD") { type = ddCT; return; } // DD is done
-
-         if(n != 5 && n != 9) return;           // rest have SV,OT,t,d = 5 or 9 args
-
-         if(tag == "SD" || tag == "BD") {       // double data
-            if(isScientificString(dat)) data = asDouble(dat); else return;
-         }
-         else {                                 // rest have int data
-            if(isDigitString(dat)) idata = asInt(dat); else return;
-         }
-
-            // now just set type
-         if(tag == "SD") type = sdCT;
-         else if(tag == "SS") type = ssCT;
-         else if(tag == "SL") type = slCT;
-         else if(tag == "BS") type = bsCT;
-         else if(tag == "BL") type = blCT;
-         else if(tag == "BD") type = bdCT;
-      }
-   }
-   catch(Exception& e) { GPSTK_RETHROW(e); }
-}
-
-//------------------------------------------------------------------------------
-bool EditCmd::parseTime(const string arg, CommonTime& ttag) throw()
-{
-   static const string fmtGPS("%F,%g"),fmtCAL("%Y,%m,%d,%H,%M,%S");
-   stripLeading(arg," \t");
-   int n(numWords(arg,','));
-   if(n == 2 || n == 6) {
-      Epoch ep;
-      try { ep.scanf(arg, (n==2 ? fmtGPS : fmtCAL)); }
-      catch(StringException) { return false; }
-      ttag = static_cast<CommonTime>(ep);
-   }
-   else return false;
-
-   return true;
-}
-
-//------------------------------------------------------------------------------
-// dump, with optional message
-string EditCmd::asString(string msg) throw(Exception)
-{
-   try {
-      Configuration& C(Configuration::Instance());
-      static map<CmdType,string> typeLabel;
-      if(typeLabel.size() == 0) {
-         typeLabel[invalidCT] = string("--invalidCT--   ");
-         typeLabel[ofCT] = string("OF_Output_File");
-         typeLabel[daCT] = string("DA_Delete_All ");
-         typeLabel[doCT] = string("DO_Delete_Obs ");
-         typeLabel[dsCT] = string("DS_Delete_Sat ");
-         typeLabel[ddCT] = string("DD_Delete_Data");
-         typeLabel[sdCT] = string("SD_Set_Data   ");
-         typeLabel[ssCT] = string("SS_Set_SSI    ");
-         typeLabel[slCT] = string("SL_Set_LLI    ");
-         typeLabel[bdCT] = string("BD_Bias_Data  ");
-         typeLabel[bsCT] = string("BS_Bias_SSI   ");
-         typeLabel[blCT] = string("BL_Bias_LLI   ");
-      }
-
-      ostringstream os;
-
-      if(msg.size()) os << msg;
-      os << " " << typeLabel[type]
-         << " " << (sign==0 ? "0" : (sign<0 ? "-":"+"))
-         << " SV:" << sat.toString()
-         << " OT:" << obs.asString()
-         << " d:" << fixed << setprecision(4) << data
-         << " i:" << idata
-         << " t:" << (ttag == CommonTime::BEGINNING_OF_TIME
-                      ? "BeginTime" : printTime(ttag,C.longfmt))
-         << " >" << field << "<";
-
-      return os.str();
-   }
-   catch(Exception& e) { GPSTK_RETHROW(e); }
-   catch(std::exception& e) {
-      Exception E(string("std::except: ") + e.what());
-      GPSTK_THROW(E);
-   }
-}
-
-//------------------------------------------------------------------------------
-void fixEditCmdList(void) throw()
-{
-   Configuration& C(Configuration::Instance());
-   vector<EditCmd>::iterator it, jt;
-   vector<EditCmd> newCmds;
-
-      // sort on time
-   sort(C.vecCmds.begin(), C.vecCmds.end(), EditCmdLessThan());
-
-      // ensure each - command has a corresponding + command
-      // (note that + cmds do not need a - cmd: they will just never be turned off)
-   for(it = C.vecCmds.begin(); it != C.vecCmds.end(); ++it ) {
-      if(it->sign == -1 && it->type != EditCmd::invalidCT) {
-         bool havePair(false);
-         if(it != C.vecCmds.begin()) {
-            jt = it; --jt;  // --(jt = it);
-            while(1) {                                // search backwards for match
-               if(jt->type == it->type &&
-                  jt->sat == it->sat &&
-                  jt->obs == it->obs)
-               {
-                  if(jt->sign == 1) havePair=true;    // its a match
-                  else if(jt->sign == -1) {           // this is an error
-                     LOG(ERROR) << it->asString("Error: repeat '-'");
-                     //LOG(ERROR) << jt->asString("Error: ref here  ");
-                     it->type = EditCmd::invalidCT;
-                  }
-                  break;
-               }
-               if(jt == C.vecCmds.begin()) break;
-               --jt;
-            }
-         }
-         if(!havePair && it->type != EditCmd::invalidCT) {
-            EditCmd ec(*it);
-            ec.sign = 1;
-            ec.ttag = CommonTime::BEGINNING_OF_TIME;
-            newCmds.push_back(ec);
-            LOG(VERBOSE) << ec.asString(" Add cmd:");
-         }
-      }
-   }
-
-   if(newCmds.size() > 0) {
-      for(it = newCmds.begin(); it != newCmds.end(); ++it )
-         C.vecCmds.push_back(*it);
-      newCmds.clear();
-      sort(C.vecCmds.begin(), C.vecCmds.end(), EditCmdLessThan());
-   }
-
-      // remove invalidCT commands
-   it = C.vecCmds.begin();
-   while(it != C.vecCmds.end()) {
-      if(it->type == EditCmd::invalidCT)
-         it = C.vecCmds.erase(it);              // erase vector element
-      else
-         ++it;
+      if(!editor.addCommand(lab,vec[i]))
+         os << "Error: invalid argument in " << lab << " cmd: >" << vec[i] << "<\n";
    }
 }
 
@@ -66,6 +66,7 @@
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
+#include "Rinex3ObsSummary.hpp"
 #include "RinexUtilities.hpp"
 
 #include "msecHandler.hpp"
@@ -111,7 +112,7 @@ private:
       endTime.setTimeSystem(TimeSystem::Any);
       userfmt = gpsfmt;
       help = verbose = brief = nohead = notab = gpstime = sorttime = vistab
-         = dogaps = doms = ycode = quiet = false;
+         = dogaps = doms = ycode = quiet = pipe = false;
       debug = -1;
       dt = -1.0;
       vres = 0;
@@ -126,7 +127,7 @@ public:
 
       // start command line input
    bool help, verbose, brief, nohead, notab, gpstime, sorttime, dogaps, doms,
-      vistab, ycode, quiet;
+      vistab, ycode, quiet, pipe;
    int debug, vres;
    double dt;
    string cfgfile, userfmt;
@@ -144,7 +145,6 @@ public:
 
       // end of command line input
 
-   vector<int> gapcount;               // for counting gaps
    string msg;
    static const string calfmt,gpsfmt,longfmt;
    ofstream logstrm;
@@ -162,41 +162,22 @@ const string Configuration::gpsfmt = string("%4F %w %10.3g %P");
 const string Configuration::longfmt = calfmt + " = " + gpsfmt;
 
 //-----------------------------------------------------------------------------
-// struct used to store SAT/Obs table
-struct TableData
-{
-   RinexSatID sat;
-   vector<int> nobs;                   // number of data for each obs type
-   vector<int> gapcount;               //
-   double prevC1, prevP1, prevL1;
-   CommonTime begin, end;
-
-      // c'tor
-   TableData(const SatID& p, const int& n)
-   {
-      sat = RinexSatID(p);
-      nobs = vector<int>(n);
-      prevC1 = 0;
-      prevP1 = 0;
-      prevL1 = 0;
-   }
-      // needed for find()
-   inline bool operator==(const TableData& d) { return d.sat == sat; }
-};
+// summary of one satellite, used for the SAT/Obs table
+typedef Rinex3ObsSummary::SatSummary SatSummary;
 
 // needed for sort()
 class TableSATLessThan
 {
 public:
-   bool operator()(const TableData& d1, const TableData& d2)
-   { return d1.sat < d2.sat; }
+   bool operator()(const SatSummary* d1, const SatSummary* d2)
+   { return d1->sat < d2->sat; }
 };
 
 class TableBegLessThan
 {
 public:
-   bool operator()(const TableData& d1, const TableData& d2)
-   { return d1.begin < d2.begin; }
+   bool operator()(const SatSummary* d1, const SatSummary* d2)
+   { return d1->begin < d2->begin; }
 };
 
 //-----------------------------------------------------------------------------
@@ -482,6 +463,8 @@ string Configuration::BuildCommandLine(void) throw()
 
    opts.Add(0, "ycode", "", false, false, &ycode, "# Other:",
             "Assume v2.11 P mean Y");
+   opts.Add(0, "pipe", "", false, false, &pipe, "",
+            "Parse the file on a separate thread from the summary");
    opts.Add(0, "verbose", "", false, false, &verbose, "",
             "Print extra output information");
    opts.Add(0, "debug", "", false, false, &debug, "",
@@ -660,24 +643,16 @@ int ProcessFiles(void) throw(Exception)
       int iret,ii,k;
       size_t i,j,nfile,nfiles;
       string tag;
-      CommonTime lastObsTime, prevObsTime, firstObsTime;
+      CommonTime lastObsTime, firstObsTime;
       RinexSatID sat;
       Rinex3ObsStream ostrm;
       ostringstream oss;
-         // estimate time step
-      const size_t ndtmax=15;
-      double dt, bestdt[ndtmax];
-      int ndt[ndtmax];
-         // cache the out-of-time-order records
-      bool cacheon;
-      vector<CommonTime> cachetime;
-      vector<vector<Rinex3ObsData> > cache;
+      double dt;
 
       for(nfiles=0,nfile=0; nfile<C.InputObsFiles.size(); nfile++)
       {
          Rinex3ObsStream istrm;
          Rinex3ObsHeader Rhead, Rheadout;
-         Rinex3ObsData Rdata;
 
             // If command line specified P1/P2 are to be considered
             // as Y-code, set the Rinex3ObsHeader flag to indicate such.
@@ -686,17 +661,11 @@ int ProcessFiles(void) throw(Exception)
             Rhead.PisY = true;
             Rheadout.PisY = true;
          }
-      
-         cacheon = false;
-         cache.clear();
-         cachetime.clear();
 
          string filename(C.InputObsFiles[nfile]);
 
          // iret is set to 0 ok, or could not: 1 open file, 2 read header, 3 read data
          iret = 0;
-         for(i=0; i<ndtmax; i++)
-            ndt[i] = -1;
 
             // open the file ------------------------------------------------
          istrm.open(filename.c_str(),ios::in);
@@ -785,29 +754,18 @@ int ProcessFiles(void) throw(Exception)
             continue;
          }
 
-            // initialize counting -------------------------------------------
-         int nepochs(0), ncommentblocks(0), nmaxobs(0);
-         vector<TableData> table;            // table of counts per sat,obs
-         map<char, vector<int> > totals;     // totals per system,obs
-
-         prevObsTime = CommonTime::BEGINNING_OF_TIME;
-         firstObsTime = CommonTime::BEGINNING_OF_TIME;
+            // initialize the summary --------------------------------------
+         Rinex3ObsSummary summary;
+         summary.setTimeLimits(C.beginTime,C.endTime);
+         summary.setInterval(C.dt);
+         summary.setSatellites(C.onlySats,C.exSats);
+         summary.reset(Rhead);
 
-            // initialize for all systems in the header
          map<std::string,vector<RinexObsID> >::const_iterator sit;   // used below often
          for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
-         {
-               // Initialize the vectors contained in the map
-            totals[(sit->first)[0]] = vector<int>((sit->second).size());
-
             LOG(DEBUG) << "GNSS " << (sit->first) << " is present with "
                        << (sit->second).size() << " observations...";
 
-               // find the max size of obs list
-            if(int((sit->second).size()) > nmaxobs)
-               nmaxobs = (sit->second).size();
-         }
-
             // initialize millisecond handler with obstypes and wavelengths
          vector<string> msots;
          if(C.doms)
@@ -854,221 +812,74 @@ int ProcessFiles(void) throw(Exception)
          if(pLOGstrm == &cout && !C.brief)
             LOG(INFO) << "\nReading the observation data...";
 
-            // loop over epochs ---------------------------------------------
-         while(1)
+            // read the data ------------------------------------------------
+            // The summary is accumulated by Rinex3ObsSummary; the debug output
+            // and the millisecond handler see each record as it is added.
+         Rinex3ObsSummary::RecordHook hook =
+            [&](const Rinex3ObsData& Rdata, Rinex3ObsSummary::RecordStatus status)
          {
-            try
-            {
-               istrm >> Rdata;
-            }
-            catch(Exception& e)
-            {
-               LOG(WARNING) << " Warning : Failed to read obs data (Exception "
-                            << e.getText(0) << "); dump follows.";
-               Rdata.dump(LOGstrm,Rhead);
-               istrm.close();
-               iret = 3;
-               break;
-            }
-            catch(std::exception& e)
-            {
-               Exception ge(string("Std excep: ") + e.what());
-               GPSTK_THROW(ge);
-            }
-            catch(...)
-            {
-               Exception ue("Unknown exception while reading RINEX data.");
-               GPSTK_THROW(ue);
-            }
-
-               // normal EOF
-            if(!istrm.good() || istrm.eof())
-            {
-               iret = 0;
-               break;
-            }
-
-               // stay within time limits
-            if(Rdata.time < C.beginTime)
+            if(status == Rinex3ObsSummary::BeforeBegin)
             {
                LOG(DEBUG) << " RINEX data timetag " << printTime(C.beginTime,C.longfmt)
                           << " is before begin time.";
-               continue;
+               return;
             }
-            if(Rdata.time > C.endTime)
+            if(status == Rinex3ObsSummary::AfterEnd)
             {
                LOG(DEBUG) << " RINEX data timetag " << printTime(C.endTime,C.longfmt)
                           << " is after end time.";
-               break;
+               return;
             }
 
-               // fix time systems
-            if(nepochs == 0 &&
-               Rdata.time.getTimeSystem() != Rhead.lastObs.getTimeSystem())
-            {
-               Rhead.lastObs.setTimeSystem(Rdata.time.getTimeSystem());
-               Rhead.firstObs.setTimeSystem(Rdata.time.getTimeSystem());
-            }
-            lastObsTime = Rdata.time;
-            lastObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            firstObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            prevObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            if(firstObsTime == CommonTime::BEGINNING_OF_TIME)
-               firstObsTime = lastObsTime;
-
-               //LOG(INFO) << "";
             LOG(DEBUG) << " Read RINEX data: flag " << Rdata.epochFlag
                        << ", timetag " << printTime(Rdata.time,C.longfmt);
 
-               // if aux header data, either output or skip
-            if(Rdata.epochFlag > 1)
+               // aux header data was only counted
+            if(status == Rinex3ObsSummary::Auxiliary)
             {
                if(C.debug > -1)
-                  for(j=0; j<Rdata.auxHeader.commentList.size(); j++)
+                  for(size_t j=0; j<Rdata.auxHeader.commentList.size(); j++)
                      LOG(DEBUG) << "Comment: " << Rdata.auxHeader.commentList[j];
-               ncommentblocks++;
-               continue;
+               return;
             }
 
                // debug: dump the RINEX data object
             if(C.debug > -1)
                Rdata.dump(LOGstrm,Rhead);
 
-               // count this epoch
-            nepochs++;
-
-               // check for data out of time order
-               // use < 1.e-3 not < 0 b/c inline header info (epochFlag > 1) excluded
-            if(prevObsTime != CommonTime::BEGINNING_OF_TIME
-               && Rdata.time-prevObsTime < 1.e-3)
-            {
-                  // save it
-               if(!cacheon)
-               {
-                     // new block
-                  cachetime.push_back(prevObsTime);
-                  cacheon = true;
-                  vector<Rinex3ObsData> v;
-                  cache.push_back(v);
-               }
-               cache[cache.size()-1].push_back(Rdata);
-               continue;
-            }
-            cacheon = false;
-
-               // look for gaps in the timetags
-            int ncount;
-            if(C.dt > 0.0)
-            {
-               ncount = int(0.5+(lastObsTime-firstObsTime)/C.dt);
-                  // update gap count
-               if(C.gapcount.size() == 0)
-               {
-                     // create the list
-                  C.gapcount.push_back(ncount);   // start time
-                  C.gapcount.push_back(ncount-1); // end time
-               }
-               i = C.gapcount.size() - 1;
-               if(ncount == C.gapcount[i] + 1)    // no gap
-                  C.gapcount[i] = ncount;
-               else
-               {
-                     // found a gap
-                  C.gapcount.push_back(ncount);   // start time
-                  C.gapcount.push_back(ncount);   // end time
-               }
-
-                  // TD test after 50 epochs - wrong dt is disasterous
-            }
+            if(status != Rinex3ObsSummary::Accepted
+               || (!C.doms && C.debug < 0))
+               return;
 
                // loop over satellites -------------------------------------
+            ostringstream oss;
             Rinex3ObsData::DataMap::const_iterator it;
             for(it=Rdata.obs.begin(); it != Rdata.obs.end(); ++it)
             {
                const RinexSatID& sat(it->first);
-
-                  // is sat included?
-               if(C.onlySats.size() > 0 &&
-                  find(C.onlySats.begin(), C.onlySats.end(), sat) == C.onlySats.end()
-                  && find(C.onlySats.begin(), C.onlySats.end(),
-                          RinexSatID(-1,sat.system)) == C.onlySats.end())
-                  continue;
-
-                  // is sat excluded?
-               if(find(C.exSats.begin(), C.exSats.end(), sat) != C.exSats.end())
-                  continue;
-                  // check for all sats of this system
-               else if(find(C.exSats.begin(), C.exSats.end(),
-                            RinexSatID(-1,sat.system)) != C.exSats.end())
+               if(!summary.isSelected(sat))
                   continue;
 
                const vector<RinexDatum>& vecData(it->second);
-
-                  // find this sat in the table; add it if necessary
-               vector<TableData>::iterator ptab;
-               ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
-               if(ptab == table.end())
-               {
-                     // add it
-                  table.push_back(TableData(sat,nmaxobs));
-                  ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
-                  ptab->begin = lastObsTime;
-                  if(C.dt > 0.0)
-                  {
-                     ptab->gapcount.push_back(ncount);      // start time
-                     ptab->gapcount.push_back(ncount-1);    // end time
-                  }
-               }
-
-                  // update list of gap times
-               if(C.dt > 0.0)
-               {
-                  i = ptab->gapcount.size() - 1;         // index of curr end time
-                  if(ncount == ptab->gapcount[i] + 1)    // no gap
-                     ptab->gapcount[i] = ncount;
-                  else
-                  {
-                        // found a gap
-                     ptab->gapcount.push_back(ncount);   // start time
-                     ptab->gapcount.push_back(ncount);   // end time
-                  }
-               }
-
-                  // set the end time for this satellite to the current epoch
-               ptab->end = lastObsTime;
                if(C.debug > -1)
                {
                   oss.str("");
                   oss << "Sat " << setw(2) << sat;
                }
 
-                  // first, find the current system...
-               char sysCode = sat.systemChar();
-               string sysStr(string(1,sysCode));
-
-                  // update Obs data totals
+               string sysStr(string(1,sat.systemChar()));
                for(size_t index=0; index != vecData.size(); index++)
                {
                   if(C.debug > -1)
                      oss << " (" << index << ")";
 
-                     // if this observation is not zero, update it's total count
-                  if(vecData[index].data != 0)
-                  {
-                     (ptab->nobs)[index]++;                 // per obs
-                     if(totals[sysCode].size() == 0)
-                        totals[sysCode] = vector<int>(vecData.size());
-                     totals[sysCode][index]++;              // per system
-                  }
-
                      // if looking for milliseconds, update handler
                   if(C.doms && vecData[index].data != 0)
                   {
-                     tag = sysStr + Rhead.mapObsTypes[sysStr][index].asString();
-                     if(vectorindex(msots,tag) != -1)
-                     {
-                        C.msh.add(lastObsTime, sat, tag, vecData[index].data);
-                     }
+                     string mtag(sysStr + Rhead.mapObsTypes[sysStr][index].asString());
+                     if(vectorindex(msots,mtag) != -1)
+                        C.msh.add(summary.getLastEpoch(), sat, mtag,
+                                  vecData[index].data);
                   }
 
                   if(C.debug > -1)
@@ -1077,68 +888,35 @@ int ProcessFiles(void) throw(Exception)
                          << " " << setw(13) << vecData[index].data
                          << " " << vecData[index].lli
                          << " " << vecData[index].ssi;
-
-               } // end loop over observations
+               }
 
                if(C.debug > -1)
                   LOG(DEBUG) << oss.str();
-
-            }  // end loop over satellites
-
-            if(prevObsTime != CommonTime::BEGINNING_OF_TIME)
-            {
-               dt = lastObsTime-prevObsTime;
-               if(dt > 0.0)
-               {
-                  for(i=0; i<ndtmax; i++)
-                  {
-                     if(ndt[i] <= 0)
-                     {
-                        bestdt[i]=dt;
-                        ndt[i]=1;
-                        break;
-                     }
-                     if(fabs(dt-bestdt[i]) < 0.0001)
-                     {
-                        ndt[i]++;
-                        break;
-                     }
-                     if(i == ndtmax-1)
-                     {
-                        k = 0;
-                        int nleast = ndt[k];
-                        for(j=1; j<ndtmax; j++)
-                        {
-                           if(ndt[j] <= nleast)
-                           {
-                              k = j;
-                              nleast = ndt[j];
-                           }
-                        }
-                        ndt[k] = 1;
-                        bestdt[k] = dt;
-                     }
-                  }
-               }
-               else if(dt == 0)
-               {
-                  LOG(WARNING) << "Warning - repeated time tag at "
-                               << printTime(lastObsTime,C.longfmt);
-               }
-               else
-               {
-                  LOG(WARNING) << "Warning - time tags out of order: "
-                               << printTime(prevObsTime,C.longfmt) << " > "
-                               << printTime(lastObsTime,C.longfmt);
-                     //<< " " << scientific << setprecision(4) << dt;
-               }
             }
-            prevObsTime = lastObsTime;
+         };
 
-         }  // end while loop over epochs
+         if(summary.read(istrm, C.pipe, hook))
+            iret = 0;
+         else
+         {
+            LOG(WARNING) << " Warning : Failed to read obs data (Exception "
+                         << summary.getReadError() << "); dump follows.";
+            summary.getFailedRecord().dump(LOGstrm,Rhead);
+            iret = 3;
+         }
 
          istrm.close();
 
+            // fix time systems
+         Rhead.lastObs.setTimeSystem(summary.getTimeSystem());
+         Rhead.firstObs.setTimeSystem(summary.getTimeSystem());
+         firstObsTime = summary.getFirstEpoch();
+         lastObsTime = summary.getLastEpoch();
+         int nepochs(summary.getEpochCount());
+         int ncommentblocks(summary.getAuxHeaderCount());
+         const map<char, vector<int> >& totals(summary.getTotals());
+         const vector<int>& gapcount(summary.getEpochGaps());
+
             // check that we found some data
          if(nepochs <= 0)
          {
@@ -1148,12 +926,12 @@ int ProcessFiles(void) throw(Exception)
          }
 
             // Compute interval -------------------------------------------------
-         for(i=1,j=0; i < ndtmax; i++)
-         {
-            if(ndt[i] > ndt[j])
-               j = i;
-            dt = bestdt[j];
-         }
+         dt = summary.getInterval();
+
+            // table of counts per sat,obs
+         vector<const SatSummary*> table;
+         for(i=0; i<summary.getSatellites().size(); i++)
+            table.push_back(&summary.getSatellites()[i]);
 
             // Summary info -----------------------------------------------------
          LOG(INFO) << "Computed interval " << fixed << setw(5) << setprecision(2)
@@ -1196,9 +974,9 @@ int ProcessFiles(void) throw(Exception)
 
             // output table
             // header
-         vector<TableData>::iterator tabIt;
+         vector<const SatSummary*>::iterator tabIt;
          if(table.size() > 0)
-            table.begin()->sat.setfill('0');
+            RinexSatID(table[0]->sat).setfill('0');
 
          if(!C.brief && !C.notab)
          {
@@ -1236,19 +1014,19 @@ int ProcessFiles(void) throw(Exception)
                for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
                {
                   std::string sysChar;
-                  sysChar += (tabIt->sat).systemChar();
+                  sysChar += (*tabIt)->sat.systemChar();
                   if((sit->first) == sysChar)
                   {
                      oss.str("");
-                     oss << " " << tabIt->sat << " ";
+                     oss << " " << (*tabIt)->sat << " ";
                      size_t obsSize = (Rhead.mapObsTypes.find(sysChar)->second).size();
                      for(k = 0; k < obsSize; k++)
-                        oss << setw(7) << tabIt->nobs[k];
+                        oss << setw(7) << (*tabIt)->count(k);
 
-                     oss << setw(7) << 1+int(0.5+(tabIt->end-tabIt->begin)/dt);
+                     oss << setw(7) << 1+int(0.5+((*tabIt)->end-(*tabIt)->begin)/dt);
 
-                     LOG(INFO) << oss.str() << "  " << printTime(tabIt->begin,fmt)
-                               << " - " << printTime(tabIt->end,fmt);
+                     LOG(INFO) << oss.str() << "  " << printTime((*tabIt)->begin,fmt)
+                               << " - " << printTime((*tabIt)->end,fmt);
                   }
                }
 
@@ -1267,7 +1045,7 @@ int ProcessFiles(void) throw(Exception)
             i = 0;
             for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
             {
-               oss << " " << tabIt->sat;
+               oss << " " << (*tabIt)->sat;
                if((++i % 20) == 0)
                {
                   LOG(INFO) << oss.str();
@@ -1338,26 +1116,26 @@ int ProcessFiles(void) throw(Exception)
             oss << "    Sat    beg - end (count,size) ... "
                 << "[count = # of dt's from first epoch]\n";
                // print for timetags = all sats
-            k = C.gapcount.size()-1;               // size() is at least 2
-            oss << "GAP ALL " << setw(5) << C.gapcount[0]
-                << " - " << setw(5) << C.gapcount[k];
+            k = gapcount.size()-1;               // size() is at least 2
+            oss << "GAP ALL " << setw(5) << gapcount[0]
+                << " - " << setw(5) << gapcount[k];
 
                // NB DO NOT make ii size_t
             for(ii=1; ii<=k-2; ii+=2)
-               oss << " (" << C.gapcount[ii]+1                          // begin of gap
-                   << "," << C.gapcount[ii+1]-C.gapcount[ii]-1 << ")";   // size
+               oss << " (" << gapcount[ii]+1                          // begin of gap
+                   << "," << gapcount[ii+1]-gapcount[ii]-1 << ")";   // size
             oss << endl;
 
                // loop over sats
             for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
             {
-               k = tabIt->gapcount.size() - 1;
-               oss << "GAP " << tabIt->sat << " " << setw(5) << tabIt->gapcount[0]
-                   << " - " << setw(5) << tabIt->gapcount[k];
+               k = (*tabIt)->gaps.size() - 1;
+               oss << "GAP " << (*tabIt)->sat << " " << setw(5) << (*tabIt)->gaps[0]
+                   << " - " << setw(5) << (*tabIt)->gaps[k];
                   // NB DO NOT make ii size_t
                for(ii=1; ii<=k-2; ii+=2)
-                  oss << " (" << tabIt->gapcount[ii]+1 << ","      // begin count of gap
-                      << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
+                  oss << " (" << (*tabIt)->gaps[ii]+1 << ","      // begin count of gap
+                      << (*tabIt)->gaps[ii+1]-(*tabIt)->gaps[ii]-1 << ")";   // size
                oss << endl;
             }
 
@@ -1376,26 +1154,26 @@ int ProcessFiles(void) throw(Exception)
             oss << "    Sat      beg -      end (sow,number of missing points)\n";
 
                // print for timetags = all sats
-            k = C.gapcount.size()-1;               // size() is at least 2
-            oss << "GAP ALL " << fixed << setprecision(1) << setw(8) << t+d*C.gapcount[0]
-                << " - " << setw(8) << t+d*C.gapcount[k];
+            k = gapcount.size()-1;               // size() is at least 2
+            oss << "GAP ALL " << fixed << setprecision(1) << setw(8) << t+d*gapcount[0]
+                << " - " << setw(8) << t+d*gapcount[k];
                // NB DO NOT make ii size_t
             for(ii=1; ii<=k-2; ii+=2)
-               oss << " (" << t+d*(C.gapcount[ii]+1)                    // begin of gap
-                   << "," << C.gapcount[ii+1]-C.gapcount[ii]-1 << ")";   // size
+               oss << " (" << t+d*(gapcount[ii]+1)                    // begin of gap
+                   << "," << gapcount[ii+1]-gapcount[ii]-1 << ")";   // size
             oss << endl;
 
                // loop over sats
             for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
             {
-               k = tabIt->gapcount.size() - 1;
-               oss << "GAP " << tabIt->sat << " " << fixed << setprecision(1)
-                   << setw(8) << t+d*tabIt->gapcount[0]
-                   << " - " << setw(8) << t+d*tabIt->gapcount[k];
+               k = (*tabIt)->gaps.size() - 1;
+               oss << "GAP " << (*tabIt)->sat << " " << fixed << setprecision(1)
+                   << setw(8) << t+d*(*tabIt)->gaps[0]
+                   << " - " << setw(8) << t+d*(*tabIt)->gaps[k];
                   // NB DO NOT make ii size_t
                for(ii=1; ii<=k-2; ii+=2)
-                  oss << " (" << t+d*(tabIt->gapcount[ii]+1) << ","  // begin sow of gap
-                      << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
+                  oss << " (" << t+d*((*tabIt)->gaps[ii]+1) << ","  // begin sow of gap
+                      << (*tabIt)->gaps[ii+1]-(*tabIt)->gaps[ii]-1 << ")";   // size
                oss << endl;
             }
 
@@ -1414,16 +1192,16 @@ int ProcessFiles(void) throw(Exception)
                    << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
                oss << "VIS ALL ";
                bool isOn(false);
-               for(k=0,i=0; i<C.gapcount.size()-1; i+=2)
+               for(k=0,i=0; i<gapcount.size()-1; i+=2)
                {
-                  ii = int(double(C.gapcount[i]/dn));
+                  ii = int(double(gapcount[i]/dn));
                   if(ii-k > 0)
                   {
                      oss << string(ii-k,' ');
                      k = ii;
                      isOn = false;
                   }
-                  ii = int(double(C.gapcount[i+1]/dn));
+                  ii = int(double(gapcount[i+1]/dn));
                   if(ii-k > 0)
                   {
                      if(isOn)
@@ -1447,19 +1225,19 @@ int ProcessFiles(void) throw(Exception)
                for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
                {
                   oss.str("");
-                  oss << "VIS " << tabIt->sat << " ";
+                  oss << "VIS " << (*tabIt)->sat << " ";
 
                   isOn = false;
                   bool first(true);
-                  int jj,kk(static_cast<int>(tabIt->gapcount[0]/dn)); // + 0.5);
-                  for(k=0,i=0; i<tabIt->gapcount.size()-1; i+=2)
+                  int jj,kk(static_cast<int>((*tabIt)->gaps[0]/dn)); // + 0.5);
+                  for(k=0,i=0; i<(*tabIt)->gaps.size()-1; i+=2)
                   {
                         // satellite 'off'
-                     j = int(double(tabIt->gapcount[i]/dn));
+                     j = int(double((*tabIt)->gaps[i]/dn));
                      if(!first)
                      {
                         vtab.insert(multimap<int, string>::value_type(
-                                       kk, string("-")+asString(tabIt->sat)));
+                                       kk, string("-")+asString((*tabIt)->sat)));
                         kk = j;
                      }
                      first = false;
@@ -1471,9 +1249,9 @@ int ProcessFiles(void) throw(Exception)
                         k = j;
                      }
                         // satellite 'on'
-                     j = int(double(tabIt->gapcount[i+1]/dn));
+                     j = int(double((*tabIt)->gaps[i+1]/dn));
                      vtab.insert(multimap<int, string>::value_type(
-                                    kk, string("+")+asString(tabIt->sat)));
+                                    kk, string("+")+asString((*tabIt)->sat)));
                      kk = j;
                      jj = j-k;
                      if(jj > 0)
@@ -1492,7 +1270,7 @@ int ProcessFiles(void) throw(Exception)
                      }
                   }
                   vtab.insert(multimap<int, string>::value_type(
-                                 kk, string("-")+asString(tabIt->sat)));
+                                 kk, string("-")+asString((*tabIt)->sat)));
                   LOG(INFO) << oss.str();
                }
 
@@ -1577,16 +1355,15 @@ int ProcessFiles(void) throw(Exception)
 
             // Warnings ------------------------------------------------------------
             // there were records out of time order
-         if(cache.size() > 0)
-         {
-            for(i=0; i<cache.size(); i++)
-               LOG(INFO) << " Warning: " << setw(4) << cache[i].size()
-                         << " data records following epoch "
-                         << printTime(cachetime[i],C.calfmt) << " are out of time order,"
-                         << "\n         with epochs " << printTime(cache[i][0].time,C.calfmt)
-                         << " to " << printTime(cache[i][cache[i].size()-1].time,C.calfmt)
-                         << endl;
-         }
+         const vector<Rinex3ObsSummary::OutOfOrderBlock>&
+            cache(summary.getOutOfOrder());
+         for(i=0; i<cache.size(); i++)
+            LOG(INFO) << " Warning: " << setw(4) << cache[i].count
+                      << " data records following epoch "
+                      << printTime(cache[i].after,C.calfmt) << " are out of time order,"
+                      << "\n         with epochs " << printTime(cache[i].first,C.calfmt)
+                      << " to " << printTime(cache[i].last,C.calfmt)
+                      << endl;
 
          if((Rhead.valid & Rinex3ObsHeader::validInterval)
             && fabs(dt-Rhead.interval) > 1.e-3)
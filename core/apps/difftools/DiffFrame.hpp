@@ -39,6 +39,10 @@
 
 #include "CommandOptionWithTimeArg.hpp"
 #include "BasicFramework.hpp"
+#include "StringUtils.hpp"
+
+#include <list>
+#include <vector>
 
 
 class DiffFrame : public gpstk::BasicFramework
@@ -60,12 +64,16 @@ public:
         eTimeOption('e', "end-time", "End of time range to compare"
                     " (default = \"end of time\")"),
         inputFileOption("input " + type + " files.", true),
+        maxRecordsOption(0, "max-records", "Maximum number of records to"
+                         " hold in memory while sorting. Larger inputs are"
+                         " sorted in temporary files (default = 100000)."),
         startTime(gpstk::CommonTime::BEGINNING_OF_TIME),
         endTime(gpstk::CommonTime::END_OF_TIME)
    {
       inputFileOption.setMaxCount(2);
       timeOption.setMaxCount(1);
       eTimeOption.setMaxCount(1);
+      maxRecordsOption.setMaxCount(1);
       timeOptions.addOption(&timeOption);
       timeOptions.addOption(&eTimeOption);
    }
@@ -117,8 +125,92 @@ protected:
    /// if either of the time options are set
    gpstk::CommandOptionGroupOr timeOptions;
    gpstk::CommandOptionRest inputFileOption;
+   /// limit on the number of records held in memory
+   gpstk::CommandOptionWithNumberArg maxRecordsOption;
 
    gpstk::CommonTime startTime, endTime;
+
+   /// Returns the value of maxRecordsOption, 0 (the default) if unset.
+   size_t maxRecords() const
+   {
+      if (maxRecordsOption.getCount())
+         return gpstk::StringUtils::asUnsigned(maxRecordsOption.getValue()[0]);
+      return 0;
+   }
+
+   /// Reads all the records of f, e.g. a result of
+   /// ExternalFileFilter::diff(), into data.
+   template <class Filter, class Data>
+   static void readDiffs(const Filter& f, std::list<Data>& data)
+   {
+      typename Filter::Reader reader(f);
+      Data d;
+      while (reader.next(d))
+         data.push_back(d);
+   }
+
+   /// The records passed on by pairDiffs()
+   enum DiffPass
+   {
+      pairedDiffs,     ///< op.both() on the records in both results
+      firstOnlyDiffs,  ///< op.first() on the other records of the first
+      secondOnlyDiffs  ///< op.second() on the other records of the second
+   };
+
+   /**
+    * Goes through the two results of ExternalFileFilter::diff() together,
+    * one group of records at a time, so that no more than a group is held
+    * in memory. groupLess orders the groups, and both results must be
+    * sorted so that the records of a group are consecutive. Within a
+    * group, each record of d1 is paired with the first unpaired record of
+    * d2 for which match() is true. Depending on pass, op.both() is called
+    * on the pairs, in the order of d1, or op.first() / op.second() on the
+    * records of d1 / d2 that were not paired.
+    */
+   template <class Data, class Filter, class GroupLess, class Match, class Op>
+   static void pairDiffs(const Filter& d1, const Filter& d2,
+                         GroupLess groupLess, Match match, Op& op,
+                         DiffPass pass)
+   {
+      typename Filter::Reader r1(d1), r2(d2);
+      Data a, b;
+      bool aok = r1.next(a), bok = r2.next(b);
+      std::vector<Data> g1, g2;
+      while (aok || bok)
+      {
+            // the next group is that of the earlier record
+         Data key((aok && (!bok || !groupLess(b, a))) ? a : b);
+         g1.clear();
+         g2.clear();
+         for ( ; aok && !groupLess(key, a) && !groupLess(a, key);
+               aok = r1.next(a))
+            g1.push_back(a);
+         for ( ; bok && !groupLess(key, b) && !groupLess(b, key);
+               bok = r2.next(b))
+            g2.push_back(b);
+
+         std::vector<bool> used1(g1.size(), false), used2(g2.size(), false);
+         for (size_t i = 0; i < g1.size(); i++)
+         {
+            for (size_t j = 0; j < g2.size(); j++)
+            {
+               if (!used2[j] && match(g1[i], g2[j]))
+               {
+                  used1[i] = used2[j] = true;
+                  if (pass == pairedDiffs)
+                     op.both(g1[i], g2[j]);
+                  break;
+               }
+            }
+         }
+         for (size_t i = 0; pass == firstOnlyDiffs && i < g1.size(); i++)
+            if (!used1[i])
+               op.first(g1[i]);
+         for (size_t j = 0; pass == secondOnlyDiffs && j < g2.size(); j++)
+            if (!used2[j])
+               op.second(g2[j]);
+      }
+   }
 };
 
 
@@ -34,7 +34,7 @@
 //
 //=============================================================================
 
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 
 #include "RinexMetData.hpp"
 #include "RinexMetStream.hpp"
@@ -63,13 +63,71 @@ protected:
 };
 
 
+   /// Groups the differences by time.
+struct TimeLess
+{
+   bool operator()(const RinexMetData& l, const RinexMetData& r) const
+   { return l.time < r.time; }
+};
+
+
+   /// Pairs the differences of the same time.
+struct TimeEquals
+{
+   bool operator()(const RinexMetData& l, const RinexMetData& r) const
+   { return l.time == r.time; }
+};
+
+
+   /// Prints the differences found by RMWDiff::process().
+struct MetDiffPrinter
+{
+   MetDiffPrinter(const string& name1, const string& name2,
+                  const set<RinexMetHeader::RinexMetType>& obs)
+         : marker1(name1), marker2(name2), intersection(obs)
+   {}
+
+      /// Prints the differences of the data of the same time.
+   void both(RinexMetData& first, RinexMetData& second)
+   {
+      YDSTime recTime(first.time);
+      cout << setw(3) << recTime.doy << ' ' 
+           << setw(10) << setprecision(0) << fixed
+           << recTime.sod << ' ' 
+           << marker1 << ' '
+           << marker2 << ' ';
+
+      set<RinexMetHeader::RinexMetType>::const_iterator m;
+      for (m = intersection.begin(); m != intersection.end(); m++)
+      {
+         double diff = first.data[*m];
+         diff -= second.data[*m];
+
+         cout << setw(7) << setprecision(1) << fixed << diff << ' '
+              << RinexMetHeader::convertObsType(*m) << ' ';
+
+      }
+      cout << endl;
+   }
+
+   void first(RinexMetData& data)
+   { cout << '<' << data.stableText(); }
+
+   void second(RinexMetData& data)
+   { cout << '>' << data.stableText(); }
+
+   string marker1, marker2;
+   const set<RinexMetHeader::RinexMetType>& intersection;
+};
+
+
 void RMWDiff::process()
 {
    try
    {
-      FileFilterFrameWithHeader<RinexMetStream, RinexMetData, RinexMetHeader>
-         ff1(inputFileOption.getValue()[0]),
-         ff2(inputFileOption.getValue()[1]);
+      ExternalFileFilter<RinexMetStream, RinexMetData, RinexMetHeader>
+         ff1(inputFileOption.getValue()[0], maxRecords()),
+         ff2(inputFileOption.getValue()[1], maxRecords());
 
          // find the obs data intersection
       RinexMetHeaderTouchHeaderMerge merged;
@@ -114,10 +172,12 @@ void RMWDiff::process()
       ff1.sort(RinexMetDataOperatorLessThanFull(intersection));
       ff2.sort(RinexMetDataOperatorLessThanFull(intersection));
 
-      pair< list<RinexMetData>, list<RinexMetData> > difflist = 
-         ff1.diff(ff2, RinexMetDataOperatorLessThanFull(intersection));
+      ExternalFileFilter<RinexMetStream, RinexMetData, RinexMetHeader>
+         only1(maxRecords()), only2(maxRecords());
+      ff1.diff(ff2, RinexMetDataOperatorLessThanFull(intersection),
+               only1, only2);
 
-      if (difflist.first.empty() && difflist.second.empty())
+      if (only1.empty() && only2.empty())
       {
             // no differences
          exitCode = 0;
@@ -127,60 +187,19 @@ void RMWDiff::process()
          // differences found
       exitCode = DIFFS_CODE;
 
-      list<RinexMetData>::iterator firstitr = difflist.first.begin();
-      while (firstitr != difflist.first.end())
-      {
-         bool matched = false;
-         list<RinexMetData>::iterator seconditr = difflist.second.begin();
-         while ((!matched) && (seconditr != difflist.second.end()))
-         {
-            if (firstitr->time == seconditr->time)
-            {
-               YDSTime recTime(firstitr->time);
-               cout << setw(3) << recTime.doy << ' ' 
-                    << setw(10) << setprecision(0) << fixed
-                    << recTime.sod << ' ' 
-                    << ff1.frontHeader().markerName << ' '
-                    << ff2.frontHeader().markerName << ' ';
-
-               for (m = intersection.begin(); m != intersection.end(); m++)
-               {
-                  double diff = firstitr->data[*m];
-                  diff -= seconditr->data[*m];
-
-                  cout << setw(7) << setprecision(1) << fixed << diff << ' '
-                       << RinexMetHeader::convertObsType(*m) << ' ';
-
-               }
-               cout << endl;
-
-               firstitr = difflist.first.erase(firstitr);
-               seconditr = difflist.second.erase(seconditr);
-               matched = true;
-            }
-            else
-               seconditr++;
-         }
-
-         if (!matched)
-            firstitr++;
-      }
-
-      list<RinexMetData>::iterator itr = difflist.first.begin();
-      while (itr != difflist.first.end())
-      {
-         cout << '<' << itr->stableText();
-         itr++;
-      }
+         // records of the same time are differenced, the rest are
+         // printed afterwards
+      MetDiffPrinter printer(ff1.frontHeader().markerName,
+                             ff2.frontHeader().markerName, intersection);
+      pairDiffs<RinexMetData>(only1, only2, TimeLess(), TimeEquals(), printer,
+                              pairedDiffs);
+      pairDiffs<RinexMetData>(only1, only2, TimeLess(), TimeEquals(), printer,
+                              firstOnlyDiffs);
 
       cout << endl;
 
-      itr = difflist.second.begin();
-      while (itr != difflist.second.end())
-      {
-         cout << '>' << itr->stableText();
-         itr++;
-      }
+      pairDiffs<RinexMetData>(only1, only2, TimeLess(), TimeEquals(), printer,
+                              secondOnlyDiffs);
 
    }
    catch(Exception& e)
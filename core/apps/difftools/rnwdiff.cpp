@@ -35,7 +35,7 @@
 //=============================================================================
 
 #include <RINEX3/Rinex3ObsFilterOperators.hpp>
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 
 #include "Rinex3NavData.hpp"
 #include "Rinex3NavStream.hpp"
@@ -91,9 +91,9 @@ void RNWDiff::process()
 {
    try
    {
-      FileFilterFrameWithHeader<Rinex3NavStream, Rinex3NavData, Rinex3NavHeader>
-         ff1(inputFileOption.getValue()[0]),
-         ff2(inputFileOption.getValue()[1]);
+      ExternalFileFilter<Rinex3NavStream, Rinex3NavData, Rinex3NavHeader>
+         ff1(inputFileOption.getValue()[0], maxRecords()),
+         ff2(inputFileOption.getValue()[1], maxRecords());
 
          // no data?  FIX make this program faster.. if one file
          // doesn't exist, there's little point in reading any.
@@ -119,8 +119,16 @@ void RNWDiff::process()
       //set desired precision for diffs
       op.setPrecision(precision);
 
-      pair< list<Rinex3NavData>, list<Rinex3NavData> > difflist =
-         ff1.diff(ff2, op);
+      ExternalFileFilter<Rinex3NavStream, Rinex3NavData, Rinex3NavHeader>
+         only1(maxRecords()), only2(maxRecords());
+      ff1.diff(ff2, op, only1, only2);
+
+         // Messages are matched below whatever their week numbers, which
+         // come first in the sort order, so the differences (though not
+         // the files) are read into memory.
+      pair< list<Rinex3NavData>, list<Rinex3NavData> > difflist;
+      readDiffs(only1, difflist.first);
+      readDiffs(only2, difflist.second);
       
       if (difflist.first.empty() && difflist.second.empty())
       {
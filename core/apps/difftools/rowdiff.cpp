@@ -36,7 +36,7 @@
 
 /// This utility assumes that epochs are in ascending time order
 
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsFilterOperators.hpp"
 
@@ -88,8 +88,9 @@ bool ROWDiff::initialize(int argc, char* argv[]) throw()
 
 void ROWDiff::process()
 {
-   gpstk::FileFilterFrameWithHeader<Rinex3ObsStream, Rinex3ObsData, Rinex3ObsHeader>
-      ff1(inputFileOption.getValue()[0]), ff2(inputFileOption.getValue()[1]);
+   gpstk::ExternalFileFilter<Rinex3ObsStream, Rinex3ObsData, Rinex3ObsHeader>
+      ff1(inputFileOption.getValue()[0], maxRecords()),
+      ff2(inputFileOption.getValue()[1], maxRecords());
 
    // no data?  FIX make this program faster.. if one file
    // doesn't exist, there's little point in reading any.
@@ -222,15 +223,14 @@ void ROWDiff::process()
       }
    }
 
-   std::list<Rinex3ObsData> a =
-      ff1.halfDiff(ff2,Rinex3ObsDataOperatorLessThanFull(intersectRom), precision);
-   std::list<Rinex3ObsData> b =
-      ff2.halfDiff(ff1, Rinex3ObsDataOperatorLessThanFull(intersectRom), precision);
+   gpstk::ExternalFileFilter<Rinex3ObsStream, Rinex3ObsData, Rinex3ObsHeader>
+      only1(maxRecords()), only2(maxRecords());
+   ff1.halfDiff(ff2, Rinex3ObsDataOperatorLessThanFull(intersectRom), precision,
+                only1);
+   ff2.halfDiff(ff1, Rinex3ObsDataOperatorLessThanFull(intersectRom), precision,
+                only2);
 
-   pair< list<Rinex3ObsData>, list<Rinex3ObsData> > difflist =
-      pair< list<Rinex3ObsData>, list<Rinex3ObsData> >( a, b);
-
-   if (difflist.first.empty() && difflist.second.empty())
+   if (only1.empty() && only2.empty())
    {
       //Indicate to the user, before exiting, that rowdiff
       //performed properly and no differences were found.
@@ -243,12 +243,17 @@ void ROWDiff::process()
       // differences found
    exitCode = DIFFS_CODE;
 
-   list<Rinex3ObsData>::iterator firstDiffItr = difflist.first.begin();
-   list<Rinex3ObsData>::iterator secondDiffItr = difflist.second.begin();
-   while(firstDiffItr != difflist.first.end() || secondDiffItr != difflist.second.end())
+      // both lists are in time order, so they are read in step
+   gpstk::ExternalFileFilter<Rinex3ObsStream, Rinex3ObsData, Rinex3ObsHeader>
+      ::Reader firstReader(only1), secondReader(only2);
+   Rinex3ObsData firstDiff, secondDiff;
+   Rinex3ObsData *firstDiffItr = &firstDiff, *secondDiffItr = &secondDiff;
+   bool firstOk = firstReader.next(firstDiff);
+   bool secondOk = secondReader.next(secondDiff);
+   while(firstOk || secondOk)
    {
          //Epoch in both files
-      if(firstDiffItr->time == secondDiffItr->time)
+      if(firstOk && secondOk && firstDiffItr->time == secondDiffItr->time)
       {
          Rinex3ObsData::DataMap::iterator firstObsItr = firstDiffItr->obs.begin();
          Rinex3ObsData::DataMap::iterator secondObsItr = secondDiffItr->obs.begin();
@@ -317,11 +322,11 @@ void ROWDiff::process()
             cout << endl;
          }
 
-         firstDiffItr++;
-         secondDiffItr++;
+         firstOk = firstReader.next(firstDiff);
+         secondOk = secondReader.next(secondDiff);
       }
          //Epoch only in first file
-      else if((firstDiffItr != difflist.first.end()) && firstDiffItr->time < secondDiffItr->time)
+      else if(firstOk && (!secondOk || firstDiffItr->time < secondDiffItr->time))
       {
          Rinex3ObsData::DataMap::iterator firstObsItr = firstDiffItr->obs.begin();
          for (;firstObsItr != firstDiffItr->obs.end(); firstObsItr++)
@@ -340,10 +345,10 @@ void ROWDiff::process()
             }
             cout << endl;
          }
-         firstDiffItr++;
+         firstOk = firstReader.next(firstDiff);
       }
          //Epoch only in second file
-      else if (secondDiffItr != difflist.second.end()) // && (secondDiffItr->time < firstDiffItr->time)
+      else // (secondDiffItr->time < firstDiffItr->time)
       {
          Rinex3ObsData::DataMap::iterator secondObsItr = secondDiffItr->obs.begin();
          for (;secondObsItr != secondDiffItr->obs.end(); secondObsItr++)
@@ -362,7 +367,7 @@ void ROWDiff::process()
             }
             cout << endl;
          }
-         secondDiffItr++;
+         secondOk = secondReader.next(secondDiff);
       }
    }
 }
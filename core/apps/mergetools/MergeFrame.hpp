@@ -38,6 +38,7 @@
 #define MERGEFRAME_HPP
 
 #include "BasicFramework.hpp"
+#include "StringUtils.hpp"
 
 /// Base class for writing utilities that merge files
 
@@ -62,9 +63,15 @@ public:
                             "Name for the merged output " + type + " file."
                             " Any existing file with that name will be"
                             " overwritten.", 
-                            true)
+                            true),
+           maxRecordsOption(0,
+                            "max-records",
+                            "Maximum number of records to hold in memory"
+                            " while sorting. Larger inputs are sorted in"
+                            " temporary files (default = 100000).")
    {
       outputFileOption.setMaxCount(1);
+      maxRecordsOption.setMaxCount(1);
    }
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Woverloaded-virtual"
@@ -78,6 +85,15 @@ protected:
 
    gpstk::CommandOptionRest inputFileOption;
    gpstk::CommandOptionWithAnyArg outputFileOption;
+   gpstk::CommandOptionWithNumberArg maxRecordsOption;
+
+      /// Returns the value of maxRecordsOption, 0 (the default) if unset.
+   size_t maxRecords() const
+   {
+      if (maxRecordsOption.getCount())
+         return gpstk::StringUtils::asUnsigned(maxRecordsOption.getValue()[0]);
+      return 0;
+   }
 };
 
 
@@ -41,7 +41,7 @@
 #include "RinexMetHeader.hpp"
 #include "RinexMetData.hpp"
 #include "RinexMetFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 #include "CivilTime.hpp"
 #include "SystemTime.hpp"
 
@@ -67,10 +67,10 @@ void MergeRinMet::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the data using
+      // the filter will sort and merge the data using
       // a simple time check
-   FileFilterFrameWithHeader<RinexMetStream, RinexMetData, RinexMetHeader> 
-      fff(files);
+   ExternalFileFilter<RinexMetStream, RinexMetData, RinexMetHeader> 
+      fff(files, maxRecords());
 
       // get the header data
    RinexMetHeaderTouchHeaderMerge merged;
@@ -38,7 +38,7 @@
 #include "RinexNavHeader.hpp"
 #include "RinexNavData.hpp"
 #include "RinexNavFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 #include "SystemTime.hpp"
 #include "CivilTime.hpp"
 
@@ -64,10 +64,10 @@ void MergeRinNav::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
+      // the filter will sort and merge the obs data using
       // a simple time check
-   FileFilterFrameWithHeader<RinexNavStream, RinexNavData, RinexNavHeader> 
-      fff(files);
+   ExternalFileFilter<RinexNavStream, RinexNavData, RinexNavHeader> 
+      fff(files, maxRecords());
 
       // get the header data
    RinexNavHeaderTouchHeaderMerge merged;
@@ -41,7 +41,7 @@
 #include "RinexObsHeader.hpp"
 #include "RinexObsData.hpp"
 #include "RinexObsFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "ExternalFileFilter.hpp"
 #include "SystemTime.hpp"
 #include "CivilTime.hpp"
 
@@ -67,10 +67,10 @@ void MergeRinObs::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
+      // the filter will sort and merge the obs data using
       // a simple time check
-   FileFilterFrameWithHeader<RinexObsStream, RinexObsData, RinexObsHeader> 
-      fff(files);
+   ExternalFileFilter<RinexObsStream, RinexObsData, RinexObsHeader> 
+      fff(files, maxRecords());
 
       // get the header data
    RinexObsHeaderTouchHeaderMerge merged;
@@ -42,9 +42,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <memory>
+#include <exception>
+#include <thread>
+#include <atomic>
 
 // GPSTK
 #include "Exception.hpp"
@@ -198,6 +203,7 @@ public:
    int maxReject;             // Max number of sats to reject [-1 for no limit]
    int nIter;                 // Maximum iteration count in linearized LS
    double convLimit;          // Minimum convergence criterion in estimation (meters)
+   int nthreads;              // threads solving epochs; not 1: epochs solved apart
 
    string TropStr;            // temp used to parse --trop
 
@@ -496,6 +502,10 @@ public:
             << " to PRS::SystemIDs";
       }
 
+      // the apriori solution has a clock for each system, so that the clocks
+      // are found when some systems have no satellites
+      prs.memory.setAPsystems(satSyss);
+
       // initialize apriori solution
       if(C.knownPos.getCoordinateSystem() != Position::Unknown)
          prs.memory.fixAPSolution(C.knownPos.X(),C.knownPos.Y(),C.knownPos.Z());
@@ -530,6 +540,40 @@ public:
    // same return value as RAIMCompute()
    int ComputeSolution(const CommonTime& t) throw(Exception);
 
+   // Data collected at one epoch, and its solutions computed by SolveEpoch(), for
+   // --threads. The solutions start from zero, not from the previous solution.
+   class EpochData {
+   public:
+      EpochData() throw() : solved(false), SPSiret(-3), iret(-3) { }
+
+      vector<SatID> Satellites;                 // as in SolutionObject
+      vector<double> PRanges,Elevations,ERanges,RIono,R1,R2;
+      multimap<RinexSatID,string> UsedObsIDs;
+
+      std::unique_ptr<TropModel> pTrop;        // copy of C.pTrop at this epoch
+      PRSolution SPS, RAIM;                     // the solutions
+      vector<SatID> Sats;                       // Satellites, as marked by RAIM
+      bool solved;                              // SolveEpoch() was called
+      int SPSiret, iret;                        // their return values
+      std::exception_ptr error;                 // thrown by SolveEpoch()
+   };
+
+   // Copy the data collected at this epoch to ed, to be solved later; also copy
+   // the configuration of prs and the trop model.
+   void SaveEpoch(EpochData& ed) const throw(Exception);
+
+   // Compute the solution(s) of ed; may be called on any thread, as it only
+   // writes to ed, and reads C.pEph. Output nothing.
+   void SolveEpoch(const CommonTime& t, EpochData& ed) const throw();
+
+   // Copy the data collected at the epoch of ed back, before FinishEpoch().
+   void RestoreEpoch(const EpochData& ed) throw();
+
+   // Output and accumulate the solutions of ed, just as ComputeSolution();
+   // SolveEpoch() is called if it has not been. Call in time order, after
+   // RestoreEpoch(); same return value as ComputeSolution().
+   int FinishEpoch(const CommonTime& t, EpochData& ed) throw(Exception);
+
    // Write out ORDs - call after ComputeSolution
    // pass it iret from ComputeSolution
    int WriteORDs(const CommonTime& t, const int iret) throw(Exception);
@@ -537,6 +581,26 @@ public:
    // Output final results
    void FinalOutput(void) throw(Exception);
 
+private:
+   // compute the inverse measurement covariance, for elevations elev
+   Matrix<double> MeasCovariance(const CommonTime& t, const vector<double>& elev)
+      const throw(Exception);
+
+   // compute the simple (no RAIM) solution in sps, for --SPSout
+   int SimpleSolution(PRSolution& sps, const CommonTime& t, vector<SatID>& sats,
+                      vector<SatID::SatelliteSystem>& syss,
+                      const vector<double>& PR, const Matrix<double>& invMCov,
+                      TropModel *pTrop) const throw(Exception);
+
+   // output the simple solution sps, for --SPSout
+   void OutputSimpleSolution(PRSolution& sps, const CommonTime& t, int iret)
+      throw(Exception);
+
+   // output the RAIM solution in prs and accumulate statistics, given the return
+   // value of RAIMCompute(); return it
+   int FinishSolution(const CommonTime& t, int iret) throw(Exception);
+
+public:
 // member data
 
    // true unless descriptor is not valid, or required ObsIDs are not available
@@ -578,10 +642,37 @@ public:
 
 }; // end class SolutionObject
 
+//------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+// An epoch read and collected for --threads, held until it is solved and finished
+class PendingEpoch {
+public:
+   string log;                                  // log output while reading it
+   Rinex3ObsData Rdata;                         // the data
+   vector<SolutionObject::EpochData> data;      // parallel to C.SolObjs
+};
+
+//------------------------------------------------------------------------------------
+// While it exists, send the log output to a string stream, if one is given.
+class LogHolder {
+public:
+   LogHolder(ostringstream *poss) throw() : pSaved(pLOGstrm)
+   { if(poss) pLOGstrm = poss; }
+   ~LogHolder() throw() { pLOGstrm = pSaved; }
+private:
+   ostream *pSaved;
+};
+
 //------------------------------------------------------------------------------------
 // prototypes
 int Initialize(string& errors) throw(Exception);
 int ProcessFiles(void) throw(Exception);
+void ProcessEpoch(const Rinex3ObsData& Rdata, Rinex3ObsStream& ostrm,
+                  vector<SolutionObject::EpochData> *pData) throw(Exception);
+void SolveEpochs(deque<PendingEpoch>& batch) throw(Exception);
+void FinishEpochs(deque<PendingEpoch>& batch, Rinex3ObsStream& ostrm)
+   throw(Exception);
+TropModel *CopyTropModel(const TropModel *pTrop) throw(Exception);
 
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
@@ -1225,7 +1316,7 @@ int ProcessFiles(void) throw(Exception)
 try {
    Configuration& C(Configuration::Instance());
    bool firstepoch(true);
-   int k,iret,nfiles;
+   int iret,nfiles;
    size_t i,j,nfile;
    Position PrevPos(C.knownPos);
    Rinex3ObsStream ostrm;
@@ -1357,7 +1448,18 @@ try {
       }
 
       // loop over epochs ---------------------------------------------
+      // with --threads, epochs are held, with their log output, in a batch until
+      // it is full, or while the trop model waits for the first solution
+      deque<PendingEpoch> batch;
+      ostringstream heldlog;
+      const size_t batchSize(C.debug > -1 ? 1 : 32*max(C.nthreads,1));
       while(1) {
+         if(!batch.empty() &&
+               (batch.size() >= batchSize || !C.TropPos || !C.TropTime))
+            FinishEpochs(batch, ostrm);
+
+         LogHolder holder(C.nthreads != 1 ? &heldlog : 0);
+
          try { istrm >> Rdata; }
          catch(Exception& e) {
             LOG(WARNING) << " Warning : Failed to read obs data (Exception "
@@ -1489,80 +1591,28 @@ try {
          // update the trop model's weather ------------------
          if(C.MetStore.size() > 0) C.setWeather(Rdata.time);
 
-         // put a blank line here for readability
-         LOG(INFO) << "";
-
-         // compute the solution(s) --------------------------
-         // tag for DAT - required for PRSplot
-         C.msg = printTime(Rdata.time,"DAT "+C.gpsfmt);
-
-         // compute and print the solution(s) ----------------
-         for(i=0; i<C.SolObjs.size(); ++i) {
-            // skip invalid descriptors
-            if(!C.SolObjs[i].isValid) continue;
-
-            // dump the "DAT" record
-            LOG(INFO) << C.SolObjs[i].dump((C.debug > -1 ? 2:1), "RPF", C.msg);
-
-            // compute the solution
-            j = C.SolObjs[i].ComputeSolution(Rdata.time);
-
-            // write ORDs, even if solution is not good
-            if(C.ORDout) C.SolObjs[i].WriteORDs(Rdata.time,j);
+         // hold the epoch, to solve it with the batch
+         if(C.nthreads != 1) {
+            batch.emplace_back();
+            PendingEpoch& pe(batch.back());
+            pe.log = heldlog.str();
+            heldlog.str("");
+            pe.Rdata = Rdata;
+            pe.data.resize(C.SolObjs.size());
+            for(i=0; i<C.SolObjs.size(); ++i)
+               if(C.SolObjs[i].isValid) C.SolObjs[i].SaveEpoch(pe.data[i]);
+            continue;
          }
 
-         // write to output RINEX ----------------------------
-         if(!C.OutputObsFile.empty()) {
-            Rinex3ObsData auxData;
-            auxData.time = Rdata.time;
-            auxData.clockOffset = Rdata.clockOffset;
-            auxData.epochFlag = 4;
-            ostringstream oss;
-            // loop over valid descriptors
-            for(k=0,i=0; i<C.SolObjs.size(); ++i) if(C.SolObjs[i].isValid) {
-               if(!C.SolObjs[i].prs.isValid())
-               {
-                  LOG(ERROR) << "Invalid soution!";
-                  break;
-               }
-               oss.str("");
-               oss << "XYZ" << fixed << setprecision(3)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(0)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(1)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(2);
-               oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-               oss.str("");
-               oss << "CLK" << fixed << setprecision(3);
-
-               for(j=0; j<C.SolObjs[i].prs.SystemIDs.size(); j++) {
-                  RinexSatID sat(1,C.SolObjs[i].prs.SystemIDs[j]);
-                  oss << " " << sat.systemString3()
-                     << " " << setw(11) << C.SolObjs[i].prs.Solution(3+j);
-               }
-               oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-               oss.str("");
-               oss << "DIA" << setw(2) << C.SolObjs[i].prs.Nsvs
-                  << fixed << setprecision(2)
-                  << " " << setw(4) << C.SolObjs[i].prs.PDOP
-                  << " " << setw(4) << C.SolObjs[i].prs.GDOP
-                  << " " << setw(8) << C.SolObjs[i].prs.RMSResidual
-                  << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-            }
-            auxData.numSVs = k;            // number of lines to write
-            auxData.auxHeader.valid |= Rinex3ObsHeader::validComment;
-            ostrm << auxData;
-
-            ostrm << Rdata;
-         }
+         // compute and output the solution(s), write output RINEX
+         ProcessEpoch(Rdata, ostrm, 0);
 
       }  // end while loop over epochs
 
+      // finish the held epochs, then output the log held after them
+      if(!batch.empty()) FinishEpochs(batch, ostrm);
+      LOGstrm << heldlog.str();
+
       istrm.close();
 
       // failure due to critical error
@@ -1581,6 +1631,184 @@ try {
 catch(Exception& e) { GPSTK_RETHROW(e); }
 }  // end ProcessFiles()
 
+//------------------------------------------------------------------------------------
+// Compute, or finish, and output the solution(s) at one epoch, and write output
+// RINEX. pData: if not 0, the data and solutions saved by SaveEpoch(), parallel to
+// C.SolObjs; else the data collected by the solution objects.
+void ProcessEpoch(const Rinex3ObsData& Rdata, Rinex3ObsStream& ostrm,
+                  vector<SolutionObject::EpochData> *pData) throw(Exception)
+{
+try {
+   Configuration& C(Configuration::Instance());
+   int k;
+   size_t i,j;
+
+   // put a blank line here for readability
+   LOG(INFO) << "";
+
+   // compute the solution(s) --------------------------
+   // tag for DAT - required for PRSplot
+   C.msg = printTime(Rdata.time,"DAT "+C.gpsfmt);
+
+   // compute and print the solution(s) ----------------
+   for(i=0; i<C.SolObjs.size(); ++i) {
+      // skip invalid descriptors
+      if(!C.SolObjs[i].isValid) continue;
+
+      // get back the data saved for the pool
+      if(pData) C.SolObjs[i].RestoreEpoch((*pData)[i]);
+
+      // dump the "DAT" record
+      LOG(INFO) << C.SolObjs[i].dump((C.debug > -1 ? 2:1), "RPF", C.msg);
+
+      // compute the solution, or finish the one computed on the pool
+      if(pData)
+         j = C.SolObjs[i].FinishEpoch(Rdata.time,(*pData)[i]);
+      else
+         j = C.SolObjs[i].ComputeSolution(Rdata.time);
+
+      // write ORDs, even if solution is not good
+      if(C.ORDout) C.SolObjs[i].WriteORDs(Rdata.time,j);
+   }
+
+   // write to output RINEX ----------------------------
+   if(!C.OutputObsFile.empty()) {
+      Rinex3ObsData auxData;
+      auxData.time = Rdata.time;
+      auxData.clockOffset = Rdata.clockOffset;
+      auxData.epochFlag = 4;
+      ostringstream oss;
+      // loop over valid descriptors
+      for(k=0,i=0; i<C.SolObjs.size(); ++i) if(C.SolObjs[i].isValid) {
+         if(!C.SolObjs[i].prs.isValid())
+         {
+            LOG(ERROR) << "Invalid soution!";
+            break;
+         }
+         oss.str("");
+         oss << "XYZ" << fixed << setprecision(3)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(0)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(1)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(2);
+         oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+         oss.str("");
+         oss << "CLK" << fixed << setprecision(3);
+
+         for(j=0; j<C.SolObjs[i].prs.SystemIDs.size(); j++) {
+            RinexSatID sat(1,C.SolObjs[i].prs.SystemIDs[j]);
+            oss << " " << sat.systemString3()
+               << " " << setw(11) << C.SolObjs[i].prs.Solution(3+j);
+         }
+         oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+         oss.str("");
+         oss << "DIA" << setw(2) << C.SolObjs[i].prs.Nsvs
+            << fixed << setprecision(2)
+            << " " << setw(4) << C.SolObjs[i].prs.PDOP
+            << " " << setw(4) << C.SolObjs[i].prs.GDOP
+            << " " << setw(8) << C.SolObjs[i].prs.RMSResidual
+            << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+      }
+      auxData.numSVs = k;            // number of lines to write
+      auxData.auxHeader.valid |= Rinex3ObsHeader::validComment;
+      ostrm << auxData;
+
+      ostrm << Rdata;
+   }
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}  // end ProcessEpoch()
+
+//------------------------------------------------------------------------------------
+// Compute the solutions of a batch of held epochs on a pool of C.nthreads threads.
+// Each thread takes the next epoch nobody has taken, and writes only to that
+// epoch's EpochData; the solution objects and the ephemeris store are only read.
+// Errors are saved, to be thrown when the epoch is finished.
+void SolveEpochs(deque<PendingEpoch>& batch) throw(Exception)
+{
+try {
+   Configuration& C(Configuration::Instance());
+   const size_t N(batch.size());
+   int numThreads(C.nthreads);
+   if(numThreads <= 0)
+      numThreads = std::thread::hardware_concurrency();
+   if(static_cast<size_t>(numThreads) > N)
+      numThreads = static_cast<int>(N);
+
+   std::atomic<size_t> next(0);
+   auto work = [&]()
+   {
+      size_t j;
+      while((j = next++) < N) {
+         for(size_t i=0; i<C.SolObjs.size(); ++i)
+            if(C.SolObjs[i].isValid)
+               C.SolObjs[i].SolveEpoch(batch[j].Rdata.time, batch[j].data[i]);
+      }
+   };
+
+   vector<std::thread> workers;
+   for(int t=1; t<numThreads; t++) {
+      try { workers.push_back(std::thread(work)); }
+      catch(std::exception&) { break; }     // go on with fewer threads
+   }
+   work();
+   for(size_t i=0; i<workers.size(); i++)
+      workers[i].join();
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}  // end SolveEpochs()
+
+//------------------------------------------------------------------------------------
+// Solve a batch of held epochs, unless debugging (then each is solved when it is
+// finished, so that the debug output is in order), then output the held log and
+// finish each epoch in time order.
+void FinishEpochs(deque<PendingEpoch>& batch, Rinex3ObsStream& ostrm)
+   throw(Exception)
+{
+try {
+   Configuration& C(Configuration::Instance());
+
+   if(C.debug < 0) SolveEpochs(batch);
+
+   for(size_t j=0; j<batch.size(); j++) {
+      LOGstrm << batch[j].log;
+      ProcessEpoch(batch[j].Rdata, ostrm, &batch[j].data);
+   }
+   batch.clear();
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}  // end FinishEpochs()
+
+//------------------------------------------------------------------------------------
+// Return a new copy of the trop model, which may then be used on another thread.
+TropModel *CopyTropModel(const TropModel *pTrop) throw(Exception)
+{
+   if(const ZeroTropModel *p = dynamic_cast<const ZeroTropModel*>(pTrop))
+      return new ZeroTropModel(*p);
+   if(const SimpleTropModel *p = dynamic_cast<const SimpleTropModel*>(pTrop))
+      return new SimpleTropModel(*p);
+   if(const SaasTropModel *p = dynamic_cast<const SaasTropModel*>(pTrop))
+      return new SaasTropModel(*p);
+   if(const NBTropModel *p = dynamic_cast<const NBTropModel*>(pTrop))
+      return new NBTropModel(*p);
+   if(const GGTropModel *p = dynamic_cast<const GGTropModel*>(pTrop))
+      return new GGTropModel(*p);
+   if(const GGHeightTropModel *p = dynamic_cast<const GGHeightTropModel*>(pTrop))
+      return new GGHeightTropModel(*p);
+   if(const NeillTropModel *p = dynamic_cast<const NeillTropModel*>(pTrop))
+      return new NeillTropModel(*p);
+   if(const GlobalTropModel *p = dynamic_cast<const GlobalTropModel*>(pTrop))
+      return new GlobalTropModel(*p);
+
+   Exception e("Cannot copy the trop model");
+   GPSTK_THROW(e);
+}
+
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 int routine(void) throw(Exception)
@@ -1629,6 +1857,7 @@ void Configuration::SetDefaults(void) throw()
       nIter = dummy.MaxNIterations;
       convLimit = dummy.ConvergenceLimit;
    }
+   nthreads = 1;
 
    userfmt = gpsfmt;
    help = verbose = false;
@@ -1832,6 +2061,12 @@ string Configuration::BuildCommandLine(void) throw()
 "   CODE = return value from solution algorithm (with words if --verbose)\n"
 "   [N]V = V for valid solution, NV for not valid (don't use!)\n"
 "\n"
+" Each epoch's solution normally starts from the solution at the previous epoch.\n"
+" With --threads n (n != 1) each epoch is solved apart, on a pool of threads,\n"
+" starting from zero; output, final solution and statistics are then built in\n"
+" time order as usual. They differ from those of --threads 1 only in niter, conv\n"
+" and round-off at the level of the convergence limit, and do not depend on n.\n"
+"\n"
 " Default values appear in () after options below.\n"
    ;
 
@@ -1913,6 +2148,8 @@ string Configuration::BuildCommandLine(void) throw()
    opts.Add(0, "Trop", "m,T,P,H", false, false, &TropStr, "",
             "Trop model <m> [one of Zero,Black,Saas,NewB,Neill,GG,GGHt,Global\n"
             "                      with optional weather T(C),P(mb),RH(%)]");
+   opts.Add(0, "threads", "n", false, false, &nthreads, "",
+            "Solve epochs apart on n threads (0: one per processor) [1: in turn]");
 
    opts.Add(0, "log", "fn", false, false, &LogFile, "# Output [for formats see "
             "GPSTK::Position (--ref) and GPSTK::Epoch (--timefmt)] :",
@@ -2094,6 +2331,9 @@ int Configuration::ExtraProcessing(string& errors, string& extras) throw()
    if(!OutputORDFile.empty() && knownPos.getCoordinateSystem() == Position::Unknown)
       oss << "Error : --ORDs requires --ref\n";
 
+   if(nthreads < 0)
+      oss << "Error : --threads must not be negative\n";
+
    // add new errors to the list
    msg = oss.str();
    //if(!msg.empty()) cmdlineErrors += msg;
@@ -2367,7 +2607,7 @@ void SolutionObject::CollectData(const RinexSatID& sat,
 int SolutionObject::ComputeSolution(const CommonTime& ttag) throw(Exception)
 {
    try {
-      int i,n,iret;
+      int iret;
       Configuration& C(Configuration::Instance());
 
       // is there data?
@@ -2379,89 +2619,263 @@ int SolutionObject::ComputeSolution(const CommonTime& ttag) throw(Exception)
       }
 
       // compute the inverse measurement covariance
-      Matrix<double> invMCov;       // default is empty
-      if(C.weight) {
-         n = Elevations.size();
-         invMCov = Matrix<double>(n,n);
-         ident(invMCov);            // start with identity
-         static const double elev0(30.0);
-         static const double sin0(::sin(elev0 * DEG_TO_RAD));
-         for(i=0; i<n; i++) if(Elevations[i] < elev0) {       // mod only el<30
-            double invsig(::sin(Elevations[i] * DEG_TO_RAD) / sin0);
-            invMCov(i,i) = invsig*invsig;
-         }
-         LOG(DEBUG) << "invMeasCov for " << Descriptor
-            << " at time " << printTime(ttag,C.longfmt) << "\n"
-            << fixed << setprecision(4) << invMCov;
-      }
+      Matrix<double> invMCov(MeasCovariance(ttag, Elevations));
 
       // get the straight solution --------------------------------------
       if(C.SPSout) {
-         Matrix<double> SVP;
-         iret=prs.PreparePRSolution(ttag, Satellites, satSyss, PRanges, C.pEph, SVP);
-
-         if(iret > -3) {
-            //Vector<double> APSol(5,0.0),Resid,Slopes;
-            Vector<double> Resid,Slopes;
-            //if(prs.hasMemory) APSol = prs.memory.getAprioriSolution(satSyss);
-            iret = prs.SimplePRSolution(ttag, Satellites, SVP,
-                                        invMCov, C.pTrop,
-                                        prs.MaxNIterations, prs.ConvergenceLimit,
-                                        satSyss, Resid, Slopes);
-         }
+         iret = SimpleSolution(prs, ttag, Satellites, satSyss, PRanges, invMCov,
+                               C.pTrop);
+         OutputSimpleSolution(prs, ttag, iret);
+      }
 
-         if(iret < 0) { LOG(VERBOSE) << "SimplePRS failed "
-            << (iret==-4 ? "to find ANY ephemeris" :
-               (iret==-3 ? "to find enough satellites with data" :
-               (iret==-2 ? "because the problem is singular" :
-              /*iret==-1*/ "because the algorithm failed to converge")))
+      // get the RAIM solution ------------------------------------------
+      iret = prs.RAIMCompute(ttag, Satellites, satSyss, PRanges, invMCov, C.pEph,
+                              C.pTrop);
+
+      return FinishSolution(ttag, iret);
+   }
+   catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+void SolutionObject::SaveEpoch(EpochData& ed) const throw(Exception)
+{
+   Configuration& C(Configuration::Instance());
+
+   ed.Satellites = Satellites;
+   ed.PRanges = PRanges;
+   ed.Elevations = Elevations;
+   ed.ERanges = ERanges;
+   ed.RIono = RIono;
+   ed.R1 = R1;
+   ed.R2 = R2;
+   ed.UsedObsIDs = UsedObsIDs;
+
+   // the solution starts from zero; prs.memory is applied in FinishEpoch()
+   ed.RAIM = prs;
+   ed.RAIM.memory.reset();
+
+   // the trop model may change with time (weather, first solution), and is
+   // changed by the solution
+   ed.pTrop.reset(CopyTropModel(C.pTrop));
+   ed.solved = false;
+}
+
+//------------------------------------------------------------------------------------
+void SolutionObject::SolveEpoch(const CommonTime& ttag, EpochData& ed) const throw()
+{
+   try {
+      Configuration& C(Configuration::Instance());
+
+      ed.solved = true;
+      ed.Sats = ed.Satellites;
+      if(ed.Sats.size() < 4) return;
+
+      vector<SatID::SatelliteSystem> syss(satSyss);
+      Matrix<double> invMCov(MeasCovariance(ttag, ed.Elevations));
+
+      if(C.SPSout) {
+         ed.SPS = ed.RAIM;
+         ed.SPSiret = SimpleSolution(ed.SPS, ttag, ed.Sats, syss, ed.PRanges,
+                                     invMCov, ed.pTrop.get());
+      }
+
+      ed.iret = ed.RAIM.RAIMCompute(ttag, ed.Sats, syss, ed.PRanges, invMCov,
+                                    C.pEph, ed.pTrop.get());
+   }
+   catch(...) { ed.error = std::current_exception(); }
+}
+
+//------------------------------------------------------------------------------------
+void SolutionObject::RestoreEpoch(const EpochData& ed) throw()
+{
+   Satellites = ed.Satellites;
+   PRanges = ed.PRanges;
+   Elevations = ed.Elevations;
+   ERanges = ed.ERanges;
+   RIono = ed.RIono;
+   R1 = ed.R1;
+   R2 = ed.R2;
+   UsedObsIDs = ed.UsedObsIDs;
+}
+
+//------------------------------------------------------------------------------------
+int SolutionObject::FinishEpoch(const CommonTime& ttag, EpochData& ed)
+   throw(Exception)
+{
+   try {
+      size_t i,j,k;
+      Configuration& C(Configuration::Instance());
+
+      // is there data?
+      if(Satellites.size() < 4) {
+         LOG(VERBOSE) << "Solution algorithm failed, not enough data"
             << " for " << Descriptor
-            << " at time " << printTime(ttag,C.longfmt) << " iret " << iret;
-         }
-         else {
-            // at this point we have a good solution
-
-            // output XYZ solution
-            LOG(INFO) << prs.outputString(string("SPS ")+Descriptor,iret);
-
-            if(prs.RMSFlag || prs.SlopeFlag || prs.TropFlag)
-               LOG(WARNING) << "Warning for " << Descriptor
-                  << " - possible degraded SPS solution at "
-                  << printTime(ttag,C.longfmt) << " due to"
-                  << (prs.RMSFlag ? " large RMS":"")           // NB strings are used
-                  << (prs.SlopeFlag ? " large slope":"")       // in PRSplot.pl
-                  << (prs.TropFlag ? " missed trop. corr.":"");
-
-            // compute residuals using known position, output XYZ resids, NEU resids
-            if(C.knownPos.getCoordinateSystem() != Position::Unknown && iret >= 0) {
-               Matrix<double> Cov;
-               Vector<double> V(3);
-
-               // compute residuals in XYZ
-               Position pos(prs.Solution(0), prs.Solution(1), prs.Solution(2));
-               Position res=pos-C.knownPos;
-               // their covariance
-               Cov = Matrix<double>(prs.Covariance,0,0,3,3);
-               // output these as SPR record
-               V(0) = res.X(); V(1) = res.Y(); V(2) = res.Z();
-               LOG(INFO) << prs.outputPOSString(string("SPR ")+Descriptor,iret,V);
-               // and accumulate statistics on XYZ residuals
-               //statsSPSXYZresid.add(V,Cov);
-
-               // convert to NEU
-               V = C.Rot * V;
-               Cov = C.Rot * Cov * transpose(C.Rot);
-               // output them as RNE record
-               LOG(INFO) << prs.outputPOSString(string("SNE ")+Descriptor,iret,V);
-               // and accumulate statistics on NEU residuals
-               //statsSPSNEUresid.add(V,Cov);
+            << " at time " << printTime(ttag,C.longfmt);
+         return -3;
+      }
+
+      if(!ed.solved) SolveEpoch(ttag, ed);
+      if(ed.error) std::rethrow_exception(ed.error);
+
+      // RAIMCompute() marks the rejected satellites
+      Satellites = ed.Sats;
+
+      // SimplePRSolution() leaves the DOPs and the RMS and slope flags of the
+      // previous RAIM solution, and ComputeSolution() outputs them
+      if(C.SPSout) {
+         ed.SPS.TDOP = prs.TDOP;
+         ed.SPS.PDOP = prs.PDOP;
+         ed.SPS.GDOP = prs.GDOP;
+         ed.SPS.RMSFlag = prs.RMSFlag;
+         ed.SPS.SlopeFlag = prs.SlopeFlag;
+         OutputSimpleSolution(ed.SPS, ttag, ed.SPSiret);
+      }
+
+      // take the RAIM solution, but keep the memory of the previous epochs
+      ed.RAIM.memory = prs.memory;
+      prs = ed.RAIM;
+
+      // add it to the memory, as RAIMCompute() does; the solution started from
+      // zero, so its pre-fit residuals Partials*(Solution-apriori)-Resids have
+      // zero for apriori. APSol has a clock for each of SystemIDs, the systems
+      // with good satellites at this epoch, while RAIMCompute() pads Partials,
+      // like Solution, with a clock column for each of satSyss.
+      if(ed.iret >= 0 && prs.hasMemory) {
+         Vector<double> APSol(prs.memory.getAprioriSolution(prs.SystemIDs));
+         for(i=0; i<prs.PreFitResidual.size(); i++) {
+            double PA(0.0);
+            for(k=0; k<3; k++) PA += prs.Partials(i,k)*APSol(k);
+            for(j=0; j<prs.SystemIDs.size(); j++) {
+               k = 3 + (find(satSyss.begin(),satSyss.end(),prs.SystemIDs[j])
+                        - satSyss.begin());
+               PA += prs.Partials(i,k)*APSol(3+j);
             }
+            prs.PreFitResidual(i) -= PA;
          }
-      }  // end if SPSout
+         prs.memory.add(prs.Solution, prs.Covariance, prs.PreFitResidual,
+                        prs.Partials, prs.invMeasCov);
+      }
 
-      // get the RAIM solution ------------------------------------------
-      iret = prs.RAIMCompute(ttag, Satellites, satSyss, PRanges, invMCov, C.pEph,
-                              C.pTrop);
+      return FinishSolution(ttag, ed.iret);
+   }
+   catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+Matrix<double> SolutionObject::MeasCovariance(const CommonTime& ttag,
+                                              const vector<double>& elev)
+   const throw(Exception)
+{
+   Configuration& C(Configuration::Instance());
+
+   Matrix<double> invMCov;       // default is empty
+   if(C.weight) {
+      int i,n(elev.size());
+      invMCov = Matrix<double>(n,n);
+      ident(invMCov);            // start with identity
+      static const double elev0(30.0);
+      static const double sin0(::sin(elev0 * DEG_TO_RAD));
+      for(i=0; i<n; i++) if(elev[i] < elev0) {             // mod only el<30
+         double invsig(::sin(elev[i] * DEG_TO_RAD) / sin0);
+         invMCov(i,i) = invsig*invsig;
+      }
+      LOG(DEBUG) << "invMeasCov for " << Descriptor
+         << " at time " << printTime(ttag,C.longfmt) << "\n"
+         << fixed << setprecision(4) << invMCov;
+   }
+
+   return invMCov;
+}
+
+//------------------------------------------------------------------------------------
+int SolutionObject::SimpleSolution(PRSolution& sps, const CommonTime& ttag,
+                                   vector<SatID>& sats,
+                                   vector<SatID::SatelliteSystem>& syss,
+                                   const vector<double>& PR,
+                                   const Matrix<double>& invMCov,
+                                   TropModel *pTrop)
+   const throw(Exception)
+{
+   Configuration& C(Configuration::Instance());
+
+   Matrix<double> SVP;
+   int iret = sps.PreparePRSolution(ttag, sats, syss, PR, C.pEph, SVP);
+
+   if(iret > -3) {
+      //Vector<double> APSol(5,0.0),Resid,Slopes;
+      Vector<double> Resid,Slopes;
+      //if(sps.hasMemory) APSol = sps.memory.getAprioriSolution(syss);
+      iret = sps.SimplePRSolution(ttag, sats, SVP, invMCov, pTrop,
+                                  sps.MaxNIterations, sps.ConvergenceLimit,
+                                  syss, Resid, Slopes);
+   }
+
+   return iret;
+}
+
+//------------------------------------------------------------------------------------
+void SolutionObject::OutputSimpleSolution(PRSolution& sps, const CommonTime& ttag,
+                                          int iret)
+   throw(Exception)
+{
+   Configuration& C(Configuration::Instance());
+
+   if(iret < 0) { LOG(VERBOSE) << "SimplePRS failed "
+      << (iret==-4 ? "to find ANY ephemeris" :
+         (iret==-3 ? "to find enough satellites with data" :
+         (iret==-2 ? "because the problem is singular" :
+        /*iret==-1*/ "because the algorithm failed to converge")))
+      << " for " << Descriptor
+      << " at time " << printTime(ttag,C.longfmt) << " iret " << iret;
+   }
+   else {
+      // at this point we have a good solution
+
+      // output XYZ solution
+      LOG(INFO) << sps.outputString(string("SPS ")+Descriptor,iret);
+
+      if(sps.RMSFlag || sps.SlopeFlag || sps.TropFlag)
+         LOG(WARNING) << "Warning for " << Descriptor
+            << " - possible degraded SPS solution at "
+            << printTime(ttag,C.longfmt) << " due to"
+            << (sps.RMSFlag ? " large RMS":"")           // NB strings are used
+            << (sps.SlopeFlag ? " large slope":"")       // in PRSplot.pl
+            << (sps.TropFlag ? " missed trop. corr.":"");
+
+      // compute residuals using known position, output XYZ resids, NEU resids
+      if(C.knownPos.getCoordinateSystem() != Position::Unknown && iret >= 0) {
+         Matrix<double> Cov;
+         Vector<double> V(3);
+
+         // compute residuals in XYZ
+         Position pos(sps.Solution(0), sps.Solution(1), sps.Solution(2));
+         Position res=pos-C.knownPos;
+         // their covariance
+         Cov = Matrix<double>(sps.Covariance,0,0,3,3);
+         // output these as SPR record
+         V(0) = res.X(); V(1) = res.Y(); V(2) = res.Z();
+         LOG(INFO) << sps.outputPOSString(string("SPR ")+Descriptor,iret,V);
+         // and accumulate statistics on XYZ residuals
+         //statsSPSXYZresid.add(V,Cov);
+
+         // convert to NEU
+         V = C.Rot * V;
+         Cov = C.Rot * Cov * transpose(C.Rot);
+         // output them as RNE record
+         LOG(INFO) << sps.outputPOSString(string("SNE ")+Descriptor,iret,V);
+         // and accumulate statistics on NEU residuals
+         //statsSPSNEUresid.add(V,Cov);
+      }
+   }
+}
+
+//------------------------------------------------------------------------------------
+int SolutionObject::FinishSolution(const CommonTime& ttag, int iret)
+   throw(Exception)
+{
+   try {
+      Configuration& C(Configuration::Instance());
 
       if(iret < 0) {
          LOG(VERBOSE) << "RAIMCompute failed "
@@ -0,0 +1,1115 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ExternalFileFilter.hpp
+ * Sorting and filtering of file data that may not fit in memory.
+ */
+
+#ifndef GPSTK_EXTERNALFILEFILTER_HPP
+#define GPSTK_EXTERNALFILEFILTER_HPP
+
+#include <cstdio>
+#include <cmath>
+#include <list>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <exception>
+
+#include "Exception.hpp"
+#include "FileUtils.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileDirProc
+      //@{
+
+      /**
+       * This class does the job of FileFilterFrameWithHeader for data sets
+       * that are too large to be held in memory.
+       *
+       * The constructor only reads the headers of the input files. The
+       * data is read when it is first needed, and no more than
+       * getMaxRecords() records are ever held in memory: sort() reads the
+       * input into runs of at most that many records, sorts them and, when
+       * the limit is reached, writes the largest run to a temporary file
+       * (in the file's own format, with the header of the file the
+       * records came from). The sorted runs are then read back through a
+       * k-way merge, one record from each run at a time, by unique(),
+       * filter(), touch(), diff() and writeFile(). Operations that remove
+       * or change records write their result as new runs, so they too
+       * stream the data instead of loading it; diff() and halfDiff()
+       * likewise write the differences to other ExternalFileFilter
+       * objects, which are read back with a Reader.
+       *
+       * Results are the same as those of FileFilterFrameWithHeader with
+       * the same operations, and records that compare equal keep the order
+       * of the input files. When the data fits in memory no temporary file
+       * is written at all.
+       *
+       * @code
+       *   ExternalFileFilter<RinexObsStream, RinexObsData, RinexObsHeader>
+       *      eff(files, 500000);
+       *
+       *   RinexObsHeaderTouchHeaderMerge merged;
+       *   eff.touchHeader(merged);
+       *
+       *   eff.sort(RinexObsDataOperatorLessThanFull(merged.obsSet));
+       *   eff.unique(RinexObsDataOperatorEqualsSimple());
+       *   eff.writeFile(outputFile, merged.theHeader);
+       * @endcode
+       *
+       * Temporary files are created in getTempDir() (by default TMPDIR
+       * or the system temporary directory), and are removed by the
+       * destructor.
+       *
+       * @warning touch() must not change the records in a way that
+       * changes their order, since the runs are not sorted again.
+       */
+   template <class FileStream, class FileData, class FileHeader>
+   class ExternalFileFilter
+   {
+   public:
+         /// Default limit on the number of records held in memory.
+      static const size_t defaultMaxRecords = 100000;
+
+         /// Default limit on the number of runs merged at once.
+      static const size_t defaultMaxOpenRuns = 64;
+
+         /// Default constructor. In all constructors, maxRecs is the
+         /// maximum number of records held in memory; 0 means
+         /// defaultMaxRecords.
+      ExternalFileFilter(size_t maxRecs = defaultMaxRecords)
+            : maxRecords(maxRecs > 0 ? maxRecs : defaultMaxRecords),
+              maxOpenRuns(defaultMaxOpenRuns), sorted(false), filtered(0)
+      {}
+
+         /// Takes a list of files; only their headers are read here.
+      ExternalFileFilter(const std::vector<std::string>& fileList,
+                         size_t maxRecs = defaultMaxRecords)
+         throw(gpstk::Exception)
+            : maxRecords(maxRecs > 0 ? maxRecs : defaultMaxRecords),
+              maxOpenRuns(defaultMaxOpenRuns), sorted(false), filtered(0)
+      { newSource(fileList); }
+
+         /// Takes a file name; only its header is read here.
+      ExternalFileFilter(const std::string& filename,
+                         size_t maxRecs = defaultMaxRecords)
+         throw(gpstk::Exception)
+            : maxRecords(maxRecs > 0 ? maxRecs : defaultMaxRecords),
+              maxOpenRuns(defaultMaxOpenRuns), sorted(false), filtered(0)
+      { newSource(filename); }
+
+         /// Destructor; removes the temporary files.
+      virtual ~ExternalFileFilter()
+      { clear(); }
+
+         /// Adds the data of a file. Only its header is read here.
+      ExternalFileFilter& newSource(const std::string& filename)
+         throw(gpstk::Exception);
+
+         /// Adds the data of a list of files. Only their headers are
+         /// read here.
+      ExternalFileFilter& newSource(const std::vector<std::string>& fileList)
+         throw(gpstk::Exception)
+      {
+         for (size_t i = 0; i < fileList.size(); i++)
+            newSource(fileList[i]);
+         return *this;
+      }
+
+         /// Sets the maximum number of records held in memory; 0 means
+         /// defaultMaxRecords.
+      void setMaxRecords(size_t n)
+      { maxRecords = (n > 0 ? n : defaultMaxRecords); }
+
+         /// Returns the maximum number of records held in memory.
+      size_t getMaxRecords(void) const
+      { return maxRecords; }
+
+         /// Sets the maximum number of runs merged at once, which bounds
+         /// the number of files open at the same time.
+      void setMaxOpenRuns(size_t n)
+      { maxOpenRuns = (n > 1 ? n : 2); }
+
+         /// Returns the maximum number of runs merged at once.
+      size_t getMaxOpenRuns(void) const
+      { return maxOpenRuns; }
+
+         /// Sets the directory for temporary files.
+      void setTempDir(const std::string& dir)
+      { tempDir = dir; }
+
+         /// Returns the directory for temporary files; empty means the
+         /// default one.
+      std::string getTempDir(void) const
+      { return tempDir; }
+
+         /// Sorts the data.
+         /// @warning comp MUST be a strict weak ordering!
+      template <class Compare>
+      ExternalFileFilter& sort(Compare comp)
+         throw(gpstk::Exception)
+      {
+         LessThan newLess(comp);
+         RunBuilder builder(*this, &newLess);
+         {
+            Cursor c(*this, allRuns());
+            FileData data;
+            size_t header;
+            while (c.next(data, header))
+               builder.add(data, header);
+         }
+         replaceRuns(builder.finish());
+         less = newLess;
+         sorted = true;
+         reduceRuns();
+         return *this;
+      }
+
+         /// After sorting, use this to ensure that each data value is unique.
+         /// Filtered count is incremented for each duplicate value removed.
+         /// @param bp Test for equality
+         /// @warning The data must be sorted first
+      template <class BinaryPredicate>
+      ExternalFileFilter& unique(BinaryPredicate bp)
+         throw(gpstk::Exception)
+      {
+         filtered = 0;
+         RunBuilder builder(*this, 0);
+         {
+            Cursor c(*this, allRuns());
+            FileData data, last;
+            size_t header;
+            bool first = true;
+               // keep only the first of many unique values
+            while (c.next(data, header))
+            {
+               if (!first && bp(last, data))
+               {
+                  filtered++;
+                  continue;
+               }
+               builder.add(data, header);
+               last = data;
+               first = false;
+            }
+         }
+         replaceRuns(builder.finish());
+         return *this;
+      }
+
+         /// This filters data based on a single test.  All data that
+         /// passes the UnaryPredicate (i.e. it returns true) is removed
+         /// Filtered count is incremented for each value removed.
+      template <class Predicate>
+      ExternalFileFilter& filter(Predicate up)
+         throw(gpstk::Exception)
+      {
+         filtered = 0;
+         RunBuilder builder(*this, 0);
+         {
+            Cursor c(*this, allRuns());
+            FileData data;
+            size_t header;
+            while (c.next(data, header))
+            {
+               if (up(data))
+                  filtered++;
+               else
+                  builder.add(data, header);
+            }
+         }
+         replaceRuns(builder.finish());
+         return *this;
+      }
+
+         /// Applies Operation on all the data elements, counting each one that
+         /// gets modified (for which Operation returns true). The operation
+         /// is passed by reference so that it can retain state information
+         /// for use by the program calling it.
+      template <class Operation>
+      ExternalFileFilter& touch(Operation& op)
+         throw(gpstk::Exception)
+      {
+         filtered = 0;
+         RunBuilder builder(*this, 0);
+         {
+            Cursor c(*this, allRuns());
+            FileData data;
+            size_t header;
+            while (c.next(data, header))
+            {
+               if (op(data))
+                  filtered++;
+               builder.add(data, header);
+            }
+         }
+         replaceRuns(builder.finish());
+         return *this;
+      }
+
+         /// a const operator touch for the classes that need it.
+      template <class Operation>
+      ExternalFileFilter& touch(const Operation& op)
+         throw(gpstk::Exception)
+      {
+         Operation o(op);
+         return touch(o);
+      }
+
+         /// Calls op on each record, in order, without changing the data.
+      template <class Operation>
+      void forEach(Operation& op) const
+         throw(gpstk::Exception)
+      {
+         Cursor c(*this, allRuns());
+         FileData data;
+         size_t header;
+         while (c.next(data, header))
+            op(data);
+      }
+
+         /**
+          * Finds the data in *this that isn't in r and the data in r
+          * that isn't in *this, as FileFilterFrameWithHeader::diff()
+          * does, without holding either in memory. The differences are
+          * written to onlyThis and onlyR, which are cleared first and
+          * take the headers of *this and r respectively. Like the result
+          * of any other operation they are kept in temporary files when
+          * larger than their getMaxRecords(); use a Reader to go through
+          * them. Remember that /a p has to be a strict weak ordering on
+          * the data.
+          * @warning the input data needs to be sorted according to /a p
+          * before running diff().
+          * @throw InvalidRequest if onlyThis or onlyR is *this or r.
+          */
+      template <class BinaryPredicate>
+      void diff(const ExternalFileFilter& r, BinaryPredicate p,
+                ExternalFileFilter& onlyThis, ExternalFileFilter& onlyR) const
+         throw(gpstk::Exception)
+      {
+         checkOutput(r, onlyThis, "diff");
+         checkOutput(r, onlyR, "diff");
+         onlyThis.assignHeaders(*this);
+         onlyR.assignHeaders(r);
+         {
+            RunBuilder lb(onlyThis, 0), rb(onlyR, 0);
+            Cursor lc(*this, allRuns()), rc(r, r.allRuns());
+            FileData ld, rd;
+            size_t lh, rh;
+            bool lok = lc.next(ld, lh), rok = rc.next(rd, rh);
+
+            while (lok && rok)
+            {
+               if (p(ld, rd))
+               {
+                  lb.add(ld, lh);
+                  lok = lc.next(ld, lh);
+               }
+               else if (p(rd, ld))
+               {
+                  rb.add(rd, rh);
+                  rok = rc.next(rd, rh);
+               }
+               else
+               {
+                  lok = lc.next(ld, lh);
+                  rok = rc.next(rd, rh);
+               }
+            }
+            for ( ; lok; lok = lc.next(ld, lh))
+               lb.add(ld, lh);
+            for ( ; rok; rok = rc.next(rd, rh))
+               rb.add(rd, rh);
+
+            onlyThis.replaceRuns(lb.finish());
+            onlyR.replaceRuns(rb.finish());
+         }
+         onlyThis.reduceRuns();
+         onlyR.reduceRuns();
+      }
+
+         /// Finds the data in *this that isn't in r, as
+         /// FileFilterFrameWithHeader::halfDiff() does, and writes it to
+         /// onlyThis as diff() does.
+         /// @throw InvalidRequest if onlyThis is *this or r.
+      template <class BinaryPredicate>
+      void halfDiff(const ExternalFileFilter& r, BinaryPredicate p,
+                    int precision, ExternalFileFilter& onlyThis) const
+         throw(gpstk::Exception)
+      {
+         checkOutput(r, onlyThis, "halfDiff");
+         onlyThis.assignHeaders(*this);
+         {
+            long double epsilon = 1 / std::pow((long double)10,precision);
+            RunBuilder lb(onlyThis, 0);
+            Cursor lc(*this, allRuns()), rc(r, r.allRuns());
+            FileData ld, rd;
+            size_t lh, rh;
+            bool lok = lc.next(ld, lh), rok = rc.next(rd, rh);
+
+            while (lok)
+            {
+               if (!rok ||
+                   p(ld, headerList.front(), rd, r.headerList.front(), epsilon))
+               {
+                  lb.add(ld, lh);
+                  lok = lc.next(ld, lh);
+               }
+               else if (p(rd, r.headerList.front(), ld, headerList.front(),
+                          epsilon))
+               {
+                  rok = rc.next(rd, rh);
+               }
+               else
+               {
+                  lok = lc.next(ld, lh);
+                  rok = rc.next(rd, rh);
+               }
+            }
+
+            onlyThis.replaceRuns(lb.finish());
+         }
+         onlyThis.reduceRuns();
+      }
+
+         /**
+          * Writes the data to the file outputFile with the given header.
+          * This will overwrite any existing file with the same name.
+          * This can throw an exception when there's a file error.
+          * @return true when it works.
+          */
+      bool writeFile(const std::string& outputFile,
+                     const FileHeader& fh) const
+         throw(gpstk::Exception);
+
+         /// Returns the first record.
+         /// @throw InvalidRequest if there is no data
+      FileData front(void) const
+         throw(gpstk::InvalidRequest, gpstk::Exception);
+
+         /// Returns the number of items filtered from the last filter()
+         /// touch() or unique() call.
+      int getFiltered() const
+      { return filtered; }
+
+         /// Returns the number of data items in the filter. Before the
+         /// first operation, this reads the input files to count them.
+      size_t getDataCount(void) const
+         throw(gpstk::Exception);
+
+      bool empty() const
+         throw(gpstk::Exception)
+      { return getDataCount() == 0; }
+
+         /// Removes all the data and headers, and the temporary files.
+      void clear();
+
+         /** performs the operation op on the header list. */
+      template <class Operation>
+      ExternalFileFilter& touchHeader(Operation& op)
+      {
+         typename std::list<FileHeader>::iterator itr = headerList.begin();
+         while (itr != headerList.end())
+         {
+            op(*itr);
+            itr++;
+         }
+         return *this;
+      }
+
+         /// Returns the contents of the header data list.
+      std::list<FileHeader>& getHeaderData(void) {return headerList;}
+
+         /// Returns the contents of the header data list, const.
+      std::list<FileHeader> getHeaderData(void) const {return headerList;}
+
+         /// Returns the number of data items in the header list.
+      typename std::list<FileHeader>::size_type getHeaderCount(void) const
+      { return headerList.size(); }
+
+      bool emptyHeader() const
+      { return headerList.empty(); }
+
+      FileHeader& frontHeader()
+         throw(gpstk::InvalidRequest)
+      { chl("frontHeader"); return headerList.front(); }
+
+      const FileHeader& frontHeader() const
+         throw(gpstk::InvalidRequest)
+      { chl("frontHeader"); return headerList.front(); }
+
+      FileHeader& backHeader()
+         throw(gpstk::InvalidRequest)
+      { chl("backHeader"); return headerList.back(); }
+
+      const FileHeader& backHeader() const
+         throw(gpstk::InvalidRequest)
+      { chl("backHeader"); return headerList.back(); }
+
+   protected:
+         /// Ordering used by sort(), kept for the merge.
+      typedef std::function<bool(const FileData&, const FileData&)> LessThan;
+
+         /**
+          * A sequence of records that came from one input file. It is
+          * either an input file itself, a temporary file, or held in
+          * memory (when fileName is empty). Runs are sorted after
+          * sort(), and in file order before.
+          */
+      struct Run
+      {
+         Run(size_t h = 0)
+               : header(h), temporary(false), count(std::string::npos)
+         {}
+
+         bool inMemory() const
+         { return fileName.empty(); }
+
+            /// index in sourceHeaders of the header of the records
+         size_t header;
+            /// file holding the records
+         std::string fileName;
+            /// true if fileName is to be removed
+         bool temporary;
+            /// number of records, npos if not known yet
+         mutable size_t count;
+            /// the records of a run held in memory
+         std::vector<FileData> data;
+      };
+
+         /// Reads the records of one Run, in order.
+      class RunReader
+      {
+      public:
+         RunReader(const Run& r)
+               : run(r), pos(0), strm(0)
+         {
+            if (!run.inMemory())
+               strm = new FileStream(run.fileName.c_str());
+         }
+
+         ~RunReader()
+         { delete strm; }
+
+         bool next(FileData& data)
+         {
+            if (strm == 0)
+            {
+               if (pos >= run.data.size())
+                  return false;
+               data = run.data[pos++];
+               return true;
+            }
+            if (!strm->good() || !(*strm >> data))
+               return false;
+            pos++;
+            return true;
+         }
+
+         const Run& run;
+         size_t pos;
+
+      private:
+         FileStream *strm;
+         RunReader(const RunReader&);
+         RunReader& operator=(const RunReader&);
+      };
+
+         /**
+          * Reads a list of runs as a single sequence: concatenated if
+          * the data is not sorted, and by a k-way merge if it is. Ties
+          * go to the run that comes first in the list.
+          */
+      class Cursor
+      {
+      public:
+         Cursor(const ExternalFileFilter& f, const std::vector<const Run*>& r)
+               : less(f.sorted ? &f.less : 0), current(0)
+         {
+            try
+            {
+               for (size_t i = 0; i < r.size(); i++)
+                  readers.push_back(new RunReader(*r[i]));
+
+               if (less)
+               {
+                  for (size_t i = 0; i < readers.size(); i++)
+                  {
+                     Head h;
+                     h.reader = i;
+                     if (readers[i]->next(h.data))
+                     {
+                        heap.push_back(h);
+                        std::push_heap(heap.begin(), heap.end(),
+                                       HeadOrder(*less));
+                     }
+                  }
+               }
+            }
+            catch (...)
+            {
+               release();
+               throw;
+            }
+         }
+
+         ~Cursor()
+         { release(); }
+
+            /// Gets the next record and the index of its header.
+         bool next(FileData& data, size_t& header)
+         {
+            if (!less)
+            {
+               for ( ; current < readers.size(); current++)
+               {
+                  if (readers[current]->next(data))
+                  {
+                     header = readers[current]->run.header;
+                     return true;
+                  }
+                  readers[current]->run.count = readers[current]->pos;
+               }
+               return false;
+            }
+
+            if (heap.empty())
+               return false;
+
+            std::pop_heap(heap.begin(), heap.end(), HeadOrder(*less));
+            Head& h = heap.back();
+            data = h.data;
+            header = readers[h.reader]->run.header;
+            if (readers[h.reader]->next(h.data))
+               std::push_heap(heap.begin(), heap.end(), HeadOrder(*less));
+            else
+               heap.pop_back();
+            return true;
+         }
+
+      private:
+         struct Head
+         {
+            FileData data;
+            size_t reader;
+         };
+
+            /// Heap order: true if a comes after b.
+         struct HeadOrder
+         {
+            HeadOrder(const LessThan& l) : lt(l) {}
+            bool operator()(const Head& a, const Head& b) const
+            {
+               if (lt(b.data, a.data))
+                  return true;
+               if (lt(a.data, b.data))
+                  return false;
+               return a.reader > b.reader;
+            }
+            const LessThan& lt;
+         };
+
+         void release()
+         {
+            for (size_t i = 0; i < readers.size(); i++)
+               delete readers[i];
+            readers.clear();
+         }
+
+         const LessThan* less;
+         std::vector<RunReader*> readers;
+         size_t current;
+         std::vector<Head> heap;
+
+         Cursor(const Cursor&);
+         Cursor& operator=(const Cursor&);
+      };
+
+         /**
+          * Collects records into runs, one open run per header, keeping
+          * no more than maxRecords of them in memory: when the limit is
+          * reached, the largest run in memory is (sorted if lt is not
+          * null and) written to a temporary file.
+          */
+      class RunBuilder
+      {
+      public:
+         RunBuilder(ExternalFileFilter& f, const LessThan* lt)
+               : eff(f), less(lt), inMemory(0)
+         {}
+
+         ~RunBuilder()
+         {
+               // only left with runs if finish() was not reached
+            for (size_t i = 0; i < runs.size(); i++)
+               if (runs[i].temporary)
+                  std::remove(runs[i].fileName.c_str());
+         }
+
+         void add(const FileData& data, size_t header)
+         {
+            if (header >= open.size())
+               open.resize(header+1, std::string::npos);
+            if (open[header] == std::string::npos)
+            {
+               open[header] = runs.size();
+               runs.push_back(Run(header));
+            }
+            runs[open[header]].data.push_back(data);
+            if (++inMemory > eff.maxRecords)
+               spillLargest();
+         }
+
+            /// Returns the runs, in header order and, for each header,
+            /// in the order they were started.
+         std::vector<Run> finish()
+         {
+            std::vector<Run> rv;
+            for (size_t h = 0; h < open.size(); h++)
+            {
+               for (size_t i = 0; i < runs.size(); i++)
+               {
+                  if (runs[i].header != h)
+                     continue;
+                  if (runs[i].inMemory())
+                  {
+                     if (runs[i].data.empty())
+                        continue;
+                     if (less)
+                        std::stable_sort(runs[i].data.begin(),
+                                         runs[i].data.end(), *less);
+                     runs[i].count = runs[i].data.size();
+                  }
+                  rv.push_back(Run(h));
+                  std::swap(rv.back().fileName, runs[i].fileName);
+                  std::swap(rv.back().temporary, runs[i].temporary);
+                  std::swap(rv.back().data, runs[i].data);
+                  rv.back().count = runs[i].count;
+               }
+            }
+            runs.clear();
+            return rv;
+         }
+
+      private:
+         void spillLargest()
+         {
+            size_t best = std::string::npos;
+            for (size_t i = 0; i < runs.size(); i++)
+            {
+               if (runs[i].inMemory() &&
+                   (best == std::string::npos ||
+                    runs[i].data.size() > runs[best].data.size()))
+                  best = i;
+            }
+            Run& r = runs[best];
+            if (less)
+               std::stable_sort(r.data.begin(), r.data.end(), *less);
+            eff.writeRun(r);
+            inMemory -= r.count;
+               // later records of this header go to a new run
+            if (open[r.header] == best)
+               open[r.header] = std::string::npos;
+         }
+
+         ExternalFileFilter& eff;
+         const LessThan* less;
+         std::vector<Run> runs;
+            /// index in runs of the run now receiving each header's records
+         std::vector<size_t> open;
+         size_t inMemory;
+      };
+
+   public:
+         /**
+          * Reads the records of an ExternalFileFilter one at a time, in
+          * order, e.g. to go through the results of diff(). The filter
+          * must not be changed while it is being read.
+          */
+      class Reader
+      {
+      public:
+         Reader(const ExternalFileFilter& f)
+               : cursor(f, f.allRuns())
+         {}
+
+            /// Gets the next record; returns false after the last one.
+         bool next(FileData& data)
+         {
+            size_t header;
+            return cursor.next(data, header);
+         }
+
+      private:
+         Cursor cursor;
+         Reader(const Reader&);
+         Reader& operator=(const Reader&);
+      };
+
+   protected:
+         /// Writes the records of an in-memory Run to a new temporary file.
+      void writeRun(Run& r)
+         throw(gpstk::Exception)
+      {
+         std::string name = FileUtils::makeTempFile(tempDir, "gpstkff");
+         if (name.empty())
+         {
+            gpstk::Exception e("Unable to create a temporary file in "
+                               + (tempDir.empty() ? std::string("TMPDIR")
+                                                  : tempDir));
+            GPSTK_THROW(e);
+         }
+         r.fileName = name;
+         r.temporary = true;
+         r.count = r.data.size();
+         try
+         {
+            FileStream s(name.c_str(), std::ios::out|std::ios::trunc);
+            s.exceptions(std::ios::failbit);
+            s << sourceHeaders[r.header];
+            for (size_t i = 0; i < r.data.size(); i++)
+               s << r.data[i];
+            s.close();
+         }
+         catch (gpstk::Exception& e)
+         {
+            e.addText("Writing temporary file " + name);
+            GPSTK_RETHROW(e);
+         }
+         catch (std::exception& e)
+         {
+            gpstk::Exception exc("Writing temporary file " + name + ": "
+                                 + e.what());
+            GPSTK_THROW(exc);
+         }
+         std::vector<FileData>().swap(r.data);
+      }
+
+         /// Merges consecutive runs of each header, so that no more than
+         /// maxOpenRuns are open at once.
+      void reduceRuns()
+         throw(gpstk::Exception)
+      {
+         while (runs.size() > maxOpenRuns)
+         {
+            std::vector<Run> next;
+            size_t b = 0, merged = 0;
+            while (b < runs.size())
+            {
+               size_t e = b + 1;
+               while (e < runs.size() && e - b < maxOpenRuns &&
+                      runs[e].header == runs[b].header)
+                  e++;
+               if (e - b == 1)
+               {
+                  next.push_back(Run(runs[b].header));
+                  swapRun(next.back(), runs[b]);
+               }
+               else
+               {
+                  next.push_back(Run(runs[b].header));
+                  std::vector<const Run*> group;
+                  for (size_t i = b; i < e; i++)
+                     group.push_back(&runs[i]);
+                  mergeRuns(group, next.back());
+                  merged++;
+               }
+               b = e;
+            }
+            replaceRuns(next);
+               // too many input files to go below the limit
+            if (merged == 0)
+               break;
+         }
+      }
+
+         /// Merges runs of the same header into one temporary file.
+      void mergeRuns(const std::vector<const Run*>& group, Run& out)
+         throw(gpstk::Exception)
+      {
+         std::string name = FileUtils::makeTempFile(tempDir, "gpstkff");
+         if (name.empty())
+         {
+            gpstk::Exception e("Unable to create a temporary file in "
+                               + (tempDir.empty() ? std::string("TMPDIR")
+                                                  : tempDir));
+            GPSTK_THROW(e);
+         }
+         out.fileName = name;
+         out.temporary = true;
+         out.count = 0;
+         try
+         {
+            FileStream s(name.c_str(), std::ios::out|std::ios::trunc);
+            s.exceptions(std::ios::failbit);
+            s << sourceHeaders[out.header];
+            Cursor c(*this, group);
+            FileData data;
+            size_t header;
+            while (c.next(data, header))
+            {
+               s << data;
+               out.count++;
+            }
+            s.close();
+         }
+         catch (gpstk::Exception& e)
+         {
+            e.addText("Writing temporary file " + name);
+            GPSTK_RETHROW(e);
+         }
+         catch (std::exception& e)
+         {
+            gpstk::Exception exc("Writing temporary file " + name + ": "
+                                 + e.what());
+            GPSTK_THROW(exc);
+         }
+      }
+
+         /// Replaces the runs, removing the temporary files of the old ones.
+      void replaceRuns(std::vector<Run> newRuns)
+      {
+         for (size_t i = 0; i < runs.size(); i++)
+            if (runs[i].temporary)
+               std::remove(runs[i].fileName.c_str());
+         runs.swap(newRuns);
+      }
+
+         /// Clears the data and takes the headers and the ordering of src,
+         /// to receive a subset of its records.
+      void assignHeaders(const ExternalFileFilter& src)
+      {
+         clear();
+         headerList = src.headerList;
+         sourceHeaders = src.sourceHeaders;
+         less = src.less;
+         sorted = src.sorted;
+      }
+
+         /// Check that out is neither *this nor r
+         /// @throw InvalidRequest if it is
+      void checkOutput(const ExternalFileFilter& r,
+                       const ExternalFileFilter& out,
+                       const std::string& req) const
+         throw(gpstk::InvalidRequest)
+      {
+         if (&out == this || &out == &r)
+         {
+            gpstk::InvalidRequest exc("The output of a " + req + " request"
+                                      " cannot be one of its inputs.");
+            GPSTK_THROW(exc);
+         }
+      }
+
+      static void swapRun(Run& a, Run& b)
+      {
+         std::swap(a.header, b.header);
+         std::swap(a.fileName, b.fileName);
+         std::swap(a.temporary, b.temporary);
+         std::swap(a.count, b.count);
+         std::swap(a.data, b.data);
+      }
+
+         /// Pointers to all the runs, in order.
+      std::vector<const Run*> allRuns() const
+      {
+         std::vector<const Run*> rv;
+         for (size_t i = 0; i < runs.size(); i++)
+            rv.push_back(&runs[i]);
+         return rv;
+      }
+
+         /// Check to make sure headerList is not empty
+         /// @throw InvalidRequest if headerList is empty
+      void chl(const std::string& req) const
+         throw(gpstk::InvalidRequest)
+      {
+         if (headerList.empty())
+         {
+            gpstk::InvalidRequest exc("Header list is empty attempting to"
+                                      " satisfy "+req+" request.");
+            GPSTK_THROW(exc);
+         }
+      }
+
+         /// Headers of the input files, as read.
+      std::list<FileHeader> headerList;
+
+         /// Headers used to write and read back each input file's records;
+         /// unlike headerList, these are never changed by touchHeader().
+      std::vector<FileHeader> sourceHeaders;
+
+         /// The data.
+      std::vector<Run> runs;
+
+      size_t maxRecords;
+      size_t maxOpenRuns;
+      std::string tempDir;
+
+         /// Ordering of the runs, valid when sorted is true.
+      LessThan less;
+      bool sorted;
+
+         /// A count of the last number of items filtered
+      int filtered;
+
+   private:
+         /// Copying would share the temporary files.
+      ExternalFileFilter(const ExternalFileFilter&);
+      ExternalFileFilter& operator=(const ExternalFileFilter&);
+   };
+
+      //@}
+
+   template <class FileStream, class FileData, class FileHeader>
+   const size_t ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   defaultMaxRecords;
+
+   template <class FileStream, class FileData, class FileHeader>
+   const size_t ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   defaultMaxOpenRuns;
+
+   template <class FileStream, class FileData, class FileHeader>
+   ExternalFileFilter<FileStream,FileData,FileHeader>&
+   ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   newSource(const std::string& filename)
+      throw(gpstk::Exception)
+   {
+         // just read the header, as FileFilterFrameWithHeader does; the
+         // data is read on first use
+      FileStream s(filename.c_str());
+
+      if (s.good())
+      {
+         s.exceptions(std::ios::failbit);
+
+         FileHeader header;
+         s >> header;
+         headerList.push_back(header);
+
+            // new data is appended unsorted, as with
+            // FileFilterFrame::newSource()
+         Run r(sourceHeaders.size());
+         r.fileName = filename;
+         sourceHeaders.push_back(header);
+         runs.push_back(r);
+         sorted = false;
+      }
+
+      return *this;
+   }
+
+   template <class FileStream, class FileData, class FileHeader>
+   bool ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   writeFile(const std::string& outputFile,
+             const FileHeader& fh) const
+      throw(gpstk::Exception)
+   {
+         // make the directory (if needed)
+      std::string::size_type pos = outputFile.rfind('/');
+
+      if (pos != std::string::npos)
+         gpstk::FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+      FileStream stream(outputFile.c_str(), std::ios::out|std::ios::trunc);
+      stream.exceptions(std::ios::failbit);
+
+      stream << fh;
+
+      Cursor c(*this, allRuns());
+      FileData data;
+      size_t header;
+      while (c.next(data, header))
+         stream << data;
+      return true;
+   }
+
+   template <class FileStream, class FileData, class FileHeader>
+   FileData ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   front(void) const
+      throw(gpstk::InvalidRequest, gpstk::Exception)
+   {
+      Cursor c(*this, allRuns());
+      FileData data;
+      size_t header;
+      if (!c.next(data, header))
+      {
+         gpstk::InvalidRequest exc("No data in ExternalFileFilter");
+         GPSTK_THROW(exc);
+      }
+      return data;
+   }
+
+   template <class FileStream, class FileData, class FileHeader>
+   size_t ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   getDataCount(void) const
+      throw(gpstk::Exception)
+   {
+      size_t n = 0;
+      for (size_t i = 0; i < runs.size(); i++)
+      {
+         if (runs[i].count == std::string::npos)
+         {
+            RunReader r(runs[i]);
+            FileData data;
+            while (r.next(data))
+               ;
+            runs[i].count = r.pos;
+         }
+         n += runs[i].count;
+      }
+      return n;
+   }
+
+   template <class FileStream, class FileData, class FileHeader>
+   void ExternalFileFilter<FileStream,FileData,FileHeader> ::
+   clear()
+   {
+      replaceRuns(std::vector<Run>());
+      headerList.clear();
+      sourceHeaders.clear();
+      sorted = false;
+      filtered = 0;
+   }
+
+} // namespace gpstk
+
+#endif // GPSTK_EXTERNALFILEFILTER_HPP
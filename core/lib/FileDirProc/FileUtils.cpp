@@ -0,0 +1,94 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file FileUtils.cpp
+ * File and directory utilities
+ */
+
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#include "FileUtils.hpp"
+
+namespace gpstk
+{
+   namespace FileUtils
+   {
+#ifdef WIN32
+      std::string makeTempFile(const std::string& dir,
+                               const std::string& prefix)
+      {
+         char *name = _tempnam(dir.empty() ? 0 : dir.c_str(),
+                               prefix.c_str());
+         if (name == 0)
+            return std::string();
+         std::string rv(name);
+         free(name);
+         std::ofstream create(rv.c_str(), std::ios::out|std::ios::binary);
+         if (!create)
+            return std::string();
+         return rv;
+      }
+#else
+      std::string makeTempFile(const std::string& dir,
+                               const std::string& prefix)
+      {
+         std::string path(dir);
+         if (path.empty())
+         {
+            const char *env = getenv("TMPDIR");
+            path = (env && *env) ? env : "/tmp";
+         }
+         path += "/" + prefix + "XXXXXX";
+         std::vector<char> name(path.begin(), path.end());
+         name.push_back(0);
+         int fd = mkstemp(&name[0]);
+         if (fd < 0)
+            return std::string();
+         ::close(fd);
+         return std::string(&name[0]);
+      }
+#endif
+
+   } // namespace FileUtils
+
+} // namespace gpstk
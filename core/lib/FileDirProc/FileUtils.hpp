@@ -153,6 +153,19 @@ namespace gpstk
       {
          return fileAccessCheck(fname.c_str(), mode);
       }
+
+         /**
+          * Creates a new, empty file with a unique name and returns
+          * that name. The caller is responsible for removing it.
+          * @param dir the directory for the file. If empty, the
+          *   TMPDIR environment variable is used, or the system
+          *   temporary directory if it is not set.
+          * @param prefix the beginning of the file name
+          * @return the name of the file, or an empty string if it
+          *   could not be created
+          */
+      std::string makeTempFile(const std::string& dir = std::string(),
+                               const std::string& prefix = "gpstk");
       
 
    } // namespace FileUtils
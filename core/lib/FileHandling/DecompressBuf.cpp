@@ -0,0 +1,542 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/**
+ * @file DecompressBuf.cpp
+ * Stream buffer reading gzip or compress (.Z) files, decompressed by a
+ * helper thread.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "DecompressBuf.hpp"
+
+#ifdef GPSTK_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace gpstk
+{
+   const size_t DecompressBuf::blockSize = 1 << 16;
+   const size_t DecompressBuf::readAhead = 8;
+
+      /* Data older than the last position told is dropped anyway once
+       * it grows past this size, so that a reader that never calls
+       * tellg() does not keep the whole file in memory. */
+   static const std::streamoff maxKeep = 1 << 20;
+
+
+   DecompressBuf::DecompressBuf()
+         : format(None), stopping(false), ready(readAhead),
+           keptStart(0), cur(0), curStart(0), keepFrom(0), atEnd(false),
+           fill(0), inPos(0), inLen(0)
+   {
+   }
+
+
+   DecompressBuf::~DecompressBuf()
+   {
+      close();
+   }
+
+
+   DecompressBuf::Format DecompressBuf::detect(std::streambuf* sb)
+   {
+      if (sb == 0)
+         return None;
+
+      unsigned char magic[2];
+      std::streamsize n = sb->sgetn(reinterpret_cast<char*>(magic), 2);
+      sb->pubseekpos(0, std::ios::in);
+
+      if (n == 2 && magic[0] == 0x1f)
+      {
+         if (magic[1] == 0x8b)
+            return Gzip;
+         if (magic[1] == 0x9d)
+            return Compress;
+      }
+      return None;
+   }
+
+
+   bool DecompressBuf::open(const std::string& fn)
+   {
+      close();
+
+      if (!file.open(fn.c_str(), std::ios::in | std::ios::binary))
+         return false;
+
+      format = detect(&file);
+      if (format == None)
+      {
+         file.close();
+         return false;
+      }
+
+      start();
+      return true;
+   }
+
+
+   void DecompressBuf::close()
+   {
+      stop();
+      if (file.is_open())
+         file.close();
+      format = None;
+   }
+
+
+   void DecompressBuf::start()
+   {
+      keptStart = curStart = keepFrom = 0;
+      cur = 0;
+      atEnd = false;
+      error.clear();
+      setg(0, 0, 0);
+
+      stopping = false;
+      worker = std::thread(&DecompressBuf::run, this);
+   }
+
+
+   void DecompressBuf::stop()
+   {
+      if (worker.joinable())
+      {
+         stopping = true;
+         worker.join();
+      }
+
+      Block *b;
+      while (ready.pop(b))
+         delete b;
+      for (size_t i = 0; i < kept.size(); i++)
+         delete kept[i];
+      kept.clear();
+      setg(0, 0, 0);
+   }
+
+
+   void DecompressBuf::setArea(std::streamoff off)
+   {
+      std::string& data(kept[cur]->data);
+      char *base = &data[0];
+      setg(base, base + off, base + data.size());
+   }
+
+
+   bool DecompressBuf::nextBlock()
+   {
+         // Kept blocks come first, after seeking back
+      if (cur + 1 < kept.size())
+      {
+         curStart += kept[cur]->data.size();
+         cur++;
+         setArea(0);
+         return true;
+      }
+
+      if (atEnd)
+         return false;
+
+      Block *b;
+      SPSCBackoff backoff;
+      while (!ready.pop(b))
+         backoff.pause();
+
+      if (b->last)
+      {
+         atEnd = true;
+         error = b->error;
+      }
+      if (b->data.empty())
+      {
+         delete b;
+         return false;
+      }
+
+      if (!kept.empty())
+         curStart += kept[cur]->data.size();
+      kept.push_back(b);
+      cur = kept.size() - 1;
+
+         // Drop the blocks that are no longer needed
+      std::streamoff dropTo((curStart - keepFrom > maxKeep) ? curStart
+                                                            : keepFrom);
+      while (cur > 0 &&
+             keptStart + (std::streamoff)kept.front()->data.size() <= dropTo)
+      {
+         keptStart += kept.front()->data.size();
+         delete kept.front();
+         kept.pop_front();
+         cur--;
+      }
+
+      setArea(0);
+      return true;
+   }
+
+
+   DecompressBuf::int_type DecompressBuf::underflow()
+   {
+      if (gptr() < egptr())
+         return traits_type::to_int_type(*gptr());
+      if (format == None || !nextBlock())
+         return traits_type::eof();
+      return traits_type::to_int_type(*gptr());
+   }
+
+
+   DecompressBuf::pos_type DecompressBuf::seekoff( off_type off,
+                                                   std::ios::seekdir dir,
+                                                   std::ios::openmode )
+   {
+      if (format == None)
+         return pos_type(off_type(-1));
+
+      std::streamoff pos = curStart + (gptr() - eback());
+      if (dir == std::ios::cur && off == 0)
+      {
+         keepFrom = pos;
+         return pos_type(pos);
+      }
+
+      if (dir == std::ios::beg)
+         return seekpos(pos_type(off), std::ios::in);
+      if (dir == std::ios::cur)
+         return seekpos(pos_type(pos + off), std::ios::in);
+      return pos_type(off_type(-1));
+   }
+
+
+   DecompressBuf::pos_type DecompressBuf::seekpos( pos_type sp,
+                                                   std::ios::openmode )
+   {
+      std::streamoff pos(sp);
+      if (format == None || pos < 0)
+         return pos_type(off_type(-1));
+
+      if (pos < keptStart)
+      {
+            // Too far back, decompress again from the beginning
+         stop();
+         if (file.pubseekpos(0, std::ios::in) != std::streampos(0))
+            return pos_type(off_type(-1));
+         start();
+      }
+
+      keepFrom = pos;
+      cur = 0;
+      curStart = keptStart;
+      while (kept.empty() ||
+             pos > curStart + (std::streamoff)kept[cur]->data.size())
+      {
+         if (!nextBlock())
+            return pos_type(off_type(-1));
+      }
+      setArea(pos - curStart);
+      return sp;
+   }
+
+
+   void DecompressBuf::run()
+   {
+      fill = new Block;
+      fill->data.reserve(blockSize);
+      inBuf.resize(blockSize);
+      inPos = inLen = 0;
+
+      std::string err((format == Gzip) ? gunzip() : uncompress());
+
+      if (fill != 0)
+      {
+         fill->error = err;
+         push(true);
+      }
+   }
+
+
+   int DecompressBuf::nextByte()
+   {
+      if (inPos == inLen)
+      {
+         inLen = file.sgetn(&inBuf[0], inBuf.size());
+         inPos = 0;
+         if (inLen <= 0)
+         {
+            inLen = 0;
+            return -1;
+         }
+      }
+      return static_cast<unsigned char>(inBuf[inPos++]);
+   }
+
+
+   bool DecompressBuf::emit(const char* p, size_t n)
+   {
+      while (n > 0)
+      {
+         size_t k = std::min(n, blockSize - fill->data.size());
+         fill->data.append(p, k);
+         p += k;
+         n -= k;
+         if (fill->data.size() == blockSize && !push(false))
+            return false;
+      }
+      return true;
+   }
+
+
+   bool DecompressBuf::push(bool last)
+   {
+      fill->last = last;
+      SPSCBackoff backoff;
+      while (!ready.push(fill))
+      {
+         if (stopping)
+         {
+            delete fill;
+            fill = 0;
+            return false;
+         }
+         backoff.pause();
+      }
+
+      if (last)
+      {
+         fill = 0;
+      }
+      else
+      {
+         fill = new Block;
+         fill->data.reserve(blockSize);
+      }
+      return true;
+   }
+
+
+   std::string DecompressBuf::gunzip()
+   {
+#ifdef GPSTK_HAVE_ZLIB
+      z_stream z;
+      std::memset(&z, 0, sizeof(z));
+         // Window bits 15, plus 32 to take both gzip and zlib headers
+      if (inflateInit2(&z, 15 + 32) != Z_OK)
+         return "zlib can't be initialized";
+
+      std::vector<char> out(blockSize);
+      std::string err;
+      bool inMember(true);
+      while (!stopping)
+      {
+         if (z.avail_in == 0)
+         {
+            inLen = file.sgetn(&inBuf[0], inBuf.size());
+            if (inLen <= 0)
+            {
+               if (inMember)
+                  err = "unexpected end of compressed data";
+               break;
+            }
+            z.next_in = reinterpret_cast<Bytef*>(&inBuf[0]);
+            z.avail_in = inLen;
+         }
+
+            // Another gzip member may follow; anything else (usually
+            // zero padding) is ignored
+         if (!inMember)
+         {
+            if (z.next_in[0] != 0x1f)
+               break;
+            inflateReset(&z);
+            inMember = true;
+         }
+
+         z.next_out = reinterpret_cast<Bytef*>(&out[0]);
+         z.avail_out = out.size();
+         int ret = inflate(&z, Z_NO_FLUSH);
+         if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+         {
+            err = std::string("invalid gzip data: ") +
+               (z.msg ? z.msg : "unknown error");
+            break;
+         }
+         if (!emit(&out[0], out.size() - z.avail_out))
+            break;
+         if (ret == Z_STREAM_END)
+            inMember = false;
+      }
+
+      inflateEnd(&z);
+      return err;
+#else
+      return "gzip files can't be read: GPSTk was built without zlib";
+#endif
+   }
+
+
+      /* This follows the decoder in pigz (unlzw), including the quirk of
+       * compress that discards the rest of a group of codes when the
+       * code size changes. */
+   std::string DecompressBuf::uncompress()
+   {
+      const std::string invalid("invalid compress (.Z) data");
+
+         // Magic bytes, then flags: maximum code size and block mode
+      nextByte();
+      nextByte();
+      int flags = nextByte();
+      if (flags < 0)
+         return invalid;
+      unsigned maxBits = flags & 0x1f;
+      bool blockMode = (flags & 0x80) != 0;
+      if (maxBits < 9 || maxBits > 16)
+         return invalid;
+      if (maxBits == 9)
+         maxBits = 10;
+
+      std::vector<unsigned short> prefix(65536);
+      std::vector<unsigned char> suffix(65536);
+      std::vector<char> match(65536);
+
+      unsigned bits = 9, mask = 0x1ff, end = blockMode ? 256 : 255;
+
+         // The first code is the first byte; it makes no table entry
+      int last = nextByte();
+      if (last < 0)
+         return "";
+      unsigned prev = last, final = last;
+      last = nextByte();
+      if (last < 0 || (last & 1))
+         return invalid;
+      unsigned rem = last >> 1, left = 7, chunk = bits - 2;
+      char first = static_cast<char>(final);
+      if (!emit(&first, 1))
+         return "";
+
+      while (!stopping)
+      {
+            // When the table is full the code size grows, and the rest
+            // of the group of codes is discarded
+         if (end >= mask && bits < maxBits)
+         {
+            for ( ; chunk > 0; chunk--)
+            {
+               if (nextByte() < 0)
+                  break;
+            }
+            chunk = 0;
+            left = rem = 0;
+            bits++;
+            mask = (mask << 1) + 1;
+         }
+
+         if (chunk == 0)
+            chunk = bits;
+         unsigned code = rem;
+         last = nextByte();
+         if (last < 0)
+            return "";   // End of the data
+         code += unsigned(last) << left;
+         left += 8;
+         chunk--;
+         if (bits > left)
+         {
+            last = nextByte();
+            if (last < 0)
+               return invalid;
+            code += unsigned(last) << left;
+            left += 8;
+            chunk--;
+         }
+         code &= mask;
+         left -= bits;
+         rem = unsigned(last) >> (8 - left);
+
+         if (code == 256 && blockMode)
+         {
+               // Clear code: empty table
+            for ( ; chunk > 0; chunk--)
+            {
+               if (nextByte() < 0)
+                  break;
+            }
+            chunk = 0;
+            left = rem = 0;
+            bits = 9;
+            mask = 0x1ff;
+            end = 255;
+            continue;
+         }
+
+            // Walk the table to get the string, which comes out reversed
+         unsigned temp = code;
+         size_t stack = 0;
+         if (code > end)
+         {
+               // The code being defined: previous string plus its first
+               // byte
+            if (code != end + 1 || prev > end)
+               return invalid;
+            match[stack++] = static_cast<char>(final);
+            code = prev;
+         }
+         while (code >= 256)
+         {
+            match[stack++] = suffix[code];
+            code = prefix[code];
+         }
+         match[stack++] = static_cast<char>(code);
+         final = code;
+
+         if (end < mask)
+         {
+            end++;
+            prefix[end] = prev;
+            suffix[end] = final;
+         }
+         prev = temp;
+
+         std::reverse(match.begin(), match.begin() + stack);
+         if (!emit(&match[0], stack))
+            return "";
+      }
+
+      return "";
+   }
+
+}  // End of namespace gpstk
@@ -0,0 +1,246 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file DecompressBuf.hpp
+ * Stream buffer reading gzip or compress (.Z) files, decompressed by a
+ * helper thread.
+ */
+
+#ifndef GPSTK_DECOMPRESSBUF_HPP
+#define GPSTK_DECOMPRESSBUF_HPP
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include "SPSCQueue.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This is a stream buffer that reads a gzip (.gz) or compress
+       * (.Z) file and hands out the decompressed data. FFStream uses it
+       * by itself for input files whose first bytes are those of a
+       * compressed file, so that every FFStream-based reader takes
+       * compressed products as they are distributed.
+       *
+       * The file is read and decompressed by a helper thread, in blocks
+       * that are queued ahead of the reader, so decompression overlaps
+       * parsing. The file is opened again by the buffer, so the stream
+       * buffer of the fstream is left alone.
+       *
+       * Positions are counted in decompressed bytes. The data is kept
+       * from the last position told (tellg()) on, so seeking back to
+       * it, as FFStream does when a record can't be read, is cheap;
+       * seeking further back restarts the decompression from the
+       * beginning of the file. Seeking from the end is not possible.
+       *
+       * gzip data is decoded with zlib, and is only available when the
+       * library was built with it. Errors in the compressed data end
+       * the data, and are reported by hasError() and getError().
+       */
+   class DecompressBuf : public std::streambuf
+   {
+   public:
+
+         /// Kinds of compressed files.
+      enum Format
+      {
+         None,       ///< Not compressed
+         Gzip,       ///< gzip (or zlib)
+         Compress    ///< Unix compress (LZW)
+      };
+
+         /// Default constructor, it does nothing until opened.
+      DecompressBuf();
+
+         /// Destructor, it stops the helper thread.
+      virtual ~DecompressBuf();
+
+         /** Find the kind of compressed data available from a stream
+          * buffer, by its first bytes. The buffer is rewound.
+          * @param[in] sb the stream buffer to check.
+          */
+      static Format detect(std::streambuf* sb);
+
+         /** Open a compressed file and start decompressing it. Any
+          * file previously opened is closed first.
+          * @param[in] fn the name of the file.
+          * @return false if the file can't be opened or is not
+          *   compressed.
+          */
+      bool open(const std::string& fn);
+
+         /// Stop decompressing and close the file.
+      void close();
+
+         /// Whether a file is open.
+      bool isOpen() const
+      { return (format != None); }
+
+         /// Kind of the file open.
+      Format getFormat() const
+      { return format; }
+
+         /// Whether an error was found in the compressed data.
+      bool hasError() const
+      { return !error.empty(); }
+
+         /// Description of the error found, if any.
+      const std::string& getError() const
+      { return error; }
+
+         /// Size of the blocks of decompressed data.
+      static const size_t blockSize;
+
+         /// Number of blocks the helper thread may have ready ahead.
+      static const size_t readAhead;
+
+   protected:
+
+         /// Gets the next block of decompressed data.
+      virtual int_type underflow();
+
+         /// Only gives or sets the position, see the class description.
+      virtual pos_type seekoff( off_type off,
+                                std::ios::seekdir dir,
+                                std::ios::openmode which );
+
+         /// Only gives or sets the position, see the class description.
+      virtual pos_type seekpos( pos_type pos,
+                                std::ios::openmode which );
+
+   private:
+
+         /// A block of decompressed data.
+      struct Block
+      {
+         Block() : last(false) {}
+
+         std::string data;
+            /// Whether it is the last one; 'error' tells why, if the
+            /// data ended early.
+         bool last;
+         std::string error;
+      };
+
+         /// Kind of the file open.
+      Format format;
+
+         /// The compressed file, only used by the helper thread while
+         /// it runs.
+      std::filebuf file;
+
+         /// Helper thread, and whether it has been told to stop.
+      std::thread worker;
+      std::atomic<bool> stopping;
+
+         /// Blocks decompressed by the helper thread.
+      SPSCQueue<Block*> ready;
+
+         /// Blocks kept by the reader, from position 'keptStart'.
+      std::deque<Block*> kept;
+      std::streamoff keptStart;
+
+         /// Index in 'kept' of the block in the get area, and its
+         /// position.
+      size_t cur;
+      std::streamoff curStart;
+
+         /// Position told last; the data from there on is kept.
+      std::streamoff keepFrom;
+
+         /// Whether the last block has been received.
+      bool atEnd;
+
+         /// Error found in the compressed data.
+      std::string error;
+
+         // State of the helper thread
+      Block *fill;
+      std::vector<char> inBuf;
+      std::streamsize inPos, inLen;
+
+         /// Start decompressing from the beginning of the file.
+      void start();
+
+         /// Stop the helper thread and drop all the blocks.
+      void stop();
+
+         /// Make the next block current. It returns false at the end.
+      bool nextBlock();
+
+         /// Set the get area to the current block, at offset 'off'.
+      void setArea(std::streamoff off);
+
+         /// Body of the helper thread.
+      void run();
+
+         /// Reads the next compressed byte; -1 at end of file.
+      int nextByte();
+
+         /// Decompress gzip data. It returns an error message, if any.
+      std::string gunzip();
+
+         /// Decompress compress (.Z) data. It returns an error message,
+         /// if any.
+      std::string uncompress();
+
+         /** Hand decompressed data over to the reader. It returns false
+          * if the thread must stop. */
+      bool emit(const char* p, size_t n);
+
+         /// Queue the block being filled.
+      bool push(bool last);
+
+         /// Copying is not allowed.
+      DecompressBuf(const DecompressBuf&);
+      DecompressBuf& operator=(const DecompressBuf&);
+
+   }; // End of class 'DecompressBuf'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_DECOMPRESSBUF_HPP
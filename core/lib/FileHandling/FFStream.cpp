@@ -40,6 +40,7 @@
  */
 
 #include "FFStream.hpp"
+#include "DecompressBuf.hpp"
 
 namespace gpstk
 {
@@ -53,6 +54,7 @@ namespace gpstk
    FFStream ::
    ~FFStream()
    {
+      closeDecompressor();
    }
 
 
@@ -106,9 +108,50 @@ namespace gpstk
          // AFTER the parent.
       init(fn, mode);
       std::fstream::open(fn, mode);
+
+         // Compressed input is read through the decompressor
+      if ((mode & std::ios::in) && !(mode & std::ios::out) && is_open() &&
+          DecompressBuf::detect(std::fstream::rdbuf()) != DecompressBuf::None)
+      {
+         zbuf.reset(new DecompressBuf);
+         if (zbuf->open(fn))
+         {
+            std::ios::rdbuf(zbuf.get());
+         }
+         else
+         {
+            zbuf.reset();
+         }
+      }
    }  // End of method 'FFStream::open()'
 
 
+   void FFStream ::
+   close()
+   {
+      closeDecompressor();
+      std::fstream::close();
+   }  // End of method 'FFStream::close()'
+
+
+   void FFStream ::
+   closeDecompressor()
+   {
+      if (zbuf)
+      {
+         std::ios::rdbuf(std::fstream::rdbuf());
+         zbuf.reset();
+      }
+   }
+
+
+   bool FFStream ::
+   decompressError() const
+   {
+      return (zbuf && zbuf->hasError());
+   }
+
+
    void FFStream ::
    init( const char* fn, std::ios::openmode mode )
    {
@@ -237,6 +280,11 @@ namespace gpstk
          // This also takes care of catching StringExceptions
       catch (gpstk::Exception &e)
       {
+            // The record may have been cut short by bad compressed data
+         if (decompressError())
+         {
+            e.addText(zbuf->getError());
+         }
          GPSTK_RETHROW(e);
       }
       catch (std::ifstream::failure &e)
@@ -252,6 +300,10 @@ namespace gpstk
             mostRecentException.addText("In file " + filename);
             mostRecentException.addLocation(FILE_LOCATION);
          }
+         else if (decompressError())
+         {
+            mostRecentException.addText(zbuf->getError());
+         }
          conditionalThrow();
       }
       catch (std::exception &e)
@@ -272,6 +324,16 @@ namespace gpstk
          conditionalThrow();
       }
 
+         // Bad compressed data ends the file early, which is not the
+         // normal end of file
+      if (fail() && decompressError())
+      {
+         mostRecentException = FFStreamError(zbuf->getError());
+         mostRecentException.addText("In file " + filename);
+         mostRecentException.addLocation(FILE_LOCATION);
+         conditionalThrow();
+      }
+
    }  // End of method 'FFStream::tryFFStreamGet()'
 
 
@@ -47,6 +47,7 @@
 #include <fstream>
 #include <string>
 #include <typeinfo>
+#include <memory>
 
 #include "FFStreamError.hpp"
 #include "FFData.hpp"
@@ -54,6 +55,8 @@
 
 namespace gpstk
 {
+   class DecompressBuf;
+
       /** @defgroup FileHandling Formatted File I/O
        *
        * This module includes the data types used for File I/O of
@@ -110,6 +113,12 @@ namespace gpstk
        * RinexObsData::reallyGetRecord()
        * for an example of this.
        *
+       * Input files compressed with gzip or compress (.gz or .Z) are
+       * recognized by their first bytes when opened, and are read
+       * decompressed, the decompression running on a helper thread (see
+       * DecompressBuf). Line numbers, record numbers and error reporting
+       * work as for plain files.
+       *
        * \sa FFData for more information
        * \sa RinexObsData::reallyGetRecord() and
        *     RinexObsHeader::reallyGetRecord() for more information for files
@@ -153,6 +162,12 @@ namespace gpstk
           */
       virtual void open( const std::string& fn, std::ios::openmode mode );
 
+         /**
+          * Overrides fstream::close so that the decompressor, if the
+          * file was being read decompressed, is stopped too.
+          */
+      void close();
+
          /// A function to help debug FFStreams
       void dumpState(std::ostream& s = std::cout) const;
 
@@ -170,6 +185,10 @@ namespace gpstk
          /// Check if the input stream is the kind of RinexObsStream
       static bool isFFStream(std::istream& i);
 
+         /// Whether the file is being read decompressed.
+      bool isCompressed() const
+      { return (zbuf.get() != NULL); }
+
          /// This stores the most recently thrown exception.
       FFStreamError mostRecentException;
 
@@ -198,6 +217,16 @@ namespace gpstk
          throw(FFStreamError, gpstk::StringUtils::StringException);
 
    private:
+         /// Decompressor, only while a compressed file is being read.
+      std::unique_ptr<DecompressBuf> zbuf;
+
+         /// Stop the decompressor, if any, and go back to the file's
+         /// own stream buffer.
+      void closeDecompressor();
+
+         /// Whether the decompressor found an error in the data.
+      bool decompressError() const;
+
          /// Initialize internal data structures according to file name & mode
       void init(const char* fn, std::ios::openmode mode);
 
@@ -0,0 +1,425 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProductCache.cpp
+ * Binary cache of data parsed from product files (SP3, RINEX clock, IONEX...)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+#include "ProductCache.hpp"
+
+namespace gpstk
+{
+      // Magic string at the start of every entry
+   static const char productCacheMagic[8] = { 'G','P','S','T','K','P','C','\n' };
+
+   const uint16_t ProductCache::formatVersion = 2;
+
+
+      // Add up to 'limit' bytes of a stream to a 64-bit FNV-1a hash
+   static void hashStream(std::istream& in,
+                          uint64_t limit,
+                          uint64_t& size,
+                          uint64_t& hash)
+   {
+      hash = 14695981039346656037ULL;
+      size = 0;
+
+      std::vector<char> buff(1 << 16);
+      while (in && size < limit)
+      {
+         uint64_t want = limit - size;
+         if (want > buff.size())
+            want = buff.size();
+         in.read(&buff[0], static_cast<std::streamsize>(want));
+         std::streamsize n = in.gcount();
+         for (std::streamsize i = 0; i < n; i++)
+         {
+            hash ^= static_cast<unsigned char>(buff[i]);
+            hash *= 1099511628211ULL;
+         }
+         size += n;
+      }
+   }
+
+
+      // The cache directory given by the environment, if any
+   static std::string environmentDirectory()
+   {
+      const char *env = std::getenv("GPSTK_PRODUCT_CACHE");
+      return (env ? std::string(env) : std::string());
+   }
+
+
+   ProductCache ::
+   ProductCache()
+         : entrySize(0)
+   {
+   }
+
+
+   ProductCache ::
+   ~ProductCache()
+   {
+      if (!tempEntry.empty())
+      {
+         close();
+         std::remove(tempEntry.c_str());
+      }
+   }
+
+
+   std::string& ProductCache ::
+   directory()
+   {
+         // initialised once, even when first called from several threads
+      static std::string dir(environmentDirectory());
+      return dir;
+   }
+
+
+   void ProductCache ::
+   setDirectory(const std::string& dir)
+   {
+      directory() = dir;
+   }
+
+
+   std::string ProductCache ::
+   getDirectory()
+   {
+      return directory();
+   }
+
+
+   bool ProductCache ::
+   fileSignature(const std::string& filename,
+                 uint64_t& size,
+                 uint64_t& hash)
+   {
+      std::ifstream in(filename.c_str(), std::ios::in|std::ios::binary);
+      if (!in)
+         return false;
+
+      hashStream(in, ~uint64_t(0), size, hash);
+
+      return in.eof() && !in.bad();
+   }
+
+
+   std::string ProductCache ::
+   entryName(uint64_t size,
+             uint64_t hash,
+             const std::string& kind)
+   {
+      std::ostringstream oss;
+      oss << getDirectory() << "/"
+          << std::hex << std::setfill('0') << std::setw(16) << hash
+          << std::dec << "-" << size << "." << kind << ".gpc";
+      return oss.str();
+   }
+
+
+   std::string ProductCache ::
+   entryFile(const std::string& filename, const std::string& kind)
+   {
+      uint64_t size, hash;
+      if (!isEnabled() || !fileSignature(filename, size, hash))
+         return std::string();
+      return entryName(size, hash, kind);
+   }
+
+
+   bool ProductCache ::
+   openEntry(const std::string& filename, const std::string& kind)
+   {
+      if (!isEnabled())
+         return false;
+
+      uint64_t size, hash;
+      if (!fileSignature(filename, size, hash))
+         return false;
+
+      std::string name(entryName(size, hash, kind));
+      open(name.c_str(), std::ios::in);
+      if (!is_open() || fail())
+         return false;
+
+         // size of the entry without the trailing hash, used by
+         // getCount()
+      seekg(0, std::ios::end);
+      entrySize = static_cast<uint64_t>(tellg());
+      if (fail() || entrySize < sizeof(uint64_t))
+      {
+         close();
+         return false;
+      }
+      entrySize -= sizeof(uint64_t);
+
+         // the trailing hash covers the rest of the entry, so that
+         // corrupt data is never used
+      uint64_t dataSize(0), dataHash(0), trailer(0);
+      seekg(0, std::ios::beg);
+      hashStream(*this, entrySize, dataSize, dataHash);
+      getData(trailer);
+      if (fail() || dataSize != entrySize || trailer != dataHash)
+      {
+         close();
+         return false;
+      }
+      seekg(0, std::ios::beg);
+
+         // check the header; it repeats the file signature and kind, so a
+         // corrupted or foreign file is never taken as an entry
+      char magic[sizeof(productCacheMagic)];
+      uint16_t version(0);
+      uint64_t entrySizeOfFile(0), entryHash(0);
+      std::string entryKind;
+
+      getData(magic, sizeof(magic));
+      getData(version);
+      getData(entrySizeOfFile);
+      getData(entryHash);
+      getString(entryKind);
+
+      if (fail() ||
+          std::string(magic, sizeof(magic)) !=
+          std::string(productCacheMagic, sizeof(productCacheMagic)) ||
+          version != formatVersion ||
+          entrySizeOfFile != size ||
+          entryHash != hash ||
+          entryKind != kind)
+      {
+         close();
+         return false;
+      }
+
+      return true;
+   }
+
+
+   bool ProductCache ::
+   createEntry(const std::string& filename, const std::string& kind)
+   {
+      if (!isEnabled())
+         return false;
+
+      uint64_t size, hash;
+      if (!fileSignature(filename, size, hash))
+         return false;
+
+      newEntry = entryName(size, hash, kind);
+
+         // temporary name unique to this writer
+      std::ostringstream oss;
+      oss << newEntry << ".tmp" << std::hex
+          << static_cast<unsigned long>(std::time(0))
+          << reinterpret_cast<size_t>(this);
+      tempEntry = oss.str();
+
+      open(tempEntry.c_str(), std::ios::out|std::ios::trunc);
+      if (!is_open() || fail())
+      {
+         tempEntry.clear();
+         return false;
+      }
+
+      writeData(productCacheMagic, sizeof(productCacheMagic));
+      writeData(formatVersion);
+      writeData(size);
+      writeData(hash);
+      writeString(kind);
+
+      return true;
+   }
+
+
+   bool ProductCache ::
+   commitEntry()
+   {
+      if (tempEntry.empty())
+         return false;
+
+      bool ok(!fail());
+      close();
+
+         // append the hash of the entry
+      if (ok)
+      {
+         uint64_t size, hash;
+         ok = fileSignature(tempEntry, size, hash);
+         if (ok)
+         {
+            open(tempEntry.c_str(), std::ios::out|std::ios::app);
+            writeData(hash);
+            ok = !fail();
+            close();
+         }
+      }
+
+      if (ok)
+         ok = (std::rename(tempEntry.c_str(), newEntry.c_str()) == 0);
+      if (!ok)
+         std::remove(tempEntry.c_str());
+
+      tempEntry.clear();
+      return ok;
+   }
+
+
+   size_t ProductCache ::
+   getCount(size_t itemSize)
+   {
+      uint64_t n(0);
+      getData(n);
+
+      if (fail())
+         return 0;
+
+      uint64_t left = entrySize - static_cast<uint64_t>(tellg());
+      if (itemSize == 0)
+         itemSize = 1;
+      if (n > left / itemSize)
+      {
+         setstate(std::ios::failbit);
+         return 0;
+      }
+
+      return static_cast<size_t>(n);
+   }
+
+
+   void ProductCache ::
+   getString(std::string& s)
+   {
+      size_t n = getCount(1);
+      s.resize(n);
+      if (n > 0)
+         getData(&s[0], n);
+   }
+
+
+   void ProductCache ::
+   writeString(const std::string& s)
+   {
+      writeCount(s.size());
+      if (!s.empty())
+         writeData(s.data(), s.size());
+   }
+
+
+   void ProductCache ::
+   getTime(CommonTime& t)
+   {
+      int64_t day(0), msod(0);
+      double fsod(0.0);
+      int32_t sys(0);
+      getData(day);
+      getData(msod);
+      getData(fsod);
+      getData(sys);
+
+      if (fail())
+         return;
+
+      try
+      {
+         t.setInternal(static_cast<long>(day), static_cast<long>(msod), fsod,
+                       TimeSystem(static_cast<int>(sys)));
+      }
+      catch (Exception&)
+      {
+         setstate(std::ios::failbit);
+      }
+   }
+
+
+   void ProductCache ::
+   writeTime(const CommonTime& t)
+   {
+      long day, msod;
+      double fsod;
+      TimeSystem sys;
+      t.getInternal(day, msod, fsod, sys);
+      writeData(static_cast<int64_t>(day));
+      writeData(static_cast<int64_t>(msod));
+      writeData(fsod);
+      writeData(static_cast<int32_t>(sys.getTimeSystem()));
+   }
+
+
+   void ProductCache ::
+   getSatID(SatID& sat)
+   {
+      int32_t id(0), sys(0);
+      getData(id);
+      getData(sys);
+      sat = SatID(static_cast<int>(id),
+                  static_cast<SatID::SatelliteSystem>(sys));
+   }
+
+
+   void ProductCache ::
+   writeSatID(const SatID& sat)
+   {
+      writeData(static_cast<int32_t>(sat.id));
+      writeData(static_cast<int32_t>(sat.system));
+   }
+
+
+   void ProductCache ::
+   getTriple(Triple& t)
+   {
+      for (int i = 0; i < 3; i++)
+         getData(t[i]);
+   }
+
+
+   void ProductCache ::
+   writeTriple(const Triple& t)
+   {
+      for (int i = 0; i < 3; i++)
+         writeData(t[i]);
+   }
+
+} // namespace gpstk
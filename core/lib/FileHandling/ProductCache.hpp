@@ -0,0 +1,211 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProductCache.hpp
+ * Binary cache of data parsed from product files (SP3, RINEX clock, IONEX...)
+ */
+
+#ifndef GPSTK_PRODUCTCACHE_HPP
+#define GPSTK_PRODUCTCACHE_HPP
+
+#include <string>
+
+#include "FFBinaryStream.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "Triple.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This is a binary stream holding one entry of a cache of the data
+       * parsed from product files, so that a program that loads the same
+       * file again (for instance, each of many short runs of a batch job)
+       * reads the binary entry instead of parsing the text.
+       *
+       * Entries are stored in a cache directory, which is taken from the
+       * environment variable GPSTK_PRODUCT_CACHE or set with
+       * setDirectory(); the cache is disabled when the directory is empty,
+       * which is the default. An entry is identified by the size and a
+       * 64-bit hash of the contents of the product file, and by a "kind"
+       * string given by the loader, which must tell apart the formats and
+       * any loader options that change the data stored. Renaming or
+       * touching a file does not invalidate its entry; changing its
+       * contents does. Each entry ends with a hash of the rest of the
+       * entry, so an entry that is cut short or corrupt is ignored.
+       *
+       * The loaders using the cache (see SP3EphemerisStore::loadFile(),
+       * Rinex3EphemerisStore::loadFile(), IonexStore::loadFile() and
+       * EOPStore::addIERSFile()) fall back to parsing the text file
+       * whenever the entry is missing or does not match, and then write a
+       * new entry. AntexReader does not use the cache: it keeps no store
+       * of parsed data, it reads the header when opened and parses a
+       * single antenna on each query. Entries are written to a temporary
+       * file that is renamed when complete, so concurrent programs never
+       * read partial entries.
+       *
+       * @code
+       *   ProductCache cache;
+       *   if (cache.openEntry(filename, "kind"))
+       *   {
+       *      cache.getData(n);  ...
+       *      if (cache.good()) { ...use the data... }
+       *   }
+       *   else
+       *   {
+       *      ...parse the file...
+       *      if (cache.createEntry(filename, "kind"))
+       *      {
+       *         cache.writeData(n);  ...
+       *         cache.commitEntry();
+       *      }
+       *   }
+       * @endcode
+       */
+   class ProductCache : public FFBinaryStream
+   {
+   public:
+         /// Version of the entry format written by this class.
+      static const uint16_t formatVersion;
+
+         /// Default constructor
+      ProductCache();
+
+         /// Destructor. An entry not committed is discarded.
+      virtual ~ProductCache();
+
+         /** Set the cache directory. An empty name disables the cache.
+          * This must not be called while files are being loaded, e.g.
+          * by SP3EphemerisStore::loadFiles().
+          * @param[in] dir name of an existing directory. */
+      static void setDirectory(const std::string& dir);
+
+         /// Get the cache directory, empty if the cache is disabled.
+      static std::string getDirectory();
+
+         /// Return true if the cache is enabled.
+      static bool isEnabled()
+      { return !getDirectory().empty(); }
+
+         /** Open the cache entry of a product file for reading, and check
+          * its header.
+          * @param[in] filename name of the product file.
+          * @param[in] kind format and options of the data in the entry.
+          * @return true if a matching entry was found, and the stream is
+          *   positioned at its data. */
+      bool openEntry(const std::string& filename, const std::string& kind);
+
+         /** Create a new cache entry for a product file, and write its
+          * header. The entry is not visible until commitEntry() is called.
+          * @param[in] filename name of the product file.
+          * @param[in] kind format and options of the data in the entry.
+          * @return true if the entry was created. */
+      bool createEntry(const std::string& filename, const std::string& kind);
+
+         /** Close the entry created by createEntry(), and make it
+          * available to later calls to openEntry().
+          * @return true if the entry was written successfully. */
+      bool commitEntry();
+
+         /** Read a count of items, checking that it is not larger than
+          * the data left in the entry. If it is, the stream is set to
+          * fail state and zero is returned.
+          * @param[in] itemSize minimum number of bytes of each item. */
+      size_t getCount(size_t itemSize);
+
+         /// Write a count of items.
+      void writeCount(size_t n)
+      { writeData(static_cast<uint64_t>(n)); }
+
+         /// Read and write a string
+      void getString(std::string& s);
+      void writeString(const std::string& s);
+
+         /// Read and write a CommonTime, including its time system
+      void getTime(CommonTime& t);
+      void writeTime(const CommonTime& t);
+
+         /// Read and write a SatID
+      void getSatID(SatID& sat);
+      void writeSatID(const SatID& sat);
+
+         /// Read and write a Triple
+      void getTriple(Triple& t);
+      void writeTriple(const Triple& t);
+
+         /// Entries are little-endian.
+      virtual bool isStreamLittleEndian() const throw()
+      { return true; }
+
+         /** Name of the entry file of a product file and kind, whether
+          * the entry exists or not.
+          * @return the name, empty if the cache is disabled or the
+          *   product file can't be read. */
+      static std::string entryFile(const std::string& filename,
+                                   const std::string& kind);
+
+         /** Compute the size and the 64-bit FNV-1a hash of the contents
+          * of a file.
+          * @return false if the file could not be read. */
+      static bool fileSignature(const std::string& filename,
+                                uint64_t& size,
+                                uint64_t& hash);
+
+   private:
+         /// Name of the entry file for a product file and kind.
+      static std::string entryName(uint64_t size,
+                                   uint64_t hash,
+                                   const std::string& kind);
+
+         /// The cache directory, initialised from the environment.
+      static std::string& directory();
+
+         /// Names of the entry being written and of its temporary file.
+      std::string newEntry, tempEntry;
+
+         /// Size of the entry being read.
+      uint64_t entrySize;
+   };
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_PRODUCTCACHE_HPP
@@ -47,8 +47,8 @@
 #include <map>
 #include <string>
 
-#include "FFTextStream.hpp"
 #include "RinexObsHeader.hpp"
+#include "CompactRinexStream.hpp"
 
 namespace gpstk
 {
@@ -59,10 +59,14 @@ namespace gpstk
       /**
        * This class reads RINEX files.
        *
+       * Compact RINEX (Hatanaka compressed) files are read as well: they
+       * are recognized by their first line and decoded on the fly. Call
+       * setCompactOutput() to write one. See CompactRinexStream.
+       *
        * @sa gpstk::RinexObsData and gpstk::RinexObsHeader.
        * @sa rinex_obs_test.cpp and rinex_obs_read_write.cpp for examples.
        */
-   class RinexObsStream : public FFTextStream
+   class RinexObsStream : public CompactRinexStream
    {
    public:
          /// Default constructor
@@ -0,0 +1,963 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/**
+ * @file CompactRinexBuf.cpp
+ * Stream buffer decoding and encoding Hatanaka Compact RINEX observation data.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <ctime>
+#include <algorithm>
+#include "CompactRinexBuf.hpp"
+
+namespace gpstk
+{
+   const std::string CompactRinexBuf::programName = "GPSTk CompactRinexBuf";
+   const int CompactRinexBuf::diffOrder = 3;
+
+      /* The decoded text older than the last position told is dropped
+       * anyway once it grows past this size, so that a reader that never
+       * calls tellg() does not keep the whole file in memory. */
+   static const std::streamoff maxKeep = 1 << 20;
+
+      /// Header label of a CRINEX file.
+   static const std::string crxLabel = "CRINEX VERS   / TYPE";
+
+
+      // Line without trailing blanks.
+   static std::string trimRight(const std::string& s)
+   {
+      std::string::size_type n = s.find_last_not_of(' ');
+      return (n == std::string::npos) ? std::string() : s.substr(0, n+1);
+   }
+
+
+      // Line padded with blanks to at least n characters.
+   static std::string padTo(const std::string& s, std::string::size_type n)
+   {
+      return (s.size() >= n) ? s : s + std::string(n - s.size(), ' ');
+   }
+
+
+      // Header label (columns 61-80) of a RINEX line.
+   static std::string labelOf(const std::string& line)
+   {
+      return (line.size() > 60) ? trimRight(line.substr(60, 20))
+                                : std::string();
+   }
+
+
+      /* Apply a CRINEX text difference to a line: a blank keeps the old
+       * character, '&' stands for a blank, and anything else replaces
+       * the old character. */
+   static void repair(std::string& s, const std::string& diff)
+   {
+      if (diff.size() > s.size())
+         s.resize(diff.size(), ' ');
+      for (std::string::size_type i = 0; i < diff.size(); i++)
+      {
+         if (diff[i] == ' ')
+            continue;
+         s[i] = (diff[i] == '&') ? ' ' : diff[i];
+      }
+   }
+
+
+      // CRINEX text difference from line a to line b; see repair().
+   static std::string textDiff(const std::string& a, const std::string& b)
+   {
+      std::string d(std::max(a.size(), b.size()), ' ');
+      for (std::string::size_type i = 0; i < d.size(); i++)
+      {
+         char o = (i < a.size()) ? a[i] : ' ';
+         char c = (i < b.size()) ? b[i] : ' ';
+         if (o != c)
+            d[i] = (c == ' ') ? '&' : c;
+      }
+      return trimRight(d);
+   }
+
+
+      // Integer CRINEX field; false unless the whole field is a number.
+   static bool parseInt(const std::string& s, long long& v)
+   {
+      if (s.empty())
+         return false;
+      char *end;
+      v = std::strtoll(s.c_str(), &end, 10);
+      return (*end == '\0' && end != s.c_str());
+   }
+
+
+      // Power of ten.
+   static long long tenTo(int n)
+   {
+      long long p = 1;
+      while (n-- > 0)
+         p *= 10;
+      return p;
+   }
+
+
+      /* Fixed point RINEX field as an integer in units of its last
+       * digit; false if it is blank. */
+   static bool parseFixed(const std::string& field, int decimals,
+                          long long& v)
+   {
+      std::string::size_type b = field.find_first_not_of(' ');
+      if (b == std::string::npos)
+         return false;
+      std::string::size_type e = field.find_last_not_of(' ') + 1;
+
+      std::string::size_type i = b;
+      bool neg = false;
+      if (field[i] == '-' || field[i] == '+')
+         neg = (field[i++] == '-');
+
+      long long ip = 0, fp = 0;
+      int nd = 0;
+      for ( ; i < e && std::isdigit(field[i]); i++)
+         ip = 10*ip + (field[i] - '0');
+      if (i < e && field[i] == '.')
+      {
+         for (i++; i < e && std::isdigit(field[i]); i++)
+         {
+            if (nd < decimals)
+            {
+               fp = 10*fp + (field[i] - '0');
+               nd++;
+            }
+         }
+      }
+
+      if (i != e)
+      {
+            // Not plain fixed point, let strtod have a go
+         std::string s(field.substr(b, e-b));
+         char *end;
+         double x = std::strtod(s.c_str(), &end);
+         if (end == s.c_str())
+            return false;
+         x *= tenTo(decimals);
+         v = static_cast<long long>(x < 0 ? x - 0.5 : x + 0.5);
+         return true;
+      }
+
+      for ( ; nd < decimals; nd++)
+         fp *= 10;
+      v = ip * tenTo(decimals) + fp;
+      if (neg)
+         v = -v;
+      return true;
+   }
+
+
+      // Integer in units of the last digit as a fixed point RINEX field.
+   static std::string formatFixed(long long v, int width, int decimals)
+   {
+      bool neg = (v < 0);
+      unsigned long long a = neg ? -(unsigned long long)v : v;
+      unsigned long long p = tenTo(decimals);
+      char buf[64];
+      std::sprintf(buf, "%s%llu.%0*llu", neg ? "-" : "", a / p,
+                   decimals, a % p);
+      return padTo(std::string(width > (int)std::strlen(buf) ?
+                               width - std::strlen(buf) : 0, ' ') + buf,
+                   width);
+   }
+
+
+   bool CompactRinexBuf::Arc::decode(const std::string& field)
+   {
+      std::string::size_type amp = field.find('&');
+      if (amp != std::string::npos)
+      {
+         long long k;
+         if (!parseInt(field.substr(0, amp), k) || k < 0 || k > maxOrder ||
+             !parseInt(field.substr(amp+1), d[0]))
+            return false;
+         valid = true;
+         order = k;
+         count = 0;
+         return true;
+      }
+
+      long long v;
+      if (!valid || !parseInt(field, v))
+         return false;
+
+         // Integrate the difference of the highest order held
+      int k = (count < order) ? count+1 : order;
+      d[k] = v;
+      for (int j = k-1; j >= 0; j--)
+         d[j] += d[j+1];
+      count = k;
+      return true;
+   }
+
+
+   std::string CompactRinexBuf::Arc::encode(long long value, int newOrder)
+   {
+      char buf[48];
+      if (!valid)
+      {
+         valid = true;
+         order = newOrder;
+         count = 0;
+         d[0] = value;
+         std::sprintf(buf, "%d&%lld", order, value);
+         return buf;
+      }
+
+         // Differences of increasing order, up to the one written
+      int k = (count < order) ? count+1 : order;
+      long long e[maxOrder+1];
+      e[0] = value;
+      for (int j = 1; j <= k; j++)
+         e[j] = e[j-1] - d[j-1];
+      std::copy(e, e+k+1, d);
+      count = k;
+      std::sprintf(buf, "%lld", e[k]);
+      return buf;
+   }
+
+
+   CompactRinexBuf::CompactRinexBuf()
+         : mode(Closed), sb(0)
+   {
+      reset();
+   }
+
+
+   CompactRinexBuf::~CompactRinexBuf()
+   {
+   }
+
+
+   void CompactRinexBuf::reset()
+   {
+      crxVersion = 0;
+      inHeader = true;
+      numTypes.clear();
+      epochLine.clear();
+      clock = Arc();
+      sats.clear();
+      error.clear();
+      out.clear();
+      outStart = 0;
+      keepFrom = 0;
+      crxHeaderDone = false;
+      pending.clear();
+      epochRinex.clear();
+      linesNeeded = 0;
+      written = 0;
+      setg(0, 0, 0);
+      setp(0, 0);
+   }
+
+
+   bool CompactRinexBuf::isCompactRinex(std::streambuf* sb)
+   {
+      if (sb == 0)
+         return false;
+
+      char buf[82];
+      std::streamsize n = sb->sgetn(buf, sizeof(buf));
+      sb->pubseekpos(0, std::ios::in);
+
+      std::string line(buf, n > 0 ? n : 0);
+      line = line.substr(0, line.find('\n'));
+      return (line.size() >= 80 && line.substr(60, 20) == crxLabel);
+   }
+
+
+   bool CompactRinexBuf::isCompactRinexName(const std::string& fn)
+   {
+      std::string name(fn);
+      for (std::string::size_type i = 0; i < name.size(); i++)
+         name[i] = std::tolower(name[i]);
+
+      std::string::size_type dot = name.rfind('.');
+      if (dot != std::string::npos &&
+          (name.substr(dot) == ".gz" || name.substr(dot) == ".z"))
+      {
+         name.erase(dot);
+         dot = name.rfind('.');
+      }
+      if (dot == std::string::npos)
+         return false;
+
+      std::string ext(name.substr(dot+1));
+      return (ext == "crx" ||
+              (ext.size() == 3 && std::isdigit(ext[0]) &&
+               std::isdigit(ext[1]) && ext[2] == 'd'));
+   }
+
+
+   bool CompactRinexBuf::attach( std::iostream& strm,
+                                 std::ios::openmode m )
+   {
+      detach(strm);
+
+      std::streambuf* cur = strm.rdbuf();
+      if (cur == 0 || !strm)
+         return false;
+
+      Mode newMode;
+      if (m & std::ios::in)
+      {
+         if (!isCompactRinex(cur))
+            return false;
+         newMode = Reading;
+      }
+      else if (m & std::ios::out)
+      {
+         newMode = Writing;
+      }
+      else
+         return false;
+
+      reset();
+      sb = cur;
+      mode = newMode;
+      strm.rdbuf(this);
+      return true;
+   }
+
+
+   void CompactRinexBuf::detach(std::ios& strm)
+   {
+      if (mode == Closed)
+         return;
+
+      if (strm.rdbuf() == this)
+      {
+         std::ios::iostate state(strm.rdstate());
+         strm.rdbuf(sb);
+         try
+         {
+            strm.setstate(state);
+         }
+         catch(std::ios::failure& e)
+         {
+               // Exceptions may be enabled, and we may be in a destructor
+         }
+      }
+      if (mode == Writing)
+         sb->pubsync();
+
+      mode = Closed;
+      sb = 0;
+      reset();
+   }
+
+
+   bool CompactRinexBuf::getLine(std::string& line)
+   {
+      line.clear();
+      int_type c;
+      while ((c = sb->sbumpc()) != traits_type::eof())
+      {
+         if (c == '\n')
+            break;
+         line += traits_type::to_char_type(c);
+      }
+      if (c == traits_type::eof() && line.empty())
+         return false;
+      if (!line.empty() && line[line.size()-1] == '\r')
+         line.erase(line.size()-1);
+      return true;
+   }
+
+
+   void CompactRinexBuf::putLine(const std::string& line)
+   {
+      sb->sputn(line.data(), line.size());
+      sb->sputc('\n');
+   }
+
+
+   void CompactRinexBuf::headerLine(const std::string& line)
+   {
+      std::string label(labelOf(line));
+      if (label == "# / TYPES OF OBSERV")
+      {
+            // RINEX 2; continuation lines have a blank count
+         if (trimRight(line.substr(0, 6)).size() > 0)
+            numTypes['\0'] = std::atoi(line.substr(0, 6).c_str());
+      }
+      else if (label == "SYS / # / OBS TYPES")
+      {
+            // RINEX 3; continuation lines have a blank system
+         if (line[0] != ' ')
+            numTypes[line[0]] = std::atoi(line.substr(3, 3).c_str());
+      }
+      else if (label == "END OF HEADER")
+      {
+         inHeader = false;
+      }
+   }
+
+
+   bool CompactRinexBuf::fail(const std::string& msg)
+   {
+      if (error.empty())
+         error = "Compact RINEX: " + msg;
+      return false;
+   }
+
+
+   bool CompactRinexBuf::decodeMore()
+   {
+      if (!error.empty())
+         return false;
+
+      std::string line;
+      if (!crxHeaderDone)
+      {
+         if (!getLine(line))
+            return false;
+         if (line.size() < 80 || line.substr(60, 20) != crxLabel)
+            return fail("missing CRINEX VERS / TYPE line");
+         crxVersion = (std::atof(line.substr(0, 20).c_str()) >= 3.0) ? 3 : 1;
+         if (!getLine(line))
+            return fail("missing CRINEX PROG / DATE line");
+         crxHeaderDone = true;
+      }
+
+      if (!getLine(line))
+         return false;
+
+         // The RINEX header is copied as is
+      if (inHeader)
+      {
+         headerLine(line);
+         out += line;
+         out += '\n';
+         return true;
+      }
+
+      return decodeEpoch(line);
+   }
+
+
+   bool CompactRinexBuf::decodeEpoch(const std::string& line)
+   {
+      const bool v1(crxVersion == 1);
+
+      if (!line.empty() && line[0] == (v1 ? '&' : '>'))
+      {
+            // Initialization of all
+         epochLine = line;
+         if (v1)
+            epochLine[0] = ' ';
+         sats.clear();
+         clock = Arc();
+      }
+      else
+      {
+         if (epochLine.empty())
+            return fail("epoch line is not initialized");
+         repair(epochLine, line);
+      }
+
+      const std::string::size_type flagPos(v1 ? 28 : 31),
+         satPos(v1 ? 32 : 41);
+      std::string ep(padTo(epochLine, satPos));
+      char flag = ep[flagPos];
+      int nsat = std::atoi(ep.substr(flagPos+1, 3).c_str());
+
+      if (flag >= '2' && flag <= '5')
+      {
+            // Event: the epoch line and the special records are copied
+         out += trimRight(epochLine);
+         out += '\n';
+         std::string rec;
+         for (int i = 0; i < nsat; i++)
+         {
+            if (!getLine(rec))
+               return fail("end of file inside an event");
+            if (flag == '3' || flag == '4')
+               headerLine(rec);
+            out += rec;
+            out += '\n';
+         }
+         epochLine.clear();
+         return true;
+      }
+
+         // Receiver clock offset
+      std::string cl;
+      if (!getLine(cl))
+         return fail("end of file inside an epoch");
+      bool haveClock(!cl.empty());
+      if (haveClock)
+      {
+         if (!clock.decode(cl))
+            return fail("bad clock offset: " + cl);
+      }
+      else
+         clock = Arc();
+
+      ep = padTo(ep, satPos + 3*nsat);
+
+         // Epoch line(s)
+      std::string text;
+      if (v1)
+      {
+         for (int i = 0; i < nsat || i == 0; i += 12)
+         {
+            std::string l(i == 0 ? ep.substr(0, satPos)
+                                 : std::string(satPos, ' '));
+            l += ep.substr(satPos + 3*i, 3*std::min(12, nsat-i));
+            if (i == 0 && haveClock)
+               l = padTo(l, 68) + formatFixed(clock.d[0], 12, 9);
+            text += trimRight(l);
+            text += '\n';
+         }
+      }
+      else
+      {
+         std::string l(ep.substr(0, satPos));
+         if (haveClock)
+            l += formatFixed(clock.d[0], 15, 12);
+         text += trimRight(l);
+         text += '\n';
+      }
+
+         // Observations, one satellite per line
+      std::map<std::string,SatState> newSats;
+      std::string dl;
+      for (int i = 0; i < nsat; i++)
+      {
+         std::string id(ep.substr(satPos + 3*i, 3));
+         std::map<char,int>::const_iterator nt =
+            numTypes.find(v1 ? '\0' : id[0]);
+         if (nt == numTypes.end())
+            return fail("no observation types for satellite " + id);
+
+         if (!getLine(dl))
+            return fail("end of file inside an epoch");
+
+         SatState& st(newSats[id]);
+         std::map<std::string,SatState>::iterator old = sats.find(id);
+         if (old != sats.end())
+            std::swap(st, old->second);
+         st.arcs.resize(nt->second);
+
+         std::vector<bool> have(nt->second);
+         std::string::size_type p = 0;
+         for (int j = 0; j < nt->second; j++)
+         {
+            if (p < dl.size() && dl[p] != ' ')
+            {
+               std::string::size_type q = dl.find(' ', p);
+               if (q == std::string::npos)
+                  q = dl.size();
+               if (!st.arcs[j].decode(dl.substr(p, q-p)))
+                  return fail("bad observation for satellite " + id + ": "
+                              + dl.substr(p, q-p));
+               have[j] = true;
+               p = q + 1;
+            }
+            else
+            {
+               st.arcs[j] = Arc();
+               p++;
+            }
+         }
+         if (p < dl.size())
+            repair(st.flags, dl.substr(p));
+         st.flags = padTo(st.flags, 2*nt->second);
+
+         std::string l(v1 ? "" : id);
+         for (int j = 0; j < nt->second; j++)
+         {
+            l += have[j] ? formatFixed(st.arcs[j].d[0], 14, 3)
+                         : std::string(14, ' ');
+            l += st.flags.substr(2*j, 2);
+            if (v1 && (j % 5 == 4 || j == nt->second-1))
+            {
+               text += trimRight(l);
+               text += '\n';
+               l.clear();
+            }
+         }
+         if (!v1)
+         {
+            text += trimRight(l);
+            text += '\n';
+         }
+      }
+
+      sats.swap(newSats);
+      out += text;
+      return true;
+   }
+
+
+   CompactRinexBuf::int_type CompactRinexBuf::underflow()
+   {
+      if (mode != Reading)
+         return traits_type::eof();
+      if (gptr() < egptr())
+         return traits_type::to_int_type(*gptr());
+
+         // The get area always covers 'out', so we are at its end
+      std::streamoff cur = outStart + out.size();
+      std::streamoff dropTo = (cur - keepFrom > maxKeep) ? cur : keepFrom;
+      if (dropTo > outStart)
+      {
+         out.erase(0, dropTo - outStart);
+         outStart = dropTo;
+      }
+
+      std::string::size_type before = out.size();
+      while (out.size() == before && decodeMore())
+         ;
+
+      char *base = &out[0];
+      setg(base, base + (cur - outStart), base + out.size());
+      if (gptr() == egptr())
+         return traits_type::eof();
+      return traits_type::to_int_type(*gptr());
+   }
+
+
+   bool CompactRinexBuf::reach(std::streamoff pos)
+   {
+      if (pos < outStart)
+      {
+            // Too far back, decode again from the beginning
+         if (sb->pubseekpos(0, std::ios::in) != std::streampos(0))
+            return false;
+         reset();
+      }
+
+      while (outStart + (std::streamoff)out.size() < pos)
+      {
+         outStart += out.size();
+         out.clear();
+         if (!decodeMore())
+            break;
+      }
+      if (outStart + (std::streamoff)out.size() < pos)
+         return false;
+
+      char *base = &out[0];
+      setg(base, base + (pos - outStart), base + out.size());
+      return true;
+   }
+
+
+   CompactRinexBuf::pos_type CompactRinexBuf::seekoff( off_type off,
+                                                       std::ios::seekdir dir,
+                                                       std::ios::openmode )
+   {
+      if (mode == Writing && off == 0 && dir == std::ios::cur)
+         return pos_type(written);
+      if (mode != Reading)
+         return pos_type(off_type(-1));
+
+      std::streamoff cur = outStart + (gptr() - eback());
+      if (dir == std::ios::cur && off == 0)
+      {
+         keepFrom = cur;
+         return pos_type(cur);
+      }
+
+      std::streamoff target;
+      if (dir == std::ios::beg)
+         target = off;
+      else if (dir == std::ios::cur)
+         target = cur + off;
+      else
+         return pos_type(off_type(-1));
+
+      return seekpos(pos_type(target), std::ios::in);
+   }
+
+
+   CompactRinexBuf::pos_type CompactRinexBuf::seekpos( pos_type pos,
+                                                       std::ios::openmode )
+   {
+      std::streamoff p(pos);
+      if (mode != Reading || p < 0 || !reach(p))
+         return pos_type(off_type(-1));
+      keepFrom = p;
+      return pos;
+   }
+
+
+   CompactRinexBuf::int_type CompactRinexBuf::overflow(int_type c)
+   {
+      if (mode != Writing)
+         return traits_type::eof();
+      if (traits_type::eq_int_type(c, traits_type::eof()))
+         return traits_type::not_eof(c);
+      char ch(traits_type::to_char_type(c));
+      xsputn(&ch, 1);
+      return c;
+   }
+
+
+   std::streamsize CompactRinexBuf::xsputn(const char* s, std::streamsize n)
+   {
+      if (mode != Writing)
+         return 0;
+
+      const char *end = s + n;
+      while (s < end)
+      {
+         const char *nl = static_cast<const char*>(std::memchr(s, '\n',
+                                                               end - s));
+         if (nl == 0)
+         {
+            pending.append(s, end);
+            break;
+         }
+         pending.append(s, nl);
+         if (!pending.empty() && pending[pending.size()-1] == '\r')
+            pending.erase(pending.size()-1);
+         takeLine(pending);
+         pending.clear();
+         s = nl + 1;
+      }
+      written += n;
+      return n;
+   }
+
+
+   int CompactRinexBuf::sync()
+   {
+      if (mode == Writing)
+         return sb->pubsync();
+      return 0;
+   }
+
+
+   void CompactRinexBuf::takeLine(const std::string& line)
+   {
+      if (!error.empty())
+         return;
+
+      if (!crxHeaderDone)
+      {
+         if (labelOf(line) != "RINEX VERSION / TYPE")
+         {
+            fail("RINEX text does not start with RINEX VERSION / TYPE");
+            return;
+         }
+         crxVersion = (std::atof(line.substr(0, 9).c_str()) >= 3.0) ? 3 : 1;
+
+         char date[32];
+         std::time_t now(std::time(0));
+         std::strftime(date, sizeof(date), "%d-%b-%y %H:%M",
+                       std::gmtime(&now));
+         putLine(padTo(crxVersion == 3 ? "3.0" : "1.0", 20) +
+                 padTo("COMPACT RINEX FORMAT", 40) + crxLabel);
+         putLine(padTo(programName, 40) + padTo(date, 20) +
+                 "CRINEX PROG / DATE");
+         crxHeaderDone = true;
+      }
+
+      if (inHeader)
+      {
+         headerLine(line);
+         putLine(line);
+         return;
+      }
+
+      if (epochRinex.empty())
+      {
+            // Epoch line: find how many lines make up the epoch
+         const bool v1(crxVersion == 1);
+         std::string ep(padTo(line, 35));
+         if (trimRight(line).empty())
+            return;
+         if (!v1 && ep[0] != '>')
+         {
+            fail("RINEX epoch line expected: " + line);
+            return;
+         }
+         char flag = ep[v1 ? 28 : 31];
+         int nsat = std::atoi(ep.substr(v1 ? 29 : 32, 3).c_str());
+         if (flag >= '2' && flag <= '5')
+            linesNeeded = nsat;
+         else if (v1)
+            linesNeeded = (nsat > 0 ? (nsat-1)/12 : 0) +
+               nsat * std::max(1, (numTypes['\0'] + 4) / 5);
+         else
+            linesNeeded = nsat;
+      }
+      else
+         linesNeeded--;
+
+      epochRinex.push_back(line);
+      if (linesNeeded <= 0)
+      {
+         encodeEpoch();
+         epochRinex.clear();
+      }
+   }
+
+
+   void CompactRinexBuf::encodeEpoch()
+   {
+      const bool v1(crxVersion == 1);
+      const std::string::size_type flagPos(v1 ? 28 : 31),
+         satPos(v1 ? 32 : 41);
+      std::string ep(padTo(epochRinex[0], 80));
+      char flag = ep[flagPos];
+      int nsat = std::atoi(ep.substr(flagPos+1, 3).c_str());
+
+      if (flag >= '2' && flag <= '5')
+      {
+            // Event: the epoch line and the special records are copied,
+            // and the next epoch is an initialization
+         std::string l(trimRight(epochRinex[0]));
+         if (v1 && !l.empty())
+            l[0] = '&';
+         putLine(l);
+         for (size_t i = 1; i < epochRinex.size(); i++)
+         {
+            if (flag == '3' || flag == '4')
+               headerLine(epochRinex[i]);
+            putLine(epochRinex[i]);
+         }
+         epochLine.clear();
+         return;
+      }
+
+         // Satellites and clock offset
+      std::vector<std::string> ids;
+      std::vector<std::string> data;
+      long long clk;
+      bool haveClock;
+      std::string crx(ep.substr(0, satPos));
+      size_t next = 1;
+      if (v1)
+      {
+         haveClock = parseFixed(ep.substr(68, 12), 9, clk);
+         for (int i = 0; i < nsat; i++)
+         {
+            if (i > 0 && i % 12 == 0)
+               ep = padTo(epochRinex[next++], 80);
+            ids.push_back(ep.substr(satPos + 3*(i % 12), 3));
+         }
+         int nl = std::max(1, (numTypes['\0'] + 4) / 5);
+         for (int i = 0; i < nsat; i++)
+         {
+            std::string d;
+            for (int j = 0; j < nl; j++)
+               d += padTo(epochRinex[next++], 80).substr(0, 80);
+            data.push_back(d);
+         }
+      }
+      else
+      {
+         haveClock = parseFixed(ep.substr(41, 15), 12, clk);
+         for (int i = 0; i < nsat; i++)
+         {
+            std::string d(padTo(epochRinex[next++], 3));
+            ids.push_back(d.substr(0, 3));
+            data.push_back(d.substr(3));
+         }
+      }
+
+         // Epoch line, as a difference from the previous one
+      for (int i = 0; i < nsat; i++)
+         crx += ids[i];
+      crx = trimRight(crx);
+      if (epochLine.empty())
+      {
+         std::string l(crx);
+         l[0] = v1 ? '&' : '>';
+         putLine(l);
+         sats.clear();
+         clock = Arc();
+      }
+      else
+         putLine(textDiff(epochLine, crx));
+      epochLine = crx;
+
+      if (haveClock)
+         putLine(clock.encode(clk, diffOrder));
+      else
+      {
+         clock = Arc();
+         putLine("");
+      }
+
+         // Observations, and flags as a difference
+      std::map<std::string,SatState> newSats;
+      for (int i = 0; i < nsat; i++)
+      {
+         int nt = numTypes[v1 ? '\0' : ids[i][0]];
+         SatState& st(newSats[ids[i]]);
+         std::map<std::string,SatState>::iterator old = sats.find(ids[i]);
+         if (old != sats.end())
+            std::swap(st, old->second);
+         st.arcs.resize(nt);
+
+         std::string d(padTo(data[i], 16*nt));
+         std::string l, flags(2*nt, ' ');
+         for (int j = 0; j < nt; j++)
+         {
+               // RINEX 2 has five observations per 80-column line
+            std::string::size_type off = v1 ? 80*(j/5) + 16*(j%5) : 16*j;
+            if (v1)
+               d = padTo(d, off + 16);
+            long long v;
+            if (parseFixed(d.substr(off, 14), 3, v))
+               l += st.arcs[j].encode(v, diffOrder);
+            else
+               st.arcs[j] = Arc();
+            l += ' ';
+            flags[2*j] = d[off+14];
+            flags[2*j+1] = d[off+15];
+         }
+         l += textDiff(st.flags, flags);
+         st.flags = flags;
+         putLine(trimRight(l));
+      }
+      sats.swap(newSats);
+   }
+
+}  // End of namespace gpstk
@@ -0,0 +1,301 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file CompactRinexBuf.hpp
+ * Stream buffer decoding and encoding Hatanaka Compact RINEX observation data.
+ */
+
+#ifndef GPSTK_COMPACTRINEXBUF_HPP
+#define GPSTK_COMPACTRINEXBUF_HPP
+
+#include <streambuf>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This is a stream buffer that converts between Compact RINEX
+       * (CRINEX, the Hatanaka compression of RINEX observation files,
+       * versions 1.0 for RINEX 2 and 3.0 for RINEX 3) and plain
+       * RINEX text. It sits on top of the stream buffer of a file.
+       *
+       * When reading, it decodes CRINEX one header line or one epoch at
+       * a time, and hands out the RINEX text, so the usual header and
+       * data classes parse it unchanged. When writing, it takes RINEX
+       * text and writes CRINEX, one epoch at a time, with differences
+       * of third order as rnx2crx does. The CRINEX PROG / DATE line
+       * written names this class (programName).
+       *
+       * Observation streams attach it by themselves (see
+       * CompactRinexStream): an input file is decoded if its first line
+       * is a CRINEX header, and an output file is encoded when asked
+       * with CompactRinexStream::setCompactOutput(). No temporary file
+       * is needed.
+       *
+       * Positions are counted in RINEX characters. The decoded text is
+       * kept from the last position told (tellg()) on, so seeking back
+       * to it, as FFStream does when a record can't be read, is cheap;
+       * seeking further back restarts the decoding from the beginning
+       * of the file.
+       *
+       * Errors in the data do not throw from the buffer: they end the
+       * decoded (or encoded) text, and are reported by hasError() and
+       * getError().
+       *
+       * @warning The decoder has only been checked against files written
+       * by this class's own encoder, not against files written by
+       * RNX2CRX. A mistake shared by both, e.g. in the clock field, the
+       * satellite list columns or the flag field spacing, would not be
+       * found by the tests.
+       */
+   class CompactRinexBuf : public std::streambuf
+   {
+   public:
+
+         /// Default constructor, it does nothing until attached.
+      CompactRinexBuf();
+
+         /// Destructor
+      virtual ~CompactRinexBuf();
+
+         /** Check whether the data available from a stream buffer
+          * start with a Compact RINEX header. The buffer is rewound.
+          * @param[in] sb the stream buffer to check.
+          */
+      static bool isCompactRinex(std::streambuf* sb);
+
+         /** Check whether a file name follows the Compact RINEX
+          * naming conventions: ".crx" (RINEX 3 long names), or a "yyd"
+          * extension (RINEX 2 short names); a trailing ".gz" or ".Z"
+          * is ignored. Applications may use it to decide whether to
+          * write Compact RINEX; the streams don't.
+          * @param[in] fn the file name.
+          */
+      static bool isCompactRinexName(const std::string& fn);
+
+         /** Attach to a stream: when \a mode is for input, only if
+          * the stream data start with a CRINEX header; when \a mode is
+          * for output, always, to encode what is written. Any previous
+          * attachment is removed first.
+          * @param[in,out] strm the stream, freshly opened.
+          * @param[in] mode the mode in which \a strm was opened.
+          * @return true if attached.
+          */
+      bool attach( std::iostream& strm,
+                   std::ios::openmode mode );
+
+         /** Detach from a stream, giving back its previous stream
+          * buffer. Nothing is done if not attached.
+          */
+      void detach(std::ios& strm);
+
+         /// Whether the buffer is attached to a stream.
+      bool isAttached() const
+      { return (mode != Closed); }
+
+         /// Whether an error was found in the data.
+      bool hasError() const
+      { return !error.empty(); }
+
+         /// Description of the error found in the data, if any.
+      const std::string& getError() const
+      { return error; }
+
+         /// Name written in the "CRINEX PROG / DATE" header line.
+      static const std::string programName;
+
+         /// Order of the differences used when writing.
+      static const int diffOrder;
+
+   protected:
+
+         /// Decodes more data when the RINEX text handed out is used up.
+      virtual int_type underflow();
+
+         /// Only gives or sets the position, see the class description.
+      virtual pos_type seekoff( off_type off,
+                                std::ios::seekdir dir,
+                                std::ios::openmode which );
+
+         /// Only gives or sets the position, see the class description.
+      virtual pos_type seekpos( pos_type pos,
+                                std::ios::openmode which );
+
+         /// Takes one character of RINEX text.
+      virtual int_type overflow(int_type c);
+
+         /// Takes several characters of RINEX text.
+      virtual std::streamsize xsputn(const char* s, std::streamsize n);
+
+         /// Flushes the underlying buffer (only whole epochs are written).
+      virtual int sync();
+
+   private:
+
+         /// Maximum order of the differences.
+      static const int maxOrder = 9;
+
+         /// State of the differences of one observable, or of the clock.
+      struct Arc
+      {
+         Arc() : valid(false), order(0), count(0) {}
+
+            /// Whether the arc has been initialized.
+         bool valid;
+            /// Order of the differences.
+         int order;
+            /// Number of differences held (it grows up to 'order').
+         int count;
+            /// Last value (d[0]) and last differences of order 1..count.
+         long long d[maxOrder+1];
+
+            /** Set the value from a CRINEX field.
+             * @return false if the field is not valid. */
+         bool decode(const std::string& field);
+
+            /// Get the CRINEX field for a new value.
+         std::string encode(long long value, int newOrder);
+      };
+
+         /// Data of one satellite in the previous epoch.
+      struct SatState
+      {
+         std::vector<Arc> arcs;
+         std::string flags;
+      };
+
+      enum Mode { Closed, Reading, Writing };
+
+         /// What the buffer is doing.
+      Mode mode;
+
+         /// The stream buffer of the file.
+      std::streambuf* sb;
+
+         /// CRINEX version: 1 (RINEX 2) or 3 (RINEX 3).
+      int crxVersion;
+
+         /// Whether the RINEX header has been passed (or written).
+      bool inHeader;
+
+         /// Number of observation types, by system ('\0' for RINEX 2).
+      std::map<char,int> numTypes;
+
+         /// Previous CRINEX epoch line; empty if the next one must be
+         /// an initialization.
+      std::string epochLine;
+
+         /// Clock offset, in units of the last digit.
+      Arc clock;
+
+         /// Satellites of the previous epoch.
+      std::map<std::string,SatState> sats;
+
+         /// Error found in the data.
+      std::string error;
+
+         /// Decoded RINEX text, starting at position 'outStart'.
+      std::string out;
+      std::streamoff outStart;
+
+         /// Position told last; the text from there on is kept.
+      std::streamoff keepFrom;
+
+         /// Whether the CRINEX header lines have been read (or written).
+      bool crxHeaderDone;
+
+         /// Incomplete line of RINEX text written.
+      std::string pending;
+
+         /// RINEX lines of the epoch being written.
+      std::vector<std::string> epochRinex;
+
+         /// RINEX lines still needed to complete that epoch.
+      int linesNeeded;
+
+         /// Number of RINEX characters written.
+      std::streamoff written;
+
+         /// Reset the state for a new file.
+      void reset();
+
+         /// Reads a line from the underlying buffer, without the end of
+         /// line. It returns false at end of file.
+      bool getLine(std::string& line);
+
+         /// Writes a line to the underlying buffer.
+      void putLine(const std::string& line);
+
+         /// Keeps track of the RINEX header: version, observation types.
+      void headerLine(const std::string& line);
+
+         /// Records an error; it returns false.
+      bool fail(const std::string& msg);
+
+         /// Decodes the next header line or epoch into 'out'. It returns
+         /// false at end of file or on error.
+      bool decodeMore();
+
+         /// Decodes one epoch, whose CRINEX epoch line is 'line'.
+      bool decodeEpoch(const std::string& line);
+
+         /// Sets 'out' to cover position 'pos', for seeking.
+      bool reach(std::streamoff pos);
+
+         /// Takes a complete line of RINEX text.
+      void takeLine(const std::string& line);
+
+         /// Writes the epoch in 'epochRinex' as CRINEX.
+      void encodeEpoch();
+
+         /// Copying is not allowed.
+      CompactRinexBuf(const CompactRinexBuf&);
+      CompactRinexBuf& operator=(const CompactRinexBuf&);
+
+   }; // End of class 'CompactRinexBuf'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_COMPACTRINEXBUF_HPP
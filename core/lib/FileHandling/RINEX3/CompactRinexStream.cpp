@@ -0,0 +1,157 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/**
+ * @file CompactRinexStream.cpp
+ * File stream for RINEX observation files that may be Compact RINEX.
+ */
+
+#include "CompactRinexStream.hpp"
+
+namespace gpstk
+{
+   CompactRinexStream ::
+   CompactRinexStream()
+         : openMode(std::ios::in)
+   {
+   }
+
+
+   CompactRinexStream ::
+   CompactRinexStream( const char* fn,
+                       std::ios::openmode mode )
+         : FFTextStream(fn, mode),
+           openMode(mode)
+   {
+      if (mode & std::ios::in)
+         crxBuf.attach(*this, mode);
+   }
+
+
+   CompactRinexStream ::
+   ~CompactRinexStream()
+   {
+      crxBuf.detach(*this);
+   }
+
+
+   void CompactRinexStream ::
+   open( const char* fn,
+         std::ios::openmode mode )
+   {
+      crxBuf.detach(*this);
+      FFTextStream::open(fn, mode);
+      openMode = mode;
+      if (mode & std::ios::in)
+         crxBuf.attach(*this, mode);
+   }
+
+
+   void CompactRinexStream ::
+   open( const std::string& fn,
+         std::ios::openmode mode )
+   {
+      open(fn.c_str(), mode);
+   }
+
+
+   void CompactRinexStream ::
+   close()
+   {
+      crxBuf.detach(*this);
+      FFTextStream::close();
+   }
+
+
+   bool CompactRinexStream ::
+   setCompactOutput()
+   {
+      if (isCompact())
+         return (openMode & std::ios::out) && !(openMode & std::ios::in);
+      if (!is_open() || (openMode & std::ios::in) || tellp() != 0)
+         return false;
+      return crxBuf.attach(*this, openMode);
+   }
+
+
+   void CompactRinexStream ::
+   tryFFStreamGet(FFData& rec)
+      throw(FFStreamError, gpstk::StringUtils::StringException)
+   {
+      try
+      {
+         FFTextStream::tryFFStreamGet(rec);
+      }
+      catch(Exception& e)
+      {
+            // A truncated record is better explained by the decoder
+         if (!crxBuf.hasError())
+            throw;
+      }
+
+      if (crxBuf.hasError() && fail())
+         checkCompact();
+   }
+
+
+   void CompactRinexStream ::
+   tryFFStreamPut(const FFData& rec)
+      throw(FFStreamError, gpstk::StringUtils::StringException)
+   {
+      FFTextStream::tryFFStreamPut(rec);
+
+      if (crxBuf.hasError())
+         checkCompact();
+   }
+
+
+   void CompactRinexStream ::
+   checkCompact()
+   {
+      mostRecentException = FFStreamError(crxBuf.getError());
+      mostRecentException.addText("In file " + filename);
+      mostRecentException.addLocation(FILE_LOCATION);
+      try
+      {
+         setstate(std::ios::failbit);
+      }
+      catch(std::ios::failure& e)
+      {
+            // conditionalThrow() below throws the right exception
+      }
+      conditionalThrow();
+   }
+
+}  // End of namespace gpstk
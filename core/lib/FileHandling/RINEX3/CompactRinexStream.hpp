@@ -0,0 +1,128 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/**
+ * @file CompactRinexStream.hpp
+ * File stream for RINEX observation files that may be Compact RINEX.
+ */
+
+#ifndef GPSTK_COMPACTRINEXSTREAM_HPP
+#define GPSTK_COMPACTRINEXSTREAM_HPP
+
+#include "FFTextStream.hpp"
+#include "CompactRinexBuf.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This is the text stream under the RINEX observation streams
+       * (RinexObsStream and Rinex3ObsStream), which handles Compact
+       * RINEX (Hatanaka compressed) files through a CompactRinexBuf.
+       *
+       * Input files are recognized by their first line and decoded on
+       * the fly. Output files are written as plain RINEX, unless
+       * setCompactOutput() is called before anything is written; the
+       * name of the file is not looked at (see
+       * CompactRinexBuf::isCompactRinexName() for the conventions).
+       * Errors in the Compact RINEX data are reported as FFStreamError.
+       */
+   class CompactRinexStream : public FFTextStream
+   {
+   public:
+         /// Default constructor
+      CompactRinexStream();
+
+         /** Common constructor.
+          *
+          * @param[in] fn the file to open
+          * @param[in] mode how to open \a fn.
+          */
+      CompactRinexStream( const char* fn,
+                          std::ios::openmode mode=std::ios::in );
+
+         /// Destructor
+      virtual ~CompactRinexStream();
+
+         /// Overrides open to decode Compact RINEX input files.
+      virtual void open( const char* fn,
+                         std::ios::openmode mode );
+
+         /// Overrides open to decode Compact RINEX input files.
+      virtual void open( const std::string& fn,
+                         std::ios::openmode mode );
+
+         /// Overrides close to detach the Compact RINEX buffer first.
+      void close();
+
+         /** Write the file as Compact RINEX. It must be called after
+          * opening the stream for output, before writing the header.
+          * @return true if the stream now writes Compact RINEX.
+          */
+      bool setCompactOutput();
+
+         /// Whether the file is Compact RINEX, decoded (or encoded) on
+         /// the fly.
+      bool isCompact() const
+      { return crxBuf.isAttached(); }
+
+   protected:
+         /// Reports Compact RINEX decoding errors as FFStreamError.
+      virtual void tryFFStreamGet(FFData& rec)
+         throw(FFStreamError, gpstk::StringUtils::StringException);
+
+         /// Reports Compact RINEX encoding errors as FFStreamError.
+      virtual void tryFFStreamPut(const FFData& rec)
+         throw(FFStreamError, gpstk::StringUtils::StringException);
+
+   private:
+         /// Compact RINEX decoder (or encoder), when needed.
+      CompactRinexBuf crxBuf;
+
+         /// Mode the file was opened with.
+      std::ios::openmode openMode;
+
+         /// Turns a Compact RINEX error into an FFStreamError.
+      void checkCompact();
+
+   }; // End of class 'CompactRinexStream'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_COMPACTRINEXSTREAM_HPP
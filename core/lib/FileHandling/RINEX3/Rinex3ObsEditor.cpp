@@ -0,0 +1,713 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/** @file Rinex3ObsEditor.cpp
+ * Apply time-tagged editing commands to RINEX observation data.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+#include "StringUtils.hpp"
+#include "Epoch.hpp"
+#include "TimeString.hpp"
+#include "logstream.hpp"
+#include "Rinex3ObsEditor.hpp"
+
+using namespace std;
+using namespace gpstk::StringUtils;
+
+namespace gpstk
+{
+   namespace
+   {
+         // format of times in EditCmd::asString()
+      const string longfmt("%04Y/%02m/%02d %02H:%02M:%02S = %4F %10.3g %P");
+
+         // used for sorting
+      struct EditCmdLessThan
+      {
+         bool operator()(const Rinex3ObsEditor::EditCmd& ec1,
+                         const Rinex3ObsEditor::EditCmd& ec2) const
+         { return (ec1.ttag < ec2.ttag); }
+      };
+
+         // commands of the same type, satellite and obs type, i.e. those
+         // a stop (-) command may end
+      struct GroupLessThan
+      {
+         bool operator()(const Rinex3ObsEditor::EditCmd& ec1,
+                         const Rinex3ObsEditor::EditCmd& ec2) const
+         {
+            if(ec1.type != ec2.type) return (ec1.type < ec2.type);
+            if(ec1.sat != ec2.sat) return (ec1.sat < ec2.sat);
+            return (ec1.obs < ec2.obs);
+         }
+      };
+
+         // apply an obs-level command to one datum
+      void editDatum(const Rinex3ObsEditor::EditCmd& cmd, RinexDatum& rd,
+                     bool biasZero)
+      {
+         typedef Rinex3ObsEditor::EditCmd EditCmd;
+         switch(cmd.type)
+         {
+               // DD delete data -----------------------------------------------
+            case EditCmd::ddCT:
+               rd.data = 0.0;
+               rd.ssi = 0;
+               rd.lli = 0;
+               break;
+               // SD set data --------------------------------------------------
+            case EditCmd::sdCT:
+               rd.data = cmd.data;
+               break;
+               // SS set SSI ---------------------------------------------------
+            case EditCmd::ssCT:
+               rd.ssi = cmd.idata;
+               break;
+               // SL set LLI ---------------------------------------------------
+            case EditCmd::slCT:
+               rd.lli = cmd.idata;
+               break;
+               // BD bias data -------------------------------------------------
+            case EditCmd::bdCT:     // do not bias missing data
+               if(rd.data != 0.0 || biasZero)
+                  rd.data += cmd.data;
+               break;
+               // BS bias SSI --------------------------------------------------
+            case EditCmd::bsCT:
+               rd.ssi += cmd.idata;
+               break;
+               // BL bias LLI --------------------------------------------------
+            case EditCmd::blCT:
+               rd.lli += cmd.idata;
+               break;
+            default:
+               break;
+         }
+      }
+
+         // true for the commands that edit a single obs type
+      bool isObsCmd(const Rinex3ObsEditor::EditCmd& cmd)
+      {
+         return (cmd.type >= Rinex3ObsEditor::EditCmd::ddCT &&
+                 cmd.type <= Rinex3ObsEditor::EditCmd::blCT);
+      }
+   }
+
+   //---------------------------------------------------------------------------
+   // constructor from strings, i.e. parser e.g. "DA+","t" or "BDp","SV,OT,t,s"
+   Rinex3ObsEditor::EditCmd::EditCmd(const string intypestr, const string inarg)
+      throw(Exception)
+   {
+      try {
+         string tag(upperCase(intypestr)), arg(inarg);
+         vector<string> flds;
+
+         type = invalidCT;                                 // defaults
+         ttag = CommonTime::BEGINNING_OF_TIME;
+         sign = idata = 0;
+         data = 0.0;
+
+         if(tag.size() < 2) return;
+         if(tag.size() == 2) sign = 0;                   // pull off sign
+         else if(tag[2] == '+') sign = 1;
+         else if(tag[2] == '-') sign = -1;
+         else return;
+         tag = tag.substr(0,2);
+
+         flds = split(arg,',');                          // split arg
+         const size_t n(flds.size());                    // number of args
+
+         if(tag == "OF") {
+            if(n != 1 && n != 3 && n != 7) return;
+            field = flds[0];
+            if(n != 1) {
+               stripLeading(arg,field+",");
+               if(!parseTime(arg,ttag)) return;
+            }
+            type = ofCT;
+         }
+         else if(tag == "DA") {
+            if(!parseTime(arg,ttag)) return;
+            type = daCT;
+         }
+         else if(tag == "DO") {
+            if(sign != 0) return;                        // no DO+ or DO-
+
+            if(arg.size() == 4)                          // get sys
+               sat.fromString(string(1,arg[0]));
+               // else sat sys is unknown
+            if(isValidRinexObsID(arg)) obs = RinexObsID(arg);
+            else return;
+            type = doCT;
+         }
+         else if(tag == "DS") {
+            if(n != 1 && n != 3 && n != 7) return;    // DS DS,w,sow and DS,y,m,d,h,m,s
+            try { sat.fromString(flds[0]); } catch(Exception) { return; }
+            if(n != 1) {                              // time for DS is BeginTime
+               stripLeading(arg,flds[0]+",");
+               if(!parseTime(arg,ttag)) return;
+            }
+            if(sign == 0 && n == 1) sign = 1;
+            type = dsCT;
+         }
+         else {
+               // args are SV,OT,t[,d or s or l]
+            if(n < 4) return;                            // at minimum SV,OT,week,sow
+
+            stripLeading(arg,flds[0]+","+flds[1]+",");   // remove 'SV,OT,' from arg
+
+            string dat;
+            if(tag != "DD") {                            // strip and save last arg (dsl)
+               dat = flds[flds.size()-1];
+               stripTrailing(arg,string(",")+dat,1);
+            }
+            if(!parseTime(arg,ttag)) return;             // get the time
+
+               // parse satellite
+            try { sat.fromString(flds[0]); } catch(Exception) { return; }
+
+               // add system char to obs string
+            if(flds[1].size() == 3 && sat.systemChar() != '?')
+               flds[1] = string(1,sat.systemChar()) + flds[1];
+               // parse obs type
+            if(isValidRinexObsID(flds[1])) obs = RinexObsID(flds[1]); else return;
+
+            if(tag == "DD") { type = ddCT; return; } // DD is done
+
+            if(n != 5 && n != 9) return;           // rest have SV,OT,t,d = 5 or 9 args
+
+            if(tag == "SD" || tag == "BD") {       // double data
+               if(isScientificString(dat)) data = asDouble(dat); else return;
+            }
+            else {                                 // rest have int data
+               if(isDigitString(dat)) idata = asInt(dat); else return;
+            }
+
+               // now just set type
+            if(tag == "SD") type = sdCT;
+            else if(tag == "SS") type = ssCT;
+            else if(tag == "SL") type = slCT;
+            else if(tag == "BS") type = bsCT;
+            else if(tag == "BL") type = blCT;
+            else if(tag == "BD") type = bdCT;
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------
+   bool Rinex3ObsEditor::EditCmd::parseTime(const string arg, CommonTime& ttag)
+      throw()
+   {
+      static const string fmtGPS("%F,%g"),fmtCAL("%Y,%m,%d,%H,%M,%S");
+      string str(arg);
+      stripLeading(str);
+      int n(numWords(str,','));
+      if(n == 2 || n == 6) {
+         Epoch ep;
+         try { ep.scanf(str, (n==2 ? fmtGPS : fmtCAL)); }
+         catch(StringException) { return false; }
+         ttag = static_cast<CommonTime>(ep);
+            // GPS and calendar times must compare while the commands
+            // are sorted; reset() sets the time system of the file
+         ttag.setTimeSystem(TimeSystem::Any);
+      }
+      else return false;
+
+      return true;
+   }
+
+   //---------------------------------------------------------------------------
+   // dump, with optional message
+   string Rinex3ObsEditor::EditCmd::asString(string msg) const throw(Exception)
+   {
+      try {
+         static const char *typeLabel[] = {
+            "--invalidCT--   ",
+            "OF_Output_File",
+            "DA_Delete_All ",
+            "DO_Delete_Obs ",
+            "DS_Delete_Sat ",
+            "DD_Delete_Data",
+            "SD_Set_Data   ",
+            "SS_Set_SSI    ",
+            "SL_Set_LLI    ",
+            "BD_Bias_Data  ",
+            "BS_Bias_SSI   ",
+            "BL_Bias_LLI   " };
+
+         ostringstream os;
+
+         if(msg.size()) os << msg;
+         os << " " << (type <= blCT ? typeLabel[type] : typeLabel[invalidCT])
+            << " " << (sign==0 ? "0" : (sign<0 ? "-":"+"))
+            << " SV:" << sat.toString()
+            << " OT:" << obs.asString()
+            << " d:" << fixed << setprecision(4) << data
+            << " i:" << idata
+            << " t:" << (ttag == CommonTime::BEGINNING_OF_TIME
+                         ? "BeginTime" : printTime(ttag,longfmt))
+            << " >" << field << "<";
+
+         return os.str();
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+      catch(std::exception& e) {
+         Exception E(string("std::except: ") + e.what());
+         GPSTK_THROW(E);
+      }
+   }
+
+   //---------------------------------------------------------------------------
+   Rinex3ObsEditor::Rinex3ObsEditor()
+         : timeTol(0.0), biasZero(false), next(0)
+   {}
+
+   //---------------------------------------------------------------------------
+   bool Rinex3ObsEditor::addCommand(const EditCmd& cmd)
+   {
+      if(!cmd.isValid()) return false;
+      cmds.push_back(cmd);
+      return true;
+   }
+
+   //---------------------------------------------------------------------------
+   bool Rinex3ObsEditor::addCommandLine(const string& line) throw(Exception)
+   {
+      string str(line);
+      string::size_type pos(str.find('#'));     // strip comment
+      if(pos != string::npos) str.erase(pos);
+      pos = str.find_last_not_of(" \t\r\n");   // strip whitespace
+      str.erase(pos == string::npos ? 0 : pos+1);
+      str.erase(0, str.find_first_not_of(" \t"));
+      if(str.empty()) return true;
+
+      stripLeading(str,"-",2);                  // -XX or --XX
+      if(str.size() < 2) return false;
+
+      pos = 2;
+      if(pos < str.size() && (str[pos] == '+' || str[pos] == '-')) pos++;
+      string tag(str.substr(0,pos)), arg(str.substr(pos));
+      arg.erase(0, arg.find_first_not_of(" \t"));
+
+      return addCommand(tag, arg);
+   }
+
+   //---------------------------------------------------------------------------
+   int Rinex3ObsEditor::addCommands(istream& is, vector<string>& bad)
+      throw(Exception)
+   {
+      size_t n(cmds.size());
+      string line;
+      while(getline(is, line)) {
+         if(!addCommandLine(line))
+            bad.push_back(line);
+      }
+      return int(cmds.size() - n);
+   }
+
+   //---------------------------------------------------------------------------
+   void Rinex3ObsEditor::compile() throw()
+   {
+      size_t k;
+      vector<EditCmd> newCmds;
+
+         // sort on time
+      stable_sort(cmds.begin(), cmds.end(), EditCmdLessThan());
+
+         // ensure each - command has a corresponding + command, i.e. that
+         // the last earlier command of its group is a + command
+         // (note that + cmds do not need a - cmd: they will just never be
+         // turned off)
+      map<EditCmd, int, GroupLessThan> lastSign;
+      map<EditCmd, int, GroupLessThan>::iterator it;
+      for(k=0; k<cmds.size(); k++) {
+         if(cmds[k].type == EditCmd::invalidCT) continue;
+         it = lastSign.find(cmds[k]);
+         if(cmds[k].sign == -1) {
+            if(it != lastSign.end() && it->second == -1) {     // this is an error
+               LOG(ERROR) << cmds[k].asString("Error: repeat '-'");
+               cmds[k].type = EditCmd::invalidCT;
+               continue;
+            }
+            if(it == lastSign.end() || it->second != 1) {
+               EditCmd ec(cmds[k]);
+               ec.sign = 1;
+               ec.ttag = CommonTime::BEGINNING_OF_TIME;
+               newCmds.push_back(ec);
+               LOG(VERBOSE) << ec.asString(" Add cmd:");
+            }
+         }
+         if(it == lastSign.end())
+            lastSign.insert(make_pair(cmds[k], cmds[k].sign));
+         else
+            it->second = cmds[k].sign;
+      }
+
+      if(newCmds.size() > 0) {
+         cmds.insert(cmds.end(), newCmds.begin(), newCmds.end());
+         stable_sort(cmds.begin(), cmds.end(), EditCmdLessThan());
+      }
+
+         // remove invalidCT commands
+      vector<EditCmd>::iterator jt(cmds.begin());
+      for(k=0; k<cmds.size(); k++)
+         if(cmds[k].type != EditCmd::invalidCT)
+            *jt++ = cmds[k];
+      cmds.erase(jt, cmds.end());
+
+         // number the groups
+      map<EditCmd, int, GroupLessThan> groups;
+      group.resize(cmds.size());
+      for(k=0; k<cmds.size(); k++) {
+         it = groups.insert(make_pair(cmds[k], int(groups.size()))).first;
+         group[k] = it->second;
+      }
+
+         // restart
+      next = 0;
+      current.clear();
+      started.clear();
+      active.assign(cmds.size(), 0);
+      groupActive.assign(groups.size(), deque<size_t>());
+      indexObsTypes();
+   }
+
+   //---------------------------------------------------------------------------
+   void Rinex3ObsEditor::reset(const Rinex3ObsHeader& header) throw(Exception)
+   {
+      try {
+         size_t i,k;
+         bool mungeData(false);
+
+            // we have to set the time system of all the timetags using
+            // ttag from file
+         for(k=0; k<cmds.size(); k++)
+            cmds[k].ttag.setTimeSystem(header.firstObs.getTimeSystem());
+
+            // generate output header from input header and DO,DS commands
+         outHead = header;
+         for(k=0; k<cmds.size(); k++) {
+            const EditCmd& cmd(cmds[k]);
+
+               // DO delete obs without sign
+            if(cmd.type == EditCmd::doCT) {
+                  // if the system is defined, delete only for that system
+               string sys(1,cmd.sat.systemChar());
+
+                  // loop over systems (short-circuit if sys is defined)
+               Rinex3ObsHeader::RinexObsMap::iterator jt;
+               for(jt=outHead.mapObsTypes.begin();
+                   jt != outHead.mapObsTypes.end(); ++jt)
+               {
+                  if(sys != string("?") && sys != jt->first)
+                     continue;
+                  if(!isValidRinexObsID(jt->first + cmd.obs.asString()))
+                     continue;               // not an obs type of this system
+                  RinexObsID obsid(jt->first + cmd.obs.asString());
+
+                     // find the OT in the output header map, and delete it
+                  Rinex3ObsHeader::RinexObsVec::iterator kt;
+                  kt = find(jt->second.begin(), jt->second.end(), obsid);
+                  if(kt == jt->second.end())
+                     continue;
+                  jt->second.erase(kt);
+                     // flag the obs types have changed so the translations
+                     // need to as well
+                  mungeData = true;
+               }
+            }
+
+               // DS delete sat without sign and without time
+            else if(cmd.type == EditCmd::dsCT && cmd.sign >= 0
+                    && cmd.ttag == CommonTime::BEGINNING_OF_TIME)
+            {
+               if(cmd.sat.id == -1) {
+                     // Delete all satellites with this system
+                  Rinex3ObsHeader::PRNNumObsMap::iterator it,jt;
+                  for(it = outHead.numObsForSat.begin();
+                      it != outHead.numObsForSat.end(); )
+                  {
+                     jt = it++;
+                     if(jt->first.system == cmd.sat.system)
+                        outHead.numObsForSat.erase(jt);
+                  }
+                  if(cmd.sat.system == SatID::systemGlonass)
+                     outHead.glonassFreqNo.clear();
+
+                     // Remove obs types for that system
+                  outHead.mapObsTypes.erase(string(1,cmd.sat.systemChar()));
+               }
+               else {
+                     // Just delete a single satellite if its there
+                  outHead.numObsForSat.erase(cmd.sat);
+                  outHead.glonassFreqNo.erase(cmd.sat);
+               }
+            }
+         }  // end loop over edit commands
+
+            // if mapObsTypes has changed, make a map of indexes for
+            // translation: translate[sys][input index] = output index
+         translate.clear();
+         if(mungeData) {
+            Rinex3ObsHeader::RinexObsMap::const_iterator jt,ht;
+            for(jt = header.mapObsTypes.begin();
+                jt != header.mapObsTypes.end(); ++jt)
+            {
+               vector<int>& trans(translate[jt->first[0]]);
+               trans.assign(jt->second.size(), -1);
+               ht = outHead.mapObsTypes.find(jt->first);
+               if(ht == outHead.mapObsTypes.end())
+                  continue;               // entire system is deleted
+               for(i=0; i<jt->second.size(); i++) {
+                  Rinex3ObsHeader::RinexObsVec::const_iterator kt;
+                  kt = find(ht->second.begin(), ht->second.end(), jt->second[i]);
+                  if(kt != ht->second.end())
+                     trans[i] = int(kt - ht->second.begin());
+               }
+
+               if(ConfigureLOG::ReportingLevel() >= DEBUG) {
+                  ostringstream oss;
+                  oss << "Translation map for sys " << jt->first;
+                  for(i=0; i < trans.size(); i++)
+                     oss << " " << i << ":" << trans[i];
+                  LOG(DEBUG) << oss.str();
+               }
+            }
+         }
+
+         indexObsTypes();
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------
+   void Rinex3ObsEditor::indexObsTypes()
+   {
+      obsIndex.assign(cmds.size(), -1);
+      for(size_t k=0; k<cmds.size(); k++) {
+         if(!isObsCmd(cmds[k])) continue;
+         Rinex3ObsHeader::RinexObsMap::const_iterator ht;
+         ht = outHead.mapObsTypes.find(string(1,cmds[k].sat.systemChar()));
+         if(ht == outHead.mapObsTypes.end()) continue;
+         Rinex3ObsHeader::RinexObsVec::const_iterator ot;
+         ot = find(ht->second.begin(), ht->second.end(), cmds[k].obs);
+         if(ot != ht->second.end())
+            obsIndex[k] = int(ot - ht->second.begin());
+      }
+   }
+
+   //---------------------------------------------------------------------------
+   int Rinex3ObsEditor::edit(Rinex3ObsData& rod) throw(Exception)
+   {
+      try {
+         size_t i,j,k;
+         int iret;
+
+            // remove deleted obs types, in place
+         if(!translate.empty()) {
+            Rinex3ObsData::DataMap::iterator it;
+            for(it=rod.obs.begin(); it!=rod.obs.end(); ++it) {
+               map<char, vector<int> >::const_iterator tt;
+               tt = translate.find(it->first.systemChar());
+               if(tt == translate.end()) continue;
+               const vector<int>& trans(tt->second);
+               vector<RinexDatum>& data(it->second);
+               for(i=0,j=0; i<data.size(); i++) {
+                  if(i < trans.size() && trans[i] < 0) continue;
+                  if(j != i) data[j] = data[i];
+                  j++;
+               }
+               data.resize(j);
+            }
+         }
+
+            // commands do not apply to aux header data
+         if(rod.epochFlag > 1)
+            return 0;
+
+            // start the commands with ttag <= now; one-time and stop
+            // commands are done here, start commands are put in effect
+         const CommonTime& now(rod.time);
+         started.clear();
+         while(next < cmds.size() &&
+               (cmds[next].ttag <= now || ::fabs(cmds[next].ttag - now) < timeTol))
+         {
+            k = next++;
+            LOG(DEBUG) << "Execute vec cmd " << cmds[k].asString();
+            iret = execute(k, rod);
+            if(iret < 0) return iret;              // fatal error
+
+            if(iret > 0) {
+               active[k] = 1;
+               groupActive[group[k]].push_back(k);
+               started.push_back(k);
+            }
+               // a stop command ends the first of its group in effect
+            else if(cmds[k].sign == -1) {
+               deque<size_t>& grp(groupActive[group[k]]);
+               while(!grp.empty() && !active[grp.front()])
+                  grp.pop_front();
+               if(!grp.empty()) {
+                  active[grp.front()] = 0;
+                  grp.pop_front();
+               }
+            }
+         }
+
+            // apply the commands in effect, dropping those that are done
+         iret = 0;
+         for(i=0,j=0; i<current.size(); i++) {
+            k = current[i];
+            if(!active[k]) continue;
+            if(iret >= 0) {
+               LOG(DEBUG) << "Execute current cmd " << cmds[k].asString();
+               iret = execute(k, rod);
+               if(iret == 0) { active[k] = 0; continue; }
+            }
+            current[j++] = k;
+         }
+         current.resize(j);
+         if(iret < 0) return iret;
+
+         for(i=0; i<started.size(); i++)
+            if(active[started[i]])
+               current.push_back(started[i]);
+
+         return 0;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------
+   int Rinex3ObsEditor::execute(size_t k, Rinex3ObsData& rod) throw(Exception)
+   {
+      const EditCmd& cmd(cmds[k]);
+      Rinex3ObsData::DataMap::iterator it;
+
+         // OF output file -------------------------------------------------------
+      if(cmd.type == EditCmd::ofCT) {
+         if(ofHook && !ofHook(cmd, outHead, rod))
+            return -1;
+         return 0;
+      }
+
+         // DA delete all --------------------------------------------------------
+      else if(cmd.type == EditCmd::daCT) {
+         if(cmd.sign == -1)
+            return 0;                           // delete the (-) command
+         rod.numSVs = 0;                        // clear this data, keep the cmd
+         rod.obs.clear();
+         if(cmd.sign == 0) return 0;
+      }
+
+         // DO delete obs type ---------------------------------------------------
+         // This is handled by reset(), where the output header is created w/o
+         // the deleted obs type in it, and by edit(), which removes it from
+         // the data.
+      else if(cmd.type == EditCmd::doCT)
+         return 0;
+
+         // DS delete satellite --------------------------------------------------
+      else if(cmd.type == EditCmd::dsCT) {
+         if(cmd.sign == -1)
+            return 0;                           // delete the (-) command
+
+         LOG(DEBUG) << " Delete sat " << cmd.asString();
+         if(cmd.sat.id > 0) {
+               // Find a specific satellite
+            it = rod.obs.find(cmd.sat);
+            if(it != rod.obs.end())             // found the SV
+               rod.obs.erase(it);
+            else
+               LOG(DEBUG) << " Execute: sat " << cmd.sat << " not found in data";
+         }
+         else {
+               // Delete all with the specified system
+            for(it=rod.obs.begin(); it!=rod.obs.end(); ) {
+               if(it->first.system == cmd.sat.system)
+                  rod.obs.erase(it++);
+               else
+                  ++it;
+            }
+         }
+
+         rod.numSVs = rod.obs.size();
+
+         if(cmd.sign == 0)
+            return 0;                           // delete the one-time command
+      }
+
+         // ----------------------------------------------------------------------
+         // the rest require that we find satellite and obsid in rod.obs
+      else {
+         if(cmd.sign == -1) return 0;           // delete the (-) command
+
+         if(obsIndex[k] < 0) {                  // ObsID not found
+            LOG(DEBUG) << " Execute: obstype " << cmd.obs << " not found in header";
+            return 0;                           // delete the cmd
+         }
+         const size_t i(obsIndex[k]);           // index into vector
+
+            // find the sat
+         if(cmd.sat.id > 0) {
+            it = rod.obs.find(cmd.sat);
+            if(it == rod.obs.end()) {
+               LOG(DEBUG) << " Execute: sat " << cmd.sat << " not found in data";
+            }
+            else if(i < it->second.size())
+               editDatum(cmd, it->second[i], biasZero);
+         }
+         else {
+            for(it=rod.obs.begin(); it!=rod.obs.end(); ++it) {
+               if(it->first.system == cmd.sat.system && i < it->second.size())
+                  editDatum(cmd, it->second[i], biasZero);
+            }
+         }
+
+         if(cmd.sign == 0)
+            return 0;                           // delete the one-time command
+      }
+
+      return 1;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,294 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsEditor.hpp
+ * Apply time-tagged editing commands to RINEX observation data.
+ */
+
+#ifndef RINEX3OBSEDITOR_HPP
+#define RINEX3OBSEDITOR_HPP
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <iostream>
+#include <functional>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "RinexSatID.hpp"
+#include "RinexObsID.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class applies the editing commands of RinEdit (delete
+       * satellites, observation types or data, set or bias data, SSI and
+       * LLI, at single times or over spans of time) to RINEX observation
+       * data, one epoch at a time.
+       *
+       * The commands are given as strings, in the form of the RinEdit
+       * command line, e.g. "DS+","G17,1850,345600" or
+       * "--BD+ G17,L1C,1850,345600,12.3 # comment" as written by DiscFix.
+       * compile() sorts them on time and pairs each stop (-) command with
+       * a start (+) command; edit() then walks the sorted list with a
+       * cursor, so that each epoch only looks at the commands that start
+       * or stop at that epoch and those that are in effect, and edits the
+       * data in place.
+       *
+       * @code
+       *   Rinex3ObsEditor editor;
+       *   editor.addCommand("DO", "L2C");
+       *   editor.addCommand("DS+", "G17,1850,345600");
+       *   editor.addCommand("DS-", "G17,1850,346200");
+       *   editor.compile();
+       *
+       *   istrm >> ihead;
+       *   editor.reset(ihead);
+       *   ostrm << editor.getHeader();
+       *   while(istrm >> rod) {
+       *      editor.edit(rod);
+       *      ostrm << rod;
+       *   }
+       * @endcode
+       *
+       * Output file (OF) commands are passed to a hook, which is expected
+       * to open the file and write the header to it.
+       *
+       * This is the engine of the application RinEdit.
+       */
+   class Rinex3ObsEditor
+   {
+   public:
+
+         /// A single editing command.
+      class EditCmd
+      {
+      public:
+         enum CmdType
+         {
+            invalidCT=0,
+            ofCT,
+            daCT,
+            doCT,
+            dsCT,
+            ddCT,
+            sdCT,
+            ssCT,
+            slCT,
+            bdCT,
+            bsCT,
+            blCT,
+            bzCT,
+            countCT
+         };
+         CmdType type;     ///< the type of this command
+         RinexSatID sat;   ///< satellite
+         RinexObsID obs;   ///< observation type
+         CommonTime ttag;  ///< associated time tag
+         int sign;         ///< sign +1,0,-1 meaning start, one-time, stop
+         int idata;        ///< integer e.g. SSI or LLI
+         double data;      ///< data e.g. bias value
+         std::string field;   ///< OF file name
+
+            /// Default constructor, an invalid command.
+         EditCmd(void) : type(invalidCT) {}
+
+            /** Constructor from strings, i.e. parser e.g. "DA+","t" or
+             * "BDp","SV,OT,t,s"; the command is invalid if they do not
+             * parse. */
+         EditCmd(const std::string typestr, const std::string arg)
+            throw(Exception);
+
+            /// Parse a time "week,sow" or "y,m,d,h,m,s" from string.
+         static bool parseTime(const std::string arg, CommonTime& ttag)
+            throw();
+
+            /// is it valid?
+         bool isValid(void) const throw()
+         { return (type != invalidCT); }
+
+            /// dump, with optional message at front
+         std::string asString(std::string msg=std::string()) const
+            throw(Exception);
+
+      }; // end class EditCmd
+
+         /**
+          * Called by edit() for an OF command, with the command, the
+          * output header and the data of the epoch at which it applies.
+          * It should open the output file and write the header to it;
+          * it returns false if that failed.
+          */
+      typedef std::function<bool(const EditCmd&, Rinex3ObsHeader&,
+                                 const Rinex3ObsData&)> OutputFileHook;
+
+         /// Constructor.
+      Rinex3ObsEditor();
+
+         /// Sets the tolerance, in seconds, in comparing command times
+         /// with data times.
+      void setTimeTolerance(double tol)
+      { timeTol = tol; }
+
+         /// If true, BD commands are applied to zero (missing) data too.
+      void setBiasZero(bool bz)
+      { biasZero = bz; }
+
+         /// Sets the hook called for OF commands.
+      void setOutputFileHook(OutputFileHook hook)
+      { ofHook = hook; }
+
+         /// Adds a command, returns false (and ignores it) if it is invalid.
+      bool addCommand(const EditCmd& cmd);
+
+         /// Adds a command given as in the RinEdit command line, e.g.
+         /// "BD+","G17,L1C,1850,345600,12.3"; returns false if it is
+         /// invalid.
+      bool addCommand(const std::string& typestr, const std::string& arg)
+         throw(Exception)
+      { return addCommand(EditCmd(typestr, arg)); }
+
+         /**
+          * Adds a command given as a line of a RinEdit input file, e.g.
+          * "--BD+ G17,L1C,1850,345600,12.3 # comment" or "-DS+G17,1850,0".
+          * @return false if the line holds an invalid command; blank and
+          *   comment lines are ignored.
+          */
+      bool addCommandLine(const std::string& line) throw(Exception);
+
+         /**
+          * Adds the commands of the lines of a stream, using
+          * addCommandLine().
+          * @param is the stream to read.
+          * @param bad the lines with invalid commands are added to this.
+          * @return the number of commands added.
+          */
+      int addCommands(std::istream& is, std::vector<std::string>& bad)
+         throw(Exception);
+
+         /// Returns the commands; after compile() they are sorted on time.
+         /// If they are changed, compile() must be called again.
+      std::vector<EditCmd>& getCommands()
+      { return cmds; }
+
+         /**
+          * Sorts the commands on time, adds a start (+) command at the
+          * beginning of time for each stop (-) command without one,
+          * removes invalid commands, and builds the index used by edit().
+          * Must be called after commands are added or changed, and may be
+          * called again; it restarts the editing.
+          */
+      void compile() throw();
+
+         /**
+          * Starts a file with the given (input) header, and makes the
+          * output header from it, by removing observation types deleted
+          * by DO commands and satellites deleted by DS commands without
+          * time. The commands in effect stay in effect.
+          */
+      void reset(const Rinex3ObsHeader& header) throw(Exception);
+
+         /// Returns the output header. Its observation types must not be
+         /// changed after reset().
+      Rinex3ObsHeader& getHeader()
+      { return outHead; }
+
+         /**
+          * Edits a data record in place: observation types deleted from
+          * the header are removed, then the commands that start, stop or
+          * are in effect at the record's epoch are applied. Commands are
+          * not applied to auxiliary header records (epoch flag > 1).
+          * @return 0, or -1 if the output file hook failed.
+          */
+      int edit(Rinex3ObsData& rod) throw(Exception);
+
+   private:
+
+         /// Executes command k on rod; returns >0 to keep it in effect,
+         /// 0 if it is done and <0 for a fatal error.
+      int execute(size_t k, Rinex3ObsData& rod) throw(Exception);
+
+         /// Finds the obs types of the commands in the output header.
+      void indexObsTypes();
+
+         // configuration
+      double timeTol;
+      bool biasZero;
+      OutputFileHook ofHook;
+
+         // the commands, sorted on time after compile()
+      std::vector<EditCmd> cmds;
+         /// Per command, the index of its (type,sat,obs) group.
+      std::vector<int> group;
+         /// Per command, the index of its obs type in the output header,
+         /// -1 if it is not there.
+      std::vector<int> obsIndex;
+
+         // state of the editing
+         /// Index of the next command to start.
+      size_t next;
+         /// Commands in effect, in the order they started.
+      std::vector<size_t> current;
+         /// Per command, true while it is in effect.
+      std::vector<char> active;
+         /// Per group, the start commands in effect, in the order they
+         /// started; stop commands end the first of them.
+      std::vector<std::deque<size_t> > groupActive;
+         /// Commands started by the epoch being edited.
+      std::vector<size_t> started;
+
+         // from the header
+      Rinex3ObsHeader outHead;
+         /// Per system, the output index of each input obs type (-1 if
+         /// deleted); empty if no obs type is deleted.
+      std::map<char, std::vector<int> > translate;
+
+   }; // end class Rinex3ObsEditor
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSEDITOR_HPP
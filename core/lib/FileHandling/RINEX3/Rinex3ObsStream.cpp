@@ -53,7 +53,7 @@ namespace gpstk
    Rinex3ObsStream ::
    Rinex3ObsStream( const char* fn,
                     std::ios::openmode mode )
-         : FFTextStream(fn, mode)
+         : CompactRinexStream(fn, mode)
    {
       init();
    }
@@ -62,7 +62,7 @@ namespace gpstk
    Rinex3ObsStream ::
    Rinex3ObsStream( const std::string fn,
                     std::ios::openmode mode )
-         : FFTextStream(fn.c_str(), mode)
+         : CompactRinexStream(fn.c_str(), mode)
    {
       init();
    }
@@ -78,7 +78,7 @@ namespace gpstk
    open( const char* fn,
          std::ios::openmode mode )
    {
-      FFTextStream::open(fn, mode);
+      CompactRinexStream::open(fn, mode);
    }
 
 
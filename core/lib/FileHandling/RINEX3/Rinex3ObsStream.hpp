@@ -47,8 +47,8 @@
 #include <map>
 #include <string>
 
-#include "FFTextStream.hpp"
 #include "Rinex3ObsHeader.hpp"
+#include "CompactRinexStream.hpp"
 
 namespace gpstk
 {
@@ -58,9 +58,13 @@ namespace gpstk
       /**
        * This class reads RINEX 3 Obs files.
        *
+       * Compact RINEX (Hatanaka compressed) files are read as well: they
+       * are recognized by their first line and decoded on the fly. Call
+       * setCompactOutput() to write one. See CompactRinexStream.
+       *
        * @sa Rinex3ObsData and Rinex3ObsHeader.
        */
-   class Rinex3ObsStream : public FFTextStream
+   class Rinex3ObsStream : public CompactRinexStream
    {
    public:
          /// Default constructor
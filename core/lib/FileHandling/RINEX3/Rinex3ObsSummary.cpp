@@ -0,0 +1,508 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/** @file Rinex3ObsSummary.cpp
+ * Single-pass summary of the content of a RINEX observation file.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cmath>
+
+#include "SPSCQueue.hpp"
+#include "Rinex3ObsSummary.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   Rinex3ObsSummary::Rinex3ObsSummary()
+         : beginTime(CommonTime::BEGINNING_OF_TIME),
+           endTime(CommonTime::END_OF_TIME),
+           nominalDT(-1.0)
+   {
+      beginTime.setTimeSystem(TimeSystem::Any);
+      endTime.setTimeSystem(TimeSystem::Any);
+      reset(Rinex3ObsHeader());
+   }
+
+
+   bool Rinex3ObsSummary::isSelected(const RinexSatID& sat) const
+   {
+      RinexSatID sys(-1,sat.system);
+      if(onlySats.size() > 0
+         && find(onlySats.begin(), onlySats.end(), sat) == onlySats.end()
+         && find(onlySats.begin(), onlySats.end(), sys) == onlySats.end())
+         return false;
+      if(find(exSats.begin(), exSats.end(), sat) != exSats.end())
+         return false;
+      if(find(exSats.begin(), exSats.end(), sys) != exSats.end())
+         return false;
+      return true;
+   }
+
+
+   void Rinex3ObsSummary::reset(const Rinex3ObsHeader& header)
+   {
+      numObsTypes.clear();
+      totals.clear();
+      map<string, vector<RinexObsID> >::const_iterator sit;
+      for(sit = header.mapObsTypes.begin();
+          sit != header.mapObsTypes.end(); ++sit)
+      {
+         if(sit->first.empty())
+            continue;
+         numObsTypes[sit->first[0]] = sit->second.size();
+         totals[sit->first[0]] = vector<int>(sit->second.size());
+      }
+
+      timeSystem = header.firstObs.getTimeSystem();
+      nepochs = nauxheaders = 0;
+      haveFirst = havePrevious = inOutOfOrder = false;
+      firstTime = lastTime = prevTime = CommonTime::BEGINNING_OF_TIME;
+      epochGaps.clear();
+      outOfOrder.clear();
+      for(size_t i=0; i<ndtmax; i++)
+      {
+         ndt[i] = -1;
+         bestdt[i] = 0.0;
+      }
+
+      sats.clear();
+      satTotals.clear();
+      satLookup.clear();
+
+      readError.clear();
+   }
+
+
+   size_t Rinex3ObsSummary::satIndex(const RinexSatID& sat)
+   {
+         // a table by system and id, so that there is no search
+      size_t sys(static_cast<size_t>(sat.system)), id(sat.id > 0 ? sat.id : 0);
+      if(sys >= satLookup.size())
+         satLookup.resize(sys+1);
+      vector<int>& ids(satLookup[sys]);
+      if(id >= ids.size())
+         ids.resize(id+1, -1);
+      if(ids[id] >= 0)
+         return ids[id];
+
+      ids[id] = sats.size();
+      sats.push_back(SatSummary());
+      sats.back().sat = sat;
+      char sysChar(sat.systemChar());
+      map<char, size_t>::const_iterator nit(numObsTypes.find(sysChar));
+      sats.back().obs.resize(nit == numObsTypes.end() ? 0 : nit->second);
+      satTotals.push_back(&totals[sysChar]);
+      return ids[id];
+   }
+
+
+   Rinex3ObsSummary::RecordStatus Rinex3ObsSummary::add(
+      const Rinex3ObsData& rod)
+   {
+         // stay within time limits
+      if(rod.time < beginTime)
+         return BeforeBegin;
+      if(rod.time > endTime)
+         return AfterEnd;
+
+         // the time system of the data wins over the one of the header
+      if(nepochs == 0 && rod.time.getTimeSystem() != timeSystem)
+         timeSystem = rod.time.getTimeSystem();
+      lastTime = rod.time;
+      lastTime.setTimeSystem(timeSystem);
+      firstTime.setTimeSystem(timeSystem);
+      prevTime.setTimeSystem(timeSystem);
+      if(!haveFirst)
+      {
+         firstTime = lastTime;
+         haveFirst = true;
+      }
+
+         // auxiliary header data is only counted
+      if(rod.epochFlag > 1)
+      {
+         nauxheaders++;
+         return Auxiliary;
+      }
+
+      nepochs++;
+
+         // records out of time order are only counted
+         // use < 1.e-3 not < 0 b/c inline header info (epochFlag > 1) excluded
+      if(havePrevious && lastTime-prevTime < 1.e-3)
+      {
+         if(!inOutOfOrder)
+         {
+            OutOfOrderBlock block;
+            block.after = prevTime;
+            block.first = rod.time;
+            block.count = 0;
+            outOfOrder.push_back(block);
+            inOutOfOrder = true;
+         }
+         outOfOrder.back().last = rod.time;
+         outOfOrder.back().count++;
+         return OutOfOrder;
+      }
+      inOutOfOrder = false;
+
+         // look for gaps in the timetags
+      int ncount(0);
+      if(nominalDT > 0.0)
+      {
+         ncount = int(0.5+(lastTime-firstTime)/nominalDT);
+         if(epochGaps.empty())
+         {
+            epochGaps.push_back(ncount);      // start
+            epochGaps.push_back(ncount-1);    // end
+         }
+         if(ncount == epochGaps.back() + 1)   // no gap
+            epochGaps.back() = ncount;
+         else
+         {
+            epochGaps.push_back(ncount);      // start
+            epochGaps.push_back(ncount);      // end
+         }
+      }
+
+         // loop over satellites
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it = rod.obs.begin(); it != rod.obs.end(); ++it)
+      {
+         const RinexSatID& sat(it->first);
+
+            // the lookup table also remembers unselected satellites
+         size_t sys(static_cast<size_t>(sat.system)), id(sat.id > 0 ? sat.id : 0);
+         if(sys < satLookup.size() && id < satLookup[sys].size()
+            && satLookup[sys][id] == -2)
+            continue;
+         if(!isSelected(sat))
+         {
+            if(sys >= satLookup.size())
+               satLookup.resize(sys+1);
+            if(id >= satLookup[sys].size())
+               satLookup[sys].resize(id+1, -1);
+            satLookup[sys][id] = -2;
+            continue;
+         }
+
+         size_t nsats(sats.size()), isat(satIndex(sat));
+         SatSummary& ss(sats[isat]);
+         vector<int>& tot(*satTotals[isat]);
+         if(sats.size() > nsats)
+         {
+               // first epoch of this satellite
+            ss.begin = lastTime;
+            if(nominalDT > 0.0)
+            {
+               ss.gaps.push_back(ncount);     // start
+               ss.gaps.push_back(ncount-1);   // end
+            }
+         }
+
+            // update list of gaps
+         if(nominalDT > 0.0)
+         {
+            if(ncount == ss.gaps.back() + 1)  // no gap
+               ss.gaps.back() = ncount;
+            else
+            {
+               ss.gaps.push_back(ncount);     // start
+               ss.gaps.push_back(ncount);     // end
+            }
+         }
+         ss.end = lastTime;
+
+            // update the counts and statistics of non-zero data
+         const vector<RinexDatum>& vecData(it->second);
+         if(vecData.size() > ss.obs.size())
+            ss.obs.resize(vecData.size());
+         if(vecData.size() > tot.size())
+            tot.resize(vecData.size());
+         for(size_t i=0; i<vecData.size(); i++)
+         {
+            if(vecData[i].data == 0)
+               continue;
+            ObsTypeSummary& ots(ss.obs[i]);
+            if(ots.count == 0)
+               ots.first = lastTime;
+            ots.last = lastTime;
+            ots.count++;
+            ots.stats.Add(vecData[i].data);
+            tot[i]++;
+         }
+      }
+
+         // estimate the time step
+      if(havePrevious)
+      {
+         double dt(lastTime-prevTime);
+         for(size_t i=0; i<ndtmax; i++)
+         {
+            if(ndt[i] <= 0)
+            {
+               bestdt[i] = dt;
+               ndt[i] = 1;
+               break;
+            }
+            if(fabs(dt-bestdt[i]) < 0.0001)
+            {
+               ndt[i]++;
+               break;
+            }
+            if(i == ndtmax-1)
+            {
+                  // replace the least frequent
+               size_t k(0);
+               int nleast(ndt[k]);
+               for(size_t j=1; j<ndtmax; j++)
+               {
+                  if(ndt[j] <= nleast)
+                  {
+                     k = j;
+                     nleast = ndt[j];
+                  }
+               }
+               ndt[k] = 1;
+               bestdt[k] = dt;
+            }
+         }
+      }
+      prevTime = lastTime;
+      havePrevious = true;
+
+      return Accepted;
+   }
+
+
+   double Rinex3ObsSummary::getInterval() const
+   {
+      size_t j(0);
+      for(size_t i=1; i<ndtmax; i++)
+         if(ndt[i] > ndt[j])
+            j = i;
+      return bestdt[j];
+   }
+
+
+   bool Rinex3ObsSummary::read(Rinex3ObsStream& strm, bool pipelined,
+                               RecordHook hook)
+      throw(Exception)
+   {
+      readError.clear();
+      if(pipelined)
+         return readPipelined(strm, hook);
+      return readSerial(strm, hook);
+   }
+
+
+   bool Rinex3ObsSummary::readSerial(Rinex3ObsStream& strm, RecordHook& hook)
+      throw(Exception)
+   {
+      Rinex3ObsData rod;
+      while(1)
+      {
+         try
+         {
+            strm >> rod;
+         }
+         catch(Exception& e)
+         {
+            readError = e.getText(0);
+            failedRecord = rod;
+            return false;
+         }
+         catch(std::exception& e)
+         {
+            Exception ge(string("Std excep: ") + e.what());
+            GPSTK_THROW(ge);
+         }
+         catch(...)
+         {
+            Exception ue("Unknown exception while reading RINEX data.");
+            GPSTK_THROW(ue);
+         }
+
+            // normal EOF
+         if(!strm.good() || strm.eof())
+            return true;
+
+         RecordStatus status(add(rod));
+         if(hook)
+            hook(rod, status);
+         if(status == AfterEnd)
+            return true;
+      }
+   }
+
+
+   bool Rinex3ObsSummary::readPipelined(Rinex3ObsStream& strm,
+                                        RecordHook& hook)
+      throw(Exception)
+   {
+         // Records are read into a ring of slots, so that they are not
+         // copied; the reader takes free slots from one queue and passes
+         // them, filled, through the other one, followed by 'endOfData'.
+      static const size_t nslots = 64;
+      static const size_t endOfData = static_cast<size_t>(-1);
+      vector<Rinex3ObsData> slots(nslots);
+      SPSCQueue<size_t> freeSlots(nslots), fullSlots(nslots+1);
+      for(size_t i=0; i<nslots; i++)
+         freeSlots.push(i);
+
+      atomic<bool> stop(false);
+      enum { ReadOK, ReadFailed, StdException, UnknownException };
+      int readStatus(ReadOK);
+      size_t failedSlot(0);
+      string message;
+
+      thread reader;
+      try
+      {
+         reader = thread([&]()
+         {
+            SPSCBackoff backoff;
+            size_t i;
+            while(!stop)
+            {
+               if(!freeSlots.pop(i))
+               {
+                  backoff.pause();
+                  continue;
+               }
+               backoff.reset();
+               try
+               {
+                  strm >> slots[i];
+               }
+               catch(Exception& e)
+               {
+                  message = e.getText(0);
+                  failedSlot = i;
+                  readStatus = ReadFailed;
+                  break;
+               }
+               catch(std::exception& e)
+               {
+                  message = string("Std excep: ") + e.what();
+                  readStatus = StdException;
+                  break;
+               }
+               catch(...)
+               {
+                  readStatus = UnknownException;
+                  break;
+               }
+               if(!strm.good() || strm.eof())
+                  break;
+               fullSlots.push(i);
+            }
+            fullSlots.push(endOfData);
+         });
+      }
+      catch(std::exception&)
+      {
+         return readSerial(strm, hook);
+      }
+
+      SPSCBackoff backoff;
+      size_t i;
+      bool stopped(false);
+      try
+      {
+         while(1)
+         {
+            if(!fullSlots.pop(i))
+            {
+               backoff.pause();
+               continue;
+            }
+            backoff.reset();
+            if(i == endOfData)
+               break;
+            if(!stopped)
+            {
+               RecordStatus status(add(slots[i]));
+               if(hook)
+                  hook(slots[i], status);
+               if(status == AfterEnd)
+               {
+                     // let the reader finish, ignoring the rest
+                  stopped = true;
+                  stop = true;
+               }
+            }
+            freeSlots.push(i);
+         }
+      }
+      catch(...)
+      {
+         stop = true;
+         do
+         {
+            while(!fullSlots.pop(i))
+               backoff.pause();
+            if(i != endOfData)
+               freeSlots.push(i);
+         } while(i != endOfData);
+         reader.join();
+         throw;
+      }
+      reader.join();
+
+         // errors after the end time are not seen by the serial reader
+      if(stopped || readStatus == ReadOK)
+         return true;
+      if(readStatus == ReadFailed)
+      {
+         readError = message;
+         failedRecord = slots[failedSlot];
+         return false;
+      }
+      if(readStatus == StdException)
+      {
+         Exception ge(message);
+         GPSTK_THROW(ge);
+      }
+      Exception ue("Unknown exception while reading RINEX data.");
+      GPSTK_THROW(ue);
+   }
+
+} // namespace gpstk
@@ -0,0 +1,305 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsSummary.hpp
+ * Single-pass summary of the content of a RINEX observation file.
+ */
+
+#ifndef RINEX3OBSSUMMARY_HPP
+#define RINEX3OBSSUMMARY_HPP
+
+#include <vector>
+#include <map>
+#include <string>
+#include <functional>
+
+#include "CommonTime.hpp"
+#include "RinexSatID.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Stats.hpp"
+
+namespace gpstk
+{
+
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class accumulates a summary of the content of a RINEX
+       * observation file in a single pass over the data: the number of
+       * epochs, the interval, the gaps, and for each satellite and
+       * observation type the number of (non-zero) data, their first and
+       * last epochs and their statistics. The storage is fixed per
+       * satellite and observation type (the data records are not kept),
+       * so files of any length can be summarized in constant memory,
+       * except for one entry per gap.
+       *
+       * @code
+       *   Rinex3ObsStream strm(filename.c_str());
+       *   Rinex3ObsHeader head;
+       *   strm >> head;
+       *
+       *   Rinex3ObsSummary summary;
+       *   summary.setInterval(30.0);          // only needed for gaps
+       *   summary.reset(head);
+       *   if(!summary.read(strm, true))
+       *      cerr << summary.getReadError() << endl;
+       *
+       *   cout << summary.getEpochCount() << " epochs, interval "
+       *        << summary.getInterval() << endl;
+       * @endcode
+       *
+       * read() can parse the file on a separate thread, while the
+       * summary is accumulated on the calling thread. Records may also
+       * be given one at a time to add().
+       *
+       * This is the engine of the application RinSum.
+       */
+   class Rinex3ObsSummary
+   {
+   public:
+
+         /// What add() did with a data record.
+      enum RecordStatus
+      {
+         BeforeBegin,   ///< before the begin time, ignored
+         AfterEnd,      ///< after the end time, ignored; reading stops
+         Auxiliary,     ///< auxiliary header (epoch flag > 1), counted
+         OutOfOrder,    ///< not after the previous epoch, counted
+         Accepted       ///< added to the summary
+      };
+
+         /// Called by read() after each record is given to add(),
+         /// on the thread that called read().
+      typedef std::function<void(const Rinex3ObsData&, RecordStatus)>
+         RecordHook;
+
+         /// Summary of one observation type of one satellite.
+      struct ObsTypeSummary
+      {
+         ObsTypeSummary() : count(0) {}
+
+         int count;                 ///< number of non-zero data
+         CommonTime first;          ///< epoch of the first of them
+         CommonTime last;           ///< epoch of the last of them
+         SeqStats<double> stats;    ///< statistics of their values
+      };
+
+         /// Summary of one satellite.
+      struct SatSummary
+      {
+         RinexSatID sat;
+         CommonTime begin;          ///< first epoch with this satellite
+         CommonTime end;            ///< last epoch with this satellite
+
+            /// Pairs of (begin,end) counts of the spans of consecutive
+            /// epochs with this satellite, counts being the number of
+            /// intervals from the first epoch of the file; empty unless
+            /// setInterval() was called.
+         std::vector<int> gaps;
+
+            /// Summaries for each observation type of the satellite
+            /// system, in the order of the header.
+         std::vector<ObsTypeSummary> obs;
+
+            /// Number of non-zero data for each observation type.
+         int count(size_t i) const
+         { return (i < obs.size() ? obs[i].count : 0); }
+      };
+
+         /// A block of consecutive records that are out of time order.
+      struct OutOfOrderBlock
+      {
+         CommonTime after;          ///< epoch preceding the block
+         CommonTime first;          ///< epoch of the first record
+         CommonTime last;           ///< epoch of the last record
+         int count;                 ///< number of records
+      };
+
+         /// Constructor.
+      Rinex3ObsSummary();
+
+         /// Sets the time limits of the data to be summarized.
+      void setTimeLimits(const CommonTime& begin, const CommonTime& end)
+      { beginTime = begin; endTime = end; }
+
+         /// Sets the nominal interval of the data, in seconds, needed to
+         /// find gaps; zero or negative (the default) means no gaps.
+      void setInterval(double dt)
+      { nominalDT = dt; }
+
+         /// Restricts the summary to some satellites. A satellite is
+         /// included if it or its system (id -1) is in 'only' or 'only'
+         /// is empty, and neither it nor its system is in 'excluded'.
+      void setSatellites(const std::vector<RinexSatID>& only,
+                         const std::vector<RinexSatID>& excluded)
+      { onlySats = only; exSats = excluded; }
+
+         /// Returns true if sat is included in the summary.
+      bool isSelected(const RinexSatID& sat) const;
+
+         /// Clears the summary and starts a new one, for data with the
+         /// given header.
+      void reset(const Rinex3ObsHeader& header);
+
+         /// Adds a data record to the summary.
+      RecordStatus add(const Rinex3ObsData& rod);
+
+         /**
+          * Reads the data records of strm, whose header has been read and
+          * given to reset(), and adds them to the summary, until the end
+          * of the file or of the time limits.
+          * @param strm the stream to read from.
+          * @param pipelined if true, the records are read on a separate
+          *   thread while they are added on this one.
+          * @param hook if set, called after each record is added.
+          * @return true if the data was read, false if reading failed;
+          *   then getReadError() and getFailedRecord() say why.
+          * @throw Exception if the stream throws anything other than a
+          *   gpstk::Exception, or hook throws.
+          */
+      bool read(Rinex3ObsStream& strm, bool pipelined = false,
+                RecordHook hook = RecordHook())
+         throw(Exception);
+
+         /// Returns the message of the error that stopped read().
+      const std::string& getReadError() const
+      { return readError; }
+
+         /// Returns the record that read() failed to read, as far as it
+         /// was read.
+      const Rinex3ObsData& getFailedRecord() const
+      { return failedRecord; }
+
+         /// Returns the number of epochs, with auxiliary headers excluded
+         /// and out of order records included.
+      int getEpochCount() const
+      { return nepochs; }
+
+         /// Returns the number of auxiliary header blocks.
+      int getAuxHeaderCount() const
+      { return nauxheaders; }
+
+         /// Returns the epoch of the first record within the time limits.
+      const CommonTime& getFirstEpoch() const
+      { return firstTime; }
+
+         /// Returns the epoch of the last record within the time limits.
+      const CommonTime& getLastEpoch() const
+      { return lastTime; }
+
+         /// Returns the time system of the data, which is the one of the
+         /// header unless the first epoch says otherwise.
+      TimeSystem getTimeSystem() const
+      { return timeSystem; }
+
+         /// Returns the most frequent interval between epochs, in seconds.
+      double getInterval() const;
+
+         /// Returns pairs of (begin,end) counts of the spans of
+         /// consecutive epochs, as SatSummary::gaps does for satellites.
+      const std::vector<int>& getEpochGaps() const
+      { return epochGaps; }
+
+         /// Returns the satellites, in the order they were first seen.
+      const std::vector<SatSummary>& getSatellites() const
+      { return sats; }
+
+         /// Returns the number of non-zero data for each system, by
+         /// system character, for each observation type.
+      const std::map<char, std::vector<int> >& getTotals() const
+      { return totals; }
+
+         /// Returns the blocks of records that are out of time order.
+      const std::vector<OutOfOrderBlock>& getOutOfOrder() const
+      { return outOfOrder; }
+
+   private:
+
+         /// Returns the index in sats of sat, adding it if needed.
+      size_t satIndex(const RinexSatID& sat);
+
+         /// Reads the records of strm, on this thread.
+      bool readSerial(Rinex3ObsStream& strm, RecordHook& hook)
+         throw(Exception);
+
+         /// Reads the records of strm on another thread.
+      bool readPipelined(Rinex3ObsStream& strm, RecordHook& hook)
+         throw(Exception);
+
+         // configuration
+      CommonTime beginTime, endTime;
+      double nominalDT;
+      std::vector<RinexSatID> onlySats, exSats;
+
+         // from the header
+      std::map<char, size_t> numObsTypes;
+
+         // summary of the epochs
+      TimeSystem timeSystem;
+      int nepochs, nauxheaders;
+      bool haveFirst, havePrevious, inOutOfOrder;
+      CommonTime firstTime, lastTime, prevTime;
+      std::vector<int> epochGaps;
+      std::vector<OutOfOrderBlock> outOfOrder;
+
+         /// Candidate intervals and the number of times they were seen.
+      static const size_t ndtmax = 15;
+      double bestdt[ndtmax];
+      int ndt[ndtmax];
+
+         // summary of the satellites
+      std::vector<SatSummary> sats;
+         /// Per satellite, the totals entry of its system.
+      std::vector<std::vector<int>*> satTotals;
+         /// Index in sats, by system and id, -1 if not there yet.
+      std::vector<std::vector<int> > satLookup;
+      std::map<char, std::vector<int> > totals;
+
+         // results of read()
+      std::string readError;
+      Rinex3ObsData failedRecord;
+
+   }; // end class Rinex3ObsSummary
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSSUMMARY_HPP
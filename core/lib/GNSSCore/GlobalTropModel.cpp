@@ -323,10 +323,22 @@ namespace gpstk
       throw(InvalidTropModel)
    {
       try {
+         // set the whole position, then update the coefficients once
          double p;
-         p = RX.getAltitude();         if(p != height) setReceiverHeight(p);
-         p = RX.getGeodeticLatitude(); if(p != latitude) setReceiverLatitude(p);
-         p = RX.getLongitude();        if(p != longitude) setReceiverLongitude(p);
+         bool changed(false);
+         p = RX.getAltitude();
+         if(!validHeight || p != height)
+            { height = p; validHeight = changed = true; }
+         p = RX.getGeodeticLatitude();
+         if(!validLat || p != latitude)
+            { latitude = p; validLat = changed = true; }
+         p = RX.getLongitude();
+         if(!validLon || p != longitude)
+            { longitude = p; validLon = changed = true; }
+         if(changed) {
+            validCoeff = false;
+            setValid();       // calls updateGTMCoeff()
+         }
       }
       catch(GeometryException& e) {
          validHeight = validLat = valid = false;
@@ -346,6 +358,39 @@ namespace gpstk
 
    }  // end GlobalTropModel::correction(RX,SV)
 
+   // Compute the full tropospheric delays and the mapping functions for
+   // several satellites, with the zenith delays computed once.
+   // @param elevations Elevations of the satellites as seen at receiver, in degrees
+   // @param delays     Output full tropospheric delays (m)
+   // @param dryMaps    Output hydrostatic (dry) mapping functions
+   // @param wetMaps    Output wet mapping functions
+   void GlobalTropModel::corrections(const std::vector<double>& elevations,
+                                     std::vector<double>& delays,
+                                     std::vector<double>& dryMaps,
+                                     std::vector<double>& wetMaps) const
+      throw(InvalidTropModel)
+   {
+      try { testValidity(); }
+      catch(InvalidTropModel& e) { GPSTK_RETHROW(e); }
+
+      const double zdry(GlobalTropModel::dry_zenith_delay());
+      const double zwet(GlobalTropModel::wet_zenith_delay());
+
+      const size_t n(elevations.size());
+      delays.resize(n);
+      dryMaps.resize(n);
+      wetMaps.resize(n);
+      for(size_t i=0; i<n; i++) {
+         dryMaps[i] = GlobalTropModel::dry_mapping_function(elevations[i]);
+         wetMaps[i] = GlobalTropModel::wet_mapping_function(elevations[i]);
+
+         // as correction(elevation): good down to 3 degrees
+         delays[i] = (elevations[i] < 3.0 ? 0.0
+                                          : (zdry * dryMaps[i]) + (zwet * wetMaps[i]));
+      }
+
+   }  // end GlobalTropModel::corrections(elevations)
+
    // Compute and return the zenith delay for hydrostatic (dry) component of
    // the troposphere. Use the Saastamoinen value.
    // Ref. Davis etal 1985 and Leick, 3rd ed, pg 197.
@@ -376,29 +421,9 @@ namespace gpstk
       try { testValidity(); } catch(InvalidTropModel& e) { GPSTK_RETHROW(e); }
       if(elevation < 3.0) { return 0.0; }
 
-      double clat = ::cos(latitude*DEG_TO_RAD);
-      double phh, c11h, c10h;
-
+      // ah and ch from updateGTMCoeff()
       static const double bh = 0.0029;
-      static const double c0h = 0.062;
-      if(latitude < 0) {
-         phh = PI;
-         c11h = 0.007;
-         c10h = 0.002;
-      }
-      else {
-         phh = 0.0;
-         c11h = 0.005;
-         c10h = 0.001;
-      }
-      double ch = c0h + ((::cos(dayfactor + phh)+1.0)*c11h/2.0 + c10h)*(1.0-clat);
-
-      double am(0.0), aa(0.0);
-      for(int i=0; i<55; i++) {
-         am += (ADryMean[i]*aP[i] + BDryMean[i]*bP[i]) * 1.0e-5;
-         aa += (ADryAmp[i]*aP[i] + BDryAmp[i]*bP[i]) * 1.0e-5;
-      }
-      double ah = am + aa*::cos(dayfactor);
+      const double ah(ahDry), ch(chDry);
 
       double sine = ::sin(elevation*DEG_TO_RAD);
       //std::cout << "sine " << std::fixed << std::setprecision(16) << sine
@@ -468,15 +493,10 @@ namespace gpstk
 
       if(elevation < 3.0) { return 0.0; }
 
+      // aw from updateGTMCoeff()
       static const double bw = 0.00146;
       static const double cw = 0.04391;
-
-      double am(0.0), aa(0.0);
-      for(int i=0; i<55; i++) {
-         am += (AWetMean[i]*aP[i] + BWetMean[i]*bP[i]) * 1.0e-5;
-         aa += (AWetAmp[i]*aP[i] + BWetAmp[i]*bP[i]) * 1.0e-5;
-      }
-      double aw = am + aa*::cos(dayfactor);
+      const double aw(awWet);
 
       double sine = ::sin(elevation*DEG_TO_RAD);
       //std::cout << "sine " << std::fixed << std::setprecision(16) << sine
@@ -548,7 +568,7 @@ namespace gpstk
    // @param ht   Height of the receiver above mean sea level, in meters.
    void GlobalTropModel::setReceiverHeight(const double& ht)
    {
-      if(height != ht) {
+      if(!validHeight || height != ht) {
          height = ht; 
          validHeight = true;
          validCoeff = false;
@@ -561,7 +581,7 @@ namespace gpstk
    // @param lat  Latitude of receiver, in degrees.
    void GlobalTropModel::setReceiverLatitude(const double& lat)
    {
-      if(latitude != lat) {
+      if(!validLat || latitude != lat) {
          latitude = lat;
          validLat = true;
          validCoeff = false;
@@ -574,7 +594,7 @@ namespace gpstk
    // @param lat  Longitude of receiver, in degrees East.
    void GlobalTropModel::setReceiverLongitude(const double& lon)
    {
-      if(longitude != lon) {
+      if(!validLon || longitude != lon) {
          longitude = lon;
          validLon = true;
          validCoeff = false;
@@ -588,7 +608,7 @@ namespace gpstk
    void GlobalTropModel::setTime(const double& mjd)
    {
       double df(TWO_PI*(mjd - 44266.0)/365.25);       // -44239 + 1 - 28
-      if(df != dayfactor) {
+      if(!validDay || df != dayfactor) {
          dayfactor = df;
          validDay = true;
          validCoeff = false;
@@ -662,6 +682,37 @@ namespace gpstk
          }
       }
 
+      // coefficients of the mapping functions, which are the same for all
+      // elevations; those that depend on time are valid only when validDay
+      double am(0.0), aa(0.0);
+      for(i=0; i<55; i++) {
+         am += (ADryMean[i]*aP[i] + BDryMean[i]*bP[i]) * 1.0e-5;
+         aa += (ADryAmp[i]*aP[i] + BDryAmp[i]*bP[i]) * 1.0e-5;
+      }
+      ahDry = am + aa*::cos(dayfactor);
+
+      double clat = ::cos(latitude*DEG_TO_RAD);
+      double phh, c11h, c10h;
+      static const double c0h = 0.062;
+      if(latitude < 0) {
+         phh = PI;
+         c11h = 0.007;
+         c10h = 0.002;
+      }
+      else {
+         phh = 0.0;
+         c11h = 0.005;
+         c10h = 0.001;
+      }
+      chDry = c0h + ((::cos(dayfactor + phh)+1.0)*c11h/2.0 + c10h)*(1.0-clat);
+
+      am = aa = 0.0;
+      for(i=0; i<55; i++) {
+         am += (AWetMean[i]*aP[i] + BWetMean[i]*bP[i]) * 1.0e-5;
+         aa += (AWetAmp[i]*aP[i] + BWetAmp[i]*bP[i]) * 1.0e-5;
+      }
+      awWet = am + aa*::cos(dayfactor);
+
    }
 
    // Utility to test valid flags
@@ -76,10 +76,11 @@ namespace gpstk
    ///    humidity%  ---> humid
    ///
    ///    [in getGPT():]  height,coeffs,dayfactor -> P,T
+   ///    [in updateGTMCoeff():] coeffs,dayfactor,lat -> map coeffs
    ///                    humid,T -----------------------> wet_zenith_delay()
    ///                    P,T,lat -----------------------> dry_zenith_delay()
-   ///                    dayfactor,coeffs --------------> wet_mapping_function(elev)
-   ///                    dayfactor,coeffs --------------> dry_mapping_function(elev)
+   ///                    map coeffs --------------------> wet_mapping_function(elev)
+   ///                    map coeffs,ht -----------------> dry_mapping_function(elev)
    /// So, change lat   => coeffs => P,T => wet/dry zen/map
    ///            lon   => coeffs => P,T => wet/dry zen/map
    ///            ht    => coeffs => P,T => wet/dry zen/map
@@ -89,6 +90,7 @@ namespace gpstk
    /// NB. members of base TropModel::temp,press,humid; valid
    ///     members of GlobalTropModel::height,latitude,longitude,dayfactor,undul;
    ///                                  validHeight, validLat, validLon, validDay
+   /// A new position given to correction(RX,SV,tt) updates the coeffs once.
    ///
    /// @warning The Global mapping functions are defined for elevation
    /// angles down to 3 degrees, below that the correction is set to zero.
@@ -115,6 +117,7 @@ namespace gpstk
                       const double& mjd)
       {
          validCoeff = validHeight = validLat = validLon = validDay = valid = false;
+         TropModel::humid = 50.0;
          setReceiverHeight(ht);
          setReceiverLatitude(lat);
          setReceiverLongitude(lon);
@@ -128,6 +131,7 @@ namespace gpstk
       GlobalTropModel(const Position& RX, const CommonTime& time)
       {
          validCoeff = validHeight = validLat = validLon = validDay = valid = false;
+         TropModel::humid = 50.0;
          setReceiverHeight(RX.getAltitude());
          setReceiverLatitude(RX.getGeodeticLatitude());
          setReceiverLongitude(RX.getLongitude());
@@ -182,6 +186,20 @@ namespace gpstk
          return correction(RX,SV);
       }
 
+      /// Compute the full tropospheric delays and the mapping functions for
+      /// several satellites, as correction(elevation) and the mapping functions
+      /// do, with the zenith delays computed once.
+      /// @param elevations Elevations of the satellites as seen at receiver,
+      ///                   in degrees.
+      /// @param delays     Output full tropospheric delays (m).
+      /// @param dryMaps    Output hydrostatic (dry) mapping functions.
+      /// @param wetMaps    Output wet mapping functions.
+      virtual void corrections(const std::vector<double>& elevations,
+                               std::vector<double>& delays,
+                               std::vector<double>& dryMaps,
+                               std::vector<double>& wetMaps) const
+         throw(InvalidTropModel);
+
       /// Compute and return the zenith delay for hydrostatic (dry) component of
       /// the troposphere. Use the Saastamoinen value.
       /// Ref. Davis etal 1985 and Leick, 3rd ed, pg 197.
@@ -303,9 +321,13 @@ namespace gpstk
 
       double height, latitude, longitude, dayfactor, undul;
       double P[10][10], aP[55], bP[55];
+      /// coefficients a and c of the dry, and a of the wet, mapping functions,
+      /// which depend only on position and time
+      double ahDry, chDry, awWet;
       bool validHeight, validLat, validLon, validDay, validCoeff;
 
-      /// Update coefficients when latitude and/or longitude changes
+      /// Update coefficients when latitude and/or longitude changes;
+      /// the mapping function coefficients also depend on time
       void updateGTMCoeff(void);
 
       /// Utility to test valid flags
@@ -42,6 +42,7 @@
 #ifndef GPSTK_IONOMODEL_HPP
 #define GPSTK_IONOMODEL_HPP
 
+#include <vector>
 #include "CommonTime.hpp"
 #include "EngAlmanac.hpp"
 #include "Position.hpp"
@@ -133,6 +134,28 @@ namespace gpstk
                            Frequency freq = L1) const
          throw(InvalidIonoModel);
 
+         /**
+          * get the ionospheric correction values for several satellites
+          * seen by the receiver at the same time. The receiver location
+          * and the time of day are computed once; each value is the same
+          * as that of getCorrection().
+          * \param time the time of the observations
+          * \param rxgeo the WGS84 geodetic position of the receiver
+          * \param svel the elevation angles between the rx and SVs (degrees)
+          * \param svaz the azimuth angles between the rx and SVs (degrees),
+          *    parallel to svel
+          * \param corrections output ionospheric corrections (meters),
+          *    parallel to svel
+          * \param freq the GPS frequency the observations were made from
+          */
+      void getCorrections(const CommonTime& time,
+                          const Position& rxgeo,
+                          const std::vector<double>& svel,
+                          const std::vector<double>& svaz,
+                          std::vector<double>& corrections,
+                          Frequency freq = L1) const
+         throw(InvalidIonoModel);
+
          /// equality operator
       bool operator==(const IonoModel& right) const throw();
 
@@ -141,6 +164,18 @@ namespace gpstk
 
    private:
 
+         /**
+          * the model for one satellite, given the receiver geodetic
+          * latitude and longitude (semi-circles) and the second of day.
+          */
+      double correction(double phi_u,
+                        double lambda_u,
+                        double sod,
+                        double svel,
+                        double svaz,
+                        Frequency freq) const
+         throw();
+
       double alpha[4];
       double beta[4];
 
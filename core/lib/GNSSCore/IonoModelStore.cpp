@@ -63,19 +63,59 @@ namespace gpstk
       throw(IonoModelStore::NoIonoModelFound)
    {
 
+      return getIonoModel(time).getCorrection(time, rxgeo, svel, svaz, freq);
+
+   }  // End of method 'IonoModelStore::getCorrection()'
+
+
+      /* Get the ionospheric correction values for several satellites
+       * seen by the receiver at the same time, with a single search
+       * for the model.
+       *
+       * \param time the time of the observations
+       * \param rxgeo the WGS84 geodetic position of the receiver
+       * \param svel the elevation angles between the rx and SVs (degrees)
+       * \param svaz the azimuth angles between the rx and SVs (degrees),
+       *    parallel to svel
+       * \param corrections output ionospheric corrections (meters),
+       *    parallel to svel
+       * \param freq the GPS frequency the observations were made from
+       */
+   void IonoModelStore::getCorrections(const CommonTime& time,
+                                       const Position& rxgeo,
+                                       const vector<double>& svel,
+                                       const vector<double>& svaz,
+                                       vector<double>& corrections,
+                                       IonoModel::Frequency freq) const
+      throw(IonoModelStore::NoIonoModelFound, IonoModel::InvalidIonoModel)
+   {
+
+      getIonoModel(time).getCorrections(time, rxgeo, svel, svaz,
+                                        corrections, freq);
+
+   }  // End of method 'IonoModelStore::getCorrections()'
+
+
+      /* Get the model in effect at a time.
+       *
+       * \param time the time of interest
+       * \return the last model added with a time not after time
+       */
+   const IonoModel& IonoModelStore::getIonoModel(const CommonTime& time) const
+      throw(IonoModelStore::NoIonoModelFound)
+   {
+
       IonoModelMap::const_iterator i = ims.upper_bound(time);
-      if (!ims.empty() && i != ims.begin())
-      {
-         i--;
-         return i->second.getCorrection(time, rxgeo, svel, svaz, freq);
-      }
-      else
+      if (ims.empty() || i == ims.begin())
       {
          NoIonoModelFound e;
          GPSTK_THROW(e);
       }
 
-   }  // End of method 'IonoModelStore::getCorrection()'
+      i--;
+      return i->second;
+
+   }  // End of method 'IonoModelStore::getIonoModel()'
 
 
       /* Add an IonoModel to this collection
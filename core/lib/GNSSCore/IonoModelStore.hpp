@@ -44,6 +44,7 @@
 #define GPSTK_IONOMODELSTORE_HPP
 
 #include <map>
+#include <vector>
 #include "CommonTime.hpp"
 #include "IonoModel.hpp"
 
@@ -94,6 +95,37 @@ namespace gpstk
          throw(NoIonoModelFound);
 
 
+         /** Get the ionospheric correction values for several satellites
+          * seen by the receiver at the same time, with a single search
+          * for the model.
+          *
+          * \param time the time of the observations
+          * \param rxgeo the WGS84 geodetic position of the receiver
+          * \param svel the elevation angles between the rx and SVs (degrees)
+          * \param svaz the azimuth angles between the rx and SVs (degrees),
+          *    parallel to svel
+          * \param corrections output ionospheric corrections (meters),
+          *    parallel to svel
+          * \param freq the GPS frequency the observations were made from
+          */
+      void getCorrections(const CommonTime& time,
+                          const Position& rxgeo,
+                          const std::vector<double>& svel,
+                          const std::vector<double>& svaz,
+                          std::vector<double>& corrections,
+                          IonoModel::Frequency freq = IonoModel::L1) const
+         throw(NoIonoModelFound, IonoModel::InvalidIonoModel);
+
+
+         /** Get the model in effect at a time.
+          *
+          * \param time the time of interest
+          * \return the last model added with a time not after time
+          */
+      const IonoModel& getIonoModel(const CommonTime& time) const
+         throw(NoIonoModelFound);
+
+
          /** Add an IonoModel to this collection
           *
           * \param mt the time the model is valid from
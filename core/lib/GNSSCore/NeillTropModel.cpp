@@ -93,6 +93,7 @@ namespace gpstk
       // @param time Time.
    NeillTropModel::NeillTropModel( const Position& RX,
                                    const CommonTime& time )
+      : validCoeff(false)
    {
       setReceiverHeight(RX.getAltitude());
       setReceiverLatitude(RX.getGeodeticLatitude( ));
@@ -356,44 +357,7 @@ namespace gpstk
          return 0.0;
       }
 
-      double lat, t, ct;
-      lat = fabs(NeillLat);         // degrees
-      t = static_cast<double>(NeillDOY) - 28.0;  // mid-winter
-
-      if(NeillLat < 0.0)              // southern hemisphere
-      {
-         t += 365.25/2.;
-      }
-
-      t *= 360.0/365.25;            // convert to degrees
-      ct = ::cos(t*DEG_TO_RAD);
-
-      double a, b, c;
-      if(lat < 15.0)
-      {
-         a = NeillDryA[0];
-         b = NeillDryB[0];
-         c = NeillDryC[0];
-      }
-      else if(lat < 75.)      // coefficients are for 15,30,45,60,75 deg
-      {
-         int i=int(lat/15.0)-1;
-         double frac=(lat-15.*(i+1))/15.;
-         a = NeillDryA[i] + frac*(NeillDryA[i+1]-NeillDryA[i]);
-         b = NeillDryB[i] + frac*(NeillDryB[i+1]-NeillDryB[i]);
-         c = NeillDryC[i] + frac*(NeillDryC[i+1]-NeillDryC[i]);
-
-         a -= ct * (NeillDryA1[i] + frac*(NeillDryA1[i+1]-NeillDryA1[i]));
-         b -= ct * (NeillDryB1[i] + frac*(NeillDryB1[i+1]-NeillDryB1[i]));
-         c -= ct * (NeillDryC1[i] + frac*(NeillDryC1[i+1]-NeillDryC1[i]));
-      }
-      else
-      {
-         a = NeillDryA[4] - ct * NeillDryA1[4];
-         b = NeillDryB[4] - ct * NeillDryB1[4];
-         c = NeillDryC[4] - ct * NeillDryC1[4];
-      }
-
+      double a(dryA), b(dryB), c(dryC);   // from setWeather()
       double se = ::sin(elevation*DEG_TO_RAD);
       double map = (1.+a/(1.+b/(1.+c)))/(se+a/(se+b/(se+c)));
 
@@ -422,29 +386,7 @@ namespace gpstk
          return 0.0;
       }
 
-      double a,b,c,lat;
-      lat = fabs(NeillLat);         // degrees
-      if(lat < 15.0)
-      {
-         a = NeillWetA[0];
-         b = NeillWetB[0];
-         c = NeillWetC[0];
-      }
-      else if(lat < 75.)          // coefficients are for 15,30,45,60,75 deg
-      {
-         int i=int(lat/15.0)-1;
-         double frac=(lat-15.*(i+1))/15.;
-         a = NeillWetA[i] + frac*(NeillWetA[i+1]-NeillWetA[i]);
-         b = NeillWetB[i] + frac*(NeillWetB[i+1]-NeillWetB[i]);
-         c = NeillWetC[i] + frac*(NeillWetC[i+1]-NeillWetC[i]);
-      }
-      else
-      {
-         a = NeillWetA[4];
-         b = NeillWetB[4];
-         c = NeillWetC[4];
-      }
-
+      double a(wetA), b(wetB), c(wetC);   // from setWeather()
       double se = ::sin(elevation*DEG_TO_RAD);
       double map = ( 1.+ a/ (1.+ b/(1.+c) ) ) / (se + a/(se + b/(se+c) ) );
 
@@ -453,6 +395,42 @@ namespace gpstk
    }  // end NeillTropModel::wet_mapping_function()
 
 
+      // Compute the full tropospheric delays and the mapping functions for
+      // several satellites seen by the receiver at the same time.
+      //
+      // @param elevations Elevations of the satellites as seen at receiver,
+      //                   in degrees.
+      // @param delays     Output full tropospheric delays (m).
+      // @param dryMaps    Output dry mapping functions.
+      // @param wetMaps    Output wet mapping functions.
+   void NeillTropModel::corrections( const std::vector<double>& elevations,
+                                     std::vector<double>& delays,
+                                     std::vector<double>& dryMaps,
+                                     std::vector<double>& wetMaps ) const
+      throw(InvalidTropModel)
+   {
+      THROW_IF_INVALID_DETAILED();
+
+      const double zdry(NeillTropModel::dry_zenith_delay());
+      const double zwet(NeillTropModel::wet_zenith_delay());
+
+      const size_t n(elevations.size());
+      delays.resize(n);
+      dryMaps.resize(n);
+      wetMaps.resize(n);
+      for(size_t i=0; i<n; i++)
+      {
+         dryMaps[i] = NeillTropModel::dry_mapping_function(elevations[i]);
+         wetMaps[i] = NeillTropModel::wet_mapping_function(elevations[i]);
+
+            // Neill mapping functions work down to 3 degrees of elevation
+         delays[i] = ( elevations[i] < 3.0 ? 0.0
+                          : (zdry * dryMaps[i]) + (zwet * wetMaps[i]) );
+      }
+
+   }  // end NeillTropModel::corrections(elevations)
+
+
       // This method configure the model to estimate the weather using height,
       // latitude and day of year (DOY). It is called automatically when
       // setting those parameters.
@@ -477,6 +455,77 @@ namespace gpstk
 
       valid = validHeight && validLat && validDOY;
 
+         // Coefficients of the mapping functions, which are the same for
+         // all satellites; the height enters only the mapping itself
+      if( valid && (!validCoeff || NeillLat != coeffLat ||
+                                   NeillDOY != coeffDOY) )
+      {
+         double lat, t, ct;
+         lat = fabs(NeillLat);         // degrees
+         t = static_cast<double>(NeillDOY) - 28.0;  // mid-winter
+
+         if(NeillLat < 0.0)              // southern hemisphere
+         {
+            t += 365.25/2.;
+         }
+
+         t *= 360.0/365.25;            // convert to degrees
+         ct = ::cos(t*DEG_TO_RAD);
+
+         if(lat < 15.0)
+         {
+            dryA = NeillDryA[0];
+            dryB = NeillDryB[0];
+            dryC = NeillDryC[0];
+         }
+         else if(lat < 75.)      // coefficients are for 15,30,45,60,75 deg
+         {
+            int i=int(lat/15.0)-1;
+            double frac=(lat-15.*(i+1))/15.;
+            dryA = NeillDryA[i] + frac*(NeillDryA[i+1]-NeillDryA[i]);
+            dryB = NeillDryB[i] + frac*(NeillDryB[i+1]-NeillDryB[i]);
+            dryC = NeillDryC[i] + frac*(NeillDryC[i+1]-NeillDryC[i]);
+
+            dryA -= ct * (NeillDryA1[i]
+                          + frac*(NeillDryA1[i+1]-NeillDryA1[i]));
+            dryB -= ct * (NeillDryB1[i]
+                          + frac*(NeillDryB1[i+1]-NeillDryB1[i]));
+            dryC -= ct * (NeillDryC1[i]
+                          + frac*(NeillDryC1[i+1]-NeillDryC1[i]));
+         }
+         else
+         {
+            dryA = NeillDryA[4] - ct * NeillDryA1[4];
+            dryB = NeillDryB[4] - ct * NeillDryB1[4];
+            dryC = NeillDryC[4] - ct * NeillDryC1[4];
+         }
+
+         if(lat < 15.0)
+         {
+            wetA = NeillWetA[0];
+            wetB = NeillWetB[0];
+            wetC = NeillWetC[0];
+         }
+         else if(lat < 75.)          // coefficients are for 15,30,45,60,75 deg
+         {
+            int i=int(lat/15.0)-1;
+            double frac=(lat-15.*(i+1))/15.;
+            wetA = NeillWetA[i] + frac*(NeillWetA[i+1]-NeillWetA[i]);
+            wetB = NeillWetB[i] + frac*(NeillWetB[i+1]-NeillWetB[i]);
+            wetC = NeillWetC[i] + frac*(NeillWetC[i+1]-NeillWetC[i]);
+         }
+         else
+         {
+            wetA = NeillWetA[4];
+            wetB = NeillWetB[4];
+            wetC = NeillWetC[4];
+         }
+
+         coeffLat = NeillLat;
+         coeffDOY = NeillDOY;
+         validCoeff = true;
+      }
+
    }
 
 
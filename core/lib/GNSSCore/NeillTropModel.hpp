@@ -86,7 +86,8 @@ namespace gpstk
 
          /// Default constructor
       NeillTropModel(void)
-      { validHeight=false; validLat=false; validDOY=false; valid=false; };
+      { validHeight=false; validLat=false; validDOY=false; valid=false;
+        validCoeff=false; };
 
 
          /// Constructor to create a Neill trop model providing just the
@@ -96,7 +97,7 @@ namespace gpstk
          ///
          /// @param ht   Height of the receiver above mean sea level, in
          ///             meters.
-      NeillTropModel(const double& ht)
+      NeillTropModel(const double& ht) : validCoeff(false)
       { setReceiverHeight(ht); };
 
 
@@ -110,7 +111,7 @@ namespace gpstk
          /// @param doy  Day of year.
       NeillTropModel( const double& ht,
                       const double& lat,
-                      const int& doy )
+                      const int& doy ) : validCoeff(false)
       { setReceiverHeight(ht); setReceiverLatitude(lat); setDayOfYear(doy); };
 
 
@@ -247,6 +248,24 @@ namespace gpstk
          throw(InvalidTropModel);
 
 
+         /** Compute the full tropospheric delays and the mapping functions
+          * for several satellites seen by the receiver at the same time.
+          * The zenith delays are computed once, and the coefficients of the
+          * mapping functions are those kept by setWeather().
+          *
+          * @param elevations Elevations of the satellites as seen at
+          *                   receiver, in degrees.
+          * @param delays     Output full tropospheric delays (m).
+          * @param dryMaps    Output dry mapping functions.
+          * @param wetMaps    Output wet mapping functions.
+          */
+      virtual void corrections( const std::vector<double>& elevations,
+                                std::vector<double>& delays,
+                                std::vector<double>& dryMaps,
+                                std::vector<double>& wetMaps ) const
+         throw(InvalidTropModel);
+
+
          /// Compute and return the zenith delay for dry component of
          /// the troposphere.
       virtual double dry_zenith_delay(void) const
@@ -280,7 +299,9 @@ namespace gpstk
 
          /// This method configure the model to estimate the weather using
          /// height, latitude and day of year (DOY). It is called
-         /// automatically when setting those parameters.
+         /// automatically when setting those parameters, and computes the
+         /// coefficients of the mapping functions when latitude or DOY
+         /// have changed.
       void setWeather()
          throw(InvalidTropModel);
 
@@ -344,6 +365,15 @@ namespace gpstk
       bool validHeight;
       bool validLat;
       bool validDOY;
+
+         /// Coefficients of the dry and wet mapping functions, which depend
+         /// only on latitude and DOY; valid if validCoeff, for coeffLat
+         /// and coeffDOY.
+      double dryA, dryB, dryC;
+      double wetA, wetB, wetC;
+      double coeffLat;
+      int coeffDOY;
+      bool validCoeff;
    };
 
 }
@@ -98,6 +98,39 @@ namespace gpstk
       return c;
    }  // end TropModel::correction(RX,SV,TT)
 
+      // Compute the full tropospheric delays and the mapping functions for
+      // several satellites seen from one receiver at one time.
+      // @param elevations Elevations of the satellites as seen at the receiver,
+      //                   in degrees
+      // @param delays     Output full tropospheric delays (m)
+      // @param dryMaps    Output hydrostatic (dry) mapping functions
+      // @param wetMaps    Output wet mapping functions
+   void TropModel::corrections(const std::vector<double>& elevations,
+                               std::vector<double>& delays,
+                               std::vector<double>& dryMaps,
+                               std::vector<double>& wetMaps) const
+      throw(InvalidTropModel)
+   {
+      const size_t n(elevations.size());
+      delays.resize(n);
+      dryMaps.resize(n);
+      wetMaps.resize(n);
+
+      try
+      {
+         for(size_t i=0; i<n; i++)
+         {
+            delays[i] = correction(elevations[i]);
+            dryMaps[i] = dry_mapping_function(elevations[i]);
+            wetMaps[i] = wet_mapping_function(elevations[i]);
+         }
+      }
+      catch(InvalidTropModel& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }  // end TropModel::corrections(elevations)
+
       // Re-define the tropospheric model with explicit weather data.
       // Typically called just before correction().
       // @param T temperature in degrees Celsius
@@ -43,6 +43,7 @@
 #ifndef TROP_MODEL_HPP
 #define TROP_MODEL_HPP
 
+#include <vector>
 #include "Exception.hpp"
 #include "ObsEpochMap.hpp"
 #include "WxObsMap.hpp"
@@ -149,6 +150,27 @@ namespace gpstk
          throw(InvalidTropModel)
       { Position R(RX),S(SV);  return TropModel::correction(R,S,tt); }
 
+         /**
+          * Compute the full tropospheric delays and the mapping functions for
+          * several satellites seen from one receiver at one time, i.e. with the
+          * model set (weather, receiver and time) as for correction(elevation).
+          * The results are those of correction(elevation), dry_mapping_function()
+          * and wet_mapping_function() for each elevation. Models override this
+          * to compute the terms that depend only on the receiver and time once,
+          * for all the satellites.
+          * @param elevations Elevations of the satellites as seen at the receiver,
+          *                   in degrees
+          * @param delays     Output full tropospheric delays (m), parallel to
+          *                   elevations
+          * @param dryMaps    Output hydrostatic (dry) mapping functions
+          * @param wetMaps    Output wet mapping functions
+          */
+      virtual void corrections(const std::vector<double>& elevations,
+                               std::vector<double>& delays,
+                               std::vector<double>& dryMaps,
+                               std::vector<double>& wetMaps) const
+         throw(InvalidTropModel);
+
          /// Compute and return the zenith delay for hydrostatic (dry)
          /// component of the troposphere
       virtual double dry_zenith_delay(void) const
@@ -322,10 +322,11 @@ namespace gpstk
          if(rec.drift != 0.0) haveClockDrift = true;
          if(rec.accel != 0.0) haveClockAccel = true;
 
-         if(tables.find(sat) != tables.end() &&
-            tables[sat].find(ttag) != tables[sat].end()) {
+         DataTable& table(tables[sat]);
+         DataTable::iterator it(table.lower_bound(ttag));
+         if(it != table.end() && !(ttag < it->first)) {
                // record already exists in the table
-            ClockRecord& oldrec(tables[sat][ttag]);
+            ClockRecord& oldrec(it->second);
             oldrec.bias = rec.bias;
             oldrec.sig_bias = rec.sig_bias;
             if(haveClockDrift) {
@@ -337,8 +338,8 @@ namespace gpstk
                oldrec.sig_accel = rec.sig_accel;
             }
          }
-         else  // create a new entry in the table
-            tables[sat][ttag] = rec;
+         else  // create a new entry in the table, 'it' is the hint
+            table.insert(it, DataTable::value_type(ttag, rec));
       }
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
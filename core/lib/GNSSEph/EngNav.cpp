@@ -625,6 +625,38 @@ namespace gpstk
    }
 
 
+   namespace
+   {
+         /** Parity contribution of each byte of the 24 data bits of a
+          * subframe word, used by EngNav::computeParity(). */
+      struct ParityTable
+      {
+         ParityTable()
+         {
+            uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
+                                  0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+            for (unsigned byte = 0; byte < 3; byte++)
+            {
+               for (uint32_t val = 0; val < 256; val++)
+               {
+                  uint32_t d = val << (6 + 8*byte);
+                  uint8_t D = 0;
+                  for (unsigned bit = 0; bit < 6; bit++)
+                  {
+                     D |= (BinUtils::countBits(bmask[bit] & d) % 2)
+                        << (5 - bit);
+                  }
+                  t[byte][val] = D;
+               }
+            }
+         }
+
+            /// t[i][b] is the parity of byte value b in data byte i (0=LSB).
+         uint8_t t[3][256];
+      };
+   }
+
+
    uint32_t EngNav :: computeParity(uint32_t sfword,
                                     uint32_t psfword,
                                     bool knownUpright)
@@ -649,26 +681,33 @@ namespace gpstk
            D29    10 1011 1011 0001 1111 0011 0100 0000
            D30    00 1011 0111 1010 1000 1001 1100 0000
          */
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                            0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+         // All the mask bits lie in the 24 data bits (d1-d24, bits 29
+         // through 6 of the word), so the six parity bits of each data
+         // byte are looked up in a table and the three bytes combined
+         // with exclusive-OR instead of counting bits once per parity
+         // bit.
+      static const ParityTable table;
 
-      uint32_t D = 0;
-      uint32_t d = sfword;
       uint32_t D29 = getd29(psfword);
       uint32_t D30 = getd30(psfword);
+      uint32_t d = (sfword >> 6) & 0x00ffffff;
 
          // If D30 of the previous subframe was set, complement the word
          // to get the source data bits.  This will also complement the
          // parity, but we don't need the original parity to compute the
          // new.
       if (D30 && !knownUpright)
-         d = ~d;
-      D |= ((D29 + BinUtils::countBits(bmask[0] & d)) % 2) << 5;
-      D |= ((D30 + BinUtils::countBits(bmask[1] & d)) % 2) << 4;
-      D |= ((D29 + BinUtils::countBits(bmask[2] & d)) % 2) << 3;
-      D |= ((D30 + BinUtils::countBits(bmask[3] & d)) % 2) << 2;
-      D |= ((D30 + BinUtils::countBits(bmask[4] & d)) % 2) << 1;
-      D |= ((D29 + BinUtils::countBits(bmask[5] & d)) % 2);
+         d ^= 0x00ffffff;
+
+      uint32_t D = table.t[0][d & 0xff] ^
+                   table.t[1][(d >> 8) & 0xff] ^
+                   table.t[2][d >> 16];
+
+         // D29* enters D25, D27 and D30, D30* enters D26, D28 and D29
+      if (D29)
+         D ^= 0x29;
+      if (D30)
+         D ^= 0x16;
 
       return D;
    }
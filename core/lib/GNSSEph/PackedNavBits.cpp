@@ -54,7 +54,8 @@ namespace gpstk
    using namespace std;
    PackedNavBits::PackedNavBits()
                  : transmitTime(CommonTime::BEGINNING_OF_TIME),
-                   bits(900),
+                   bits((900+63)/64),
+                   bits_size(900),
                    bits_used(0),
                    rxID(""),
                    xMitCoerced(false)
@@ -64,7 +65,8 @@ namespace gpstk
    PackedNavBits::PackedNavBits(const SatID& satSysArg, 
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((900+63)/64),
+                                  bits_size(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -79,7 +81,8 @@ namespace gpstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((900+63)/64),
+                                  bits_size(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -96,7 +99,8 @@ namespace gpstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((900+63)/64),
+                                  bits_size(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -118,11 +122,12 @@ namespace gpstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      bits.resize(bits_used);
-      for (int i=0;i<bits_used;i++)
-      {
-         bits[i] = right.bits[i];
-      }
+      bits_size = bits_used;
+      bits.assign(right.bits.begin(),
+                  right.bits.begin() + (bits_size+63)/64);
+         // Clear whatever the source held past bits_used
+      if (bits_size & 63)
+         bits.back() &= ~(~uint64_t(0) >> (bits_size & 63));
       xMitCoerced = right.xMitCoerced;
    }
  
@@ -181,6 +186,7 @@ namespace gpstk
    void PackedNavBits::clearBits()
    {
       bits.clear();
+      bits_size = 0;
       bits_used = 0;
    }
 
@@ -219,20 +225,27 @@ namespace gpstk
                                       const int numBits ) const
       throw(InvalidParameter)                                    
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
       size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if (stop>bits_size)
       {
          InvalidParameter exc("Requested bits not present.");
          GPSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
-      {
-         temp <<= 1;
-         if (bits[i]) temp++;
-      }
-      return( temp ); 
+      return( getBits(startBit, numBits) ); 
+   }
+
+      // A field spans at most two words, so it is extracted with a
+      // couple of shifts rather than one bit at a time.
+   uint64_t PackedNavBits::getBits(const size_t startBit,
+                                   const int numBits ) const
+   {
+      if (numBits<=0) return 0;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      uint64_t temp = bits[ndx] << offset;
+      if (offset + numBits > 64)
+         temp |= bits[ndx+1] >> (64 - offset);
+      return( temp >> (64 - numBits) );
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit, 
@@ -451,7 +464,7 @@ namespace gpstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits[bitNum]; 
+      return getBit(bitNum); 
    }
 
 
@@ -593,32 +606,52 @@ namespace gpstk
    {
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
-      bits.resize(bits_used);
+      resizeBits(bits_used);
       
-      for (int i=0;i<right.bits_used;i++)
+         // Copy 64 bits at a time
+      for (int i=0;i<right.bits_used;i+=64)
       {
-         bits[i+old_bits_used] = right.bits[i];
+         int num = right.bits_used - i;
+         if (num>64) num = 64;
+         setBits(i+old_bits_used, num, right.getBits(i, num));
       }
    }
 
    void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
    {
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
+      if (static_cast<size_t>(bits_used + numBits) > bits_size)
+         resizeBits(bits_used + numBits);
+      setBits(bits_used, numBits, value);
+      bits_used += numBits;
+   }
 
-      for (int i=0; i<numBits; ++i)
+   void PackedNavBits::setBits( const size_t startBit, const int numBits,
+                                const uint64_t value )
+   {
+      if (numBits<=0) return;
+      uint64_t val = value;
+      if (numBits<64) val &= (uint64_t(1) << numBits) - 1;
+
+         // Left justify the value at the start bit.  The part that
+         // does not fit in the first word goes to the next one.
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      uint64_t mask = ~uint64_t(0) << (64 - numBits);
+      uint64_t just = val << (64 - numBits);
+      bits[ndx] = (bits[ndx] & ~(mask >> offset)) | (just >> offset);
+      if (offset + numBits > 64)
       {
-         bits[ndx] = false;
-         if (value & mask) 
-         {
-             //set the bits to true
-            bits[ndx] = true;
-         }
-         mask>>= 1;
-         ndx++;
+         bits[ndx+1] = (bits[ndx+1] & ~(mask << (64 - offset)))
+                     | (just << (64 - offset));
       }
-      bits_used += numBits;
+   }
+
+   void PackedNavBits::resizeBits( const size_t newSize )
+   {
+      bits.resize((newSize+63)/64, 0);
+      bits_size = newSize;
+      if (bits_size & 63)
+         bits.back() &= ~(~uint64_t(0) >> (bits_size & 63));
    }
 
    //--------------------------------------------------------------------------
@@ -628,9 +661,9 @@ namespace gpstk
    // in which left has a FALSE whereas right has a TRUE starting at the 
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation 
-   // is probably not the fastest.  Since we are scanning a bit array rather 
-   // than testing a series of unsigned ints.
+   // Since the bits are stored most significant first and the unused bits
+   // of the last word are zero, comparing whole words as unsigned integers
+   // gives the same result as the bit-for-bit scan.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -638,20 +671,19 @@ namespace gpstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should 
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (bits_size!=right.bits_size)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (bits_size<right.bits_size) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<bits.size();i++)
       {
-         if (bits[i]==false && right.bits[i]==true)
-         //if (bits[i]<right.bits[i])
+         if (bits[i]<right.bits[i])
          {
             return true;
          }
-         if (bits[i]==true && right.bits[i]==false)
+         if (bits[i]>right.bits[i])
          {
             return false;
          }
@@ -659,22 +691,30 @@ namespace gpstk
       return false;
    }
 
+   size_t PackedNavBits::hashBits() const
+   {
+         // Mix each word into the hash with a multiply and a shift
+         // (the 64-bit FNV prime and golden ratio constants).
+      uint64_t h = bits_size * 0x9e3779b97f4a7c15ULL;
+      for (size_t i=0;i<bits.size();i++)
+      {
+         h ^= bits[i];
+         h *= 0x100000001b3ULL;
+         h ^= h >> 29;
+      }
+      return( (size_t) h );
+   }
+
    void PackedNavBits::invert( )
    {
-         // Each bit is either 1 or 0.
-         // Starting with 1 and subtracting the 
-         // current value will yield the inverse
-         //   
-         //  Input    Equation     Result
-         //    1       1 - 1          0
-         //    0       1 - 0          1
-         //
-         // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+         // Complement whole words, then clear the bits past
+         // bits_size in the last word.
+      for (size_t i=0;i<bits.size();i++)
       {
-         bits[i] = 1 - bits[i];
+         bits[i] = ~bits[i];
       }
+      if (bits_size & 63)
+         bits.back() &= ~(~uint64_t(0) >> (bits_size & 63));
    } 
 
       /**
@@ -699,9 +739,11 @@ namespace gpstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
+      for (int i=startBit; i<=finalBit; i+=64)
       {
-         bits[i] = from.bits[i];
+         int num = finalBit - i + 1;
+         if (num>64) num = 64;
+         setBits(i, num, from.getBits(i, num));
       }
    }
 
@@ -732,20 +774,7 @@ namespace gpstk
          GPSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L; 
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
-      {
-         bits[ndx] = false;
-         if (out & mask)
-         {
-            bits[ndx] = true;
-         }
-         mask >>= 1;
-         ndx++;
-      }
+      setBits(startBit, numBits, out);
    }
 
 
@@ -760,7 +789,7 @@ namespace gpstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -823,10 +852,10 @@ namespace gpstk
       int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getBit(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= 32)
@@ -862,10 +891,10 @@ namespace gpstk
       int bit_count    = 0; 
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getBit(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= numBitsPerWord)
@@ -879,7 +908,7 @@ namespace gpstk
             //but ONLY if there are more bits left to put on the next line.
             if (word_count>0 && 
                 word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;        
+                (i+1) < bits_size) s << endl;        
          }
       }
          // Need to check if there is a partial word in the buffer
@@ -889,7 +918,7 @@ namespace gpstk
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size()); 
+      return(bits_size); 
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -942,19 +971,23 @@ namespace gpstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them. 
-      if (bits.size()!=right.bits.size()) return false; 
+      if (bits_size!=right.bits_size) return false; 
+      if (bits_size==0) return true;
 
       short startBit = startBitA;
       short endBit = endBitA; 
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=int(bits_size)) endBit = bits_size-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
+      if (startBit>=int(bits_size)) startBit = bits_size-1;
 
-      for (int i=startBit;i<=endBit;i++)
+         // Compare up to 64 bits at a time
+      for (int i=startBit;i<=endBit;i+=64)
       {
-         if (bits[i]!=right.bits[i])
+         int num = endBit - i + 1;
+         if (num>64) num = 64;
+         if (getBits(i, num)!=right.getBits(i, num))
          {
             return false;
          }
@@ -346,6 +346,15 @@ namespace gpstk
           */
       bool operator<(const PackedNavBits& right) const; 
 
+         /**
+          * Return a hash of the packed bits, consistent with
+          *   operator<( ): objects for which neither a < b nor b < a
+          *   have the same hash.  The meta-data are not included.
+          *   Used by the NavFilter classes to group matching messages
+          *   without sorting them.
+          */
+      size_t hashBits() const;
+
          /**
           *  Bitwise invert contents of this object.
           */
@@ -419,7 +428,11 @@ namespace gpstk
       NavID navID;             /**< Defines the navigation message tracked */ 
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+      std::vector<uint64_t> bits; /**< Holds the packed data, 64 bits per
+                                       word, first bit in the most
+                                       significant bit of word 0.  Bits past
+                                       bits_size are kept at zero */
+      size_t bits_size;        /**< Number of bits held in 'bits' */
       int bits_used;
       
       bool xMitCoerced;        /**< Used to indicate that the transmit
@@ -433,6 +446,24 @@ namespace gpstk
          /** Pack the bits */
       void addUint64_t( const uint64_t value, const int numBits );
 
+         /** Return the bit at bitNum */
+      bool getBit( const size_t bitNum ) const
+      { return (bits[bitNum >> 6] >> (63 - (bitNum & 63))) & 1; }
+
+         /** Return numBits (at most 64) bits starting at startBit,
+          *  right justified.  No range checking is done. */
+      uint64_t getBits( const size_t startBit, const int numBits ) const;
+
+         /** Overwrite numBits (at most 64) bits starting at startBit
+          *  with the low-order numBits of value.  No range checking
+          *  is done. */
+      void setBits( const size_t startBit, const int numBits,
+                    const uint64_t value );
+
+         /** Set the number of bits held to newSize.  Added bits are
+          *  zero. */
+      void resizeBits( const size_t newSize );
+
          /** Extend the sign bit for signed values */
       int64_t SignExtend( const int startBit, const int numBits ) const;
    
@@ -358,17 +358,19 @@ namespace gpstk
             for(i=0; i<3; i++)
                if(rec.Acc[i] != 0.0) { haveAcceleration = true; break; }
 
-         if(tables.find(sat) != tables.end() &&
-            tables[sat].find(ttag) != tables[sat].end()) {
+         DataTable& table(tables[sat]);
+         DataTable::iterator it(table.lower_bound(ttag));
+         if(it != table.end() && !(ttag < it->first)) {
                   // record already exists in table
-            PositionRecord& oldrec(tables[sat][ttag]);
+            PositionRecord& oldrec(it->second);
             oldrec.Pos = rec.Pos;
             oldrec.sigPos = rec.sigPos;
             if(haveVelocity) { oldrec.Vel = rec.Vel; oldrec.sigVel = rec.sigVel; }
             if(haveAcceleration) { oldrec.Acc = rec.Acc; oldrec.sigAcc = rec.sigAcc; }
          }
-         else {   // create a new entry in the table
-            tables[sat][ttag] = rec;
+         else {   // create a new entry in the table; records usually come
+                  // in time order, so 'it' is a good hint
+            table.insert(it, DataTable::value_type(ttag, rec));
          }
       }
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
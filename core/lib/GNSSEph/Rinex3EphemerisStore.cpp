@@ -46,6 +46,7 @@
 #include "GalEphemeris.hpp"
 #include "BDSEphemeris.hpp"
 #include "QZSEphemeris.hpp"
+#include "ProductCache.hpp"
 
 using namespace std;
 
@@ -143,6 +144,18 @@ namespace gpstk
                addTimeCorr(it->second);
          }
 
+         // the records of a file loaded before may be in the product cache
+         vector<Rinex3NavData> recs;
+         if(readCachedRecords(filename, recs)) {
+            for(size_t i=0; i<recs.size(); i++) {
+               Rdata = recs[i];
+               if(dump) Rdata.dump(s);
+               addEphemeris(Rdata);
+            }
+            return recs.size();
+         }
+         bool saveRecs(ProductCache::isEnabled());
+
          while(1) {
             // read the record
             try { strm >> Rdata; }
@@ -165,6 +178,7 @@ namespace gpstk
 
             nread++;
             if(dump) Rdata.dump(s);
+            if(saveRecs) recs.push_back(Rdata);
 
             try {
                addEphemeris(Rdata);
@@ -175,6 +189,8 @@ namespace gpstk
             }
          }
 
+         if(saveRecs) saveCachedRecords(filename, recs);
+
          return nread;
       }
       catch(Exception& e) {
@@ -183,6 +199,100 @@ namespace gpstk
 
    } // end Rinex3EphemerisStore::loadFile
 
+   // Read the nav records of the product cache entry of a file, if there is
+   // a matching entry. Return false if the file must be parsed.
+   bool Rinex3EphemerisStore::readCachedRecords(const string& filename,
+                                                vector<Rinex3NavData>& recs)
+      const throw()
+   {
+      try {
+         ProductCache cache;
+         if(!cache.openEntry(filename, "rnx3nav"))
+            return false;
+
+         // each record is at least its time, satellite, satSys, 2 64-bit
+         // and 7 32-bit integers and 42 doubles
+         size_t n = cache.getCount(28+8+8+2*8+7*4+42*8);
+         recs.resize(n);
+         for(size_t i=0; i<n && cache.good(); i++) {
+            Rinex3NavData& rec(recs[i]);
+            int64_t l[2];
+            int32_t k[7];
+            SatID sat;
+            cache.getTime(rec.time);
+            cache.getSatID(sat);
+            rec.sat = RinexSatID(sat);
+            cache.getString(rec.satSys);
+            cache.getData(l[0]); cache.getData(l[1]);
+            for(int j=0; j<7; j++) cache.getData(k[j]);
+            rec.xmitTime = l[0];    rec.MFtime = l[1];
+            rec.PRNID = k[0];       rec.weeknum = k[1];
+            rec.health = k[2];      rec.codeflgs = k[3];
+            rec.L2Pdata = k[4];     rec.freqNum = k[5];
+            rec.datasources = k[6];
+            double *d[42] = {
+               &rec.accuracy, &rec.IODC, &rec.IODE, &rec.TauN, &rec.GammaN,
+               &rec.MFTraw, &rec.ageOfInfo, &rec.IODnav, &rec.accCode,
+               &rec.IODN, &rec.Toc, &rec.af0, &rec.af1, &rec.af2, &rec.Tgd,
+               &rec.Tgd2, &rec.Cuc, &rec.Cus, &rec.Crc, &rec.Crs, &rec.Cic,
+               &rec.Cis, &rec.Toe, &rec.M0, &rec.dn, &rec.ecc, &rec.Ahalf,
+               &rec.OMEGA0, &rec.i0, &rec.w, &rec.OMEGAdot, &rec.idot,
+               &rec.fitint, &rec.px, &rec.py, &rec.pz, &rec.vx, &rec.vy,
+               &rec.vz, &rec.ax, &rec.ay, &rec.az };
+            for(int j=0; j<42; j++) cache.getData(*d[j]);
+         }
+
+         if(cache.good())
+            return true;
+      }
+      catch(...) { }
+
+      // a bad entry is ignored, and the file parsed
+      recs.clear();
+      return false;
+   }
+
+   // Write the nav records of a file to the product cache. Errors are ignored.
+   void Rinex3EphemerisStore::saveCachedRecords(const string& filename,
+                                          const vector<Rinex3NavData>& recs)
+      const throw()
+   {
+      try {
+         ProductCache cache;
+         if(!cache.createEntry(filename, "rnx3nav"))
+            return;
+
+         cache.writeCount(recs.size());
+         for(size_t i=0; i<recs.size(); i++) {
+            const Rinex3NavData& rec(recs[i]);
+            cache.writeTime(rec.time);
+            cache.writeSatID(rec.sat);
+            cache.writeString(rec.satSys);
+            cache.writeData(static_cast<int64_t>(rec.xmitTime));
+            cache.writeData(static_cast<int64_t>(rec.MFtime));
+            const int32_t k[7] = { rec.PRNID, rec.weeknum, rec.health,
+                                   rec.codeflgs, rec.L2Pdata, rec.freqNum,
+                                   rec.datasources };
+            for(int j=0; j<7; j++) cache.writeData(k[j]);
+            const double d[42] = {
+               rec.accuracy, rec.IODC, rec.IODE, rec.TauN, rec.GammaN,
+               rec.MFTraw, rec.ageOfInfo, rec.IODnav, rec.accCode,
+               rec.IODN, rec.Toc, rec.af0, rec.af1, rec.af2, rec.Tgd,
+               rec.Tgd2, rec.Cuc, rec.Cus, rec.Crc, rec.Crs, rec.Cic,
+               rec.Cis, rec.Toe, rec.M0, rec.dn, rec.ecc, rec.Ahalf,
+               rec.OMEGA0, rec.i0, rec.w, rec.OMEGAdot, rec.idot,
+               rec.fitint, rec.px, rec.py, rec.pz, rec.vx, rec.vy,
+               rec.vz, rec.ax, rec.ay, rec.az };
+            for(int j=0; j<42; j++) cache.writeData(d[j]);
+         }
+
+         cache.commitEntry();
+      }
+      catch(...) {
+         // the entry is discarded by the ProductCache destructor
+      }
+   }
+
    // Find the appropriate time system correction object in the collection for the
    // given time systems, and dump it to a string and return that string.
    string Rinex3EphemerisStore::dumpTimeSystemCorrection(
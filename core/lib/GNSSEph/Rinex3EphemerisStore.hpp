@@ -44,6 +44,7 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
 #include <map>
 #include <algorithm>
 
@@ -87,6 +88,25 @@ namespace gpstk
          /// Ephemeris store for Geosync nav messages (stored as GeoRecord)
          //GeoEphemerisStore GEOstore;
 
+         /** Read the nav records of the product cache entry of a file,
+          * if there is a matching entry (see ProductCache).
+          * @param filename name of the file
+          * @param recs the records, in file order; cleared if no
+          *   entry was read
+          * @return true if the records were read, false if the file
+          *   must be parsed. */
+      bool readCachedRecords(const std::string& filename,
+                             std::vector<Rinex3NavData>& recs) const
+         throw();
+
+         /** Write the nav records of a file to the product cache.
+          * Errors are ignored.
+          * @param filename name of the file
+          * @param recs the records read from the file */
+      void saveCachedRecords(const std::string& filename,
+                             const std::vector<Rinex3NavData>& recs) const
+         throw();
+
    public:
 
          /// Rinex file header last read by loadFile()
@@ -239,6 +259,10 @@ namespace gpstk
           *         -2 failed to read header (this->Rhead),
           *         -3 failed to read data (this->Rdata),
           *        >=0 number of nav records read
+          * @note If the product cache is enabled (see ProductCache), the
+          * records of a file already loaded by an earlier run are read
+          * from the cache instead of being parsed; the header is still
+          * read from the file.
           * @throw some other problem */
       int loadFile(const std::string& filename, bool dump=false,
                    std::ostream& s=std::cout);
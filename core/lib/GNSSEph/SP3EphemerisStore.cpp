@@ -43,6 +43,8 @@
 /// interpolation algorithm.
 
 #include <iostream>
+#include <thread>
+#include <atomic>
 
 #include "Exception.hpp"
 #include "SatID.hpp"
@@ -60,6 +62,7 @@
 #include "FileStore.hpp"
 #include "ClockSatStore.hpp"
 #include "PositionSatStore.hpp"
+#include "ProductCache.hpp"
 
 #include "SP3EphemerisStore.hpp"
 
@@ -240,307 +243,496 @@ namespace gpstk
    {
       try
       {
-            // open the input stream
-         SP3Stream strm(filename.c_str());
-         if (!strm)
+         ProductFile pf(filename, ProductFile::SP3, fillClockStore);
+         readProductFile(pf);
+         addProductFile(pf);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Read the header and the data records of a file, using the product cache
+      // if enabled. Errors are kept in the ProductFile; the store is not changed.
+   void SP3EphemerisStore::readProductFile(ProductFile& pf) const throw()
+   {
+      const string& filename(pf.filename);
+
+      try
+      {
+            // decide if the file is SP3
+         if(pf.format == ProductFile::Unknown)
          {
-            Exception e("File " + filename + " could not be opened");
-            GPSTK_THROW(e);
+            SP3Stream strm(filename.c_str(),std::ios::in);
+            if (strm)
+            {
+                  // read the header
+               SP3Header header;
+               strm >> header;
+            }
+            pf.format = (strm ? ProductFile::SP3 : ProductFile::RinexClock);
+            strm.close();
          }
-         strm.exceptions(ios::failbit);
-            //cout << "Opened file " << filename << endl;
-
-            // declare header and data
-         SP3Header head;
 
-            // read the SP3 ephemeris header
-         try
+         if(pf.format == ProductFile::SP3)
          {
-            strm >> head;
+               // open the input stream
+            SP3Stream strm(filename.c_str());
+            if (!strm)
+            {
+               Exception e("File " + filename + " could not be opened");
+               GPSTK_THROW(e);
+            }
+            strm.exceptions(ios::failbit);
+
+               // read the SP3 ephemeris header
+            try
+            {
+               strm >> pf.sp3Head;
+            }
+            catch(Exception& e)
+            {
+               e.addText("Error reading header of file " + filename + e.getText());
+               GPSTK_RETHROW(e);
+            }
+            pf.haveHeader = true;
+
+               // the product cache holds the records read below, which
+               // depend on the reject options
+            string kind = string("sp3-") + (pf.fillClockStore ? "c" : "n")
+                        + (rejectBadPosFlag ? "1" : "0")
+                        + (rejectBadClockFlag ? "1" : "0")
+                        + (rejectPredPosFlag ? "1" : "0")
+                        + (rejectPredClockFlag ? "1" : "0");
+            if(readCachedRecords(filename, kind, pf.recs))
+               return;
+
+               // read data
+            try
+            {
+               readSP3Records(strm, pf.sp3Head, pf.fillClockStore, pf.recs);
+            }
+            catch(Exception& e)
+            {
+               e.addText("Error reading data of file " + filename);
+               GPSTK_RETHROW(e);
+            }
+
+            strm.close();
+
+            if(ProductCache::isEnabled())
+               saveCachedRecords(filename, kind, pf.recs);
          }
-         catch(Exception& e)
+         else
          {
-            e.addText("Error reading header of file " + filename + e.getText());
-            GPSTK_RETHROW(e);
+               // open the input stream
+            Rinex3ClockStream strm(filename.c_str());
+            if(!strm.is_open())
+            {
+               Exception e("File " + filename + " could not be opened");
+               GPSTK_THROW(e);
+            }
+            strm.exceptions(std::ios::failbit);
+
+               // read the RINEX clock header
+            try
+            {
+               strm >> pf.clkHead;
+            }
+            catch(Exception& e)
+            {
+               e.addText("Error reading header of file " + filename);
+               GPSTK_RETHROW(e);
+            }
+            pf.haveHeader = true;
+
+               // there is no way to determine the time system....this is a problem TD
+               // TD SP3EphemerisStore::fixTimeSystem() ??
+            TimeSystem ts(pf.clkHead.timeSystem);
+            if(ts == TimeSystem::Any || ts == TimeSystem::Unknown)
+               ts = TimeSystem::GPS;
+
+            if(readCachedRecords(filename, "rnxclk", pf.recs))
+               return;
+
+               // read data
+            Rinex3ClockData data;
+            try
+            {
+               while(strm >> data)
+               {
+                     //data.dump(cout);
+
+                  if(data.datatype == std::string("AS"))
+                  {
+                     data.time.setTimeSystem(ts);
+                        // add this data
+                     ClockRecord rec;
+                     rec.bias = data.bias; rec.sig_bias = data.sig_bias;
+                     rec.drift = data.drift; rec.sig_drift = data.sig_drift;
+                     rec.accel = data.accel; rec.sig_accel = data.sig_accel;
+                     pf.recs.addClock(data.sat, data.time, rec);
+                  }
+               }
+            }
+            catch(Exception& e)
+            {
+               e.addText("Error reading data of file " + filename);
+               GPSTK_RETHROW(e);
+            }
+
+            strm.close();
+
+            if(ProductCache::isEnabled())
+               saveCachedRecords(filename, "rnxclk", pf.recs);
          }
-            //cout << "Read header" << endl; head.dump();
+      }
+      catch (Exception& e)
+      {
+         pf.error = std::current_exception();
+      }
+      catch (std::exception& e)
+      {
+         gpstk::Exception exc("std::exception " + std::string(e.what()));
+         pf.error = std::make_exception_ptr(exc);
+      }
+      catch (...)
+      {
+         gpstk::Exception exc("Unknown exception");
+         pf.error = std::make_exception_ptr(exc);
+      }
+   }
+
+      // Add a file read by readProductFile() to the file and data stores: check
+      // the time system, add the header and the records, then throw the error
+      // raised while reading, if any.
+   void SP3EphemerisStore::addProductFile(ProductFile& pf)
+      throw(Exception)
+   {
+      try
+      {
+            // nothing to add if the header could not be read
+         if(!pf.haveHeader && pf.error)
+            std::rethrow_exception(pf.error);
+
+         bool isSP3(pf.format == ProductFile::SP3);
+         TimeSystem fileTimeSystem(isSP3 ? pf.sp3Head.timeSystem
+                                         : pf.clkHead.timeSystem);
 
             // check/save TimeSystem to storeTimeSystem
-         if(head.timeSystem != TimeSystem::Any &&
-            head.timeSystem != TimeSystem::Unknown)
+         if(fileTimeSystem != TimeSystem::Any &&
+            fileTimeSystem != TimeSystem::Unknown)
          {
                // if store time system has not been set, do so
             if(storeTimeSystem == TimeSystem::Any)
             {
                   // NB. store-, pos- and clk- TimeSystems must always be the same
-               storeTimeSystem = head.timeSystem;
-               posStore.setTimeSystem(head.timeSystem);
-               clkStore.setTimeSystem(head.timeSystem);
+               storeTimeSystem = fileTimeSystem;
+               posStore.setTimeSystem(fileTimeSystem);
+               clkStore.setTimeSystem(fileTimeSystem);
             }
 
                // if store system has been set, and it doesn't agree, throw
-            else if(storeTimeSystem != head.timeSystem)
+            else if(storeTimeSystem != fileTimeSystem)
             {
-               InvalidRequest ir("Time system of file " + filename
-                                 + " (" + head.timeSystem.asString()
+               InvalidRequest ir("Time system of file " + pf.filename
+                                 + " (" + fileTimeSystem.asString()
                                  + ") is incompatible with store time system ("
                                  + storeTimeSystem.asString() + ").");
                GPSTK_THROW(ir);
             }
          }  // end if header time system is set
 
-            // save in FileStore
-         SP3Files.addFile(filename, head);
-
-            // read data
-         bool isC(head.version==SP3Header::SP3c);
-         bool goNext,haveP,haveV,haveEP,haveEV,predP,predC;
-         int i;
-         CommonTime ttag;
-         SatID sat;
-         SP3Data data;
-         PositionRecord prec;
-         ClockRecord crec;
+            // RINEX clock files without time system are taken as GPS
+         else if(!isSP3)
+         {
+            storeTimeSystem = TimeSystem::GPS;
+            posStore.setTimeSystem(storeTimeSystem);
+            clkStore.setTimeSystem(storeTimeSystem);
+         }
 
-         prec.Pos = prec.sigPos = prec.Vel = prec.sigVel = prec.Acc = prec.sigAcc
-            = Triple(0,0,0);
-         if(fillClockStore)
+            // save in FileStore
+         if(isSP3)
+         {
+            SP3Files.addFile(pf.filename, pf.sp3Head);
+         }
+         else
          {
-            crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
-            crec.accel = crec.sig_accel = 0.0;
+            pf.clkHead.timeSystem = storeTimeSystem;
+            clkFiles.addFile(pf.filename, pf.clkHead);
          }
 
+            // add the records, in file order
+         const FileRecords& recs(pf.recs);
+         size_t i;
          try
          {
-            haveP = haveV = haveEP = haveEV = predP = predC = false;
-            goNext = true;
+            for(i=0; i<recs.posRecs.size(); i++)
+               posStore.addPositionRecord(recs.posSats[i], recs.posTimes[i],
+                                          recs.posRecs[i]);
+            for(i=0; i<recs.clkRecs.size(); i++)
+               clkStore.addClockRecord(recs.clkSats[i], recs.clkTimes[i],
+                                       recs.clkRecs[i]);
+         }
+         catch(Exception& e)
+         {
+            e.addText("Error reading data of file " + pf.filename);
+            GPSTK_RETHROW(e);
+         }
+
+         if(pf.error)
+            std::rethrow_exception(pf.error);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Read the data records of an SP3 file, whose header has been read.
+   void SP3EphemerisStore::readSP3Records(SP3Stream& strm, const SP3Header& head,
+                                          bool fillClockStore,
+                                          FileRecords& recs) const
+      throw(Exception)
+   {
+         // read data
+      bool isC(head.version==SP3Header::SP3c);
+      bool goNext,haveP,haveV,haveEP,haveEV,predP,predC;
+      int i;
+      CommonTime ttag;
+      SatID sat;
+      SP3Data data;
+      PositionRecord prec;
+      ClockRecord crec;
+
+      prec.Pos = prec.sigPos = prec.Vel = prec.sigVel = prec.Acc = prec.sigAcc
+         = Triple(0,0,0);
+      if(fillClockStore)
+      {
+         crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
+         crec.accel = crec.sig_accel = 0.0;
+      }
 
-            while(strm >> data)
+      try
+      {
+         haveP = haveV = haveEP = haveEV = predP = predC = false;
+         goNext = true;
+
+         while(strm >> data)
+         {
+               //cout << "Read data " << data.RecType
+               //<< " at " << printTime(data.time,"%Y %m %d %H %M %S") << endl;
+
+               // The SP3 doc says that records will be in order....
+               // use while to loop twice, if necessary: as soon as a RecType is
+               // repeated, the current records are output, then the loop
+               // returns to start filling the records again.
+               //strm.dumpState();
+            if (strm.eof())
+               break;
+            
+            while(1)
             {
-                  //cout << "Read data " << data.RecType
-                  //<< " at " << printTime(data.time,"%Y %m %d %H %M %S") << endl;
-
-                  // The SP3 doc says that records will be in order....
-                  // use while to loop twice, if necessary: as soon as a RecType is
-                  // repeated, the current records are output, then the loop
-                  // returns to start filling the records again.
-                  //strm.dumpState();
-               if (strm.eof())
-                  break;
-               
-               while(1)
+               if(data.RecType == '*')
                {
-                  if(data.RecType == '*')
+                     // epoch
+                  if(haveP || haveV)
+                     goNext = false;
+                  else
                   {
-                        // epoch
-                     if(haveP || haveV)
-                        goNext = false;
-                     else
-                     {
-                        ttag = data.time;
-                        goNext = true;
-                     }
+                     ttag = data.time;
+                     goNext = true;
                   }
-                  else if(data.RecType == 'P' && !data.correlationFlag)
+               }
+               else if(data.RecType == 'P' && !data.correlationFlag)
+               {
+                     // P
+                     //cout << "P record: "; data.dump(cout); cout << endl;
+                  if(haveP)
+                     goNext = false;
+                  else
                   {
-                        // P
-                        //cout << "P record: "; data.dump(cout); cout << endl;
-                     if(haveP)
-                        goNext = false;
-                     else
+                     sat = data.sat;
+                     for(i=0; i<3; i++)
                      {
-                        sat = data.sat;
-                        for(i=0; i<3; i++)
-                        {
-                           prec.Pos[i] = data.x[i]; // km
-                           if(isC && data.sig[i]>=0)
-                              prec.sigPos[i] = ::pow(head.basePV,data.sig[i]); // mm
-                           else
-                              prec.sigPos[i] = 0.0;
-                        }
-
-                        if(fillClockStore)
-                        {
-                           crec.bias = data.clk; // microsec
-                           if(isC && data.sig[3]>=0) // picosec -> msec
-                              crec.sig_bias = ::pow(head.baseClk,data.sig[3]) * 1.e-6;
-                        }
-
-                        if(data.orbitPredFlag) predP = true;
-                        if(data.clockPredFlag) predC = true;
-
-                        haveP = true;
+                        prec.Pos[i] = data.x[i]; // km
+                        if(isC && data.sig[i]>=0)
+                           prec.sigPos[i] = ::pow(head.basePV,data.sig[i]); // mm
+                        else
+                           prec.sigPos[i] = 0.0;
                      }
-                  }
-                  else if(data.RecType == 'V' && !data.correlationFlag)
-                  {
-                        // V
-                        //cout << "V record: "; data.dump(cout); cout << endl;
-                     if(haveV)
-                        goNext = false;
-                     else
+
+                     if(fillClockStore)
                      {
-                        for(i=0; i<3; i++)
-                        {
-                           prec.Vel[i] = data.x[i]; // dm/s
-                           if(isC && data.sig[i]>=0)
-                              prec.sigVel[i] =
-                                 ::pow(head.basePV,data.sig[i]);  // 10-4mm/s
-                           else
-                              prec.sigVel[i] = 0.0;
-                        }
-
-                        if(fillClockStore)
-                        {
-                           crec.drift = data.clk * 1.e-4; // 10-4micros/s -> micors/s
-                           if(isC && data.sig[3]>=0)      // 10-4picos/s  -> micros/s
-                              crec.sig_drift = ::pow(head.baseClk,data.sig[3])*1.e-10;
-                        }
-
-                        if(data.orbitPredFlag)
-                           predP = true;
-                        if(data.clockPredFlag)
-                           predC = true;
-
-                        haveV = true;
+                        crec.bias = data.clk; // microsec
+                        if(isC && data.sig[3]>=0) // picosec -> msec
+                           crec.sig_bias = ::pow(head.baseClk,data.sig[3]) * 1.e-6;
                      }
-                  }
-                  else if(data.RecType == 'P' && data.correlationFlag)
-                  {
-                        // EP
-                        //cout << "EP record: "; data.dump(cout); cout << endl;
-                     if(haveEP)
-                        goNext = false;
-                     else
-                     {
-                        for(i=0; i<3; i++)
-                           prec.sigPos[i] = data.sdev[i];
-                        if(fillClockStore)
-                           crec.sig_bias = data.sdev[3] * 1.e-6;// picosec -> microsec
 
-                        if(data.orbitPredFlag) predP = true;
-                        if(data.clockPredFlag) predC = true;
+                     if(data.orbitPredFlag) predP = true;
+                     if(data.clockPredFlag) predC = true;
 
-                        haveEP = true;
-                     }
+                     haveP = true;
                   }
-                  else if(data.RecType == 'V' && data.correlationFlag)
+               }
+               else if(data.RecType == 'V' && !data.correlationFlag)
+               {
+                     // V
+                     //cout << "V record: "; data.dump(cout); cout << endl;
+                  if(haveV)
+                     goNext = false;
+                  else
                   {
-                        // EV
-                        //cout << "EV record: "; data.dump(cout); cout << endl;
-                     if(haveEV)
-                        goNext = false;
-                     else
+                     for(i=0; i<3; i++)
                      {
-                        for(i=0; i<3; i++)
-                           prec.sigVel[i] = data.sdev[i]; // 10-4mm/s
+                        prec.Vel[i] = data.x[i]; // dm/s
+                        if(isC && data.sig[i]>=0)
+                           prec.sigVel[i] =
+                              ::pow(head.basePV,data.sig[i]);  // 10-4mm/s
+                        else
+                           prec.sigVel[i] = 0.0;
+                     }
 
-                        if(fillClockStore)
-                           crec.sig_drift = data.sdev[3]*1.0e-10;// 10-4ps/s->micros/s
+                     if(fillClockStore)
+                     {
+                        crec.drift = data.clk * 1.e-4; // 10-4micros/s -> micors/s
+                        if(isC && data.sig[3]>=0)      // 10-4picos/s  -> micros/s
+                           crec.sig_drift = ::pow(head.baseClk,data.sig[3])*1.e-10;
+                     }
 
-                        if(data.orbitPredFlag)
-                           predP = true;
-                        if(data.clockPredFlag)
-                           predC = true;
+                     if(data.orbitPredFlag)
+                        predP = true;
+                     if(data.clockPredFlag)
+                        predC = true;
 
-                        haveEV = true;
-                     }
+                     haveV = true;
                   }
+               }
+               else if(data.RecType == 'P' && data.correlationFlag)
+               {
+                     // EP
+                     //cout << "EP record: "; data.dump(cout); cout << endl;
+                  if(haveEP)
+                     goNext = false;
                   else
                   {
-                        //cout << "other record (" << data.RecType << "):\n";
-                        //data.dump(cout); cout << endl;
-                        //throw?
-                     goNext = true;
-                  }
+                     for(i=0; i<3; i++)
+                        prec.sigPos[i] = data.sdev[i];
+                     if(fillClockStore)
+                        crec.sig_bias = data.sdev[3] * 1.e-6;// picosec -> microsec
 
-                     //cout << "goNext is " << (goNext ? "T":"F") << endl;
-                  if(goNext)
-                     break;
+                     if(data.orbitPredFlag) predP = true;
+                     if(data.clockPredFlag) predC = true;
 
-                  if(rejectBadPosFlag &&
-                     (prec.Pos[0]==0.0 ||
-                      prec.Pos[1]==0.0 ||
-                      prec.Pos[2]==0.0))
-                  {
-                        //cout << "Bad position" << endl;
-                     haveP = haveV = haveEV = haveEP = false; // bad position record
-                  }
-                  else if(fillClockStore && rejectBadClockFlag
-                          && crec.bias >= 999999.)
-                  {
-                        //cout << "Bad clock" << endl;
-                     haveP = haveV = haveEV = haveEP = false; // bad clock record
+                     haveEP = true;
                   }
+               }
+               else if(data.RecType == 'V' && data.correlationFlag)
+               {
+                     // EV
+                     //cout << "EV record: "; data.dump(cout); cout << endl;
+                  if(haveEV)
+                     goNext = false;
                   else
                   {
-                        //cout << "Add rec: " << sat << " " << ttag << " " << prec<<endl;
-                     if(!rejectPredPosFlag || !predP)
-                        posStore.addPositionRecord(sat,ttag,prec);
-                     if(fillClockStore && (!rejectPredClockFlag || !predC))
-                        clkStore.addClockRecord(sat,ttag,crec);
-
-                        // prepare for next
-                     haveP = haveV = haveEP = haveEV = predP = predC = false;
-                     prec.Pos = prec.Vel = prec.sigPos = prec.sigVel = Triple(0,0,0);
+                     for(i=0; i<3; i++)
+                        prec.sigVel[i] = data.sdev[i]; // 10-4mm/s
+
                      if(fillClockStore)
-                        crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
-                  }
+                        crec.sig_drift = data.sdev[3]*1.0e-10;// 10-4ps/s->micros/s
+
+                     if(data.orbitPredFlag)
+                        predP = true;
+                     if(data.clockPredFlag)
+                        predC = true;
 
+                     haveEV = true;
+                  }
+               }
+               else
+               {
+                     //cout << "other record (" << data.RecType << "):\n";
+                     //data.dump(cout); cout << endl;
+                     //throw?
                   goNext = true;
+               }
 
-               }  // end while loop (loop twice)
-            }  // end read loop
+                  //cout << "goNext is " << (goNext ? "T":"F") << endl;
+               if(goNext)
+                  break;
 
-            if(haveP || haveV)
-            {
                if(rejectBadPosFlag &&
                   (prec.Pos[0]==0.0 ||
                    prec.Pos[1]==0.0 ||
-                   prec.Pos[2]==0.0) )
+                   prec.Pos[2]==0.0))
                {
-                     //cout << "Bad last rec: position" << endl;
-                  ;
+                     //cout << "Bad position" << endl;
+                  haveP = haveV = haveEV = haveEP = false; // bad position record
                }
-               else if(fillClockStore && rejectBadClockFlag && crec.bias >= 999999.)
+               else if(fillClockStore && rejectBadClockFlag
+                       && crec.bias >= 999999.)
                {
-                     //cout << "Bad last rec: clock" << endl;
-                  ;
+                     //cout << "Bad clock" << endl;
+                  haveP = haveV = haveEV = haveEP = false; // bad clock record
                }
                else
                {
-                     //cout << "Add last rec: "<< sat <<" "<< ttag <<" "<< prec << endl;
+                     //cout << "Add rec: " << sat << " " << ttag << " " << prec<<endl;
                   if(!rejectPredPosFlag || !predP)
-                     posStore.addPositionRecord(sat,ttag,prec);
+                  {
+                     recs.addPosition(sat,ttag,prec);
+                  }
                   if(fillClockStore && (!rejectPredClockFlag || !predC))
-                     clkStore.addClockRecord(sat,ttag,crec);
+                  {
+                     recs.addClock(sat,ttag,crec);
+                  }
+
+                     // prepare for next
+                  haveP = haveV = haveEP = haveEV = predP = predC = false;
+                  prec.Pos = prec.Vel = prec.sigPos = prec.sigVel = Triple(0,0,0);
+                  if(fillClockStore)
+                     crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
                }
-            }
-         }
-         catch(Exception& e)
-         {
-            e.addText("Error reading data of file " + filename);
-            GPSTK_RETHROW(e);
-         }
 
-            // close
-         strm.close();
+               goNext = true;
+
+            }  // end while loop (loop twice)
+         }  // end read loop
 
+         if(haveP || haveV)
+         {
+            if(rejectBadPosFlag &&
+               (prec.Pos[0]==0.0 ||
+                prec.Pos[1]==0.0 ||
+                prec.Pos[2]==0.0) )
+            {
+                  //cout << "Bad last rec: position" << endl;
+               ;
+            }
+            else if(fillClockStore && rejectBadClockFlag && crec.bias >= 999999.)
+            {
+                  //cout << "Bad last rec: clock" << endl;
+               ;
+            }
+            else
+            {
+                  //cout << "Add last rec: "<< sat <<" "<< ttag <<" "<< prec << endl;
+               if(!rejectPredPosFlag || !predP)
+               {
+                  recs.addPosition(sat,ttag,prec);
+               }
+               if(fillClockStore && (!rejectPredClockFlag || !predC))
+               {
+                  recs.addClock(sat,ttag,crec);
+               }
+            }
+         }
       }
-      catch (Exception& e)
+      catch(Exception& e)
       {
          GPSTK_RETHROW(e);
       }
-      catch (std::exception& e)
-      {
-         gpstk::Exception exc("std::exception " + std::string(e.what()));
-         GPSTK_THROW(exc);
-      }
-      catch (...)
-      {
-         gpstk::Exception exc("Unknown exception");
-         GPSTK_THROW(exc);
-      }
    }
 
       // Load an SP3 ephemeris file; if the clock store uses RINEX clock files,
@@ -551,40 +743,13 @@ namespace gpstk
    {
       try
       {
-            // if using only SP3, simply read the SP3
-         if(useSP3clock)
-         {
-            loadSP3Store(filename, true);
-            return;
-         }
-
-            // must determine what kind of file it is
-         bool isSP3 = true;
-
-            // decide if the file is SP3
-         SP3Stream strm(filename.c_str(),std::ios::in);
-         if (strm)
-         {
-               // read the header
-            SP3Header header;
-            strm >> header;
-         }
-         if (!strm)
-         {
-            isSP3 = false;
-         }
-         strm.close();
-
-            // call the appropriate load routine
-         if(isSP3)
-         {
-            loadSP3File(filename);
-         }
-         else
-         {
-            loadRinexClockFile(filename);
-         }
-
+            // if using only SP3, simply read the SP3; otherwise the kind of
+            // file is determined when reading it
+         ProductFile pf(filename,
+                        (useSP3clock ? ProductFile::SP3 : ProductFile::Unknown),
+                        useSP3clock);
+         readProductFile(pf);
+         addProductFile(pf);
       }
       catch(Exception& e)
       {
@@ -615,100 +780,184 @@ namespace gpstk
       {
          if(useSP3clock) useRinexClockData();
 
-            // open the input stream
-         Rinex3ClockStream strm(filename.c_str());
-         if(!strm.is_open())
-         {
-            Exception e("File " + filename + " could not be opened");
-            GPSTK_THROW(e);
-         }
-         strm.exceptions(std::ios::failbit);
-            //cout << "Opened file " << filename << endl;
+         ProductFile pf(filename, ProductFile::RinexClock, false);
+         readProductFile(pf);
+         addProductFile(pf);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
 
-            // declare header and data
-         Rinex3ClockHeader head;
-         Rinex3ClockData data;
+      // Load several SP3 (and RINEX clock) files, parsing them concurrently,
+      // then adding them to the store in the order given.
+   void SP3EphemerisStore::loadFiles(const vector<string>& filenames,
+                                     int numThreads)
+      throw(Exception)
+   {
+      try
+      {
+         size_t i;
+         vector<ProductFile> files;
+         files.reserve(filenames.size());
+         for(i=0; i<filenames.size(); i++)
+            files.push_back(ProductFile(filenames[i],
+                                        (useSP3clock ? ProductFile::SP3
+                                                     : ProductFile::Unknown),
+                                        useSP3clock));
+
+         if(numThreads < 1)
+            numThreads = std::thread::hardware_concurrency();
+         if(static_cast<size_t>(numThreads) > files.size())
+            numThreads = static_cast<int>(files.size());
+
+            // Each thread takes the next file nobody has taken, and reads it
+            // into its own ProductFile; readProductFile() does not change the
+            // store, so no locking is needed.
+         std::atomic<size_t> next(0);
+         auto work = [this, &files, &next]()
+         {
+            size_t j;
+            while((j = next++) < files.size())
+               readProductFile(files[j]);
+         };
 
-            // read the RINEX clock header
-         try
+         vector<std::thread> workers;
+         for(int t=1; t<numThreads; t++)
          {
-            strm >> head;
+            try { workers.push_back(std::thread(work)); }
+            catch(std::exception&) { break; }     // go on with fewer threads
          }
-         catch(Exception& e)
+         work();
+         for(i=0; i<workers.size(); i++)
+            workers[i].join();
+
+            // add to the store in the order given, so that overlapping files
+            // and errors are handled as loadFile() would
+         for(i=0; i<files.size(); i++)
          {
-            e.addText("Error reading header of file " + filename);
-            GPSTK_RETHROW(e);
+            addProductFile(files[i]);
+            files[i].recs = FileRecords();
          }
-            //cout << "Read header" << endl; head.dump();
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
 
-            // check/save TimeSystem to storeTimeSystem
-         if(head.timeSystem != TimeSystem::Any &&
-            head.timeSystem != TimeSystem::Unknown)
+      // Read the data records of the product cache entry of a file, if there is
+      // a matching entry. Return false if the file must be parsed.
+   bool SP3EphemerisStore::readCachedRecords(const string& filename,
+                                             const string& kind,
+                                             FileRecords& recs) const
+      throw()
+   {
+      try
+      {
+         ProductCache cache;
+         if(!cache.openEntry(filename, kind))
+            return false;
+
+         size_t i,n;
+         double d[18];
+
+         n = cache.getCount(8+28+18*8);
+         recs.posSats.resize(n);
+         recs.posTimes.resize(n);
+         recs.posRecs.resize(n);
+         for(i=0; i<n && cache.good(); i++)
          {
-               // if store time system has not been set, do so
-            if(storeTimeSystem == TimeSystem::Any)
-            {
-                  // NB. store-, pos- and clk- TimeSystems must always be the same
-               storeTimeSystem = head.timeSystem;
-               posStore.setTimeSystem(head.timeSystem);
-               clkStore.setTimeSystem(head.timeSystem);
-            }
-
-               // if store system has been set, and it doesn't agree, throw
-            else if(storeTimeSystem != head.timeSystem)
-            {
-               InvalidRequest ir("Time system of file " + filename
-                                 + " (" + head.timeSystem.asString()
-                                 + ") is incompatible with store time system ("
-                                 + storeTimeSystem.asString() + ").");
-               GPSTK_THROW(ir);
-            }
-         }  // end if header time system is set
+            PositionRecord& prec(recs.posRecs[i]);
+            cache.getSatID(recs.posSats[i]);
+            cache.getTime(recs.posTimes[i]);
+            for(int j=0; j<18; j++)
+               cache.getData(d[j]);
+            prec.Pos    = Triple(d[0],  d[1],  d[2]);
+            prec.sigPos = Triple(d[3],  d[4],  d[5]);
+            prec.Vel    = Triple(d[6],  d[7],  d[8]);
+            prec.sigVel = Triple(d[9],  d[10], d[11]);
+            prec.Acc    = Triple(d[12], d[13], d[14]);
+            prec.sigAcc = Triple(d[15], d[16], d[17]);
+         }
 
-            // there is no way to determine the time system....this is a problem TD
-            // TD SP3EphemerisStore::fixTimeSystem() ??
-         else
+         n = cache.getCount(8+28+6*8);
+         recs.clkSats.resize(n);
+         recs.clkTimes.resize(n);
+         recs.clkRecs.resize(n);
+         for(i=0; i<n && cache.good(); i++)
          {
-            head.timeSystem = TimeSystem::GPS;
-            storeTimeSystem = head.timeSystem;
-            posStore.setTimeSystem(head.timeSystem);
-            clkStore.setTimeSystem(head.timeSystem);
+            ClockRecord& crec(recs.clkRecs[i]);
+            cache.getSatID(recs.clkSats[i]);
+            cache.getTime(recs.clkTimes[i]);
+            cache.getData(crec.bias);
+            cache.getData(crec.sig_bias);
+            cache.getData(crec.drift);
+            cache.getData(crec.sig_drift);
+            cache.getData(crec.accel);
+            cache.getData(crec.sig_accel);
          }
 
-            // save in FileStore
-         clkFiles.addFile(filename, head);
+         if(cache.good())
+            return true;
+      }
+      catch(...)
+      {
+      }
 
-            // read data
-         try
-         {
-            while(strm >> data)
-            {
-                  //data.dump(cout);
+         // a bad entry is ignored, and the file parsed
+      recs.clear();
+      return false;
+   }
 
-               if(data.datatype == std::string("AS"))
-               {
-                  data.time.setTimeSystem(head.timeSystem);
-                     // add this data
-                  ClockRecord rec;
-                  rec.bias = data.bias; rec.sig_bias = data.sig_bias,
-                                           rec.drift = data.drift; rec.sig_drift = data.sig_drift,
-                                                                      rec.accel = data.accel; rec.sig_accel = data.sig_accel;
-                  clkStore.addClockRecord(data.sat, data.time, rec);
-               }
-            }
-         }
-         catch(Exception& e)
+      // Write the records added to the stores by loading a file to the product
+      // cache. Errors are ignored.
+   void SP3EphemerisStore::saveCachedRecords(const string& filename,
+                                             const string& kind,
+                                             const FileRecords& recs) const
+      throw()
+   {
+      try
+      {
+         ProductCache cache;
+         if(!cache.createEntry(filename, kind))
+            return;
+
+         size_t i;
+         cache.writeCount(recs.posRecs.size());
+         for(i=0; i<recs.posRecs.size(); i++)
          {
-            e.addText("Error reading data of file " + filename);
-            GPSTK_RETHROW(e);
+            const PositionRecord& rec(recs.posRecs[i]);
+            cache.writeSatID(recs.posSats[i]);
+            cache.writeTime(recs.posTimes[i]);
+            cache.writeTriple(rec.Pos);
+            cache.writeTriple(rec.sigPos);
+            cache.writeTriple(rec.Vel);
+            cache.writeTriple(rec.sigVel);
+            cache.writeTriple(rec.Acc);
+            cache.writeTriple(rec.sigAcc);
          }
 
-         strm.close();
+         cache.writeCount(recs.clkRecs.size());
+         for(i=0; i<recs.clkRecs.size(); i++)
+         {
+            const ClockRecord& rec(recs.clkRecs[i]);
+            cache.writeSatID(recs.clkSats[i]);
+            cache.writeTime(recs.clkTimes[i]);
+            cache.writeData(rec.bias);
+            cache.writeData(rec.sig_bias);
+            cache.writeData(rec.drift);
+            cache.writeData(rec.sig_drift);
+            cache.writeData(rec.accel);
+            cache.writeData(rec.sig_accel);
+         }
 
+         cache.commitEntry();
       }
-      catch(Exception& e)
+      catch(...)
       {
-         GPSTK_RETHROW(e);
+            // the entry is discarded by the ProductCache destructor
       }
    }
 
@@ -49,6 +49,7 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <exception>
 
 #include "Exception.hpp"
 #include "SatID.hpp"
@@ -64,6 +65,8 @@
 
 namespace gpstk
 {
+   class SP3Stream;
+
       /// @ingroup GNSSEph
       //@{
 
@@ -132,6 +135,100 @@ namespace gpstk
       void loadSP3Store(const std::string& filename, bool fillClockStore)
          throw(Exception);
 
+         /** Records added to the position and clock stores by loading
+          * one file, in file order. They are kept in the product cache
+          * (see ProductCache), and used by loadFiles() to parse files
+          * concurrently. */
+      struct FileRecords
+      {
+         std::vector<SatID> posSats, clkSats;
+         std::vector<CommonTime> posTimes, clkTimes;
+         std::vector<PositionRecord> posRecs;
+         std::vector<ClockRecord> clkRecs;
+
+         void addPosition(const SatID& sat, const CommonTime& ttag,
+                          const PositionRecord& rec)
+         { posSats.push_back(sat); posTimes.push_back(ttag);
+           posRecs.push_back(rec); }
+
+         void addClock(const SatID& sat, const CommonTime& ttag,
+                       const ClockRecord& rec)
+         { clkSats.push_back(sat); clkTimes.push_back(ttag);
+           clkRecs.push_back(rec); }
+
+         void clear()
+         { posSats.clear(); posTimes.clear(); posRecs.clear();
+           clkSats.clear(); clkTimes.clear(); clkRecs.clear(); }
+      };
+
+         /** One input file, read by readProductFile() without changing
+          * the store and then added to it by addProductFile(). */
+      struct ProductFile
+      {
+            /// Format of the file
+         enum Format { Unknown, SP3, RinexClock };
+
+         ProductFile(const std::string& fn, Format fmt, bool fill)
+               : filename(fn), format(fmt), fillClockStore(fill),
+                 haveHeader(false)
+         {}
+
+         std::string filename;
+            /// Format; Unknown means that it must be determined
+         Format format;
+            /// Whether SP3 clock data goes to the clock store
+         bool fillClockStore;
+            /// Whether the header has been read
+         bool haveHeader;
+         SP3Header sp3Head;
+         Rinex3ClockHeader clkHead;
+            /// Data records read, even when reading fails midway
+         FileRecords recs;
+            /// Error raised while reading the file, if any
+         std::exception_ptr error;
+      };
+
+         /** Read the header and the data records of a file, using the
+          * product cache if enabled. Errors are kept in the
+          * ProductFile. This does not change the store, so several
+          * files can be read concurrently. */
+      void readProductFile(ProductFile& pf) const throw();
+
+         /** Add a file read by readProductFile() to the file and
+          * data stores: check the time system, add the header and the
+          * records, then throw the error raised while reading, if any.
+          * This gives the same result as loading the file directly. */
+      void addProductFile(ProductFile& pf) throw(Exception);
+
+         /** Read the data records of an SP3 file, whose header has
+          * been read, into a FileRecords. */
+      void readSP3Records(SP3Stream& strm, const SP3Header& head,
+                          bool fillClockStore, FileRecords& recs) const
+         throw(Exception);
+
+         /** Read the data records of the product cache entry of a
+          * file, if there is a matching entry.
+          * @param filename name of the file
+          * @param kind format and options of the entry
+          * @param recs records of the file; empty unless the whole
+          *   entry was read
+          * @return true if the records were read, false if the file
+          *   must be parsed. */
+      bool readCachedRecords(const std::string& filename,
+                             const std::string& kind,
+                             FileRecords& recs) const
+         throw();
+
+         /** Write the records added to the stores by loading a file to
+          * the product cache. Errors are ignored.
+          * @param filename name of the file
+          * @param kind format and options of the entry
+          * @param recs records added by the file */
+      void saveCachedRecords(const std::string& filename,
+                             const std::string& kind,
+                             const FileRecords& recs) const
+         throw();
+
    public:
 
          /// Default constructor
@@ -534,6 +631,10 @@ namespace gpstk
           * and load the data into the clock store. This routine will
           * may set the velocity, acceleration, bias or drift 'have'
           * flags.
+          * @note If the product cache is enabled (see ProductCache),
+          * the data of a file already loaded by an earlier run, with
+          * the same reject options, is read from the cache instead of
+          * being parsed; the header is still read from the file.
           * @param filename name of file (SP3 or RINEX clock format) to load 
           * @throw if time step is inconsistent with previous value */
       void loadFile(const std::string& filename) throw(Exception);
@@ -552,6 +653,25 @@ namespace gpstk
           * @throw if time step is inconsistent with previous value */
       void loadRinexClockFile(const std::string& filename) throw(Exception);
 
+         /** Load several SP3 (and, if the clock store uses RINEX
+          * clock files, RINEX clock) files, parsing them concurrently.
+          * Each thread parses whole files into separate record
+          * buffers, without locking; the buffers are then added to
+          * the store one file at a time, in the order given. Records
+          * of overlapping files, and errors, are thus handled exactly
+          * as calling loadFile() for each file in turn would: the
+          * reject options apply within each file, a later file
+          * replaces the records of an earlier one at the same time,
+          * and the first file that fails stops loading with its
+          * exception, after the files before it have been added.
+          * @param filenames names of the files to load, in order
+          * @param numThreads number of threads to use; 0 means one per
+          *   hardware thread
+          * @throw if time step is inconsistent with previous value */
+      void loadFiles(const std::vector<std::string>& filenames,
+                     int numThreads = 0)
+         throw(Exception);
+
 
          /** Add a complete PositionRecord to the store; this is the
           * preferred method of adding data to the tables.
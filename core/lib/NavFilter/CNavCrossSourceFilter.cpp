@@ -3,104 +3,45 @@
 namespace gpstk
 {
    CNavCrossSourceFilter ::
-   CNavCrossSourceFilter() : minIdentical(2)
+   CNavCrossSourceFilter()
+         : minIdentical(2)
    {
    }
 
-   void CNavCrossSourceFilter ::
-   validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   size_t CNavCrossSourceFilter ::
+   hashMessage(const CNavFilterData *fd) const
    {
-      NavMsgList::const_iterator nmli;
-      for (nmli = msgBitsIn.begin(); nmli != msgBitsIn.end(); nmli++)
-      {
-         CNavFilterData *fd = dynamic_cast<CNavFilterData*>(*nmli);
-         if (fd->timeStamp != currentTime)
-         {
-               // different time, so check out what we have
-            examineMessages(msgBitsOut);
-            groupedNav.clear();
-            currentTime = fd->timeStamp;
-         }
-            // add the message to our collection
-         groupedNav[fd->prn][fd].push_back(*nmli);
-      }
+      uint64_t h = fd->pnb->hashBits();
+      h ^= fd->prn * 0x9e3779b97f4a7c15ULL;
+      h ^= h >> 29;
+      return (size_t)h;
    }
 
-   void CNavCrossSourceFilter ::
-   finalize(NavMsgList& msgBitsOut)
+   bool CNavCrossSourceFilter ::
+   sameBits(const CNavFilterData *l, const CNavFilterData *r) const
    {
-      examineMessages(msgBitsOut);
-      groupedNav.clear();
-      currentTime.reset();
-   }
-
-   void CNavCrossSourceFilter ::
-   examineMessages(NavMsgList& msgBitsOut)
-   {
-      NavMap::const_iterator nmi;
-      MessageMap::const_iterator smi;
-         // loop over each PRN/SV
-      for (nmi = groupedNav.begin(); nmi != groupedNav.end(); nmi++)
-      {
-            // count of unique messages
-         size_t uniqueBits = nmi->second.size();
-            // count of total messages
-         size_t msgCount = 0;
-            // store the vote winner here
-         CNavFilterData *winner = NULL;
-            // store the largest number of "votes" for a subframe here
-         size_t voteCount = 0;
-         for (smi = nmi->second.begin(); smi != nmi->second.end(); smi++)
-         {
-            size_t msgs = smi->second.size();
-            msgCount += msgs;
-               // minimum # of useful votes
-            if ((msgs > voteCount) && (msgs >= minIdentical))
-            {
-               voteCount = msgs;
-               winner = smi->first;
-            }
-         }
-         if (msgCount < minIdentical)
-            winner = NULL; // not enough messages to have a useful vote
-
-            // If winner is NULL, i.e. there is no winner, all
-            // messages will be rejected below.  Otherwise only the
-            // winners will be accepted.
-         for (smi = nmi->second.begin(); smi != nmi->second.end(); smi++)
-         {
-            if (smi->first == winner)
-               accept(smi->second, msgBitsOut);
-            else
-               reject(smi->second);
-         }
-      }
+      return !(*(l->pnb) < *(r->pnb)) && !(*(r->pnb) < *(l->pnb));
    }
 
    void CNavCrossSourceFilter::
    dump(std::ostream& s) const
    {
       s << "#--------------------------------" << std::endl;
-      s << "  Dump of CNavCrossSourceFilter::NavMap" << std::endl; 
-      NavMap::const_iterator cit;
-      for (cit=groupedNav.begin(); cit!=groupedNav.end(); cit++)
+      s << "  Dump of CNavCrossSourceFilter groups" << std::endl; 
+      std::vector<size_t> order(sortGroups(false));
+      for (size_t i = 0; i < order.size(); i++)
       {
-         s << "PRN " << std::setw(2) << (unsigned short) cit->first << std::endl;
-
-         const MessageMap& mm = cit->second;
-         MessageMap::const_iterator cit2;
-         for (cit2=mm.begin(); cit2!=mm.end(); cit2++)
+         const MessageGroup& grp = groups[order[i]];
+         if ((i == 0) || (groups[order[i-1]].prn != grp.prn))
+            s << "PRN " << std::setw(2) << (unsigned short) grp.prn << std::endl;
+
+         const CNavFilterData* cfdp = grp.key;
+         s << "  Key  ptr: " << cfdp << ": " << *cfdp << std::endl;
+         NavMsgList::const_iterator cit3;
+         for (cit3=grp.msgs.begin(); cit3!=grp.msgs.end(); cit3++)
          {
-            const CNavFilterData* cfdp = cit2->first;
-            const NavMsgList& nml = cit2->second;
-
-            s << "  Key  ptr: " << cfdp << ": " << *cfdp << std::endl;
-            NavMsgList::const_iterator cit3;
-            for (cit3=nml.begin(); cit3!=nml.end(); cit3++)
-            {
-               const NavFilterKey* nfkp = *cit3;
-               s << "       ptr: " << nfkp << ": " << *nfkp  << std::endl; 
-            }
+            const NavFilterKey* nfkp = *cit3;
+            s << "       ptr: " << nfkp << ": " << *nfkp  << std::endl; 
          }
       }
    }
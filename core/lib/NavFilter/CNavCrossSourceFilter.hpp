@@ -2,7 +2,7 @@
 #define CNAVCROSSOURCEFILTER_HPP
 
 #include <NavFilterMgr.hpp>
-#include <NavFilter.hpp>
+#include <NavCrossSourceFilter.hpp>
 #include <CNavFilterData.hpp>
 
 namespace gpstk
@@ -16,29 +16,12 @@ namespace gpstk
        * multiple receivers (with or without multiple codes).
        *
        * @attention Processing depth = 2 epochs. */
-   class CNavCrossSourceFilter : public NavFilter
+   class CNavCrossSourceFilter
+      : public NavCrossSourceFilter<CNavFilterData, CNavMsgSort>
    {
    public:
       CNavCrossSourceFilter();
 
-         /** Add LNAV messages to the voting collection (groupedNav).
-          * @pre NavFilterKey::timeStamp is set to either the the 
-          * time of transmission of the message/
-          * @pre NavFilterKey::prn is set
-          * @pre CNavFilterData::sf is set
-          * @param[in,out] msgBitsIn A list of CNavFilterData* objects
-          *   containing GPS CNAV messages.
-          * @param[out] msgBitsOut The messages successfully passing
-          *   the filter.  The contents of msgBitsOut will always be
-          *   one epoch behind msgBitsIn (meaning data from previous,
-          *   but not current calls to validate will be here). */
-      virtual void validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut);
-
-         /** Flush the remaining contents of groupedNav.
-          * @param[out] msgBitsOut Any remaining valid (by vote) nav
-          *   messages are stored here on return. */
-      virtual void finalize(NavMsgList& msgBitsOut);
-
       virtual void setMinIdentical(const unsigned value)
       { minIdentical = value;}
 
@@ -53,25 +36,20 @@ namespace gpstk
       virtual void dump(std::ostream& s) const;
 
    protected:
-         /// Map from subframe data to source list
-      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort> MessageMap;
-         /// Map from PRN to SubframeMap
-      typedef std::map<uint32_t, MessageMap> NavMap;
+         /// Hash of the message bits and PRN of fd.
+      virtual size_t hashMessage(const CNavFilterData *fd) const;
 
-         /// Nav subframes grouped by prn and unique nav bits
-      NavMap groupedNav;
-         /// Most recent time
-      gpstk::CommonTime currentTime;
+         /// Return true if both messages hold the same bits.
+      virtual bool sameBits(const CNavFilterData *l, const CNavFilterData *r)
+         const;
 
+         /// minIdentical identical messages are needed to win a vote.
+      virtual size_t minVotes() const
+      { return minIdentical; }
 
-         /** Filter by vote.
-          * @note Bare minimum for producing output is 2 out of 2
-          *   matching subframes.  If there are no matching subframes,
-          *   or fewer than 2 subframes are present in groupedNav, no
-          *   output will be produced.
-          * @param[out] msgBitsOut Nav messages passing the voting
-          *   algorithm are stored here. */
-      void examineMessages(NavMsgList& msgBitsOut);
+         /// minIdentical messages are needed for a PRN to vote.
+      virtual size_t minMessages() const
+      { return minIdentical; }
    };
 
       //@}
@@ -7,73 +7,27 @@ namespace gpstk
    {
    }
 
-   void LNavCrossSourceFilter ::
-   validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   size_t LNavCrossSourceFilter ::
+   hashMessage(const LNavFilterData *fd) const
    {
-      NavMsgList::const_iterator nmli;
-      for (nmli = msgBitsIn.begin(); nmli != msgBitsIn.end(); nmli++)
+      uint64_t h = fd->prn * 0x9e3779b97f4a7c15ULL;
+      for (unsigned sfword = 0; sfword < 10; sfword++)
       {
-         LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*nmli);
-         if (fd->timeStamp != currentTime)
-         {
-               // different time, so check out what we have
-            examineSubframes(msgBitsOut);
-            groupedNav.clear();
-            currentTime = fd->timeStamp;
-         }
-            // add the subframe to our collection
-         groupedNav[fd->prn][fd].push_back(*nmli);
+         h ^= fd->sf[sfword];
+         h *= 0x100000001b3ULL;
+         h ^= h >> 29;
       }
+      return (size_t)h;
    }
 
-   void LNavCrossSourceFilter ::
-   finalize(NavMsgList& msgBitsOut)
+   bool LNavCrossSourceFilter ::
+   sameBits(const LNavFilterData *l, const LNavFilterData *r) const
    {
-      examineSubframes(msgBitsOut);
-      groupedNav.clear();
-      currentTime.reset();
-   }
-
-   void LNavCrossSourceFilter ::
-   examineSubframes(NavMsgList& msgBitsOut)
-   {
-      NavMap::const_iterator nmi;
-      SubframeMap::const_iterator smi;
-         // loop over each PRN/SV
-      for (nmi = groupedNav.begin(); nmi != groupedNav.end(); nmi++)
+      for (unsigned sfword = 0; sfword < 10; sfword++)
       {
-            // count of unique messages
-         size_t uniqueBits = nmi->second.size();
-            // count of total messages
-         size_t msgCount = 0;
-            // store the vote winner here
-         LNavFilterData *winner = NULL;
-            // store the largest number of "votes" for a subframe here
-         size_t voteCount = 0;
-         for (smi = nmi->second.begin(); smi != nmi->second.end(); smi++)
-         {
-            size_t msgs = smi->second.size();
-            msgCount += msgs;
-               // minimum # of useful votes
-            if ((msgs > voteCount) && (msgs >= 2))
-            {
-               voteCount = msgs;
-               winner = smi->first;
-            }
-         }
-         if (msgCount < 3)
-            winner = NULL; // not enough messages to have a useful vote
-
-            // If winner is NULL, i.e. there is no winner, all
-            // messages will be rejected below.  Otherwise only the
-            // winners will be accepted.
-         for (smi = nmi->second.begin(); smi != nmi->second.end(); smi++)
-         {
-            if (smi->first == winner)
-               accept(smi->second, msgBitsOut);
-            else
-               reject(smi->second);
-         }
+         if (l->sf[sfword] != r->sf[sfword])
+            return false;
       }
+      return true;
    }
 }
@@ -0,0 +1,363 @@
+#ifndef NAVCROSSSOURCEFILTER_HPP
+#define NAVCROSSSOURCEFILTER_HPP
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <NavFilter.hpp>
+#include <CommonTime.hpp>
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Voting algorithm shared by the cross-source filters
+       * (LNavCrossSourceFilter and CNavCrossSourceFilter).  Messages
+       * of a single epoch are hashed once, over their bits and PRN,
+       * and grouped in an open addressing table so that full
+       * comparisons only happen when the hashes match.  The group
+       * with the most identical messages for a PRN wins the vote.
+       *
+       * Derived classes define how the message bits are hashed and
+       * compared, and how many messages a vote needs.
+       *
+       * @param FilterData The NavFilterKey class holding the messages.
+       * @param MsgSort Orders FilterData pointers by message bits,
+       *   which breaks ties between groups with the same number of
+       *   votes.
+       *
+       * @attention Processing depth = 2 epochs. */
+   template <class FilterData, class MsgSort>
+   class NavCrossSourceFilter : public NavFilter
+   {
+   public:
+      NavCrossSourceFilter();
+
+         /** Add messages to the voting collection.
+          * @pre NavFilterKey::timeStamp is set to the time of the
+          *   message (e.g. the time of transmission).
+          * @pre NavFilterKey::prn is set
+          * @param[in,out] msgBitsIn A list of FilterData* objects
+          *   containing navigation messages.
+          * @param[out] msgBitsOut The messages successfully passing
+          *   the filter.  The contents of msgBitsOut will always be
+          *   one epoch behind msgBitsIn (meaning data from previous,
+          *   but not current calls to validate will be here), unless
+          *   an early quorum is set (see setEarlyQuorum()). */
+      virtual void validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut);
+
+         /** Flush the remaining contents of the voting collection.
+          * @param[out] msgBitsOut Any remaining valid (by vote) nav
+          *   messages are stored here on return. */
+      virtual void finalize(NavMsgList& msgBitsOut);
+
+         /** Set the latency budget of the vote.  By default (0) the
+          * vote for an epoch is held until data for a later epoch
+          * arrives, so that every source gets its say.  When set to
+          * n, the vote for a PRN is decided as soon as n identical
+          * messages have been received, provided there are enough
+          * for a vote (see minVotes() and minMessages()): those
+          * messages are output immediately, any different messages
+          * already received are rejected, and later messages for
+          * that PRN and epoch are accepted or rejected as they
+          * arrive, according to whether they match the winner.  n
+          * should be more than half the number of sources for the
+          * result to match the full vote.
+          * @param[in] n Number of identical messages needed to
+          *   decide early, or 0 to always wait for the full vote. */
+      virtual void setEarlyQuorum(const unsigned n)
+      { earlyQuorum = n; }
+
+         /// Return the number of identical messages needed to decide early.
+      virtual unsigned getEarlyQuorum() const
+      { return earlyQuorum; }
+
+   protected:
+         /// Messages with identical bits received for a PRN.
+      struct MessageGroup
+      {
+         uint32_t prn;          ///< PRN of the messages
+         size_t hash;           ///< Hash of the message bits
+         FilterData *key;       ///< First message, used to compare bits
+         NavMsgList msgs;       ///< All messages in the group
+      };
+
+         /// Voting state of a PRN.
+      struct PRNVote
+      {
+         PRNVote() : msgCount(0), winner(-1) {}
+         size_t msgCount;       ///< Number of messages received
+         long winner;           ///< Index of the early winner, or -1
+      };
+
+         /// Orders group indices by PRN, then by MsgSort.
+      struct GroupOrder
+      {
+         GroupOrder(const std::vector<MessageGroup>& g)
+               : groups(g)
+         {}
+         bool operator()(const size_t l, const size_t r) const
+         {
+            if (groups[l].prn != groups[r].prn)
+               return groups[l].prn < groups[r].prn;
+            return MsgSort()(groups[l].key, groups[r].key);
+         }
+         const std::vector<MessageGroup>& groups;
+      };
+
+         /// Groups for the current epoch.  Only the first numGroups
+         /// are in use, the rest are kept to reuse their storage.
+      std::vector<MessageGroup> groups;
+         /// Number of groups in use.
+      size_t numGroups;
+         /// Open addressing hash table of indices into groups (-1 if
+         /// the slot is free).  The size is a power of two.
+      std::vector<long> slots;
+         /// Voting state for each PRN seen in the current epoch.
+      std::map<uint32_t, PRNVote> votes;
+         /// Most recent time
+      gpstk::CommonTime currentTime;
+         /// Identical messages needed to decide before the epoch ends.
+      unsigned earlyQuorum;
+
+         /// Hash of the message bits and PRN of fd.
+      virtual size_t hashMessage(const FilterData *fd) const = 0;
+
+         /// Return true if both messages hold the same bits.
+      virtual bool sameBits(const FilterData *l, const FilterData *r)
+         const = 0;
+
+         /// Minimum number of identical messages needed to win a vote.
+      virtual size_t minVotes() const = 0;
+
+         /// Minimum number of messages for a PRN needed to vote at all.
+      virtual size_t minMessages() const = 0;
+
+         /** Return the index of the group for fd's bits, creating
+          * one if needed. */
+      size_t findGroup(FilterData *fd, size_t hash);
+
+         /** Decide the vote for a PRN early.
+          * @param[in] win Index of the winning group.
+          * @param[out] msgBitsOut The winning messages. */
+      void decide(size_t win, NavMsgList& msgBitsOut);
+
+         /// Empty the voting collection for a new epoch.
+      void clearGroups();
+
+         /** Return the indices of the groups in use sorted by PRN
+          * and then by MsgSort.
+          * @param[in] undecided Only include PRNs not decided early. */
+      std::vector<size_t> sortGroups(bool undecided) const;
+
+         /** Filter by vote.
+          * @note Bare minimum for producing output is minVotes()
+          *   matching messages out of minMessages().  If there are
+          *   not enough matching messages, or not enough messages
+          *   are present for a PRN, no output will be produced.
+          * @param[out] msgBitsOut Nav messages passing the voting
+          *   algorithm are stored here. */
+      void examineMessages(NavMsgList& msgBitsOut);
+   };
+
+      //@}
+
+
+   template <class FilterData, class MsgSort>
+   NavCrossSourceFilter<FilterData,MsgSort> ::
+   NavCrossSourceFilter()
+         : numGroups(0),
+           slots(64, -1),
+           earlyQuorum(0)
+   {
+   }
+
+
+   template <class FilterData, class MsgSort>
+   void NavCrossSourceFilter<FilterData,MsgSort> ::
+   validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   {
+      NavMsgList::const_iterator nmli;
+      for (nmli = msgBitsIn.begin(); nmli != msgBitsIn.end(); nmli++)
+      {
+         FilterData *fd = dynamic_cast<FilterData*>(*nmli);
+         if (fd->timeStamp != currentTime)
+         {
+               // different time, so check out what we have
+            examineMessages(msgBitsOut);
+            clearGroups();
+            currentTime = fd->timeStamp;
+         }
+         size_t hash = hashMessage(fd);
+         PRNVote& vote = votes[fd->prn];
+         vote.msgCount++;
+         if (vote.winner >= 0)
+         {
+               // the vote for this PRN is already decided
+            const MessageGroup& win = groups[vote.winner];
+            if ((win.hash == hash) && sameBits(win.key, fd))
+               accept(*nmli, msgBitsOut);
+            else
+               reject(*nmli);
+            continue;
+         }
+            // add the message to our collection
+         size_t g = findGroup(fd, hash);
+         groups[g].msgs.push_back(*nmli);
+         size_t msgs = groups[g].msgs.size();
+         if ((earlyQuorum > 0) && (msgs >= earlyQuorum) &&
+             (msgs >= minVotes()) && (vote.msgCount >= minMessages()))
+         {
+            vote.winner = g;
+            decide(g, msgBitsOut);
+         }
+      }
+   }
+
+
+   template <class FilterData, class MsgSort>
+   void NavCrossSourceFilter<FilterData,MsgSort> ::
+   finalize(NavMsgList& msgBitsOut)
+   {
+      examineMessages(msgBitsOut);
+      clearGroups();
+      currentTime.reset();
+   }
+
+
+   template <class FilterData, class MsgSort>
+   size_t NavCrossSourceFilter<FilterData,MsgSort> ::
+   findGroup(FilterData *fd, size_t hash)
+   {
+      size_t mask = slots.size() - 1;
+      size_t slot;
+      for (slot = hash & mask; slots[slot] != -1; slot = (slot+1) & mask)
+      {
+         MessageGroup& grp = groups[slots[slot]];
+         if ((grp.hash == hash) && (grp.prn == fd->prn) &&
+             sameBits(grp.key, fd))
+         {
+            return slots[slot];
+         }
+      }
+         // Not found, add a new group, reusing old storage if possible
+      if (numGroups == groups.size())
+         groups.push_back(MessageGroup());
+      MessageGroup& grp = groups[numGroups];
+      grp.prn = fd->prn;
+      grp.hash = hash;
+      grp.key = fd;
+      grp.msgs.clear();
+      slots[slot] = numGroups;
+      numGroups++;
+         // keep the table at most half full
+      if (2*numGroups > slots.size())
+      {
+         slots.assign(2*slots.size(), -1);
+         mask = slots.size() - 1;
+         for (size_t i = 0; i < numGroups; i++)
+         {
+            for (slot = groups[i].hash & mask; slots[slot] != -1;
+                 slot = (slot+1) & mask)
+               ;
+            slots[slot] = i;
+         }
+      }
+      return numGroups-1;
+   }
+
+
+   template <class FilterData, class MsgSort>
+   void NavCrossSourceFilter<FilterData,MsgSort> ::
+   decide(size_t win, NavMsgList& msgBitsOut)
+   {
+      uint32_t prn = groups[win].prn;
+      accept(groups[win].msgs, msgBitsOut);
+      for (size_t i = 0; i < numGroups; i++)
+      {
+         if ((i != win) && (groups[i].prn == prn))
+            reject(groups[i].msgs);
+      }
+   }
+
+
+   template <class FilterData, class MsgSort>
+   void NavCrossSourceFilter<FilterData,MsgSort> ::
+   clearGroups()
+   {
+      for (size_t i = 0; i < numGroups; i++)
+         groups[i].msgs.clear();
+      numGroups = 0;
+      std::fill(slots.begin(), slots.end(), -1);
+      votes.clear();
+   }
+
+
+   template <class FilterData, class MsgSort>
+   std::vector<size_t> NavCrossSourceFilter<FilterData,MsgSort> ::
+   sortGroups(bool undecided) const
+   {
+      std::vector<size_t> order;
+      order.reserve(numGroups);
+      for (size_t i = 0; i < numGroups; i++)
+      {
+         if (undecided && (votes.find(groups[i].prn)->second.winner >= 0))
+            continue;
+         order.push_back(i);
+      }
+      std::sort(order.begin(), order.end(), GroupOrder(groups));
+      return order;
+   }
+
+
+   template <class FilterData, class MsgSort>
+   void NavCrossSourceFilter<FilterData,MsgSort> ::
+   examineMessages(NavMsgList& msgBitsOut)
+   {
+         // Sorting the groups gives the same order (and same winner
+         // on ties) as a map sorted by MsgSort.
+      std::vector<size_t> order(sortGroups(true));
+
+      size_t first, last;
+         // loop over each PRN/SV
+      for (first = 0; first < order.size(); first = last)
+      {
+         uint32_t prn = groups[order[first]].prn;
+            // count of total messages
+         size_t msgCount = 0;
+            // store the vote winner here
+         long winner = -1;
+            // store the largest number of "votes" for a message here
+         size_t voteCount = 0;
+         for (last = first;
+              (last < order.size()) && (groups[order[last]].prn == prn);
+              last++)
+         {
+            size_t msgs = groups[order[last]].msgs.size();
+            msgCount += msgs;
+               // minimum # of useful votes
+            if ((msgs > voteCount) && (msgs >= minVotes()))
+            {
+               voteCount = msgs;
+               winner = order[last];
+            }
+         }
+         if (msgCount < minMessages())
+            winner = -1; // not enough messages to have a useful vote
+
+            // If there is no winner, all messages will be rejected
+            // below.  Otherwise only the winners will be accepted.
+         for (size_t i = first; i < last; i++)
+         {
+            if ((long)order[i] == winner)
+               accept(groups[order[i]].msgs, msgBitsOut);
+            else
+               reject(groups[order[i]].msgs);
+         }
+      }
+   }
+
+}
+
+#endif // NAVCROSSSOURCEFILTER_HPP
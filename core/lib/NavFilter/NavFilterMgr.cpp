@@ -18,8 +18,15 @@ namespace gpstk
    NavFilter::NavMsgList NavFilterMgr ::
    validate(NavFilterKey* msgBits)
    {
-      NavFilter::NavMsgList rv, newrv;
-      rv.push_back(msgBits);
+      NavFilter::NavMsgList msgs(1, msgBits);
+      return validate(msgs);
+   }
+
+
+   NavFilter::NavMsgList NavFilterMgr ::
+   validate(const NavFilter::NavMsgList& msgs)
+   {
+      NavFilter::NavMsgList rv(msgs), newrv;
       rejected.clear();
       for (FilterList::iterator i = filters.begin(); i != filters.end(); i++)
       {
@@ -30,7 +37,7 @@ namespace gpstk
          (*i)->validate(rv, newrv);
          if (!(*i)->rejected.empty())
             rejected.insert(*i);
-         rv = newrv;
+         rv.swap(newrv);
       }
       return rv;
    }
@@ -59,13 +66,13 @@ namespace gpstk
             fliNxt = fliCur;
             fliNxt++;
                // cascade the data through the end.
-            rv1 = rv2;
+            rv1.swap(rv2);
             while ((fliNxt != filters.end()) && !rv1.empty())
             {
                (*fliNxt)->rejected.clear();
                rv2.clear();
                (*fliNxt)->validate(rv1, rv2);
-               rv1 = rv2;
+               rv1.swap(rv2);
                fliNxt++;
             }
                // If the filter cascade got some data that passed all
@@ -163,6 +163,22 @@ namespace gpstk
           *   configured filters. */
       NavFilter::NavMsgList validate(NavFilterKey* msgBits);
 
+         /** Validate a batch of navigation messages, e.g. all the
+          * subframes received from several receivers for the same
+          * epoch.  The whole batch is passed through each filter in
+          * turn, so each filter is called once per batch rather than
+          * once per message.  Each filter sees the messages in the
+          * same order as if they had been given to validate(msgBits)
+          * one at a time, so the same messages are accepted and
+          * rejected.
+          * @param[in] msgs The navigation messages to validate/filter,
+          *   with the same requirements as validate(msgBits).
+          * @return Any messages that have successfully passed all
+          *   configured filters.
+          * @note The rejected set and the filters' rejected lists
+          *   hold the rejections for the whole batch. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgs);
+
          /** Flush the stored data for all known filters.  This method
           * should be called by the user after all data has been added
           * to the filter manager via validate().
@@ -248,29 +248,49 @@ namespace gpstk
 
          // -----------------------------------------------------------
          // build the measurement covariance matrix
-         Matrix<double> iMC;
+         // when it is diagonal (as it usually is) use the weights alone
+         Matrix<double>& iMC(work.iMC);
+         Vector<double>& wts(work.wts);
+         bool diagonal(true);
          if(invMC.rows() > 0) {
             LOG(DEBUG) << "Build inverse MCov";
-            iMC = Matrix<double>(Nsvs,Nsvs,0.0);
+            iMC.resize(Nsvs,Nsvs);
+            wts.resize(Nsvs);
             for(n=0,i=0; i<Sats.size(); i++) {
                if(Sats[i].id <= 0) continue;
                for(k=0,j=0; j<Sats.size(); j++) {
                   if(Sats[j].id <= 0) continue;
                   iMC(n,k) = invMC(i,j);
+                  if(k != n && iMC(n,k) != 0.0) diagonal = false;
                   ++k;
                }
+               wts(n) = iMC(n,n);
                ++n;
             }
             LOG(DEBUG) << "inv MCov matrix is\n" << fixed << setprecision(4) << iMC;
          }
+         else {
+            iMC.resize(0,0);
+            wts.resize(Nsvs,1.0);
+         }
+         const bool weighted(invMC.rows() > 0);
 
          // -----------------------------------------------------------
          // define for computation
-         Vector<double> CRange(Nsvs),dX(dim);
-         Matrix<double> P(Nsvs,dim,0.0),PT,G(dim,Nsvs),PG(Nsvs,Nsvs),Rotation;
+         Vector<double>& CRange(work.CRange);
+         Vector<double>& dX(work.dX);
+         Vector<double>& PGdiag(work.PGdiag);
+         Matrix<double>& P(work.P);
+         Matrix<double>& G(work.G);
+         Matrix<double> Rotation;
          Triple dirCos;
          Xvt SV,RX;
 
+         CRange.resize(Nsvs);
+         dX.resize(dim);
+         PGdiag.resize(Nsvs);
+         P.resize(Nsvs,dim,0.0);
+         G.resize(dim,Nsvs);
          Solution.resize(dim);
          Covariance.resize(dim,dim);
          Resids.resize(Nsvs);
@@ -294,134 +314,251 @@ namespace gpstk
             LOG(DEBUG) << " no memory - no apriori solution";
          }
 
+         // within RAIMCompute(), a combination with the same systems as all the
+         // good satellites starts from the same apriori solution, so its first
+         // iteration follows from the full normal equations by removing the rows
+         // of the rejected satellites
+         const bool downdate(work.haveFull && diagonal && mySyss == work.fullSyss
+                             && size_t(Nsvs) < work.fullIndexes.size());
+
          // -----------------------------------------------------------
          // iteration loop
          do {
             TropFlag = false;       // true means the trop corr was NOT applied
 
-            // current estimate of position solution
-            RX.x = Triple(Solution(0),Solution(1),Solution(2));
-
-            // loop over satellites, computing partials matrix
-            for(n=0,i=0; i<Sats.size(); i++) {
-               // ignore marked satellites
-               if(Sats[i].id <= 0) continue;
-
-               // ------------ ephemeris
-               // rho is time of flight (sec)
-               if(n_iterate == 0)
-                  rho = 0.070;             // initial guess: 70ms
-               else
-                  rho = RSS(SVP(i,0)-Solution(0),
-                           SVP(i,1)-Solution(1), SVP(i,2)-Solution(2))/ellip.c();
-
-               // correct for earth rotation
-               wt = ellip.angVelocity()*rho;             // radians
-               svxyz[0] =  ::cos(wt)*SVP(i,0) + ::sin(wt)*SVP(i,1);
-               svxyz[1] = -::sin(wt)*SVP(i,0) + ::cos(wt)*SVP(i,1);
-               svxyz[2] = SVP(i,2);
-
-               // rho is now geometric range
-               rho = RSS(svxyz[0]-Solution(0),
-                         svxyz[1]-Solution(1),
-                         svxyz[2]-Solution(2));
-
-               // direction cosines
-               dirCos[0] = (Solution(0)-svxyz[0])/rho;
-               dirCos[1] = (Solution(1)-svxyz[1])/rho;
-               dirCos[2] = (Solution(2)-svxyz[2])/rho;
-
-               // ------------ data
-               // corrected pseudorange (m) minus geometric range
-               CRange(n) = SVP(i,3) - rho;
-
-               // correct for troposphere and PCOs (but not on the first iteration)
-               if(n_iterate > 0) {
-                  SV.x = Triple(svxyz[0],svxyz[1],svxyz[2]);
-                  Position R,S;
-                  R.setECEF(RX.x[0],RX.x[1],RX.x[2]);
-                  S.setECEF(SV.x[0],SV.x[1],SV.x[2]);
-
-                  // trop
-                  double tc(R.getHeight());  // tc is a dummy here
-                  // must test R for reasonableness to avoid corrupting TropModel
-                  // Global model sets the upper limit
-                  if(R.elevation(S) < 0.0 || tc > 44247. || tc < -1000.0) {
-                     tc = 0.0;
-                     TropFlag = true;        // true means failed to apply trop corr
+            if(n_iterate == 0 && downdate) {
+               Vector<double>& b(work.b);
+               Covariance = work.fullN;
+               b = work.fullb;
+               for(n=0,k=0; k<int(work.fullIndexes.size()); k++) {
+                  // keep the row of a good satellite
+                  if(Sats[work.fullIndexes[k]].id > 0) {
+                     for(j=0; j<dim; j++) P(n,j) = work.fullP(k,j);
+                     Resids(n) = work.fullResids(k);
+                     n++;
+                     continue;
                   }
-                  else
-                     tc = pTropModel->correction(R,S,T);    // pTropModel not const
 
-                  CRange(n) -= tc;
-                  LOG(DEBUG) << "Trop " << i << " " << Sats[i] << " "
-                     << fixed << setprecision(3) << tc;
-
-               }  // end if n_iterate > 0
-
-               // get the index, for this clock, in the solution vector
-               j = 3 + vectorindex(mySyss, Sats[i].system); // Solution ~ X,Y,Z,clks
+                  // rank-one downdate for a rejected one
+                  for(i=0; i<dim; i++) {
+                     const double wp(work.fullWts(k)*work.fullP(k,i));
+                     b(i) -= wp*work.fullResids(k);
+                     for(j=0; j<dim; j++) Covariance(i,j) -= wp*work.fullP(k,j);
+                  }
+               }
 
-               // find the clock for the sat's system
-               const double clk(Solution(j));
-               LOG(DEBUG) << "Clock is (" << j << ") " << clk;
+               if(n != Nsvs) {
+                  Exception e("Counting error in downdate of normal equations");
+                  GPSTK_THROW(e);
+               }
+               LOG(DEBUG) << "Downdated normal equations, Nsvs " << Nsvs << " of "
+                  << work.fullIndexes.size();
 
-               // data vector: corrected range residual
-               Resids(n) = CRange(n) - clk;
+               // invert using SVD
+               try {
+                  Covariance = inverseSVD(Covariance);
+               }
+               catch(SingularMatrixException& sme) { return -2; }
 
-               // ------------ least squares
-               // partials matrix
-               P(n,0) = dirCos[0];           // x direction cosine
-               P(n,1) = dirCos[1];           // y direction cosine
-               P(n,2) = dirCos[2];           // z direction cosine
-               P(n,j) = 1.0;                 // clock
+               // compute solution
+               for(i=0; i<dim; i++) {
+                  dX(i) = 0.0;
+                  for(j=0; j<dim; j++) dX(i) += Covariance(i,j) * b(j);
+               }
+            }
+            else {
+               // current estimate of position solution
+               RX.x = Triple(Solution(0),Solution(1),Solution(2));
 
-               // ------------ increment index
-               // n is index and number of good satellites - also used for Slope
-               n++;
+               // receiver position for the trop model, the same for all sats
+               Position R;
+               double Rht(0.0);
+               if(n_iterate > 0) {
+                  R.setECEF(RX.x[0],RX.x[1],RX.x[2]);
+                  Rht = R.getHeight();
+               }
 
-            }  // end loop over satellites
+               // loop over satellites, computing partials matrix
+               for(n=0,i=0; i<Sats.size(); i++) {
+                  // ignore marked satellites
+                  if(Sats[i].id <= 0) continue;
 
-            if(n != Nsvs) {
-               Exception e("Counting error after satellite loop");
-               GPSTK_THROW(e);
-            }
+                  // ------------ ephemeris
+                  // rho is time of flight (sec)
+                  if(n_iterate == 0)
+                     rho = 0.070;             // initial guess: 70ms
+                  else
+                     rho = RSS(SVP(i,0)-Solution(0),
+                              SVP(i,1)-Solution(1), SVP(i,2)-Solution(2))/ellip.c();
+
+                  // correct for earth rotation
+                  wt = ellip.angVelocity()*rho;             // radians
+                  svxyz[0] =  ::cos(wt)*SVP(i,0) + ::sin(wt)*SVP(i,1);
+                  svxyz[1] = -::sin(wt)*SVP(i,0) + ::cos(wt)*SVP(i,1);
+                  svxyz[2] = SVP(i,2);
+
+                  // rho is now geometric range
+                  rho = RSS(svxyz[0]-Solution(0),
+                            svxyz[1]-Solution(1),
+                            svxyz[2]-Solution(2));
+
+                  // direction cosines
+                  dirCos[0] = (Solution(0)-svxyz[0])/rho;
+                  dirCos[1] = (Solution(1)-svxyz[1])/rho;
+                  dirCos[2] = (Solution(2)-svxyz[2])/rho;
+
+                  // ------------ data
+                  // corrected pseudorange (m) minus geometric range
+                  CRange(n) = SVP(i,3) - rho;
+
+                  // correct for troposphere and PCOs (but not on the first iteration)
+                  if(n_iterate > 0) {
+                     SV.x = Triple(svxyz[0],svxyz[1],svxyz[2]);
+                     Position S;
+                     S.setECEF(SV.x[0],SV.x[1],SV.x[2]);
+
+                     // trop
+                     double tc(Rht);            // tc is a dummy here
+                     // must test R for reasonableness to avoid corrupting TropModel
+                     // Global model sets the upper limit
+                     if(R.elevation(S) < 0.0 || tc > 44247. || tc < -1000.0) {
+                        tc = 0.0;
+                        TropFlag = true;        // true means failed to apply trop corr
+                     }
+                     else
+                        tc = pTropModel->correction(R,S,T);    // pTropModel not const
+
+                     CRange(n) -= tc;
+                     LOG(DEBUG) << "Trop " << i << " " << Sats[i] << " "
+                        << fixed << setprecision(3) << tc;
+
+                  }  // end if n_iterate > 0
+
+                  // get the index, for this clock, in the solution vector
+                  j = 3 + vectorindex(mySyss, Sats[i].system); // Solution ~ X,Y,Z,clks
+
+                  // find the clock for the sat's system
+                  const double clk(Solution(j));
+                  LOG(DEBUG) << "Clock is (" << j << ") " << clk;
+
+                  // data vector: corrected range residual
+                  Resids(n) = CRange(n) - clk;
+
+                  // ------------ least squares
+                  // partials matrix
+                  P(n,0) = dirCos[0];           // x direction cosine
+                  P(n,1) = dirCos[1];           // y direction cosine
+                  P(n,2) = dirCos[2];           // z direction cosine
+                  P(n,j) = 1.0;                 // clock
+
+                  // ------------ increment index
+                  // n is index and number of good satellites - also used for Slope
+                  n++;
+
+               }  // end loop over satellites
+
+               if(n != Nsvs) {
+                  Exception e("Counting error after satellite loop");
+                  GPSTK_THROW(e);
+               }
 
-            LOG(DEBUG) << "Partials (" << P.rows() << "x" << P.cols() << ")\n"
-               << fixed << setprecision(4) << P;
-            LOG(DEBUG) << "Resids (" << Resids.size() << ") "
-               << fixed << setprecision(3) << Resids;
+               LOG(DEBUG) << "Partials (" << P.rows() << "x" << P.cols() << ")\n"
+                  << fixed << setprecision(4) << P;
+               LOG(DEBUG) << "Resids (" << Resids.size() << ") "
+                  << fixed << setprecision(3) << Resids;
+
+               // ------------------------------------------------------
+               // compute information matrix (inverse covariance) and generalized inverse
+               // The products are formed in place, in the same order as the Matrix
+               // operators, i.e. Covariance = PT * iMC * P and G = Covariance * PT * iMC;
+               // a diagonal iMC is applied as weights.
+
+               // weight matrix = measurement covariance inverse
+               if(weighted && !diagonal) {
+                  Matrix<double>& PTW(work.PTW);
+                  PTW.resize(dim,Nsvs);
+                  for(i=0; i<dim; i++) for(k=0; k<Nsvs; k++) {
+                     PTW(i,k) = 0.0;
+                     for(n=0; n<Nsvs; n++) PTW(i,k) += P(n,i) * iMC(n,k);
+                  }
+                  for(i=0; i<dim; i++) for(j=0; j<dim; j++) {
+                     Covariance(i,j) = 0.0;
+                     for(k=0; k<Nsvs; k++) Covariance(i,j) += PTW(i,k) * P(k,j);
+                  }
+               }
+               else for(i=0; i<dim; i++) for(j=0; j<dim; j++) {
+                  Covariance(i,j) = 0.0;
+                  if(weighted)
+                     for(k=0; k<Nsvs; k++) Covariance(i,j) += (P(k,i)*wts(k)) * P(k,j);
+                  else
+                     for(k=0; k<Nsvs; k++) Covariance(i,j) += P(k,i) * P(k,j);
+               }
 
-            // ------------------------------------------------------
-            // compute information matrix (inverse covariance) and generalized inverse
-            PT = transpose(P);
+               // save the first iteration for the RAIM downdate
+               if(n_iterate == 0 && work.record) {
+                  work.record = false;
+                  if(diagonal) {
+                     work.haveFull = true;
+                     work.fullSyss = mySyss;
+                     work.fullIndexes.clear();
+                     for(i=0; i<Sats.size(); i++)
+                        if(Sats[i].id > 0) work.fullIndexes.push_back(i);
+                     work.fullP = P;
+                     work.fullN = Covariance;
+                     work.fullResids = Resids;
+                     work.fullWts = wts;
+                     work.fullb.resize(dim);
+                     for(i=0; i<dim; i++) {
+                        work.fullb(i) = 0.0;
+                        for(k=0; k<Nsvs; k++)
+                           work.fullb(i) += (P(k,i)*wts(k)) * Resids(k);
+                     }
+                  }
+               }
 
-            // weight matrix = measurement covariance inverse
-            if(invMC.rows() > 0) Covariance = PT * iMC * P;
-            else                 Covariance = PT * P;
+               // invert using SVD
+               try {
+                  Covariance = inverseSVD(Covariance);
+               }
+               catch(SingularMatrixException& sme) { return -2; }
+               LOG(DEBUG) << "InvCov (" << Covariance.rows() << "x" << Covariance.cols()
+                  << ")\n" << fixed << setprecision(4) << Covariance;
+
+               // generalized inverse
+               Matrix<double>& CP(weighted && !diagonal ? work.CP : G);
+               CP.resize(dim,Nsvs);
+               for(i=0; i<dim; i++) for(k=0; k<Nsvs; k++) {
+                  CP(i,k) = 0.0;
+                  for(j=0; j<dim; j++) CP(i,k) += Covariance(i,j) * P(k,j);
+               }
+               if(weighted && !diagonal) {
+                  for(i=0; i<dim; i++) for(k=0; k<Nsvs; k++) {
+                     G(i,k) = 0.0;
+                     for(n=0; n<Nsvs; n++) G(i,k) += CP(i,n) * iMC(n,k);
+                  }
+               }
+               else if(weighted) {
+                  for(i=0; i<dim; i++) for(k=0; k<Nsvs; k++) G(i,k) *= wts(k);
+               }
 
-            // invert using SVD
-            try {
-               Covariance = inverseSVD(Covariance);
+               // diagonal of PG is used for Slope computation
+               for(k=0; k<Nsvs; k++) {
+                  PGdiag(k) = 0.0;
+                  for(i=0; i<dim; i++) PGdiag(k) += P(k,i) * G(i,k);
+               }
+               LOG(DEBUG) << "PG (" << Nsvs << "x" << Nsvs
+                  << ")\n" << fixed << setprecision(4) << P*G;
+
+               // ------------------------------------------------------
+               // compute solution
+               for(i=0; i<dim; i++) {
+                  dX(i) = 0.0;
+                  for(k=0; k<Nsvs; k++) dX(i) += G(i,k) * Resids(k);
+               }
             }
-            catch(SingularMatrixException& sme) { return -2; }
-            LOG(DEBUG) << "InvCov (" << Covariance.rows() << "x" << Covariance.cols()
-               << ")\n" << fixed << setprecision(4) << Covariance;
-
-            // generalized inverse
-            if(invMC.rows() > 0) G = Covariance * PT * iMC;
-            else                 G = Covariance * PT;
-
-            // PG is used for Slope computation
-            PG = P * G;
-            LOG(DEBUG) << "PG (" << PG.rows() << "x" << PG.cols()
-               << ")\n" << fixed << setprecision(4) << PG;
 
             n_iterate++;                        // increment number iterations
 
-            // ------------------------------------------------------
-            // compute solution
-            dX = G * Resids;
             LOG(DEBUG) << "Computed dX(" << dX.size() << ")";
             Solution += dX;
 
@@ -451,10 +588,10 @@ namespace gpstk
 
             // NB when one (few) sats have their own clock, PG(j,j) = 1 (nearly 1)
             // and slope is inf (large)
-            if(::fabs(1.0-PG(j,j)) < 1.e-8) continue;
+            if(::fabs(1.0-PGdiag(j)) < 1.e-8) continue;
 
             for(int k=0; k<dim; k++) Slopes(j) += G(k,j)*G(k,j); // TD dim=4 here?
-            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PG(j,j)));
+            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PGdiag(j)));
             if(Slopes(j) > MaxSlope) MaxSlope = Slopes(j);
             j++;
          }
@@ -548,6 +685,11 @@ namespace gpstk
          // return is >=0(number of good sats) or -4(no ephemeris)
          if(N <= 0) return -4;
 
+         // the first solution, with all the good satellites, saves its normal
+         // equations; the solutions that reject satellites start from them
+         work.record = RAIMDowndate;
+         work.haveFull = false;
+
          // ----------------------------------------------------------------
          // Build GoodIndexes based on Sats; save Sats as SaveSats.
          // Sats is used to mark good sats (id > 0) and those to ignore (id <= 0).
@@ -777,9 +919,11 @@ namespace gpstk
          LOG(DEBUG) << " RAIM exit with ret value " << iret
                      << " and Valid " << (Valid ? "T":"F");
 
+         work.record = work.haveFull = false;
          return iret;
       }
       catch(Exception& e) {
+         work.record = work.haveFull = false;
          GPSTK_RETHROW(e);
       }
    }  // end PRSolution::RAIMCompute()
@@ -203,7 +203,7 @@ namespace gpstk
          nsol = ndata = 0;
          APV = 0.0;
          was.reset();
-         APSolution = Vector<double>(4,0.0);
+         APSolution = Vector<double>(3+(APsysIDs.empty() ? 1 : APsysIDs.size()),0.0);
       }
 
       /// Define the systems, including their order, that will be in the apriori sol
@@ -212,7 +212,7 @@ namespace gpstk
          if(sys.size() == 0) 
             GPSTK_THROW(Exception("Cannot have zero systems in setAPsystems"));
          APsysIDs = sys;
-         APSolution.resize(3+APsysIDs.size());
+         APSolution = Vector<double>(3+APsysIDs.size(),0.0);
       }
 
       /// Fix the apriori solution to the given constant value (XYZ,m)
@@ -376,6 +376,7 @@ namespace gpstk
                              MaxNIterations(10),
                              ConvergenceLimit(3.e-7),
                              hasMemory(true),
+                             RAIMDowndate(true),
                              Valid(false)
          {}
       /// Return the status of solution
@@ -419,6 +420,13 @@ namespace gpstk
       /// and a combined weighted average solution.
       bool hasMemory;
 
+      /// If true (the default), RAIMCompute() forms the first iteration of each
+      /// solution that rejects satellites by downdating the normal equations of
+      /// the solution with all the good satellites (see Workspace). If false,
+      /// every solution is formed from scratch; the results differ only by
+      /// round-off.
+      bool RAIMDowndate;
+
       // input and output: -------------------------------------------------
 
       /// vector<SatID> containing satellite IDs for all the satellites input, with
@@ -661,6 +669,38 @@ namespace gpstk
       /// empty vector used to detect default
       static const Vector<double> PRSNullVector;
 
+      /// Storage for SimplePRSolution(), kept from one call to the next so that
+      /// the RAIM loop over combinations of satellites does not allocate it again.
+      /// During RAIMCompute() it also holds the normal equations of all the good
+      /// satellites at the first iteration (i.e. at the apriori solution); the
+      /// first iteration of each combination is derived from them by a rank-one
+      /// downdate for each rejected satellite, rather than built from scratch.
+      /// Only used when the measurement covariance is diagonal (or not given).
+      class Workspace {
+      public:
+         Workspace() throw() : record(false), haveFull(false) { }
+
+         /// per solution
+         Vector<double> CRange,dX,b,wts,PGdiag;
+         Matrix<double> iMC,P,PTW,CP,G;
+
+         /// if true, the next solution saves its normal equations as the full ones
+         bool record;
+         /// true when the full normal equations are valid
+         bool haveFull;
+         /// systems (clocks) in the full normal equations
+         std::vector<SatID::SatelliteSystem> fullSyss;
+         /// index in Sats of each row of the full normal equations
+         std::vector<size_t> fullIndexes;
+         /// full partials, residuals, weights, information matrix PT*W*P
+         /// and PT*W*Resids
+         Matrix<double> fullP,fullN;
+         Vector<double> fullResids,fullWts,fullb;
+      };
+
+      /// workspace of SimplePRSolution()
+      Workspace work;
+
    }; // end class PRSolution
 
    //@}
@@ -0,0 +1,209 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file SPSCQueue.hpp
+ * Bounded, lock-free, single-producer/single-consumer queue.
+ */
+
+#ifndef GPSTK_SPSCQUEUE_HPP
+#define GPSTK_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+namespace gpstk
+{
+      /** Bounded, lock-free queue for exactly one producer thread and
+       * exactly one consumer thread.
+       *
+       * The storage is a ring buffer allocated once at construction,
+       * so push() and pop() never allocate.  The capacity is rounded
+       * up to a power of two so that the read and write positions
+       * can be free-running counters reduced by a mask.  The two
+       * counters are padded a cache line apart so the producer and
+       * the consumer do not contend for the same line.  Padding is
+       * used rather than alignment so that the queue, and the
+       * classes holding one, are not over-aligned types and can be
+       * created with plain new.
+       *
+       * Neither push() nor pop() blocks; they return false when the
+       * queue is full or empty respectively.  Callers that need to
+       * wait can use SPSCBackoff between attempts.
+       *
+       * @code
+       *   SPSCQueue<int> q(16);
+       *      // producer thread
+       *   while (!q.push(42)) backoff.pause();
+       *      // consumer thread
+       *   int i;
+       *   while (!q.pop(i)) backoff.pause();
+       * @endcode
+       */
+   template <class T>
+   class SPSCQueue
+   {
+   public:
+         /** Create a queue able to hold at least \a minCapacity
+          * items.
+          * @param[in] minCapacity minimum number of items the queue
+          *   must be able to hold (at least 1). */
+      explicit SPSCQueue(size_t minCapacity)
+            : head(0), tail(0)
+      {
+         size_t cap = 1;
+         while (cap < minCapacity)
+            cap <<= 1;
+         buffer.resize(cap);
+         mask = cap - 1;
+      }
+
+         /** Add an item to the back of the queue.  Only the producer
+          * thread may call this method.
+          * @param[in] item the item to copy into the queue.
+          * @return false if the queue is full, true otherwise. */
+      bool push(const T& item)
+      {
+         size_t t = tail.load(std::memory_order_relaxed);
+         if (t - head.load(std::memory_order_acquire) > mask)
+            return false;
+         buffer[t & mask] = item;
+         tail.store(t + 1, std::memory_order_release);
+         return true;
+      }
+
+         /** Remove an item from the front of the queue.  Only the
+          * consumer thread may call this method.
+          * @param[out] item the item removed from the queue.
+          * @return false if the queue is empty, true otherwise. */
+      bool pop(T& item)
+      {
+         size_t h = head.load(std::memory_order_relaxed);
+         if (h == tail.load(std::memory_order_acquire))
+            return false;
+         item = buffer[h & mask];
+         head.store(h + 1, std::memory_order_release);
+         return true;
+      }
+
+         /// Return true if the queue holds no items.
+      bool empty() const
+      {
+         return head.load(std::memory_order_acquire) ==
+            tail.load(std::memory_order_acquire);
+      }
+
+         /** Return the number of items in the queue.  The value is
+          * exact only when called from the producer or the consumer
+          * while the other side is idle. */
+      size_t size() const
+      {
+         return tail.load(std::memory_order_acquire) -
+            head.load(std::memory_order_acquire);
+      }
+
+         /// Return the number of items the queue can hold.
+      size_t capacity() const
+      { return mask + 1; }
+
+   private:
+         /// Copying a queue that is shared between threads is not allowed.
+      SPSCQueue(const SPSCQueue&);
+      SPSCQueue& operator=(const SPSCQueue&);
+
+         /// Ring buffer storage, size is a power of two.
+      std::vector<T> buffer;
+         /// buffer.size()-1, used to reduce counters to indices.
+      size_t mask;
+         /// Size of a cache line, the distance kept between counters.
+      static const size_t cacheLine = 64;
+
+         /// Keeps head off the cache line of mask and buffer.
+      char padHead[cacheLine];
+         /// Count of items popped, written only by the consumer.
+      std::atomic<size_t> head;
+         /// Keeps tail off the cache line of head.
+      char padTail[cacheLine];
+         /// Count of items pushed, written only by the producer.
+      std::atomic<size_t> tail;
+         /// Keeps tail off the cache line of whatever follows the queue.
+      char padEnd[cacheLine];
+   }; // class SPSCQueue
+
+
+      /** Progressive wait used while polling an SPSCQueue.  The
+       * first calls spin, later calls yield the processor and
+       * finally sleep briefly, so that an idle waiter does not
+       * monopolise a core while a busy one reacts quickly. */
+   class SPSCBackoff
+   {
+   public:
+      SPSCBackoff()
+            : count(0)
+      {}
+
+         /// Wait a little longer than the previous call did.
+      void pause()
+      {
+         if (count < 64)
+         {
+            ++count;
+         }
+         else if (count < 128)
+         {
+            ++count;
+            std::this_thread::yield();
+         }
+         else
+         {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+         }
+      }
+
+         /// Start again from spinning, call after a successful poll.
+      void reset()
+      { count = 0; }
+
+   private:
+      unsigned count;
+   }; // class SPSCBackoff
+
+} // namespace gpstk
+
+#endif // GPSTK_SPSCQUEUE_HPP
@@ -0,0 +1,341 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+
+#include "RinexObsStream.hpp"
+#include "RinexObsHeader.hpp"
+#include "RinexObsData.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /** Tests for Compact RINEX (Hatanaka) files read and written by the
+    * RINEX observation streams. The .06d and .crx files are Compact
+    * RINEX 1.0 and 3.0 versions of the .06o and .15o files, written by
+    * CompactRinexBuf (differences of order 3, as rnx2crx uses); they
+    * were not made by rnx2crx nor checked with crx2rnx. So these tests
+    * only show that decoding undoes encoding; files compressed by
+    * RNX2CRX, with their plain RINEX, are still to be added. */
+class CompactRinex_T
+{
+public:
+   CompactRinex_T();
+
+      /// The decoded text is that of the plain file.
+   int decodeTextTest(void);
+      /// The data read are those of the plain file.
+   int decodeDataTest(void);
+      /// Text written compact is encoded as the reference files.
+   int encodeTextTest(void);
+      /// Data written compact read back the same.
+   int roundTripTest(void);
+      /// Output is plain unless Compact RINEX is asked for.
+   int optInTest(void);
+
+private:
+   string dataFilePath;
+   string tempFilePath;
+   string obs2, crx2, obs3, crx3;
+
+      /// Lines of a file, without trailing blanks.
+   static vector<string> readLines(istream& s);
+      /// Header (unless \a noHeader) and records read from a RINEX 2
+      /// obs file, as dumps.
+   static string readObs2(RinexObsStream& strm, bool noHeader = false);
+      /// Header (unless \a noHeader) and records read from a RINEX 3
+      /// obs file, as dumps.
+   static string readObs3(Rinex3ObsStream& strm, bool noHeader = false);
+};
+
+
+CompactRinex_T ::
+CompactRinex_T()
+{
+   dataFilePath = getPathData() + getFileSep();
+   tempFilePath = getPathTestTemp() + getFileSep();
+   obs2 = dataFilePath + "test_input_rinex2_obs_RinexObsFile.06o";
+   crx2 = dataFilePath + "test_input_rinex2_obs_RinexObsFile.06d";
+   obs3 = dataFilePath + "test_input_rinex3_obs_RinexObsFile.15o";
+   crx3 = dataFilePath + "test_input_rinex3_obs_RinexObsFile.crx";
+}
+
+
+vector<string> CompactRinex_T ::
+readLines(istream& s)
+{
+   vector<string> lines;
+   string line;
+   while (getline(s, line))
+   {
+      string::size_type n = line.find_last_not_of(' ');
+      lines.push_back(n == string::npos ? string() : line.substr(0, n+1));
+   }
+   return lines;
+}
+
+
+string CompactRinex_T ::
+readObs2(RinexObsStream& strm, bool noHeader)
+{
+   ostringstream s;
+   RinexObsHeader hdr;
+   RinexObsData data;
+   strm >> hdr;
+   if (!noHeader)
+      hdr.dump(s);
+   while (strm >> data)
+   {
+      data.dump(s);
+   }
+   s << "records " << strm.recordNumber << endl;
+   return s.str();
+}
+
+
+string CompactRinex_T ::
+readObs3(Rinex3ObsStream& strm, bool noHeader)
+{
+   ostringstream s;
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData data;
+   strm >> hdr;
+   if (!noHeader)
+      hdr.dump(s);
+   while (strm >> data)
+   {
+      data.dump(s, hdr);
+   }
+   s << "records " << strm.recordNumber << endl;
+   return s.str();
+}
+
+
+int CompactRinex_T ::
+decodeTextTest(void)
+{
+   TUDEF("CompactRinexBuf", "underflow");
+
+   ifstream plain2(obs2.c_str());
+   RinexObsStream compact2(crx2.c_str());
+   TUASSERT(compact2.isCompact());
+   vector<string> expect(readLines(plain2)), got(readLines(compact2));
+   TUASSERTE(size_t, expect.size(), got.size());
+   TUASSERT(expect == got);
+
+   ifstream plain3(obs3.c_str());
+   Rinex3ObsStream compact3(crx3.c_str());
+   TUASSERT(compact3.isCompact());
+   expect = readLines(plain3);
+   got = readLines(compact3);
+   TUASSERTE(size_t, expect.size(), got.size());
+   TUASSERT(expect == got);
+
+   TURETURN();
+}
+
+
+int CompactRinex_T ::
+decodeDataTest(void)
+{
+   TUDEF("CompactRinexBuf", "underflow");
+
+   RinexObsStream plain2(obs2.c_str()), compact2(crx2.c_str());
+   string expect(readObs2(plain2));
+   TUASSERT(expect.find("records 0") == string::npos);
+   TUASSERTE(string, expect, readObs2(compact2));
+
+   Rinex3ObsStream plain3(obs3.c_str()), compact3(crx3.c_str());
+   expect = readObs3(plain3);
+   TUASSERT(expect.find("records 0") == string::npos);
+   TUASSERTE(string, expect, readObs3(compact3));
+
+      // RINEX 2 files read through Rinex3ObsStream as well
+   Rinex3ObsStream plain23(obs2.c_str()), compact23(crx2.c_str());
+   TUASSERTE(string, readObs3(plain23), readObs3(compact23));
+
+   TURETURN();
+}
+
+
+int CompactRinex_T ::
+encodeTextTest(void)
+{
+   TUDEF("CompactRinexBuf", "xsputn");
+
+   const string files[2][2] = { { obs2, crx2 }, { obs3, crx3 } };
+   for (int f = 0; f < 2; f++)
+   {
+      string out = tempFilePath + "test_output_compact_rinex_text.crx";
+      {
+         ifstream in(files[f][0].c_str());
+         Rinex3ObsStream strm(out.c_str(), ios::out);
+         TUASSERT(strm.setCompactOutput());
+         string line;
+         while (getline(in, line))
+         {
+            strm << line << '\n';
+         }
+      }
+
+         // the same as the reference, but for the date
+      ifstream ref(files[f][1].c_str()), got(out.c_str());
+      vector<string> expect(readLines(ref)), lines(readLines(got));
+      TUASSERTE(size_t, expect.size(), lines.size());
+      if (expect.size() == lines.size() && expect.size() > 2)
+      {
+         TUASSERTE(string, expect[0], lines[0]);
+         TUASSERTE(string, expect[1].substr(0,40), lines[1].substr(0,40));
+         TUASSERTE(string, expect[1].substr(60), lines[1].substr(60));
+         expect.erase(expect.begin(), expect.begin()+2);
+         lines.erase(lines.begin(), lines.begin()+2);
+         TUASSERT(expect == lines);
+      }
+   }
+
+   TURETURN();
+}
+
+
+int CompactRinex_T ::
+roundTripTest(void)
+{
+   TUDEF("CompactRinexBuf", "overflow");
+
+   string out2 = tempFilePath + "test_output_compact_rinex_RoundTrip.06d";
+   {
+      RinexObsStream in(obs2.c_str());
+      RinexObsStream out(out2.c_str(), ios::out);
+      TUASSERT(out.setCompactOutput());
+      TUASSERT(out.isCompact());
+      RinexObsHeader hdr;
+      RinexObsData data;
+      in >> hdr;
+      out << hdr;
+      while (in >> data)
+      {
+         out << data;
+      }
+   }
+   RinexObsStream plain2(obs2.c_str()), compact2(out2.c_str());
+   TUASSERT(compact2.isCompact());
+      // the header written has a new date
+   TUASSERTE(string, readObs2(plain2, true), readObs2(compact2, true));
+
+   string out3 = tempFilePath + "test_output_compact_rinex_RoundTrip.crx";
+   {
+      Rinex3ObsStream in(obs3.c_str());
+      Rinex3ObsStream out(out3.c_str(), ios::out);
+      TUASSERT(out.setCompactOutput());
+      Rinex3ObsHeader hdr;
+      Rinex3ObsData data;
+      in >> hdr;
+      out << hdr;
+      while (in >> data)
+      {
+         out << data;
+      }
+   }
+   Rinex3ObsStream plain3(obs3.c_str()), compact3(out3.c_str());
+   TUASSERT(compact3.isCompact());
+   TUASSERTE(string, readObs3(plain3, true), readObs3(compact3, true));
+
+   TURETURN();
+}
+
+
+int CompactRinex_T ::
+optInTest(void)
+{
+   TUDEF("CompactRinexStream", "setCompactOutput");
+
+      // a Compact RINEX name alone doesn't compress
+   string out = tempFilePath + "test_output_compact_rinex_Plain.06d";
+   {
+      RinexObsStream in(obs2.c_str());
+      RinexObsStream strm(out.c_str(), ios::out);
+      TUASSERT(!strm.isCompact());
+      RinexObsHeader hdr;
+      in >> hdr;
+      strm << hdr;
+
+         // too late once something is written
+      TUASSERT(!strm.setCompactOutput());
+      TUASSERT(!strm.isCompact());
+   }
+   RinexObsStream check(out.c_str());
+   TUASSERT(!check.isCompact());
+
+      // not for input
+   RinexObsStream input(obs2.c_str());
+   TUASSERT(!input.setCompactOutput());
+   TUASSERT(!input.isCompact());
+
+      // close() detaches the buffer
+   Rinex3ObsStream strm(crx3.c_str());
+   TUASSERT(strm.isCompact());
+   strm.close();
+   TUASSERT(!strm.isCompact());
+   strm.open(obs3.c_str(), ios::in);
+   TUASSERT(!strm.isCompact());
+
+   TURETURN();
+}
+
+
+int main(void)
+{
+   CompactRinex_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.decodeTextTest();
+   errorTotal += testClass.decodeDataTest();
+   errorTotal += testClass.encodeTextTest();
+   errorTotal += testClass.roundTripTest();
+   errorTotal += testClass.optInTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
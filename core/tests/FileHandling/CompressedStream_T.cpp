@@ -0,0 +1,278 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavHeader.hpp"
+#include "Rinex3NavData.hpp"
+#include "FFStream.hpp"
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /** Tests for reading gzip (.gz) and compress (.Z) files through
+    * FFStream. The compressed files hold the same data as the plain
+    * ones they are named after. */
+class CompressedStream_T
+{
+public:
+   CompressedStream_T();
+
+      /// Compressed RINEX 2 obs files read the same as the plain one.
+   int obsTest(void);
+      /// Compressed RINEX 3 nav files read the same as the plain one.
+   int navTest(void);
+      /// close() stops the decompressor, and the stream can be reused.
+   int closeTest(void);
+      /// A truncated file fails with the decompressor's error.
+   int truncatedTest(void);
+
+private:
+   string dataFilePath;
+   string tempFilePath;
+   string obsFile;
+   string navFile;
+
+      /// Header and records of an obs file, as dumps.
+   string readObs(const string& fn, bool& compressed);
+      /// Header and records of a nav file, as dumps.
+   string readNav(const string& fn, bool& compressed);
+};
+
+
+CompressedStream_T ::
+CompressedStream_T()
+{
+   dataFilePath = getPathData() + getFileSep();
+   tempFilePath = getPathTestTemp() + getFileSep();
+   obsFile = dataFilePath + "test_input_rinex2_obs_RinexObsFile.06o";
+   navFile = dataFilePath + "arlm200a.15n";
+}
+
+
+string CompressedStream_T ::
+readObs(const string& fn, bool& compressed)
+{
+   ostringstream s;
+   Rinex3ObsStream strm(fn.c_str());
+   compressed = strm.isCompressed();
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData data;
+   strm >> hdr;
+   hdr.dump(s);
+   while (strm >> data)
+   {
+      data.dump(s, hdr);
+   }
+   s << "records " << strm.recordNumber << endl;
+   return s.str();
+}
+
+
+string CompressedStream_T ::
+readNav(const string& fn, bool& compressed)
+{
+   ostringstream s;
+   Rinex3NavStream strm(fn.c_str());
+   compressed = strm.isCompressed();
+   Rinex3NavHeader hdr;
+   Rinex3NavData data;
+   strm >> hdr;
+   hdr.dump(s);
+   while (strm >> data)
+   {
+      data.dump(s);
+   }
+   s << "records " << strm.recordNumber << endl;
+   return s.str();
+}
+
+
+int CompressedStream_T ::
+obsTest(void)
+{
+   TUDEF("FFStream", "compressed obs");
+   bool compressed;
+   string plain = readObs(obsFile, compressed);
+   TUASSERT(!compressed);
+   TUASSERT(plain.find("records 0") == string::npos);
+
+   string got = readObs(obsFile + ".Z", compressed);
+   TUASSERT(compressed);
+   TUASSERTE(string, plain, got);
+
+#ifdef GPSTK_HAVE_ZLIB
+   got = readObs(obsFile + ".gz", compressed);
+   TUASSERT(compressed);
+   TUASSERTE(string, plain, got);
+#endif
+
+   TURETURN();
+}
+
+
+int CompressedStream_T ::
+navTest(void)
+{
+   TUDEF("FFStream", "compressed nav");
+   bool compressed;
+   string plain = readNav(navFile, compressed);
+   TUASSERT(!compressed);
+
+   string got = readNav(navFile + ".Z", compressed);
+   TUASSERT(compressed);
+   TUASSERTE(string, plain, got);
+
+#ifdef GPSTK_HAVE_ZLIB
+   got = readNav(navFile + ".gz", compressed);
+   TUASSERT(compressed);
+   TUASSERTE(string, plain, got);
+#endif
+
+   TURETURN();
+}
+
+
+int CompressedStream_T ::
+closeTest(void)
+{
+   TUDEF("FFStream", "close");
+   string plainLine, line;
+   {
+      ifstream in(obsFile.c_str());
+      getline(in, plainLine);
+   }
+
+   FFStream strm((obsFile + ".Z").c_str());
+   getline(strm, line);
+   TUASSERT(strm.isCompressed());
+   TUASSERTE(string, plainLine, line);
+   strm.close();
+   TUASSERT(!strm.isCompressed());
+   TUASSERT(!strm.is_open());
+
+      // Reopening a plain file reads it through the file buffer
+   strm.open(obsFile.c_str(), ios::in);
+   TUASSERT(!strm.isCompressed());
+   line.clear();
+   getline(strm, line);
+   TUASSERTE(string, plainLine, line);
+
+      // and a compressed one again through a new decompressor
+   strm.open((obsFile + ".Z").c_str(), ios::in);
+   TUASSERT(strm.isCompressed());
+   line.clear();
+   getline(strm, line);
+   TUASSERTE(string, plainLine, line);
+
+   TURETURN();
+}
+
+
+int CompressedStream_T ::
+truncatedTest(void)
+{
+   TUDEF("FFStream", "truncated");
+   string cut = tempFilePath + "test_output_compressed_Truncated.06o.Z";
+   {
+      ifstream in((obsFile + ".Z").c_str(), ios::binary);
+      string z((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+      ofstream out(cut.c_str(), ios::binary);
+      out.write(z.data(), z.size() / 2);
+   }
+
+   bool compressed;
+   string plain = readObs(obsFile, compressed);
+   string got;
+   try
+   {
+      got = readObs(cut, compressed);
+   }
+   catch (Exception& e)
+   {
+   }
+   TUASSERT(compressed);
+      // Only the records before the cut are read
+   TUASSERT(got.size() < plain.size());
+
+      // With exceptions enabled, the cut ends in an error
+   Rinex3ObsStream strm(cut.c_str());
+   strm.exceptions(ios::failbit);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData data;
+   try
+   {
+      strm >> hdr;
+      while (strm >> data)
+      {
+      }
+      TUFAIL("No error at the cut");
+   }
+   catch (FFStreamError& e)
+   {
+      TUPASS("error at the cut");
+   }
+   catch (...)
+   {
+      TUFAIL("Unexpected exception");
+   }
+
+   TURETURN();
+}
+
+
+int main(void)
+{
+   CompressedStream_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.obsTest();
+   errorTotal += testClass.navTest();
+   errorTotal += testClass.closeTest();
+   errorTotal += testClass.truncatedTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,366 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#include "ProductCache.hpp"
+#include "Rinex3EphemerisStore.hpp"
+#include "FileUtils.hpp"
+#include "CivilTime.hpp"
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /** Tests for ProductCache, and for the cache of the records read by
+    * Rinex3EphemerisStore::loadFile(). The product files are copied to
+    * the test output directory, where they can be changed. */
+class ProductCache_T
+{
+public:
+   ProductCache_T();
+   ~ProductCache_T();
+
+      /// A missing entry is created, and then found with the same data.
+   int hitMissTest(void);
+      /// A change in the product file hides its entry.
+   int staleTest(void);
+      /// Truncated or corrupt entries are not used.
+   int corruptTest(void);
+      /// Rinex3EphemerisStore loads the same data with and without the
+      /// cache, in all the cases above.
+   int navStoreTest(void);
+
+private:
+   string dataFilePath;
+   string tempFilePath;
+   string cacheDir;
+   string navFile, navFile2;
+   string srcFile;
+
+      /// Copy a file.
+   static void copyFile(const string& from, const string& to);
+      /// Size of a file, -1 if it can't be read.
+   static long fileSize(const string& fn);
+      /// Cut a file to n bytes.
+   static void truncateFile(const string& fn, long n);
+      /// Contents of a Rinex3EphemerisStore loaded from a file.
+   static string loadNav(const string& fn, int& nread);
+      /// Write a small entry for the kind "test".
+   static bool writeTestEntry(const string& fn);
+};
+
+
+ProductCache_T ::
+ProductCache_T()
+{
+   dataFilePath = getPathData() + getFileSep();
+   tempFilePath = getPathTestTemp() + getFileSep();
+   cacheDir = tempFilePath + "test_output_product_cache";
+   FileUtils::makeDir(cacheDir, 0755);
+   navFile = dataFilePath + "arlm200a.15n";
+   navFile2 = dataFilePath + "arlm200b.15n";
+   srcFile = tempFilePath + "test_output_product_cache_src.15n";
+   ProductCache::setDirectory(cacheDir);
+}
+
+
+ProductCache_T ::
+~ProductCache_T()
+{
+   ProductCache::setDirectory(string());
+}
+
+
+void ProductCache_T ::
+copyFile(const string& from, const string& to)
+{
+   ifstream in(from.c_str(), ios::binary);
+   ofstream out(to.c_str(), ios::binary|ios::trunc);
+   out << in.rdbuf();
+}
+
+
+long ProductCache_T ::
+fileSize(const string& fn)
+{
+   ifstream in(fn.c_str(), ios::binary|ios::ate);
+   if (!in)
+      return -1;
+   return static_cast<long>(in.tellg());
+}
+
+
+void ProductCache_T ::
+truncateFile(const string& fn, long n)
+{
+   string data;
+   {
+      ifstream in(fn.c_str(), ios::binary);
+      data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+   }
+   ofstream out(fn.c_str(), ios::binary|ios::trunc);
+   out.write(data.data(), n);
+}
+
+
+string ProductCache_T ::
+loadNav(const string& fn, int& nread)
+{
+   Rinex3EphemerisStore store;
+   nread = store.loadFile(fn);
+   ostringstream oss;
+   store.dump(oss, 2);
+   return oss.str();
+}
+
+
+bool ProductCache_T ::
+writeTestEntry(const string& fn)
+{
+   ProductCache cache;
+   if (!cache.createEntry(fn, "test"))
+      return false;
+   cache.writeCount(2);
+   cache.writeString("first");
+   cache.writeTime(CivilTime(2015, 1, 1, 12, 0, 30.5, TimeSystem::GPS));
+   cache.writeSatID(SatID(7, SatID::systemGalileo));
+   cache.writeTriple(Triple(1.5, -2.25, 3e7));
+   return cache.commitEntry();
+}
+
+
+int ProductCache_T ::
+hitMissTest(void)
+{
+   TUDEF("ProductCache", "openEntry");
+   copyFile(navFile, srcFile);
+   string entry = ProductCache::entryFile(srcFile, "test");
+   TUASSERT(!entry.empty());
+   std::remove(entry.c_str());
+
+      // miss
+   ProductCache miss;
+   TUASSERT(!miss.openEntry(srcFile, "test"));
+
+   TUASSERT(writeTestEntry(srcFile));
+   TUASSERT(fileSize(entry) > 0);
+
+      // hit, with the data written
+   ProductCache hit;
+   TUASSERT(hit.openEntry(srcFile, "test"));
+   string s;
+   CommonTime t;
+   SatID sat;
+   Triple tr;
+   TUASSERTE(size_t, 2, hit.getCount(1));
+   hit.getString(s);
+   hit.getTime(t);
+   hit.getSatID(sat);
+   hit.getTriple(tr);
+   TUASSERT(static_cast<bool>(hit));
+   TUASSERTE(string, "first", s);
+   TUASSERTE(CommonTime,
+             CommonTime(CivilTime(2015, 1, 1, 12, 0, 30.5, TimeSystem::GPS)),
+             t);
+   TUASSERTE(SatID, SatID(7, SatID::systemGalileo), sat);
+   TUASSERTE(Triple, Triple(1.5, -2.25, 3e7), tr);
+
+      // another kind is another entry
+   ProductCache other;
+   TUASSERT(!other.openEntry(srcFile, "test2"));
+
+      // no cache at all
+   ProductCache::setDirectory(string());
+   ProductCache disabled;
+   TUASSERT(!disabled.openEntry(srcFile, "test"));
+   TUASSERT(ProductCache::entryFile(srcFile, "test").empty());
+   ProductCache::setDirectory(cacheDir);
+
+   TURETURN();
+}
+
+
+int ProductCache_T ::
+staleTest(void)
+{
+   TUDEF("ProductCache", "openEntry");
+   copyFile(navFile, srcFile);
+   TUASSERT(writeTestEntry(srcFile));
+   ProductCache before;
+   TUASSERT(before.openEntry(srcFile, "test"));
+
+      // changing the contents, but not the size, hides the entry
+   string entry = ProductCache::entryFile(srcFile, "test");
+   {
+      fstream f(srcFile.c_str(), ios::in|ios::out|ios::binary);
+      f.seekp(0);
+      f.put('X');
+   }
+   ProductCache after;
+   TUASSERT(!after.openEntry(srcFile, "test"));
+   TUASSERT(ProductCache::entryFile(srcFile, "test") != entry);
+
+   TURETURN();
+}
+
+
+int ProductCache_T ::
+corruptTest(void)
+{
+   TUDEF("ProductCache", "openEntry");
+   copyFile(navFile, srcFile);
+   string entry = ProductCache::entryFile(srcFile, "test");
+
+      // truncated in the header
+   TUASSERT(writeTestEntry(srcFile));
+   truncateFile(entry, 12);
+   ProductCache cut;
+   TUASSERT(!cut.openEntry(srcFile, "test"));
+
+      // garbage with the name of the entry
+   {
+      ofstream out(entry.c_str(), ios::binary|ios::trunc);
+      for (int i = 0; i < 200; i++)
+         out.put(static_cast<char>(i * 37));
+   }
+   ProductCache garbage;
+   TUASSERT(!garbage.openEntry(srcFile, "test"));
+
+      // truncated in the data
+   TUASSERT(writeTestEntry(srcFile));
+   truncateFile(entry, fileSize(entry) - 20);
+   ProductCache data;
+   TUASSERT(!data.openEntry(srcFile, "test"));
+
+      // a changed byte in the data
+   TUASSERT(writeTestEntry(srcFile));
+   {
+      fstream f(entry.c_str(), ios::in|ios::out|ios::binary);
+      f.seekp(fileSize(entry) - 12);
+      f.put('X');
+   }
+   ProductCache changed;
+   TUASSERT(!changed.openEntry(srcFile, "test"));
+
+      // a count larger than the data left fails
+   {
+      ProductCache big;
+      TUASSERT(big.createEntry(srcFile, "test"));
+      big.writeCount(1000000);
+      TUASSERT(big.commitEntry());
+   }
+   ProductCache count;
+   TUASSERT(count.openEntry(srcFile, "test"));
+   TUASSERTE(size_t, 0, count.getCount(8));
+   TUASSERT(!count);
+
+   TURETURN();
+}
+
+
+int ProductCache_T ::
+navStoreTest(void)
+{
+   TUDEF("Rinex3EphemerisStore", "loadFile");
+   int nplain, n;
+
+   copyFile(navFile, srcFile);
+   ProductCache::setDirectory(string());
+   string plain = loadNav(srcFile, nplain);
+   TUASSERT(nplain > 0);
+   ProductCache::setDirectory(cacheDir);
+
+   string entry = ProductCache::entryFile(srcFile, "rnx3nav");
+   std::remove(entry.c_str());
+
+      // miss: the file is parsed and the entry written
+   TUASSERTE(string, plain, loadNav(srcFile, n));
+   TUASSERTE(int, nplain, n);
+   long entrySize = fileSize(entry);
+   TUASSERT(entrySize > 0);
+
+      // hit: the entry is read
+   TUASSERTE(string, plain, loadNav(srcFile, n));
+   TUASSERTE(int, nplain, n);
+
+      // a truncated entry is ignored, and written again
+   truncateFile(entry, entrySize / 2);
+   TUASSERTE(string, plain, loadNav(srcFile, n));
+   TUASSERTE(int, nplain, n);
+   TUASSERTE(long, entrySize, fileSize(entry));
+
+      // a corrupt entry with a good header is ignored too
+   {
+      fstream f(entry.c_str(), ios::in|ios::out|ios::binary);
+      f.seekp(entrySize - 100);
+      for (int i = 0; i < 100; i++)
+         f.put(static_cast<char>(0xff));
+   }
+   TUASSERTE(string, plain, loadNav(srcFile, n));
+   TUASSERTE(int, nplain, n);
+
+      // stale: the source file changed, so it is parsed again
+   copyFile(navFile2, srcFile);
+   ProductCache::setDirectory(string());
+   string plain2 = loadNav(srcFile, nplain);
+   ProductCache::setDirectory(cacheDir);
+   TUASSERT(plain2 != plain);
+   TUASSERTE(string, plain2, loadNav(srcFile, n));
+   TUASSERTE(int, nplain, n);
+
+   TURETURN();
+}
+
+
+int main(void)
+{
+   ProductCache_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.hitMissTest();
+   errorTotal += testClass.staleTest();
+   errorTotal += testClass.corruptTest();
+   errorTotal += testClass.navStoreTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
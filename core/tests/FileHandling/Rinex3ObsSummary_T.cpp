@@ -0,0 +1,345 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "Rinex3ObsSummary.hpp"
+#include "CivilTime.hpp"
+
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsSummary_T
+{
+public:
+   Rinex3ObsSummary_T()
+   {
+      string dp(getPathData() + getFileSep());
+      dataRinexObsFile = dp + "test_input_rinex3_obs_RinexObsFile.15o";
+      dataRinex2ObsFile = dp + "arlm200a.15o";
+      dataBadEpochFlag = dp + "test_input_rinex3_obs_BadEpochFlag.15o";
+
+      t0 = CivilTime(2015,1,1,0,0,0.0,TimeSystem::GPS);
+      header.firstObs = CivilTime(t0);
+      header.mapObsTypes["G"].push_back(RinexObsID("GC1C"));
+      header.mapObsTypes["G"].push_back(RinexObsID("GL1C"));
+   }
+
+      /** Add the records of a made up file to summary, every 30 s
+       * from t0:
+       * 0, 30, 60 s; an auxiliary header at 60 s; 150 s (a gap);
+       * 90 and 120 s (out of order); 180 and 210 s. G01 is in every
+       * record, G02 at 0, 60 and 180 s with a zero L1C at 0 s, and G03
+       * only at 210 s.
+       * @return the statuses returned by add(). */
+   vector<Rinex3ObsSummary::RecordStatus> addRecords(Rinex3ObsSummary& summary)
+   {
+      struct { double sec; short flag; int prn; double c1, l1; } recs[] = {
+         {   0, 0, 1, 1, 2 }, {   0, 0, 2, 3, 0 },
+         {  30, 0, 1, 1, 2 },
+         {  60, 0, 1, 1, 2 }, {  60, 0, 2, 3, 4 },
+         {  60, 4, 0, 0, 0 },
+         { 150, 0, 1, 1, 2 },
+         {  90, 0, 1, 1, 2 },
+         { 120, 0, 1, 1, 2 },
+         { 180, 0, 1, 1, 2 }, { 180, 0, 2, 5, 4 },
+         { 210, 0, 1, 1, 2 }, { 210, 0, 3, 7, 8 } };
+      const size_t nrecs = sizeof(recs)/sizeof(recs[0]);
+
+      vector<Rinex3ObsSummary::RecordStatus> status;
+      size_t i, j;
+      for(i=0; i<nrecs; i=j)
+      {
+         Rinex3ObsData rod;
+         rod.time = t0 + recs[i].sec;
+         rod.epochFlag = recs[i].flag;
+            // the data of each satellite at the same epoch
+         for(j=i; j<nrecs && recs[j].sec == recs[i].sec &&
+                recs[j].flag == recs[i].flag; j++)
+         {
+            if(recs[j].prn == 0)
+               continue;
+            vector<RinexDatum> data(2);
+            data[0].data = recs[j].c1;
+            data[1].data = recs[j].l1;
+            rod.obs[RinexSatID(recs[j].prn, SatID::systemGPS)] = data;
+         }
+         rod.numSVs = rod.obs.size();
+         status.push_back(summary.add(rod));
+      }
+      return status;
+   }
+
+      /// The whole summary, as text, to compare summaries.
+   static string dumpSummary(const Rinex3ObsSummary& summary)
+   {
+      ostringstream oss;
+      oss << summary.getEpochCount() << " " << summary.getAuxHeaderCount()
+          << " " << summary.getFirstEpoch() << " " << summary.getLastEpoch()
+          << " " << summary.getInterval() << " "
+          << summary.getTimeSystem() << endl;
+      const vector<int>& gaps(summary.getEpochGaps());
+      for(size_t i=0; i<gaps.size(); i++)
+         oss << " " << gaps[i];
+      oss << endl;
+      const vector<Rinex3ObsSummary::SatSummary>& sats(summary.getSatellites());
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         oss << sats[i].sat << " " << sats[i].begin << " " << sats[i].end;
+         for(size_t j=0; j<sats[i].gaps.size(); j++)
+            oss << " " << sats[i].gaps[j];
+         for(size_t j=0; j<sats[i].obs.size(); j++)
+         {
+            const Rinex3ObsSummary::ObsTypeSummary& ots(sats[i].obs[j]);
+            oss << " " << ots.count;
+            if(ots.count > 0)
+               oss << " " << ots.first << " " << ots.last << " "
+                   << ots.stats.Average();
+         }
+         oss << endl;
+      }
+      map<char, vector<int> >::const_iterator it;
+      for(it = summary.getTotals().begin(); it != summary.getTotals().end();
+          ++it)
+      {
+         oss << it->first;
+         for(size_t j=0; j<it->second.size(); j++)
+            oss << " " << it->second[j];
+         oss << endl;
+      }
+      const vector<Rinex3ObsSummary::OutOfOrderBlock>&
+         ooo(summary.getOutOfOrder());
+      for(size_t i=0; i<ooo.size(); i++)
+         oss << ooo[i].after << " " << ooo[i].first << " " << ooo[i].last
+             << " " << ooo[i].count << endl;
+      return oss.str();
+   }
+
+      /** Read fileName with read(strm,pipelined).
+       * @param[out] nhook number of calls of the record hook.
+       * @return the summary, as text. */
+   static string readFile(const string& fileName, bool pipelined,
+                          bool& ok, string& error, int& nhook)
+   {
+      Rinex3ObsStream strm(fileName.c_str());
+      strm.exceptions(ios::failbit);
+      Rinex3ObsHeader head;
+      strm >> head;
+
+      Rinex3ObsSummary summary;
+      summary.setInterval(30.0);
+      summary.reset(head);
+      nhook = 0;
+      Rinex3ObsSummary::RecordHook hook =
+         [&nhook](const Rinex3ObsData&, Rinex3ObsSummary::RecordStatus)
+         { nhook++; };
+      ok = summary.read(strm, pipelined, hook);
+      error = summary.getReadError();
+      return dumpSummary(summary);
+   }
+
+      /** Counts, gaps and out of order blocks of the made up file. */
+   int addTest(void)
+   {
+      TUDEF("Rinex3ObsSummary", "add");
+      Rinex3ObsSummary summary;
+      summary.setInterval(30.0);
+      vector<RinexSatID> only, excluded(1, RinexSatID(3, SatID::systemGPS));
+      summary.setSatellites(only, excluded);
+      summary.reset(header);
+      TUASSERT(!summary.isSelected(RinexSatID(3, SatID::systemGPS)));
+      TUASSERT(summary.isSelected(RinexSatID(2, SatID::systemGPS)));
+
+      vector<Rinex3ObsSummary::RecordStatus> status(addRecords(summary));
+      Rinex3ObsSummary::RecordStatus expStatus[] = {
+         Rinex3ObsSummary::Accepted, Rinex3ObsSummary::Accepted,
+         Rinex3ObsSummary::Accepted, Rinex3ObsSummary::Auxiliary,
+         Rinex3ObsSummary::Accepted, Rinex3ObsSummary::OutOfOrder,
+         Rinex3ObsSummary::OutOfOrder, Rinex3ObsSummary::Accepted,
+         Rinex3ObsSummary::Accepted };
+      TUASSERTE(size_t, 9, status.size());
+      for(size_t i=0; i<status.size() && i<9; i++)
+         TUASSERTE(int, expStatus[i], status[i]);
+
+         // out of order records are epochs, auxiliary headers are not
+      TUASSERTE(int, 8, summary.getEpochCount());
+      TUASSERTE(int, 1, summary.getAuxHeaderCount());
+      TUASSERTE(CommonTime, t0, summary.getFirstEpoch());
+      TUASSERTE(CommonTime, t0 + 210.0, summary.getLastEpoch());
+      TUASSERTE(double, 30.0, summary.getInterval());
+
+         // spans of epochs 0-2 and 5-7
+      int expGaps[] = { 0, 2, 5, 7 };
+      TUASSERT(summary.getEpochGaps() == vector<int>(expGaps, expGaps+4));
+
+      TUCSM("getOutOfOrder");
+      TUASSERTE(size_t, 1, summary.getOutOfOrder().size());
+      if(summary.getOutOfOrder().size() == 1)
+      {
+         const Rinex3ObsSummary::OutOfOrderBlock& b(summary.getOutOfOrder()[0]);
+         TUASSERTE(CommonTime, t0 + 150.0, b.after);
+         TUASSERTE(CommonTime, t0 + 90.0, b.first);
+         TUASSERTE(CommonTime, t0 + 120.0, b.last);
+         TUASSERTE(int, 2, b.count);
+      }
+
+      TUCSM("getSatellites");
+      const vector<Rinex3ObsSummary::SatSummary>& sats(summary.getSatellites());
+      TUASSERTE(size_t, 2, sats.size());
+      if(sats.size() == 2)
+      {
+         TUASSERTE(RinexSatID, RinexSatID(1, SatID::systemGPS), sats[0].sat);
+         TUASSERTE(int, 6, sats[0].count(0));
+         TUASSERTE(int, 6, sats[0].count(1));
+         TUASSERT(sats[0].gaps == vector<int>(expGaps, expGaps+4));
+         TUASSERTE(CommonTime, t0, sats[0].begin);
+         TUASSERTE(CommonTime, t0 + 210.0, sats[0].end);
+
+         TUASSERTE(RinexSatID, RinexSatID(2, SatID::systemGPS), sats[1].sat);
+         TUASSERTE(int, 3, sats[1].count(0));
+            // the zero L1C at 0 s is not counted
+         TUASSERTE(int, 2, sats[1].count(1));
+         TUASSERTE(CommonTime, t0 + 60.0, sats[1].obs[1].first);
+         TUASSERTE(CommonTime, t0 + 180.0, sats[1].obs[1].last);
+         TUASSERTFE(11.0/3.0, sats[1].obs[0].stats.Average());
+         int expGaps2[] = { 0, 0, 2, 2, 6, 6 };
+         TUASSERT(sats[1].gaps == vector<int>(expGaps2, expGaps2+6));
+         TUASSERTE(CommonTime, t0 + 180.0, sats[1].end);
+         TUASSERTE(int, 0, sats[1].count(2));
+      }
+
+      TUCSM("getTotals");
+      TUASSERTE(size_t, 1, summary.getTotals().size());
+      int expTotals[] = { 9, 8 };
+      TUASSERT(summary.getTotals().find('G')->second ==
+               vector<int>(expTotals, expTotals+2));
+
+         // reset() starts again from scratch
+      TUCSM("reset");
+      summary.reset(header);
+      TUASSERTE(int, 0, summary.getEpochCount());
+      TUASSERTE(size_t, 0, summary.getSatellites().size());
+      TUASSERTE(size_t, 0, summary.getOutOfOrder().size());
+      TUASSERTE(size_t, 0, summary.getEpochGaps().size());
+      TURETURN();
+   }
+
+      /** Records outside the time limits are ignored. */
+   int timeLimitsTest(void)
+   {
+      TUDEF("Rinex3ObsSummary", "setTimeLimits");
+      Rinex3ObsSummary summary;
+      summary.setTimeLimits(t0 + 30.0, t0 + 150.0);
+      summary.reset(header);
+
+      vector<Rinex3ObsSummary::RecordStatus> status(addRecords(summary));
+      TUASSERTE(size_t, 9, status.size());
+      if(status.size() == 9)
+      {
+         TUASSERTE(int, Rinex3ObsSummary::BeforeBegin, status[0]);
+         TUASSERTE(int, Rinex3ObsSummary::Accepted, status[1]);
+         TUASSERTE(int, Rinex3ObsSummary::AfterEnd, status[7]);
+         TUASSERTE(int, Rinex3ObsSummary::AfterEnd, status[8]);
+      }
+      TUASSERTE(int, 5, summary.getEpochCount());
+      TUASSERTE(CommonTime, t0 + 30.0, summary.getFirstEpoch());
+      TUASSERTE(CommonTime, t0 + 120.0, summary.getLastEpoch());
+         // no interval given, so no gaps
+      TUASSERTE(size_t, 0, summary.getEpochGaps().size());
+      TURETURN();
+   }
+
+      /** read(strm,true) gives the same summary as read(strm,false). */
+   int readTest(void)
+   {
+      TUDEF("Rinex3ObsSummary", "read");
+      string files[] = { dataRinexObsFile, dataRinex2ObsFile };
+      for(int i=0; i<2; i++)
+      {
+         bool ok1, ok2;
+         string err1, err2;
+         int nhook1, nhook2;
+         string serial(readFile(files[i], false, ok1, err1, nhook1));
+         string pipelined(readFile(files[i], true, ok2, err2, nhook2));
+         TUASSERT(ok1);
+         TUASSERT(ok2);
+         TUASSERTE(string, serial, pipelined);
+         TUASSERTE(int, nhook1, nhook2);
+         TUASSERT(nhook1 > 0);
+      }
+
+         // an error stops both in the same place
+      bool ok1, ok2;
+      string err1, err2;
+      int nhook1, nhook2;
+      string serial(readFile(dataBadEpochFlag, false, ok1, err1, nhook1));
+      string pipelined(readFile(dataBadEpochFlag, true, ok2, err2, nhook2));
+      TUASSERT(!ok1);
+      TUASSERT(!ok2);
+      TUASSERT(!err1.empty());
+      TUASSERTE(string, err1, err2);
+      TUASSERTE(string, serial, pipelined);
+      TUASSERTE(int, nhook1, nhook2);
+      TURETURN();
+   }
+
+private:
+   string dataRinexObsFile;
+   string dataRinex2ObsFile;
+   string dataBadEpochFlag;
+
+   CommonTime t0;
+   Rinex3ObsHeader header;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   Rinex3ObsSummary_T testClass;
+
+   errorTotal += testClass.addTest();
+   errorTotal += testClass.timeLimitsTest();
+   errorTotal += testClass.readTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -1,15 +1,152 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "IonoModelStore.hpp"
+#include "CivilTime.hpp"
+
 #include "TestUtil.hpp"
 #include <iostream>
+#include <vector>
 
-class IonoModelStoreTest
+using namespace std;
+using namespace gpstk;
+
+class IonoModelStore_T
 {
-        public: 
-		IonoModelStoreTest(){}// Default Constructor, set the precision value
-		~IonoModelStoreTest() {} // Default Desructor
+public:
+   IonoModelStore_T()
+         : rxgeo(30.0, 262.0, 200.0, Position::Geodetic)
+   {
+      double a1[4] = { 1.118e-08, -7.451e-09, -5.960e-08, 1.192e-07 };
+      double b1[4] = { 90112., -655360., -262144., 1966080. };
+      double a2[4] = { 1.397e-08, -7.451e-09, -5.960e-08, 5.960e-08 };
+      double b2[4] = { 96256., -196608., -131072., 458752. };
+      model1 = IonoModel(a1, b1);
+      model2 = IonoModel(a2, b2);
+      t1 = CivilTime(2015,7,19,0,0,0.0,TimeSystem::GPS);
+      t2 = CivilTime(2015,7,20,0,0,0.0,TimeSystem::GPS);
+      store.addIonoModel(t1, model1);
+      store.addIonoModel(t2, model2);
+
+      double el[] = { 5., 15., 30., 45., 60., 89. };
+      double az[] = { 0., 45., 135., 200., 270., 330. };
+      svel.assign(el, el + 6);
+      svaz.assign(az, az + 6);
+   }
+
+      /// getIonoModel() returns the model in effect at a time.
+   int getIonoModelTest(void)
+   {
+      TUDEF("IonoModelStore", "getIonoModel");
+      TUASSERT(store.getIonoModel(t1) == model1);
+      TUASSERT(store.getIonoModel(t1 + 3600.) == model1);
+      TUASSERT(store.getIonoModel(t2) == model2);
+      TUASSERT(store.getIonoModel(t2 + 86400.) == model2);
+      try
+      {
+         store.getIonoModel(t1 - 1.);
+         TUFAIL("getIonoModel() before the first model should throw");
+      }
+      catch(IonoModelStore::NoIonoModelFound& e)
+      {
+         TUPASS("getIonoModel() before the first model");
+      }
+      TURETURN();
+   }
+
+      /** getCorrections() gives the values of getCorrection(), with
+       * each model, at 20:30 GPS, i.e. in the local afternoon. */
+   int getCorrectionsTest(void)
+   {
+      TUDEF("IonoModelStore", "getCorrections");
+      CommonTime times[] = { t1 + 73800., t2 + 73800. };
+      vector<double> corr;
+      for(int t = 0; t < 2; t++)
+      {
+         store.getCorrections(times[t], rxgeo, svel, svaz, corr);
+         TUASSERTE(size_t, svel.size(), corr.size());
+         for(size_t i = 0; i < svel.size(); i++)
+         {
+            TUASSERTFE(store.getCorrection(times[t], rxgeo, svel[i], svaz[i]),
+                       corr[i]);
+         }
+         store.getCorrections(times[t], rxgeo, svel, svaz, corr,
+                              IonoModel::L2);
+         for(size_t i = 0; i < svel.size(); i++)
+         {
+            TUASSERTFE(store.getCorrection(times[t], rxgeo, svel[i], svaz[i],
+                                           IonoModel::L2),
+                       corr[i]);
+         }
+      }
+         // the two models give different corrections
+      vector<double> corr1, corr2;
+      store.getCorrections(times[0], rxgeo, svel, svaz, corr1);
+      store.getCorrections(times[0] + 86400., rxgeo, svel, svaz, corr2);
+      TUASSERT(corr1 != corr2);
+
+      try
+      {
+         store.getCorrections(t1 - 1., rxgeo, svel, svaz, corr);
+         TUFAIL("getCorrections() before the first model should throw");
+      }
+      catch(IonoModelStore::NoIonoModelFound& e)
+      {
+         TUPASS("getCorrections() before the first model");
+      }
+      TURETURN();
+   }
+
+private:
+   Position rxgeo;
+   IonoModel model1, model2;
+   CommonTime t1, t2;
+   IonoModelStore store;
+   vector<double> svel, svaz;
 };
 
 
-int main() //Main function to initialize and run all tests above
+int main(void)
 {
-	return 0; //Return the total number of errors
+   int errorTotal = 0;
+   IonoModelStore_T testClass;
+
+   errorTotal += testClass.getIonoModelTest();
+   errorTotal += testClass.getCorrectionsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
 }
@@ -36,6 +36,8 @@
 
 #include "TestUtil.hpp"
 #include "IonoModel.hpp"
+#include "CivilTime.hpp"
+#include <vector>
 
 using namespace gpstk;
 using namespace std;
@@ -49,6 +51,7 @@ class IonoModel_T
         int nonEqualityTest( void );
         int validTest( void );
         int exceptionTest( void );
+        int getCorrectionsTest( void );
     protected:
     private:
 };
@@ -302,6 +305,72 @@ int IonoModel_T :: exceptionTest( void )
 
 }
 
+//------------------------------------------------------------
+// Assert that getCorrections() gives the values of getCorrection()
+//------------------------------------------------------------
+int IonoModel_T :: getCorrectionsTest( void )
+{
+    TestUtil test5( "IonoModel", "getCorrections", __FILE__, __LINE__ );
+
+    double a[4] = {1.118e-08, -7.451e-09, -5.960e-08, 1.192e-07};
+    double b[4] = {90112., -655360., -262144., 1966080.};
+    gpstk::IonoModel model(a,b);
+
+    gpstk::CommonTime time = gpstk::CivilTime(2015,7,19,20,30,0.0,
+                                              gpstk::TimeSystem::GPS);
+    gpstk::Position rxgeo(30.0, 262.0, 200.0, gpstk::Position::Geodetic);
+
+    double el[] = { 5., 15., 30., 45., 60., 89. };
+    double az[] = { 0., 45., 135., 200., 270., 330. };
+    std::vector<double> svel(el, el + 6), svaz(az, az + 6), corr;
+
+    //---------------------------------
+    // Each value is that of getCorrection(), on both frequencies
+    //---------------------------------
+    model.getCorrections( time, rxgeo, svel, svaz, corr );
+    test5.assert( corr.size() == svel.size(), "one correction per satellite", __LINE__ );
+    for (size_t i = 0; i < svel.size(); i++)
+        test5.assert_equals( model.getCorrection(time, rxgeo, el[i], az[i]), corr[i], __LINE__ );
+
+    model.getCorrections( time, rxgeo, svel, svaz, corr, model.L2 );
+    for (size_t i = 0; i < svel.size(); i++)
+        test5.assert_equals( model.getCorrection(time, rxgeo, el[i], az[i], model.L2), corr[i], __LINE__ );
+
+    //---------------------------------
+    // No satellites
+    //---------------------------------
+    std::vector<double> none;
+    model.getCorrections( time, rxgeo, none, none, corr );
+    test5.assert( corr.empty(), "no satellites should give no corrections", __LINE__ );
+
+    //---------------------------------
+    // An invalid model, and azimuths that do not match the elevations
+    //---------------------------------
+    try
+    {
+        gpstk::IonoModel invalid;
+        invalid.getCorrections( time, rxgeo, svel, svaz, corr );
+        test5.assert( false, "getCorrections() with an invalid model should have thrown an InvalidIonoModel exception", __LINE__ );
+    }
+    catch( gpstk::IonoModel::InvalidIonoModel& e )
+    {
+        test5.assert( true, "getCorrections() with an invalid model threw an InvalidIonoModel exception as expected", __LINE__ );
+    }
+
+    try
+    {
+        svaz.pop_back();
+        model.getCorrections( time, rxgeo, svel, svaz, corr );
+        test5.assert( false, "getCorrections() with fewer azimuths than elevations should have thrown an InvalidIonoModel exception", __LINE__ );
+    }
+    catch( gpstk::IonoModel::InvalidIonoModel& e )
+    {
+        test5.assert( true, "getCorrections() with fewer azimuths than elevations threw an InvalidIonoModel exception as expected", __LINE__ );
+    }
+
+    return( test5.countFails() );
+}
+
 //------------------------------------------------------------
 // main()
 //------------------------------------------------------------
@@ -322,6 +391,9 @@ int main( void )
     check = testClass.exceptionTest();
     errorCounter += check;
 
+    check = testClass.getCorrectionsTest();
+    errorCounter += check;
+
     std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
 
     return( errorCounter );
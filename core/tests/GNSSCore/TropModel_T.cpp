@@ -1,15 +1,157 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "SaasTropModel.hpp"
+#include "NeillTropModel.hpp"
+#include "GlobalTropModel.hpp"
+#include "CivilTime.hpp"
+#include "MJD.hpp"
+
 #include "TestUtil.hpp"
 #include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
 
 class TropModel_T
 {
-        public: 
-		TropModel_T(){}// Default Constructor, set the precision value
-		~TropModel_T() {} // Default Desructor
+public:
+   TropModel_T()
+   {
+      double el[] = { 5., 10., 15., 30., 45., 60., 75., 89.9 };
+      elevations.assign(el, el + sizeof(el)/sizeof(el[0]));
+   }
+
+      /** Check that corrections() gives, for each elevation, the
+       * values of correction(), dry_mapping_function() and
+       * wet_mapping_function(). */
+   void checkCorrections(TestUtil& testFramework, const TropModel& tm)
+   {
+      vector<double> delays, dryMaps, wetMaps;
+      tm.corrections(elevations, delays, dryMaps, wetMaps);
+      TUASSERTE(size_t, elevations.size(), delays.size());
+      TUASSERTE(size_t, elevations.size(), dryMaps.size());
+      TUASSERTE(size_t, elevations.size(), wetMaps.size());
+      for(size_t i = 0; i < elevations.size(); i++)
+      {
+         TUASSERTFE(tm.correction(elevations[i]), delays[i]);
+         TUASSERTFE(tm.dry_mapping_function(elevations[i]), dryMaps[i]);
+         TUASSERTFE(tm.wet_mapping_function(elevations[i]), wetMaps[i]);
+      }
+
+         // no satellites
+      vector<double> none;
+      tm.corrections(none, delays, dryMaps, wetMaps);
+      TUASSERT(delays.empty());
+      TUASSERT(dryMaps.empty());
+      TUASSERT(wetMaps.empty());
+   }
+
+      /// TropModel::corrections(), used by SaasTropModel.
+   int saasCorrectionsTest(void)
+   {
+      TUDEF("SaasTropModel", "corrections");
+      SaasTropModel saas(30.0, 200, 20.0, 1013.0, 50.0);
+      saas.setReceiverHeight(200.0);
+      TUASSERT(saas.isValid());
+      checkCorrections(testFramework, saas);
+      TURETURN();
+   }
+
+      /// NeillTropModel::corrections()
+   int neillCorrectionsTest(void)
+   {
+      TUDEF("NeillTropModel", "corrections");
+      NeillTropModel neill(200.0, 30.0, 200);
+      TUASSERT(neill.isValid());
+      checkCorrections(testFramework, neill);
+         // southern hemisphere
+      neill.setReceiverLatitude(-40.0);
+      checkCorrections(testFramework, neill);
+      TURETURN();
+   }
+
+      /** GlobalTropModel::corrections(), and correction(RX,SV) with
+       * the coefficients kept from one receiver position to the
+       * next. */
+   int globalCorrectionsTest(void)
+   {
+      TUDEF("GlobalTropModel", "corrections");
+      CommonTime t(CivilTime(2015,7,19,1,0,0.0,TimeSystem::GPS));
+      GlobalTropModel global(200.0, 30.0, 262.0,
+                             static_cast<MJD>(t).mjd);
+      TUASSERT(global.isValid());
+      checkCorrections(testFramework, global);
+
+      TUCSM("correction(RX,SV)");
+      Position rx[2], sv;
+      rx[0].setGeodetic(30.0, 262.0, 200.0);
+      rx[1].setGeodetic(-40.0, 20.0, 1000.0);
+      GlobalTropModel reused(rx[0], t);
+         // alternate between the receivers, so that the reused model
+         // recomputes its coefficients at every call
+      for(int i = 0; i < 8; i++)
+      {
+         for(int r = 0; r < 2; r++)
+         {
+            sv.setGeodetic(rx[r].getGeodeticLatitude() + 5.0*i - 20.0,
+                           rx[r].getLongitude() + 5.0*i - 20.0, 20.e6);
+            GlobalTropModel fresh(rx[r], t);
+            TUASSERTFE(fresh.correction(rx[r], sv, t),
+                       reused.correction(rx[r], sv, t));
+         }
+      }
+      TURETURN();
+   }
+
+private:
+   vector<double> elevations;
 };
 
 
-int main() //Main function to initialize and run all tests above
+int main(void)
 {
-	return 0; //Return the total number of errors
+   int errorTotal = 0;
+   TropModel_T testClass;
+
+   errorTotal += testClass.saasCorrectionsTest();
+   errorTotal += testClass.neillCorrectionsTest();
+   errorTotal += testClass.globalCorrectionsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
 }
@@ -46,6 +46,8 @@
 #include "CivilTime.hpp"
 #include "CommonTime.hpp"
 #include "SP3EphemerisStore.hpp"
+#include "ProductCache.hpp"
+#include "FileUtils.hpp"
 #include "TestUtil.hpp"
 
 using namespace gpstk;
@@ -75,6 +77,16 @@ public:
          "test_input_sp3_nav_apcData.sp3";
       inputNotaFile            =  dataFilePath + file_sep + "NotaFILE";
 
+      inputSP3Files.clear();
+      inputSP3Files.push_back(inputSP3Data);
+      inputSP3Files.push_back(dataFilePath + file_sep + "test_input_SP3a.sp3");
+      inputSP3Files.push_back(dataFilePath + file_sep + "test_input_SP3b.sp3");
+      inputSP3Files.push_back(dataFilePath + file_sep + "test_input_SP3c.sp3");
+      inputSP3Files.push_back(inputAPCData);
+
+      cacheDir                 =  tempFilePath + file_sep +
+         "test_output_sp3_cache";
+
       outputDataDump           =  tempFilePath + file_sep + "SP3_DataDump.txt";
 
       inputComparisonOutput1 =
@@ -301,6 +313,75 @@ public:
    }
 
 
+//=============================================================================
+// Test for loadFiles
+// Loads several SP3 files concurrently, without and with the product
+// cache, and checks that the store is the same as that made by loading
+// them in turn with loadFile()
+//=============================================================================
+   int loadFilesTest (void)
+   {
+      TUDEF( "SP3EphemerisStore", "loadFiles" );
+
+      try
+      {
+         SP3EphemerisStore serialStore;
+         for(size_t i=0; i<inputSP3Files.size(); i++)
+            serialStore.loadFile(inputSP3Files[i]);
+         std::ostringstream serialDump;
+         serialStore.dump(serialDump, 2);
+
+            // no cache, then the cache twice: the first load writes the
+            // entries (unless an earlier run did), the second reads them
+         gpstk::FileUtils::makeDir(cacheDir, 0755);
+         const char *passes[3] = { "no cache", "cache, first load",
+                                   "cache, second load" };
+         for(int pass=0; pass<3; pass++)
+         {
+            ProductCache::setDirectory(pass == 0 ? std::string() : cacheDir);
+
+            SP3EphemerisStore store;
+            store.loadFiles(inputSP3Files, 3);
+            std::ostringstream dump;
+            store.dump(dump, 2);
+
+            testFramework.assert(dump.str() == serialDump.str(),
+                                 std::string("store differs, ") + passes[pass],
+                                 __LINE__);
+            TUASSERTE(int, serialStore.ndata(), store.ndata());
+            TUASSERTE(CommonTime, serialStore.getInitialTime(),
+                      store.getInitialTime());
+            TUASSERTE(CommonTime, serialStore.getFinalTime(),
+                      store.getFinalTime());
+         }
+         ProductCache::setDirectory(std::string());
+
+            // a missing file throws, as loadFile() does
+         std::vector<std::string> badFiles(inputSP3Files);
+         badFiles.insert(badFiles.begin()+1, inputNotaFile);
+         SP3EphemerisStore badStore;
+         try
+         {
+            badStore.loadFiles(badFiles, 2);
+            TUFAIL("loadFiles did not throw for a missing file");
+         }
+         catch (Exception& e)
+         {
+            TUPASS("loadFiles threw for a missing file");
+         }
+      }
+      catch (Exception& e)
+      {
+         ProductCache::setDirectory(std::string());
+         std::ostringstream oss;
+         oss << "Unexpected exception " << e;
+         TUFAIL(oss.str());
+      }
+
+      return testFramework.countFails();
+   }
+
+
 //=============================================================================
 // Test for getFinalTime
 // Tests getFinalTime method in SP3EphemerisStore by ensuring that
@@ -521,6 +602,9 @@ private:
 
    std::string inputNotaFile;
 
+   std::vector<std::string> inputSP3Files;
+   std::string cacheDir;
+
    std::string inputComparisonOutput1;
    std::string inputComparisonOutput15;
    std::string inputComparisonOutput31;
@@ -537,6 +621,7 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getXvtTest();
    errorTotal += testClass.getInitialTimeTest();
    errorTotal += testClass.getFinalTimeTest();
+   errorTotal += testClass.loadFilesTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
 
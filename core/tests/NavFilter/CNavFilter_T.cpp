@@ -74,6 +74,8 @@ public:
    unsigned testCNavCombined();
       /// Test the combination of cook,parity, empty, TOW, and cross-source filters
    unsigned testCNavCrossSource();
+      /// Test the cross-source filter deciding votes early
+   unsigned testCNavCrossSourceEarly();
 
       // This is a list of the PackedNavBit messages that are created from the
       // static strings contained in the loadData( ) method.
@@ -760,6 +762,45 @@ testCNavCrossSource()
    TURETURN();
 }
 
+//-------------------------------------------------------------------
+unsigned CNavFilter_T ::
+testCNavCrossSourceEarly()
+{
+   TUDEF("CNavCrossSource", "setEarlyQuorum");
+
+   CNavCrossSourceFilter filtXSource;
+   filtXSource.setEarlyQuorum(2);
+   TUASSERTE(unsigned, 2, filtXSource.getEarlyQuorum());
+
+      // Submit each message three times.  With a quorum of two, the
+      // first copy is held, the second decides the vote and both are
+      // output at once, and the third is output as soon as it arrives.
+   unsigned long wrongCount = 0;
+   unsigned long rejectCount = 0;
+   list<CNavFilterData>::iterator it; 
+   for (it=cNavList.begin(); it!=cNavList.end(); it++)
+   {
+      for (unsigned n=0; n<3; n++)
+      {
+         NavFilter::NavMsgList in(1, &(*it)), out;
+         filtXSource.rejected.clear();
+         filtXSource.validate(in, out);
+         unsigned long expected = (n==0) ? 0 : ((n==1) ? 2 : 1);
+         if (out.size() != expected)
+            wrongCount++;
+         rejectCount += filtXSource.rejected.size();
+      }
+   }
+   NavFilter::NavMsgList out;
+   filtXSource.rejected.clear();
+   filtXSource.finalize(out);
+   TUASSERTE(unsigned long, 0, wrongCount);
+   TUASSERTE(unsigned long, 0, rejectCount);
+   TUASSERTE(unsigned long, 0, out.size());
+   TUASSERTE(unsigned long, 0, filtXSource.rejected.size());
+   TURETURN();
+}
+
 //-------------------------------------------------------------------
 int main()
 {
@@ -774,6 +815,7 @@ int main()
    errorTotal += testClass.testCNavEmpty();
    errorTotal += testClass.testCNavTOW();
    errorTotal += testClass.testCNavCombined();
+   errorTotal += testClass.testCNavCrossSourceEarly();
    errorTotal += testClass.testCNavCrossSource();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
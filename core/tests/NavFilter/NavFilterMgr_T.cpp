@@ -42,6 +42,7 @@
 #include "LNavEmptyFilter.hpp"
 #include "LNavTLMHOWFilter.hpp"
 #include "LNavEphMaker.hpp"
+#include "LNavCrossSourceFilter.hpp"
 #include "CommonTime.hpp"
 #include "TimeString.hpp"
 
@@ -140,6 +141,10 @@ public:
    unsigned testLNavEphMaker();
       /// Test the combination of parity, empty and TLM/HOW filters
    unsigned testLNavCombined();
+      /// Same as testLNavCombined, validating batches of subframes
+   unsigned testLNavCombinedBatch();
+      /// Test the cross-source filter deciding the vote early
+   unsigned testLNavCrossSourceEarly();
 
       /// test a simple bit pattern filter
    unsigned testBunk1();
@@ -529,6 +534,101 @@ testLNavCombined()
 }
 
 
+unsigned NavFilterMgr_T ::
+testLNavCombinedBatch()
+{
+   TUDEF("NavFilterMgr", "validate");
+
+   NavFilterMgr mgr;
+   unsigned long acceptCount = 0, rejectCount = 0;
+   LNavParityFilter filtParity;
+   LNavEmptyFilter filtEmpty;
+   LNavTLMHOWFilter filtTLMHOW;
+
+   mgr.addFilter(&filtParity);
+   mgr.addFilter(&filtEmpty);
+   mgr.addFilter(&filtTLMHOW);
+
+   const unsigned batchSize = 37;
+   gpstk::NavFilter::NavMsgList batch;
+   for (unsigned i = 0; i < dataIdxLNAV; i += batchSize)
+   {
+      batch.clear();
+      for (unsigned j = i; (j < i+batchSize) && (j < dataIdxLNAV); j++)
+         batch.push_back(&dataLNAV[j]);
+      gpstk::NavFilter::NavMsgList l = mgr.validate(batch);
+      acceptCount += l.size();
+      rejectCount += filtParity.rejected.size() + filtEmpty.rejected.size() +
+         filtTLMHOW.rejected.size();
+   }
+   TUASSERTE(unsigned long, expLNavCombined, dataIdxLNAV - acceptCount);
+   TUASSERTE(unsigned long, expLNavCombined, rejectCount);
+
+   return testFramework.countFails();
+}
+
+
+unsigned NavFilterMgr_T ::
+testLNavCrossSourceEarly()
+{
+   TUDEF("LNavCrossSource", "setEarlyQuorum");
+
+   LNavCrossSourceFilter filtXSource;
+   filtXSource.setEarlyQuorum(2);
+   TUASSERTE(unsigned, 2, filtXSource.getEarlyQuorum());
+
+      // Each subframe gets its own epoch, with a corrupted copy
+      // submitted first and then three good copies.  With a quorum of
+      // two, the vote is decided by the second good copy, when there
+      // are three subframes in total: both good copies are output and
+      // the corrupted one rejected at once, and the third good copy is
+      // output as soon as it arrives.
+   vector<LNavFilterData> good(dataLNAV.begin(),
+                               dataLNAV.begin() + dataIdxLNAV);
+   vector<LNavFilterData> bad(good);
+   vector<uint32_t> badWords(10 * dataIdxLNAV);
+   CommonTime t;
+   for (unsigned long i = 0; i < dataIdxLNAV; i++)
+   {
+      good[i].timeStamp = t + 6.0 * i;
+      bad[i].timeStamp = good[i].timeStamp;
+      copy(good[i].sf, good[i].sf + 10, &badWords[10*i]);
+      badWords[10*i+2] ^= 0x100;
+      bad[i].sf = &badWords[10*i];
+   }
+   const unsigned long expOut[4] = { 0, 0, 2, 1 };
+   const unsigned long expReject[4] = { 0, 0, 1, 0 };
+   unsigned long wrongCount = 0, wrongRejectCount = 0;
+   for (unsigned long i = 0; i < dataIdxLNAV; i++)
+   {
+      LNavFilterData *msgs[4] = { &bad[i], &good[i], &good[i], &good[i] };
+      for (unsigned n = 0; n < 4; n++)
+      {
+         gpstk::NavFilter::NavMsgList in(1, msgs[n]), out;
+         filtXSource.rejected.clear();
+         filtXSource.validate(in, out);
+         if (out.size() != expOut[n])
+            wrongCount++;
+         else if ((n == 2) && (out.front() != &good[i]))
+            wrongCount++;
+         if (filtXSource.rejected.size() != expReject[n])
+            wrongRejectCount++;
+         else if ((n == 2) && (filtXSource.rejected.front() != &bad[i]))
+            wrongRejectCount++;
+      }
+   }
+   gpstk::NavFilter::NavMsgList out;
+   filtXSource.rejected.clear();
+   filtXSource.finalize(out);
+   TUASSERTE(unsigned long, 0, wrongCount);
+   TUASSERTE(unsigned long, 0, wrongRejectCount);
+   TUASSERTE(unsigned long, 0, out.size());
+   TUASSERTE(unsigned long, 0, filtXSource.rejected.size());
+
+   return testFramework.countFails();
+}
+
+
 unsigned NavFilterMgr_T ::
 testBunk1()
 {
@@ -662,6 +762,8 @@ int main()
    errorTotal += testClass.testLNavTLMHOW();
    errorTotal += testClass.testLNavEphMaker();
    errorTotal += testClass.testLNavCombined();
+   errorTotal += testClass.testLNavCombinedBatch();
+   errorTotal += testClass.testLNavCrossSourceEarly();
    errorTotal += testClass.testBunk1();
    errorTotal += testClass.testBunk2();
 
@@ -0,0 +1,176 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "PRSolution.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "TropModel.hpp"
+
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class PRSolution_T
+{
+public:
+   PRSolution_T()
+   {
+      string dp(getPathData() + getFileSep());
+      dataObsFile = dp + "arlm200b.15o";
+      dataSP3File = dp + "test_input_sp3_nav_2015_200.sp3";
+   }
+
+      /** Compare RAIMCompute() with and without the downdate of the
+       * normal equations, for the first epoch of dataObsFile and a
+       * diagonal weight matrix that is not a multiple of the
+       * identity.  The C1 of G06 at that epoch is 2.5 km off its P1,
+       * so RAIM rejects it. */
+   int downdateTest(void)
+   {
+      TUDEF("PRSolution", "RAIMCompute");
+
+      SP3EphemerisStore eph;
+      Rinex3ObsStream strm;
+      Rinex3ObsHeader header;
+      Rinex3ObsData rod;
+      try
+      {
+         eph.loadFile(dataSP3File);
+         strm.open(dataObsFile.c_str(), ios::in);
+         strm >> header;
+         strm >> rod;
+      }
+      catch(Exception& e)
+      {
+         cout << e;
+         TUFAIL("Unable to read the test data");
+         TURETURN();
+      }
+
+         // pseudoranges; G06 is the third satellite
+      const size_t bad = 2;
+      vector<SatID> sats;
+      vector<double> prs;
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it = rod.obs.begin(); it != rod.obs.end(); ++it)
+      {
+         sats.push_back(it->first);
+         prs.push_back(rod.getObs(it->first, "C1C", header).data);
+      }
+      TUASSERT(sats.size() > 6);
+
+         // sigma from 1 m, rising by 0.25 m per satellite
+      Matrix<double> invMC(sats.size(), sats.size(), 0.0);
+      for(size_t i = 0; i < sats.size(); i++)
+      {
+         double sigma = 1.0 + 0.25*i;
+         invMC(i,i) = 1.0/(sigma*sigma);
+      }
+
+      ZeroTropModel trop;
+      PRSolution withDD, withoutDD;
+      withoutDD.RAIMDowndate = false;
+      vector<SatID> satsDD(sats), satsNoDD(sats);
+      vector<SatID::SatelliteSystem> syssDD, syssNoDD;
+      syssDD.push_back(SatID::systemGPS);
+      syssNoDD = syssDD;
+
+      int iretDD = withDD.RAIMCompute(rod.time, satsDD, syssDD, prs, invMC,
+                                      &eph, &trop);
+      int iretNoDD = withoutDD.RAIMCompute(rod.time, satsNoDD, syssNoDD, prs,
+                                           invMC, &eph, &trop);
+      TUASSERTE(int, 0, iretDD);
+      TUASSERTE(int, iretNoDD, iretDD);
+      TUASSERT(withDD.isValid());
+      TUASSERT(withoutDD.isValid());
+
+         // the same satellite, G06, is rejected
+      TUASSERTE(size_t, sats.size(), satsDD.size());
+      TUASSERTE(size_t, sats.size(), satsNoDD.size());
+      for(size_t i = 0; i < sats.size(); i++)
+      {
+         TUASSERTE(int, satsNoDD[i].id, satsDD[i].id);
+         TUASSERTE(bool, i == bad, satsDD[i].id <= 0);
+      }
+      TUASSERTE(int, withoutDD.Nsvs, withDD.Nsvs);
+      TUASSERTE(int, int(sats.size())-1, withDD.Nsvs);
+
+         // the downdate only changes round-off
+      TUASSERTE(size_t, withoutDD.Solution.size(), withDD.Solution.size());
+      for(size_t i = 0; i < withDD.Solution.size(); i++)
+      {
+         TUASSERTFEPS(withoutDD.Solution(i), withDD.Solution(i), 1.e-6);
+      }
+      TUASSERTE(size_t, withoutDD.Covariance.rows(), withDD.Covariance.rows());
+      TUASSERTE(size_t, withoutDD.Covariance.cols(), withDD.Covariance.cols());
+      for(size_t i = 0; i < withDD.Covariance.rows(); i++)
+      {
+         for(size_t j = 0; j < withDD.Covariance.cols(); j++)
+         {
+            TUASSERTFEPS(withoutDD.Covariance(i,j), withDD.Covariance(i,j),
+                         1.e-9);
+         }
+      }
+      TUASSERTFEPS(withoutDD.RMSResidual, withDD.RMSResidual, 1.e-6);
+
+      TURETURN();
+   }
+
+private:
+   string dataObsFile;
+   string dataSP3File;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   PRSolution_T testClass;
+
+   errorTotal += testClass.downdateTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,68 @@
+# Test RinEdit with a large command file.  NCMDS pairs of start and
+# stop commands deleting a satellite, STEP milliseconds apart from time
+# TB on, with each stop halfway to the next start, must give the same
+# output as the single pair of commands at TB and TE.  A start command
+# is done at the epoch it falls in, so STEP must be shorter than the
+# data interval and the last start must fall in the last epoch before
+# TE.
+
+# Required variables
+# TEST_PROG: the program under test (RinEdit)
+# SOURCEDIR: the location of the input file
+# TARGETDIR: the directory to store the command and output files in
+# TESTBASE: the name of the test, used to name the files
+# INFILE: the RINEX obs file to edit, in SOURCEDIR
+# SAT: the satellite to delete, e.g. G15
+# WEEK: the GPS week of the commands
+# TB: the first start time, in integer seconds of WEEK
+# TE: the stop time of the single pair, in integer seconds of WEEK
+# NCMDS: the number of pairs of commands
+# STEP: the time between start commands, an even number of milliseconds
+# DIFF_PROG: path to the df_diff program
+
+set(cmds1 ${TARGETDIR}/${TESTBASE}-pair.cmd)
+set(cmds2 ${TARGETDIR}/${TESTBASE}-many.cmd)
+set(out1 ${TARGETDIR}/${TESTBASE}-pair.out)
+set(out2 ${TARGETDIR}/${TESTBASE}-many.out)
+
+file(WRITE ${cmds1} "--DS+ ${SAT},${WEEK},${TB}\n--DS- ${SAT},${WEEK},${TE}\n")
+
+# times are built in milliseconds, to keep to integer arithmetic
+math(EXPR last "${NCMDS} - 1")
+math(EXPR half "${STEP} / 2")
+set(lines "")
+foreach(k RANGE ${last})
+   math(EXPR start "${TB} * 1000 + ${k} * ${STEP}")
+   math(EXPR stop "${start} + ${half}")
+   foreach(sign + -)
+      if(sign STREQUAL "+")
+         set(ms ${start})
+      else()
+         set(ms ${stop})
+      endif()
+      math(EXPR sec "${ms} / 1000")
+      math(EXPR frac "${ms} % 1000 + 1000")
+      string(SUBSTRING ${frac} 1 3 frac)
+      list(APPEND lines "--DS${sign} ${SAT},${WEEK},${sec}.${frac}")
+   endforeach()
+endforeach()
+string(REPLACE ";" "\n" lines "${lines}")
+file(WRITE ${cmds2} "${lines}\n")
+
+foreach(run pair many)
+   message(STATUS         "${TEST_PROG} --IF ${SOURCEDIR}/${INFILE} --OF ${TARGETDIR}/${TESTBASE}-${run}.out --file ${TARGETDIR}/${TESTBASE}-${run}.cmd")
+   execute_process(COMMAND ${TEST_PROG} --IF ${SOURCEDIR}/${INFILE} --OF ${TARGETDIR}/${TESTBASE}-${run}.out --file ${TARGETDIR}/${TESTBASE}-${run}.cmd
+      OUTPUT_QUIET
+      RESULT_VARIABLE RC)
+   if(NOT RC EQUAL 0)
+      message(FATAL_ERROR "Test failed, ${RC} != 0")
+   endif()
+endforeach()
+
+message(STATUS         "${DIFF_PROG} -l2 -1${out2} -2${out1}")
+execute_process(COMMAND ${DIFF_PROG} -l2 -1${out2} -2${out1} RESULT_VARIABLE RC)
+
+if(RC)
+   message(FATAL_ERROR "Test failed, file differs")
+endif()
+message(STATUS "Test passed")
@@ -0,0 +1,135 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+#include "TestUtil.hpp"
+#include "SPSCQueue.hpp"
+#include <iostream>
+#include <thread>
+
+using namespace gpstk;
+
+   /// Push the sequence 0..count-1 into q, waiting whenever it is full.
+void produce(SPSCQueue<unsigned long>* q, unsigned long count)
+{
+   SPSCBackoff backoff;
+   for (unsigned long i = 0; i < count; i++)
+   {
+      while (!q->push(i))
+         backoff.pause();
+      backoff.reset();
+   }
+}
+
+class SPSCQueue_T
+{
+public:
+   SPSCQueue_T() {}
+   ~SPSCQueue_T() {}
+
+   int basicTest()
+   {
+      TUDEF("SPSCQueue", "push");
+      SPSCQueue<int> q(5);
+      int val = -1;
+         // capacity is rounded up to a power of two
+      TUASSERTE(size_t, 8, q.capacity());
+      TUASSERT(q.empty());
+      TUCSM("pop");
+      TUASSERT(!q.pop(val));
+      TUASSERTE(int, -1, val);
+      TUCSM("push");
+      for (int i = 0; i < 8; i++)
+      {
+         TUASSERT(q.push(i));
+      }
+      TUASSERT(!q.push(8));
+      TUASSERTE(size_t, 8, q.size());
+      TUCSM("pop");
+      for (int i = 0; i < 8; i++)
+      {
+         TUASSERT(q.pop(val));
+         TUASSERTE(int, i, val);
+      }
+      TUASSERT(!q.pop(val));
+      TUASSERT(q.empty());
+         // wrap around the end of the ring buffer
+      TUCSM("push");
+      for (int i = 0; i < 20; i++)
+      {
+         TUASSERT(q.push(i));
+         TUASSERT(q.pop(val));
+         TUASSERTE(int, i, val);
+      }
+      TURETURN();
+   }
+
+      /// Pass a long sequence between two threads through a small queue.
+   int threadTest()
+   {
+      TUDEF("SPSCQueue", "pop");
+      const unsigned long count = 100000;
+      SPSCQueue<unsigned long> q(4);
+      std::thread producer(produce, &q, count);
+      unsigned long val, errors = 0;
+      SPSCBackoff backoff;
+      for (unsigned long i = 0; i < count; i++)
+      {
+         while (!q.pop(val))
+            backoff.pause();
+         backoff.reset();
+         if (val != i)
+            errors++;
+      }
+      producer.join();
+      TUASSERTE(unsigned long, 0, errors);
+      TUASSERT(q.empty());
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   int errorTotal = 0;
+   SPSCQueue_T testClass;
+
+   errorTotal += testClass.basicTest();
+   errorTotal += testClass.threadTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
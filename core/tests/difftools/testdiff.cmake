@@ -1,8 +1,8 @@
 # test that files differ
 
-message(STATUS "running ${TEST_PROG} ${SOURCEDIR}/${FILE1} ${SOURCEDIR}/${FILE2}")
+message(STATUS "running ${TEST_PROG} ${OPTS} ${SOURCEDIR}/${FILE1} ${SOURCEDIR}/${FILE2}")
 
-execute_process(COMMAND ${TEST_PROG} ${SOURCEDIR}/${FILE1} ${SOURCEDIR}/${FILE2}
+execute_process(COMMAND ${TEST_PROG} ${OPTS} ${SOURCEDIR}/${FILE1} ${SOURCEDIR}/${FILE2}
                 OUTPUT_FILE ${TARGETDIR}/${TESTBASE}.out
                 RESULT_VARIABLE HAD_ERROR)
 # files are expected to be different
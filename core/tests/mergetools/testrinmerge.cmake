@@ -9,6 +9,8 @@
 # INFILE2: second input file
 # RINDIFF: location of RINEX diff tool for the format being tested
 # RINHEADDIFF: location of rinheaddiff application
+# OPTS: options for both TEST_PROG and RINDIFF, e.g. --max-records=10
+#       (optional)
 #
 # TEST_PROG is expected to generate the output file
 # ${TARGETDIR}/${TESTBASE}.out
@@ -17,9 +19,9 @@
 
 # Generate the merged file
 
-message(STATUS "running ${TEST_PROG} -o ${TARGETDIR}/${TESTBASE}.out ${SOURCEDIR}/${INFILE1} ${SOURCEDIR}/${INFILE2}")
+message(STATUS "running ${TEST_PROG} ${OPTS} -o ${TARGETDIR}/${TESTBASE}.out ${SOURCEDIR}/${INFILE1} ${SOURCEDIR}/${INFILE2}")
 
-execute_process(COMMAND ${TEST_PROG} -o ${TARGETDIR}/${TESTBASE}.out ${SOURCEDIR}/${INFILE1} ${SOURCEDIR}/${INFILE2}
+execute_process(COMMAND ${TEST_PROG} ${OPTS} -o ${TARGETDIR}/${TESTBASE}.out ${SOURCEDIR}/${INFILE1} ${SOURCEDIR}/${INFILE2}
                 OUTPUT_QUIET
                 RESULT_VARIABLE HAD_ERROR)
 if(HAD_ERROR)
@@ -29,9 +31,9 @@ endif()
 
 # diff against reference
 
-message(STATUS "running ${RINDIFF} ${SOURCEDIR}/${TESTBASE}.exp ${TARGETDIR}/${TESTBASE}.out")
+message(STATUS "running ${RINDIFF} ${OPTS} ${SOURCEDIR}/${TESTBASE}.exp ${TARGETDIR}/${TESTBASE}.out")
 
-execute_process(COMMAND ${RINDIFF} ${SOURCEDIR}/${TESTBASE}.exp ${TARGETDIR}/${TESTBASE}.out
+execute_process(COMMAND ${RINDIFF} ${OPTS} ${SOURCEDIR}/${TESTBASE}.exp ${TARGETDIR}/${TESTBASE}.out
     OUTPUT_QUIET
     RESULT_VARIABLE DIFFERENT)
 if(DIFFERENT)
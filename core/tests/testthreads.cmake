@@ -0,0 +1,161 @@
+# Test that a program gives the same output whatever the number of threads.
+# The program is run once with "--threads B" (B is 1 unless BASETHREADS is
+# given) and once with "--threads N", each in its own directory, and the files
+# it writes are compared.
+#
+# Expected variables (required unless otherwise noted):
+# TARGETDIR: the directory in which to create the run directories
+# TESTBASE: the name of the test, used to name the run directories
+# TEST_PROG: the program under test
+# ARGS: a space-separated argument list (optional)
+# BASETHREADS: the number of threads of the first run (optional, default 1)
+# THREADS: the number of threads of the second run
+# OUTFILES: a space-separated list of the files that the program writes
+# IGNORE: lines of the output files matching this regular expression, e.g.
+#    run dates and timing, are not compared (optional)
+# KEEP: if given, only lines matching this regular expression are compared
+#    (optional)
+# KEEPNEXT: if given with KEEP, the lines following those matching this
+#    regular expression are compared too (optional)
+# TOLERANCE: if given, the lines are compared field by field, and fixed-point
+#    numbers with the same number of decimals may differ by up to TOLERANCE,
+#    e.g. 0.0001; other fields must be the same (optional)
+
+# Set ${result} TRUE if the fields a and b are the same, or are fixed-point
+# numbers with the same number of decimals that differ by up to ${TOLERANCE}
+function(fields_agree a b result)
+   set(${result} TRUE PARENT_SCOPE)
+   if("${a}" STREQUAL "${b}")
+      return()
+   endif()
+   set(${result} FALSE PARENT_SCOPE)
+   set(fixed "^(-?)([0-9]+)\\.([0-9]+)$")
+   if(NOT "${a}" MATCHES "${fixed}")
+      return()
+   endif()
+   set(sa "${CMAKE_MATCH_1}")
+   set(ia "${CMAKE_MATCH_2}${CMAKE_MATCH_3}")
+   string(LENGTH "${CMAKE_MATCH_3}" ndec)
+   if(NOT "${b}" MATCHES "${fixed}")
+      return()
+   endif()
+   set(sb "${CMAKE_MATCH_1}")
+   set(ib "${CMAKE_MATCH_2}${CMAKE_MATCH_3}")
+   string(LENGTH "${CMAKE_MATCH_3}" n)
+   if(NOT n EQUAL ndec)
+      return()
+   endif()
+
+   # the tolerance in units of the last decimal
+   string(REGEX MATCH "^([0-9]*)\\.?([0-9]*)$" tol "${TOLERANCE}")
+   set(it "${CMAKE_MATCH_1}")
+   set(ft "${CMAKE_MATCH_2}0000000000000000")
+   string(SUBSTRING "${ft}" 0 ${ndec} ft)
+   set(it "${it}${ft}")
+
+   # integers without leading zeros, which math() could take for octal
+   foreach(v ia ib it)
+      string(REGEX REPLACE "^0+" "" ${v} "${${v}}")
+      if("${${v}}" STREQUAL "")
+         set(${v} 0)
+      endif()
+   endforeach()
+   math(EXPR d "(${sa}${ia}) - (${sb}${ib})")
+   if(d LESS 0)
+      math(EXPR d "0 - (${d})")
+   endif()
+   if(NOT d GREATER it)
+      set(${result} TRUE PARENT_SCOPE)
+   endif()
+endfunction()
+
+IF(DEFINED ARGS)
+   string(REPLACE " " ";" ARG_LIST ${ARGS})
+ENDIF(DEFINED ARGS)
+string(REPLACE " " ";" OUT_LIST ${OUTFILES})
+IF(NOT DEFINED BASETHREADS)
+   set(BASETHREADS 1)
+ENDIF(NOT DEFINED BASETHREADS)
+
+foreach(nthreads ${BASETHREADS} ${THREADS})
+   set(rundir "${TARGETDIR}/${TESTBASE}_${nthreads}")
+   file(REMOVE_RECURSE ${rundir})
+   file(MAKE_DIRECTORY ${rundir})
+   message(STATUS "${TEST_PROG} ${ARGS} --threads ${nthreads}")
+   execute_process(COMMAND ${TEST_PROG} ${ARG_LIST} --threads ${nthreads}
+       WORKING_DIRECTORY ${rundir}
+       OUTPUT_QUIET
+       RESULT_VARIABLE RC)
+   if(NOT RC EQUAL 0)
+      message(FATAL_ERROR "Test failed, ${TEST_PROG} returned ${RC}")
+   endif()
+endforeach()
+
+foreach(outfile ${OUT_LIST})
+   foreach(nthreads ${BASETHREADS} ${THREADS})
+      file(STRINGS "${TARGETDIR}/${TESTBASE}_${nthreads}/${outfile}" lines)
+      set(lines_${nthreads})
+      set(next FALSE)
+      foreach(line ${lines})
+         if(DEFINED IGNORE AND "${line}" MATCHES "${IGNORE}")
+            set(keep FALSE)
+         elseif(NOT DEFINED KEEP OR next OR "${line}" MATCHES "${KEEP}")
+            set(keep TRUE)
+         else()
+            set(keep FALSE)
+         endif()
+         if(keep)
+            list(APPEND lines_${nthreads} "${line}")
+         endif()
+         set(next FALSE)
+         if(DEFINED KEEPNEXT AND "${line}" MATCHES "${KEEPNEXT}")
+            set(next TRUE)
+         endif()
+      endforeach()
+   endforeach()
+   list(LENGTH lines_${BASETHREADS} nlines)
+   if(nlines EQUAL 0)
+      message(FATAL_ERROR "Test failed - ${outfile} is empty")
+   endif()
+   if(NOT DEFINED TOLERANCE)
+      if(NOT "${lines_${BASETHREADS}}" STREQUAL "${lines_${THREADS}}")
+         message(FATAL_ERROR "Test failed - ${outfile} differs with ${BASETHREADS} and ${THREADS} threads")
+      endif()
+      message(STATUS "${outfile}: ${nlines} lines are the same")
+   else()
+      list(LENGTH lines_${THREADS} n)
+      if(NOT n EQUAL nlines)
+         message(FATAL_ERROR "Test failed - ${outfile} has ${nlines} and ${n} lines with ${BASETHREADS} and ${THREADS} threads")
+      endif()
+      math(EXPR last "${nlines} - 1")
+      foreach(i RANGE ${last})
+         list(GET lines_${BASETHREADS} ${i} line1)
+         list(GET lines_${THREADS} ${i} line2)
+         string(STRIP "${line1}" line1)
+         string(STRIP "${line2}" line2)
+         string(REGEX REPLACE " +" ";" fields1 "${line1}")
+         string(REGEX REPLACE " +" ";" fields2 "${line2}")
+         list(LENGTH fields1 nf)
+         list(LENGTH fields2 n)
+         set(same TRUE)
+         if(NOT n EQUAL nf)
+            set(same FALSE)
+         else()
+            math(EXPR lastf "${nf} - 1")
+            foreach(j RANGE ${lastf})
+               list(GET fields1 ${j} f1)
+               list(GET fields2 ${j} f2)
+               fields_agree("${f1}" "${f2}" agree)
+               if(NOT agree)
+                  set(same FALSE)
+               endif()
+            endforeach()
+         endif()
+         if(NOT same)
+            message(FATAL_ERROR "Test failed - ${outfile} differs by more than ${TOLERANCE} with ${BASETHREADS} and ${THREADS} threads:\n${line1}\n${line2}")
+         endif()
+      endforeach()
+      message(STATUS "${outfile}: ${nlines} lines agree within ${TOLERANCE}")
+   endif()
+endforeach()
+message(STATUS "Test passed")
@@ -41,24 +41,32 @@
 #include <string.h>
 #include <math.h>
 
+#include "ClockStability.hpp"
+
 using namespace std;
+using namespace gpstk;
 
 int main(int argv, char **argc)
 {
+    // Averaging factors: all of them unless "octave" or "decade" is given
+    ClockStability::TauSet tauSet = ClockStability::All;
     if(argc[1])
     {
         string str = argc[1];
         if((str == "-h") || (str == "--help"))
         {
           cout << "mallandev: Computes the modified Allan deviation from the standard input." << endl;
+          cout << "Usage: mallandev [octave|decade|all] < phase" << endl;
           return 1;
         }
+        if(str == "octave") tauSet = ClockStability::Octave;
+        else if(str == "decade") tauSet = ClockStability::Decade;
     }
     // Structures used to store time and clock phase information
     vector <double> timeArray;
     vector <double> phaseArray;
     long double time, phase;
-    long unsigned int numPoints, i, numGaps, N, m;
+    long unsigned int numPoints, i, N;
 
     // All of the time and clock phase data is read in from the standard input
     i = 0;
@@ -75,56 +83,29 @@ int main(int argv, char **argc)
 
     numPoints = i-1;
 
-    // Variables used in Overlapping Allan Deviation calculations
-    double Tau, Tau0, sum, sigma1, sigma2;
-
     // Ensures there are at least the minimum number of points required to do calculations
-    N = numPoints;
-    if(N > 1) Tau0 = timeArray[1] - timeArray[0];
-    else
+    if(i < 4)
     {
         cout << "Not Enough Points to Calculate Tau0" << endl;
+        return(0);
     }
 
-    // Actual Overlapping Allan Deviation Calculation is done here
-    // The Overlapping Allan Deviation is calculated as follows
-    //  Sigma^2(Tau) = 1 / (2*(N-3*m+1)*Tau^2) * Sum(X[i+2*m]-2*X[i+m]+X[i], i=1, i=N-2*m)
-    //  Where Tau is the averaging time, N is the total number of points, and Tau = m*Tau0
-    //  Where Tau0 is the basic measurement interval
-
-        for(m = 1; m <= (N-1)/2; m++)
+    N = numPoints;
+    double Tau0 = timeArray[1] - timeArray[0];
+    phaseArray.resize(N);
+
+    // The Modified Allan Deviation is calculated as follows
+    //  Sigma^2(Tau) = 1 / (2*m^2*(N-3*m+1)*Tau^2) * Sum(Sum(X[i+2*m]-2*X[i+m]+X[i], i=j, i=j+m-1)^2, j=1, j=N-3*m+1)
+    //  Where Tau = m*Tau0 is the averaging time, Tau0 is the basic measurement interval
+    //  and N is the total number of points
+    ClockStability stability(phaseArray, Tau0);
+    vector<ClockStability::Point> curve =
+        stability.compute(ClockStability::MDEV, tauSet);
+
+    for(i = 0; i < curve.size(); i++)
     {
-            numGaps=0;
-                Tau = m*Tau0;
-        sigma1 = 0;
-        sigma2 = 0;
-        int y=0; //counts number of times a value is added to sigma
-
-        for(long unsigned int j=0; j < (N-3*m+1); j=j+1)
-        {
-            for(i = j; i <= (j+m-1); i++)
-            {
-                sum = 0;
-                if((phaseArray[i+2*m]==0 ||  phaseArray[i+m]==0 || phaseArray[i]==0)
-                   && i!=0 && i!=(j+m-1))
-                   numGaps++;
-                            else
-                                sum = phaseArray[i+2*m] - 2*phaseArray[i+m] + phaseArray[i];
-                sigma1 += sum;
-
-            }
-            sigma2 += sigma1*sigma1;
-            sigma1 = 0;
-            y++;
-        }
-
-        sigma2 = sigma2 / (2.0*Tau*Tau*m*m*((double)N-(double)numGaps-3.0*m+1));
-        sigma2 = sqrt(sigma2);
-
-        fprintf(stdout, "%.1f %.4e \n", Tau, sigma2); // outputs results to the standard output
-        }
-    /*************
-    *************/
+        fprintf(stdout, "%.1f %.4e \n", curve[i].tau, curve[i].deviation); // outputs results to the standard output
+    }
 
     return(0);
 }
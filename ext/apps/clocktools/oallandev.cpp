@@ -41,24 +41,32 @@
 #include <string.h>
 #include <math.h>
 
+#include "ClockStability.hpp"
+
 using namespace std;
+using namespace gpstk;
 
 int main(int argv, char **argc)
 {
+    // Averaging factors: all of them unless "octave" or "decade" is given
+    ClockStability::TauSet tauSet = ClockStability::All;
     if(argc[1])
     {
         string str = argc[1];
         if((str == "-h") || (str == "--help"))
         {
           cout << "oallandev: Computes the overlapping Allan deviation from the standard input." << endl;
+          cout << "Usage: oallandev [octave|decade|all] < phase" << endl;
           return 1;
         }
+        if(str == "octave") tauSet = ClockStability::Octave;
+        else if(str == "decade") tauSet = ClockStability::Decade;
     }
     // Structures used to store time and clock phase information
     vector <double> timeArray;
     vector <double> phaseArray;
     long double time, phase;
-    long unsigned int numPoints, i, numGaps, N, m;
+    long unsigned int numPoints, i, N;
 
     // All of the time and clock phase data is read in from the standard input
     i = 0;
@@ -75,46 +83,29 @@ int main(int argv, char **argc)
 
     numPoints = i-1;
 
-    // Variables used in Overlapping Allan Deviation calculations
-    double Tau, Tau0, sum, sigma;
-
     // Ensures there are at least the minimum number of points required to do calculations
-    N = numPoints;
-    if(N > 1) Tau0 = timeArray[1] - timeArray[0];
-    else
+    if(i < 4)
     {
         cout << "Not Enough Points to Calculate Tau0" << endl;
+        return(0);
     }
 
-    // Actual Overlapping Allan Deviation Calculation is done here
+    N = numPoints;
+    double Tau0 = timeArray[1] - timeArray[0];
+    phaseArray.resize(N);
+
     // The Overlapping Allan Deviation is calculated as follows
     //  Sigma^2(Tau) = 1 / (2*(N-2*m)*Tau^2) * Sum(X[i+2*m]-2*X[i+m]+X[i], i=1, i=N-2*m)
-    //  Where Tau is the averaging time, N is the total number of points, and Tau = m*Tau0
-    //  Where Tau0 is the basic measurement interval
+    //  Where Tau = m*Tau0 is the averaging time, Tau0 is the basic measurement interval
+    //  and N is the total number of points
+    ClockStability stability(phaseArray, Tau0);
+    vector<ClockStability::Point> curve =
+        stability.compute(ClockStability::ADEV, tauSet);
 
-        for(m = 1; m <= (N-1)/2; m++)
+    for(i = 0; i < curve.size(); i++)
     {
-            numGaps=0;
-                Tau = m*Tau0;
-        sigma = 0;
-
-        for(i = 0; i < (N-2*m); i++)
-        {
-            sum = 0;
-            if((phaseArray[i+2*m]==0 ||  phaseArray[i+m]==0 || phaseArray[i]==0)
-               && i!=0 && i!=(N-2*m-1))
-                numGaps++;
-                        else
-                            sum = phaseArray[i+2*m] - 2*phaseArray[i+m] + phaseArray[i];
-            sigma += sum * sum;
-        }
-
-        sigma = sigma / (2.0*((double)N-(double)numGaps-0-2.0*(double)m)*Tau*Tau);
-        sigma = sqrt(sigma);
-        fprintf(stdout, "%.1f %.4e \n", Tau, sigma); // outputs results to the standard output
-        }
-    /*************
-    *************/
+        fprintf(stdout, "%.1f %.4e \n", curve[i].tau, curve[i].deviation); // outputs results to the standard output
+    }
 
     return(0);
 }
@@ -41,24 +41,32 @@
 #include <string.h>
 #include <math.h>
 
+#include "ClockStability.hpp"
+
 using namespace std;
+using namespace gpstk;
 
 int main(int argv, char **argc)
 {
+    // Averaging factors: all of them unless "octave" or "decade" is given
+    ClockStability::TauSet tauSet = ClockStability::All;
     if(argc[1])
     {
         string str = argc[1];
         if((str == "-h") || (str == "--help"))
         {
           cout << "ohadamarddev: Computes the overlapping Hadamard deviation from the standard input." << endl;
+          cout << "Usage: ohadamarddev [octave|decade|all] < phase" << endl;
           return 1;
         }
+        if(str == "octave") tauSet = ClockStability::Octave;
+        else if(str == "decade") tauSet = ClockStability::Decade;
     }
     // Structures used to store time and clock phase information
     vector <double> timeArray;
     vector <double> phaseArray;
     long double time, phase;
-    long unsigned int numPoints, i, numGaps, N, m;
+    long unsigned int numPoints, i, N;
 
     // All of the time and clock phase data is read in from the standard input
     i = 0;
@@ -75,48 +83,29 @@ int main(int argv, char **argc)
 
     numPoints = i-1;
 
-
-
-    // Variables used in Overlapping Hadamard Deviation calculations
-    double Tau, Tau0, sum, sigma;
-
     // Ensures there are at least the minimum number of points required to do calculations
-    N = numPoints;
-    if(N > 2) Tau0 = timeArray[1] - timeArray[0];
-    else
+    if(i < 4)
     {
         cout << "Not Enough Points to Calculate Tau0" << endl;
+        return(0);
     }
 
-    // Overlapping Hadamard Calculation
-    //  Done As Follows
+    N = numPoints;
+    double Tau0 = timeArray[1] - timeArray[0];
+    phaseArray.resize(N);
+
+    // The Overlapping Hadamard Deviation is calculated as follows
     //  HSigma^2(Tau) = Sum((x[i+3m]-3x[i+2m]+3x[i+m]-x[i])^2, from i=1 to N-3m)/[6(N-3m)Tau^2]
-    //  Where Tau = m*Tau0, Tau0 being the basic time interval
-    //   m being the spacing, and N the total number of data points
-    for(m = 1; m <= (N-1)/3; m++)
-    {
-        Tau = m*Tau0;
-        sigma = 0;
-        numGaps=0;
-        for(i = 0; i < (N-3*m); i++)
-        {
-            sum = 0;
-            if((phaseArray[i+3*m]==0 ||  phaseArray[i+2*m]==0
-                || phaseArray[i+m]==0 || phaseArray[i]==0)
-               && i!=0 && i!=(N-3*m-1))
-                numGaps++;
-            else
-                sum = phaseArray[i+3*m] - 3*phaseArray[i+2*m] + 3*phaseArray[i+m] - phaseArray[i];
-            sigma += sum * sum;
-        }
+    //  Where Tau = m*Tau0 is the averaging time, Tau0 is the basic measurement interval
+    //  and N is the total number of points
+    ClockStability stability(phaseArray, Tau0);
+    vector<ClockStability::Point> curve =
+        stability.compute(ClockStability::HDEV, tauSet);
 
-        sigma = sigma / (6.0*((double)N-numGaps-3.0*(double)m)*Tau*Tau);
-        sigma = sqrt(sigma);
-        fprintf(stdout, "%.1f %.4e \n", Tau, sigma); // outputs results to the standard output
+    for(i = 0; i < curve.size(); i++)
+    {
+        fprintf(stdout, "%.1f %.4e \n", curve[i].tau, curve[i].deviation); // outputs results to the standard output
     }
 
-    /*************
-    *************/
-
     return(0);
 }
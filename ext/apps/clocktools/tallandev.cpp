@@ -41,18 +41,26 @@
 #include <string.h>
 #include <math.h>
 
+#include "ClockStability.hpp"
+
 using namespace std;
+using namespace gpstk;
 
 int main(int argv, char **argc)
 {
+    // Averaging factors: all of them unless "octave" or "decade" is given
+    ClockStability::TauSet tauSet = ClockStability::All;
     if(argc[1])
     {
         string str = argc[1];
         if((str == "-h") || (str == "--help"))
         {
           cout << "tallandev: Computes the total Allan deviation from the standard input." << endl;
+          cout << "Usage: tallandev [octave|decade|all] < phase" << endl;
           return 1;
         }
+        if(str == "octave") tauSet = ClockStability::Octave;
+        else if(str == "decade") tauSet = ClockStability::Decade;
     }
     // Structures used to store time and clock phase information
     vector <double> timeArray;
@@ -75,63 +83,29 @@ int main(int argv, char **argc)
 
     numPoints = i-1;
 
-    /*************
-    *************/
-
-    // Variables used in Overlapping Allan Deviation calculations
-    double Tau, Tau0, sum, sigma;
-
     // Ensures there are at least the minimum number of points required to do calculations
-    N = numPoints;
-    if(N > 1) Tau0 = timeArray[1] - timeArray[0];
-    else
+    if(i < 4)
     {
         cout << "Not Enough Points to Calculate Tau0" << endl;
+        return(0);
     }
 
-        //Vector to store the transformed data
-    vector <double> phaseTemp(3*N-4,0);
-
-        //Transforms and stores data
-    for(i=0; i<N; i++)
-    {
-        phaseTemp[N-2+i] = phaseArray[i];
-    }
-
-    for(int x=N-5, y=3*N-5, j=3; x>=0; j++)
-        {
-        phaseTemp[x] = 2*phaseArray[0]-phaseArray[j];
-        phaseTemp[y] = 2*phaseArray[N-1]-phaseArray[j];
-        x--; y--;
-    }
-
-        phaseTemp[N-3] = 2*phaseArray[0]-phaseArray[1];
-    phaseTemp[N-4] = 2*phaseArray[0]-phaseArray[2];
-    phaseTemp[2*N-2] = 2*phaseArray[N-1]-phaseArray[N-2];
-       phaseTemp[2*N-1] = 2*phaseArray[N-1]-phaseArray[N-3];
-
-    // Actual Total Variance Calculation is done here
-    // The Total Variance is calculated as follows
-    //  Sigma2(Tau) = 1 / (2*(N-2)*Tau2) * Sum(X[i-m]-2*X[i+m]+X[i+m], i=2, i=N-1)
-    //  Where Tau is the averaging time, N is the total number of points, and Tau = m*Tau0
-    //  Where Tau0 is the basic measurement interval
-
-    for(m = 1; m<N; m++)
+    N = numPoints;
+    double Tau0 = timeArray[1] - timeArray[0];
+    phaseArray.resize(N);
+
+    // The Total Deviation is calculated as follows
+    //  Sigma^2(Tau) = 1 / (2*(N-2)*Tau^2) * Sum((X*[i-m]-2*X*[i]+X*[i+m])^2, i=2, i=N-1)
+    //  Where X* is the phase data extended at both ends by reflection
+    //  Where Tau = m*Tau0 is the averaging time, Tau0 is the basic measurement interval
+    //  and N is the total number of points
+    ClockStability stability(phaseArray, Tau0);
+    vector<ClockStability::Point> curve =
+        stability.compute(ClockStability::TOTDEV, tauSet);
+
+    for(i = 0; i < curve.size(); i++)
     {
-        Tau = m*Tau0;
-        sigma = 0;
-
-        for(i = N-1; i<(2*N-3); i++)
-        {
-            sum = 0;
-                    sum = phaseTemp[i-m] - 2*phaseTemp[i] + phaseTemp[i+m];
-            sigma += sum*sum;
-        }
-
-        sigma = sigma / (2.0*(double(N)-2.0)*Tau*Tau);
-        sigma = sqrt(sigma);
-        fprintf(stdout, "%.1f %.4e \n", Tau, sigma); // outputs results to the standard output
-
+        fprintf(stdout, "%.1f %.4e \n", curve[i].tau, curve[i].deviation); // outputs results to the standard output
     }
 
     return(0);
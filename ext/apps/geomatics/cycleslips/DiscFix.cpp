@@ -54,6 +54,7 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 // gpstk
 #include "MathBase.hpp"
@@ -121,6 +122,7 @@ typedef struct configuration {
    Epoch FirstEpoch,LastEpoch;
    bool smoothPR,smoothPH,smooth;
    int debug;
+   int nthreads;          // number of threads for the GDC
    bool verbose,DChelp;
    vector<string> DCcmds;        // all the --DC... on the cmd line
       // estimate dt from data
@@ -311,13 +313,40 @@ int main(int argc, char **argv)
          LOG(INFO) << "";
 
          // -------------------------------- call the GDC, output results and smooth
+         // passes are independent; the GDC processes them concurrently, and its
+         // output for each pass is printed here in order, as if called in turn
+         vector<string> passSummary(cfg.SPList.size());
          for(npass=0; npass<cfg.SPList.size(); npass++) {
+            ostringstream oss;
+            oss << cfg.SPList[npass];
+            passSummary[npass] = oss.str();
+         }
+         // if a pass throws, the output of the passes before it, and its log,
+         // are printed before the exception is passed on
+         vector<int> GLOn,iretList;
+         vector< vector<string> > PassEditCmds;
+         vector<string> PassMsgs,GDCLogs;
+         bool GDCthrew(false);
+         Exception GDCexception;
+         try {
+            DiscontinuityCorrector(cfg.SPList, cfg.GDConfig, iretList,
+                        PassEditCmds, PassMsgs, GDCLogs, GLOn, cfg.nthreads);
+         }
+         catch(Exception& e) { GDCthrew = true; GDCexception = e; }
 
-            LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << cfg.SPList[npass];
+         for(npass=0; npass<GDCLogs.size(); npass++) {
+
+            LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << passSummary[npass];
             //cfg.SPList[npass].dump(*pLOGstrm,"RAW");      // temp
 
-            msg = "";
-            iret=DiscontinuityCorrector(cfg.SPList[npass],cfg.GDConfig,EditCmds,msg);
+            cfg.oflog << GDCLogs[npass];
+            if(GDCthrew && npass+1 == GDCLogs.size())
+               GPSTK_RETHROW(GDCexception);
+            msg = PassMsgs[npass];
+            // commands of a failed pass are kept, and output with the next
+            EditCmds.insert(EditCmds.end(), PassEditCmds[npass].begin(),
+                                            PassEditCmds[npass].end());
+            iret = iretList[npass];
             if(iret != 0) {
                cfg.SPList[npass].status() = -1;         // failed
                LOG(ERROR) << "GDC failed (" << iret << " "
@@ -827,6 +856,8 @@ try {
    cfg.smoothPH = false;
    cfg.smooth = false;
 
+   cfg.nthreads = 0;       // one per processor
+
    for(i=0; i<9; i++) cfg.ndt[i]=-1;
 
    cfg.inputPath = string(".");
@@ -914,6 +945,8 @@ try {
             "Set DC parameter <param> to <value>");
    opts.Add(0, "DChelp", "", false, false, &cfg.DChelp, "",
             "Print list of DC parameters (all if -v) and their defaults, then quit");
+   opts.Add(0, "threads", "n", false, false, &cfg.nthreads, "",
+            "Number of passes to process concurrently (0: one per processor)");
 
    opts.Add(0, "log", "file", false, false, &cfg.LogFile, "# Output:",
             "Output log file name (" + cfg.LogFile + ")");
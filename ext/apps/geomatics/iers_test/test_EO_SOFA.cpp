@@ -49,6 +49,7 @@
 #include "CommandLine.hpp"
 #include "SolarSystem.hpp"
 #include "EarthOrientation.hpp"
+#include "EarthRotationCache.hpp"
 #include "logstream.hpp"
 
 using namespace std;
@@ -135,6 +136,19 @@ try {
    LOG(INFO) << "\ncelestial-to-terrestrial matrix:\n" << showpos << fixed
       << setprecision(15) << setw(18) << transpose(M);
 
+   // the same, interpolating the precession-nutation series
+   LOGlevel = ConfigureLOG::Level("INFO");
+   LOG(INFO) << "\nEarthRotationCache "
+      << "-------------------------------------------------";
+   EarthOrientation *eos[3] = { &nGF96, &nGF03, &nGF10 };
+   for(i=0; i<3; i++) {
+      EarthRotationCache cache(eos[i]->convention);
+      M = cache.ECEFtoInertial(ttag, *eos[i]);
+      LOG(INFO) << "\n" << eos[i]->convention.asString()
+         << " celestial-to-terrestrial matrix:\n" << showpos << fixed
+         << setprecision(15) << setw(18) << transpose(M);
+   }
+
    return 0;
 }
 catch(Exception& e) { cerr << "Exception: " << e; }
@@ -327,8 +327,9 @@ try {
       }
 
       if(C.doOcean) {
+         vector<Triple> dNEUs(C.oceanStore.computeDisplacements(C.oceannames,ttag));
          for(size_t j=0; j<C.oceannames.size(); j++) {
-            dNEU = C.oceanStore.computeDisplacement(C.oceannames[j], ttag);
+            dNEU = dNEUs[j];
             for(i=0; i<3; i++) NEU(i) = dNEU[i];
             XYZ = transpose(Rotate) * NEU;
 
@@ -640,11 +640,20 @@ namespace gpstk
       double xp( (inarg[1] - ABC[0][1]) / lon[2] );
       double xq( (inarg[0] - ABC[0][0]) / lat[2] );
 
+         // rounding in getIndex() may leave the point just outside the
+         // cell of E00, e.g. for longitudes shifted by the map rotation
+      if ( (xp < 0.0) && (xp > -1.e-9) ) xp = 0.0;
+      if ( (xp > 1.0) && (xp < 1.0+1.e-9) ) xp = 1.0;
+      if ( (xq < 0.0) && (xq > -1.e-9) ) xq = 0.0;
+      if ( (xq > 1.0) && (xq < 1.0+1.e-9) ) xq = 1.0;
+
          // this never should happen but just in case
       if ( (xp < 0) || (xp > 1) || (xq < 0) || (xq > 1) )
       {
 
-         throw(Exception("IonexData::getValue(): Wrong xp and xq factors!!!"));
+         InvalidRequest e("IonexData::getValue(): Wrong xp and xq factors!!!");
+
+         GPSTK_THROW(e);
 
       }
 
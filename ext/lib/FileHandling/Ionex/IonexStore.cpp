@@ -42,7 +42,10 @@
  */
 
 
+#include <algorithm>
+
 #include "IonexStore.hpp"
+#include "ProductCache.hpp"
 
 using namespace gpstk::StringUtils;
 using namespace gpstk;
@@ -96,11 +99,35 @@ namespace gpstk
             // this map is useful in finding DCB value
          inxDCBMap[header.firstEpoch] = header.svsmap;
 
-            // object data. If valid, add to the map
-         IonexData iod;
-         while ( strm >> iod && iod.isValid() )
+            // object data. If valid, add to the map. The maps are read from
+            // the product cache if it holds them
+         if ( !loadCachedMaps(filename) )
          {
-            addMap(iod);
+
+            std::vector<IonexData> maps;
+
+            IonexData iod;
+            while ( strm >> iod && iod.isValid() )
+            {
+               addMap(iod);
+
+               if (ProductCache::isEnabled())
+               {
+                  maps.push_back(iod);
+               }
+            }
+
+            if (ProductCache::isEnabled())
+            {
+               saveCachedMaps(filename, maps);
+            }
+
+         }
+
+            // pack all the maps, including those of previous files
+         if (packedMode)
+         {
+            packMaps();
          }
 
       }
@@ -124,6 +151,9 @@ namespace gpstk
       if (type != IonexData::UN)
       {
          inxMaps[t][type] = iod;
+
+            // packed maps are out of date until packMaps() is called again
+         packedMaps.valid = false;
       }
 
       if (t < initialTime)
@@ -139,6 +169,292 @@ namespace gpstk
 
 
 
+      /* Add to the store the maps of the product cache entry of a file,
+       * if there is a matching entry.
+       *
+       * @param filename   Name of the IONEX file
+       *
+       * @return           true if the maps were added, false if the file
+       *                   must be parsed.
+       */
+   bool IonexStore::loadCachedMaps(const std::string& filename)
+      throw()
+   {
+
+      ProductCache cache;
+      if ( !cache.openEntry(filename, "ionex") )
+      {
+         return false;
+      }
+
+         // read everything before adding anything, so that a bad entry
+         // leaves the store untouched
+      size_t nmap( cache.getCount(1) );
+      std::vector<IonexData> maps(nmap);
+
+      for (size_t i = 0; i < nmap && cache.good(); i++)
+      {
+
+         IonexData& iod(maps[i]);
+         int32_t ival;
+         uint8_t valid;
+
+         cache.getData(ival);
+         iod.mapID = ival;
+         for (int j = 0; j < 3; j++)
+         {
+            cache.getData(ival);
+            iod.dim[j] = ival;
+         }
+         cache.getTime(iod.time);
+         cache.getString(iod.type.type);
+         cache.getString(iod.type.description);
+         cache.getString(iod.type.units);
+         cache.getData(ival);
+         iod.exponent = ival;
+         for (int j = 0; j < 3; j++)
+         {
+            cache.getData(iod.lat[j]);
+            cache.getData(iod.lon[j]);
+            cache.getData(iod.hgt[j]);
+         }
+         cache.getData(valid);
+         iod.valid = (valid != 0);
+
+         size_t n( cache.getCount(sizeof(double)) );
+         iod.data.resize(n);
+         for (size_t j = 0; j < n; j++)
+         {
+            cache.getData(iod.data[j]);
+         }
+
+      }  // End of 'for (size_t i = 0; i < nmap && cache.good(); i++)'
+
+      if ( !cache.good() )
+      {
+         return false;
+      }
+
+      for (size_t i = 0; i < nmap; i++)
+      {
+         addMap(maps[i]);
+      }
+
+      return true;
+
+   }  // End of method 'IonexStore::loadCachedMaps()'
+
+
+
+      /* Write the maps of a file to the product cache. Errors are ignored.
+       *
+       * @param filename   Name of the IONEX file
+       * @param maps       Maps read from the file
+       */
+   void IonexStore::saveCachedMaps( const std::string& filename,
+                                    const std::vector<IonexData>& maps )
+      throw()
+   {
+
+      try
+      {
+
+         ProductCache cache;
+         if ( !cache.createEntry(filename, "ionex") )
+         {
+            return;
+         }
+
+         cache.writeCount(maps.size());
+
+         for (size_t i = 0; i < maps.size(); i++)
+         {
+
+            const IonexData& iod(maps[i]);
+
+            cache.writeData(static_cast<int32_t>(iod.mapID));
+            for (int j = 0; j < 3; j++)
+            {
+               cache.writeData(static_cast<int32_t>(iod.dim[j]));
+            }
+            cache.writeTime(iod.time);
+            cache.writeString(iod.type.type);
+            cache.writeString(iod.type.description);
+            cache.writeString(iod.type.units);
+            cache.writeData(static_cast<int32_t>(iod.exponent));
+            for (int j = 0; j < 3; j++)
+            {
+               cache.writeData(iod.lat[j]);
+               cache.writeData(iod.lon[j]);
+               cache.writeData(iod.hgt[j]);
+            }
+            cache.writeData(static_cast<uint8_t>(iod.valid ? 1 : 0));
+
+            cache.writeCount(iod.data.size());
+            for (size_t j = 0; j < iod.data.size(); j++)
+            {
+               cache.writeData(iod.data[j]);
+            }
+
+         }  // End of 'for (size_t i = 0; i < maps.size(); i++)'
+
+         cache.commitEntry();
+
+      }
+      catch (...)
+      {
+            // the entry is discarded by the ProductCache destructor
+      }
+
+      return;
+
+   }  // End of method 'IonexStore::saveCachedMaps()'
+
+
+
+      /* Pack all the TEC and RMS maps of the store into a contiguous
+       * (epoch x latitude x longitude) array, which is then used by
+       * getIonexValue() and getIonexValues() instead of the individual
+       * maps.
+       */
+   void IonexStore::packMaps()
+      throw()
+   {
+
+      packedMaps = PackedMaps();
+
+      if (inxMaps.empty())
+      {
+         return;
+      }
+
+         // all the maps must share the same two-dimensional grid as the
+         // first one
+      const IonexData* first(0);
+
+      IonexMap::const_iterator it;
+      for (it = inxMaps.begin(); it != inxMaps.end(); it++)
+      {
+
+         IonexValTypeMap::const_iterator itv;
+         for (itv = it->second.begin(); itv != it->second.end(); itv++)
+         {
+
+            const IonexData& iod(itv->second);
+
+            if ( iod.dim[2] != 1 || iod.hgt[2] != 0 ||
+                 iod.dim[0] < 2  || iod.dim[1] < 2  ||
+                 iod.data.size() != size_t(iod.dim[0]*iod.dim[1]) )
+            {
+               return;
+            }
+
+            if (first == 0)
+            {
+               first = &iod;
+            }
+            else if ( iod.dim[0] != first->dim[0] ||
+                      iod.dim[1] != first->dim[1] ||
+                      iod.lat[0] != first->lat[0] ||
+                      iod.lat[2] != first->lat[2] ||
+                      iod.lon[0] != first->lon[0] ||
+                      iod.lon[2] != first->lon[2] )
+            {
+               return;
+            }
+
+         }  // End of 'for (itv = it->second.begin(); ...'
+
+      }  // End of 'for (it = inxMaps.begin(); ...'
+
+      if (first == 0)
+      {
+         return;
+      }
+
+         // grid metadata
+      for (int i = 0; i < 3; i++)
+      {
+         packedMaps.lat[i] = first->lat[i];
+         packedMaps.lon[i] = first->lon[i];
+      }
+      packedMaps.nlat = first->dim[0];
+      packedMaps.nlon = first->dim[1];
+      packedMaps.ncyc = static_cast<int>( ( 360.0 / std::abs(first->lon[2]) )
+                                          + 0.5 );
+
+         // values; missing maps are filled with the 'undefined' value
+      size_t nepoch(inxMaps.size());
+      size_t nval(packedMaps.nlat*packedMaps.nlon);
+
+      packedMaps.epochs.reserve(nepoch);
+      packedMaps.hasTEC.resize(nepoch, false);
+      packedMaps.hasRMS.resize(nepoch, false);
+      packedMaps.tec.resize(nepoch*nval, 999.9);
+      packedMaps.rms.resize(nepoch*nval, 999.9);
+
+      size_t k(0);
+      for (it = inxMaps.begin(); it != inxMaps.end(); it++, k++)
+      {
+
+         packedMaps.epochs.push_back(it->first);
+
+         IonexValTypeMap::const_iterator itv;
+
+         itv = it->second.find(IonexData::TEC);
+         if (itv != it->second.end())
+         {
+            packedMaps.hasTEC[k] = true;
+            std::copy( itv->second.data.begin(),
+                       itv->second.data.end(),
+                       packedMaps.tec.begin() + k*nval );
+         }
+
+         itv = it->second.find(IonexData::RMS);
+         if (itv != it->second.end())
+         {
+            packedMaps.hasRMS[k] = true;
+            std::copy( itv->second.data.begin(),
+                       itv->second.data.end(),
+                       packedMaps.rms.begin() + k*nval );
+         }
+
+      }  // End of 'for (it = inxMaps.begin(); ...'
+
+      packedMaps.valid = true;
+
+      return;
+
+   }  // End of method 'IonexStore::packMaps()'
+
+
+
+      /* Set whether loadFile() packs the maps (see packMaps()).
+       *
+       * @param packed     true to pack the maps, false to use the
+       *                   individual maps.
+       */
+   IonexStore& IonexStore::setPackedMode(bool packed)
+      throw()
+   {
+
+      packedMode = packed;
+
+      if (packedMode)
+      {
+         packMaps();
+      }
+      else
+      {
+         packedMaps = PackedMaps();
+      }
+
+      return (*this);
+
+   }  // End of method 'IonexStore::setPackedMode()'
+
+
+
       /** Dump the store to the provided std::ostream (std::cout by default).
        *
        * @param s       std::ostream object to dump the data to.
@@ -243,6 +559,7 @@ namespace gpstk
    {
 
       inxMaps.clear();
+      packedMaps = PackedMaps();
 
       initialTime = CommonTime::END_OF_TIME;
       finalTime = CommonTime::BEGINNING_OF_TIME;
@@ -281,6 +598,16 @@ namespace gpstk
       throw(InvalidRequest)
    {
 
+         // use the packed maps if available
+      if (packedMaps.valid)
+      {
+         int k[2];
+         double f[2];
+         int nmap( findPackedMaps(t, strategy, k, f) );
+
+         return getPackedValue(t, RX, strategy, nmap, k, f);
+      }
+
          // Here we store the necessary IONEX-extracted values 
          // (i.e, TEC, RMS, ionosphere height)
       Triple tecval(0.0,0.0,0.0);
@@ -331,11 +658,23 @@ namespace gpstk
          if( itm != inxMaps.end() )              // exact match of t
          {
 
-               // get the current map
-            itm = inxMaps.lower_bound(t);
-               // store current and next epoch
-            T[0] = itm->first;
-            T[1] = (++itm)->first;
+               // store current and next epoch, or, if t is the last epoch,
+               // previous and current epoch, as the packed maps do
+            IonexMap::const_iterator itn(itm);
+            if( ++itn != inxMaps.end() )
+            {
+               T[0] = itm->first;
+               T[1] = itn->first;
+            }
+            else if( itm != inxMaps.begin() )
+            {
+               T[1] = itm->first;
+               T[0] = (--itm)->first;
+            }
+            else                                // the only map
+            {
+               T[0] = T[1] = itm->first;
+            }
 
          }
          else                                   // t is between two maps
@@ -359,8 +698,17 @@ namespace gpstk
 
          // factors (As in Eq.(3), pag.2 of the manual)
       double f[2];
-      f[0] = (T[1]-t   ) / (T[1]-T[0]);
-      f[1] = (t   -T[0]) / (T[1]-T[0]);
+      if( T[0] == T[1] )
+      {
+         nmap = 1;
+         f[0] = 1.0;
+         f[1] = 0.0;
+      }
+      else
+      {
+         f[0] = (T[1]-t   ) / (T[1]-T[0]);
+         f[1] = (t   -T[0]) / (T[1]-T[0]);
+      }
 
          // if only one map, then we have to use the neareast
       if( nmap == 1 )
@@ -412,22 +760,267 @@ namespace gpstk
             // object to hold the corresponding data to the current map
          IonexData iod;
 
-            // Compute TEC value
-         if ( ivtm.find(IonexData::TEC) != ivtm.end() )
+         try
          {
 
-            iod = ivtm[IonexData::TEC];
-            tecval[0] = tecval[0] + f[imap]*iod.getValue(pos);
+               // Compute TEC value
+            if ( ivtm.find(IonexData::TEC) != ivtm.end() )
+            {
+
+               iod = ivtm[IonexData::TEC];
+               tecval[0] = tecval[0] + f[imap]*iod.getValue(pos);
+
+            }
+
+               // Compute RMS value
+            if ( ivtm.find(IonexData::RMS) != ivtm.end() )
+            {
+
+               iod = ivtm[IonexData::RMS];
+               tecval[1] = tecval[1] + f[imap]*iod.getValue(pos);
 
+            }
+
+         }
+         catch (InvalidRequest& e)
+         {
+            GPSTK_RETHROW(e);
+         }
+         catch (Exception& u)
+         {
+               // undefined values are reported as FFStreamError by
+               // IonexData, which this method may not throw
+            InvalidRequest e(u.what());
+            GPSTK_THROW(e);
          }
 
-            // Compute RMS value
-         if ( ivtm.find(IonexData::RMS) != ivtm.end() )
+      }  // End of 'for(int imap = 0; imap < nmap; imap++)...'
+
+
+         // ionosphere height in meters
+      tecval[2] = RX.theArray[2];
+
+      return tecval;
+
+   }  // End of method 'IonexStore::getIonexValue()'
+
+
+
+      /* Get IONEX TEC, RMS and ionosphere height values at one epoch
+       * for several positions. The maps used are found only once for all
+       * the positions.
+       *
+       * @param t          Time tag of signal (CommonTime object)
+       * @param RXs        Positions in GEOCENTRIC coordinates
+       * @param values     TEC, RMS and ionosphere height values, one per
+       *                   position (@sa getIonexValue())
+       * @param strategy   Interpolation strategy (@sa getIonexValue())
+       */
+   void IonexStore::getIonexValues( const CommonTime& t,
+                                    const std::vector<Position>& RXs,
+                                    std::vector<Triple>& values,
+                                    int strategy ) const
+      throw(InvalidRequest)
+   {
+
+      values.resize(RXs.size());
+
+      if (!packedMaps.valid)
+      {
+         for (size_t i = 0; i < RXs.size(); i++)
+         {
+            values[i] = getIonexValue(t, RXs[i], strategy);
+         }
+
+         return;
+      }
+
+      int k[2];
+      double f[2];
+      int nmap( findPackedMaps(t, strategy, k, f) );
+
+      for (size_t i = 0; i < RXs.size(); i++)
+      {
+         values[i] = getPackedValue(t, RXs[i], strategy, nmap, k, f);
+      }
+
+      return;
+
+   }  // End of method 'IonexStore::getIonexValues()'
+
+
+
+      /* Check the epoch and strategy of a request, and find the maps
+       * to be used and their factors.
+       *
+       * @param t          Time tag of signal
+       * @param strategy   Interpolation strategy (@sa getIonexValue())
+       * @param k          Indexes of the maps within packedMaps.epochs
+       * @param f          Factors of the maps
+       *
+       * @return           Number of maps to be used (1 or 2)
+       */
+   int IonexStore::findPackedMaps( const CommonTime& t,
+                                   int strategy,
+                                   int k[2],
+                                   double f[2] ) const
+      throw(InvalidRequest)
+   {
+
+         // current time check
+      if (t < getInitialTime())
+      {
+         InvalidRequest e("Inadequate data before requested time");
+         GPSTK_THROW(e);
+      }
+
+      if (t > getFinalTime() )
+      {
+         InvalidRequest e("Inadequate data after requested time");
+         GPSTK_THROW(e);
+      }
+
+         //let's define the number of maps to be considered
+      int nmap;
+      if      (strategy == 1) nmap = 1;
+      else if (strategy == 2) nmap = 2;
+      else if (strategy == 3) nmap = 2;
+      else if (strategy == 4) nmap = 1;
+      else
+      {
+         InvalidRequest e("Invalid interpolation stategy");
+         GPSTK_THROW(e);
+      }
+
+      const std::vector<CommonTime>& epochs(packedMaps.epochs);
+      int nepoch( static_cast<int>(epochs.size()) );
+
+         // first map after t, so that epochs[k[0]] <= t < epochs[k[1]]
+      k[1] = static_cast<int>( std::upper_bound( epochs.begin(),
+                                                 epochs.end(),
+                                                 t ) - epochs.begin() );
+      k[0] = k[1] - 1;
+
+      if (k[0] < 0)
+      {
+         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
+         GPSTK_THROW(e);
+      }
+
+         // t is the last epoch (or the only one)
+      if (k[1] == nepoch)
+      {
+         if (nepoch == 1)
+         {
+            k[1] = k[0];
+            f[0] = 1.0;
+            f[1] = 0.0;
+
+            return 1;
+         }
+
+         k[0]--;
+         k[1]--;
+      }
+
+         // factors (As in Eq.(3), pag.2 of the manual)
+      double dt( epochs[k[1]] - epochs[k[0]] );
+      f[0] = (epochs[k[1]] - t) / dt;
+      f[1] = (t - epochs[k[0]]) / dt;
+
+         // if only one map, then we have to use the neareast
+      if( nmap == 1 )
+      {
+
+            // closer to the next map
+         if( f[1] > f[0] )
+         {
+            k[0] = k[1];
+         }
+
+            // than the factor is unit
+         f[0] = 1.0;
+
+      }  // if( nmap == 1 )
+
+      return nmap;
+
+   }  // End of method 'IonexStore::findPackedMaps()'
+
+
+
+      /* Get TEC, RMS and ionosphere height values from the packed maps
+       * found by findPackedMaps().
+       *
+       * @param t          Time tag of signal
+       * @param RX         Position in GEOCENTRIC coordinates
+       * @param strategy   Interpolation strategy (@sa getIonexValue())
+       * @param nmap       Number of maps to be used
+       * @param k          Indexes of the maps within packedMaps.epochs
+       * @param f          Factors of the maps
+       */
+   Triple IonexStore::getPackedValue( const CommonTime& t,
+                                      const Position& RX,
+                                      int strategy,
+                                      int nmap,
+                                      const int k[2],
+                                      const double f[2] ) const
+      throw(InvalidRequest)
+   {
+
+         // this never should happen but just in case
+      if ( RX.getCoordinateSystem() != Position::Geocentric )
+      {
+
+         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
+
+         GPSTK_THROW(e);
+
+      }
+
+      Triple tecval(0.0,0.0,0.0);
+
+         // loop over the number of maps considered
+      for(int imap = 0; imap < nmap; imap++)
+      {
+
+         double beta( RX.theArray[0] );
+         double lambda( RX.theArray[1] );
+
+            // take into account the rotation around the Sun
+         if (strategy == 3 || strategy == 4)
          {
 
-            iod = ivtm[IonexData::RMS];
-            tecval[1] = tecval[1] + f[imap]*iod.getValue(pos);
+               // seconds of time to degree (360.0 / 86400.0)
+            double sec2deg( 4.16666666666667e-3 );
+
+               // count the rotation
+            lambda = lambda + ( t - packedMaps.epochs[k[imap]] ) * sec2deg;
+
+         }
 
+            // IONEX longitudes are within [-180 180]
+         if (lambda > 180.0)
+         {
+            lambda = lambda - 360.0;
+         }
+
+            // Compute TEC value
+         if (packedMaps.hasTEC[k[imap]])
+         {
+            tecval[0] = tecval[0] + f[imap]*interpolatePackedMap( packedMaps.tec,
+                                                                  k[imap],
+                                                                  beta,
+                                                                  lambda );
+         }
+
+            // Compute RMS value
+         if (packedMaps.hasRMS[k[imap]])
+         {
+            tecval[1] = tecval[1] + f[imap]*interpolatePackedMap( packedMaps.rms,
+                                                                  k[imap],
+                                                                  beta,
+                                                                  lambda );
          }
 
       }  // End of 'for(int imap = 0; imap < nmap; imap++)...'
@@ -438,7 +1031,118 @@ namespace gpstk
 
       return tecval;
 
-   }  // End of method 'IonexStore::getIonexValue()'
+   }  // End of method 'IonexStore::getPackedValue()'
+
+
+
+      /* Interpolate a packed map at the given geocentric latitude and
+       * longitude, as IonexData::getValue() does.
+       *
+       * @param values     Packed TEC or RMS values
+       * @param k          Index of the map within packedMaps.epochs
+       * @param beta       Geocentric latitude (degrees)
+       * @param lambda     Longitude (degrees), within [-180, 180]
+       */
+   double IonexStore::interpolatePackedMap( const std::vector<double>& values,
+                                            int k,
+                                            double beta,
+                                            double lambda ) const
+      throw(InvalidRequest)
+   {
+
+      const PackedMaps& pm(packedMaps);
+
+         // lower left hand grid point E00 (indexes start at 1, as in
+         // IonexData::getIndex())
+      int ilat( static_cast<int>( (beta - pm.lat[0]) / pm.lat[2] + 1.0 ) );
+
+      if (ilat < 1 || ilat >= pm.nlat)
+      {
+         InvalidRequest e( "Irregular latitude. Latitude "
+                           + asString(beta) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+      int ilon( static_cast<int>( (lambda - pm.lon[0]) / pm.lon[2] + 1.0 ) );
+
+      if (ilon < 1)
+      {
+         ilon = ilon + pm.ncyc;
+      }
+      else if (ilon > pm.nlon)
+      {
+         ilon = ilon - pm.ncyc;
+      }
+
+      if (ilon < 1 || ilon > pm.nlon)
+      {
+         InvalidRequest e( "Irregular longitude. Longitude: "
+                           + asString(lambda) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+         // compute factors P and Q
+      double xp( (lambda - (pm.lon[0] + (ilon-1)*pm.lon[2])) / pm.lon[2] );
+      double xq( (beta   - (pm.lat[0] + (ilat-1)*pm.lat[2])) / pm.lat[2] );
+
+         // rounding may leave the point just outside the cell of E00, as
+         // in IonexData::getValue()
+      if ( (xp < 0.0) && (xp > -1.e-9) ) xp = 0.0;
+      if ( (xp > 1.0) && (xp < 1.0+1.e-9) ) xp = 1.0;
+      if ( (xq < 0.0) && (xq > -1.e-9) ) xq = 0.0;
+      if ( (xq > 1.0) && (xq < 1.0+1.e-9) ) xq = 1.0;
+
+         // this never should happen but just in case
+      if ( (xp < 0) || (xp > 1) || (xq < 0) || (xq > 1) )
+      {
+         InvalidRequest e("IonexStore: Wrong xp and xq factors!!!");
+         GPSTK_THROW(e);
+      }
+
+         // next longitude, around the Earth if needed
+      int ilon1( ilon + 1 );
+      if (ilon1 > pm.nlon)
+      {
+         ilon1 = ilon1 - pm.ncyc;
+
+         if (ilon1 < 1)
+         {
+            InvalidRequest e( "Irregular longitude. Longitude: "
+                              + asString(lambda) + " DEG" );
+            GPSTK_THROW(e);
+         }
+      }
+
+         // indexes of E00, E10, E01 and E11
+      size_t row( (size_t(k)*pm.nlat + (ilat-1))*pm.nlon );
+      size_t e[4];
+      e[0] = row + (ilon -1);
+      e[1] = row + (ilon1-1);
+      e[2] = e[0] + pm.nlon;
+      e[3] = e[1] + pm.nlon;
+
+         // let's fetch the values
+      double pntval[4];
+      for (int i = 0; i < 4; i++)
+      {
+
+         pntval[i] = values[e[i]];
+
+         if (pntval[i] == 999.9)
+         {
+            InvalidRequest e("Undefined TEC/RMS value(s).");
+            GPSTK_THROW(e);
+         }
+
+      }  // End of 'for (int i = 0; i < 4; i++)...'
+
+         // bivariate interpolation (pag.3, IONEX manual)
+      return ( (1.0-xp) * (1.0-xq) * pntval[0] +
+                    xp  * (1.0-xq) * pntval[1] +
+               (1.0-xp) *      xq  * pntval[2] +
+                    xp  *      xq  * pntval[3] );
+
+   }  // End of method 'IonexStore::interpolatePackedMap()'
 
 
 
@@ -45,6 +45,7 @@
 #define GPSTK_IONEXSTORE_HPP
 
 #include <map>
+#include <vector>
 
 #include "FileStore.hpp"
 #include "IonexData.hpp"
@@ -83,7 +84,8 @@ namespace gpstk
       IonexStore()
          throw()
          : initialTime(CommonTime::END_OF_TIME),
-           finalTime(CommonTime::BEGINNING_OF_TIME)
+           finalTime(CommonTime::BEGINNING_OF_TIME),
+           packedMode(true)
       {};
 
 
@@ -91,7 +93,11 @@ namespace gpstk
       virtual ~IonexStore() {};
 
 
-         /// Load the given IONEX file
+         /** Load the given IONEX file. If the product cache is enabled
+          *  (see ProductCache), the maps of a file already loaded by an
+          *  earlier run are read from the cache instead of being parsed;
+          *  the header is still read from the file.
+          */
       virtual void loadFile(const std::string& filename)
          throw(FileMissingException);
 
@@ -101,6 +107,36 @@ namespace gpstk
          throw();
 
 
+         /** Pack all the TEC and RMS maps of the store into a contiguous
+          *  (epoch x latitude x longitude) array, which is then used by
+          *  getIonexValue() and getIonexValues() instead of the individual
+          *  maps. This is done by loadFile() when the packed mode is on;
+          *  call it after addMap() to pack the maps added.
+          *
+          * Maps are only packed if all of them are two-dimensional and
+          * share the same latitude and longitude grid; otherwise the
+          * individual maps are used.
+          */
+      void packMaps()
+         throw();
+
+
+         /** Set whether loadFile() packs the maps (see packMaps()). It is
+          *  on by default.
+          *
+          * @param packed     true to pack the maps, false to use the
+          *                   individual maps.
+          */
+      IonexStore& setPackedMode(bool packed)
+         throw();
+
+
+         /// Returns true if the maps of the store are currently packed.
+      bool isPacked() const
+         throw()
+      { return packedMaps.valid; };
+
+
          /** Dump the store to the provided std::ostream (std::cout by default).
           *
           * @param s       std::ostream object to dump the data to.
@@ -140,6 +176,10 @@ namespace gpstk
           * @return values    TEC, RMS and ionosphere height values
           *                   (Triple object with: TEC and RMS in TECU and
           *                   the ionosphere height in meters)
+          *
+          * @throw InvalidRequest if there are no maps at 't', if RX is
+          *        outside the grid, or if the map value is undefined
+          *        there; whether or not the maps are packed.
           */
       Triple getIonexValue( const CommonTime& t,
                             const Position& RX,
@@ -147,6 +187,24 @@ namespace gpstk
          throw(InvalidRequest);
 
 
+         /** Get IONEX TEC, RMS and ionosphere height values at one epoch
+          *  for several positions, for example the ionospheric pierce
+          *  points of all the satellites in view. The maps used are found
+          *  only once for all the positions.
+          *
+          * @param t          Time tag of signal (CommonTime object)
+          * @param RXs        Positions in GEOCENTRIC coordinates
+          * @param values     TEC, RMS and ionosphere height values, one per
+          *                   position (@sa getIonexValue())
+          * @param strategy   Interpolation strategy (@sa getIonexValue())
+          */
+      void getIonexValues( const CommonTime& t,
+                           const std::vector<Position>& RXs,
+                           std::vector<Triple>& values,
+                           int strategy = 3 ) const
+         throw(InvalidRequest);
+
+
 
       /** Get slant total electron content (STEC) in TECU
        *
@@ -370,6 +428,116 @@ namespace gpstk
       IonexDCBMap inxDCBMap;
 
 
+         /// TEC and RMS maps packed in a contiguous array, with their grid.
+      struct PackedMaps
+      {
+
+            /// Whether the packed data is in use
+         bool valid;
+
+            /// Latitude and longitude grid (first, last, increment)
+         double lat[3], lon[3];
+
+            /// Number of latitudes and longitudes in the grid, and number of
+            /// longitude increments around the Earth
+         int nlat, nlon, ncyc;
+
+            /// Epochs of the maps
+         std::vector<CommonTime> epochs;
+
+            /// Whether there is a TEC or RMS map at each epoch
+         std::vector<bool> hasTEC, hasRMS;
+
+            /// TEC and RMS values, indexed by (epoch*nlat + lat)*nlon + lon
+         std::vector<double> tec, rms;
+
+         PackedMaps() : valid(false) {};
+
+      };
+
+
+         /// Packed maps
+      PackedMaps packedMaps;
+
+
+         /// Whether loadFile() packs the maps
+      bool packedMode;
+
+
+         /** Add to the store the maps of the product cache entry of a
+          *  file, if there is a matching entry (see ProductCache).
+          *
+          * @param filename   Name of the IONEX file
+          *
+          * @return           true if the maps were added, false if the file
+          *                   must be parsed.
+          */
+      bool loadCachedMaps(const std::string& filename)
+         throw();
+
+
+         /** Write the maps of a file to the product cache. Errors are
+          *  ignored.
+          *
+          * @param filename   Name of the IONEX file
+          * @param maps       Maps read from the file
+          */
+      void saveCachedMaps( const std::string& filename,
+                           const std::vector<IonexData>& maps )
+         throw();
+
+
+         /** Check the epoch and strategy of a request, and find the maps
+          *  to be used and their factors.
+          *
+          * @param t          Time tag of signal
+          * @param strategy   Interpolation strategy (@sa getIonexValue())
+          * @param k          Indexes of the maps within packedMaps.epochs
+          * @param f          Factors of the maps
+          *
+          * @return           Number of maps to be used (1 or 2)
+          */
+      int findPackedMaps( const CommonTime& t,
+                          int strategy,
+                          int k[2],
+                          double f[2] ) const
+         throw(InvalidRequest);
+
+
+         /** Get TEC, RMS and ionosphere height values from the packed maps
+          *  found by findPackedMaps().
+          *
+          * @param t          Time tag of signal
+          * @param RX         Position in GEOCENTRIC coordinates
+          * @param strategy   Interpolation strategy (@sa getIonexValue())
+          * @param nmap       Number of maps to be used
+          * @param k          Indexes of the maps within packedMaps.epochs
+          * @param f          Factors of the maps
+          */
+      Triple getPackedValue( const CommonTime& t,
+                             const Position& RX,
+                             int strategy,
+                             int nmap,
+                             const int k[2],
+                             const double f[2] ) const
+         throw(InvalidRequest);
+
+
+         /** Interpolate a packed map at the given geocentric latitude and
+          *  longitude, as IonexData::getValue() does.
+          *
+          * @param values     Packed TEC or RMS values
+          * @param k          Index of the map within packedMaps.epochs
+          * @param beta       Geocentric latitude (degrees)
+          * @param lambda     Longitude (degrees), within [-180, 180]
+          */
+      double interpolatePackedMap( const std::vector<double>& values,
+                                   int k,
+                                   double beta,
+                                   double lambda ) const
+         throw(InvalidRequest);
+
+
    }; // End of class 'IonexStore'
 
       //@}
@@ -67,9 +67,6 @@ namespace gpstk
       throw(InvalidRequest)
    {
 
-      const int NUM_COMPONENTS = 3;
-      const int NUM_HARMONICS = 11;
-
       Matrix<double> harmonics(6,11,0.0);
 
          // Get harmonics data from file
@@ -80,6 +77,65 @@ namespace gpstk
          // Compute arguments
       arguments = getArg(t);
 
+      return getLoading(harmonics, arguments);
+
+   }  // End of method 'OceanLoading::getOceanLoading()'
+
+
+
+      /* Returns the effect of ocean tides loading (meters) at several
+       * stations and a single epoch, in the Up-East-North (UEN) reference
+       * frame. The astronomical arguments, which depend only on the
+       * epoch, are computed once for all the stations.
+       *
+       * @param names Station names (case is NOT relevant).
+       * @param time  Epoch to look up
+       *
+       * @return a vector of Triples, one per station and in the same order
+       * as 'names', with the ocean tidas loading effect, in meters and in
+       * the UEN reference frame.
+       *
+       * @throw InvalidRequest If the request can not be completed for any
+       * reason, this is thrown. The text may have additional information
+       * about the reason the request failed.
+       */
+   std::vector<Triple> OceanLoading::getOceanLoading(
+                                          const std::vector<string>& names,
+                                          const CommonTime& t )
+      throw(InvalidRequest)
+   {
+
+         // Compute arguments, common to all the stations
+      Vector<double> arguments( getArg(t) );
+
+      std::vector<Triple> oLoading( names.size() );
+
+      for(size_t i=0; i<names.size(); i++)
+      {
+         oLoading[i] = getLoading( blqData.getTideHarmonics(names[i]),
+                                   arguments );
+      }
+
+      return oLoading;
+
+   }  // End of method 'OceanLoading::getOceanLoading()'
+
+
+
+      /* Compute the ocean loading effect in the UEN reference frame,
+       * given the tide harmonics of the station and the astronomical
+       * arguments.
+       *
+       * @param harmonics  Tide harmonics of the station.
+       * @param arguments  Astronomical arguments, as given by getArg().
+       */
+   Triple OceanLoading::getLoading( const Matrix<double>& harmonics,
+                                    const Vector<double>& arguments ) const
+   {
+
+      const int NUM_COMPONENTS = 3;
+      const int NUM_HARMONICS = 11;
+
       Triple oLoading;
 
       for(int i=0; i<NUM_COMPONENTS;  i++)
@@ -105,7 +161,7 @@ namespace gpstk
 
       return oLoading;
 
-   }  // End of method 'OceanLoading::getOceanLoading()'
+   }  // End of method 'OceanLoading::getLoading()'
 
 
 
@@ -44,6 +44,7 @@
 #define OCEANLOADING_HPP
 
 #include <string>
+#include <vector>
 #include "Triple.hpp"
 #include "Vector.hpp"
 #include "Matrix.hpp"
@@ -121,6 +122,27 @@ namespace gpstk
          throw(InvalidRequest);
 
 
+         /** Returns the effect of ocean tides loading (meters) at several
+          *  stations and a single epoch, in the Up-East-North (UEN)
+          *  reference frame. The astronomical arguments, which depend only
+          *  on the epoch, are computed once for all the stations.
+          *
+          * @param names Station names (case is NOT relevant).
+          * @param time  Epoch to look up
+          *
+          * @return a vector of Triples, one per station and in the same
+          * order as 'names', with the ocean tidas loading effect, in meters
+          * and in the UEN reference frame.
+          *
+          * @throw InvalidRequest If the request can not be completed for any
+          * reason, this is thrown. The text may have additional information
+          * about the reason the request failed.
+          */
+      std::vector<Triple> getOceanLoading( const std::vector<std::string>& names,
+                                           const CommonTime& t )
+         throw(InvalidRequest);
+
+
          /// Returns the name of BLQ file containing ocean tides harmonics data.
       virtual std::string getFilename(void) const
       { return fileData; };
@@ -159,6 +181,17 @@ namespace gpstk
       virtual Vector<double> getArg(const CommonTime& time);
 
 
+         /** Compute the ocean loading effect in the UEN reference frame,
+          *  given the tide harmonics of the station and the astronomical
+          *  arguments.
+          *
+          * @param harmonics  Tide harmonics of the station.
+          * @param arguments  Astronomical arguments, as given by getArg().
+          */
+      Triple getLoading( const Matrix<double>& harmonics,
+                         const Vector<double>& arguments ) const;
+
+
    }; // End of class 'OceanLoading'
 
       //@}
@@ -88,81 +88,156 @@ namespace gpstk
          Triple sunPos(sunPosition.getPosition(t));
          Triple moonPos(moonPosition.getPosition(t));
 
+         res = getTide(sunPos, moonPos, p);
 
-            // Compute the factors for the Sun
-         double rpRs( p.X()*sunPos.theArray[0] + 
-                      p.Y()*sunPos.theArray[1] + 
-                      p.Z()*sunPos.theArray[2]);
+      } // End of try block
+      catch(InvalidRequest& ir)
+      {
+         GPSTK_RETHROW(ir);
+      }
 
-         double Rs2(sunPos.theArray[0]*sunPos.theArray[0] +
-                    sunPos.theArray[1]*sunPos.theArray[1] +
-                    sunPos.theArray[2]*sunPos.theArray[2]);
+      return res;
 
-         double rp2( p.X()*p.X() + p.Y()*p.Y() + p.Z()*p.Z() );
+   } // End SolidTides::getSolidTide
 
-         double xy2p( p.X()*p.X() + p.Y()*p.Y() );
-         double sqxy2p( std::sqrt(xy2p) );
 
-         double sqRs2(std::sqrt(Rs2));
 
-         double fac_s( 3.0*MU_SUN*rp2/(sqRs2*sqRs2*sqRs2*sqRs2*sqRs2) );
+      /* Returns the effect of solid Earth tides (meters) at several
+       * positions and a single epoch, in the Up-East-North (UEN)
+       * reference frame. The Sun and Moon positions are computed once
+       * for all the positions.
+       *
+       * @param[in] t Epoch to look up
+       * @param[in] p Positions of interest
+       *
+       * @return a vector of Triples, one per position and in the same
+       * order as 'p', with the solid tidal effect, in meters and in the
+       * UEN reference frame.
+       *
+       * @throw InvalidRequest If the request can not be completed for any
+       * reason, this is thrown. The text may have additional information
+       * as to why the request failed.
+       */
+   std::vector<Triple> SolidTides::getSolidTide(const CommonTime& t,
+                                        const std::vector<Position>& p) const
+      throw(InvalidRequest)
+   {
 
-         double g1sun( fac_s*(rpRs*rpRs/2.0 - rp2*Rs2/6.0) );
+         // We will store here the results
+      std::vector<Triple> res( p.size() );
 
-         double g2sun( fac_s * rpRs * (sunPos.theArray[1]*p.X() -
-                       sunPos.theArray[0]*p.Y()) * std::sqrt(rp2)/sqxy2p );
+         // Objects to compute Sun and Moon positions
+      SunPosition  sunPosition;
+      MoonPosition moonPosition;
 
-         double g3sun( fac_s * rpRs * ( sqxy2p* sunPos.theArray[2] -
-                       p.Z()/sqxy2p * (p.X()*sunPos.theArray[0] +
-                       p.Y()*sunPos.theArray[1]) ) );
+      try
+      {
 
+            // Sun and Moon positions are common to all the positions
+         Triple sunPos(sunPosition.getPosition(t));
+         Triple moonPos(moonPosition.getPosition(t));
 
-            // Compute the factors for the Moon
-         double rpRm( p.X()*moonPos.theArray[0] + 
-                      p.Y()*moonPos.theArray[1] + 
-                      p.Z()*moonPos.theArray[2]);
+         for(size_t i=0; i<p.size(); i++)
+         {
+            res[i] = getTide(sunPos, moonPos, p[i]);
+         }
 
-         double Rm2(moonPos.theArray[0]*moonPos.theArray[0] +
-                    moonPos.theArray[1]*moonPos.theArray[1] +
-                    moonPos.theArray[2]*moonPos.theArray[2]);
+      } // End of try block
+      catch(InvalidRequest& ir)
+      {
+         GPSTK_RETHROW(ir);
+      }
 
-         double sqRm2(std::sqrt(Rm2));
+      return res;
 
-         double fac_m( 3.0*MU_MOON*rp2/(sqRm2*sqRm2*sqRm2*sqRm2*sqRm2) );
+   } // End SolidTides::getSolidTide
 
-         double g1moon( fac_m*(rpRm*rpRm/2.0 - rp2*Rm2/6.0) );
 
-         double g2moon( fac_m * rpRm * (moonPos.theArray[1]*p.X() -
-                        moonPos.theArray[0]*p.Y()) * std::sqrt(rp2)/sqxy2p );
 
-         double g3moon( fac_m * rpRm * ( sqxy2p* moonPos.theArray[2] -
-                        p.Z()/sqxy2p * (p.X()*moonPos.theArray[0] +
-                        p.Y()*moonPos.theArray[1]) ) );
+      /* Returns the effect of solid Earth tides (meters) at the given
+       * position, in the UEN reference frame, given the Sun and Moon
+       * positions at the epoch of interest.
+       *
+       * @param[in] sunPos  Position of the Sun, ECEF in meters
+       * @param[in] moonPos Position of the Moon, ECEF in meters
+       * @param[in] p       Position of interest
+       */
+   Triple SolidTides::getTide( const Triple& sunPos,
+                               const Triple& moonPos,
+                               const Position& p )
+   {
 
-            // Effects due to the Sun
-         double delta_sun1(H_LOVE*g1sun);
-         double delta_sun2(L_LOVE*g2sun);
-         double delta_sun3(L_LOVE*g3sun);
+         // We will store here the results
+      Triple res;
 
-            // Effects due to the Moon
-         double delta_moon1(H_LOVE*g1moon);
-         double delta_moon2(L_LOVE*g2moon);
-         double delta_moon3(L_LOVE*g3moon);
+         // Compute the factors for the Sun
+      double rpRs( p.X()*sunPos.theArray[0] + 
+                   p.Y()*sunPos.theArray[1] + 
+                   p.Z()*sunPos.theArray[2]);
 
-            // Combined effect
-         res.theArray[0] = delta_sun1 + delta_moon1;
-         res.theArray[1] = delta_sun2 + delta_moon2;
-         res.theArray[2] = delta_sun3 + delta_moon3;
+      double Rs2(sunPos.theArray[0]*sunPos.theArray[0] +
+                 sunPos.theArray[1]*sunPos.theArray[1] +
+                 sunPos.theArray[2]*sunPos.theArray[2]);
 
-      } // End of try block
-      catch(InvalidRequest& ir)
-      {
-         GPSTK_RETHROW(ir);
-      }
+      double rp2( p.X()*p.X() + p.Y()*p.Y() + p.Z()*p.Z() );
+
+      double xy2p( p.X()*p.X() + p.Y()*p.Y() );
+      double sqxy2p( std::sqrt(xy2p) );
+
+      double sqRs2(std::sqrt(Rs2));
+
+      double fac_s( 3.0*MU_SUN*rp2/(sqRs2*sqRs2*sqRs2*sqRs2*sqRs2) );
+
+      double g1sun( fac_s*(rpRs*rpRs/2.0 - rp2*Rs2/6.0) );
+
+      double g2sun( fac_s * rpRs * (sunPos.theArray[1]*p.X() -
+                    sunPos.theArray[0]*p.Y()) * std::sqrt(rp2)/sqxy2p );
+
+      double g3sun( fac_s * rpRs * ( sqxy2p* sunPos.theArray[2] -
+                    p.Z()/sqxy2p * (p.X()*sunPos.theArray[0] +
+                    p.Y()*sunPos.theArray[1]) ) );
+
+
+         // Compute the factors for the Moon
+      double rpRm( p.X()*moonPos.theArray[0] + 
+                   p.Y()*moonPos.theArray[1] + 
+                   p.Z()*moonPos.theArray[2]);
+
+      double Rm2(moonPos.theArray[0]*moonPos.theArray[0] +
+                 moonPos.theArray[1]*moonPos.theArray[1] +
+                 moonPos.theArray[2]*moonPos.theArray[2]);
+
+      double sqRm2(std::sqrt(Rm2));
+
+      double fac_m( 3.0*MU_MOON*rp2/(sqRm2*sqRm2*sqRm2*sqRm2*sqRm2) );
+
+      double g1moon( fac_m*(rpRm*rpRm/2.0 - rp2*Rm2/6.0) );
+
+      double g2moon( fac_m * rpRm * (moonPos.theArray[1]*p.X() -
+                     moonPos.theArray[0]*p.Y()) * std::sqrt(rp2)/sqxy2p );
+
+      double g3moon( fac_m * rpRm * ( sqxy2p* moonPos.theArray[2] -
+                     p.Z()/sqxy2p * (p.X()*moonPos.theArray[0] +
+                     p.Y()*moonPos.theArray[1]) ) );
+
+         // Effects due to the Sun
+      double delta_sun1(H_LOVE*g1sun);
+      double delta_sun2(L_LOVE*g2sun);
+      double delta_sun3(L_LOVE*g3sun);
+
+         // Effects due to the Moon
+      double delta_moon1(H_LOVE*g1moon);
+      double delta_moon2(L_LOVE*g2moon);
+      double delta_moon3(L_LOVE*g3moon);
+
+         // Combined effect
+      res.theArray[0] = delta_sun1 + delta_moon1;
+      res.theArray[1] = delta_sun2 + delta_moon2;
+      res.theArray[2] = delta_sun3 + delta_moon3;
 
       return res;
 
-   } // End SolidTides::getSolidTide
+   } // End SolidTides::getTide
 
 
 } // end namespace gpstk
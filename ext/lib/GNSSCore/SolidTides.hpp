@@ -45,6 +45,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 #include "CommonTime.hpp"
 #include "Triple.hpp"
@@ -101,8 +102,41 @@ namespace gpstk
             throw(InvalidRequest);
 
 
+         /** Returns the effect of solid Earth tides (meters) at several
+          * positions and a single epoch, in the Up-East-North (UEN)
+          * reference frame. The Sun and Moon positions are computed once
+          * for all the positions.
+          *
+          * @param[in] t Epoch to look up
+          * @param[in] p Positions of interest
+          *
+          * @return a vector of Triples, one per position and in the same
+          * order as 'p', with the solid tidal effect, in meters and in
+          * the UEN reference frame.
+          *
+          * @throw InvalidRequest If the request can not be completed for any
+          * reason, this is thrown. The text may have additional information
+          * as to why the request failed.
+          */
+         std::vector<Triple> getSolidTide(const CommonTime& t,
+                                          const std::vector<Position>& p) const
+            throw(InvalidRequest);
+
+
    private:
 
+         /** Returns the effect of solid Earth tides (meters) at the given
+          * position, in the UEN reference frame, given the Sun and Moon
+          * positions at the epoch of interest.
+          *
+          * @param[in] sunPos  Position of the Sun, ECEF in meters
+          * @param[in] moonPos Position of the Moon, ECEF in meters
+          * @param[in] p       Position of interest
+          */
+      static Triple getTide( const Triple& sunPos,
+                             const Triple& moonPos,
+                             const Position& p );
+
          /// Love numbers
       static const double H_LOVE, L_LOVE;
 
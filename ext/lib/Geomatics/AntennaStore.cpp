@@ -61,13 +61,48 @@ namespace gpstk
       }
 
       // is the name already in the store?
+      bool replace(false);
       map<string, AntexData>::iterator it;
       it = antennaMap.find(name);
-      if(it != antennaMap.end())       // erase it
+      if(it != antennaMap.end()) {     // erase it
          antennaMap.erase(it);
+         replace = true;
+      }
 
       // add the new data
       antennaMap[name] = antdata;
+
+      // update the satellite index; rebuild it if an entry was replaced,
+      // since the replaced antenna may have been indexed
+      if(replace) {
+         satPRNIndex.clear();
+         satSVNIndex.clear();
+         for(it = antennaMap.begin(); it != antennaMap.end(); it++)
+            indexSatellite(it->first, it->second);
+      }
+      else
+         indexSatellite(name, antennaMap[name]);
+   }
+
+   //----------------------------------------------------------------------------
+   // add a satellite antenna to satPRNIndex and satSVNIndex. The index keeps the
+   // first (in order of name) antenna for each system/PRN and system/SVN, which
+   // is the one a search through antennaMap would find.
+   void AntennaStore::indexSatellite(const string& name, const AntexData& antdata)
+      throw()
+   {
+      if(antdata.isRxAntenna) return;
+
+      map<pair<char,int>, string>::iterator jt;
+      pair<char,int> key(antdata.systemChar, antdata.PRN);
+      jt = satPRNIndex.find(key);
+      if(jt == satPRNIndex.end() || name < jt->second)
+         satPRNIndex[key] = name;
+
+      key.second = antdata.SVN;
+      jt = satSVNIndex.find(key);
+      if(jt == satSVNIndex.end() || name < jt->second)
+         satSVNIndex[key] = name;
    }
 
    // Get the antenna data for the given name from the store.
@@ -102,22 +137,33 @@ namespace gpstk
                             string& name, AntexData& data,
                             bool inputPRN) const throw()
    {
-      map<string, AntexData>::const_iterator it;
-      for(it = antennaMap.begin(); it != antennaMap.end(); it++) {
-         if(it->second.isRxAntenna) continue;
-         if(it->second.systemChar != sys) continue;
-         if(inputPRN && it->second.PRN == n) {
-            name = it->first;
-            data = it->second;
-            return true;
-         }
-         if(!inputPRN && it->second.SVN == n) {
-            name = it->first;
-            data = it->second;
-            return true;
-         }
-      }
-      return false;
+      const map<pair<char,int>, string>& index(inputPRN ? satPRNIndex
+                                                         : satSVNIndex);
+      map<pair<char,int>, string>::const_iterator it;
+      it = index.find(make_pair(sys,n));
+      if(it == index.end()) return false;
+
+      name = it->second;
+      data = antennaMap.find(name)->second;
+      return true;
+   }
+
+   //----------------------------------------------------------------------------
+   // Find the antenna data for the given satellite in the store, without copying
+   // it; same as getSatelliteAntenna() but faster.
+   // return pointer to the data, or null if satellite was not found in the store
+   const AntexData *AntennaStore::findSatelliteAntenna(const char sys,
+                                                       const int n,
+                                                       bool inputPRN) const
+      throw()
+   {
+      const map<pair<char,int>, string>& index(inputPRN ? satPRNIndex
+                                                         : satSVNIndex);
+      map<pair<char,int>, string>::const_iterator it;
+      it = index.find(make_pair(sys,n));
+      if(it == index.end()) return NULL;
+
+      return &(antennaMap.find(it->second)->second);
    }
 
    // Get a vector of all antenna names in the store
@@ -284,77 +330,16 @@ namespace gpstk
                                       bool inputPRN) const
       throw(Exception)
    {
-      AntexData antenna;
-      string name;
       try
       {
-         if (getSatelliteAntenna(sys, n, name, antenna))
+         const AntexData *antenna = findSatelliteAntenna(sys, n);
+         if(antenna)
          {
-
-            // tracking, and future expansion. 
-            double fact1, fact2;
-            string freq1, freq2;
-            switch (sys)
-            {
-               case 'G':
-               {
-                  fact1 = 2.5458;   // (alpha+1)/alpha
-                  fact2 = -1.5458;  // -1/alpha
-                  freq1 = "G01";
-                  freq2 = "G01";
-                  break;
-               }
-               case 'R':
-               {
-                  fact1 = 2.53125;
-                  fact2 = -1.52125;
-                  freq1 = "R01";
-                  freq2 = "R02";
-                  break;
-               }
-               case 'C':
-               {
-                  fact1 = 2.53125;
-                  fact2 = -1.52125;
-                  freq1 = "C01";
-                  freq2 = "C02";
-                  break;
-               }
-
-               default:
-               {
-                  stringstream ss;
-                  ss << "Invalid satellite system " << sys << " PRN " << n; 
-                  ss << " for AntennaStore::ComToPcVector.";
-                  InvalidRequest ir(ss.str());
-                  GPSTK_THROW(ir); 
-               }
-            }
-             
-           // Rotation matrix from satellite attitude.
-           // Rot * [XYZ] = [body frame]
-           Matrix<double> SVAtt;
-
            // Use low accuracy Sun vector from SunEarthSatGeometry
            double AR;
            Position Sun=SolarPosition(ct,AR);
-           Position Rx=Position(satVector);
-           SVAtt = SatelliteAttitude(Rx,Sun);
-
-           // phase center offset vector in body frame (at L1)
-           Triple pco1 = antenna.getPhaseCenterOffset(freq1);
-           Triple pco2 = antenna.getPhaseCenterOffset(freq2);
-           Vector<double> PCO(3);
-           for(int i=0; i<3; i++)            // body frame, mm -> m, iono-free combo
-              PCO(i) = (fact1*pco1[i]+fact2*pco2[i])/1000.0;
-
-           // PCO vector (from COM to PC) in ECEF XYZ frame, m
-           Vector<double> SatPCOXYZ(3);
-           SatPCOXYZ = transpose(SVAtt) * PCO;
-           Triple pcoxyz = Triple(SatPCOXYZ(0), SatPCOXYZ(1), SatPCOXYZ(2));
-
-           return pcoxyz; 
 
+           return ComToPcVector(*antenna, sys, n, Sun, satVector);
          }
          else
          {
@@ -371,30 +356,93 @@ namespace gpstk
       }
    }
 
-   // Same as above except with different calling sequence for convenience
-   Triple AntennaStore::ComToPcVector(const SatID& sidr, 
-                                      const CommonTime& ct, 
+   //----------------------------------------------------------------------------
+   // Compute the vector (m) from the SV COM to the phase center given the antenna
+   // data of the satellite and the position of the Sun.
+   Triple AntennaStore::ComToPcVector(const AntexData& antenna,
+                                      const char sys,
+                                      const int n,
+                                      const Position& Sun,
                                       const Triple& satVector) const
       throw(Exception)
    {
-      char sys = ' ';
-      Triple tp;
-      switch (sidr.system)
+      // tracking, and future expansion. 
+      double fact1, fact2;
+      string freq1, freq2;
+      switch (sys)
       {
-         case SatID::systemGPS:     {sys='G'; break;}
-         //case systemGalileo: {sys='E'; break;}   Not yet  implemented
-         case SatID::systemGlonass: {sys='R'; break;}
-         case SatID::systemBeiDou:  {sys='C'; break;}
+         case 'G':
+         {
+            fact1 = 2.5458;   // (alpha+1)/alpha
+            fact2 = -1.5458;  // -1/alpha
+            freq1 = "G01";
+            freq2 = "G01";
+            break;
+         }
+         case 'R':
+         {
+            fact1 = 2.53125;
+            fact2 = -1.52125;
+            freq1 = "R01";
+            freq2 = "R02";
+            break;
+         }
+         case 'C':
+         {
+            fact1 = 2.53125;
+            fact2 = -1.52125;
+            freq1 = "C01";
+            freq2 = "C02";
+            break;
+         }
+
          default:
          {
             stringstream ss;
-            ss << "Invalid satellite system " << sidr; 
+            ss << "Invalid satellite system " << sys << " PRN " << n; 
             ss << " for AntennaStore::ComToPcVector.";
             InvalidRequest ir(ss.str());
             GPSTK_THROW(ir); 
          }
       }
 
+      // Rotation matrix from satellite attitude.
+      // Rot * [XYZ] = [body frame]
+      Matrix<double> SVAtt;
+      Position Rx=Position(satVector);
+      SVAtt = SatelliteAttitude(Rx,Sun);
+
+      // phase center offset vector in body frame (at L1)
+      Triple pco1 = antenna.getPhaseCenterOffset(freq1);
+      Triple pco2 = antenna.getPhaseCenterOffset(freq2);
+      Vector<double> PCO(3);
+      for(int i=0; i<3; i++)            // body frame, mm -> m, iono-free combo
+         PCO(i) = (fact1*pco1[i]+fact2*pco2[i])/1000.0;
+
+      // PCO vector (from COM to PC) in ECEF XYZ frame, m
+      Vector<double> SatPCOXYZ(3);
+      SatPCOXYZ = transpose(SVAtt) * PCO;
+
+      return Triple(SatPCOXYZ(0), SatPCOXYZ(1), SatPCOXYZ(2));
+   }
+
+   // Same as above except with different calling sequence for convenience
+   Triple AntennaStore::ComToPcVector(const SatID& sidr, 
+                                      const CommonTime& ct, 
+                                      const Triple& satVector) const
+      throw(Exception)
+   {
+      char sys = systemChar(sidr);
+      Triple tp;
+      if(sys == ' ')
+      {
+         stringstream ss;
+         ss << "Invalid satellite system " << sidr; 
+         ss << " for AntennaStore::ComToPcVector.";
+         InvalidRequest ir(ss.str());
+         GPSTK_THROW(ir); 
+      }
+
       try
       {
          tp = ComToPcVector(sys, sidr.id, ct, satVector);             
@@ -407,6 +455,103 @@ namespace gpstk
    }
 
 
+   //----------------------------------------------------------------------------
+   // Compute the vectors from the SV COM to the phase center for several
+   // satellites at one epoch; the Sun position is computed only once.
+   void AntennaStore::ComToPcVectors(const vector<SatID>& sats,
+                                     const CommonTime& ct,
+                                     const vector<Triple>& satVectors,
+                                     vector<Triple>& pcos) const
+      throw(Exception)
+   {
+      try {
+         if(satVectors.size() != sats.size()) {
+            InvalidRequest ir("Satellite and position arrays differ in length"
+                              " in AntennaStore::ComToPcVectors.");
+            GPSTK_THROW(ir);
+         }
+
+         // Use low accuracy Sun vector from SunEarthSatGeometry
+         double AR;
+         Position Sun=SolarPosition(ct,AR);
+
+         pcos.resize(sats.size());
+         for(size_t i=0; i<sats.size(); i++) {
+            char sys = systemChar(sats[i]);
+            if(sys == ' ') {
+               stringstream ss;
+               ss << "Invalid satellite system " << sats[i];
+               ss << " for AntennaStore::ComToPcVectors.";
+               InvalidRequest ir(ss.str());
+               GPSTK_THROW(ir);
+            }
+
+            const AntexData *antenna = findSatelliteAntenna(sys, sats[i].id);
+            if(!antenna) {
+               stringstream ss;
+               ss << "AntennaStore::ComToPcVectors.  No satellite data found for "
+                  << sys << " PRN " << sats[i].id;
+               InvalidRequest ir(ss.str());
+               GPSTK_THROW(ir);
+            }
+
+            pcos[i] = ComToPcVector(*antenna, sys, sats[i].id, Sun, satVectors[i]);
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //----------------------------------------------------------------------------
+   // Compute the phase center variations of several satellites at one epoch.
+   void AntennaStore::getSatellitePCVs(const vector<SatID>& sats,
+                                       const string& band,
+                                       const vector<double>& azimuths,
+                                       const vector<double>& nadirs,
+                                       vector<double>& pcvs) const
+      throw(Exception)
+   {
+      try {
+         if(azimuths.size() != sats.size() || nadirs.size() != sats.size()) {
+            InvalidRequest ir("Satellite and angle arrays differ in length"
+                              " in AntennaStore::getSatellitePCVs.");
+            GPSTK_THROW(ir);
+         }
+
+         pcvs.resize(sats.size());
+         for(size_t i=0; i<sats.size(); i++) {
+            char sys = systemChar(sats[i]);
+            const AntexData *antenna = (sys == ' ' ? NULL
+                                          : findSatelliteAntenna(sys, sats[i].id));
+            if(!antenna) {
+               stringstream ss;
+               ss << "AntennaStore::getSatellitePCVs.  No satellite data found for "
+                  << sats[i];
+               InvalidRequest ir(ss.str());
+               GPSTK_THROW(ir);
+            }
+
+            pcvs[i] = antenna->getPhaseCenterVariation(string(1,sys) + band,
+                                                       azimuths[i], nadirs[i]);
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //----------------------------------------------------------------------------
+   // return the system character used in ANTEX for the satellite, or blank if
+   // the system is not supported.
+   char AntennaStore::systemChar(const SatID& sat) throw()
+   {
+      switch (sat.system)
+      {
+         case SatID::systemGPS:     return 'G';
+         //case systemGalileo: return 'E';   Not yet  implemented
+         case SatID::systemGlonass: return 'R';
+         case SatID::systemBeiDou:  return 'C';
+         default:                   return ' ';
+      }
+   }
+
    // dump the store
    void AntennaStore::dump(ostream& s, short detail)
    {
@@ -53,6 +53,7 @@
 #include "CommonTime.hpp"
 #include "SatID.hpp"
 #include "Triple.hpp"
+#include "Position.hpp"
 
 namespace gpstk
 {
@@ -123,6 +124,16 @@ namespace gpstk
                                std::string& name, AntexData& data,
                                bool inputPRN=true) const throw();
 
+      /// Find the antenna data for the given satellite in the store, without
+      /// copying it; same as getSatelliteAntenna() but faster. The pointer is
+      /// valid until the store is modified.
+      /// @param        char sys  System character for the satellite: G,R,E or M
+      /// @param           int n  PRN (or SVN) of the satellite
+      /// @param   bool inputPRN  If false, parameter n is SVN not PRN (default true).
+      /// @return pointer to the data, or null if satellite was not found in the store
+      const AntexData *findSatelliteAntenna(const char sys, const int n,
+                                            bool inputPRN=true) const throw();
+
       /// Get a vector of all antenna names in the store
       void getNames(std::vector<std::string>& names) throw();
 
@@ -133,7 +144,8 @@ namespace gpstk
       unsigned int size(void) const throw() { return antennaMap.size(); }
 
       /// clear the store of all information
-      void clear(void) throw() { antennaMap.clear(); }
+      void clear(void) throw()
+      { antennaMap.clear(); satPRNIndex.clear(); satSVNIndex.clear(); }
 
       /// call to have satellite antennas included in store
       /// NB. call before addAntenna() or addANTEXfile()
@@ -195,6 +207,38 @@ namespace gpstk
                            const Triple& satVector) const
          throw(Exception);
 
+      /// Compute the vectors from the SV Center of Mass (COM) to the phase center
+      /// of the antenna for several satellites at one epoch, for example all the
+      /// satellites in view; same as ComToPcVector(SatID,...) for each satellite,
+      /// but the Sun position is computed only once.
+      /// @param sats       satellites of interest
+      /// @param ct         time of interest
+      /// @param satVectors satellite (COM) positions, ECEF XYZ in m, parallel to sats
+      /// @param pcos       output vectors (m) from COM to PC, parallel to sats
+      /// @throw InvalidRequest if no data available for any satellite
+      void ComToPcVectors(const std::vector<SatID>& sats,
+                          const CommonTime& ct,
+                          const std::vector<Triple>& satVectors,
+                          std::vector<Triple>& pcos) const
+         throw(Exception);
+
+      /// Compute the phase center variations of several satellites at one epoch,
+      /// for example all the satellites in view, using the gridded PCVs of the
+      /// AntexData (see AntexData::getPhaseCenterVariation()).
+      /// @param sats       satellites of interest
+      /// @param band       frequency number, which is appended to the system
+      ///                   character to form the ANTEX frequency, e.g. "01"
+      /// @param azimuths   azimuth angles (deg) in the satellite body frame
+      /// @param nadirs     nadir angles (deg), parallel to azimuths
+      /// @param pcvs       output phase center variations (mm), parallel to sats
+      /// @throw InvalidRequest if no data available for any satellite
+      void getSatellitePCVs(const std::vector<SatID>& sats,
+                            const std::string& band,
+                            const std::vector<double>& azimuths,
+                            const std::vector<double>& nadirs,
+                            std::vector<double>& pcvs) const
+         throw(Exception);
+
       /// dump the store
       void dump(std::ostream& s = std::cout, short detail = 0);
 
@@ -208,6 +252,27 @@ namespace gpstk
 
       /// map from name of antenna to AntexData object
       std::map<std::string, AntexData> antennaMap;
+
+      /// maps from (system character, PRN or SVN) to the name of the satellite
+      /// antenna; where several antennas match, the first name is kept.
+      std::map<std::pair<char,int>, std::string> satPRNIndex, satSVNIndex;
+
+      /// add a satellite antenna to satPRNIndex and satSVNIndex
+      void indexSatellite(const std::string& name, const AntexData& antdata)
+         throw();
+
+      /// Compute the vector (m) from the SV COM to the phase center given the
+      /// antenna data of the satellite and the position of the Sun.
+      Triple ComToPcVector(const AntexData& antenna,
+                           const char sys,
+                           const int n,
+                           const Position& Sun,
+                           const Triple& satVector) const
+         throw(Exception);
+
+      /// @return the system character used in ANTEX for the satellite, or
+      /// blank if the system is not supported.
+      static char systemChar(const SatID& sat) throw();
       
    }; // end class AntennaStore
    
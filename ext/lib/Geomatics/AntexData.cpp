@@ -232,6 +232,11 @@ namespace gpstk
       }
 
       const antennaPCOandPCVData& antpco = it->second;
+
+      // use the regular grid, if it has been compiled
+      if(antpco.PCVgrid.isValid())
+         return antpco.PCVgrid.evaluate(azim, zen);
+
       const azimZenMap& azzenmap = antpco.PCVvalue;      // map<double, zenOffsetMap>
 
       if(!antpco.hasAzimuth) {
@@ -304,6 +309,111 @@ namespace gpstk
       return retpco;
    }
 
+   // Compute the phase center variations at many (azimuth, elev_nadir) pairs
+   // for one frequency; the frequency is looked up only once.
+   void AntexData::getPhaseCenterVariations(const string freq,
+                                            const vector<double>& azimuths,
+                                            const vector<double>& elev_nadirs,
+                                            vector<double>& pcvs) const
+      throw(Exception)
+   {
+      if(!isValid()) {
+         Exception e("Invalid AntexData object");
+         GPSTK_THROW(e);
+      }
+      if(azimuths.size() != elev_nadirs.size()) {
+         Exception e("Azimuth and elevation/nadir arrays differ in length");
+         GPSTK_THROW(e);
+      }
+
+      map<string, antennaPCOandPCVData>::const_iterator it;
+      it = freqPCVmap.find(freq);
+      if(it == freqPCVmap.end()) {
+         Exception e("Frequency " + freq
+               + " not found! System not supported or data corrupted.");
+         GPSTK_THROW(e);
+      }
+
+      const PCVGrid& grid = it->second.PCVgrid;
+      pcvs.resize(azimuths.size());
+      for(size_t i=0; i<azimuths.size(); i++) {
+         if(!grid.isValid()) {
+            pcvs[i] = getPhaseCenterVariation(freq, azimuths[i], elev_nadirs[i]);
+            continue;
+         }
+
+         if(elev_nadirs[i] < 0.0 || elev_nadirs[i] > 90.0) {
+            Exception e("Invalid elevation/nadir angle");
+            GPSTK_THROW(e);
+         }
+
+         double azim(azimuths[i]), zen(elev_nadirs[i]);
+         if(isRxAntenna) zen = 90. - zen;
+         while(azim < 0.0) azim += 360.0;
+         while(azim >= 360.0) azim -= 360.0;
+
+         pcvs[i] = grid.evaluate(azim, zen);
+      }
+   }
+
+   // Compile the PCVs of each frequency into a regular grid (PCVGrid).
+   // Frequencies whose PCVs are not on the regular grid defined by zenRange and
+   // azimDelta are left without a grid.
+   void AntexData::compilePCVGrids(void) throw()
+   {
+      static const double tol(1.e-6);     // degrees
+
+      // zenith angles of the grid, as in ParseDataRecord()
+      if(zenRange[2] <= 0.0) return;
+      const int nzen(1+int((zenRange[1]-zenRange[0])/zenRange[2]));
+
+      map<string, antennaPCOandPCVData>::iterator it;
+      for(it = freqPCVmap.begin(); it != freqPCVmap.end(); ++it) {
+         antennaPCOandPCVData& antpco = it->second;
+         const azimZenMap& azzenmap = antpco.PCVvalue;
+         antpco.PCVgrid = PCVGrid();
+         if(nzen < 2 || azzenmap.empty()) continue;
+
+         // rows of the grid: the only (NOAZI) entry, or azimuths 0 to 360
+         vector<const zenOffsetMap *> rows;
+         if(!antpco.hasAzimuth)
+            rows.push_back(&(azzenmap.begin()->second));
+         else {
+            if(azimDelta <= 0.0) continue;
+            const int nazim(1+int(360.0/azimDelta + 0.5));
+            if(::fabs((nazim-1)*azimDelta - 360.0) > tol) continue;
+            azimZenMap::const_iterator jt = azzenmap.lower_bound(-tol);
+            for(int k=0; k<nazim; k++, ++jt) {
+               if(jt == azzenmap.end() || ::fabs(jt->first-k*azimDelta) > tol)
+                  break;
+               rows.push_back(&(jt->second));
+            }
+            // all rows must be present, with no others in between
+            if(int(rows.size()) != nazim || jt != azzenmap.end()) continue;
+         }
+
+         // fill the values
+         PCVGrid grid;
+         grid.values.reserve(rows.size()*nzen);
+         for(size_t k=0; k<rows.size(); k++) {
+            if(int(rows[k]->size()) != nzen) break;
+            zenOffsetMap::const_iterator kt = rows[k]->begin();
+            for(int i=0; i<nzen; ++i, ++kt) {
+               if(::fabs(kt->first - (zenRange[0]+i*zenRange[2])) > tol) break;
+               grid.values.push_back(kt->second);
+            }
+         }
+         if(grid.values.size() != rows.size()*nzen) continue;
+
+         grid.zen0 = zenRange[0];
+         grid.invdzen = 1.0/zenRange[2];
+         grid.nzen = nzen;
+         grid.nazim = rows.size();
+         grid.invdazim = (antpco.hasAzimuth ? 1.0/azimDelta : 0.0);
+         antpco.PCVgrid = grid;
+      }
+   }
+
    void AntexData::dump(ostream& s, int detail) const
    {
       map<string, antennaPCOandPCVData>::const_iterator it;
@@ -675,6 +785,9 @@ namespace gpstk
             GPSTK_THROW(e);
          }
       }
+
+      // grid the PCVs for fast evaluation
+      compilePCVGrids();
       
    } // end of reallyGetRecord()
 
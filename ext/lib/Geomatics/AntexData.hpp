@@ -165,6 +165,55 @@ namespace gpstk
       /// azimZenMap[-1.0] (this may be the only entry)
       typedef std::map<double, zenOffsetMap> azimZenMap;
 
+      /// PCVs of one frequency on a dense regular (azimuth, zenith) grid, compiled
+      /// from the azimZenMap by compilePCVGrids(). Values are stored row by row,
+      /// one row per azimuth, so that evaluation is a bilinear interpolation with
+      /// no searching: the cell is found from the angles and the grid steps.
+      class PCVGrid {
+      public:
+         /// Constructor; the grid is empty (not valid).
+         PCVGrid() : zen0(0.0), invdzen(0.0), nzen(0), invdazim(0.0), nazim(0) {}
+
+         /// @return true if the grid has been compiled.
+         bool isValid(void) const throw() { return (nzen > 1 && nazim > 0); }
+
+         /// Interpolate the grid; azimuth (degrees) must be in [0,360) and the
+         /// zenith angle (degrees) is clamped to the grid, as in
+         /// getPhaseCenterVariation(). The grid must be valid.
+         /// @return phase center variation in millimeters
+         double evaluate(const double azim, const double zen) const throw()
+         {
+            double z((zen - zen0) * invdzen);
+            if(z < 0.0) z = 0.0;
+            else if(z > nzen-1) z = nzen-1;
+            int iz(static_cast<int>(z));
+            if(iz > nzen-2) iz = nzen-2;
+            z -= iz;
+
+            const double *row(&values[iz]);
+            if(nazim == 1)                   // no azimuth dependence
+               return (row[0] + z*(row[1]-row[0]));
+
+            double a(azim * invdazim);
+            int ia(static_cast<int>(a));
+            if(ia > nazim-2) ia = nazim-2;
+            a -= ia;
+
+            row += ia*nzen;
+            const double lo(row[0] + z*(row[1]-row[0]));
+            row += nzen;
+            const double hi(row[0] + z*(row[1]-row[0]));
+            return (lo + a*(hi-lo));
+         }
+
+         double zen0;      ///< first zenith angle in the grid (degrees)
+         double invdzen;   ///< 1/(zenith step) (1/degrees)
+         int nzen;         ///< number of zenith angles (columns)
+         double invdazim;  ///< 1/(azimuth step) (1/degrees); 0 if no azimuth
+         int nazim;        ///< number of azimuths (rows), 0 to 360; 1 if no azimuth
+         std::vector<double> values;   ///< values[iazim*nzen+izen] in millimeters
+      }; // end of class PCVGrid
+
       /// class encapsulating the PCOs and PCVs of the antenna. See the ANTEX
       /// documentation for discussion of how the PCO/Vs are defined, sign conventions
       /// and how to apply the PCOs.
@@ -188,6 +237,10 @@ namespace gpstk
          /// RMS values are OPTIONAL
          azimZenMap PCVvalue, PCVrms;
 
+         /// PCVvalue on a regular grid; set by compilePCVGrids(), and used by
+         /// getPhaseCenterVariation() when valid.
+         PCVGrid PCVgrid;
+
       }; // end of class antennaPCOandPCVData
 
       // member data
@@ -321,6 +374,32 @@ namespace gpstk
                                      const double elev_nadir) const
          throw(Exception);
 
+      /// Compute the phase center variations at many (azimuth, elev_nadir) pairs
+      /// for one frequency, for example for all the satellites in view at one
+      /// epoch; the frequency is looked up only once.
+      /// NB. see documentation of the class for coordinates, signs and application.
+      /// @param freq frequency (usually G01 or G02)
+      /// @param azimuths azimuth angles in degrees, as in getPhaseCenterVariation()
+      /// @param elev_nadirs elevation or nadir angles in degrees, parallel to
+      ///        azimuths, as in getPhaseCenterVariation()
+      /// @param pcvs output phase center variations in millimeters, parallel to
+      ///        azimuths
+      /// @throw  if this object is invalid
+      ///         if frequency does not exist for this data
+      ///         if the input vectors differ in length, or an angle is invalid
+      void getPhaseCenterVariations(const std::string freq,
+                                    const std::vector<double>& azimuths,
+                                    const std::vector<double>& elev_nadirs,
+                                    std::vector<double>& pcvs) const
+         throw(Exception);
+
+      /// Compile the PCVs of each frequency into a regular grid (PCVGrid), used
+      /// for fast evaluation by getPhaseCenterVariation(). This is done when the
+      /// data is read from a stream; call it again after changing freqPCVmap.
+      /// Frequencies whose PCVs do not lie on the regular grid given by zenRange
+      /// and azimDelta are left without a grid, and are evaluated from the maps.
+      void compilePCVGrids(void) throw();
+
       /// Dump AntexData. Set detail = 0 for type, serial no., sat codes only;
       /// = 1 for all information except phase center offsets, = 2 for all data.
 #pragma clang diagnostic push
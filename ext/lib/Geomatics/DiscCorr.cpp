@@ -49,6 +49,9 @@
 #include <deque>
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <exception>
 // gpstk
 #include "StringUtils.hpp"
 #include "Stats.hpp"
@@ -494,6 +497,22 @@ private:
    /// keep count of various results: slips, deletions, etc.; print to log in finish()
    map<string,int> learn;
 
+public:
+
+   /// obs types of the data arrays; indexes into both data and this vector
+   /// are L1,L2,etc...
+   vector<string> DCobstypes;
+
+   /// unique number of this pass in the log file, and of each (WL,GF) fix
+   int GDCUnique, GDCUniqueFix;
+
+   /// wavelength and other frequency-dependent quantities, determined early
+   /// in DC(); constants used in linear combinations
+   int GLOn;
+   double wl1,wl2,wlwl,wlgf;        // wavelengths: L1,L2,widelane,narrowlane
+   double wl1r,wl2r,wl1p,wl2p;      // coefficients in widelane linear combinations
+   double gf1r,gf2r,gf1p,gf2p;      // coefficients in geometry-free linear combinations
+
 }; // end class GDCPass
 
 //------------------------------------------------------------------------------------
@@ -506,7 +525,6 @@ static const int P1 = 2;
 static const int P2 = 3;
 static const int A1 = 4;
 static const int A2 = 5;
-vector<string> DCobstypes; // indexes into both data and this vector are L1,L2,etc...
 
 //------------------------------------------------------------------------------------
 // Return values (used by all routines within this module):
@@ -519,18 +537,11 @@ static const int Singular=-1;
 static const int ReturnOK=0;
 
 //------------------------------------------------------------------------------------
-// these are used only to associate a unique number in the log file with each pass
-static int GDCUnique=0;     // unique number for each call
-static int GDCUniqueFix;    // unique for each (WL,GF) fix
-static string GDCtag="GDC"; // begin each line of return message
-
-//------------------------------------------------------------------------------------
-// wavelength and other frequency-dependent quantities, determined early in DC()
-// constants used in linear combinations
-int GLOn;
-double wl1,wl2,wlwl,wlgf;        // wavelengths: L1,L2,widelane,narrowlane
-double wl1r,wl2r,wl1p,wl2p;      // coefficients in widelane linear combinations
-double gf1r,gf2r,gf1p,gf2p;      // coefficients in geometry-free linear combinations
+// this is used only to associate a unique number in the log file with each pass;
+// everything else that changes during a call is kept in the GDCPass, so that
+// calls on different passes may run concurrently.
+static std::atomic<int> GDCCount(0);    // number of calls so far
+static const string GDCtag="GDC";       // begin each line of return message
 
 //------------------------------------------------------------------------------------
 // Flags - constants used to mark slips, etc. using the SatPass flag:
@@ -566,28 +577,28 @@ const unsigned short GDCPass::FIX      =  24;  // = WLFIX | GFFIX
 //------------------------------------------------------------------------------------
 // The discontinuity corrector function
 //------------------------------------------------------------------------------------
-// yes you need the gpstk::
-int gpstk::DiscontinuityCorrector(SatPass& svp,
-                                  GDCconfiguration& gdc,
-                                  vector<string>& editCmds,
-                                  string& retMessage,
-                                  int GLOn_in)
+// Correct one pass; this is re-entrant: it does not change gdc or any global,
+// and debug output goes to *plog if plog is not null, else to gdc's debug stream.
+// GDCUnique is the number of this pass in the log and the return message.
+static int GDCorrect(SatPass& svp,
+                     const GDCconfiguration& gdc,
+                     vector<string>& editCmds,
+                     string& retMessage,
+                     int GLOn_in,
+                     int GDCUnique,
+                     ostream *plog)
    throw(Exception)
 {
 try {
    unsigned int i,j;
    int iret;
 
-   if(gdc.getParameter("ResetUnique") != 0)
-      { GDCUnique=0; gdc.setParameter("ResetUnique=0"); }
-   GDCUnique++;
-
    //if(!retMessage.empty()) { GDCtag = retMessage; }
    retMessage = "";
 
    // --------------------------------------------------------------------------------
    // require obstypes L1,L2,C1/P1,C2/P2, and add two auxiliary arrays
-   DCobstypes.clear();
+   vector<string> DCobstypes;
    DCobstypes.push_back("L1");
    DCobstypes.push_back("L2");
    DCobstypes.push_back((int(gdc.getParameter("useCA1"))) == 0 ? "P1" : "C1");
@@ -635,10 +646,17 @@ try {
    // --------------------------------------------------------------------------------
    // create a GDCPass from the input SatPass (modified) and GDC configuration
    GDCPass gp(nsvp,gdc);
+   gp.DCobstypes = DCobstypes;
+   gp.GDCUnique = GDCUnique;
+   if(plog) gp.setDebugStream(*plog);
 
    // --------------------------------------------------------------------------------
    // if the satellite is Glonass, compute the frequency channel, if necessary,
    // and define wavelengths and other constants for this satellite
+   int& GLOn(gp.GLOn);
+   double &wl1(gp.wl1),&wl2(gp.wl2),&wlwl(gp.wlwl),&wlgf(gp.wlgf);
+   double &wl1r(gp.wl1r),&wl2r(gp.wl2r),&wl1p(gp.wl1p),&wl2p(gp.wl2p);
+   double &gf1r(gp.gf1r),&gf2r(gp.gf2r),&gf1p(gp.gf1p),&gf2p(gp.gf2p);
    GLOn = GLOn_in;
    if(sat.system == SatID::systemGlonass) {
 
@@ -750,6 +768,108 @@ catch(std::exception& e) {
 catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+// yes you need the gpstk::
+int gpstk::DiscontinuityCorrector(SatPass& svp,
+                                  GDCconfiguration& gdc,
+                                  vector<string>& editCmds,
+                                  string& retMessage,
+                                  int GLOn_in)
+   throw(Exception)
+{
+try {
+   if(gdc.getParameter("ResetUnique") != 0)
+      { GDCCount=0; gdc.setParameter("ResetUnique=0"); }
+
+   return GDCorrect(svp, gdc, editCmds, retMessage, GLOn_in, ++GDCCount, 0);
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(std::exception& e) {
+   Exception E("std except: "+string(e.what())); GPSTK_THROW(E);
+}
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+void gpstk::DiscontinuityCorrector(vector<SatPass>& SPList,
+                                          GDCconfiguration& gdc,
+                                          vector<int>& iret,
+                                          vector< vector<string> >& editCmds,
+                                          vector<string>& retMessages,
+                                          vector<string>& logs,
+                                          const vector<int>& GLOn_in,
+                                          int numThreads)
+   throw(Exception)
+{
+try {
+   size_t i;
+   const size_t N(SPList.size());
+
+   editCmds.assign(N, vector<string>());
+   retMessages.assign(N, string());
+   logs.assign(N, string());
+   iret.assign(N, 0);
+   if(N == 0) return;
+
+   // number the passes here, in order, as N serial calls would
+   if(gdc.getParameter("ResetUnique") != 0)
+      { GDCCount=0; gdc.setParameter("ResetUnique=0"); }
+   const int first(GDCCount.fetch_add(static_cast<int>(N)) + 1);
+
+   if(numThreads < 1)
+      numThreads = std::thread::hardware_concurrency();
+   if(static_cast<size_t>(numThreads) > N)
+      numThreads = static_cast<int>(N);
+
+   // Each thread takes the next pass nobody has taken, and writes only to that
+   // pass' outputs; gdc is only read, so no locking is needed. Passes differ
+   // a lot in length, so they are handed out one at a time.
+   vector<std::exception_ptr> errors(N);
+   std::atomic<size_t> next(0);
+   const GDCconfiguration& config(gdc);
+   auto work = [&]()
+   {
+      size_t j;
+      while((j = next++) < N) {
+         ostringstream oss;
+         try {
+            iret[j] = GDCorrect(SPList[j], config, editCmds[j], retMessages[j],
+                                (j < GLOn_in.size() ? GLOn_in[j] : -99),
+                                first + static_cast<int>(j), &oss);
+         }
+         catch(...) { errors[j] = std::current_exception(); }
+         logs[j] = oss.str();
+      }
+   };
+
+   vector<std::thread> workers;
+   for(int t=1; t<numThreads; t++) {
+      try { workers.push_back(std::thread(work)); }
+      catch(std::exception&) { break; }     // go on with fewer threads
+   }
+   work();
+   for(i=0; i<workers.size(); i++)
+      workers[i].join();
+
+   // report the error of the first failing pass, as a serial loop would;
+   // drop the results of the passes it would not have reached
+   for(i=0; i<N; i++) {
+      if(errors[i]) {
+         iret.resize(i+1);
+         editCmds.resize(i+1);
+         retMessages.resize(i+1);
+         logs.resize(i+1);
+         std::rethrow_exception(errors[i]);
+      }
+   }
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(std::exception& e) {
+   Exception E("std except: "+string(e.what())); GPSTK_THROW(E);
+}
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 // class GDCPass member functions
@@ -81,18 +81,21 @@ namespace gpstk {
       void setParameter(std::string label, double value) throw(gpstk::Exception);
 
          /// Get the parameter in the configuration corresponding to label
-      double getParameter(std::string label) throw()
+      double getParameter(std::string label) const throw()
       {
-         if(CFG.find(label) == CFG.end()) return 0.0;    // TD throw?
-         return CFG[label];
+         std::map<std::string,double>::const_iterator it(CFG.find(label));
+         if(it == CFG.end()) return 0.0;    // TD throw?
+         return it->second;
       }
 
          /// Get the description of a parameter
-      std::string getDescription(std::string label) throw()
+      std::string getDescription(std::string label) const throw()
       {
-         if(CFGdescription.find(label) == CFGdescription.end())
+         std::map<std::string,std::string>::const_iterator
+            it(CFGdescription.find(label));
+         if(it == CFGdescription.end())
             return std::string("Invalid label");
-         return CFGdescription[label];
+         return it->second;
       }
 
          /// Tell GDCconfiguration to which stream to send debugging output.
@@ -265,6 +268,38 @@ namespace gpstk {
                               int GLOn=-99)
       throw(Exception);
 
+   /// GPSTK Discontinuity Corrector for a list of satellite passes, which are
+   /// processed concurrently on a pool of threads. The result for each pass is
+   /// the same as calling DiscontinuityCorrector(SP,config,EditCmds,retMsg,GLOn)
+   /// on the passes in order: passes are numbered in the log and messages
+   /// as they would be by such calls, and the debug output that each pass
+   /// would have written to the config's debug stream is returned in
+   /// logs[i] instead, so the caller can print it, in order, with the rest.
+   /// If a pass throws, the exception of the first such pass is rethrown, and
+   /// the outputs are cut to end with that pass, as if the calls had stopped
+   /// there: the caller can print the results of the passes before it, and
+   /// the log of the failed pass, then handle the exception.
+   ///
+   /// @param SPList   vector of SatPass objects containing the input data.
+   /// @param config   GDCconfiguration object; it is not changed by the threads.
+   /// @param retCodes (output) retCodes[i] is the return code of SPList[i] (see
+   ///                   above); if a pass threw, the last entry is meaningless
+   /// @param EditCmds (output) EditCmds[i] are the RinexEditor commands of SPList[i]
+   /// @param retMsgs  (output) retMsgs[i] is the summary of results of SPList[i]
+   /// @param logs     (output) logs[i] is the debug output for SPList[i]
+   /// @param GLOn     GLONASS frequency channels, parallel to SPList; if shorter,
+   ///                   missing entries are UNKNOWN (-99)
+   /// @param numThreads number of threads to use; 0 means one per processor
+   void DiscontinuityCorrector(std::vector<SatPass>& SPList,
+                              GDCconfiguration& config,
+                              std::vector<int>& retCodes,
+                              std::vector< std::vector<std::string> >& EditCmds,
+                              std::vector<std::string>& retMsgs,
+                              std::vector<std::string>& logs,
+                              const std::vector<int>& GLOn=std::vector<int>(),
+                              int numThreads=0)
+      throw(Exception);
+
    //@}
 
 }  // end namespace gpstk
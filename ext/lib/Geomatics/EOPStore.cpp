@@ -39,6 +39,7 @@
 
 //------------------------------------------------------------------------------------
 #include "EOPStore.hpp"
+#include "ProductCache.hpp"
 //#include "logstream.hpp"
 
 //------------------------------------------------------------------------------------
@@ -149,6 +150,16 @@ namespace gpstk
          GPSTK_THROW(fme);
       }
 
+      // a file loaded before may be in the product cache
+      vector<int> mjds;
+      vector<EarthOrientation> eops;
+      if(readCachedIERS(filename, mjds, eops)) {
+         for(size_t i=0; i<mjds.size(); i++)
+            addEOP(mjds[i], eops[i]);
+         return;
+      }
+      bool saveEOPs(ProductCache::isEnabled());
+
       ok = true;
       while(!inpf.eof() && inpf.good()) {
          getline(inpf,line);
@@ -168,6 +179,7 @@ namespace gpstk
          //eo.UT1mUTC = StringUtils::asDouble(line.substr(154,11));  // seconds
 
          addEOP(mjd,eo);
+         if(saveEOPs) { mjds.push_back(mjd); eops.push_back(eo); }
       };
       inpf.close();
 
@@ -176,6 +188,69 @@ namespace gpstk
                                    + " is corrupted or wrong format");
          GPSTK_THROW(fme);
       }
+
+      if(saveEOPs) saveCachedIERS(filename, mjds, eops);
+   }
+
+   //---------------------------------------------------------------------------------
+   // Read the EOPs of the product cache entry of an IERS file, if there is a
+   // matching entry. Return false if the file must be parsed.
+   bool EOPStore::readCachedIERS(const string& filename,
+                                 vector<int>& mjds,
+                                 vector<EarthOrientation>& eops)
+      throw()
+   {
+      try {
+         ProductCache cache;
+         if(!cache.openEntry(filename, "iers")) return false;
+
+         size_t n = cache.getCount(4+3*8);
+         mjds.resize(n);
+         eops.resize(n);
+         for(size_t i=0; i<n && cache.good(); i++) {
+            int32_t mjd(0);
+            cache.getData(mjd);
+            mjds[i] = mjd;
+            cache.getData(eops[i].xp);
+            cache.getData(eops[i].yp);
+            cache.getData(eops[i].UT1mUTC);
+         }
+
+         if(cache.good()) return true;
+      }
+      catch(...) { }
+
+      // a bad entry is ignored, and the file parsed
+      mjds.clear();
+      eops.clear();
+      return false;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Write the EOPs read from an IERS file to the product cache.
+   // Errors are ignored.
+   void EOPStore::saveCachedIERS(const string& filename,
+                                 const vector<int>& mjds,
+                                 const vector<EarthOrientation>& eops)
+      throw()
+   {
+      try {
+         ProductCache cache;
+         if(!cache.createEntry(filename, "iers")) return;
+
+         cache.writeCount(mjds.size());
+         for(size_t i=0; i<mjds.size(); i++) {
+            cache.writeData(static_cast<int32_t>(mjds[i]));
+            cache.writeData(eops[i].xp);
+            cache.writeData(eops[i].yp);
+            cache.writeData(eops[i].UT1mUTC);
+         }
+
+         cache.commitEntry();
+      }
+      catch(...) {
+         // the entry is discarded by the ProductCache destructor
+      }
    }
 
    //---------------------------------------------------------------------------------
@@ -46,6 +46,7 @@
 #include <iomanip>
 #include <string>
 #include <map>
+#include <vector>
 // GPSTk
 #include "Exception.hpp"
 #include "IERSConvention.hpp"
@@ -66,6 +67,21 @@ namespace gpstk {
 
       /// first and last times in the store, -1 if store is empty.
       int begMJD,endMJD;
+
+      /// Read the EOPs of the product cache entry of an IERS file, if there
+      /// is a matching entry (see ProductCache).
+      /// @return true if the EOPs were read, false if the file must be parsed.
+      static bool readCachedIERS(const std::string& filename,
+                                 std::vector<int>& mjds,
+                                 std::vector<EarthOrientation>& eops)
+         throw();
+
+      /// Write the EOPs read from an IERS file to the product cache.
+      /// Errors are ignored.
+      static void saveCachedIERS(const std::string& filename,
+                                 const std::vector<int>& mjds,
+                                 const std::vector<EarthOrientation>& eops)
+         throw();
    
    public:
       /// Constructor
@@ -99,6 +115,8 @@ namespace gpstk {
          throw(FileMissingException);
 
       /// Add EOPs to the store via a flat IERS file; e.g. finals2000A.data from USNO.
+      /// If the product cache is enabled (see ProductCache), the EOPs of a file
+      /// loaded by an earlier run are read from the cache instead of parsed.
       /// @param filename Name of file to read, including path.
       /// @throw if file is not found.
       void addIERSFile(const std::string& filename)
@@ -1597,6 +1597,19 @@ namespace gpstk
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
 
+   //------------------------------------------------------------------------------
+   // Transformation (3x3 rotation) from the GCRS to the Celestial Intermediate
+   // Reference System (CIRS), given the coordinates X,Y of the CIP and the
+   // CIO locator s. cf. sofa c2ixys
+   Matrix<double> EarthOrientation::GCRStoCIRS(double X, double Y, double s)
+      throw()
+   {
+      double r2(X*X+Y*Y);                          // squared radius
+      double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
+      double d(::atan(::sqrt(r2/(1.0-r2))));       //
+      return (rotation(-(e+s),3) * rotation(d, 2) * rotation(e, 3));
+   }
+
    //------------------------------------------------------------------------------
    // Equation of the equinoxes complementary terms, IAU 2000 (IERS 2003)
    // Note that GAST = GMST + EquationOfEquinoxes2003
@@ -2763,14 +2776,9 @@ namespace gpstk
          LOG(DEBUG7) << "s\" = " << fixed << setprecision(15) << s/ARCSEC_TO_RAD;
 
          // compute transformation GCRS-to-CIRS or inertial-to-intermediate-celestial
-         // cf. sofa c2ixys
-         double r2(X*X+Y*Y);                          // squared radius
-         double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
-         double d(::atan(::sqrt(r2/(1.0-r2))));       //
-         Matrix<double> GCRStoCIRS;
-         GCRStoCIRS = rotation(-(e+s),3) * rotation(d, 2) * rotation(e, 3);
+         Matrix<double> C2I(GCRStoCIRS(X,Y,s));
          LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
-               << showpos << GCRStoCIRS;
+               << showpos << C2I;
 
          // note that we could have called PreciseEarthRotation2010() instead
 
@@ -2784,7 +2792,7 @@ namespace gpstk
          CIRStoTIRS = rotation(era, 3);
          LOG(DEBUG7) << "\ncelestial-to-terrestrial matrix (no polar motion):\n"
                << fixed << setprecision(15) << setw(18) << showpos
-               << CIRStoTIRS * GCRStoCIRS;
+               << CIRStoTIRS * C2I;
 
          // compute the polar motion matrix, TIRS-to-ITRS
          //double sprime(Sprime(T));
@@ -2794,7 +2802,7 @@ namespace gpstk
 
          // combine to get GCRS-to-ITRS
          Matrix<double> GCRStoITRS;
-         GCRStoITRS = PolarMotion * CIRStoTIRS * GCRStoCIRS;
+         GCRStoITRS = PolarMotion * CIRStoTIRS * C2I;
 
          // invert to get ITRS-to-GCRS or ECEFtoInertial
          return (transpose(GCRStoITRS));
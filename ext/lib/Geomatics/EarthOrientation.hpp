@@ -384,6 +384,9 @@ namespace gpstk {
          throw(Exception);
 
    private:
+      /// EarthRotationCache tabulates the series computed by the private functions
+      friend class EarthRotationCache;
+
       //------------------------------------------------------------------------------
       /// locator s which gives the position of the CIO on the equator of
       /// the CIP, given the coordinate transformation time T and the coordinates X,Y
@@ -426,6 +429,16 @@ namespace gpstk {
          throw();
 
       //------------------------------------------------------------------------------
+      /// Transformation (3x3 rotation) from the GCRS to the Celestial Intermediate
+      /// Reference System (CIRS), given the coordinates X,Y of the CIP and the
+      /// CIO locator s. cf. sofa c2ixys
+      /// @param X, x coordinate of the CIP
+      /// @param Y, y coordinate of the CIP
+      /// @param s, the CIO locator s in radians
+      /// @return Matrix<double>(3,3) rotation matrix GCRS -> CIRS
+      static Matrix<double> GCRStoCIRS(double X, double Y, double s)
+         throw();
+      //------------------------------------------------------------------------------
       /// Starting with 2003 conventions a new method for computing the transformation
       /// fron ITRS to GCRS is provided by the Celestial Ephemeris Origin (CEO) which
       /// is based on the Earth Rotation Angle, which depends on time(UT1).
@@ -0,0 +1,412 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/// @file EarthRotationCache.cpp
+/// class EarthRotationCache tabulates the precession-nutation quantities computed
+/// by class EarthOrientation on a grid of times, and interpolates them to provide
+/// fast terrestrial <=> inertial frame transformations at many epochs.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <cmath>
+// GPSTk
+#include "MiscMath.hpp"
+
+#include "EarthRotationCache.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   // Largest number of grid points computed to join a query to the grid
+   const long EarthRotationCache::maxGap = 512;
+
+   // smallest grid spacing in days, reached by halving the step
+   static const double minStep = 1.0/1440.0;
+
+   // days per century, CoordTransTime is in centuries
+   static const double daysPerCentury = 36525.0;
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache::EarthRotationCache(IERSConvention conv, double st, double tol)
+      throw(Exception)
+         : convention(IERSConvention::NONE), step(st), tolerance(tol),
+           maxError(0.0), numEvaluations(0), nv(0), kfirst(0)
+   {
+      if(step <= 0.0 || tolerance <= 0.0) {
+         Exception e("Step and tolerance must be positive");
+         GPSTK_THROW(e);
+      }
+      try { setConvention(conv); }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache::EarthRotationCache(const EarthRotationCache& right) throw()
+   {
+      std::lock_guard<std::mutex> lock(right.gridMutex);
+      convention = right.convention;
+      step = right.step;
+      tolerance = right.tolerance;
+      maxError = right.maxError;
+      numEvaluations = right.numEvaluations;
+      nv = right.nv;
+      kfirst = right.kfirst;
+      nodes = right.nodes;
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthRotationCache& EarthRotationCache::operator=(const EarthRotationCache& right)
+      throw()
+   {
+      if(this == &right) return *this;
+
+      std::lock(gridMutex, right.gridMutex);
+      std::lock_guard<std::mutex> lock(gridMutex, std::adopt_lock);
+      std::lock_guard<std::mutex> rlock(right.gridMutex, std::adopt_lock);
+      convention = right.convention;
+      step = right.step;
+      tolerance = right.tolerance;
+      maxError = right.maxError;
+      numEvaluations = right.numEvaluations;
+      nv = right.nv;
+      kfirst = right.kfirst;
+      nodes = right.nodes;
+      return *this;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::setConvention(const IERSConvention& conv)
+      throw(Exception)
+   {
+      std::lock_guard<std::mutex> lock(gridMutex);
+      if(conv == IERSConvention::IERS1996 || conv == IERSConvention::IERS2003)
+         nv = 10;
+      else if(conv == IERSConvention::IERS2010)
+         nv = 3;
+      else {
+         Exception e("IERS convention is not defined");
+         GPSTK_THROW(e);
+      }
+      convention = conv;
+      maxError = 0.0;
+      clearNodes();
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::clear(void) throw()
+   {
+      std::lock_guard<std::mutex> lock(gridMutex);
+      clearNodes();
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::XYS(const EphTime& t, double& X, double& Y, double& s)
+      throw(Exception)
+   {
+      try {
+         double v[NVMAX];
+         IERSConvention conv(interpolate(EarthOrientation::CoordTransTime(t), v));
+         if(conv == IERSConvention::IERS2010) {
+            X = v[0]; Y = v[1]; s = v[2];
+         }
+         else if(conv == IERSConvention::IERS2003) {
+            X = v[6]; Y = v[7]; s = v[9];       // X,Y are NPB(2,0),NPB(2,1)
+         }
+         else {
+            Exception e("X,Y,s are not available for IERS1996");
+            GPSTK_THROW(e);
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   Matrix<double> EarthRotationCache::PrecessionNutationMatrix(const EphTime& t)
+      throw(Exception)
+   {
+      try {
+         double v[NVMAX];
+         IERSConvention conv(interpolate(EarthOrientation::CoordTransTime(t), v));
+         return NPBMatrix(conv, v);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // Same as EarthOrientation::ECEFtoInertial1996,2003,2010 except for the
+   // precession-nutation part, which is interpolated.
+   Matrix<double> EarthRotationCache::ECEFtoInertial(const EphTime& t,
+                                                     const EarthOrientation& eo,
+                                                     bool reduced)
+      throw(Exception)
+   {
+      try {
+         double v[NVMAX];
+         double T(EarthOrientation::CoordTransTime(t));
+         IERSConvention conv(interpolate(T, v));
+
+         Matrix<double> NPB(NPBMatrix(conv, v)), R, W;
+         double UT1mUTC(eo.UT1mUTC);
+
+         if(conv == IERSConvention::IERS1996) {
+            // if reduced (NGA), correct UT1mUTC for tides
+            if(reduced) {
+               double UT1mUT1R,dlodR,domegaR;
+               EarthOrientation::UT1mUTCTidalCorrections(T,UT1mUT1R,dlodR,domegaR);
+               UT1mUTC = UT1mUT1R - UT1mUTC;
+            }
+            // GAST = GMST + equation of the equinoxes
+            double g(EarthOrientation::GMST1996(t, UT1mUTC, false) + v[9]);
+            R = rotation(g,3);
+            W = EarthOrientation::PolarMotionMatrix1996(eo.xp, eo.yp);
+         }
+         else {
+            // ERA replaces GAST in the Earth rotation matrix
+            R = rotation(EarthOrientation::EarthRotationAngle(t,UT1mUTC),3);
+            W = EarthOrientation::PolarMotionMatrix2003(t, eo.xp, eo.yp);
+         }
+
+         return transpose(W*R*NPB);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::ECEFtoInertial(const vector<EphTime>& t,
+                                           const vector<EarthOrientation>& eo,
+                                           vector< Matrix<double> >& R,
+                                           bool reduced)
+      throw(Exception)
+   {
+      if(eo.size() != t.size() && eo.size() != 1) {
+         Exception e("Number of EOPs does not match number of epochs");
+         GPSTK_THROW(e);
+      }
+
+      try {
+         R.resize(t.size());
+         for(size_t i=0; i<t.size(); i++)
+            R[i] = ECEFtoInertial(t[i], eo[eo.size() == 1 ? 0 : i], reduced);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // private functions
+   //---------------------------------------------------------------------------------
+   // Compute the tabulated values at T with the exact series; cf.
+   // EarthOrientation::ECEFtoInertial1996,2003,2010.
+   void EarthRotationCache::evaluate(double T, double *v) throw()
+   {
+      ++numEvaluations;
+
+      if(convention == IERSConvention::IERS2010) {
+         double X,Y;
+         EarthOrientation::XYCIO(T, X, Y);
+         v[0] = X;
+         v[1] = Y;
+         v[2] = EarthOrientation::S(T,X,Y,IERSConvention::IERS2010);
+         return;
+      }
+
+      Matrix<double> NPB;
+      double deps,dpsi;
+      if(convention == IERSConvention::IERS1996) {
+         double om, eps(EarthOrientation::Obliquity1996(T));
+         EarthOrientation::NutationAngles1996(T,deps,dpsi,om);
+         NPB = EarthOrientation::NutationMatrix(eps,dpsi,deps)
+               * EarthOrientation::PrecessionMatrix1996(T);
+         // equation of the equinoxes, cf. EarthOrientation::gast1996()
+         v[9] = dpsi * ::cos(eps) + (0.00264 * ::sin(om) + 0.000063 * ::sin(2.0*om))
+                                    * EarthOrientation::ARCSEC_TO_RAD;
+      }
+      else {
+         double dpsipr,depspr;
+         EarthOrientation::NutationAngles2003(T,deps,dpsi);
+         EarthOrientation::PrecessionRateCorrections2003(T, dpsipr, depspr);
+         double eps(EarthOrientation::Obliquity1996(T) + depspr);
+         NPB = EarthOrientation::NutationMatrix(eps,dpsi,deps)
+               * EarthOrientation::PrecessionMatrix2003(T);
+         double X(NPB(2,0)), Y(NPB(2,1));
+         v[9] = EarthOrientation::S(T,X,Y,IERSConvention::IERS2003);
+      }
+
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            v[3*i+j] = NPB(i,j);
+   }
+
+   //---------------------------------------------------------------------------------
+   IERSConvention EarthRotationCache::interpolate(double T, double *v)
+      throw(Exception)
+   {
+      std::lock_guard<std::mutex> lock(gridMutex);
+      if(nv == 0) {
+         Exception e("IERS convention is not defined");
+         GPSTK_THROW(e);
+      }
+
+      while(1) {
+         double u(T*daysPerCentury/step);
+         long k(long(::floor(u)));
+         if(!extend(k-3, k+4))               // step was reduced, start again
+            continue;
+         lagrange(k, u-double(k), v);
+         return convention;
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthRotationCache::clearNodes(void) throw()
+   {
+      nodes.clear();
+      kfirst = 0;
+   }
+
+   //---------------------------------------------------------------------------------
+   bool EarthRotationCache::extend(long k0, long k1) throw()
+   {
+      long klast(kfirst + long(nodes.size()/nv) - 1);
+      double v[NVMAX];
+      int i;
+      long k;
+
+      // intervals [lo,hi] that have a full stencil for the first time
+      long lo[2] = { 0, 0 }, hi[2] = { -1, -1 };
+
+      // start again if the grid is empty or far from [k0,k1]
+      if(nodes.empty() || k1 < kfirst-maxGap || k0 > klast+maxGap) {
+         clearNodes();
+         kfirst = k0;
+         for(k=k0; k<=k1; k++) {
+            evaluate(double(k)*step/daysPerCentury, v);
+            for(i=0; i<nv; i++) nodes.push_back(v[i]);
+         }
+         lo[0] = k0+3;
+         hi[0] = k1-4;
+         // always check the first interval of a new grid
+         if((lo[0] & 7) != 0 && !check(lo[0]))
+            return false;
+      }
+      else {
+         if(k0 < kfirst) {
+            for(k=kfirst-1; k>=k0; k--) {
+               evaluate(double(k)*step/daysPerCentury, v);
+               for(i=nv-1; i>=0; i--) nodes.push_front(v[i]);
+            }
+            lo[0] = k0+3;
+            hi[0] = std::min(kfirst+2, klast-4);
+            kfirst = k0;
+         }
+         if(k1 > klast) {
+            for(k=klast+1; k<=k1; k++) {
+               evaluate(double(k)*step/daysPerCentury, v);
+               for(i=0; i<nv; i++) nodes.push_back(v[i]);
+            }
+            lo[1] = std::max(klast-3, kfirst+3);
+            hi[1] = k1-4;
+         }
+      }
+
+      // check one interval in 8
+      for(i=0; i<2; i++) {
+         for(k=lo[i]; k<=hi[i]; k++) {
+            if((k & 7) == 0 && !check(k))
+               return false;
+         }
+      }
+
+      return true;
+   }
+
+   //---------------------------------------------------------------------------------
+   bool EarthRotationCache::check(long k) throw()
+   {
+      double exact[NVMAX], interp[NVMAX], err(0.0);
+      evaluate((double(k)+0.5)*step/daysPerCentury, exact);
+      lagrange(k, 0.5, interp);
+      for(int i=0; i<nv; i++)
+         err = std::max(err, ::fabs(exact[i]-interp[i]));
+
+      if(err > tolerance && step/2.0 >= minStep) {
+         step /= 2.0;
+         maxError = 0.0;
+         clearNodes();
+         return false;
+      }
+
+      if(err > maxError) maxError = err;
+      return true;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Lagrange interpolation with the 8 grid points k-3 through k+4, at fraction p
+   // of interval k.
+   void EarthRotationCache::lagrange(long k, double p, double *v) const throw()
+   {
+      int i,j;
+      double w[8];
+      for(j=0; j<8; j++) {
+         w[j] = 1.0;
+         for(i=0; i<8; i++) if(i != j)
+            w[j] *= (p - double(i-3)) / double(j-i);
+      }
+
+      size_t base((k-3-kfirst)*nv);
+      for(i=0; i<nv; i++) {
+         v[i] = 0.0;
+         for(j=0; j<8; j++)
+            v[i] += w[j] * nodes[base + j*nv + i];
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   Matrix<double> EarthRotationCache::NPBMatrix(const IERSConvention& conv,
+                                                const double *v) throw()
+   {
+      if(conv == IERSConvention::IERS2010)
+         return EarthOrientation::GCRStoCIRS(v[0], v[1], v[2]);
+
+      Matrix<double> NPB(3,3);
+      for(int i=0; i<3; i++)
+         for(int j=0; j<3; j++)
+            NPB(i,j) = v[3*i+j];
+      return NPB;
+   }
+
+}  // end namespace gpstk
@@ -0,0 +1,244 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/// @file EarthRotationCache.hpp
+/// class EarthRotationCache tabulates the precession-nutation quantities computed
+/// by class EarthOrientation on a grid of times, and interpolates them to provide
+/// fast terrestrial <=> inertial frame transformations at many epochs.
+
+#ifndef CLASS_EARTHROTATIONCACHE_INCLUDE
+#define CLASS_EARTHROTATIONCACHE_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <vector>
+#include <deque>
+#include <mutex>
+// GPSTk
+#include "Exception.hpp"
+#include "Matrix.hpp"
+// geomatics
+#include "EphTime.hpp"
+#include "IERSConvention.hpp"
+#include "EarthOrientation.hpp"
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class EarthRotationCache is a cache of the precession-nutation part of the
+   /// transformation between the terrestrial (ECEF) and the inertial frames, which
+   /// is the expensive part of EarthOrientation::ECEFtoInertial() since it sums
+   /// the long nutation (IERS1996, IERS2003) or CIP (IERS2010) series.
+   ///
+   /// The quantities that depend only on TT and not on the EOPs are evaluated once
+   /// on a grid of times with the functions of class EarthOrientation, then
+   /// interpolated with an 8-point Lagrange interpolator; they are
+   ///    IERS1996: the NPB matrix and the equation of the equinoxes,
+   ///    IERS2003: the NPB matrix and the CIO locator s,
+   ///    IERS2010: the CIP coordinates X,Y and the CIO locator s.
+   /// The Earth rotation angle (or GMST) and the polar motion matrix, which depend
+   /// on the EOPs, are computed exactly at each call, just as EarthOrientation does.
+   ///
+   /// Grid points are computed on demand, covering the span of the queries; a query
+   /// far away from the current span (more than maxGap grid points) restarts the
+   /// grid. The interpolation error is bounded: in the first interval of a new grid
+   /// and in every 8th interval, the interpolated values at the middle of the
+   /// interval are compared to the exact values and, if the difference exceeds the
+   /// tolerance, the step is halved and the grid is rebuilt. The largest difference
+   /// found is reported by getMaxError(). With the default step of 0.5 day the
+   /// error is below 1.e-13 radians for all the conventions.
+   ///
+   /// @code
+   /// EarthRotationCache cache(IERSConvention::IERS2010);
+   /// EarthOrientation eo = eopstore.getEOP(mjd, IERSConvention::IERS2010);
+   /// Matrix<double> R = cache.ECEFtoInertial(ttag, eo);
+   /// // same as eo.ECEFtoInertial(ttag), to within cache.getMaxError()
+   /// @endcode
+   ///
+   /// Queries extend the grid, and may halve the step, even though they look like
+   /// pure functions of time; the grid is guarded by a mutex so that one object
+   /// may be shared between threads. Queries that extend the grid are serialized,
+   /// so for heavy use from many threads a separate object for each thread is
+   /// faster.
+   class EarthRotationCache
+   {
+   public:
+      /// Constructor
+      /// @param conv the IERS convention to be used.
+      /// @param step spacing of the grid in days.
+      /// @param tol tolerance on the interpolation error, in radians.
+      EarthRotationCache(IERSConvention conv=IERSConvention::IERS2010,
+                         double step=0.5, double tol=1.e-12)
+         throw(Exception);
+
+      /// Copy constructor; the copy has its own mutex.
+      EarthRotationCache(const EarthRotationCache& right) throw();
+
+      /// Assignment; the mutex is not copied.
+      EarthRotationCache& operator=(const EarthRotationCache& right) throw();
+
+      /// Change the IERS convention; this clears the cache.
+      /// @throw if the convention is not defined
+      void setConvention(const IERSConvention& conv) throw(Exception);
+
+      /// get the IERS convention
+      IERSConvention getConvention(void) const throw()
+         { std::lock_guard<std::mutex> lock(gridMutex); return convention; }
+
+      /// get the current grid spacing in days; this may be smaller than the value
+      /// given to the constructor if the tolerance was not met.
+      double getStep(void) const throw()
+         { std::lock_guard<std::mutex> lock(gridMutex); return step; }
+
+      /// get the tolerance on the interpolation error, in radians
+      double getTolerance(void) const throw()
+         { return tolerance; }
+
+      /// get the largest interpolation error found so far, in radians
+      double getMaxError(void) const throw()
+         { std::lock_guard<std::mutex> lock(gridMutex); return maxError; }
+
+      /// get the number of exact evaluations of the series done so far, including
+      /// those used to check the interpolation error
+      unsigned long getNumEvaluations(void) const throw()
+         { std::lock_guard<std::mutex> lock(gridMutex); return numEvaluations; }
+
+      /// get the number of grid points currently stored
+      size_t size(void) const throw()
+         { std::lock_guard<std::mutex> lock(gridMutex); return nodes.size()/nv; }
+
+      /// remove all grid points, keeping the current step
+      void clear(void) throw();
+
+      /// Coordinates X,Y of the CIP and the CIO locator s, in radians, at the given
+      /// time. Valid for IERS2003 and IERS2010.
+      /// @param t EphTime time of interest.
+      /// @param X, x coordinate of the CIP (output)
+      /// @param Y, y coordinate of the CIP (output)
+      /// @param s, CIO locator s (output)
+      /// @throw if the convention is IERS1996 or TimeSystem conversion fails
+      void XYS(const EphTime& t, double& X, double& Y, double& s)
+         throw(Exception);
+
+      /// Precession-nutation-bias matrix (3x3 rotation) at the given time, from the
+      /// inertial frame to the true-of-date (IERS1996, IERS2003) or the celestial
+      /// intermediate (IERS2010) frame.
+      /// @param t EphTime time of interest.
+      /// @throw if the TimeSystem conversion fails
+      Matrix<double> PrecessionNutationMatrix(const EphTime& t)
+         throw(Exception);
+
+      /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
+      /// frame to the conventional inertial frame, using the EOPs in eo; cf.
+      /// EarthOrientation::ECEFtoInertial(). The convention of eo is not used.
+      /// @param t EphTime epoch of the rotation.
+      /// @param eo EarthOrientation holding the EOPs at t.
+      /// @param reduced, bool true when UT1mUTC is 'reduced', meaning assumes
+      ///                 'no tides', as is the case with the NGA EOPs (default=F).
+      ///                 Used for IERS1996 only, like EarthOrientation does.
+      /// @return 3x3 rotation matrix
+      /// @throw if the TimeSystem conversion fails
+      Matrix<double> ECEFtoInertial(const EphTime& t, const EarthOrientation& eo,
+                                    bool reduced=false)
+         throw(Exception);
+
+      /// Batch version of ECEFtoInertial(), for many epochs. The times need not be
+      /// sorted, but queries in time order make the best use of the cache.
+      /// @param t vector of epochs
+      /// @param eo vector of EOPs, parallel to t, or of length 1 to use the same
+      ///           EOPs at all the epochs
+      /// @param R vector of rotation matrices (output), parallel to t
+      /// @param reduced cf. ECEFtoInertial()
+      /// @throw if the lengths of t and eo do not match
+      void ECEFtoInertial(const std::vector<EphTime>& t,
+                          const std::vector<EarthOrientation>& eo,
+                          std::vector< Matrix<double> >& R,
+                          bool reduced=false)
+         throw(Exception);
+
+      /// Largest number of grid points to compute to join a query to the current
+      /// span of the grid; beyond that the grid is restarted.
+      static const long maxGap;
+
+   private:
+      /// number of values stored per grid point
+      static const int NVMAX = 10;
+
+      /// Compute the tabulated values at T (CoordTransTime) with the exact series.
+      void evaluate(double T, double *v) throw();
+
+      /// Interpolate the tabulated values at T (CoordTransTime), locking the
+      /// grid. Return the convention of the values, which the caller must use
+      /// rather than the member in case another thread changes it.
+      IERSConvention interpolate(double T, double *v) throw(Exception);
+
+      /// Remove all grid points; the caller must hold gridMutex.
+      void clearNodes(void) throw();
+
+      /// Make sure grid points k0 through k1 are available. Return false if the
+      /// step was reduced because the tolerance was not met.
+      bool extend(long k0, long k1) throw();
+
+      /// Compare interpolated and exact values in the middle of interval k, which
+      /// must be covered by the grid. Return false if the tolerance is not met.
+      bool check(long k) throw();
+
+      /// Lagrange interpolation at fraction p of interval k
+      void lagrange(long k, double p, double *v) const throw();
+
+      /// Build the NPB matrix from the values tabulated for convention conv
+      static Matrix<double> NPBMatrix(const IERSConvention& conv, const double *v)
+         throw();
+
+      IERSConvention convention; ///< IERS convention of the tabulated values
+      double step;               ///< grid spacing in days
+      double tolerance;          ///< tolerance on the interpolation error (rad)
+      double maxError;           ///< largest interpolation error found (rad)
+      unsigned long numEvaluations;    ///< number of exact evaluations
+      int nv;                    ///< number of values used per grid point
+
+      long kfirst;               ///< index of first grid point, at time kfirst*step
+      std::deque<double> nodes;  ///< nv values per grid point, from kfirst on
+
+      /// guards all the members above; the private functions other than
+      /// interpolate() expect the caller to hold it
+      mutable std::mutex gridMutex;
+
+   }; // end class EarthRotationCache
+
+}  // end namespace gpstk
+
+#endif // CLASS_EARTHROTATIONCACHE_INCLUDE
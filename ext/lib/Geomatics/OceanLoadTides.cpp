@@ -61,6 +61,181 @@ namespace gpstk {
    // Number of derived tides computed by deriveTides()
    const int OceanLoadTides::NDER=342;
 
+   // Indexes in DerInd of the std tides, used by deriveTides()
+   // std tides: M2, S2, N2, K2, K1,  O1,  P1,  Q1,  Mf,  Mm, Ssa
+   const int OceanLoadTides::stdindex[] = {
+      0,  1,  2,  3,109, 110, 111, 112, 263, 264, 265 };
+
+   // Amplitudes of the derived tides, used by deriveTides()
+   const double OceanLoadTides::DerAmp[] = {
+       .632208, .294107, .121046, .079915, .023818,-.023589, .022994,
+       .019333,-.017871, .017192, .016018, .004671,-.004662,-.004519,
+       .004470, .004467, .002589,-.002455,-.002172, .001972, .001947,
+       .001914,-.001898, .001802, .001304, .001170, .001130, .001061,
+      -.001022,-.001017, .001014, .000901,-.000857, .000855, .000855,
+       .000772, .000741, .000741,-.000721, .000698, .000658, .000654,
+      -.000653, .000633, .000626,-.000598, .000590, .000544, .000479,
+      -.000464, .000413,-.000390, .000373, .000366, .000366,-.000360,
+      -.000355, .000354, .000329, .000328, .000319, .000302, .000279,
+      -.000274,-.000272, .000248,-.000225, .000224,-.000223,-.000216,
+       .000211, .000209, .000194, .000185,-.000174,-.000171, .000159,
+       .000131, .000127, .000120, .000118, .000117, .000108, .000107,
+       .000105,-.000102, .000102, .000099,-.000096, .000095,-.000089,
+      -.000085,-.000084,-.000081,-.000077,-.000072,-.000067, .000066,
+       .000064, .000063, .000063, .000063, .000062, .000062,-.000060,
+       .000056, .000053, .000051, .000050, .368645,-.262232,-.121995,
+      -.050208, .050031,-.049470, .020620, .020613, .011279,-.009530,
+      -.009469,-.008012, .007414,-.007300, .007227,-.007131,-.006644,
+       .005249, .004137, .004087, .003944, .003943, .003420, .003418,
+       .002885, .002884, .002160,-.001936, .001934,-.001798, .001690,
+       .001689, .001516, .001514,-.001511, .001383, .001372, .001371,
+      -.001253,-.001075, .001020, .000901, .000865,-.000794, .000788,
+       .000782,-.000747,-.000745, .000670,-.000603,-.000597, .000542,
+       .000542,-.000541,-.000469,-.000440, .000438, .000422, .000410,
+      -.000374,-.000365, .000345, .000335,-.000321,-.000319, .000307,
+       .000291, .000290,-.000289, .000286, .000275, .000271, .000263,
+      -.000245, .000225, .000225, .000221,-.000202,-.000200,-.000199,
+       .000192, .000183, .000183, .000183,-.000170, .000169, .000168,
+       .000162, .000149,-.000147,-.000141, .000138, .000136, .000136,
+       .000127, .000127,-.000126,-.000121,-.000121, .000117,-.000116,
+      -.000114,-.000114,-.000114, .000114, .000113, .000109, .000108,
+       .000106,-.000106,-.000106, .000105, .000104,-.000103,-.000100,
+      -.000100,-.000100, .000099,-.000098, .000093, .000093, .000090,
+      -.000088, .000083,-.000083,-.000082,-.000081,-.000079,-.000077,
+      -.000075,-.000075,-.000075, .000071, .000071,-.000071, .000068,
+       .000068, .000065, .000065, .000064, .000064, .000064,-.000064,
+      -.000060, .000056, .000056, .000053, .000053, .000053,-.000053,
+       .000053, .000053, .000052, .000050,-.066607,-.035184,-.030988,
+       .027929,-.027616,-.012753,-.006728,-.005837,-.005286,-.004921,
+      -.002884,-.002583,-.002422, .002310, .002283,-.002037, .001883,
+      -.001811,-.001687,-.001004,-.000925,-.000844, .000766, .000766,
+      -.000700,-.000495,-.000492, .000491, .000483, .000437,-.000416,
+      -.000384, .000374,-.000312,-.000288,-.000273, .000259, .000245,
+      -.000232, .000229,-.000216, .000206,-.000204,-.000202, .000200,
+       .000195,-.000190, .000187, .000180,-.000179, .000170, .000153,
+      -.000137,-.000119,-.000119,-.000112,-.000110,-.000110, .000107,
+      -.000095,-.000095,-.000091,-.000090,-.000081,-.000079,-.000079,
+       .000077,-.000073, .000069,-.000067,-.000066, .000065, .000064,
+      -.000062, .000060, .000059,-.000056, .000055,-.000051 };
+
+   // Doodson numbers of the derived tides, used by deriveTides()
+   const OceanLoadTides::NVector OceanLoadTides::DerInd[] = {
+      { 2, 0, 0, 0, 0, 0 },  { 2, 2,-2, 0, 0, 0 },  { 2,-1, 0, 1, 0, 0 },//M2,S2,N2
+      { 2, 2, 0, 0, 0, 0 },  { 2, 2, 0, 0, 1, 0 },  { 2, 0, 0, 0,-1, 0 },//K2,x,x
+      { 2,-1, 2,-1, 0, 0 },  { 2,-2, 2, 0, 0, 0 },  { 2, 1, 0,-1, 0, 0 },  
+      { 2, 2,-3, 0, 0, 1 },  { 2,-2, 0, 2, 0, 0 },  { 2,-3, 2, 1, 0, 0 },  
+      { 2, 1,-2, 1, 0, 0 },  { 2,-1, 0, 1,-1, 0 },  { 2, 3, 0,-1, 0, 0 },  
+      { 2, 1, 0, 1, 0, 0 },  { 2, 2, 0, 0, 2, 0 },  { 2, 2,-1, 0, 0,-1 },  
+      { 2, 0,-1, 0, 0, 1 },  { 2, 1, 0, 1, 1, 0 },  { 2, 3, 0,-1, 1, 0 },  
+      { 2, 0, 1, 0, 0,-1 },  { 2, 0,-2, 2, 0, 0 },  { 2,-3, 0, 3, 0, 0 },  
+      { 2,-2, 3, 0, 0,-1 },  { 2, 4, 0, 0, 0, 0 },  { 2,-1, 1, 1, 0,-1 },  
+      { 2,-1, 3,-1, 0,-1 },  { 2, 2, 0, 0,-1, 0 },  { 2,-1,-1, 1, 0, 1 },  
+      { 2, 4, 0, 0, 1, 0 },  { 2,-3, 4,-1, 0, 0 },  { 2,-1, 2,-1,-1, 0 },  
+      { 2, 3,-2, 1, 0, 0 },  { 2, 1, 2,-1, 0, 0 },  { 2,-4, 2, 2, 0, 0 },  
+      { 2, 4,-2, 0, 0, 0 },  { 2, 0, 2, 0, 0, 0 },  { 2,-2, 2, 0,-1, 0 },  
+      { 2, 2,-4, 0, 0, 2 },  { 2, 2,-2, 0,-1, 0 },  { 2, 1, 0,-1,-1, 0 },  
+      { 2,-1, 1, 0, 0, 0 },  { 2, 2,-1, 0, 0, 1 },  { 2, 2, 1, 0, 0,-1 },  
+      { 2,-2, 0, 2,-1, 0 },  { 2,-2, 4,-2, 0, 0 },  { 2, 2, 2, 0, 0, 0 },  
+      { 2,-4, 4, 0, 0, 0 },  { 2,-1, 0,-1,-2, 0 },  { 2, 1, 2,-1, 1, 0 },  
+      { 2,-1,-2, 3, 0, 0 },  { 2, 3,-2, 1, 1, 0 },  { 2, 4, 0,-2, 0, 0 },  
+      { 2, 0, 0, 2, 0, 0 },  { 2, 0, 2,-2, 0, 0 },  { 2, 0, 2, 0, 1, 0 },  
+      { 2,-3, 3, 1, 0,-1 },  { 2, 0, 0, 0,-2, 0 },  { 2, 4, 0, 0, 2, 0 },  
+      { 2, 4,-2, 0, 1, 0 },  { 2, 0, 0, 0, 0, 2 },  { 2, 1, 0, 1, 2, 0 },  
+      { 2, 0,-2, 0,-2, 0 },  { 2,-2, 1, 0, 0, 1 },  { 2,-2, 1, 2, 0,-1 },  
+      { 2,-1, 1,-1, 0, 1 },  { 2, 5, 0,-1, 0, 0 },  { 2, 1,-3, 1, 0, 1 },  
+      { 2,-2,-1, 2, 0, 1 },  { 2, 3, 0,-1, 2, 0 },  { 2, 1,-2, 1,-1, 0 },  
+      { 2, 5, 0,-1, 1, 0 },  { 2,-4, 0, 4, 0, 0 },  { 2,-3, 2, 1,-1, 0 },  
+      { 2,-2, 1, 1, 0, 0 },  { 2, 4, 0,-2, 1, 0 },  { 2, 0, 0, 2, 1, 0 },  
+      { 2,-5, 4, 1, 0, 0 },  { 2, 0, 2, 0, 2, 0 },  { 2,-1, 2, 1, 0, 0 },  
+      { 2, 5,-2,-1, 0, 0 },  { 2, 1,-1, 0, 0, 0 },  { 2, 2,-2, 0, 0, 2 },  
+      { 2,-5, 2, 3, 0, 0 },  { 2,-1,-2, 1,-2, 0 },  { 2,-3, 5,-1, 0,-1 },  
+      { 2,-1, 0, 0, 0, 1 },  { 2,-2, 0, 0,-2, 0 },  { 2, 0,-1, 1, 0, 0 },  
+      { 2,-3, 1, 1, 0, 1 },  { 2, 3, 0,-1,-1, 0 },  { 2, 1, 0, 1,-1, 0 },  
+      { 2,-1, 2, 1, 1, 0 },  { 2, 0,-3, 2, 0, 1 },  { 2, 1,-1,-1, 0, 1 },  
+      { 2,-3, 0, 3,-1, 0 },  { 2, 0,-2, 2,-1, 0 },  { 2,-4, 3, 2, 0,-1 },  
+      { 2,-1, 0, 1,-2, 0 },  { 2, 5, 0,-1, 2, 0 },  { 2,-4, 5, 0, 0,-1 },  
+      { 2,-2, 4, 0, 0,-2 },  { 2,-1, 0, 1, 0, 2 },  { 2,-2,-2, 4, 0, 0 },  
+      { 2, 3,-2,-1,-1, 0 },  { 2,-2, 5,-2, 0,-1 },  { 2, 0,-1, 0,-1, 1 },  
+      { 2, 5,-2,-1, 1, 0 },  { 1, 1, 0, 0, 0, 0 },  { 1,-1, 0, 0, 0, 0 },//x,K1,O1
+      { 1, 1,-2, 0, 0, 0 },  { 1,-2, 0, 1, 0, 0 },  { 1, 1, 0, 0, 1, 0 },//P1,Q1,x
+      { 1,-1, 0, 0,-1, 0 },  { 1, 2, 0,-1, 0, 0 },  { 1, 0, 0, 1, 0, 0 },  
+      { 1, 3, 0, 0, 0, 0 },  { 1,-2, 2,-1, 0, 0 },  { 1,-2, 0, 1,-1, 0 },  
+      { 1,-3, 2, 0, 0, 0 },  { 1, 0, 0,-1, 0, 0 },  { 1, 1, 0, 0,-1, 0 },  
+      { 1, 3, 0, 0, 1, 0 },  { 1, 1,-3, 0, 0, 1 },  { 1,-3, 0, 2, 0, 0 },  
+      { 1, 1, 2, 0, 0, 0 },  { 1, 0, 0, 1, 1, 0 },  { 1, 2, 0,-1, 1, 0 },  
+      { 1, 0, 2,-1, 0, 0 },  { 1, 2,-2, 1, 0, 0 },  { 1, 3,-2, 0, 0, 0 },  
+      { 1,-1, 2, 0, 0, 0 },  { 1, 1, 1, 0, 0,-1 },  { 1, 1,-1, 0, 0, 1 },  
+      { 1, 4, 0,-1, 0, 0 },  { 1,-4, 2, 1, 0, 0 },  { 1, 0,-2, 1, 0, 0 },  
+      { 1,-2, 2,-1,-1, 0 },  { 1, 3, 0,-2, 0, 0 },  { 1,-1, 0, 2, 0, 0 },  
+      { 1,-1, 0, 0,-2, 0 },  { 1, 3, 0, 0, 2, 0 },  { 1,-3, 2, 0,-1, 0 },  
+      { 1, 4, 0,-1, 1, 0 },  { 1, 0, 0,-1,-1, 0 },  { 1, 1,-2, 0,-1, 0 },  
+      { 1,-3, 0, 2,-1, 0 },  { 1, 1, 0, 0, 2, 0 },  { 1, 1,-1, 0, 0,-1 },  
+      { 1,-1,-1, 0, 0, 1 },  { 1, 0, 2,-1, 1, 0 },  { 1,-1, 1, 0, 0,-1 },  
+      { 1,-1,-2, 2, 0, 0 },  { 1, 2,-2, 1, 1, 0 },  { 1,-4, 0, 3, 0, 0 },  
+      { 1,-1, 2, 0, 1, 0 },  { 1, 3,-2, 0, 1, 0 },  { 1, 2, 0,-1,-1, 0 },  
+      { 1, 0, 0, 1,-1, 0 },  { 1,-2, 2, 1, 0, 0 },  { 1, 4,-2,-1, 0, 0 },  
+      { 1,-3, 3, 0, 0,-1 },  { 1,-2, 1, 1, 0,-1 },  { 1,-2, 3,-1, 0,-1 },  
+      { 1, 0,-2, 1,-1, 0 },  { 1,-2,-1, 1, 0, 1 },  { 1, 4,-2, 1, 0, 0 },  
+      { 1,-4, 4,-1, 0, 0 },  { 1,-4, 2, 1,-1, 0 },  { 1, 5,-2, 0, 0, 0 },  
+      { 1, 3, 0,-2, 1, 0 },  { 1,-5, 2, 2, 0, 0 },  { 1, 2, 0, 1, 0, 0 },  
+      { 1, 1, 3, 0, 0,-1 },  { 1,-2, 0, 1,-2, 0 },  { 1, 4, 0,-1, 2, 0 },  
+      { 1, 1,-4, 0, 0, 2 },  { 1, 5, 0,-2, 0, 0 },  { 1,-1, 0, 2, 1, 0 },  
+      { 1,-2, 1, 0, 0, 0 },  { 1, 4,-2, 1, 1, 0 },  { 1,-3, 4,-2, 0, 0 },  
+      { 1,-1, 3, 0, 0,-1 },  { 1, 3,-3, 0, 0, 1 },  { 1, 5,-2, 0, 1, 0 },  
+      { 1, 1, 2, 0, 1, 0 },  { 1, 2, 0, 1, 1, 0 },  { 1,-5, 4, 0, 0, 0 },  
+      { 1,-2, 0,-1,-2, 0 },  { 1, 5, 0,-2, 1, 0 },  { 1, 1, 2,-2, 0, 0 },  
+      { 1, 1,-2, 2, 0, 0 },  { 1,-2, 2, 1, 1, 0 },  { 1, 0, 3,-1, 0,-1 },  
+      { 1, 2,-3, 1, 0, 1 },  { 1,-2,-2, 3, 0, 0 },  { 1,-1, 2,-2, 0, 0 },  
+      { 1,-4, 3, 1, 0,-1 },  { 1,-4, 0, 3,-1, 0 },  { 1,-1,-2, 2,-1, 0 },  
+      { 1,-2, 0, 3, 0, 0 },  { 1, 4, 0,-3, 0, 0 },  { 1, 0, 1, 1, 0,-1 },  
+      { 1, 2,-1,-1, 0, 1 },  { 1, 2,-2, 1,-1, 0 },  { 1, 0, 0,-1,-2, 0 },  
+      { 1, 2, 0, 1, 2, 0 },  { 1, 2,-2,-1,-1, 0 },  { 1, 0, 0, 1, 2, 0 },  
+      { 1, 0, 1, 0, 0, 0 },  { 1, 2,-1, 0, 0, 0 },  { 1, 0, 2,-1,-1, 0 },  
+      { 1,-1,-2, 0,-2, 0 },  { 1,-3, 1, 0, 0, 1 },  { 1, 3,-2, 0,-1, 0 },  
+      { 1,-1,-1, 0,-1, 1 },  { 1, 4,-2,-1, 1, 0 },  { 1, 2, 1,-1, 0,-1 },  
+      { 1, 0,-1, 1, 0, 1 },  { 1,-2, 4,-1, 0, 0 },  { 1, 4,-4, 1, 0, 0 },  
+      { 1,-3, 1, 2, 0,-1 },  { 1,-3, 3, 0,-1,-1 },  { 1, 1, 2, 0, 2, 0 },  
+      { 1, 1,-2, 0,-2, 0 },  { 1, 3, 0, 0, 3, 0 },  { 1,-1, 2, 0,-1, 0 },  
+      { 1,-2, 1,-1, 0, 1 },  { 1, 0,-3, 1, 0, 1 },  { 1,-3,-1, 2, 0, 1 },  
+      { 1, 2, 0,-1, 2, 0 },  { 1, 6,-2,-1, 0, 0 },  { 1, 2, 2,-1, 0, 0 },  
+      { 1,-1, 1, 0,-1,-1 },  { 1,-2, 3,-1,-1,-1 },  { 1,-1, 0, 0, 0, 2 },  
+      { 1,-5, 0, 4, 0, 0 },  { 1, 1, 0, 0, 0,-2 },  { 1,-2, 1, 1,-1,-1 },  
+      { 1, 1,-1, 0, 1, 1 },  { 1, 1, 2, 0, 0,-2 },  { 1,-3, 1, 1, 0, 0 },  
+      { 1,-4, 4,-1,-1, 0 },  { 1, 1, 0,-2,-1, 0 },  { 1,-2,-1, 1,-1, 1 },  
+      { 1,-3, 2, 2, 0, 0 },  { 1, 5,-2,-2, 0, 0 },  { 1, 3,-4, 2, 0, 0 },  
+      { 1, 1,-2, 0, 0, 2 },  { 1,-1, 4,-2, 0, 0 },  { 1, 2, 2,-1, 1, 0 },  
+      { 1,-5, 2, 2,-1, 0 },  { 1, 1,-3, 0,-1, 1 },  { 1, 1, 1, 0, 1,-1 },  
+      { 1, 6,-2,-1, 1, 0 },  { 1,-2, 2,-1,-2, 0 },  { 1, 4,-2, 1, 2, 0 },  
+      { 1,-6, 4, 1, 0, 0 },  { 1, 5,-4, 0, 0, 0 },  { 1,-3, 4, 0, 0, 0 },  
+      { 1, 1, 2,-2, 1, 0 },  { 1,-2, 1, 0,-1, 0 },  { 0, 2, 0, 0, 0, 0 },//x,x,Mf
+      { 0, 1, 0,-1, 0, 0 },  { 0, 0, 2, 0, 0, 0 },  { 0, 0, 0, 0, 1, 0 },//Mm,SSa
+      { 0, 2, 0, 0, 1, 0 },  { 0, 3, 0,-1, 0, 0 },  { 0, 1,-2, 1, 0, 0 },  
+      { 0, 2,-2, 0, 0, 0 },  { 0, 3, 0,-1, 1, 0 },  { 0, 0, 1, 0, 0,-1 },  
+      { 0, 2, 0,-2, 0, 0 },  { 0, 2, 0, 0, 2, 0 },  { 0, 3,-2, 1, 0, 0 },  
+      { 0, 1, 0,-1,-1, 0 },  { 0, 1, 0,-1, 1, 0 },  { 0, 4,-2, 0, 0, 0 },  
+      { 0, 1, 0, 1, 0, 0 },  { 0, 0, 3, 0, 0,-1 },  { 0, 4, 0,-2, 0, 0 },  
+      { 0, 3,-2, 1, 1, 0 },  { 0, 3,-2,-1, 0, 0 },  { 0, 4,-2, 0, 1, 0 },  
+      { 0, 0, 2, 0, 1, 0 },  { 0, 1, 0, 1, 1, 0 },  { 0, 4, 0,-2, 1, 0 },  
+      { 0, 3, 0,-1, 2, 0 },  { 0, 5,-2,-1, 0, 0 },  { 0, 1, 2,-1, 0, 0 },  
+      { 0, 1,-2, 1,-1, 0 },  { 0, 1,-2, 1, 1, 0 },  { 0, 2,-2, 0,-1, 0 },  
+      { 0, 2,-3, 0, 0, 1 },  { 0, 2,-2, 0, 1, 0 },  { 0, 0, 2,-2, 0, 0 },  
+      { 0, 1,-3, 1, 0, 1 },  { 0, 0, 0, 0, 2, 0 },  { 0, 0, 1, 0, 0, 1 },  
+      { 0, 1, 2,-1, 1, 0 },  { 0, 3, 0,-3, 0, 0 },  { 0, 2, 1, 0, 0,-1 },  
+      { 0, 1,-1,-1, 0, 1 },  { 0, 1, 0, 1, 2, 0 },  { 0, 5,-2,-1, 1, 0 },  
+      { 0, 2,-1, 0, 0, 1 },  { 0, 2, 2,-2, 0, 0 },  { 0, 1,-1, 0, 0, 0 },  
+      { 0, 5, 0,-3, 0, 0 },  { 0, 2, 0,-2, 1, 0 },  { 0, 1, 1,-1, 0,-1 },  
+      { 0, 3,-4, 1, 0, 0 },  { 0, 0, 2, 0, 2, 0 },  { 0, 2, 0,-2,-1, 0 },  
+      { 0, 4,-3, 0, 0, 1 },  { 0, 3,-1,-1, 0, 1 },  { 0, 0, 2, 0, 0,-2 },  
+      { 0, 3,-3, 1, 0, 1 },  { 0, 2,-4, 2, 0, 0 },  { 0, 4,-2,-2, 0, 0 },  
+      { 0, 3, 1,-1, 0,-1 },  { 0, 5,-4, 1, 0, 0 },  { 0, 3,-2,-1,-1, 0 },  
+      { 0, 3,-2, 1, 2, 0 },  { 0, 4,-4, 0, 0, 0 },  { 0, 6,-2,-2, 0, 0 },  
+      { 0, 5, 0,-3, 1, 0 },  { 0, 4,-2, 0, 2, 0 },  { 0, 2, 2,-2, 1, 0 },  
+      { 0, 0, 4, 0, 0,-2 },  { 0, 3,-1, 0, 0, 0 },  { 0, 3,-3,-1, 0, 1 },  
+      { 0, 4, 0,-2, 2, 0 },  { 0, 1,-2,-1,-1, 0 },  { 0, 2,-1, 0, 0,-1 },  
+      { 0, 4,-4, 2, 0, 0 },  { 0, 2, 1, 0, 1,-1 },  { 0, 3,-2,-1, 1, 0 },  
+      { 0, 4,-3, 0, 1, 1 },  { 0, 2, 0, 0, 3, 0 },  { 0, 6,-4, 0, 0, 0 },
+   };
+
    //---------------------------------------------------------------------------------
    // Open and read the given file, containing ocean loading coefficients, and
    // initialize this object for the sites names in the input list that match a
@@ -91,6 +266,9 @@ namespace gpstk {
          GPSTK_THROW(e);
       }
 
+      // cached harmonics may belong to coefficients that are about to be replaced
+      harmonicsMap.clear();
+
       n = 0;         // number of successes
       bool looking=true;                        // true if looking for a site name
       double lat,lon;
@@ -373,64 +551,9 @@ namespace gpstk {
             GPSTK_THROW(e);
          }
 
-         // compute time argument
-         EphTime ttag(time);
-         ttag.convertSystemTo(TimeSystem::UTC);
-         double dayfr(ttag.secOfDay()/86400.0);
-         ttag.convertSystemTo(TimeSystem::TT);
-         // T = EarthOrientation::CoordTransTime()
-         double T((ttag.dMJD() - 51544.5)/36525.0);
-
-         // get the Delauney arguments and frequencies at t
-         double Del[5], freqDel[5];       // degrees and cycles/day
-         Del[0] =    134.9634025100 +     // EarthOrientation::L()
-               T*(477198.8675605000 +
-               T*(     0.0088553333 +
-               T*(     0.0000143431 +
-               T*(    -0.0000000680))));
-         Del[1] =    357.5291091806 +     // EarthOrientation::Lp()
-               T*( 35999.0502911389 +
-               T*(    -0.0001536667 +
-               T*(     0.0000000378 +
-               T*(    -0.0000000032))));
-         Del[2] =     93.2720906200 +     // EarthOrientation::F()
-               T*(483202.0174577222 +
-               T*(    -0.0035420000 +
-               T*(    -0.0000002881 +
-               T*(     0.0000000012))));
-         Del[3] =    297.8501954694 +     // EarthOrientation::D()
-               T*(445267.1114469445 +
-               T*(    -0.0017696111 +
-               T*(     0.0000018314 +
-               T*(    -0.0000000088))));
-         Del[4] =    125.0445550100 +     // EarthOrientation::Omega2003()
-               T*( -1934.1362619722 +
-               T*(     0.0020756111 +
-               T*(     0.0000021394 +
-               T*(    -0.0000000165))));
-         for(i=0; i<5; i++) Del[i] = ::fmod(Del[i],360.0);
-         freqDel[0] =  0.0362916471 + 0.0000000013*T;
-         freqDel[1] =  0.0027377786;
-         freqDel[2] =  0.0367481951 - 0.0000000005*T;
-         freqDel[3] =  0.0338631920 - 0.0000000003*T;
-         freqDel[4] = -0.0001470938 + 0.0000000003*T;
-
-         // convert to Doodson (Darwin) variables
+         // get the Doodson arguments and frequencies at t
          double Dood[6], freqDood[6];
-         Dood[0] = 360.0*dayfr - Del[3];
-         Dood[1] = Del[2] + Del[4];
-         Dood[2] = Dood[1] - Del[3];
-         Dood[3] = Dood[1] - Del[0];
-         Dood[4] = -Del[4];
-         Dood[5] = Dood[2] - Del[1];
-         for(i=0; i<6; i++) Dood[i] = ::fmod(Dood[i],360.0);
-
-         freqDood[0] = 1.0 - freqDel[3];
-         freqDood[1] = freqDel[2] + freqDel[4];
-         freqDood[2] = freqDood[1] - freqDel[3];
-         freqDood[3] = freqDood[1] - freqDel[0];
-         freqDood[4] = -freqDel[4];
-         freqDood[5] = freqDood[2] - freqDel[1];
+         DoodsonArguments(time, Dood, freqDood);
 
          // find amplitudes and phases for vertical, west and south components,
          // for all 342 derived tides, from standard tides
@@ -547,192 +670,310 @@ namespace gpstk {
    }  // end Triple OceanLoadTides::computeDisplacement
 
    //---------------------------------------------------------------------------------
-   int OceanLoadTides::deriveTides(const NVector SchInd[],
-                                   const double amp[], const double phs[],
-                                   const double Dood[], const double freqDood[],
-                                   double ampDer[], double phsDer[], double freqDer[],
-                                   const int Nin)
+   // Compute the site displacement vectors at the given time for several sites.
+   // The astronomical arguments of the derived tides are computed once and shared
+   // by all the sites, and the harmonics of each site are cached.
+   // @param sites vector<string> Input names of the sites; each must have been
+   //              successfully passed to initializeSites().
+   // @param t     EphTime Input time of interest.
+   // @return vector<Triple>, parallel to sites, containing the North, East and Up
+   //                components of the site displacements in meters.
+   // @throw if a site has not been initialized, or if the time system is unknown.
+   vector<Triple> OceanLoadTides::computeDisplacements(const vector<string>& sites,
+                                                       EphTime time)
       throw(Exception)
    {
-      // indexes for std tides: M2, S2, N2, K2, K1,  O1,  P1,  Q1,  Mf,  Mm, Ssa
-      static const int stdindex[] = {
-         0,  1,  2,  3,109, 110, 111, 112, 263, 264, 265 };
-
-      static const double DerAmp[] = {
-          .632208, .294107, .121046, .079915, .023818,-.023589, .022994,
-          .019333,-.017871, .017192, .016018, .004671,-.004662,-.004519,
-          .004470, .004467, .002589,-.002455,-.002172, .001972, .001947,
-          .001914,-.001898, .001802, .001304, .001170, .001130, .001061,
-         -.001022,-.001017, .001014, .000901,-.000857, .000855, .000855,
-          .000772, .000741, .000741,-.000721, .000698, .000658, .000654,
-         -.000653, .000633, .000626,-.000598, .000590, .000544, .000479,
-         -.000464, .000413,-.000390, .000373, .000366, .000366,-.000360,
-         -.000355, .000354, .000329, .000328, .000319, .000302, .000279,
-         -.000274,-.000272, .000248,-.000225, .000224,-.000223,-.000216,
-          .000211, .000209, .000194, .000185,-.000174,-.000171, .000159,
-          .000131, .000127, .000120, .000118, .000117, .000108, .000107,
-          .000105,-.000102, .000102, .000099,-.000096, .000095,-.000089,
-         -.000085,-.000084,-.000081,-.000077,-.000072,-.000067, .000066,
-          .000064, .000063, .000063, .000063, .000062, .000062,-.000060,
-          .000056, .000053, .000051, .000050, .368645,-.262232,-.121995,
-         -.050208, .050031,-.049470, .020620, .020613, .011279,-.009530,
-         -.009469,-.008012, .007414,-.007300, .007227,-.007131,-.006644,
-          .005249, .004137, .004087, .003944, .003943, .003420, .003418,
-          .002885, .002884, .002160,-.001936, .001934,-.001798, .001690,
-          .001689, .001516, .001514,-.001511, .001383, .001372, .001371,
-         -.001253,-.001075, .001020, .000901, .000865,-.000794, .000788,
-          .000782,-.000747,-.000745, .000670,-.000603,-.000597, .000542,
-          .000542,-.000541,-.000469,-.000440, .000438, .000422, .000410,
-         -.000374,-.000365, .000345, .000335,-.000321,-.000319, .000307,
-          .000291, .000290,-.000289, .000286, .000275, .000271, .000263,
-         -.000245, .000225, .000225, .000221,-.000202,-.000200,-.000199,
-          .000192, .000183, .000183, .000183,-.000170, .000169, .000168,
-          .000162, .000149,-.000147,-.000141, .000138, .000136, .000136,
-          .000127, .000127,-.000126,-.000121,-.000121, .000117,-.000116,
-         -.000114,-.000114,-.000114, .000114, .000113, .000109, .000108,
-          .000106,-.000106,-.000106, .000105, .000104,-.000103,-.000100,
-         -.000100,-.000100, .000099,-.000098, .000093, .000093, .000090,
-         -.000088, .000083,-.000083,-.000082,-.000081,-.000079,-.000077,
-         -.000075,-.000075,-.000075, .000071, .000071,-.000071, .000068,
-          .000068, .000065, .000065, .000064, .000064, .000064,-.000064,
-         -.000060, .000056, .000056, .000053, .000053, .000053,-.000053,
-          .000053, .000053, .000052, .000050,-.066607,-.035184,-.030988,
-          .027929,-.027616,-.012753,-.006728,-.005837,-.005286,-.004921,
-         -.002884,-.002583,-.002422, .002310, .002283,-.002037, .001883,
-         -.001811,-.001687,-.001004,-.000925,-.000844, .000766, .000766,
-         -.000700,-.000495,-.000492, .000491, .000483, .000437,-.000416,
-         -.000384, .000374,-.000312,-.000288,-.000273, .000259, .000245,
-         -.000232, .000229,-.000216, .000206,-.000204,-.000202, .000200,
-          .000195,-.000190, .000187, .000180,-.000179, .000170, .000153,
-         -.000137,-.000119,-.000119,-.000112,-.000110,-.000110, .000107,
-         -.000095,-.000095,-.000091,-.000090,-.000081,-.000079,-.000079,
-          .000077,-.000073, .000069,-.000067,-.000066, .000065, .000064,
-         -.000062, .000060, .000059,-.000056, .000055,-.000051 };
-   
-      static const NVector DerInd[] = {
-         { 2, 0, 0, 0, 0, 0 },  { 2, 2,-2, 0, 0, 0 },  { 2,-1, 0, 1, 0, 0 },//M2,S2,N2
-         { 2, 2, 0, 0, 0, 0 },  { 2, 2, 0, 0, 1, 0 },  { 2, 0, 0, 0,-1, 0 },//K2,x,x
-         { 2,-1, 2,-1, 0, 0 },  { 2,-2, 2, 0, 0, 0 },  { 2, 1, 0,-1, 0, 0 },  
-         { 2, 2,-3, 0, 0, 1 },  { 2,-2, 0, 2, 0, 0 },  { 2,-3, 2, 1, 0, 0 },  
-         { 2, 1,-2, 1, 0, 0 },  { 2,-1, 0, 1,-1, 0 },  { 2, 3, 0,-1, 0, 0 },  
-         { 2, 1, 0, 1, 0, 0 },  { 2, 2, 0, 0, 2, 0 },  { 2, 2,-1, 0, 0,-1 },  
-         { 2, 0,-1, 0, 0, 1 },  { 2, 1, 0, 1, 1, 0 },  { 2, 3, 0,-1, 1, 0 },  
-         { 2, 0, 1, 0, 0,-1 },  { 2, 0,-2, 2, 0, 0 },  { 2,-3, 0, 3, 0, 0 },  
-         { 2,-2, 3, 0, 0,-1 },  { 2, 4, 0, 0, 0, 0 },  { 2,-1, 1, 1, 0,-1 },  
-         { 2,-1, 3,-1, 0,-1 },  { 2, 2, 0, 0,-1, 0 },  { 2,-1,-1, 1, 0, 1 },  
-         { 2, 4, 0, 0, 1, 0 },  { 2,-3, 4,-1, 0, 0 },  { 2,-1, 2,-1,-1, 0 },  
-         { 2, 3,-2, 1, 0, 0 },  { 2, 1, 2,-1, 0, 0 },  { 2,-4, 2, 2, 0, 0 },  
-         { 2, 4,-2, 0, 0, 0 },  { 2, 0, 2, 0, 0, 0 },  { 2,-2, 2, 0,-1, 0 },  
-         { 2, 2,-4, 0, 0, 2 },  { 2, 2,-2, 0,-1, 0 },  { 2, 1, 0,-1,-1, 0 },  
-         { 2,-1, 1, 0, 0, 0 },  { 2, 2,-1, 0, 0, 1 },  { 2, 2, 1, 0, 0,-1 },  
-         { 2,-2, 0, 2,-1, 0 },  { 2,-2, 4,-2, 0, 0 },  { 2, 2, 2, 0, 0, 0 },  
-         { 2,-4, 4, 0, 0, 0 },  { 2,-1, 0,-1,-2, 0 },  { 2, 1, 2,-1, 1, 0 },  
-         { 2,-1,-2, 3, 0, 0 },  { 2, 3,-2, 1, 1, 0 },  { 2, 4, 0,-2, 0, 0 },  
-         { 2, 0, 0, 2, 0, 0 },  { 2, 0, 2,-2, 0, 0 },  { 2, 0, 2, 0, 1, 0 },  
-         { 2,-3, 3, 1, 0,-1 },  { 2, 0, 0, 0,-2, 0 },  { 2, 4, 0, 0, 2, 0 },  
-         { 2, 4,-2, 0, 1, 0 },  { 2, 0, 0, 0, 0, 2 },  { 2, 1, 0, 1, 2, 0 },  
-         { 2, 0,-2, 0,-2, 0 },  { 2,-2, 1, 0, 0, 1 },  { 2,-2, 1, 2, 0,-1 },  
-         { 2,-1, 1,-1, 0, 1 },  { 2, 5, 0,-1, 0, 0 },  { 2, 1,-3, 1, 0, 1 },  
-         { 2,-2,-1, 2, 0, 1 },  { 2, 3, 0,-1, 2, 0 },  { 2, 1,-2, 1,-1, 0 },  
-         { 2, 5, 0,-1, 1, 0 },  { 2,-4, 0, 4, 0, 0 },  { 2,-3, 2, 1,-1, 0 },  
-         { 2,-2, 1, 1, 0, 0 },  { 2, 4, 0,-2, 1, 0 },  { 2, 0, 0, 2, 1, 0 },  
-         { 2,-5, 4, 1, 0, 0 },  { 2, 0, 2, 0, 2, 0 },  { 2,-1, 2, 1, 0, 0 },  
-         { 2, 5,-2,-1, 0, 0 },  { 2, 1,-1, 0, 0, 0 },  { 2, 2,-2, 0, 0, 2 },  
-         { 2,-5, 2, 3, 0, 0 },  { 2,-1,-2, 1,-2, 0 },  { 2,-3, 5,-1, 0,-1 },  
-         { 2,-1, 0, 0, 0, 1 },  { 2,-2, 0, 0,-2, 0 },  { 2, 0,-1, 1, 0, 0 },  
-         { 2,-3, 1, 1, 0, 1 },  { 2, 3, 0,-1,-1, 0 },  { 2, 1, 0, 1,-1, 0 },  
-         { 2,-1, 2, 1, 1, 0 },  { 2, 0,-3, 2, 0, 1 },  { 2, 1,-1,-1, 0, 1 },  
-         { 2,-3, 0, 3,-1, 0 },  { 2, 0,-2, 2,-1, 0 },  { 2,-4, 3, 2, 0,-1 },  
-         { 2,-1, 0, 1,-2, 0 },  { 2, 5, 0,-1, 2, 0 },  { 2,-4, 5, 0, 0,-1 },  
-         { 2,-2, 4, 0, 0,-2 },  { 2,-1, 0, 1, 0, 2 },  { 2,-2,-2, 4, 0, 0 },  
-         { 2, 3,-2,-1,-1, 0 },  { 2,-2, 5,-2, 0,-1 },  { 2, 0,-1, 0,-1, 1 },  
-         { 2, 5,-2,-1, 1, 0 },  { 1, 1, 0, 0, 0, 0 },  { 1,-1, 0, 0, 0, 0 },//x,K1,O1
-         { 1, 1,-2, 0, 0, 0 },  { 1,-2, 0, 1, 0, 0 },  { 1, 1, 0, 0, 1, 0 },//P1,Q1,x
-         { 1,-1, 0, 0,-1, 0 },  { 1, 2, 0,-1, 0, 0 },  { 1, 0, 0, 1, 0, 0 },  
-         { 1, 3, 0, 0, 0, 0 },  { 1,-2, 2,-1, 0, 0 },  { 1,-2, 0, 1,-1, 0 },  
-         { 1,-3, 2, 0, 0, 0 },  { 1, 0, 0,-1, 0, 0 },  { 1, 1, 0, 0,-1, 0 },  
-         { 1, 3, 0, 0, 1, 0 },  { 1, 1,-3, 0, 0, 1 },  { 1,-3, 0, 2, 0, 0 },  
-         { 1, 1, 2, 0, 0, 0 },  { 1, 0, 0, 1, 1, 0 },  { 1, 2, 0,-1, 1, 0 },  
-         { 1, 0, 2,-1, 0, 0 },  { 1, 2,-2, 1, 0, 0 },  { 1, 3,-2, 0, 0, 0 },  
-         { 1,-1, 2, 0, 0, 0 },  { 1, 1, 1, 0, 0,-1 },  { 1, 1,-1, 0, 0, 1 },  
-         { 1, 4, 0,-1, 0, 0 },  { 1,-4, 2, 1, 0, 0 },  { 1, 0,-2, 1, 0, 0 },  
-         { 1,-2, 2,-1,-1, 0 },  { 1, 3, 0,-2, 0, 0 },  { 1,-1, 0, 2, 0, 0 },  
-         { 1,-1, 0, 0,-2, 0 },  { 1, 3, 0, 0, 2, 0 },  { 1,-3, 2, 0,-1, 0 },  
-         { 1, 4, 0,-1, 1, 0 },  { 1, 0, 0,-1,-1, 0 },  { 1, 1,-2, 0,-1, 0 },  
-         { 1,-3, 0, 2,-1, 0 },  { 1, 1, 0, 0, 2, 0 },  { 1, 1,-1, 0, 0,-1 },  
-         { 1,-1,-1, 0, 0, 1 },  { 1, 0, 2,-1, 1, 0 },  { 1,-1, 1, 0, 0,-1 },  
-         { 1,-1,-2, 2, 0, 0 },  { 1, 2,-2, 1, 1, 0 },  { 1,-4, 0, 3, 0, 0 },  
-         { 1,-1, 2, 0, 1, 0 },  { 1, 3,-2, 0, 1, 0 },  { 1, 2, 0,-1,-1, 0 },  
-         { 1, 0, 0, 1,-1, 0 },  { 1,-2, 2, 1, 0, 0 },  { 1, 4,-2,-1, 0, 0 },  
-         { 1,-3, 3, 0, 0,-1 },  { 1,-2, 1, 1, 0,-1 },  { 1,-2, 3,-1, 0,-1 },  
-         { 1, 0,-2, 1,-1, 0 },  { 1,-2,-1, 1, 0, 1 },  { 1, 4,-2, 1, 0, 0 },  
-         { 1,-4, 4,-1, 0, 0 },  { 1,-4, 2, 1,-1, 0 },  { 1, 5,-2, 0, 0, 0 },  
-         { 1, 3, 0,-2, 1, 0 },  { 1,-5, 2, 2, 0, 0 },  { 1, 2, 0, 1, 0, 0 },  
-         { 1, 1, 3, 0, 0,-1 },  { 1,-2, 0, 1,-2, 0 },  { 1, 4, 0,-1, 2, 0 },  
-         { 1, 1,-4, 0, 0, 2 },  { 1, 5, 0,-2, 0, 0 },  { 1,-1, 0, 2, 1, 0 },  
-         { 1,-2, 1, 0, 0, 0 },  { 1, 4,-2, 1, 1, 0 },  { 1,-3, 4,-2, 0, 0 },  
-         { 1,-1, 3, 0, 0,-1 },  { 1, 3,-3, 0, 0, 1 },  { 1, 5,-2, 0, 1, 0 },  
-         { 1, 1, 2, 0, 1, 0 },  { 1, 2, 0, 1, 1, 0 },  { 1,-5, 4, 0, 0, 0 },  
-         { 1,-2, 0,-1,-2, 0 },  { 1, 5, 0,-2, 1, 0 },  { 1, 1, 2,-2, 0, 0 },  
-         { 1, 1,-2, 2, 0, 0 },  { 1,-2, 2, 1, 1, 0 },  { 1, 0, 3,-1, 0,-1 },  
-         { 1, 2,-3, 1, 0, 1 },  { 1,-2,-2, 3, 0, 0 },  { 1,-1, 2,-2, 0, 0 },  
-         { 1,-4, 3, 1, 0,-1 },  { 1,-4, 0, 3,-1, 0 },  { 1,-1,-2, 2,-1, 0 },  
-         { 1,-2, 0, 3, 0, 0 },  { 1, 4, 0,-3, 0, 0 },  { 1, 0, 1, 1, 0,-1 },  
-         { 1, 2,-1,-1, 0, 1 },  { 1, 2,-2, 1,-1, 0 },  { 1, 0, 0,-1,-2, 0 },  
-         { 1, 2, 0, 1, 2, 0 },  { 1, 2,-2,-1,-1, 0 },  { 1, 0, 0, 1, 2, 0 },  
-         { 1, 0, 1, 0, 0, 0 },  { 1, 2,-1, 0, 0, 0 },  { 1, 0, 2,-1,-1, 0 },  
-         { 1,-1,-2, 0,-2, 0 },  { 1,-3, 1, 0, 0, 1 },  { 1, 3,-2, 0,-1, 0 },  
-         { 1,-1,-1, 0,-1, 1 },  { 1, 4,-2,-1, 1, 0 },  { 1, 2, 1,-1, 0,-1 },  
-         { 1, 0,-1, 1, 0, 1 },  { 1,-2, 4,-1, 0, 0 },  { 1, 4,-4, 1, 0, 0 },  
-         { 1,-3, 1, 2, 0,-1 },  { 1,-3, 3, 0,-1,-1 },  { 1, 1, 2, 0, 2, 0 },  
-         { 1, 1,-2, 0,-2, 0 },  { 1, 3, 0, 0, 3, 0 },  { 1,-1, 2, 0,-1, 0 },  
-         { 1,-2, 1,-1, 0, 1 },  { 1, 0,-3, 1, 0, 1 },  { 1,-3,-1, 2, 0, 1 },  
-         { 1, 2, 0,-1, 2, 0 },  { 1, 6,-2,-1, 0, 0 },  { 1, 2, 2,-1, 0, 0 },  
-         { 1,-1, 1, 0,-1,-1 },  { 1,-2, 3,-1,-1,-1 },  { 1,-1, 0, 0, 0, 2 },  
-         { 1,-5, 0, 4, 0, 0 },  { 1, 1, 0, 0, 0,-2 },  { 1,-2, 1, 1,-1,-1 },  
-         { 1, 1,-1, 0, 1, 1 },  { 1, 1, 2, 0, 0,-2 },  { 1,-3, 1, 1, 0, 0 },  
-         { 1,-4, 4,-1,-1, 0 },  { 1, 1, 0,-2,-1, 0 },  { 1,-2,-1, 1,-1, 1 },  
-         { 1,-3, 2, 2, 0, 0 },  { 1, 5,-2,-2, 0, 0 },  { 1, 3,-4, 2, 0, 0 },  
-         { 1, 1,-2, 0, 0, 2 },  { 1,-1, 4,-2, 0, 0 },  { 1, 2, 2,-1, 1, 0 },  
-         { 1,-5, 2, 2,-1, 0 },  { 1, 1,-3, 0,-1, 1 },  { 1, 1, 1, 0, 1,-1 },  
-         { 1, 6,-2,-1, 1, 0 },  { 1,-2, 2,-1,-2, 0 },  { 1, 4,-2, 1, 2, 0 },  
-         { 1,-6, 4, 1, 0, 0 },  { 1, 5,-4, 0, 0, 0 },  { 1,-3, 4, 0, 0, 0 },  
-         { 1, 1, 2,-2, 1, 0 },  { 1,-2, 1, 0,-1, 0 },  { 0, 2, 0, 0, 0, 0 },//x,x,Mf
-         { 0, 1, 0,-1, 0, 0 },  { 0, 0, 2, 0, 0, 0 },  { 0, 0, 0, 0, 1, 0 },//Mm,SSa
-         { 0, 2, 0, 0, 1, 0 },  { 0, 3, 0,-1, 0, 0 },  { 0, 1,-2, 1, 0, 0 },  
-         { 0, 2,-2, 0, 0, 0 },  { 0, 3, 0,-1, 1, 0 },  { 0, 0, 1, 0, 0,-1 },  
-         { 0, 2, 0,-2, 0, 0 },  { 0, 2, 0, 0, 2, 0 },  { 0, 3,-2, 1, 0, 0 },  
-         { 0, 1, 0,-1,-1, 0 },  { 0, 1, 0,-1, 1, 0 },  { 0, 4,-2, 0, 0, 0 },  
-         { 0, 1, 0, 1, 0, 0 },  { 0, 0, 3, 0, 0,-1 },  { 0, 4, 0,-2, 0, 0 },  
-         { 0, 3,-2, 1, 1, 0 },  { 0, 3,-2,-1, 0, 0 },  { 0, 4,-2, 0, 1, 0 },  
-         { 0, 0, 2, 0, 1, 0 },  { 0, 1, 0, 1, 1, 0 },  { 0, 4, 0,-2, 1, 0 },  
-         { 0, 3, 0,-1, 2, 0 },  { 0, 5,-2,-1, 0, 0 },  { 0, 1, 2,-1, 0, 0 },  
-         { 0, 1,-2, 1,-1, 0 },  { 0, 1,-2, 1, 1, 0 },  { 0, 2,-2, 0,-1, 0 },  
-         { 0, 2,-3, 0, 0, 1 },  { 0, 2,-2, 0, 1, 0 },  { 0, 0, 2,-2, 0, 0 },  
-         { 0, 1,-3, 1, 0, 1 },  { 0, 0, 0, 0, 2, 0 },  { 0, 0, 1, 0, 0, 1 },  
-         { 0, 1, 2,-1, 1, 0 },  { 0, 3, 0,-3, 0, 0 },  { 0, 2, 1, 0, 0,-1 },  
-         { 0, 1,-1,-1, 0, 1 },  { 0, 1, 0, 1, 2, 0 },  { 0, 5,-2,-1, 1, 0 },  
-         { 0, 2,-1, 0, 0, 1 },  { 0, 2, 2,-2, 0, 0 },  { 0, 1,-1, 0, 0, 0 },  
-         { 0, 5, 0,-3, 0, 0 },  { 0, 2, 0,-2, 1, 0 },  { 0, 1, 1,-1, 0,-1 },  
-         { 0, 3,-4, 1, 0, 0 },  { 0, 0, 2, 0, 2, 0 },  { 0, 2, 0,-2,-1, 0 },  
-         { 0, 4,-3, 0, 0, 1 },  { 0, 3,-1,-1, 0, 1 },  { 0, 0, 2, 0, 0,-2 },  
-         { 0, 3,-3, 1, 0, 1 },  { 0, 2,-4, 2, 0, 0 },  { 0, 4,-2,-2, 0, 0 },  
-         { 0, 3, 1,-1, 0,-1 },  { 0, 5,-4, 1, 0, 0 },  { 0, 3,-2,-1,-1, 0 },  
-         { 0, 3,-2, 1, 2, 0 },  { 0, 4,-4, 0, 0, 0 },  { 0, 6,-2,-2, 0, 0 },  
-         { 0, 5, 0,-3, 1, 0 },  { 0, 4,-2, 0, 2, 0 },  { 0, 2, 2,-2, 1, 0 },  
-         { 0, 0, 4, 0, 0,-2 },  { 0, 3,-1, 0, 0, 0 },  { 0, 3,-3,-1, 0, 1 },  
-         { 0, 4, 0,-2, 2, 0 },  { 0, 1,-2,-1,-1, 0 },  { 0, 2,-1, 0, 0,-1 },  
-         { 0, 4,-4, 2, 0, 0 },  { 0, 2, 1, 0, 1,-1 },  { 0, 3,-2,-1, 1, 0 },  
-         { 0, 4,-3, 0, 1, 1 },  { 0, 2, 0, 0, 3, 0 },  { 0, 6,-4, 0, 0, 0 },
-      };
+      try {
+         size_t i;
+         for(i=0; i<sites.size(); i++) {
+            if(!isValid(sites[i])) {
+               Exception e("Site " + sites[i] + " has not been initialized.");
+               GPSTK_THROW(e);
+            }
+         }
+
+         // epoch-dependent part, common to all the sites
+         double Dood[6], freqDood[6];
+         double T = DoodsonArguments(time, Dood, freqDood);
+         vector<double> cosArg(NDER), sinArg(NDER);
+         deriveArguments(Dood, &cosArg[0], &sinArg[0]);
+
+         // site-dependent part
+         vector<Triple> disp(sites.size());
+         for(i=0; i<sites.size(); i++) {
+            const SiteHarmonics& harm = getHarmonics(sites[i], T, freqDood);
+            disp[i] = sumHarmonics(harm, &cosArg[0], &sinArg[0]);
+         }
+
+         return disp;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+      catch(exception& e) {
+         Exception E("std except: " + string(e.what()));
+         GPSTK_THROW(E);
+      }
+      catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+
+   }  // end vector<Triple> OceanLoadTides::computeDisplacements()
+
+   //---------------------------------------------------------------------------------
+   // Compute the site displacement vectors for one site at several times, for
+   // example a dense time grid. The harmonics of the site are computed once and
+   // reused as long as the times are within getHarmonicsSpan() days of the time
+   // at which they were computed.
+   // @param site  string Input name of the site; must be the same as previously
+   //              successfully passed to initializeSites().
+   // @param times vector<EphTime> Input times of interest.
+   // @return vector<Triple>, parallel to times, containing the North, East and Up
+   //                components of the site displacements in meters.
+   // @throw if the site has not been initialized, or if the time system is unknown.
+   vector<Triple> OceanLoadTides::computeDisplacements(string site,
+                                                   const vector<EphTime>& times)
+      throw(Exception)
+   {
+      try {
+         if(!isValid(site)) {
+            Exception e("Site " + site + " has not been initialized.");
+            GPSTK_THROW(e);
+         }
+
+         double Dood[6], freqDood[6];
+         vector<double> cosArg(NDER), sinArg(NDER);
+         vector<Triple> disp(times.size());
+         for(size_t i=0; i<times.size(); i++) {
+            double T = DoodsonArguments(times[i], Dood, freqDood);
+            deriveArguments(Dood, &cosArg[0], &sinArg[0]);
+            const SiteHarmonics& harm = getHarmonics(site, T, freqDood);
+            disp[i] = sumHarmonics(harm, &cosArg[0], &sinArg[0]);
+         }
+
+         return disp;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+      catch(exception& e) {
+         Exception E("std except: " + string(e.what()));
+         GPSTK_THROW(E);
+      }
+      catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+
+   }  // end vector<Triple> OceanLoadTides::computeDisplacements()
+
+   //---------------------------------------------------------------------------------
+   // Compute the cosine and sine of the astronomical argument of each of the NDER
+   // derived tides.
+   // @param Dood      array of 6 Doodson arguments at time in degrees
+   // @param cosArg    array of NDER cosines of the arguments
+   // @param sinArg    array of NDER sines of the arguments
+   void OceanLoadTides::deriveArguments(const double Dood[],
+                                        double cosArg[], double sinArg[]) throw()
+   {
+      for(int j=0; j<NDER; j++) {
+         double arg(0.0);
+         for(int k=0; k<6; k++)
+            arg += DerInd[j].n[k] * Dood[k];
+         arg = ::fmod(arg,360.0) * DEG_TO_RAD;
+         cosArg[j] = ::cos(arg);
+         sinArg[j] = ::sin(arg);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   // Return the harmonics of the given (valid) site, computing them first if they
+   // are not in the cache or if they were computed more than harmonicsSpan days
+   // away from T.
+   // @param site      name of the site
+   // @param T         time of interest in Julian centuries (TT) since J2000
+   // @param freqDood  array of 6 Doodson frequencies at T in cycles/day
+   // @throw if static arrays are corrupted.
+   const OceanLoadTides::SiteHarmonics& OceanLoadTides::getHarmonics(
+                  const string& site, const double T, const double freqDood[])
+      throw(Exception)
+   {
+      map<string, SiteHarmonics>::iterator it = harmonicsMap.find(site);
+      if(it != harmonicsMap.end() && ::fabs(T-it->second.T)*36525.0 <= harmonicsSpan)
+         return it->second;
 
+      SiteHarmonics& harm = harmonicsMap[site];
+      deriveHarmonics(coefficientMap[site], freqDood, harm);
+      harm.T = T;
+
+      return harm;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Derive the site-dependent part of the derived tides from the coefficients of
+   // the standard tides for one site. This is the same computation as
+   // deriveTides(), with the phase of each derived tide split into its
+   // astronomical argument, which depends only on time (see deriveArguments()),
+   // and a constant offset; the amplitude and offset of each tide are stored as
+   // amp*cos(offset) and amp*sin(offset), for the vertical, west and south
+   // components.
+   // @param coeff     coefficients of the site, as in coefficientMap
+   // @param freqDood  array of 6 Doodson frequencies in cycles/day
+   // @param harm      output harmonics
+   // @throw if static arrays are corrupted.
+   void OceanLoadTides::deriveHarmonics(const vector<double>& coeff,
+                                        const double freqDood[], SiteHarmonics& harm)
+      throw(Exception)
+   {
+      int i,j,k,c;
+      static const double dtr(0.01745329252);
+
+      harm.index.clear();
+      for(c=0; c<3; c++) {                      // vertical, west, south
+         double amp[NSTD],phs[NSTD];
+         for(i=0; i<NSTD; i++) {
+            amp[i] = coeff[c*NSTD+i];
+            phs[i] = -coeff[33+c*NSTD+i];
+         }
+
+         CubicSpline<double> csR[3], csI[3];
+         int nl = buildSplines(amp, phs, freqDood, csR, csI, NSTD);
+
+         harm.C[c].clear();
+         harm.S[c].clear();
+         for(j=0; j<NDER; j++) {
+            if(DerInd[j].n[0] == 0 && nl == 0) continue;
+            if(c == 0) harm.index.push_back(j);
+
+            double freq(0.0);
+            for(k=0; k<6; k++)
+               freq += DerInd[j].n[k] * freqDood[k];
+
+            double ramp,iamp;
+            k = DerInd[j].n[0];         // shell: 0=low, 1=medium, 2=high
+            if(csR[k].testLimits(freq,ramp)) ramp = csR[k].Evaluate(freq);
+            if(csI[k].testLimits(freq,iamp)) iamp = csI[k].Evaluate(freq);
+
+            double offset(::atan2(iamp,ramp)/dtr);
+            if(     DerInd[j].n[0] == 0) offset += 180.0;
+            else if(DerInd[j].n[0] == 1) offset += 90.0;
+            offset *= DEG_TO_RAD;
+
+            double ampl(DerAmp[j] * RSS(ramp,iamp));
+            harm.C[c].push_back(ampl * ::cos(offset));
+            harm.S[c].push_back(ampl * ::sin(offset));
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   // Sum the derived tides of one site, given the cosine and sine of their
+   // astronomical arguments, and return the displacement as North, East, Up.
+   Triple OceanLoadTides::sumHarmonics(const SiteHarmonics& harm,
+                                       const double cosArg[], const double sinArg[])
+      throw()
+   {
+      Triple dc(0.0,0.0,0.0);          // U W S
+      const size_t n(harm.index.size());
+      for(int c=0; c<3; c++) {
+         const double *C(&harm.C[c][0]), *S(&harm.S[c][0]);
+         double sum(0.0);
+         for(size_t i=0; i<n; i++) {
+            const int j(harm.index[i]);
+            sum += C[i]*cosArg[j] - S[i]*sinArg[j];
+         }
+         dc[c] = sum;
+      }
+
+      // convert vertical,west,south to north,east,up
+      double temp=dc[0];
+      dc[0] = -dc[2];         // N = -S
+      dc[1] = -dc[1];         // E = -W
+      dc[2] = temp;           // U = U
+
+      return dc;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Compute the Doodson arguments and their frequencies at the given time.
+   // @param time      EphTime Input time of interest.
+   // @param Dood      array of 6 Doodson arguments at time in degrees
+   // @param freqDood  array of 6 Doodson frequencies at time in cycles/day
+   // @return T, time of interest in Julian centuries (TT) since J2000.
+   // @throw if the time system is unknown.
+   double OceanLoadTides::DoodsonArguments(EphTime time,
+                                           double Dood[], double freqDood[])
+      throw(Exception)
+   {
+      int i;
+
+      // compute time argument
+      EphTime ttag(time);
+      ttag.convertSystemTo(TimeSystem::UTC);
+      double dayfr(ttag.secOfDay()/86400.0);
+      ttag.convertSystemTo(TimeSystem::TT);
+      // T = EarthOrientation::CoordTransTime()
+      double T((ttag.dMJD() - 51544.5)/36525.0);
+
+      // get the Delauney arguments and frequencies at t
+      double Del[5], freqDel[5];       // degrees and cycles/day
+      Del[0] =    134.9634025100 +     // EarthOrientation::L()
+            T*(477198.8675605000 +
+            T*(     0.0088553333 +
+            T*(     0.0000143431 +
+            T*(    -0.0000000680))));
+      Del[1] =    357.5291091806 +     // EarthOrientation::Lp()
+            T*( 35999.0502911389 +
+            T*(    -0.0001536667 +
+            T*(     0.0000000378 +
+            T*(    -0.0000000032))));
+      Del[2] =     93.2720906200 +     // EarthOrientation::F()
+            T*(483202.0174577222 +
+            T*(    -0.0035420000 +
+            T*(    -0.0000002881 +
+            T*(     0.0000000012))));
+      Del[3] =    297.8501954694 +     // EarthOrientation::D()
+            T*(445267.1114469445 +
+            T*(    -0.0017696111 +
+            T*(     0.0000018314 +
+            T*(    -0.0000000088))));
+      Del[4] =    125.0445550100 +     // EarthOrientation::Omega2003()
+            T*( -1934.1362619722 +
+            T*(     0.0020756111 +
+            T*(     0.0000021394 +
+            T*(    -0.0000000165))));
+      for(i=0; i<5; i++) Del[i] = ::fmod(Del[i],360.0);
+      freqDel[0] =  0.0362916471 + 0.0000000013*T;
+      freqDel[1] =  0.0027377786;
+      freqDel[2] =  0.0367481951 - 0.0000000005*T;
+      freqDel[3] =  0.0338631920 - 0.0000000003*T;
+      freqDel[4] = -0.0001470938 + 0.0000000003*T;
+
+      // convert to Doodson (Darwin) variables
+      Dood[0] = 360.0*dayfr - Del[3];
+      Dood[1] = Del[2] + Del[4];
+      Dood[2] = Dood[1] - Del[3];
+      Dood[3] = Dood[1] - Del[0];
+      Dood[4] = -Del[4];
+      Dood[5] = Dood[2] - Del[1];
+      for(i=0; i<6; i++) Dood[i] = ::fmod(Dood[i],360.0);
+
+      freqDood[0] = 1.0 - freqDel[3];
+      freqDood[1] = freqDel[2] + freqDel[4];
+      freqDood[2] = freqDood[1] - freqDel[3];
+      freqDood[3] = freqDood[1] - freqDel[0];
+      freqDood[4] = -freqDel[4];
+      freqDood[5] = freqDood[2] - freqDel[1];
+
+      return T;
+
+   }  // end double OceanLoadTides::DoodsonArguments()
+
+   //---------------------------------------------------------------------------------
+   int OceanLoadTides::buildSplines(const double amp[], const double phs[],
+                                    const double freqDood[],
+                                    CubicSpline<double> csR[], CubicSpline<double> csI[],
+                                    const int Nin)
+      throw(Exception)
+   {
       if((int)(sizeof(DerAmp) / sizeof(double)) != NDER
             || (int)(sizeof(DerInd) / sizeof(NVector)) != NDER) {
          Exception e("Static arrays are corrupted");
          GPSTK_THROW(e);
       }
    
-      int i,j,k,kk;
+      int i,j,k;
       static const double dtr(0.01745329252);
 
       // get amplitude, phase and frequency for each of the standard tides
@@ -830,15 +1071,34 @@ namespace gpstk {
       }
 
       // find splines of amp vs frequency in each shell
-      CubicSpline<double> csRlow, csIlow, csRmed, csImed, csRhi, csIhi;
       if(nl > 0) {
-         csRlow.Initialize(Flow, Rlow);
-         csIlow.Initialize(Flow, Ilow);
+         csR[0].Initialize(Flow, Rlow);
+         csI[0].Initialize(Flow, Ilow);
       }
-      csRmed.Initialize(Fmed, Rmed);
-      csImed.Initialize(Fmed, Imed);
-      csRhi.Initialize(Fhi, Rhi);
-      csIhi.Initialize(Fhi, Ihi);
+      csR[1].Initialize(Fmed, Rmed);
+      csI[1].Initialize(Fmed, Imed);
+      csR[2].Initialize(Fhi, Rhi);
+      csI[2].Initialize(Fhi, Ihi);
+
+      return nl;
+
+   }  // end int OceanLoadTides::buildSplines()
+
+   //---------------------------------------------------------------------------------
+   int OceanLoadTides::deriveTides(const NVector SchInd[],
+                                   const double amp[], const double phs[],
+                                   const double Dood[], const double freqDood[],
+                                   double ampDer[], double phsDer[], double freqDer[],
+                                   const int Nin)
+      throw(Exception)
+   {
+      int j,k;
+      double freq;
+      static const double dtr(0.01745329252);
+
+      // splines of amplitude vs frequency in each shell
+      CubicSpline<double> csR[3], csI[3];
+      int nl = buildSplines(amp, phs, freqDood, csR, csI, Nin);
 
       // evaluate splines at each of the NDER waves; not all will contribute
       int nout(0);
@@ -868,18 +1128,9 @@ namespace gpstk {
          // get amplitudes at freq
          freq = freqDer[nout];
          double ramp,iamp;
-         if(     DerInd[j].n[0] == 0) {
-            if(csRlow.testLimits(freq,ramp)) ramp = csRlow.Evaluate(freq);
-            if(csIlow.testLimits(freq,iamp)) iamp = csIlow.Evaluate(freq);
-         }
-         else if(DerInd[j].n[0] == 1) {
-            if(csRmed.testLimits(freq,ramp)) ramp = csRmed.Evaluate(freq);
-            if(csImed.testLimits(freq,iamp)) iamp = csImed.Evaluate(freq);
-         }
-         else if(DerInd[j].n[0] == 2) {
-            if(csRhi.testLimits(freq,ramp)) ramp = csRhi.Evaluate(freq);
-            if(csIhi.testLimits(freq,iamp)) iamp = csIhi.Evaluate(freq);
-         }
+         k = DerInd[j].n[0];         // shell: 0=low, 1=medium, 2=high
+         if(csR[k].testLimits(freq,ramp)) ramp = csR[k].Evaluate(freq);
+         if(csI[k].testLimits(freq,iamp)) iamp = csI[k].Evaluate(freq);
 
          ampDer[nout] = DerAmp[j] * RSS(ramp,iamp);
          phsDer[nout] += ::atan2(iamp,ramp)/dtr; //*RAD_TO_DEG;   // TEMP
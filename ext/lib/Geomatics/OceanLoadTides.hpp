@@ -48,6 +48,7 @@
 #include "Exception.hpp"
 #include "EphTime.hpp"
 #include "Triple.hpp"
+#include "CubicSpline.hpp"
 
 //------------------------------------------------------------------------------------
 namespace gpstk {
@@ -66,11 +67,16 @@ namespace gpstk {
 /// which computations will later be desired. The function isValid() returns true
 /// when a given site has been initialized. The function computeDisplacement() will
 /// compute the site displacement vector at any time for any initialized site.
+/// The functions computeDisplacements() compute displacements in batches, either
+/// for many sites at one time or for one site at many times; they compute the
+/// time-dependent astronomical arguments only once per time, and cache, for each
+/// site, the amplitudes and phases of the derived tides, which depend on time
+/// only very weakly.
 /// 
 class OceanLoadTides {
 public:
    /// Constructor
-   OceanLoadTides() {};
+   OceanLoadTides() : harmonicsSpan(1.0) {};
 
    /// Open and read the given file, containing ocean loading coefficients, and
    /// initialize this object for the sites names in the input list that match a
@@ -119,6 +125,55 @@ public:
    ///                if there is corruption in the static arrays, or .
    Triple computeDisplacement(std::string site, EphTime t) throw(Exception);
 
+   /// Compute the site displacement vectors at the given time for several sites.
+   /// The astronomical arguments of the derived tides are computed once and
+   /// shared by all the sites, and the harmonics of each site are cached (see
+   /// setHarmonicsSpan()). The results are not bit-identical to those of
+   /// computeDisplacement(): the sum over the tides is arranged differently, and
+   /// cached harmonics are reused for up to getHarmonicsSpan() days. With the
+   /// default span of 1 day the two agree to about 1e-14 m; the difference grows
+   /// slowly with the span, to about 2e-14 m for a span of 100 days.
+   /// @param sites vector<string> Input names of the sites; each must have been
+   ///              successfully passed to initializeSites().
+   /// @param t     EphTime Input time of interest.
+   /// @return vector<Triple>, parallel to sites, containing the North, East and
+   ///                Up components of the site displacements in meters.
+   /// @throw if a site has not been initialized, or if the time system is unknown.
+   std::vector<Triple> computeDisplacements(const std::vector<std::string>& sites,
+                                            EphTime t)
+      throw(Exception);
+
+   /// Compute the site displacement vectors for one site at several times, for
+   /// example a dense time grid. The harmonics of the site are computed once and
+   /// reused for all the times within getHarmonicsSpan() days; see the
+   /// computeDisplacements() above for the agreement with computeDisplacement().
+   /// @param site  string Input name of the site; must be the same as previously
+   ///              successfully passed to initializeSites().
+   /// @param times vector<EphTime> Input times of interest.
+   /// @return vector<Triple>, parallel to times, containing the North, East and Up
+   ///                components of the site displacements in meters.
+   /// @throw if the site has not been initialized, or if the time system is unknown.
+   std::vector<Triple> computeDisplacements(std::string site,
+                                            const std::vector<EphTime>& times)
+      throw(Exception);
+
+   /// Set the time span, in days, over which the cached harmonics of a site are
+   /// reused by computeDisplacements(). The harmonics depend on time only through
+   /// the slow drift of the tidal frequencies, so the span hardly matters: the
+   /// results differ from computeDisplacement() by about 1e-14 m for spans of
+   /// 0 (harmonics recomputed at every call) to 10 days, and by about 2e-14 m for
+   /// a span of 100 days. Default is 1 day.
+   void setHarmonicsSpan(double days) throw()
+   { harmonicsSpan = days; }
+
+   /// Get the time span, in days, over which cached harmonics are reused.
+   double getHarmonicsSpan(void) const throw()
+   { return harmonicsSpan; }
+
+   /// Clear the cache of harmonics used by computeDisplacements().
+   void clearHarmonics(void) throw()
+   { harmonicsMap.clear(); }
+
    /// Return the recorded latitude, longitude and ht(=0) for the given site.
    /// Return value of (0.0,0.0,0.0) probably means the position was not found.
    Triple getPosition(std::string site) throw()
@@ -147,12 +202,98 @@ private:
    /// Used for convenience by computeDisplacements
    typedef struct { int n[6]; } NVector;
 
+   /// Harmonics of one site, i.e. the site-dependent part of the derived tides,
+   /// created by deriveHarmonics().
+   typedef struct {
+      double T;                        ///< time (TT centuries since J2000) of freqs
+      std::vector<int> index;          ///< index in DerInd of each derived tide
+      std::vector<double> C[3];        ///< amp*cos(phase offset), vert,west,south
+      std::vector<double> S[3];        ///< amp*sin(phase offset), vert,west,south
+   } SiteHarmonics;
+
+   /// map of (site name, harmonics), cache used by computeDisplacements()
+   std::map<std::string, SiteHarmonics> harmonicsMap;
+
+   /// time span (days) over which cached harmonics are reused
+   double harmonicsSpan;
+
    /// Number of standard (Schwiderski) tides read from BLQ file
    static const int NSTD;
 
    /// Number of derived tides computed by deriveTides()
    static const int NDER;
 
+   /// Indexes in DerInd of the standard tides
+   static const int stdindex[];
+
+   /// Amplitudes of the derived tides
+   static const double DerAmp[];
+
+   /// Doodson numbers of the derived tides
+   static const NVector DerInd[];
+
+   /// Compute the Doodson arguments and their frequencies at the given time.
+   /// @param time      EphTime Input time of interest.
+   /// @param Dood      array of 6 Doodson arguments at time in degrees
+   /// @param freqDood  array of 6 Doodson frequencies at time in cycles/day
+   /// @return T, time of interest in Julian centuries (TT) since J2000.
+   /// @throw if the time system is unknown.
+   double DoodsonArguments(EphTime time, double Dood[], double freqDood[])
+      throw(Exception);
+
+   /// Compute the cosine and sine of the astronomical argument of each of the
+   /// NDER derived tides.
+   /// @param Dood      array of 6 Doodson arguments at time in degrees
+   /// @param cosArg    array of NDER cosines of the arguments
+   /// @param sinArg    array of NDER sines of the arguments
+   void deriveArguments(const double Dood[], double cosArg[], double sinArg[])
+      throw();
+
+   /// Return the harmonics of the given (valid) site, from the cache or, if they
+   /// are not there or were computed more than harmonicsSpan days from T, from
+   /// deriveHarmonics().
+   /// @param site      name of the site
+   /// @param T         time of interest in Julian centuries (TT) since J2000
+   /// @param freqDood  array of 6 Doodson frequencies at T in cycles/day
+   /// @throw if static arrays are corrupted.
+   const SiteHarmonics& getHarmonics(const std::string& site, const double T,
+                                     const double freqDood[])
+      throw(Exception);
+
+   /// Derive the site-dependent part of the derived tides, as in deriveTides(),
+   /// but with the phase of each derived tide split into its astronomical
+   /// argument (see deriveArguments()) and a constant offset.
+   /// @param coeff     coefficients of the site, as in coefficientMap
+   /// @param freqDood  array of 6 Doodson frequencies in cycles/day
+   /// @param harm      output harmonics
+   /// @throw if static arrays are corrupted.
+   void deriveHarmonics(const std::vector<double>& coeff, const double freqDood[],
+                        SiteHarmonics& harm)
+      throw(Exception);
+
+   /// Sum the derived tides of one site, given the cosine and sine of their
+   /// astronomical arguments; return the displacement as North, East, Up.
+   Triple sumHarmonics(const SiteHarmonics& harm,
+                       const double cosArg[], const double sinArg[])
+      throw();
+
+   /// Fit cubic splines of the real and imaginary amplitudes of the standard tides
+   /// vs frequency, for each of the three shells (long period, diurnal and
+   /// semi-diurnal). Called by deriveTides() and deriveHarmonics().
+   /// @param amp       array of 11 amplitudes from BLQ file
+   /// @param phs       array of 11 phases from BLQ file
+   /// @param freqDood  array of 6 Doodson frequencies at time in cycles/day
+   /// @param csR       array of 3 splines of the real amplitudes, one per shell
+   /// @param csI       array of 3 splines of the imaginary amplitudes
+   /// @param Nin       number of std tides (11)
+   /// @return nl       number of std tides in the long period shell; if 0, the
+   ///                  splines for this shell are not initialized.
+   /// @throw if static arrays are corrupted.
+   int buildSplines(const double amp[], const double phs[], const double freqDood[],
+                    CubicSpline<double> csR[], CubicSpline<double> csI[],
+                    const int Nin)
+      throw(Exception);
+
    /// Derive the 342 tides from the standard 11 tides using cubic spline
    /// interpolation. Called by computeDisplacements()
    /// @param SchTides  array of 11 NVectors (int[6]) with for standard tides
@@ -117,7 +117,14 @@ namespace gpstk
          EarthOrientation eo = EOPStore::getEOP(ttag.dMJD(), iersconv);
 
          // get transformation i-to-t = transpose(terrestrial-to-inertial)
-         Matrix<double> Rot = transpose(eo.ECEFtoInertial(time));
+         Matrix<double> Rot;
+         if(useRotationCache) {
+            if(rotationCache.getConvention() != iersconv)
+               rotationCache.setConvention(iersconv);
+            Rot = transpose(rotationCache.ECEFtoInertial(time, eo));
+         }
+         else
+            Rot = transpose(eo.ECEFtoInertial(time));
 
          // transform inertial to terrestrial
          tPos = Rot * iPos;
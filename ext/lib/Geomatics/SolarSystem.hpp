@@ -85,6 +85,7 @@
 #include "SolarSystemEphemeris.hpp"
 #include "IERSConvention.hpp"
 #include "EarthOrientation.hpp"
+#include "EarthRotationCache.hpp"
 #include "SunEarthSatGeometry.hpp"
 #include "SolidEarthTides.hpp"
 #include "logstream.hpp"
@@ -154,6 +155,7 @@ public:
    /// SolarSystemEphemeris file when initializeWithBinaryFile() is called, otherwise
    /// a warning is issued.
    SolarSystem(IERSConvention inputiers=IERSConvention::NONE) throw()
+      : useRotationCache(false)
       { iersconv = inputiers; }
 
    /// Choose an IERS Convention. If the input IERS convention is inconsistent with
@@ -168,6 +170,17 @@ public:
    IERSConvention getConvention(void) const throw ()
       { return iersconv; }
 
+   /// Choose whether the terrestrial <=> inertial transformation, used by
+   /// ECEFPosition() and related functions, interpolates the precession-nutation
+   /// series with an EarthRotationCache (faster when called at many epochs) rather
+   /// than summing them at each call (the default).
+   void setUseRotationCache(bool use) throw()
+      { useRotationCache = use; }
+
+   /// get the EarthRotationCache, e.g. to check its interpolation error
+   const EarthRotationCache& getRotationCache(void) const throw()
+      { return rotationCache; }
+
    /// Overloaded function to load ephemeris file. A check of the ephemeris number
    /// and the IERS convention for this object is made; if the IERS convention is
    /// inconsistent with the ephemeris file then a warning is issued.
@@ -380,6 +393,12 @@ private:
    /// issued at the reading of the ephemeris file or when the assignment is made.
    IERSConvention iersconv;
 
+   /// if true, use rotationCache in ECEFPositionVelocity()
+   bool useRotationCache;
+
+   /// cache of the precession-nutation series, cf. setUseRotationCache()
+   EarthRotationCache rotationCache;
+
    /// Helper routine to keep the tests in one place
    void testIERSvsEphemeris(const IERSConvention conv, const int ephno) throw()
    {
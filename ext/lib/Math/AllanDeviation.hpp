@@ -43,10 +43,9 @@
 #define GPSTK_ALLANDEVIATION_HPP
 
 #include <vector>
-#include <cmath>
-#include <ostream>
+#include <iostream>
 
-#include "Exception.hpp"
+#include "ClockStability.hpp"
 
 namespace gpstk
 {
@@ -54,7 +53,9 @@ namespace gpstk
    //@{
 
    
-   /// Compute the overlapping Allan variance of the phase data provided.
+      /** Compute the overlapping Allan variance of the phase data provided.
+       * The last phase sample is not used.
+       * @sa ClockStability for the other stability statistics. */
    class AllanDeviation
    {
    public:
@@ -67,32 +68,22 @@ namespace gpstk
             GPSTK_THROW(e);
          }
 
-         // Actual Overlapping Allan Deviation Calculation is done here
          // The Overlapping Allan Deviation is calculated as follows
          //  Sigma^2(Tau) = 1 / (2*(N-2*m)*Tau^2) * Sum(X[i+2*m]-2*X[i+m]+X[i], i=1, i=N-2*m)
          //  Where Tau is the averaging time, N is the total number of points, and Tau = m*Tau0
          //  Where Tau0 is the basic measurement interval	
-         double sum, sigma;
-         for(int m = 1; m <= (N-1)/2; m++)
+         if (N < 3)
+            return;
+
+         std::vector<double> x(phase.begin(), phase.begin()+N);
+         ClockStability cs(x, tau0);
+         std::vector<ClockStability::Point> curve;
+         curve = cs.compute(ClockStability::ADEV, ClockStability::All);
+         for (size_t i = 0; i < curve.size(); i++)
          {
-            double tau = m*tau0;
-            sigma = 0;
-            
-            for(int i = 0; i < (N-2*m); i++)
-            {
-               sum = 0;
-               if((phase[i+2*m]==0 ||  phase[i+m]==0 || phase[i]==0) 
-                  && i!=0 && i!=(N-2*m-1))
-                  numGaps++;
-               else
-                  sum = phase[i+2*m] - 2*phase[i+m] + phase[i];
-               sigma += sum * sum;
-            }
-		
-            sigma = sigma / (2.0*((double)N-(double)numGaps-0-2.0*(double)m)*tau*tau);
-            sigma = sqrt(sigma);
-            deviation.push_back(sigma);
-            time.push_back(tau);
+            deviation.push_back(curve[i].deviation);
+            time.push_back(curve[i].tau);
+            numGaps += curve[i].numGaps;
          }
       }
 
@@ -105,15 +96,18 @@ namespace gpstk
 
       const int N;
       std::vector<double> deviation, time;
+         /// Total number of gaps over all the averaging times
       int numGaps;
    };
 
-   std::ostream& operator<<(std::ostream& s, const AllanDeviation& a)
+   inline std::ostream& operator<<(std::ostream& s, const AllanDeviation& a)
    {
       a.dump(s);
       return s;
    }
 
+   //@}
+
 }  // namespace
 
 #endif
@@ -0,0 +1,445 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ClockStability.cpp
+ * Frequency stability analysis of clock phase data.
+ */
+
+#include "ClockStability.hpp"
+#include <math.h>
+
+namespace gpstk
+{
+   ClockStability::ClockStability(const std::vector<double>& phase,
+                                  double t0)
+      throw(Exception)
+         : x(phase), tau0(t0), hasGaps(false)
+   {
+      if (x.size() < 3)
+      {
+         Exception e("Need at least 3 points to compute a stability curve.");
+         GPSTK_THROW(e);
+      }
+
+      for (size_t i=0; i<x.size() && !hasGaps; i++)
+         hasGaps = (x[i] == 0);
+   }
+
+
+   unsigned long ClockStability::maxFactor(Statistic stat) const throw()
+   {
+      unsigned long N = x.size();
+      switch (stat)
+      {
+         case ADEV:   return (N-1)/2;
+         case MDEV:
+         case TDEV:   return N/3;
+         case HDEV:   return (N-1)/3;
+         case TOTDEV: return N-1;
+      }
+      return 0;
+   }
+
+
+   std::vector<unsigned long>
+   ClockStability::factors(TauSet set, unsigned long mMax) throw()
+   {
+      std::vector<unsigned long> m;
+      if (set == All)
+      {
+         for (unsigned long i=1; i<=mMax; i++)
+            m.push_back(i);
+      }
+      else if (set == Octave)
+      {
+         for (unsigned long i=1; i<=mMax; i*=2)
+            m.push_back(i);
+      }
+      else
+      {
+            // 1, 2, 5, 10, 20, 50, ...
+         for (unsigned long d=1; d<=mMax; d*=10)
+         {
+            m.push_back(d);
+            if (2*d <= mMax)
+               m.push_back(2*d);
+            if (5*d <= mMax)
+               m.push_back(5*d);
+         }
+      }
+      return m;
+   }
+
+
+   ClockStability::Point ClockStability::compute(Statistic stat,
+                                                 unsigned long m) const
+      throw(Exception)
+   {
+      if (m < 1 || m > maxFactor(stat))
+      {
+         Exception e("Averaging factor out of range.");
+         GPSTK_THROW(e);
+      }
+
+      switch (stat)
+      {
+         case ADEV:
+            return adev(m);
+         case MDEV:
+            return mdev(m);
+         case TDEV:
+         {
+            Point p = mdev(m);
+            p.deviation *= p.tau / sqrt(3.0);
+            return p;
+         }
+         case HDEV:
+            return hdev(m);
+         case TOTDEV:
+            return totdev(m);
+      }
+      return Point();
+   }
+
+
+   std::vector<ClockStability::Point>
+   ClockStability::compute(Statistic stat, TauSet set) const
+      throw(Exception)
+   {
+      return compute(stat, factors(stat, set));
+   }
+
+
+   std::vector<ClockStability::Point>
+   ClockStability::compute(Statistic stat,
+                           const std::vector<unsigned long>& m) const
+      throw(Exception)
+   {
+      std::vector<Point> curve;
+      curve.reserve(m.size());
+      for (size_t i=0; i<m.size(); i++)
+         curve.push_back(compute(stat, m[i]));
+      return curve;
+   }
+
+
+      // sigma^2 = Sum((x[i+2m]-2x[i+m]+x[i])^2) / (2 (N-gaps-2m) tau^2)
+      // Terms with a zero phase are gaps, except the first and last ones.
+   ClockStability::Point ClockStability::adev(unsigned long m) const
+   {
+      const unsigned long N = x.size(), n = N-2*m;
+      Point p;
+      p.m = m;
+      p.tau = m*tau0;
+      p.numGaps = 0;
+
+      double sigma = 0;
+      for (unsigned long i=0; i<n; i++)
+      {
+         if (hasGaps && (x[i+2*m]==0 || x[i+m]==0 || x[i]==0)
+             && i!=0 && i!=n-1)
+         {
+            p.numGaps++;
+            continue;
+         }
+         double d = x[i+2*m] - 2*x[i+m] + x[i];
+         sigma += d*d;
+      }
+
+      sigma /= 2.0*((double)N-(double)p.numGaps-2.0*m)*p.tau*p.tau;
+      p.deviation = sqrt(sigma);
+      return p;
+   }
+
+
+      // sigma^2 = Sum_j((Sum_{i=j}^{j+m-1} x[i+2m]-2x[i+m]+x[i])^2)
+      //           / (2 m^2 (N-gaps-3m+1) tau^2)
+      // The inner sums are differences of cumulative sums of the second
+      // differences, so each point costs O(N) instead of O(N m).  Within
+      // each window, terms with a zero phase are gaps except the last one
+      // and the one at i=0.
+   ClockStability::Point ClockStability::mdev(unsigned long m) const
+   {
+      const unsigned long N = x.size(), n = N-2*m, windows = N-3*m+1;
+      Point p;
+      p.m = m;
+      p.tau = m*tau0;
+      p.numGaps = 0;
+
+         // ds[k] and gs[k] are the sums of the second differences (skipping
+         // gaps) and of the gap flags for i < k
+      std::vector<long double> ds(n+1);
+      std::vector<unsigned long> gs(n+1);
+      ds[0] = 0;
+      gs[0] = 0;
+      for (unsigned long i=0; i<n; i++)
+      {
+         bool gap = hasGaps && (x[i+2*m]==0 || x[i+m]==0 || x[i]==0)
+            && i!=0;
+         ds[i+1] = ds[i];
+         gs[i+1] = gs[i];
+         if (gap)
+            gs[i+1]++;
+         else
+            ds[i+1] += x[i+2*m] - 2*x[i+m] + x[i];
+      }
+
+      double sigma = 0;
+      for (unsigned long j=0; j<windows; j++)
+      {
+         unsigned long last = j+m-1;
+         double sum = (double)(ds[last] - ds[j])
+            + (x[last+2*m] - 2*x[last+m] + x[last]);
+         p.numGaps += gs[last] - gs[j];
+         sigma += sum*sum;
+      }
+
+      sigma /= 2.0*p.tau*p.tau*m*m
+         *((double)N-(double)p.numGaps-3.0*m+1);
+      p.deviation = sqrt(sigma);
+      return p;
+   }
+
+
+      // sigma^2 = Sum((x[i+3m]-3x[i+2m]+3x[i+m]-x[i])^2)
+      //           / (6 (N-gaps-3m) tau^2)
+   ClockStability::Point ClockStability::hdev(unsigned long m) const
+   {
+      const unsigned long N = x.size(), n = N-3*m;
+      Point p;
+      p.m = m;
+      p.tau = m*tau0;
+      p.numGaps = 0;
+
+      double sigma = 0;
+      for (unsigned long i=0; i<n; i++)
+      {
+         if (hasGaps && (x[i+3*m]==0 || x[i+2*m]==0 || x[i+m]==0 || x[i]==0)
+             && i!=0 && i!=n-1)
+         {
+            p.numGaps++;
+            continue;
+         }
+         double d = x[i+3*m] - 3*x[i+2*m] + 3*x[i+m] - x[i];
+         sigma += d*d;
+      }
+
+      sigma /= 6.0*((double)N-(double)p.numGaps-3.0*m)*p.tau*p.tau;
+      p.deviation = sqrt(sigma);
+      return p;
+   }
+
+
+      // The phase is extended by N-2 points at each end, reflected about
+      // the end points (see reflected()).  The extension is not stored so
+      // that computing TOTDEV doesn't change the object.
+      // sigma^2 = Sum_{i=1}^{N-2}((x[i-m]-2x[i]+x[i+m])^2)
+      //           / (2 (N-2) tau^2)
+   ClockStability::Point ClockStability::totdev(unsigned long m) const
+   {
+      const long N = x.size();
+      Point p;
+      p.m = m;
+      p.tau = m*tau0;
+      p.numGaps = 0;
+
+      double sigma = 0;
+      for (long i=1; i<N-1; i++)
+      {
+         double d = reflected(i-(long)m) - 2*x[i] + reflected(i+(long)m);
+         sigma += d*d;
+      }
+
+      sigma /= 2.0*((double)N-2.0)*p.tau*p.tau;
+      p.deviation = sqrt(sigma);
+      return p;
+   }
+
+
+   StreamingStability::StreamingStability(double t0,
+                                          ClockStability::TauSet set,
+                                          unsigned long mMax)
+         : tau0(t0)
+   {
+      init(ClockStability::factors(set, mMax));
+   }
+
+
+   StreamingStability::StreamingStability(double t0,
+                                          const std::vector<unsigned long>& m)
+         : tau0(t0)
+   {
+      init(m);
+   }
+
+
+   void StreamingStability::init(const std::vector<unsigned long>& m)
+   {
+      unsigned long mMax = 0;
+      acc.resize(m.size());
+      for (size_t i=0; i<m.size(); i++)
+      {
+         acc[i].m = m[i];
+         acc[i].diff.resize(m[i]);
+         if (m[i] > mMax)
+            mMax = m[i];
+      }
+
+         // The oldest sample used is x[n-3m]
+      unsigned long size = 1;
+      while (size < 3*mMax+1)
+         size <<= 1;
+      ring.resize(size);
+      mask = size-1;
+
+      clear();
+   }
+
+
+   void StreamingStability::clear() throw()
+   {
+      n = 0;
+      for (size_t i=0; i<acc.size(); i++)
+      {
+         Accumulator& a = acc[i];
+         a.sumA = a.sumH = a.sumM = 0;
+         a.numA = a.numH = a.numM = 0;
+         a.diffSum = 0;
+      }
+   }
+
+
+   void StreamingStability::add(double phase) throw()
+   {
+      ring[n & mask] = phase;
+
+      for (size_t i=0; i<acc.size(); i++)
+      {
+         Accumulator& a = acc[i];
+         const unsigned long m = a.m;
+         if (m == 0 || n < 2*m)
+            continue;
+
+         double xm = ring[(n-m) & mask], x2m = ring[(n-2*m) & mask];
+         double d = phase - 2*xm + x2m;
+         a.sumA += d*d;
+         a.numA++;
+
+            // Moving sum of the last m second differences; it is summed
+            // again each time the buffer wraps so that rounding errors
+            // do not build up
+         unsigned long k = (n-2*m) % m;
+         double old = a.diff[k];
+         a.diff[k] = d;
+         if (k == m-1)
+         {
+            a.diffSum = 0;
+            for (unsigned long j=0; j<m; j++)
+               a.diffSum += a.diff[j];
+         }
+         else
+         {
+            a.diffSum += d;
+            if (a.numA > m)
+               a.diffSum -= old;
+         }
+         if (a.numA >= m)
+         {
+            double s = a.diffSum;
+            a.sumM += s*s;
+            a.numM++;
+         }
+
+         if (n >= 3*m)
+         {
+            double h = phase - 3*xm + 3*x2m - ring[(n-3*m) & mask];
+            a.sumH += h*h;
+            a.numH++;
+         }
+      }
+
+      n++;
+   }
+
+
+   std::vector<ClockStability::Point>
+   StreamingStability::compute(ClockStability::Statistic stat) const
+      throw(Exception)
+   {
+      if (stat == ClockStability::TOTDEV)
+      {
+         Exception e("The total deviation can't be computed incrementally.");
+         GPSTK_THROW(e);
+      }
+
+      std::vector<ClockStability::Point> curve;
+      for (size_t i=0; i<acc.size(); i++)
+      {
+         const Accumulator& a = acc[i];
+         ClockStability::Point p;
+         p.m = a.m;
+         p.tau = a.m*tau0;
+         p.numGaps = 0;
+
+         double t2 = p.tau*p.tau;
+         switch (stat)
+         {
+            case ClockStability::ADEV:
+               if (a.numA == 0)
+                  continue;
+               p.deviation = sqrt(a.sumA / (2.0*a.numA*t2));
+               break;
+            case ClockStability::MDEV:
+            case ClockStability::TDEV:
+               if (a.numM == 0)
+                  continue;
+               p.deviation = sqrt(a.sumM / (2.0*t2*a.m*a.m*a.numM));
+               if (stat == ClockStability::TDEV)
+                  p.deviation *= p.tau / sqrt(3.0);
+               break;
+            default:
+               if (a.numH == 0)
+                  continue;
+               p.deviation = sqrt(a.sumH / (6.0*a.numH*t2));
+               break;
+         }
+         curve.push_back(p);
+      }
+      return curve;
+   }
+
+}  // namespace
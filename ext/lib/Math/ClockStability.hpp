@@ -0,0 +1,289 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file ClockStability.hpp
+ * Frequency stability analysis (Allan, modified Allan, Hadamard, time
+ * and total deviations) of clock phase data.
+ */
+
+#ifndef GPSTK_CLOCKSTABILITY_HPP
+#define GPSTK_CLOCKSTABILITY_HPP
+
+#include <vector>
+
+#include "Exception.hpp"
+
+namespace gpstk
+{
+   /// @ingroup math 
+   //@{
+
+      /** Frequency stability analysis of clock phase data.
+       *
+       * This class computes the usual stability statistics of a series
+       * of N phase (time error) samples x[i] taken every tau0 seconds,
+       * at averaging times tau = m*tau0:
+       *
+       * - ADEV, overlapping Allan deviation:
+       *   sigma^2 = Sum((x[i+2m]-2x[i+m]+x[i])^2) / (2 (N-2m) tau^2)
+       * - MDEV, modified Allan deviation:
+       *   sigma^2 = Sum_j((Sum_{i=j}^{j+m-1} x[i+2m]-2x[i+m]+x[i])^2)
+       *             / (2 m^2 (N-3m+1) tau^2)
+       * - HDEV, overlapping Hadamard deviation:
+       *   sigma^2 = Sum((x[i+3m]-3x[i+2m]+3x[i+m]-x[i])^2) / (6 (N-3m) tau^2)
+       * - TDEV, time deviation: tau * MDEV / sqrt(3)
+       * - TOTDEV, total deviation: the ADEV of the phase data extended
+       *   at both ends by reflection, with N-2 terms.
+       *
+       * Each deviation is computed in O(N) operations; the inner sums of
+       * MDEV are obtained from cumulative sums instead of being summed
+       * again for each term.  The cost of a whole curve therefore
+       * depends on the set of averaging factors: with All it is
+       * O(N^2), while with Octave or Decade it is
+       * O(N log N), which makes long series (e.g. a month of 1 s data)
+       * practical.
+       *
+       * As in the clocktools applications, a phase value of exactly 0
+       * marks a gap: terms (other than the first and the last one)
+       * involving it are dropped and the normalization is reduced
+       * accordingly.  Gaps are not considered for TOTDEV.
+       *
+       * The computations only read the phase data, so a const
+       * ClockStability may be shared between threads.
+       *
+       * @code
+       *   ClockStability cs(phase, 1.0);
+       *   std::vector<ClockStability::Point> adev;
+       *   adev = cs.compute(ClockStability::ADEV, ClockStability::Octave);
+       * @endcode
+       *
+       * @sa StreamingStability to update the statistics as samples
+       *   arrive.
+       */
+   class ClockStability
+   {
+   public:
+
+         /// Statistics that can be computed.
+      enum Statistic
+      {
+         ADEV,       ///< Overlapping Allan deviation
+         MDEV,       ///< Modified Allan deviation
+         HDEV,       ///< Overlapping Hadamard deviation
+         TDEV,       ///< Time deviation
+         TOTDEV      ///< Total deviation
+      };
+
+         /// Sets of averaging factors.
+      enum TauSet
+      {
+         Octave,     ///< m = 1, 2, 4, 8, ...
+         Decade,     ///< m = 1, 2, 5, 10, 20, 50, ...
+         All         ///< every m from 1 to the maximum
+      };
+
+         /// One point of a stability curve.
+      struct Point
+      {
+         unsigned long m;        ///< Averaging factor
+         double tau;             ///< Averaging time, m*tau0
+         double deviation;       ///< Value of the statistic
+         unsigned long numGaps;  ///< Terms dropped because of gaps
+      };
+
+         /** Constructor.
+          * @param[in] phase Phase samples, in seconds.
+          * @param[in] tau0 Sampling interval, in seconds.
+          * @throw Exception if there are fewer than 3 samples. */
+      ClockStability(const std::vector<double>& phase, double tau0)
+         throw(Exception);
+
+         /// Return the number of phase samples.
+      unsigned long size() const throw()
+      { return x.size(); }
+
+         /// Return the largest averaging factor usable for stat.
+      unsigned long maxFactor(Statistic stat) const throw();
+
+         /// Return the averaging factors of a set, up to maxFactor(stat).
+      std::vector<unsigned long> factors(Statistic stat, TauSet set) const
+         throw()
+      { return factors(set, maxFactor(stat)); }
+
+         /// Return the averaging factors of a set, up to mMax.
+      static std::vector<unsigned long> factors(TauSet set,
+                                                unsigned long mMax)
+         throw();
+
+         /** Compute a single point of a stability curve.
+          * @param[in] stat The statistic to compute.
+          * @param[in] m The averaging factor, 1 to maxFactor(stat).
+          * @throw Exception if m is out of range. */
+      Point compute(Statistic stat, unsigned long m) const
+         throw(Exception);
+
+         /// Compute a stability curve over a set of averaging factors.
+      std::vector<Point> compute(Statistic stat, TauSet set) const
+         throw(Exception);
+
+         /// Compute a stability curve over the given averaging factors.
+      std::vector<Point> compute(Statistic stat,
+                                 const std::vector<unsigned long>& m) const
+         throw(Exception);
+
+   private:
+
+         /// Phase samples
+      std::vector<double> x;
+         /// Sampling interval
+      double tau0;
+         /// True if any sample is a gap (zero)
+      bool hasGaps;
+
+         /** Return the phase extended at both ends by reflection, for
+          * TOTDEV: x[-k] = 2x[0]-x[k] and x[N-1+k] = 2x[N-1]-x[N-1-k].
+          * @param[in] i Index of the sample, -(N-2) to 2N-3. */
+      double reflected(long i) const
+      {
+         const long last = x.size()-1;
+         if (i < 0)
+            return 2*x[0] - x[-i];
+         if (i > last)
+            return 2*x[last] - x[2*last-i];
+         return x[i];
+      }
+
+      Point adev(unsigned long m) const;
+      Point mdev(unsigned long m) const;
+      Point hdev(unsigned long m) const;
+      Point totdev(unsigned long m) const;
+   };
+
+
+      /** Frequency stability statistics updated as phase samples
+       * arrive.
+       *
+       * Only the last 3*mMax+1 samples are kept, plus m second
+       * differences for each averaging factor m, and each new sample
+       * costs O(1) per averaging factor.  After N samples the results
+       * are the same as those of ClockStability for the same N
+       * samples, except that gaps are not handled: every sample,
+       * including zeros, is used.  TOTDEV is not available since it
+       * needs the whole series.
+       *
+       * @code
+       *   StreamingStability ss(1.0, ClockStability::Octave, 1024);
+       *   while (readPhase(x))
+       *   {
+       *      ss.add(x);
+       *   }
+       *   std::vector<ClockStability::Point> adev;
+       *   adev = ss.compute(ClockStability::ADEV);
+       * @endcode
+       */
+   class StreamingStability
+   {
+   public:
+
+         /** Constructor.
+          * @param[in] tau0 Sampling interval, in seconds.
+          * @param[in] set The set of averaging factors to track.
+          * @param[in] mMax The largest averaging factor to track. */
+      StreamingStability(double tau0,
+                         ClockStability::TauSet set,
+                         unsigned long mMax);
+
+         /** Constructor.
+          * @param[in] tau0 Sampling interval, in seconds.
+          * @param[in] m The averaging factors to track. */
+      StreamingStability(double tau0, const std::vector<unsigned long>& m);
+
+         /// Add the next phase sample, in seconds.
+      void add(double phase) throw();
+
+         /// Forget all the samples added.
+      void clear() throw();
+
+         /// Return the number of samples added.
+      unsigned long size() const throw()
+      { return n; }
+
+         /** Return the statistic for the tracked averaging factors
+          * that have enough samples.
+          * @throw Exception if stat is TOTDEV. */
+      std::vector<ClockStability::Point>
+      compute(ClockStability::Statistic stat) const
+         throw(Exception);
+
+   private:
+
+         /// Running sums of one averaging factor.
+      struct Accumulator
+      {
+         unsigned long m;
+            /// Sum and count of squared second differences (ADEV)
+         long double sumA;
+         unsigned long numA;
+            /// Sum and count of squared third differences (HDEV)
+         long double sumH;
+         unsigned long numH;
+            /// Sum and count of squared window sums (MDEV)
+         long double sumM;
+         unsigned long numM;
+            /// Last m second differences and their sum
+         std::vector<double> diff;
+         long double diffSum;
+      };
+
+      void init(const std::vector<unsigned long>& m);
+
+      double tau0;
+         /// Samples added so far
+      unsigned long n;
+         /// Last samples, the size is a power of two
+      std::vector<double> ring;
+      unsigned long mask;
+      std::vector<Accumulator> acc;
+   };
+
+
+   //@}
+
+}  // namespace
+
+#endif
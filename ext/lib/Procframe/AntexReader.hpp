@@ -300,6 +300,11 @@ namespace gpstk
       { return valid; };
 
 
+         /// Returns the name of the Antex file.
+      std::string getFileName() const
+      { return fileName; };
+
+
          /// Returns version of Antex file.
       double getVersion() const
       { return version; };
@@ -64,9 +64,6 @@ namespace gpstk
       try
       {
 
-         double value1(0.0);
-         double value2(0.0);
-
          SatIDSet satRejectedSet;
 
             // Loop through all the satellites
@@ -74,24 +71,15 @@ namespace gpstk
          for( it = gData.begin(); it != gData.end(); ++it ) 
          {
 
-            try
-            {
-                  // Try to extract the values
-               value1 = (*it).second(type1);
-               value2 = (*it).second(type2);
-            }
-            catch(...)
+               // If some value is missing, schedule this satellite
+               // for removal
+            if( !processSatellite( CommonTime::BEGINNING_OF_TIME,
+                                   (*it).first,
+                                   (*it).second ) )
             {
-                  // If some value is missing, schedule this satellite
-                  // for removal
                satRejectedSet.insert( (*it).first );
-               continue;
             }
 
-               // If everything is OK, then get the new value inside
-               // the structure
-            (*it).second[resultType] = getCombination(value1, value2);
-
          }
 
             // Remove satellites with missing data
@@ -98,6 +98,37 @@ namespace gpstk
       { Process(gData.body); return gData; };
 
 
+         /** Computes the combination for a single satellite, adding the
+          *  result to its typeValueMap. It returns false if some of the
+          *  needed values is missing, and then the satellite should be
+          *  removed.
+          *
+          * Process() is just a loop calling this method, which is also used
+          * by StaticProcessingChain to fuse the satellite loops of several
+          * objects.
+          *
+          * @param time      Epoch corresponding to the data.
+          * @param sat       Satellite the data belongs to.
+          * @param tvMap     Data values of this satellite.
+          */
+      virtual bool processSatellite( const CommonTime& time,
+                                     const SatID& sat,
+                                     typeValueMap& tvMap )
+      {
+         typeValueMap::const_iterator it1( tvMap.find(type1) );
+         typeValueMap::const_iterator it2( tvMap.find(type2) );
+
+         if( it1 == tvMap.end() || it2 == tvMap.end() )
+         {
+            return false;
+         }
+
+         tvMap[resultType] = getCombination( (*it1).second, (*it2).second );
+
+         return true;
+      };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
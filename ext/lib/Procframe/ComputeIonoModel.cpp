@@ -77,8 +77,40 @@ namespace gpstk
          Position rxPos(nominalPos[0],nominalPos[1],nominalPos[2],
             Position::Cartesian);
 
-            // Loop through all the satellites
          satTypeValueMap::iterator stv;
+
+            // The Klobuchar model is evaluated for all the satellites in
+            // a single call, in the order of the loop below
+         std::vector<double> klbCorr;
+         size_t klbIndex(0);
+         if(ionoType == Klobuchar)
+         {
+            std::vector<double> elevations, azimuths;
+            for(stv = gData.begin(); stv != gData.end(); ++stv)
+            {
+               typeValueMap::const_iterator itElev(
+                                    stv->second.find(TypeID::elevation) );
+               typeValueMap::const_iterator itAzim(
+                                    stv->second.find(TypeID::azimuth) );
+               if( itElev == stv->second.end() ||
+                   itAzim == stv->second.end() )
+               {
+                  continue;
+               }
+
+               elevations.push_back(itElev->second);
+               azimuths.push_back(itAzim->second);
+            }
+
+               // with no satellites to correct, do not look for the model,
+               // which may not be there
+            if(!elevations.empty())
+            {
+               klbStore.getCorrections(time,rxPos,elevations,azimuths,klbCorr);
+            }
+         }
+
+            // Loop through all the satellites
          for(stv = gData.begin(); stv != gData.end(); ++stv) 
          {
 
@@ -132,7 +164,7 @@ namespace gpstk
             }
             else if(ionoType == Klobuchar)
             {
-               ionL1 = klbStore.getCorrection(time,rxPos,elevation,azimuth);
+               ionL1 = klbCorr[klbIndex++];
             }
             else if(ionoType == DualFreq)
             {
@@ -75,39 +75,20 @@ namespace gpstk
       try
       {
 
-         double value1(0.0);
-         double value2(0.0);
-         double value3(0.0);
-         double value4(0.0);
-
          SatIDSet satRejectedSet;
 
             // Loop through all the satellites
          satTypeValueMap::iterator it;
          for (it = gData.begin(); it != gData.end(); ++it) 
          {
-            try
-            {
-                  // Try to extract the values
-               value1 = (*it).second(type1);
-               value2 = (*it).second(type2);
-               value3 = (*it).second(type3);
-               value4 = (*it).second(type4);
-            }
-            catch(...)
+               // If some value is missing, then schedule this satellite
+               // for removal
+            if( !processSatellite( CommonTime::BEGINNING_OF_TIME,
+                                   (*it).first,
+                                   (*it).second ) )
             {
-                  // If some value is missing, then schedule this satellite
-                  // for removal
                satRejectedSet.insert( (*it).first );
-               continue;
             }
-
-               // If everything is OK, then get the new value inside
-               // the structure
-            (*it).second[resultType] = getCombination( value1,
-                                                       value2,
-                                                       value3,
-                                                       value4 );
          }
 
             // Remove satellites with missing data
@@ -130,6 +111,41 @@ namespace gpstk
 
 
 
+      /* Computes the combination for a single satellite, adding the
+       * result to its typeValueMap. It returns false if some of the
+       * needed values is missing.
+       *
+       * @param time      Epoch corresponding to the data.
+       * @param sat       Satellite the data belongs to.
+       * @param tvMap     Data values of this satellite.
+       */
+   bool ComputeMelbourneWubbena::processSatellite( const CommonTime& time,
+                                                   const SatID& sat,
+                                                   typeValueMap& tvMap )
+   {
+
+      typeValueMap::const_iterator it1( tvMap.find(type1) );
+      typeValueMap::const_iterator it2( tvMap.find(type2) );
+      typeValueMap::const_iterator it3( tvMap.find(type3) );
+      typeValueMap::const_iterator it4( tvMap.find(type4) );
+
+      if( it1 == tvMap.end() || it2 == tvMap.end() ||
+          it3 == tvMap.end() || it4 == tvMap.end() )
+      {
+         return false;
+      }
+
+      tvMap[resultType] = getCombination( (*it1).second,
+                                          (*it2).second,
+                                          (*it3).second,
+                                          (*it4).second );
+
+      return true;
+
+   }  // End of method 'ComputeMelbourneWubbena::processSatellite()'
+
+
+
       // Compute the combination of observables.
    double ComputeMelbourneWubbena::getCombination( const double& p1,
                                                    const double& p2,
@@ -109,6 +109,19 @@ namespace gpstk
          throw(ProcessingException);
 
 
+         /** Computes the combination for a single satellite, adding the
+          *  result to its typeValueMap. It returns false if some of the
+          *  needed values is missing.
+          *
+          * @param time      Epoch corresponding to the data.
+          * @param sat       Satellite the data belongs to.
+          * @param tvMap     Data values of this satellite.
+          */
+      virtual bool processSatellite( const CommonTime& time,
+                                     const SatID& sat,
+                                     typeValueMap& tvMap );
+
+
          /// Some Rinex data files provide C1 instead of P1. Use this method
          /// in those cases.
       virtual ComputeMelbourneWubbena& useC1(void)
@@ -41,6 +41,8 @@
  */
 
 #include "ComputeSatPCenter.hpp"
+#include "AntexStream.hpp"
+#include "AntexHeader.hpp"
 
 using namespace std;
 
@@ -67,8 +69,7 @@ namespace gpstk
       {
 
             // Compute Sun position at this epoch
-         SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(time));
+         Triple sunPos( SatContextStore::getSunPosition(pSatContext, time) );
 
             // Define a Triple that will hold satellite position, in ECEF
          Triple svPos(0.0, 0.0, 0.0);
@@ -231,7 +232,7 @@ namespace gpstk
       if( absoluteModel )
       {
 
-            // We will need the elevation, in degrees. It is found using
+            // We will need the nadir angle, in degrees. It is found using
             // dot product and the corresponding unitary angles
 
          double nadir = std::acos( rrho.dot(rk) ) * RAD_TO_DEG;
@@ -243,36 +244,30 @@ namespace gpstk
             // http://igscb.jpl.nasa.gov/igscb/resource/pubs/02_ott/session_8.pdf
          nadir = (nadir>14) ? 14.0 : nadir;
 
-         double elev( 90.0 - nadir );
-
             // Get satellite information in Antex format. Currently this
             // only works for GPS and Glonass.
-         if( satid.system == SatID::systemGPS )
+         if( ( satid.system == SatID::systemGPS ) ||
+             ( satid.system == SatID::systemGlonass ) )
          {
-            std::stringstream sat;
-            sat << "G";
-            if( satid.id < 10 )
-            {
-               sat << "0";
-            }
-            sat << satid.id;
-
-               // Get satellite antenna information out of AntexReader object
-            Antenna antenna( pAntexReader->getAntenna( sat.str(), time ) );
 
-               // Get antenna eccentricity for frequency "G01" (L1), in
-               // satellite reference system.
-               // NOTE: It is NOT in ECEF, it is in UEN!!!
-            Triple satAnt( antenna.getAntennaEccentricity( Antenna::G01) );
+               // Get satellite antenna information, for frequency "G01" (L1)
+               // or "R01" (Glonass)
+            const AntexData& antenna( getSatAntenna(satid, time) );
+            const std::string freq( (satid.system == SatID::systemGPS) ?
+                                    "G01" : "R01" );
 
-               // Now, get the phase center variation.
-            Triple var( antenna.getAntennaPCVariation( Antenna::G01, elev) );
+               // Get antenna eccentricity, in millimeters, in satellite
+               // reference system (X, Y, Z).
+               // NOTE: It is NOT in ECEF!!!
+            Triple satAnt( antenna.getPhaseCenterOffset(freq) );
 
-               // We must substract them
-            satAnt = satAnt - var;
+               // Now, get the phase center variation, and substract it along
+               // the Z axis. Satellite PCVs are not azimuth dependent.
+            satAnt[2] -= antenna.getPhaseCenterVariation(freq, 0.0, nadir);
 
-                  // Change to ECEF
-            Triple svAntenna( satAnt[2]*ri + satAnt[1]*rj + satAnt[0]*rk );
+               // Change to ECEF, in meters
+            Triple svAntenna( 0.001 * ( satAnt[0]*ri + satAnt[1]*rj
+                                        + satAnt[2]*rk ) );
 
                // Projection of "svAntenna" vector to line of sight vector rrho
             svPCcorr =  (rrho.dot(svAntenna));
@@ -280,45 +275,9 @@ namespace gpstk
          }
          else
          {
-               // Check if this satellite belongs to Glonass system
-            if( satid.system == SatID::systemGlonass )
-            {
-               std::stringstream sat;
-               sat << "R";
-               if( satid.id < 10 )
-               {
-                  sat << "0";
-               }
-               sat << satid.id;
-
-                  // Get satellite antenna information out of AntexReader object
-               Antenna antenna( pAntexReader->getAntenna( sat.str(), time ) );
-
-                  // Get antenna offset for frequency "R01" (Glonass), in
-                  // satellite reference system.
-                  // NOTE: It is NOT in ECEF, it is in UEN!!!
-               Triple satAnt( antenna.getAntennaEccentricity( Antenna::R01) );
-
-                  // Now, get the phase center variation.
-               Triple var( antenna.getAntennaPCVariation( Antenna::R01, elev) );
-
-                  // We must substract them
-               satAnt = satAnt - var;
-
-                     // Change to ECEF
-               Triple svAntenna( satAnt[2]*ri + satAnt[1]*rj + satAnt[0]*rk );
-
-                  // Project "svAntenna" vector to line of sight vector rrho
-               svPCcorr = (rrho.dot(svAntenna));
-
-            }
-            else
-            {
-                  // In this case no correction will be computed
-               svPCcorr = 0.0;
-            }
-
-         }  // End of 'if( satid.system == SatID::systemGPS )...'
+               // In this case no correction will be computed
+            svPCcorr = 0.0;
+         }
 
       }
       else
@@ -369,4 +328,79 @@ namespace gpstk
 
 
 
+      /* Returns the antenna data of a satellite at a given epoch: the first
+       * antenna of the Antex file that is valid at that epoch, as
+       * AntexReader::getAntenna() would find.
+       *
+       * @param satid     Satellite ID
+       * @param time      Epoch of interest
+       */
+   const AntexData& ComputeSatPCenter::getSatAntenna( const SatID& satid,
+                                                      const CommonTime& time )
+      throw(ObjectNotFound)
+   {
+
+         // Read the satellite antennas of the Antex file, once. Searching
+         // the file, as AntexReader does, is too slow for every epoch.
+      if( !satAntennasLoaded )
+      {
+
+         satAntennas.clear();
+
+         AntexStream strm( pAntexReader->getFileName().c_str() );
+         AntexHeader header;
+         strm >> header;
+
+         AntexData antenna;
+         while( strm >> antenna )
+         {
+
+            if( !antenna.isValid() || antenna.isRxAntenna || antenna.PRN <= 0 )
+            {
+               continue;
+            }
+
+            if( antenna.systemChar == 'G' )
+            {
+               satAntennas[ SatID(antenna.PRN, SatID::systemGPS) ]
+                  .push_back(antenna);
+            }
+            else if( antenna.systemChar == 'R' )
+            {
+               satAntennas[ SatID(antenna.PRN, SatID::systemGlonass) ]
+                  .push_back(antenna);
+            }
+
+         }  // End of 'while( strm >> antenna )'
+
+         satAntennasLoaded = true;
+
+      }  // End of 'if( !satAntennasLoaded )'
+
+         // Validity epochs in Antex files have no time system
+      CommonTime epoch(time);
+      epoch.setTimeSystem(TimeSystem::Any);
+
+      std::map< SatID, std::vector<AntexData> >::const_iterator it(
+                                                   satAntennas.find(satid) );
+      if( it != satAntennas.end() )
+      {
+         for( size_t i = 0; i < (*it).second.size(); i++ )
+         {
+            if( (*it).second[i].isValid(epoch) )
+            {
+               return (*it).second[i];
+            }
+         }
+      }
+
+      std::ostringstream oss;
+      oss << "No antenna data for satellite " << satid;
+      ObjectNotFound e(oss.str());
+      GPSTK_THROW(e);
+
+   }  // End of method 'ComputeSatPCenter::getSatAntenna()'
+
+
+
 }  // End of namespace gpstk
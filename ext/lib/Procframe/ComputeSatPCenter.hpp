@@ -46,13 +46,17 @@
 #include <cmath>
 #include <string>
 #include <sstream>
+#include <map>
+#include <vector>
 #include "ProcessingClass.hpp"
 #include "Triple.hpp"
 #include "Position.hpp"
 #include "SunPosition.hpp"
+#include "SatContextStore.hpp"
 #include "XvtStore.hpp"
 #include "SatDataReader.hpp"
 #include "AntexReader.hpp"
+#include "AntexData.hpp"
 #include "GNSSconstants.hpp"
 #include "StringUtils.hpp"
 
@@ -103,6 +107,11 @@ namespace gpstk
        * Be warned that if a given satellite does not have the required data,
        * it will be summarily deleted from the data structure.
        *
+       * When an AntexReader with absolute antenna data is given, the
+       * satellite antennas of its Antex file are read once, on first use,
+       * and indexed by satellite; phase center variations are evaluated on
+       * the regular grid of each AntexData (see AntexData::PCVGrid).
+       *
        * \warning The ComputeSatPCenter objects generate corrections that are
        * interpreted as an "advance" in the signal, instead of a delay.
        * Therefore, those corrections always hava a negative sign.
@@ -115,7 +124,8 @@ namespace gpstk
          /// Default constructor
       ComputeSatPCenter()
          : pEphemeris(NULL), nominalPos(0.0, 0.0, 0.0),
-           satData("PRN_GPS"), fileData("PRN_GPS"), pAntexReader(NULL)
+           satData("PRN_GPS"), fileData("PRN_GPS"), pAntexReader(NULL),
+           satAntennasLoaded(false), pSatContext(NULL)
       { };
 
 
@@ -133,7 +143,8 @@ namespace gpstk
                          const Position& stapos,
                          std::string filename="PRN_GPS" )
          : pEphemeris(&ephem), nominalPos(stapos), satData(filename),
-           fileData(filename), pAntexReader(NULL)
+           fileData(filename), pAntexReader(NULL),
+           satAntennasLoaded(false), pSatContext(NULL)
       { };
 
 
@@ -149,7 +160,8 @@ namespace gpstk
       ComputeSatPCenter( const Position& stapos,
                          std::string filename="PRN_GPS" )
          : pEphemeris(NULL), nominalPos(stapos), satData(filename),
-           fileData(filename), pAntexReader(NULL)
+           fileData(filename), pAntexReader(NULL),
+           satAntennasLoaded(false), pSatContext(NULL)
       { };
 
 
@@ -166,7 +178,8 @@ namespace gpstk
       ComputeSatPCenter( XvtStore<SatID>& ephem,
                          const Position& stapos,
                          AntexReader& antexObj )
-         : pEphemeris(&ephem), nominalPos(stapos), pAntexReader(&antexObj)
+         : pEphemeris(&ephem), nominalPos(stapos), pAntexReader(&antexObj),
+           satAntennasLoaded(false), pSatContext(NULL)
       { };
 
 
@@ -181,7 +194,8 @@ namespace gpstk
           */
       ComputeSatPCenter( const Position& stapos,
                          AntexReader& antexObj )
-         : pEphemeris(NULL), nominalPos(stapos), pAntexReader(&antexObj)
+         : pEphemeris(NULL), nominalPos(stapos), pAntexReader(&antexObj),
+           satAntennasLoaded(false), pSatContext(NULL)
       { };
 
 
@@ -264,7 +278,22 @@ namespace gpstk
           *                  antenna data.
           */
       virtual ComputeSatPCenter& setAntexReader(AntexReader& antexObj)
-      { pAntexReader = &antexObj; return (*this); };
+      { pAntexReader = &antexObj; satAntennasLoaded = false; return (*this); };
+
+
+         /// Returns a pointer to the shared satellite context currently in
+         /// use, or NULL if Sun positions are computed by this object.
+      virtual SatContextStore *getSatContext(void) const
+      { return pSatContext; };
+
+
+         /** Sets a shared satellite context to take Sun positions from.
+          *
+          * @param context   SatContextStore object shared with other
+          *                  processing objects and stations.
+          */
+      virtual ComputeSatPCenter& setSatContext(SatContextStore& context)
+      { pSatContext = &context; return (*this); };
 
 
          /// Returns a string identifying this object.
@@ -298,6 +327,18 @@ namespace gpstk
       AntexReader* pAntexReader;
 
 
+         /// Satellite antennas of the Antex file, in file order, per satellite
+      std::map< SatID, std::vector<AntexData> > satAntennas;
+
+
+         /// True if satAntennas holds the antennas of pAntexReader's file
+      bool satAntennasLoaded;
+
+
+         /// Shared satellite context, if any.
+      SatContextStore *pSatContext;
+
+
          /** Compute the value of satellite antenna phase correction, in meters
           * @param satid     Satellite ID
           * @param time      Epoch of interest
@@ -312,6 +353,18 @@ namespace gpstk
                                     const Triple& sunPosition );
 
 
+         /** Returns the antenna data of a satellite at a given epoch: the
+          *  first antenna of the Antex file that is valid at that epoch,
+          *  as AntexReader::getAntenna() would find.
+          *
+          * @param satid     Satellite ID
+          * @param time      Epoch of interest
+          */
+      const AntexData& getSatAntenna( const SatID& satid,
+                                      const CommonTime& time )
+         throw(ObjectNotFound);
+
+
    }; // End of class 'ComputeSatPCenter'
 
       //@}
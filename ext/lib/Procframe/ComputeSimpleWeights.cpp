@@ -68,18 +68,6 @@ namespace gpstk
       try
       {
 
-            // If we are using a 5th order Taylor-based differencing filter, the
-            // corresponding scale factor to convert from covariance matrix to
-            // double-differenced covariance matrix is 1.509551839.
-         double scaleFact( 1.509551839 );
-
-            // Declare some important constants
-         double tropoVar( 0.0004 );    // (0.02 m)^2
-         double multiVar( 0.000025 );  // (0.005 m)^2
-
-            // We need a NBTropModel initialized with dummy values
-         NBTropModel tropoObj(0.0, 0.0, 1);
-
          SatIDSet satRejectedSet;
 
 
@@ -89,31 +77,13 @@ namespace gpstk
               ++it )
          {
 
-            double elevP( 0.0 );
-
-            try
+               // If some value is missing, then schedule this satellite
+               // for removal
+            if( !processSatellite(time, (*it).first, (*it).second) )
             {
-               elevP = gData.getValue( (*it).first, TypeID::elevation );
-            }
-            catch(...)
-            {
-
-                  // If some value is missing, then schedule this satellite
-                  // for removal
                satRejectedSet.insert( (*it).first );
-
-               continue;
-
             }
 
-               // If everything is OK, then compute the weight value and
-               // put it into the GDS structure
-            double mt( tropoObj.dry_mapping_function(elevP) );
-
-            double weight( 1.0 / ( scaleFact*( mt*mt*tropoVar + multiVar ) ) );
-
-            (*it).second[TypeID::weight] = weight;
-
          }
 
             // Remove satellites with missing data
@@ -136,6 +106,48 @@ namespace gpstk
 
 
 
+      /* Computes the weight of a single satellite, adding it to its
+       * typeValueMap. It returns false if the satellite elevation is
+       * missing.
+       *
+       * @param time      Epoch corresponding to the data.
+       * @param sat       Satellite the data belongs to.
+       * @param tvMap     Data values of this satellite.
+       */
+   bool ComputeSimpleWeights::processSatellite( const CommonTime& time,
+                                                const SatID& sat,
+                                                typeValueMap& tvMap )
+   {
+
+         // If we are using a 5th order Taylor-based differencing filter, the
+         // corresponding scale factor to convert from covariance matrix to
+         // double-differenced covariance matrix is 1.509551839.
+      const double scaleFact( 1.509551839 );
+
+         // Declare some important constants
+      const double tropoVar( 0.0004 );    // (0.02 m)^2
+      const double multiVar( 0.000025 );  // (0.005 m)^2
+
+      typeValueMap::const_iterator itElev( tvMap.find(TypeID::elevation) );
+      if( itElev == tvMap.end() )
+      {
+         return false;
+      }
+
+         // If everything is OK, then compute the weight value and
+         // put it into the GDS structure
+      double mt( tropoObj.dry_mapping_function( (*itElev).second ) );
+
+      double weight( 1.0 / ( scaleFact*( mt*mt*tropoVar + multiVar ) ) );
+
+      tvMap[TypeID::weight] = weight;
+
+      return true;
+
+   }  // End of method 'ComputeSimpleWeights::processSatellite()'
+
+
+
       /* Returns a gnnsSatTypeValue object, adding the new data
        * generated when calling this object.
        *
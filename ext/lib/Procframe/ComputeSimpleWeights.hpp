@@ -99,6 +99,7 @@ namespace gpstk
 
          /// Default constructor.
       ComputeSimpleWeights()
+         : tropoObj(0.0, 0.0, 1)
       { };
 
 
@@ -113,6 +114,19 @@ namespace gpstk
          throw(ProcessingException);
 
 
+         /** Computes the weight of a single satellite, adding it to its
+          *  typeValueMap. It returns false if the satellite elevation is
+          *  missing, and then the satellite should be removed.
+          *
+          * @param time      Epoch corresponding to the data.
+          * @param sat       Satellite the data belongs to.
+          * @param tvMap     Data values of this satellite.
+          */
+      virtual bool processSatellite( const CommonTime& time,
+                                     const SatID& sat,
+                                     typeValueMap& tvMap );
+
+
          /** Returns a gnnsSatTypeValue object, adding the new data
           *  generated when calling this object.
           *
@@ -146,6 +160,11 @@ namespace gpstk
       Position nominalPos;
 
 
+         /// A NBTropModel initialized with dummy values, used to get the
+         /// dry mapping function.
+      NBTropModel tropoObj;
+
+
    }; // End of class 'ComputeSimpleWeights'
 
       //@}
@@ -70,71 +70,78 @@ namespace gpstk
 
          SatIDSet satRejectedSet;
 
-            // Loop through all the satellites
+            // Gather the elevations of all the satellites, so that the
+            // model is evaluated for all of them in a single call.
+            // Satellites without elevation are removed.
+         std::vector<SatID> sats;
+         std::vector<double> elevations;
          satTypeValueMap::iterator stv;
-         for(stv = gData.begin(); stv != gData.end(); ++stv) 
+         for(stv = gData.begin(); stv != gData.end(); ++stv)
          {
-
-            // First check if TropModel was set
-            if(pTropModel==NULL)
+            typeValueMap::const_iterator itElev(
+                                    (*stv).second.find(TypeID::elevation) );
+            if( pTropModel == NULL || itElev == (*stv).second.end() )
             {
-                  // If TropModel is missing, then remove all satellites
                satRejectedSet.insert( (*stv).first );
                continue;
             }
 
-               // If satellite elevation is missing, remove satellite
-            if( (*stv).second.find(TypeID::elevation) == (*stv).second.end() )
+            sats.push_back( (*stv).first );
+            elevations.push_back( (*itElev).second );
+
+         }  // End of loop 'for(stv = gData.begin()...'
+
+         if( !sats.empty() )
+         {
+            std::vector<double> tropoCorr, dryMap, wetMap;
+            double dryZDelay(0.0), wetZDelay(0.0);
+            bool ok(true);
+
+            try
             {
-               satRejectedSet.insert( (*stv).first );
-               continue;
+                  // Compute tropospheric slant corrections
+               pTropModel->corrections(elevations, tropoCorr, dryMap, wetMap);
+               dryZDelay = pTropModel->dry_zenith_delay();
+               wetZDelay = pTropModel->wet_zenith_delay();
+
+                  // Check validity
+               if( !(pTropModel->isValid()) )
+               {
+                  tropoCorr.assign(sats.size(), 0.0);
+                  dryMap.assign(sats.size(), 0.0);
+                  wetMap.assign(sats.size(), 0.0);
+                  dryZDelay = 0.0;
+                  wetZDelay = 0.0;
+               }
             }
-            else
+            catch(InvalidTropModel& e)
             {
+                  // The model may fail for some elevations only, so fall
+                  // back to one satellite at a time, and only remove the
+                  // satellites it fails for
+               ok = false;
+            }
 
-                  // Scalar to hold satellite elevation
-               double elevation( (*stv).second(TypeID::elevation) );
-               double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
-               double dryMap(0.0), wetMap(0.0);
-
-               try
+            for(size_t i = 0; i < sats.size(); ++i)
+            {
+               if(!ok)
                {
-                     // Compute tropospheric slant correction
-                  tropoCorr = pTropModel->correction(elevation);
-                  dryZDelay = pTropModel->dry_zenith_delay();
-                  wetZDelay = pTropModel->wet_zenith_delay();
-                  dryMap = pTropModel->dry_mapping_function(elevation);
-                  wetMap = pTropModel->wet_mapping_function(elevation);
-
-                     // Check validity
-                  if( !(pTropModel->isValid()) )
+                  if( !processSatellite(time, sats[i], gData[sats[i]]) )
                   {
-                     tropoCorr = 0.0;
-                     dryZDelay = 0.0;
-                     wetZDelay = 0.0;
-                     dryMap    = 0.0;
-                     wetMap    = 0.0;
+                     satRejectedSet.insert(sats[i]);
                   }
-
+                  continue;
                }
-               catch(InvalidTropModel& e)
-               {
-                     // If some problem appears, then schedule this
-                     // satellite for removal
-                  satRejectedSet.insert( (*stv).first );
-                  continue;    // Skip this SV if problems arise
-               };
 
                   // Now we have to add the new values to the data structure
-               (*stv).second[TypeID::tropoSlant] = tropoCorr;
-               (*stv).second[TypeID::dryTropo] = dryZDelay;
-               (*stv).second[TypeID::wetTropo] = wetZDelay;
-               (*stv).second[TypeID::dryMap] = dryMap;
-               (*stv).second[TypeID::wetMap] = wetMap;
-
+               typeValueMap& tvMap(gData[sats[i]]);
+               tvMap[TypeID::tropoSlant] = tropoCorr[i];
+               tvMap[TypeID::dryTropo] = dryZDelay;
+               tvMap[TypeID::wetTropo] = wetZDelay;
+               tvMap[TypeID::dryMap] = dryMap[i];
+               tvMap[TypeID::wetMap] = wetMap[i];
             }
-
-         }  // End of loop 'for(stv = gData.begin()...'
+         }
 
             // Remove satellites with missing data
          gData.removeSatID(satRejectedSet);
@@ -155,4 +162,75 @@ namespace gpstk
    } // End ComputeTropModel::Process()
 
 
+
+      /* Computes the tropospheric values for a single satellite,
+       * adding them to its typeValueMap. It returns false if the
+       * satellite elevation is missing, the TropModel was not set or the
+       * model raised an error.
+       *
+       * @param time      Epoch corresponding to the data.
+       * @param sat       Satellite the data belongs to.
+       * @param tvMap     Data values of this satellite.
+       */
+   bool ComputeTropModel::processSatellite( const CommonTime& time,
+                                            const SatID& sat,
+                                            typeValueMap& tvMap )
+   {
+
+         // First check if TropModel was set
+      if(pTropModel==NULL)
+      {
+         return false;
+      }
+
+         // If satellite elevation is missing, remove satellite
+      typeValueMap::const_iterator itElev( tvMap.find(TypeID::elevation) );
+      if( itElev == tvMap.end() )
+      {
+         return false;
+      }
+
+         // Scalar to hold satellite elevation
+      double elevation( (*itElev).second );
+      double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
+      double dryMap(0.0), wetMap(0.0);
+
+      try
+      {
+            // Compute tropospheric slant correction
+         tropoCorr = pTropModel->correction(elevation);
+         dryZDelay = pTropModel->dry_zenith_delay();
+         wetZDelay = pTropModel->wet_zenith_delay();
+         dryMap = pTropModel->dry_mapping_function(elevation);
+         wetMap = pTropModel->wet_mapping_function(elevation);
+
+            // Check validity
+         if( !(pTropModel->isValid()) )
+         {
+            tropoCorr = 0.0;
+            dryZDelay = 0.0;
+            wetZDelay = 0.0;
+            dryMap    = 0.0;
+            wetMap    = 0.0;
+         }
+
+      }
+      catch(InvalidTropModel& e)
+      {
+            // If some problem appears, then this satellite must be removed
+         return false;
+      };
+
+         // Now we have to add the new values to the data structure
+      tvMap[TypeID::tropoSlant] = tropoCorr;
+      tvMap[TypeID::dryTropo] = dryZDelay;
+      tvMap[TypeID::wetTropo] = wetZDelay;
+      tvMap[TypeID::dryMap] = dryMap;
+      tvMap[TypeID::wetMap] = wetMap;
+
+      return true;
+
+   } // End ComputeTropModel::processSatellite()
+
+
 } // End of namespace gpstk
@@ -159,6 +159,21 @@ namespace gpstk
       { Process(gData.header.epoch, gData.body); return gData; };
 
 
+         /** Computes the tropospheric values for a single satellite,
+          *  adding them to its typeValueMap. It returns false if the
+          *  satellite elevation is missing, the TropModel was not set or the
+          *  model raised an error, and then the satellite should be
+          *  removed.
+          *
+          * @param time      Epoch corresponding to the data.
+          * @param sat       Satellite the data belongs to.
+          * @param tvMap     Data values of this satellite.
+          */
+      virtual bool processSatellite( const CommonTime& time,
+                                     const SatID& sat,
+                                     typeValueMap& tvMap );
+
+
          /// Method to get a pointer to the default TropModel to be used
          /// with GNSS data structures.
       virtual TropModel *getTropModel() const
@@ -68,8 +68,7 @@ namespace gpstk
       {
 
             // Compute Sun position at this epoch
-         SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(time));
+         Triple sunPos( SatContextStore::getSunPosition(pSatContext, time) );
 
             // Define a Triple that will hold satellite position, in ECEF
          Triple svPos(0.0, 0.0, 0.0);
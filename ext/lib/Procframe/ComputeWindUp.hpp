@@ -48,6 +48,7 @@
 #include "Triple.hpp"
 #include "Position.hpp"
 #include "SunPosition.hpp"
+#include "SatContextStore.hpp"
 #include "XvtStore.hpp"
 #include "SatDataReader.hpp"
 #include "GNSSconstants.hpp"
@@ -115,7 +116,7 @@ namespace gpstk
          /// Default constructor
       ComputeWindUp()
          : pEphemeris(NULL), nominalPos(0.0, 0.0, 0.0),
-           satData("PRN_GPS"), fileData("PRN_GPS")
+           satData("PRN_GPS"), fileData("PRN_GPS"), pSatContext(NULL)
       { };
 
 
@@ -133,7 +134,7 @@ namespace gpstk
                      const Position& stapos,
                      std::string filename="PRN_GPS" )
          : pEphemeris(&ephem), nominalPos(stapos), satData(filename),
-           fileData(filename)
+           fileData(filename), pSatContext(NULL)
       { };
 
 
@@ -204,6 +205,21 @@ namespace gpstk
       { pEphemeris = &ephem; return (*this); };
 
 
+         /// Returns a pointer to the shared satellite context currently in
+         /// use, or NULL if Sun positions are computed by this object.
+      virtual SatContextStore *getSatContext(void) const
+      { return pSatContext; };
+
+
+         /** Sets a shared satellite context to take Sun positions from.
+          *
+          * @param context   SatContextStore object shared with other
+          *                  processing objects and stations.
+          */
+      virtual ComputeWindUp& setSatContext(SatContextStore& context)
+      { pSatContext = &context; return (*this); };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -231,6 +247,10 @@ namespace gpstk
       std::string fileData;
 
 
+         /// Shared satellite context, if any.
+      SatContextStore *pSatContext;
+
+
          /// A structure used to store phase data.
       struct phaseData
       {
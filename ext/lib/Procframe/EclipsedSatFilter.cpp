@@ -114,8 +114,7 @@ namespace gpstk
          double threshold( std::cos(PI - coneAngle/2.0*DEG_TO_RAD) );
 
             // Compute Sun position at this epoch, and store it in a Triple
-         SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(epoch));
+         Triple sunPos( SatContextStore::getSunPosition(pSatContext, epoch) );
 
             // Define a Triple that will hold satellite position, in ECEF
          Triple svPos(0.0, 0.0, 0.0);
@@ -46,6 +46,7 @@
 #include <math.h>
 #include "Triple.hpp"
 #include "SunPosition.hpp"
+#include "SatContextStore.hpp"
 #include "Position.hpp"
 #include "ProcessingClass.hpp"
 #include "GNSSconstants.hpp"                   // DEG_TO_RAD
@@ -114,7 +115,8 @@ namespace gpstk
       public:
 
          /// Default constructor.
-      EclipsedSatFilter() : coneAngle(30.0), postShadowPeriod(1800.0)
+      EclipsedSatFilter()
+         : coneAngle(30.0), postShadowPeriod(1800.0), pSatContext(NULL)
       { };
 
 
@@ -126,7 +128,7 @@ namespace gpstk
           */
       EclipsedSatFilter( const double angle,
                          const double pShTime )
-         : coneAngle(angle), postShadowPeriod(pShTime)
+         : coneAngle(angle), postShadowPeriod(pShTime), pSatContext(NULL)
       { };
 
 
@@ -188,6 +190,21 @@ namespace gpstk
       virtual EclipsedSatFilter& setPostShadowPeriod(const double pShTime);
 
 
+         /// Returns a pointer to the shared satellite context currently in
+         /// use, or NULL if Sun positions are computed by this object.
+      virtual SatContextStore *getSatContext(void) const
+      { return pSatContext; };
+
+
+         /** Sets a shared satellite context to take Sun positions from.
+          *
+          * @param context   SatContextStore object shared with other
+          *                  processing objects and stations.
+          */
+      virtual EclipsedSatFilter& setSatContext(SatContextStore& context)
+      { pSatContext = &context; return (*this); };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -206,6 +223,9 @@ namespace gpstk
          /// filtered out, in seconds.
       double postShadowPeriod;
 
+         /// Shared satellite context, if any.
+      SatContextStore *pSatContext;
+
          /// Map holding the time information about every satellite in eclipse
       std::map<SatID, CommonTime> shadowEpoch;
 
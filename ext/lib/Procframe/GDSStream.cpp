@@ -0,0 +1,1171 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file GDSStream.cpp
+ * Binary file stream to store and replay GNSS Data Structures.
+ */
+
+#include "GDSStream.hpp"
+#include "BinUtils.hpp"
+#include <algorithm>
+
+
+namespace gpstk
+{
+
+   namespace
+   {
+
+         // File header: magic, version and flags
+      const char gdsMagic[4] = { 'G', 'D', 'S', 'B' };
+      const size_t headerSize = 8;
+
+         // Record tags
+      const char tagType    = 'T';
+      const char tagSat     = 'S';
+      const char tagSource  = 'O';
+      const char tagAntenna = 'A';
+      const char tagData    = 'D';
+
+         // Kinds of source inside a data record
+      const unsigned char kindPlain = 0;
+      const unsigned char kindRinex = 1;
+
+         // Epoch flags
+      const unsigned char epochHasFsod = 1;
+
+      const int64_t millisPerDay = 86400000;
+
+
+         // Appends an unsigned integer as a base-128 varint
+      inline void putVar(std::string& b, uint64_t v)
+      {
+         while( v >= 0x80 )
+         {
+            b += static_cast<char>( (v & 0x7f) | 0x80 );
+            v >>= 7;
+         }
+         b += static_cast<char>(v);
+      }
+
+
+         // Appends a signed integer as a zig-zag varint
+      inline void putSVar(std::string& b, int64_t v)
+      {
+         putVar( b, ( static_cast<uint64_t>(v) << 1 ) ^
+                    static_cast<uint64_t>( v >> 63 ) );
+      }
+
+
+         // Appends a double in little-endian IEEE format
+      inline void putDouble(std::string& b, double v)
+      {
+         char buf[8];
+         BinUtils::buhtoid(buf, v);
+         b.append(buf, 8);
+      }
+
+
+         // Appends a string preceded by its length
+      inline void putString(std::string& b, const std::string& s)
+      {
+         putVar(b, s.size());
+         b += s;
+      }
+
+
+         // Throws the error for a malformed record
+      void malformed(const std::string& what)
+         throw(FFStreamError)
+      {
+         FFStreamError e("Malformed GDS record: " + what);
+         GPSTK_THROW(e);
+      }
+
+
+         // Reads an unsigned varint
+      uint64_t getVar(const std::string& b, size_t& pos)
+         throw(FFStreamError)
+      {
+         uint64_t v(0);
+         for( unsigned shift = 0; shift < 64; shift += 7 )
+         {
+            if( pos >= b.size() )
+            {
+               break;
+            }
+
+            unsigned char c( static_cast<unsigned char>(b[pos++]) );
+            v |= static_cast<uint64_t>(c & 0x7f) << shift;
+
+            if( !(c & 0x80) )
+            {
+               return v;
+            }
+         }
+
+         malformed("bad integer");
+         return 0;
+      }
+
+
+         // Reads a signed zig-zag varint
+      inline int64_t getSVar(const std::string& b, size_t& pos)
+         throw(FFStreamError)
+      {
+         uint64_t v( getVar(b, pos) );
+         return static_cast<int64_t>( (v >> 1) ^ (~(v & 1) + 1) );
+      }
+
+
+         // Reads a little-endian IEEE double
+      inline double getDouble(const std::string& b, size_t& pos)
+         throw(FFStreamError)
+      {
+         if( pos + 8 > b.size() )
+         {
+            malformed("truncated value");
+         }
+
+         double v;
+         BinUtils::buitohd(b.data() + pos, v);
+         pos += 8;
+         return v;
+      }
+
+
+         // Reads a byte
+      inline unsigned char getByte(const std::string& b, size_t& pos)
+         throw(FFStreamError)
+      {
+         if( pos >= b.size() )
+         {
+            malformed("truncated value");
+         }
+
+         return static_cast<unsigned char>(b[pos++]);
+      }
+
+
+         // Reads a string preceded by its length
+      std::string getString(const std::string& b, size_t& pos)
+         throw(FFStreamError)
+      {
+         uint64_t n( getVar(b, pos) );
+         if( n > b.size() - pos )
+         {
+            malformed("truncated string");
+         }
+
+         std::string s( b, pos, n );
+         pos += n;
+         return s;
+      }
+
+
+         // Checks a table index read from the file
+      inline size_t checkIndex(uint64_t i, size_t size, const char* table)
+         throw(FFStreamError)
+      {
+         if( i >= size )
+         {
+            malformed( std::string("undefined ") + table + " index" );
+         }
+
+         return static_cast<size_t>(i);
+      }
+
+
+         // Checks the index of a table entry being defined. Entries are
+         // defined in order, so it is at most the size of the table
+      inline size_t checkNewIndex(uint64_t i, size_t size, const char* table)
+         throw(FFStreamError)
+      {
+         if( i > size )
+         {
+            malformed( std::string("out of order ") + table + " index" );
+         }
+
+         return static_cast<size_t>(i);
+      }
+
+
+         // Size of the pieces a record is read in
+      const size_t recordChunk = 65536;
+
+   }  // End of anonymous namespace
+
+
+
+   const uint16_t GDSStream::formatVersion = 1;
+
+
+
+      // Default constructor
+   GDSStream::GDSStream()
+   {
+      init(std::ios::in);
+   }
+
+
+
+      /* Common constructor. When opened for output the file is
+       * truncated and a new header is written; when opened for input
+       * the header is read and checked. If it is not a GDS header of
+       * a supported version, the stream is set to fail state and
+       * reading from it throws FFStreamError.
+       *
+       * @param fn      File name.
+       * @param mode    File open mode.
+       */
+   GDSStream::GDSStream( const char* fn,
+                         std::ios::openmode mode )
+      : FFBinaryStream(fn, mode)
+   {
+      init(mode);
+   }
+
+
+
+      // Destructor
+   GDSStream::~GDSStream()
+   {
+   }
+
+
+
+      // Overrides open to write or check the file header.
+   void GDSStream::open( const char* fn,
+                         std::ios::openmode mode )
+   {
+      FFBinaryStream::open(fn, mode);
+      init(mode);
+   }
+
+
+
+      /* Resets the tables and writes or checks the header. If the
+       * header is not valid, the stream is set to fail state and
+       * later reads throw FFStreamError.
+       */
+   void GDSStream::init(std::ios::openmode mode)
+   {
+
+      typeIndex.clear();
+      satIndex.clear();
+      sourceIndex.clear();
+      antennaIndex.clear();
+      types.clear();
+      sats.clear();
+      sources.clear();
+      antennas.clear();
+      index.clear();
+      indexed = false;
+      badHeader = false;
+      lastMillis = 0;
+      sourcesLeft = 0;
+      bufPos = 0;
+
+      if( !is_open() )
+      {
+         return;
+      }
+
+      char head[headerSize];
+
+      if( mode & std::ios::out )
+      {
+         std::copy(gdsMagic, gdsMagic + 4, head);
+         BinUtils::buhtois(head, formatVersion, 4);
+         BinUtils::buhtois(head, uint16_t(0), 6);
+         writeData(head, headerSize);
+         return;
+      }
+
+      uint16_t version(0);
+      if( readRaw(head, headerSize) == headerSize )
+      {
+         BinUtils::buitohs(head, version, 4);
+      }
+
+      if( !std::equal(gdsMagic, gdsMagic + 4, head) ||
+          version == 0                             ||
+          version > formatVersion )
+      {
+         badHeader = true;
+         setstate(std::ios::failbit);
+      }
+
+   }  // End of method 'GDSStream::init()'
+
+
+
+      // Reads up to 'n' bytes, returning how many were read.
+   size_t GDSStream::readRaw(char* p, size_t n)
+   {
+
+         // Reaching end of file must not raise the stream exceptions the
+         // user may have enabled: it is reported by the return value
+      try
+      {
+         read(p, n);
+      }
+      catch(std::exception& e)
+      {
+      }
+
+      return static_cast<size_t>( gcount() );
+
+   }  // End of method 'GDSStream::readRaw()'
+
+
+
+      // Writes a record made of 'tag' and 'payload'.
+   void GDSStream::putRecord(char tag, const std::string& payload)
+      throw(FFStreamError)
+   {
+
+      char head[5];
+      head[0] = tag;
+      BinUtils::buhtoil(head, static_cast<uint32_t>( payload.size() ), 1);
+
+      writeData(head, 5);
+      writeData(payload.data(), payload.size());
+
+   }  // End of method 'GDSStream::putRecord()'
+
+
+
+      /* Reads the next record into 'buffer'. It returns false at end
+       * of file.
+       *
+       * @param tag     Tag of the record.
+       */
+   bool GDSStream::getRecord(char& tag)
+      throw(FFStreamError)
+   {
+
+      char head[5];
+      size_t got( readRaw(head, 5) );
+
+      if( got == 0 )
+      {
+         return false;
+      }
+
+      if( got < 5 )
+      {
+         FFStreamError e("Truncated GDS record header");
+         GPSTK_THROW(e);
+      }
+
+      tag = head[0];
+      uint32_t length;
+      BinUtils::buitohl(head, length, 1);
+
+      bufPos = 0;
+      buffer.clear();
+
+         // The length comes from the file, so the buffer only grows as
+         // the data is read: a corrupt length can't ask for more memory
+         // than the file holds
+      while( buffer.size() < length )
+      {
+         size_t have( buffer.size() );
+         size_t n( std::min<size_t>(length - have, recordChunk) );
+         buffer.resize(have + n);
+         if( readRaw(&buffer[have], n) < n )
+         {
+            malformed("record longer than the file");
+         }
+      }
+
+      return true;
+
+   }  // End of method 'GDSStream::getRecord()'
+
+
+
+      /* Reads records until a data record is found, and decodes its
+       * epoch into 'lastEpoch'. It returns false at end of file.
+       */
+   bool GDSStream::getDataRecord(void)
+      throw(FFStreamError)
+   {
+
+      checkHeader();
+
+      char tag;
+      while( getRecord(tag) )
+      {
+         if( tag == tagData )
+         {
+            lastEpoch = decodeEpoch(lastMillis);
+            sourcesLeft = static_cast<size_t>( getVar(buffer, bufPos) );
+            return true;
+         }
+
+         decodeDictionary(tag);
+      }
+
+      sourcesLeft = 0;
+
+      return false;
+
+   }  // End of method 'GDSStream::getDataRecord()'
+
+
+
+      // Decodes a dictionary record held in 'buffer'.
+   void GDSStream::decodeDictionary(char tag)
+      throw(FFStreamError)
+   {
+
+      size_t pos(0);
+
+      switch( tag )
+      {
+
+         case tagType:
+         {
+            size_t i( checkNewIndex( getVar(buffer, pos), types.size(),
+                                        "type" ) );
+            TypeID::ValueType vt(
+                        static_cast<TypeID::ValueType>(getSVar(buffer, pos)) );
+            std::string desc( getString(buffer, pos) );
+
+               // User-defined types may have another value in this
+               // program, so the description is the key
+            std::map<TypeID::ValueType, std::string>::const_iterator it(
+                                                   TypeID::tStrings.find(vt) );
+            if( it == TypeID::tStrings.end() || it->second != desc )
+            {
+               vt = TypeID::Unknown;
+               for( it = TypeID::tStrings.begin();
+                    it != TypeID::tStrings.end();
+                    ++it )
+               {
+                  if( it->second == desc )
+                  {
+                     vt = it->first;
+                     break;
+                  }
+               }
+
+               if( vt == TypeID::Unknown )
+               {
+                  vt = TypeID::newValueType(desc);
+               }
+            }
+
+            if( types.size() <= i )
+            {
+               types.resize(i + 1);
+            }
+            types[i] = TypeID(vt);
+
+            break;
+         }
+
+         case tagSat:
+         {
+            size_t i( checkNewIndex( getVar(buffer, pos), sats.size(),
+                                        "satellite" ) );
+            SatID::SatelliteSystem sys(
+                  static_cast<SatID::SatelliteSystem>(getVar(buffer, pos)) );
+            int id( static_cast<int>( getSVar(buffer, pos) ) );
+
+            if( sats.size() <= i )
+            {
+               sats.resize(i + 1);
+            }
+            sats[i] = SatID(id, sys);
+
+            break;
+         }
+
+         case tagSource:
+         {
+            size_t i( checkNewIndex( getVar(buffer, pos), sources.size(),
+                                        "source" ) );
+            SourceID::SourceType st(
+                  static_cast<SourceID::SourceType>(getVar(buffer, pos)) );
+            std::string name( getString(buffer, pos) );
+
+            if( sources.size() <= i )
+            {
+               sources.resize(i + 1);
+            }
+            sources[i] = SourceID(st, name);
+
+            break;
+         }
+
+         case tagAntenna:
+         {
+            size_t i( checkNewIndex( getVar(buffer, pos), antennas.size(),
+                                        "antenna" ) );
+            std::string type( getString(buffer, pos) );
+            double x( getDouble(buffer, pos) );
+            double y( getDouble(buffer, pos) );
+            double z( getDouble(buffer, pos) );
+
+            if( antennas.size() <= i )
+            {
+               antennas.resize(i + 1);
+            }
+            antennas[i] = AntennaData( type, Triple(x, y, z) );
+
+            break;
+         }
+
+            // Records unknown to this version are skipped
+         default:
+            break;
+
+      }  // End of 'switch( tag )'
+
+   }  // End of method 'GDSStream::decodeDictionary()'
+
+
+
+      // Index of 'type' in the table, adding it if needed.
+   size_t GDSStream::putType(const TypeID& type)
+      throw(FFStreamError)
+   {
+
+      std::map<TypeID, size_t>::const_iterator it( typeIndex.find(type) );
+      if( it != typeIndex.end() )
+      {
+         return it->second;
+      }
+
+      size_t i( typeIndex.size() );
+      typeIndex[type] = i;
+
+      dictBuffer.clear();
+      putVar(dictBuffer, i);
+      putSVar(dictBuffer, type.type);
+      putString(dictBuffer, TypeID::tStrings[type.type]);
+      putRecord(tagType, dictBuffer);
+
+      return i;
+
+   }  // End of method 'GDSStream::putType()'
+
+
+
+      // Index of 'sat' in the table, adding it if needed.
+   size_t GDSStream::putSat(const SatID& sat)
+      throw(FFStreamError)
+   {
+
+      std::map<SatID, size_t>::const_iterator it( satIndex.find(sat) );
+      if( it != satIndex.end() )
+      {
+         return it->second;
+      }
+
+      size_t i( satIndex.size() );
+      satIndex[sat] = i;
+
+      dictBuffer.clear();
+      putVar(dictBuffer, i);
+      putVar(dictBuffer, sat.system);
+      putSVar(dictBuffer, sat.id);
+      putRecord(tagSat, dictBuffer);
+
+      return i;
+
+   }  // End of method 'GDSStream::putSat()'
+
+
+
+      // Index of 'source' in the table, adding it if needed.
+   size_t GDSStream::putSource(const SourceID& source)
+      throw(FFStreamError)
+   {
+
+      std::map<SourceID, size_t>::const_iterator it(
+                                                   sourceIndex.find(source) );
+      if( it != sourceIndex.end() )
+      {
+         return it->second;
+      }
+
+      size_t i( sourceIndex.size() );
+      sourceIndex[source] = i;
+
+      dictBuffer.clear();
+      putVar(dictBuffer, i);
+      putVar(dictBuffer, source.type);
+      putString(dictBuffer, source.sourceName);
+      putRecord(tagSource, dictBuffer);
+
+      return i;
+
+   }  // End of method 'GDSStream::putSource()'
+
+
+
+      // Index of antenna data in the table, adding it if needed.
+   size_t GDSStream::putAntenna( const std::string& type,
+                                 const Triple& position )
+      throw(FFStreamError)
+   {
+
+         // The encoded record itself is the key, so that antennas match
+         // bit for bit
+      dictBuffer.clear();
+      putString(dictBuffer, type);
+      putDouble(dictBuffer, position[0]);
+      putDouble(dictBuffer, position[1]);
+      putDouble(dictBuffer, position[2]);
+
+      std::map<std::string, size_t>::const_iterator it(
+                                             antennaIndex.find(dictBuffer) );
+      if( it != antennaIndex.end() )
+      {
+         return it->second;
+      }
+
+      size_t i( antennaIndex.size() );
+      antennaIndex[dictBuffer] = i;
+
+      std::string record;
+      putVar(record, i);
+      record += dictBuffer;
+      putRecord(tagAntenna, record);
+
+      return i;
+
+   }  // End of method 'GDSStream::putAntenna()'
+
+
+
+      // Starts a data record in 'buffer' with the delta-coded epoch.
+   void GDSStream::beginData(const CommonTime& epoch, size_t numSources)
+   {
+
+      long day, msod;
+      double fsod;
+      TimeSystem sys;
+      epoch.getInternal(day, msod, fsod, sys);
+
+      int64_t millis( static_cast<int64_t>(day) * millisPerDay + msod );
+
+      buffer.clear();
+      buffer += static_cast<char>( fsod != 0.0 ? epochHasFsod : 0 );
+      putSVar(buffer, millis - lastMillis);
+      putVar(buffer, sys.getTimeSystem());
+      if( fsod != 0.0 )
+      {
+         putDouble(buffer, fsod);
+      }
+      putVar(buffer, numSources);
+
+      lastMillis = millis;
+
+   }  // End of method 'GDSStream::beginData()'
+
+
+
+      // Appends a satTypeValueMap to the data record in 'buffer'.
+   void GDSStream::encodeBody(const satTypeValueMap& body)
+      throw(FFStreamError)
+   {
+
+      putVar(buffer, body.size());
+
+      for( satTypeValueMap::const_iterator it = body.begin();
+           it != body.end();
+           ++it )
+      {
+         putVar(buffer, putSat(it->first));
+         putVar(buffer, it->second.size());
+
+         for( typeValueMap::const_iterator itt = it->second.begin();
+              itt != it->second.end();
+              ++itt )
+         {
+            putVar(buffer, putType(itt->first));
+            putDouble(buffer, itt->second);
+         }
+      }
+
+   }  // End of method 'GDSStream::encodeBody()'
+
+
+
+      /* Decodes the epoch at 'bufPos', coded relative to 'reference'
+       * which is then updated.
+       */
+   CommonTime GDSStream::decodeEpoch(int64_t& reference)
+      throw(FFStreamError)
+   {
+
+      unsigned char flags( getByte(buffer, bufPos) );
+      int64_t millis( reference + getSVar(buffer, bufPos) );
+      TimeSystem sys( static_cast<int>( getVar(buffer, bufPos) ) );
+      double fsod( (flags & epochHasFsod) ? getDouble(buffer, bufPos) : 0.0 );
+
+      int64_t day( millis / millisPerDay );
+      int64_t msod( millis % millisPerDay );
+      if( msod < 0 )
+      {
+         msod += millisPerDay;
+         --day;
+      }
+
+      reference = millis;
+
+      CommonTime epoch;
+      try
+      {
+         epoch.setInternal(day, msod, fsod, sys);
+      }
+      catch(Exception& u)
+      {
+         malformed("bad epoch");
+      }
+
+      return epoch;
+
+   }  // End of method 'GDSStream::decodeEpoch()'
+
+
+
+      /* Decodes the next source of the current data record. When
+       * 'rinex' is not null, the RINEX header data is stored there.
+       */
+   void GDSStream::decodeSource( SourceID& source,
+                                 sourceEpochRinexHeader* rinex,
+                                 satTypeValueMap& body )
+      throw(FFStreamError)
+   {
+
+      source = sources[ checkIndex( getVar(buffer, bufPos),
+                                    sources.size(),
+                                    "source" ) ];
+
+      if( getByte(buffer, bufPos) == kindRinex )
+      {
+         const AntennaData& ant( antennas[ checkIndex( getVar(buffer, bufPos),
+                                                       antennas.size(),
+                                                       "antenna" ) ] );
+         short flag( static_cast<short>( getSVar(buffer, bufPos) ) );
+
+         if( rinex != 0 )
+         {
+            rinex->antennaType = ant.first;
+            rinex->antennaPosition = ant.second;
+            rinex->epochFlag = flag;
+         }
+      }
+
+      body.clear();
+
+      size_t numSats( getVar(buffer, bufPos) );
+      for( size_t i = 0; i < numSats; ++i )
+      {
+         const SatID& sat( sats[ checkIndex( getVar(buffer, bufPos),
+                                             sats.size(),
+                                             "satellite" ) ] );
+
+            // Data was written in order, so hinted insertion is O(1)
+         typeValueMap& tvMap( body.insert( body.end(),
+                              std::make_pair(sat, typeValueMap()) )->second );
+
+         size_t numTypes( getVar(buffer, bufPos) );
+         for( size_t j = 0; j < numTypes; ++j )
+         {
+            const TypeID& type( types[ checkIndex( getVar(buffer, bufPos),
+                                                   types.size(),
+                                                   "type" ) ] );
+            tvMap.insert( tvMap.end(),
+                          std::make_pair( type, getDouble(buffer, bufPos) ) );
+         }
+      }
+
+      --sourcesLeft;
+
+   }  // End of method 'GDSStream::decodeSource()'
+
+
+
+      /* Writes a gnssSatTypeValue object.
+       *
+       * @param gds     Data to be written.
+       */
+   void GDSStream::writeGnssSatTypeValue(const gnssSatTypeValue& gds)
+      throw(FFStreamError)
+   {
+
+      size_t src( putSource(gds.header.source) );
+
+      beginData(gds.header.epoch, 1);
+      putVar(buffer, src);
+      buffer += static_cast<char>(kindPlain);
+      encodeBody(gds.body);
+
+      putRecord(tagData, buffer);
+
+   }  // End of method 'GDSStream::writeGnssSatTypeValue()'
+
+
+
+      /* Writes a gnssRinex object, including its RINEX header data
+       * (antenna type and position and epoch flag).
+       *
+       * @param gds     Data to be written.
+       */
+   void GDSStream::writeGnssRinex(const gnssRinex& gds)
+      throw(FFStreamError)
+   {
+
+         // Dictionary records must precede the data record using them
+      size_t src( putSource(gds.header.source) );
+      size_t ant( putAntenna( gds.header.antennaType,
+                              gds.header.antennaPosition ) );
+
+      beginData(gds.header.epoch, 1);
+      putVar(buffer, src);
+      buffer += static_cast<char>(kindRinex);
+      putVar(buffer, ant);
+      putSVar(buffer, gds.header.epochFlag);
+      encodeBody(gds.body);
+
+      putRecord(tagData, buffer);
+
+   }  // End of method 'GDSStream::writeGnssRinex()'
+
+
+
+      /* Writes a gnssDataMap object. Each epoch entry of the map
+       * becomes a data record holding all of its sources.
+       *
+       * @param gds     Data to be written.
+       */
+   void GDSStream::writeGnssDataMap(const gnssDataMap& gds)
+      throw(FFStreamError)
+   {
+
+      gnssDataMap::const_iterator it( gds.begin() );
+      while( it != gds.end() )
+      {
+            // Entries sharing the epoch go to the same record
+         const CommonTime& epoch( it->first );
+
+         gnssDataMap::const_iterator itEnd( gds.upper_bound(epoch) );
+
+         size_t numSources(0);
+         for( gnssDataMap::const_iterator itc = it; itc != itEnd; ++itc )
+         {
+            for( sourceDataMap::const_iterator its = itc->second.begin();
+                 its != itc->second.end();
+                 ++its )
+            {
+               putSource(its->first);
+               ++numSources;
+            }
+         }
+
+         beginData(epoch, numSources);
+
+         for( ; it != itEnd; ++it )
+         {
+            for( sourceDataMap::const_iterator its = it->second.begin();
+                 its != it->second.end();
+                 ++its )
+            {
+               putVar(buffer, putSource(its->first));
+               buffer += static_cast<char>(kindPlain);
+               encodeBody(its->second);
+            }
+         }
+
+         putRecord(tagData, buffer);
+      }
+
+   }  // End of method 'GDSStream::writeGnssDataMap()'
+
+
+
+      /* Reads the next data record into a gnssSatTypeValue object.
+       * It returns false at end of file. If the record holds several
+       * sources, only the first one is kept.
+       *
+       * @param gds     Object to receive the data.
+       */
+   bool GDSStream::readGnssSatTypeValue(gnssSatTypeValue& gds)
+      throw(FFStreamError)
+   {
+
+      if( !getDataRecord() )
+      {
+         return false;
+      }
+
+      gds.header.epoch = lastEpoch;
+
+      if( sourcesLeft == 0 )
+      {
+         gds.header.source = SourceID();
+         gds.body.clear();
+      }
+      else
+      {
+         decodeSource(gds.header.source, 0, gds.body);
+      }
+
+      return true;
+
+   }  // End of method 'GDSStream::readGnssSatTypeValue()'
+
+
+
+      /* Reads the next data record into a gnssRinex object. It returns
+       * false at end of file. If the record holds several sources,
+       * only the first one is kept.
+       *
+       * @param gds     Object to receive the data.
+       */
+   bool GDSStream::readGnssRinex(gnssRinex& gds)
+      throw(FFStreamError)
+   {
+
+      if( !getDataRecord() )
+      {
+         return false;
+      }
+
+      gds.header.epoch = lastEpoch;
+      gds.header.antennaType.clear();
+      gds.header.antennaPosition = Triple();
+      gds.header.epochFlag = 0;
+
+      if( sourcesLeft == 0 )
+      {
+         gds.header.source = SourceID();
+         gds.body.clear();
+      }
+      else
+      {
+         decodeSource(gds.header.source, &gds.header, gds.body);
+      }
+
+         // Keep the base header consistent with the RINEX one
+      gds.gnssSatTypeValue::header.source = gds.header.source;
+      gds.gnssSatTypeValue::header.epoch = gds.header.epoch;
+
+      return true;
+
+   }  // End of method 'GDSStream::readGnssRinex()'
+
+
+
+      /* Reads the next data record and adds all of its sources to a
+       * gnssDataMap object. It returns false at end of file.
+       *
+       * @param gds     Object to receive the data.
+       */
+   bool GDSStream::readGnssDataMap(gnssDataMap& gds)
+      throw(FFStreamError)
+   {
+
+      if( !getDataRecord() )
+      {
+         return false;
+      }
+
+      sourceDataMap sdMap;
+      SourceID source;
+      satTypeValueMap body;
+
+      while( sourcesLeft > 0 )
+      {
+         decodeSource(source, 0, body);
+         sdMap[source].swap(body);
+      }
+
+      gds.insert( std::make_pair(lastEpoch, sdMap) );
+
+      return true;
+
+   }  // End of method 'GDSStream::readGnssDataMap()'
+
+
+
+      // Builds the epoch index.
+   void GDSStream::buildIndex(void)
+      throw(FFStreamError)
+   {
+
+      checkHeader();
+
+      index.clear();
+
+         // Scanning must not disturb sequential reading
+      clear();
+      std::streampos current( tellg() );
+      seekg(headerSize, std::ios::beg);
+
+      int64_t reference(0);
+      std::streampos offset( tellg() );
+      char tag;
+
+      while( getRecord(tag) )
+      {
+         if( tag == tagData )
+         {
+            IndexEntry entry;
+            entry.offset = offset;
+            entry.previous = reference;
+            entry.epoch = decodeEpoch(reference);
+            index.push_back(entry);
+         }
+         else
+         {
+            decodeDictionary(tag);
+         }
+
+         offset = tellg();
+      }
+
+      clear();
+      seekg(current);
+
+      sourcesLeft = 0;
+      indexed = true;
+
+   }  // End of method 'GDSStream::buildIndex()'
+
+
+
+      // Throws FFStreamError if the file header was not valid.
+   void GDSStream::checkHeader(void) const
+      throw(FFStreamError)
+   {
+
+         // Otherwise a file of another kind or version would read as an
+         // empty one
+      if( badHeader )
+      {
+         FFStreamError e("Not a GDS file, or unsupported GDS format version");
+         GPSTK_THROW(e);
+      }
+
+   }  // End of method 'GDSStream::checkHeader()'
+
+
+
+      /* Positions the stream so that the next record read is the first
+       * one with epoch greater than or equal to 'epoch'. It returns
+       * false if there is no such record, and then the stream is left
+       * at end of file.
+       *
+       * @param epoch   Epoch to look for.
+       */
+   bool GDSStream::seekEpoch(const CommonTime& epoch)
+      throw(FFStreamError)
+   {
+
+      if( !indexed )
+      {
+         buildIndex();
+      }
+
+      clear();
+      sourcesLeft = 0;
+
+      for( size_t i = 0; i < index.size(); ++i )
+      {
+         bool found(false);
+         try
+         {
+            found = ( index[i].epoch >= epoch );
+         }
+         catch(Exception& u)
+         {
+               // Epochs in incompatible time systems
+            FFStreamError e( u.what() );
+            GPSTK_THROW(e);
+         }
+
+         if( found )
+         {
+               // Dictionary records were all decoded by buildIndex()
+            seekg(index[i].offset);
+            lastMillis = index[i].previous;
+            return true;
+         }
+      }
+
+      seekg(0, std::ios::end);
+      setstate(std::ios::eofbit);
+
+      return false;
+
+   }  // End of method 'GDSStream::seekEpoch()'
+
+
+
+      // Returns the epochs of all the data records in the file, in
+      // file order.
+   std::vector<CommonTime> GDSStream::getEpochs(void)
+      throw(FFStreamError)
+   {
+
+      if( !indexed )
+      {
+         buildIndex();
+      }
+
+      std::vector<CommonTime> epochs;
+      epochs.reserve( index.size() );
+
+      for( size_t i = 0; i < index.size(); ++i )
+      {
+         epochs.push_back(index[i].epoch);
+      }
+
+      return epochs;
+
+   }  // End of method 'GDSStream::getEpochs()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,432 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file GDSStream.hpp
+ * Binary file stream to store and replay GNSS Data Structures.
+ */
+
+#ifndef GPSTK_GDSSTREAM_HPP
+#define GPSTK_GDSSTREAM_HPP
+
+#include <map>
+#include <vector>
+#include <string>
+#include "FFBinaryStream.hpp"
+#include "DataStructures.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup DataStructures
+      //@{
+
+
+      /** Binary file stream to store and replay GNSS Data Structures (GDS).
+       *
+       * This stream stores gnssSatTypeValue, gnssRinex and gnssDataMap
+       * objects in a compact, versioned binary format, so that data
+       * processed up to a given stage can be saved once and replayed many
+       * times (for instance, to try different solver configurations)
+       * without running the whole chain from RINEX again. Values are
+       * stored as IEEE doubles, so replayed data is bit-for-bit identical
+       * to the data that was written.
+       *
+       * The file starts with a short header (magic "GDSB", format version)
+       * followed by records made of a tag byte, a 32-bit payload length
+       * and the payload. Dictionary records define TypeID, SatID, SourceID
+       * and antenna (type and position) tables the first time each of
+       * them is written, and data records refer to them by small indexes.
+       * Data records hold one epoch, coded as the difference in
+       * milliseconds with respect to the previous data record, and the
+       * satTypeValueMap of each source. TypeIDs are stored along with
+       * their description, so user-defined types are registered again
+       * when the file is read by another program.
+       *
+       * Writing:
+       *
+       * @code
+       *   GDSStream gdsOut("ebre.gds", std::ios::out);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> basicModel >> computeTropo;
+       *      gdsOut << gRin;
+       *   }
+       * @endcode
+       *
+       * See also GDSWriter, which does the same as a ProcessingClass.
+       *
+       * Reading, from the beginning or from a given epoch:
+       *
+       * @code
+       *   GDSStream gdsIn("ebre.gds");
+       *
+       *   gdsIn.seekEpoch(startTime);
+       *
+       *   while(gdsIn >> gRin)
+       *   {
+       *      gRin >> pppSolver;
+       *   }
+       * @endcode
+       *
+       * The first call to seekEpoch() or getEpochs() scans the file once
+       * to build an index of epochs; later calls are just lookups.
+       */
+   class GDSStream : public FFBinaryStream
+   {
+   public:
+
+
+         /// Version of the format written by this class.
+      static const uint16_t formatVersion;
+
+
+         /// Default constructor
+      GDSStream();
+
+
+         /** Common constructor. When opened for output the file is
+          *  truncated and a new header is written; when opened for input
+          *  the header is read and checked. If it is not a GDS header of
+          *  a supported version, the stream is set to fail state and
+          *  reading from it throws FFStreamError.
+          *
+          * @param fn      File name.
+          * @param mode    File open mode.
+          */
+      GDSStream( const char* fn,
+                 std::ios::openmode mode = std::ios::in );
+
+
+         /// Destructor
+      virtual ~GDSStream();
+
+
+         /// Overrides open to write or check the file header.
+      virtual void open( const char* fn,
+                         std::ios::openmode mode );
+
+
+         /// This format is little-endian.
+      virtual bool isStreamLittleEndian() const throw()
+      { return true; };
+
+
+         /** Writes a gnssSatTypeValue object.
+          *
+          * @param gds     Data to be written.
+          */
+      virtual void writeGnssSatTypeValue(const gnssSatTypeValue& gds)
+         throw(FFStreamError);
+
+
+         /** Writes a gnssRinex object, including its RINEX header data
+          *  (antenna type and position and epoch flag).
+          *
+          * @param gds     Data to be written.
+          */
+      virtual void writeGnssRinex(const gnssRinex& gds)
+         throw(FFStreamError);
+
+
+         /** Writes a gnssDataMap object. Each epoch entry of the map
+          *  becomes a data record holding all of its sources.
+          *
+          * @param gds     Data to be written.
+          */
+      virtual void writeGnssDataMap(const gnssDataMap& gds)
+         throw(FFStreamError);
+
+
+         /** Reads the next data record into a gnssSatTypeValue object.
+          *  It returns false at end of file. If the record holds several
+          *  sources, only the first one is kept.
+          *
+          * @param gds     Object to receive the data.
+          */
+      virtual bool readGnssSatTypeValue(gnssSatTypeValue& gds)
+         throw(FFStreamError);
+
+
+         /** Reads the next data record into a gnssRinex object. It returns
+          *  false at end of file. If the record holds several sources,
+          *  only the first one is kept.
+          *
+          * @param gds     Object to receive the data.
+          */
+      virtual bool readGnssRinex(gnssRinex& gds)
+         throw(FFStreamError);
+
+
+         /** Reads the next data record and adds all of its sources to a
+          *  gnssDataMap object. It returns false at end of file.
+          *
+          * @param gds     Object to receive the data.
+          */
+      virtual bool readGnssDataMap(gnssDataMap& gds)
+         throw(FFStreamError);
+
+
+         /** Positions the stream so that the next record read is the first
+          *  one with epoch greater than or equal to 'epoch'. It returns
+          *  false if there is no such record, and then the stream is left
+          *  at end of file.
+          *
+          * @param epoch   Epoch to look for.
+          */
+      virtual bool seekEpoch(const CommonTime& epoch)
+         throw(FFStreamError);
+
+
+         /// Returns the epochs of all the data records in the file, in
+         /// file order.
+      virtual std::vector<CommonTime> getEpochs(void)
+         throw(FFStreamError);
+
+
+   private:
+
+
+         /// Entry of the epoch index.
+      struct IndexEntry
+      {
+            /// Stream offset of the record.
+         std::streampos offset;
+
+            /// Epoch of the record.
+         CommonTime epoch;
+
+            /// Epoch of the previous data record, in milliseconds.
+         int64_t previous;
+      };
+
+
+         /// Antenna type and position, as stored in the antenna table.
+      typedef std::pair<std::string, Triple> AntennaData;
+
+
+         // Tables used when writing
+      std::map<TypeID, size_t> typeIndex;
+      std::map<SatID, size_t> satIndex;
+      std::map<SourceID, size_t> sourceIndex;
+      std::map<std::string, size_t> antennaIndex;   // by encoded record
+
+
+         // Tables used when reading
+      std::vector<TypeID> types;
+      std::vector<SatID> sats;
+      std::vector<SourceID> sources;
+      std::vector<AntennaData> antennas;
+
+
+         /// Epoch of the previous data record, in milliseconds (days times
+         /// 86400000 plus milliseconds of day). Epochs are coded relative
+         /// to it.
+      int64_t lastMillis;
+
+
+         /// Epoch of the last data record read.
+      CommonTime lastEpoch;
+
+
+         /// Number of sources left to decode in the current data record.
+      size_t sourcesLeft;
+
+
+         /// Epoch index, built on demand.
+      std::vector<IndexEntry> index;
+
+
+         /// Whether 'index' has been built.
+      bool indexed;
+
+
+         /// Whether the file header read was not a valid one.
+      bool badHeader;
+
+
+         /// Record payload buffer, reused to avoid allocations.
+      std::string buffer;
+
+
+         /// Dictionary record buffer.
+      std::string dictBuffer;
+
+
+         /// Read position inside 'buffer'.
+      size_t bufPos;
+
+
+         /** Resets the tables and writes or checks the header. If the
+          *  header is not valid, the stream is set to fail state and
+          *  later reads throw FFStreamError.
+          */
+      void init(std::ios::openmode mode);
+
+
+         /// Reads up to 'n' bytes, returning how many were read.
+      size_t readRaw(char* p, size_t n);
+
+
+         /// Writes a record made of 'tag' and 'payload'.
+      void putRecord(char tag, const std::string& payload)
+         throw(FFStreamError);
+
+
+         /** Reads the next record into 'buffer'. It returns false at end
+          *  of file.
+          *
+          * @param tag     Tag of the record.
+          */
+      bool getRecord(char& tag)
+         throw(FFStreamError);
+
+
+         /** Reads records until a data record is found, and decodes its
+          *  epoch into 'lastEpoch'. It returns false at end of file.
+          */
+      bool getDataRecord(void)
+         throw(FFStreamError);
+
+
+         /// Decodes a dictionary record held in 'buffer'.
+      void decodeDictionary(char tag)
+         throw(FFStreamError);
+
+
+         /// Index of 'type' in the table, adding it if needed.
+      size_t putType(const TypeID& type)
+         throw(FFStreamError);
+
+
+         /// Index of 'sat' in the table, adding it if needed.
+      size_t putSat(const SatID& sat)
+         throw(FFStreamError);
+
+
+         /// Index of 'source' in the table, adding it if needed.
+      size_t putSource(const SourceID& source)
+         throw(FFStreamError);
+
+
+         /// Index of antenna data in the table, adding it if needed.
+      size_t putAntenna( const std::string& type,
+                         const Triple& position )
+         throw(FFStreamError);
+
+
+         /// Starts a data record in 'buffer' with the delta-coded epoch.
+      void beginData(const CommonTime& epoch, size_t numSources);
+
+
+         /// Appends a satTypeValueMap to the data record in 'buffer'.
+      void encodeBody(const satTypeValueMap& body)
+         throw(FFStreamError);
+
+
+         /** Decodes the epoch at 'bufPos', coded relative to 'reference'
+          *  which is then updated.
+          */
+      CommonTime decodeEpoch(int64_t& reference)
+         throw(FFStreamError);
+
+
+         /** Decodes the next source of the current data record. When
+          *  'rinex' is not null, the RINEX header data is stored there.
+          */
+      void decodeSource( SourceID& source,
+                         sourceEpochRinexHeader* rinex,
+                         satTypeValueMap& body )
+         throw(FFStreamError);
+
+
+         /// Builds the epoch index.
+      void buildIndex(void)
+         throw(FFStreamError);
+
+
+         /// Throws FFStreamError if the file header was not valid.
+      void checkHeader(void) const
+         throw(FFStreamError);
+
+
+   }; // End of class 'GDSStream'
+
+
+
+      /// Output operator from gnssSatTypeValue to GDSStream.
+   inline GDSStream& operator<<( GDSStream& s,
+                                 const gnssSatTypeValue& gds )
+   { s.writeGnssSatTypeValue(gds); return s; }
+
+
+      /// Output operator from gnssRinex to GDSStream.
+   inline GDSStream& operator<<( GDSStream& s,
+                                 gnssRinex& gds )
+   { s.writeGnssRinex(gds); return s; }
+
+
+      /// Output operator from gnssDataMap to GDSStream.
+   inline GDSStream& operator<<( GDSStream& s,
+                                 const gnssDataMap& gds )
+   { s.writeGnssDataMap(gds); return s; }
+
+
+      /// Input operator from GDSStream to gnssSatTypeValue.
+   inline GDSStream& operator>>( GDSStream& s,
+                                 gnssSatTypeValue& gds )
+   { s.readGnssSatTypeValue(gds); return s; }
+
+
+      /// Input operator from GDSStream to gnssRinex.
+   inline GDSStream& operator>>( GDSStream& s,
+                                 gnssRinex& gds )
+   { s.readGnssRinex(gds); return s; }
+
+
+      /// Input operator from GDSStream to gnssDataMap. It adds the next
+      /// data record to the map.
+   inline GDSStream& operator>>( GDSStream& s,
+                                 gnssDataMap& gds )
+   { s.readGnssDataMap(gds); return s; }
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_GDSSTREAM_HPP
@@ -0,0 +1,114 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file GDSWriter.cpp
+ * This class writes GNSS Data Structures (GDS) to a GDSStream as they pass
+ * through a processing chain.
+ */
+
+#include "GDSWriter.hpp"
+
+
+namespace gpstk
+{
+
+      // Returns a string identifying this object.
+   std::string GDSWriter::getClassName() const
+   { return "GDSWriter"; }
+
+
+
+      /* Writes a gnnsSatTypeValue object.
+       *
+       * @param gData    Data object holding the data.
+       */
+   gnssSatTypeValue& GDSWriter::Process( gnssSatTypeValue& gData )
+      throw(ProcessingException)
+   {
+
+      try
+      {
+
+         gdsStream->writeGnssSatTypeValue(gData);
+
+         return gData;
+
+      }
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'GDSWriter::Process()'
+
+
+
+      /* Writes a gnnsRinex object.
+       *
+       * @param gData    Data object holding the data.
+       */
+   gnssRinex& GDSWriter::Process( gnssRinex& gData )
+      throw(ProcessingException)
+   {
+
+      try
+      {
+
+         gdsStream->writeGnssRinex(gData);
+
+         return gData;
+
+      }
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'GDSWriter::Process()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,155 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file GDSWriter.hpp
+ * This class writes GNSS Data Structures (GDS) to a GDSStream as they pass
+ * through a processing chain.
+ */
+
+#ifndef GPSTK_GDSWRITER_HPP
+#define GPSTK_GDSWRITER_HPP
+
+#include "ProcessingClass.hpp"
+#include "GDSStream.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup DataStructures
+      //@{
+
+
+      /** This class writes GNSS Data Structures (GDS) to a GDSStream as
+       *  they pass through a processing chain, leaving them untouched.
+       *
+       * It is meant to save the data processed up to a given point, so
+       * that the rest of the chain can later be run many times reading the
+       * GDSStream instead of repeating the whole processing.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   RinexObsStream rin("ebre0300.02o");
+       *   GDSStream gdsOut("ebre.gds", std::ios::out);
+       *
+       *   gnssRinex gRin;
+       *   GDSWriter saveModel(gdsOut);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> basicModel >> computeTropo >> saveModel >> pppSolver;
+       *   }
+       * @endcode
+       *
+       * Later, the solver alone may be run on the stored data:
+       *
+       * @code
+       *   GDSStream gdsIn("ebre.gds");
+       *
+       *   while(gdsIn >> gRin)
+       *   {
+       *      gRin >> pppSolver;
+       *   }
+       * @endcode
+       *
+       * @sa GDSStream.hpp for the file format.
+       */
+   class GDSWriter : public ProcessingClass
+   {
+   public:
+
+         /** Common constructor
+          *
+          * @param stream    GDSStream, opened for output, to write to.
+          */
+      GDSWriter( GDSStream& stream )
+            : gdsStream(&stream)
+      { };
+
+
+         /** Writes a gnnsSatTypeValue object.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssSatTypeValue& Process( gnssSatTypeValue& gData )
+         throw(ProcessingException);
+
+
+         /** Writes a gnnsRinex object.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssRinex& Process( gnssRinex& gData )
+         throw(ProcessingException);
+
+
+         /** Method to set the GDSStream to write to.
+          *
+          * @param stream    GDSStream, opened for output, to write to.
+          */
+      virtual GDSWriter& setStream( GDSStream& stream )
+      { gdsStream = &stream; return (*this); };
+
+
+         /// Method to get the GDSStream being written to.
+      virtual GDSStream& getStream(void) const
+      { return (*gdsStream); };
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const;
+
+
+         /// Destructor
+      virtual ~GDSWriter() {};
+
+
+   private:
+
+
+         /// Pointer to the GDSStream to write to.
+      GDSStream* gdsStream;
+
+
+   }; // End of class 'GDSWriter'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_GDSWRITER_HPP
@@ -115,6 +115,10 @@ namespace gpstk
       try
       {
 
+            // Satellites to be modeled, and their ionospheric pierce-points
+         std::vector<satTypeValueMap::iterator> satList;
+         std::vector<Position> ippList;
+
             // Loop through all the satellites
          satTypeValueMap::iterator stv;
          for(stv = gData.begin(); stv != gData.end(); ++stv)
@@ -141,130 +145,143 @@ namespace gpstk
                continue;
 
             }
-            else
-            {
 
-                  // Scalars to hold satellite elevation, azimuth, ionospheric
-                  // map and ionospheric slant delays
-               double elevation( stv->second(TypeID::elevation) );
-               double azimuth(   stv->second(TypeID::azimuth)   );
-               double ionoMap(0.0);
-               double ionexL1(0.0), ionexL2(0.0), ionexL5(0.0);   // GPS
-               double ionexL6(0.0), ionexL7(0.0), ionexL8(0.0);   // Galileo
+               //	calculate the position of the ionospheric pierce-point
+               // corresponding to the receiver-satellite ray
+            Position IPP = rxPos.getIonosphericPiercePoint(
+                                             stv->second(TypeID::elevation),
+                                             stv->second(TypeID::azimuth),
+                                             ionoHeight );
 
-                  //	calculate the position of the ionospheric pierce-point
-                  // corresponding to the receiver-satellite ray
-               Position IPP = rxPos.getIonosphericPiercePoint( elevation,
-                                                               azimuth,
-                                                               ionoHeight);
+               // TODO
+               // Checking the collinearity of rxPos, IPP and SV
 
-                  // TODO
-                  // Checking the collinearity of rxPos, IPP and SV
+            IPP.transformTo(Position::Geocentric);
 
+            satList.push_back(stv);
+            ippList.push_back(IPP);
 
-                  // Let's get TEC, RMS and ionosphere height for IPP
-                  // at current epoch
-               Position pos(IPP);
-               pos.transformTo(Position::Geocentric);
-               Triple val = pDefaultMaps->getIonexValue( time, pos );
+         }  // End of loop 'for(stv = gData.begin()...'
 
-                  // just to make it handy for useage
-               double tecval = val[0];
 
-               try
-               {
+            // Let's get TEC, RMS and ionosphere height for all the IPPs
+            // at current epoch
+         std::vector<Triple> ippValues;
+         if( !satList.empty() )
+         {
+            pDefaultMaps->getIonexValues( time, ippList, ippValues );
+         }
+
+            // Loop through the satellites to be modeled
+         for(size_t i = 0; i < satList.size(); ++i)
+         {
 
-                  ionoMap = pDefaultMaps->iono_mapping_function( elevation,
-                                                                 ionoMapType);
+            stv = satList[i];
 
-                     // Compute ionospheric slant correction
-                  ionexL1 = pDefaultMaps->getIonoL1( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+               // Scalars to hold satellite elevation, ionospheric
+               // map and ionospheric slant delays
+            double elevation( stv->second(TypeID::elevation) );
+            double ionoMap(0.0);
+            double ionexL1(0.0), ionexL2(0.0), ionexL5(0.0);   // GPS
+            double ionexL6(0.0), ionexL7(0.0), ionexL8(0.0);   // Galileo
 
-                  ionexL2 = pDefaultMaps->getIonoL2( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+            Triple val = ippValues[i];
 
-                  ionexL5 = pDefaultMaps->getIonoL5( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+               // just to make it handy for useage
+            double tecval = val[0];
 
-                  ionexL6 = pDefaultMaps->getIonoL6( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+            try
+            {
 
-                  ionexL7 = pDefaultMaps->getIonoL7( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+               ionoMap = pDefaultMaps->iono_mapping_function( elevation,
+                                                              ionoMapType);
 
-                  ionexL8 = pDefaultMaps->getIonoL8( elevation,
-                                                     tecval,
-                                                     ionoMapType);
+                  // Compute ionospheric slant correction
+               ionexL1 = pDefaultMaps->getIonoL1( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-               }
-               catch(InvalidRequest)
-               {
+               ionexL2 = pDefaultMaps->getIonoL2( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-                     // If some problem appears, then schedule this
-                     // satellite for removal
-                  satRejectedSet.insert( stv->first );
+               ionexL5 = pDefaultMaps->getIonoL5( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-                  continue;    // Skip this SV if problems arise
+               ionexL6 = pDefaultMaps->getIonoL6( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-               }
+               ionexL7 = pDefaultMaps->getIonoL7( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-                  // Now we have to add the new values (i.e., ionosphere delays)
-                  // to the data structure
-               (*stv).second[TypeID::ionoTEC] = tecval;
-               (*stv).second[TypeID::ionoMap] = ionoMap;
-               (*stv).second[TypeID::ionoL1]  = ionexL1;
-               (*stv).second[TypeID::ionoL2]  = ionexL2;
-               (*stv).second[TypeID::ionoL5]  = ionexL5;
-               (*stv).second[TypeID::ionoL6]  = ionexL6;
-               (*stv).second[TypeID::ionoL7]  = ionexL7;
-               (*stv).second[TypeID::ionoL8]  = ionexL8;
-
-
-                  // DCB corrections for P1 measurements and satellite clock
-                  // values should be considered because precise ephemerides
-                  // and satellite clock information for SP3 orbit file always
-                  // refers to the ionosphere-free linear combination (LC)
-                  // see Appendix B, pg.14 of the Ionex manual
-                  // Useful link:
+               ionexL8 = pDefaultMaps->getIonoL8( elevation,
+                                                  tecval,
+                                                  ionoMapType);
 
-      // http://www.ngs.noaa.gov/IGSWorkshop2008/docs/Schaer_DCB_IGSWS2008.ppt
+            }
+            catch(InvalidRequest)
+            {
 
-                  // Computing Differential Code Biases (DCB - nanoseconds)
-               double tempDCB( getDCBCorrections( time,
-                                                 (*pDefaultMaps),
-                                                  stv->first) );
+                  // If some problem appears, then schedule this
+                  // satellite for removal
+               satRejectedSet.insert( stv->first );
 
+               continue;    // Skip this SV if problems arise
 
-                  // add to the GDS the  corresponding correction,
-                  // if appropriate
-               if(useDCB)
-               {
+            }
 
-                     // the second LC factor (see gpstk::LinearCombinations.cpp)
-                     // see pg.14, Ionex manual
-                  double kappa2(-1.0/0.646944444);
-                  double dcb(tempDCB * C_MPS * 1e-9);  // meters
+               // Now we have to add the new values (i.e., ionosphere delays)
+               // to the data structure
+            (*stv).second[TypeID::ionoTEC] = tecval;
+            (*stv).second[TypeID::ionoMap] = ionoMap;
+            (*stv).second[TypeID::ionoL1]  = ionexL1;
+            (*stv).second[TypeID::ionoL2]  = ionexL2;
+            (*stv).second[TypeID::ionoL5]  = ionexL5;
+            (*stv).second[TypeID::ionoL6]  = ionexL6;
+            (*stv).second[TypeID::ionoL7]  = ionexL7;
+            (*stv).second[TypeID::ionoL8]  = ionexL8;
+
+
+               // DCB corrections for P1 measurements and satellite clock
+               // values should be considered because precise ephemerides
+               // and satellite clock information for SP3 orbit file always
+               // refers to the ionosphere-free linear combination (LC)
+               // see Appendix B, pg.14 of the Ionex manual
+               // Useful link:
 
-                  if( stv->second.find(TypeID::instC1) == stv->second.end() )
-                  {
-                     stv->second[TypeID::instC1] = (kappa2 * dcb);
-                  }
-                  else
-                  {
-                     stv->second[TypeID::instC1] += (kappa2 * dcb);
-                  }
+      // http://www.ngs.noaa.gov/IGSWorkshop2008/docs/Schaer_DCB_IGSWS2008.ppt
 
-               }  // End of 'if(useDCB)...'
+               // Computing Differential Code Biases (DCB - nanoseconds)
+            double tempDCB( getDCBCorrections( time,
+                                              (*pDefaultMaps),
+                                               stv->first) );
 
-            }  // End of 'if( stv->second.find(TypeID::elevation) == ... '
 
-         }  // End of loop 'for(stv = gData.begin()...'
+               // add to the GDS the  corresponding correction,
+               // if appropriate
+            if(useDCB)
+            {
+
+                  // the second LC factor (see gpstk::LinearCombinations.cpp)
+                  // see pg.14, Ionex manual
+               double kappa2(-1.0/0.646944444);
+               double dcb(tempDCB * C_MPS * 1e-9);  // meters
+
+               if( stv->second.find(TypeID::instC1) == stv->second.end() )
+               {
+                  stv->second[TypeID::instC1] = (kappa2 * dcb);
+               }
+               else
+               {
+                  stv->second[TypeID::instC1] += (kappa2 * dcb);
+               }
+
+            }  // End of 'if(useDCB)...'
+
+         }  // End of loop 'for(size_t i = 0; i < satList.size(); ++i)'
 
 
             // Remove satellites with missing data
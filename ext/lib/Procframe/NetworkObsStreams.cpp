@@ -66,9 +66,10 @@ namespace gpstk
 
             return false;
          }
-            // Open the file
-         oData.pObsStream->exceptions(std::ios::failbit);
+            // Open the file. Exceptions are enabled after opening, since
+            // open() first closes the stream, which fails if it isn't open
          oData.pObsStream->open(oData.obsFile, std::ios::in);
+         oData.pObsStream->exceptions(std::ios::failbit);
 
             // We reader the header of the obs file
          RinexObsHeader obsHeader;
@@ -79,6 +80,7 @@ namespace gpstk
          oData.obsSource.sourceName = obsHeader.markerName;
 
          oData.pSynchro->setReferenceSource(*oData.pObsStream);
+         oData.pSynchro->setInterpolation(interpolation, maxInterpolationGap);
 
             // Now, we should store the data for the receiver
          allStreamData.push_back(oData);
@@ -116,11 +118,13 @@ namespace gpstk
 
       RinexObsStream* pRefObsStream = mapSourceStream[referenceSource];
 
-      gnssRinex gRef;
-  
       if( (*pRefObsStream) >> gRef )
       {
-         gdsMap.addGnssRinex(gRef);
+            // Bodies are swapped into the map instead of copied. Only
+            // the header of 'gRef' is needed to synchronize other streams.
+         gdsMap.insert( std::make_pair( gRef.header.epoch,
+                                        sourceDataMap() ) )
+            ->second[gRef.header.source].swap(gRef.body);
 
          std::map<SourceID, RinexObsStream*>::iterator it;
          for( it = mapSourceStream.begin();
@@ -132,12 +136,13 @@ namespace gpstk
             Synchronize* synchro = mapSourceSynchro[it->first];
             synchro->setRoverData(gRef);
 
-            gnssRinex gRin;
-
             try
             {
                gRin >> (*synchro);
-               gdsMap.addGnssRinex(gRin);
+
+               gdsMap.insert( std::make_pair( gRin.header.epoch,
+                                              sourceDataMap() ) )
+                  ->second[gRin.header.source].swap(gRin.body);
             }
             catch(...)
             {
@@ -154,7 +159,6 @@ namespace gpstk
             }
 
          }  // End of 'for(std::map<SourceID, RinexObsStream*>::iterator it;
-         
          return true;
 
       }  // End of 'if( (*pRefObsStream) >> gRef )'
@@ -164,6 +168,23 @@ namespace gpstk
 
    }  // End of method 'NetworkObsStreams::readEpochData()'
 
+      // Enables or disables interpolation of the data of every file
+      // to the epochs of the reference file.
+   void NetworkObsStreams::setInterpolation(bool interp, double maxGap)
+   {
+      interpolation = interp;
+      maxInterpolationGap = maxGap;
+
+      std::map<SourceID, Synchronize*>::iterator it;
+      for( it = mapSourceSynchro.begin();
+           it != mapSourceSynchro.end();
+         ++it)
+      {
+         it->second->setInterpolation(interp, maxGap);
+      }
+
+   }  // End of method 'NetworkObsStreams::setInterpolation()'
+
       // do some clean operation 
    void NetworkObsStreams::cleanUp()
    {
@@ -198,8 +219,8 @@ namespace gpstk
       try
       {
          RinexObsStream rin;
-         rin.exceptions(std::ios::failbit);
          rin.open(obsFile, std::ios::in);
+         rin.exceptions(std::ios::failbit);
  
          gnssRinex gRin;
          rin >> gRin;
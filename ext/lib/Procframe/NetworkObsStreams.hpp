@@ -100,7 +100,9 @@ namespace gpstk
    {
    public:
          /// Default constructor
-      NetworkObsStreams() : synchronizeException(false)
+      NetworkObsStreams()
+         : synchronizeException(false), interpolation(false),
+           maxInterpolationGap(30.0)
       {}
 
          /// Default destructor
@@ -134,6 +136,18 @@ namespace gpstk
       RinexObsStream* getRinexObsStream(const SourceID& source)
       { return mapSourceStream[source]; }
 
+         /// Get the Synchronize object of a source, to monitor its
+         /// buffer depth and latency
+      Synchronize* getSynchronize(const SourceID& source)
+      { return mapSourceSynchro[source]; }
+
+         /** Enables or disables interpolation of the data of every file
+          *  to the epochs of the reference file.
+          *
+          * @sa Synchronize::setInterpolation()
+          */
+      void setInterpolation(bool interp, double maxGap = 30.0);
+
    protected:
 
          /// Struct to hold all the data for a observation file
@@ -162,6 +176,16 @@ namespace gpstk
          /// Flag indicate will throw 'SynchronizeException'
       bool synchronizeException;
 
+         /// Whether data is interpolated to the reference epochs
+      bool interpolation;
+
+         /// Maximum time between interpolated epochs, in seconds
+      double maxInterpolationGap;
+
+         /// Objects reused to read reference data and synchronized data
+      gnssRinex gRef;
+      gnssRinex gRin;
+
    private:
          // Do some clean operation 
       virtual void cleanUp();
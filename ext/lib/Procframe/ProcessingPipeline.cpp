@@ -0,0 +1,440 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProcessingPipeline.cpp
+ * This class runs a chain of ProcessingClass objects as concurrent stages
+ * connected by lock-free queues.
+ */
+
+#include "ProcessingPipeline.hpp"
+
+
+namespace gpstk
+{
+
+      // Returns a string identifying this object.
+   std::string ProcessingPipeline::getClassName() const
+   { return "ProcessingPipeline"; }
+
+
+
+      /* Common constructor.
+       *
+       * @param depth    Maximum number of epochs in flight. It is
+       *                 also the size of the recycled object pool.
+       */
+   ProcessingPipeline::ProcessingPipeline(int d)
+      : depth( d > 0 ? d : 1 ),
+        pool( d > 0 ? d : 1 ),
+        running(false),
+        finished(false),
+        drained(false)
+   {
+
+      freeSlots = new SlotQueue(depth);
+
+      for (size_t i = 0; i < pool.size(); ++i)
+      {
+         freeSlots->push( &pool[i] );
+      }
+
+   }  // End of constructor 'ProcessingPipeline::ProcessingPipeline()'
+
+
+
+      // Destructor.
+   ProcessingPipeline::~ProcessingPipeline()
+   {
+
+      if( running )
+      {
+            // Make sure stage threads see an end of stream, and discard
+            // whatever is still inside the pipeline
+         finish();
+
+         Slot* slot(0);
+         SPSCBackoff backoff;
+         while( !drained )
+         {
+            if( queues.back()->pop(slot) )
+            {
+               if( slot == 0 )
+               {
+                  drained = true;
+               }
+               else
+               {
+                  slot->error = std::exception_ptr();
+                  freeSlots->push(slot);
+               }
+               backoff.reset();
+            }
+            else
+            {
+               backoff.pause();
+            }
+         }
+
+         join();
+      }
+
+      for (size_t i = 0; i < queues.size(); ++i)
+      {
+         delete queues[i];
+      }
+
+      delete freeSlots;
+
+   }  // End of destructor 'ProcessingPipeline::~ProcessingPipeline()'
+
+
+
+      /* Appends a new stage to the pipeline. Stages may only be
+       * added before the first epoch is pushed.
+       *
+       * @param pClass     Processing object to be run as a stage.
+       */
+   ProcessingPipeline& ProcessingPipeline::addStage(ProcessingClass& pClass)
+      throw(ProcessingException)
+   {
+
+      if( running || finished )
+      {
+         ProcessingException e( "Stages can't be added to a "
+                                "ProcessingPipeline that is already running." );
+         GPSTK_THROW(e);
+      }
+
+      stages.push_back( &pClass );
+
+      return (*this);
+
+   }  // End of method 'ProcessingPipeline::addStage()'
+
+
+
+      /* Starts the stage threads. It is called by the first push() if
+       * it was not called before.
+       */
+   void ProcessingPipeline::start(void)
+   {
+
+      if( running || finished )
+      {
+         return;
+      }
+
+         // One queue in front of each stage, plus one for the consumer.
+         // There are never more than 'depth' slots plus the end of stream
+         // mark inside a queue, so pushing into them never fails.
+      for (size_t i = 0; i <= stages.size(); ++i)
+      {
+         queues.push_back( new SlotQueue(depth + 1) );
+      }
+
+      for (size_t i = 0; i < stages.size(); ++i)
+      {
+         workers.push_back( std::thread(&ProcessingPipeline::runStage,
+                                        this,
+                                        i) );
+      }
+
+      running = true;
+
+   }  // End of method 'ProcessingPipeline::start()'
+
+
+
+      // Body of the thread running stage 'i'.
+   void ProcessingPipeline::runStage(size_t i)
+   {
+
+      SlotQueue& input( *queues[i] );
+      SlotQueue& output( *queues[i+1] );
+      ProcessingClass& stage( *stages[i] );
+
+      SPSCBackoff backoff;
+      Slot* slot(0);
+
+      while( true )
+      {
+
+         if( !input.pop(slot) )
+         {
+            backoff.pause();
+            continue;
+         }
+
+         backoff.reset();
+
+            // Epochs that already failed in a previous stage, and the end
+            // of stream mark, are forwarded untouched
+         if( slot != 0 && !slot->error )
+         {
+            try
+            {
+               stage.Process(slot->data);
+            }
+            catch(...)
+            {
+               slot->error = std::current_exception();
+            }
+         }
+
+         output.push(slot);
+
+         if( slot == 0 )
+         {
+            return;
+         }
+
+      }  // End of 'while( true )'
+
+   }  // End of method 'ProcessingPipeline::runStage()'
+
+
+
+      // Waits for the stage threads to end.
+   void ProcessingPipeline::join(void)
+   {
+
+      for (size_t i = 0; i < workers.size(); ++i)
+      {
+         if( workers[i].joinable() )
+         {
+            workers[i].join();
+         }
+      }
+
+      workers.clear();
+      running = false;
+
+   }  // End of method 'ProcessingPipeline::join()'
+
+
+
+      /* Feeds a new epoch into the pipeline, waiting if 'depth'
+       * epochs are already in flight. Threads are started with the
+       * first call.
+       *
+       * @param gData    Data object holding the data. On return it
+       *                 holds recycled storage with unspecified
+       *                 contents.
+       */
+   void ProcessingPipeline::push(gnssRinex& gData)
+      throw(ProcessingException)
+   {
+
+      if( finished )
+      {
+         ProcessingException e( "Epoch pushed into a ProcessingPipeline "
+                                "after finish()." );
+         GPSTK_THROW(e);
+      }
+
+      if( !running )
+      {
+         start();
+      }
+
+         // Back-pressure: wait until the consumer gives a slot back
+      Slot* slot(0);
+      SPSCBackoff backoff;
+      while( !freeSlots->pop(slot) )
+      {
+         backoff.pause();
+      }
+
+         // Swapping the body hands over the data without copying it, and
+         // leaves the slot's old storage in 'gData' for its next use
+      slot->data.header = gData.header;
+      slot->data.body.swap( gData.body );
+      slot->error = std::exception_ptr();
+
+      queues.front()->push(slot);
+
+      return;
+
+   }  // End of method 'ProcessingPipeline::push()'
+
+
+
+      // Hands over the contents of a processed slot to the consumer.
+   bool ProcessingPipeline::deliver(Slot* slot, gnssRinex& gData)
+   {
+
+      if( slot == 0 )
+      {
+         drained = true;
+         join();
+         return false;
+      }
+
+      gData.header = slot->data.header;
+      gData.body.swap( slot->data.body );
+
+      std::exception_ptr error( slot->error );
+      slot->error = std::exception_ptr();
+
+      freeSlots->push(slot);
+
+         // This epoch failed: report it as the synchronous chain would
+      if( error )
+      {
+         std::rethrow_exception(error);
+      }
+
+      return true;
+
+   }  // End of method 'ProcessingPipeline::deliver()'
+
+
+
+      /* Retrieves the oldest processed epoch, waiting until it is
+       * available. It returns false when the end of stream signalled
+       * by finish() is reached.
+       *
+       * @param gData    Data object to receive the data.
+       */
+   bool ProcessingPipeline::pop(gnssRinex& gData)
+   {
+
+      if( drained || !running )
+      {
+         return false;
+      }
+
+      Slot* slot(0);
+      SPSCBackoff backoff;
+      while( !queues.back()->pop(slot) )
+      {
+         backoff.pause();
+      }
+
+      return deliver(slot, gData);
+
+   }  // End of method 'ProcessingPipeline::pop()'
+
+
+
+      /* Retrieves the oldest processed epoch if it is available,
+       * without waiting. It returns false when there is no such
+       * epoch.
+       *
+       * @param gData    Data object to receive the data.
+       */
+   bool ProcessingPipeline::tryPop(gnssRinex& gData)
+   {
+
+      if( drained || !running )
+      {
+         return false;
+      }
+
+      Slot* slot(0);
+      if( !queues.back()->pop(slot) )
+      {
+         return false;
+      }
+
+      return deliver(slot, gData);
+
+   }  // End of method 'ProcessingPipeline::tryPop()'
+
+
+
+      /* Feeds a new epoch into the pipeline and, if a processed epoch
+       * is available or the pool is exhausted, retrieves the oldest
+       * processed epoch into the same object.
+       *
+       * @param gData    Data object holding the data.
+       */
+   bool ProcessingPipeline::exchange(gnssRinex& gData)
+   {
+
+      push(gData);
+
+      if( tryPop(gData) )
+      {
+         return true;
+      }
+
+         // Without free slots the next push() would wait forever for
+         // ourselves, so wait here for the oldest epoch instead
+      if( freeSlots->empty() )
+      {
+         return pop(gData);
+      }
+
+      return false;
+
+   }  // End of method 'ProcessingPipeline::exchange()'
+
+
+
+      /* Signals the end of the stream. Epochs already pushed are
+       * still processed and must be drained with pop().
+       */
+   void ProcessingPipeline::finish(void)
+   {
+
+      if( finished )
+      {
+         return;
+      }
+
+      finished = true;
+
+      if( running )
+      {
+         queues.front()->push(0);
+      }
+
+      return;
+
+   }  // End of method 'ProcessingPipeline::finish()'
+
+
+
+      // Returns the number of epochs currently inside the pipeline.
+   int ProcessingPipeline::getNumInFlight(void) const
+   {
+      return ( depth - static_cast<int>(freeSlots->size()) );
+   }
+
+
+}  // End of namespace gpstk
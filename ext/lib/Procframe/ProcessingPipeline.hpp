@@ -0,0 +1,333 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProcessingPipeline.hpp
+ * This class runs a chain of ProcessingClass objects as concurrent stages
+ * connected by lock-free queues.
+ */
+
+#ifndef GPSTK_PROCESSINGPIPELINE_HPP
+#define GPSTK_PROCESSINGPIPELINE_HPP
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include "ProcessingClass.hpp"
+#include "SPSCQueue.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions
+      //@{
+
+
+      /** This class runs a chain of ProcessingClass objects as concurrent
+       *  stages, each one in its own thread.
+       *
+       * A chain such as 'gRin >> basic >> tropo >> pppSolver' is strictly
+       * synchronous: a new epoch can't be read until the previous one has
+       * been solved. With this class the chain is split into stages that
+       * are connected by bounded single-producer/single-consumer lock-free
+       * queues, so that reading, modelling and solving of consecutive
+       * epochs overlap on different cores.
+       *
+       * Each stage is a reference to a ProcessingClass object; use a
+       * ProcessingList to group several objects in the same stage. Stage
+       * objects are NOT owned by the pipeline, and each of them is only
+       * called from its own thread, so they must not be shared with other
+       * stages or used elsewhere while the pipeline is running.
+       *
+       * The pipeline owns a fixed pool of 'depth' gnssRinex objects that
+       * are recycled: data enters and leaves the pipeline by swapping
+       * contents with the caller's object, so epochs are handed from
+       * stage to stage without copying, and the pipeline itself allocates
+       * nothing per epoch. The data structures are still allocated as
+       * usual by the reader and by the stages that add values to them
+       * (std::map nodes). When all the objects of the pool are in flight,
+       * push() waits (back-pressure) until the consumer retrieves a
+       * processed epoch.
+       *
+       * Epochs come out in the same order they were pushed. If a stage
+       * throws an exception while processing an epoch (for instance
+       * 'DecimateEpoch'), the remaining stages are skipped for that epoch
+       * and the exception is rethrown, with its original type, by the
+       * pop() call that retrieves the epoch, just as the synchronous chain
+       * would have done.
+       *
+       * A typical way to use this class in a single thread follows:
+       *
+       * @code
+       *   RinexObsStream rin("ebre0300.02o");
+       *   gnssRinex gRin;
+       *
+       *   BasicModel basic(nominalPos, SP3EphList);
+       *   ComputeTropModel computeTropo(neillTM);
+       *   SolverPPP pppSolver;
+       *
+       *      // Group modelling objects in a single stage
+       *   ProcessingList modelling;
+       *   modelling.push_back(basic);
+       *   modelling.push_back(computeTropo);
+       *
+       *   ProcessingPipeline pipe(8);
+       *   pipe.addStage(modelling);
+       *   pipe.addStage(pppSolver);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      try
+       *      {
+       *            // 'gRin' goes in, and an older processed epoch may
+       *            // come out in its place
+       *         if( pipe.exchange(gRin) )
+       *         {
+       *            printSolution(gRin, pppSolver);
+       *         }
+       *      }
+       *      catch(DecimateEpoch& d)
+       *      {
+       *         continue;
+       *      }
+       *   }
+       *
+       *      // Signal end of stream and drain the remaining epochs
+       *   pipe.finish();
+       *   while( pipe.pop(gRin) )
+       *   {
+       *      printSolution(gRin, pppSolver);
+       *   }
+       * @endcode
+       *
+       * Alternatively, push() and finish() may be called from a producer
+       * thread while pop() and tryPop() are called from a consumer thread.
+       * In that case start() must be called before both threads are
+       * launched.
+       *
+       * @warning Objects that read state from a stage (like 'pppSolver' in
+       * the example above) see that stage's latest epoch, which may be
+       * newer than the one just retrieved. Results that must match the
+       * retrieved epoch should be stored into the gnssRinex object by the
+       * stage itself.
+       */
+   class ProcessingPipeline
+   {
+   public:
+
+
+         /** Common constructor.
+          *
+          * @param depth    Maximum number of epochs in flight. It is
+          *                 also the size of the recycled object pool.
+          */
+      ProcessingPipeline(int depth = 8);
+
+
+         /** Appends a new stage to the pipeline. Stages may only be
+          *  added before the first epoch is pushed.
+          *
+          * @param pClass     Processing object to be run as a stage.
+          */
+      virtual ProcessingPipeline& addStage(ProcessingClass& pClass)
+         throw(ProcessingException);
+
+
+         /** Starts the stage threads. It is called by the first push() if
+          *  it was not called before.
+          */
+      virtual void start(void);
+
+
+         /** Feeds a new epoch into the pipeline, waiting if 'depth'
+          *  epochs are already in flight. Threads are started with the
+          *  first call.
+          *
+          * @param gData    Data object holding the data. On return it
+          *                 holds recycled storage with unspecified
+          *                 contents.
+          */
+      virtual void push(gnssRinex& gData)
+         throw(ProcessingException);
+
+
+         /** Retrieves the oldest processed epoch, waiting until it is
+          *  available. It returns false when the end of stream signalled
+          *  by finish() is reached, or if the pipeline was not started.
+          *
+          * @param gData    Data object to receive the data.
+          */
+      virtual bool pop(gnssRinex& gData);
+
+
+         /** Retrieves the oldest processed epoch if it is available,
+          *  without waiting. It returns false when there is no such
+          *  epoch.
+          *
+          * @param gData    Data object to receive the data.
+          */
+      virtual bool tryPop(gnssRinex& gData);
+
+
+         /** Feeds a new epoch into the pipeline and, if a processed epoch
+          *  is available or the pool is exhausted, retrieves the oldest
+          *  processed epoch into the same object. This is the method to
+          *  use when a single thread both feeds and drains the pipeline.
+          *  It returns true if 'gData' holds a processed epoch. Like pop(),
+          *  it rethrows the exception raised by a stage for the epoch
+          *  retrieved.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual bool exchange(gnssRinex& gData);
+
+
+         /** Signals the end of the stream. Epochs already pushed are
+          *  still processed and must be drained with pop().
+          */
+      virtual void finish(void);
+
+
+         /// Returns the maximum number of epochs in flight.
+      virtual int getDepth(void) const
+      { return depth; };
+
+
+         /// Returns the number of stages.
+      virtual int getNumStages(void) const
+      { return stages.size(); };
+
+
+         /// Returns the number of epochs currently inside the pipeline.
+      virtual int getNumInFlight(void) const;
+
+
+         /// Returns true if the stage threads are running.
+      virtual bool isRunning(void) const
+      { return running.load(); };
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const;
+
+
+         /** Destructor. If the end of stream was not reached, pending
+          *  epochs are discarded and the stage threads are stopped.
+          */
+      virtual ~ProcessingPipeline();
+
+
+   private:
+
+
+         /// Pool element travelling across the pipeline.
+      struct Slot
+      {
+            /// Epoch data.
+         gnssRinex data;
+
+            /// Exception raised by a stage while processing 'data', if any.
+         std::exception_ptr error;
+      };
+
+
+         /// Queue of pool elements. A null pointer marks end of stream.
+      typedef SPSCQueue<Slot*> SlotQueue;
+
+
+         /// Maximum number of epochs in flight.
+      int depth;
+
+
+         /// Pool of recycled objects.
+      std::vector<Slot> pool;
+
+
+         /// Processing objects, one per stage.
+      std::vector<ProcessingClass*> stages;
+
+
+         /// Queues between stages. queues[i] feeds stages[i], and the
+         /// last queue feeds the consumer.
+      std::vector<SlotQueue*> queues;
+
+
+         /// Free pool elements, from the consumer back to the producer.
+      SlotQueue* freeSlots;
+
+
+         /// Stage threads.
+      std::vector<std::thread> workers;
+
+
+         /// Whether the stage threads have been started.
+      std::atomic<bool> running;
+
+
+         /// Whether finish() has been called.
+      std::atomic<bool> finished;
+
+
+         /// Whether the consumer has reached the end of stream.
+      std::atomic<bool> drained;
+
+
+         /// Body of the thread running stage 'i'.
+      void runStage(size_t i);
+
+
+         /// Waits for the stage threads to end.
+      void join(void);
+
+
+         /// Hands over the contents of a processed slot to the consumer.
+      bool deliver(Slot* slot, gnssRinex& gData);
+
+
+         /// Copying a pipeline is not allowed.
+      ProcessingPipeline(const ProcessingPipeline&);
+      ProcessingPipeline& operator=(const ProcessingPipeline&);
+
+
+   }; // End of class 'ProcessingPipeline'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_PROCESSINGPIPELINE_HPP
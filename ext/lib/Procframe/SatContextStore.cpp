@@ -0,0 +1,456 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file SatContextStore.cpp
+ * Per-epoch cache of satellite states and Sun/Moon positions, shared by
+ * several stations and processing objects.
+ */
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "SatContextStore.hpp"
+#include "SunPosition.hpp"
+#include "MoonPosition.hpp"
+#include "GPSEllipsoid.hpp"
+#include "GNSSconstants.hpp"
+
+
+namespace gpstk
+{
+
+      /* Common constructor.
+       *
+       * @param ephem      Ephemeris store to take satellite states from.
+       * @param grid       Time span, in seconds, sharing a single
+       *                   evaluation of each satellite state. Zero,
+       *                   the default, disables caching of states.
+       */
+   SatContextStore::SatContextStore( XvtStore<SatID>& ephem,
+                                     double g )
+      : pEphemeris(&ephem), grid( g > 0.0 ? g : 0.0 ), retention(300.0)
+   {
+   }
+
+
+
+      /* Returns the position, velocity and clock offset of the given
+       * satellite, extrapolated from the cached state of its grid cell,
+       * or taken from the wrapped store if there is no grid.
+       *
+       * @param sat     Satellite.
+       * @param t       Time to look up.
+       */
+   Xvt SatContextStore::getXvt(const SatID& sat, const CommonTime& t) const
+      throw(InvalidRequest)
+   {
+
+         // Without a grid, exact transmit times never coincide across
+         // stations, so there is nothing worth caching
+      if( grid <= 0.0 )
+      {
+         try
+         {
+            return pEphemeris->getXvt(sat, t);
+         }
+         catch(InvalidRequest& e)
+         {
+            GPSTK_RETHROW(e);
+         }
+         catch(Exception& u)
+         {
+            InvalidRequest e( u.what() );
+            GPSTK_THROW(e);
+         }
+      }
+
+      CommonTime cell( gridCell(t) );
+
+      {
+         std::lock_guard<std::mutex> lock(cacheMutex);
+
+         std::map<CommonTime, XvtMap>::const_iterator itc(
+                                                      xvtCache.find(cell) );
+         if( itc != xvtCache.end() )
+         {
+            XvtMap::const_iterator its( itc->second.find(sat) );
+            if( its != itc->second.end() )
+            {
+               return extrapolate(its->second, cell, t);
+            }
+         }
+      }
+
+         // The wrapped store is called without holding the lock, so
+         // that several threads may evaluate different satellites
+      Xvt ref;
+      try
+      {
+         ref = pEphemeris->getXvt(sat, cell);
+      }
+      catch(InvalidRequest& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+      catch(Exception& u)
+      {
+         InvalidRequest e( u.what() );
+         GPSTK_THROW(e);
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(cacheMutex);
+
+         xvtCache[cell][sat] = ref;
+         prune(xvtCache);
+      }
+
+      return extrapolate(ref, cell, t);
+
+   }  // End of method 'SatContextStore::getXvt()'
+
+
+
+      /* Evaluates the states of a set of satellites at the grid cell of
+       * time 't', using several threads. Satellites without ephemeris
+       * are skipped. Later calls to getXvt() near 't' only read the
+       * cache. Does nothing if there is no grid.
+       *
+       * @param t          Time, usually the approximate transmit time.
+       * @param sats       Satellites to evaluate.
+       * @param numThreads Number of threads to use.
+       */
+   void SatContextStore::fill( const CommonTime& t,
+                               const SatIDSet& sats,
+                               int numThreads )
+   {
+
+         // Nothing is cached without a grid
+      if( grid <= 0.0 )
+      {
+         return;
+      }
+
+      std::vector<SatID> satList( sats.begin(), sats.end() );
+
+      if( numThreads < 1 )
+      {
+         numThreads = 1;
+      }
+      if( static_cast<size_t>(numThreads) > satList.size() )
+      {
+         numThreads = static_cast<int>( satList.size() );
+      }
+
+         // Each thread takes every numThreads-th satellite. getXvt() does
+         // the caching, and only holds the lock while touching the maps.
+      std::vector<std::thread> workers;
+      for( int i = 1; i < numThreads; ++i )
+      {
+         workers.push_back( std::thread( [this, &satList, &t, i, numThreads]
+         {
+            for( size_t j = i; j < satList.size(); j += numThreads )
+            {
+               try
+               {
+                  getXvt(satList[j], t);
+               }
+               catch(...)
+               {
+               }
+            }
+         } ) );
+      }
+
+      for( size_t j = 0; j < satList.size(); j += numThreads )
+      {
+         try
+         {
+            getXvt(satList[j], t);
+         }
+         catch(...)
+         {
+         }
+      }
+
+      for( size_t i = 0; i < workers.size(); ++i )
+      {
+         workers[i].join();
+      }
+
+      return;
+
+   }  // End of method 'SatContextStore::fill()'
+
+
+
+      // Returns the position of the Sun, in ECEF, at epoch 't'.
+   Triple SatContextStore::getSunPosition(const CommonTime& t) const
+   {
+
+      std::lock_guard<std::mutex> lock(cacheMutex);
+
+      std::map<CommonTime, Triple>::const_iterator it( sunCache.find(t) );
+      if( it != sunCache.end() )
+      {
+         return it->second;
+      }
+
+      SunPosition sunPosition;
+      Triple pos( sunPosition.getPosition(t) );
+
+      sunCache[t] = pos;
+      prune(sunCache);
+
+      return pos;
+
+   }  // End of method 'SatContextStore::getSunPosition()'
+
+
+
+
+      /* Returns the position of the Sun, in ECEF, at epoch 't', taken from
+       * 'context' if it is not NULL, or else computed.
+       *
+       * @param context   Shared satellite context, or NULL.
+       * @param t         Epoch of interest.
+       */
+   Triple SatContextStore::getSunPosition( const SatContextStore* context,
+                                           const CommonTime& t )
+   {
+
+      if( context != NULL )
+      {
+            // Shared with other objects and stations
+         return context->getSunPosition(t);
+      }
+
+      SunPosition sunPosition;
+      return sunPosition.getPosition(t);
+
+   }  // End of method 'SatContextStore::getSunPosition()'
+
+
+
+      // Returns the position of the Moon, in ECEF, at epoch 't'.
+   Triple SatContextStore::getMoonPosition(const CommonTime& t) const
+   {
+
+      std::lock_guard<std::mutex> lock(cacheMutex);
+
+      std::map<CommonTime, Triple>::const_iterator it( moonCache.find(t) );
+      if( it != moonCache.end() )
+      {
+         return it->second;
+      }
+
+      MoonPosition moonPosition;
+      Triple pos( moonPosition.getPosition(t) );
+
+      moonCache[t] = pos;
+      prune(moonCache);
+
+      return pos;
+
+   }  // End of method 'SatContextStore::getMoonPosition()'
+
+
+
+      // Sets the grid, in seconds, discarding cached states.
+   SatContextStore& SatContextStore::setGrid(double seconds)
+   {
+
+      std::lock_guard<std::mutex> lock(cacheMutex);
+
+      grid = ( seconds > 0.0 ? seconds : 0.0 );
+      xvtCache.clear();
+
+      return (*this);
+
+   }  // End of method 'SatContextStore::setGrid()'
+
+
+
+      // Dumps the number of cached entries, and the wrapped store.
+   void SatContextStore::dump(std::ostream& s, short detail) const
+   {
+
+      {
+         std::lock_guard<std::mutex> lock(cacheMutex);
+
+         size_t numStates(0);
+         for( std::map<CommonTime, XvtMap>::const_iterator it =
+                                                            xvtCache.begin();
+              it != xvtCache.end();
+              ++it )
+         {
+            numStates += it->second.size();
+         }
+
+         s << "SatContextStore: grid " << grid << " s, "
+           << xvtCache.size() << " cells, "
+           << numStates << " satellite states, "
+           << sunCache.size() << " Sun and "
+           << moonCache.size() << " Moon positions." << std::endl;
+      }
+
+      pEphemeris->dump(s, detail);
+
+   }  // End of method 'SatContextStore::dump()'
+
+
+
+      // Edits the wrapped store, and discards cached data.
+   void SatContextStore::edit( const CommonTime& tmin,
+                               const CommonTime& tmax )
+   {
+
+      pEphemeris->edit(tmin, tmax);
+      clear();
+
+   }  // End of method 'SatContextStore::edit()'
+
+
+
+      // Discards cached data. The wrapped store is NOT cleared.
+   void SatContextStore::clear(void)
+   {
+
+      std::lock_guard<std::mutex> lock(cacheMutex);
+
+      xvtCache.clear();
+      sunCache.clear();
+      moonCache.clear();
+
+   }  // End of method 'SatContextStore::clear()'
+
+
+
+      // Returns the grid cell holding 't'.
+   CommonTime SatContextStore::gridCell(const CommonTime& t) const
+   {
+
+      if( grid <= 0.0 )
+      {
+         return t;
+      }
+
+         // Cells are counted from the start of the day, so that every time
+         // inside a cell yields exactly the same CommonTime
+      long day, msod;
+      double fsod;
+      TimeSystem sys;
+      t.getInternal(day, msod, fsod, sys);
+
+      double k( std::floor( t.getSecondOfDay() / grid + 0.5 ) );
+
+      CommonTime cell;
+      cell.setInternal(day, 0, 0.0, sys);
+      cell += k * grid;
+
+      return cell;
+
+   }  // End of method 'SatContextStore::gridCell()'
+
+
+
+      // Discards entries older than the retention time from 'cache'.
+   template <class T>
+   void SatContextStore::prune(std::map<CommonTime, T>& cache) const
+   {
+
+      if( cache.size() < 2 )
+      {
+         return;
+      }
+
+      CommonTime oldest( cache.rbegin()->first - retention );
+
+      cache.erase( cache.begin(), cache.lower_bound(oldest) );
+
+   }  // End of method 'SatContextStore::prune()'
+
+
+
+      // Extrapolates 'ref', valid at 't0', to 't'.
+   Xvt SatContextStore::extrapolate( const Xvt& ref,
+                                     const CommonTime& t0,
+                                     const CommonTime& t )
+   {
+
+      double dt( t - t0 );
+
+      if( dt == 0.0 )
+      {
+         return ref;
+      }
+
+      static const GPSEllipsoid ellipsoid;
+      static const double gm( ellipsoid.gm() );
+      static const double omega( ellipsoid.angVelocity() );
+
+         // Acceleration in the Earth-fixed frame: central gravity plus
+         // centrifugal and Coriolis terms (rotation is about Z)
+      const Triple& r( ref.x );
+      const Triple& v( ref.v );
+      double rad( r.mag() );
+      double k( -gm / (rad*rad*rad) );
+
+      Triple a( k*r[0] + omega*omega*r[0] + 2.0*omega*v[1],
+                k*r[1] + omega*omega*r[1] - 2.0*omega*v[0],
+                k*r[2] );
+
+      Xvt xvt(ref);
+
+      for( int i = 0; i < 3; ++i )
+      {
+         xvt.x[i] = r[i] + v[i]*dt + 0.5*a[i]*dt*dt;
+         xvt.v[i] = v[i] + a[i]*dt;
+      }
+
+      xvt.clkbias = ref.clkbias + ref.clkdrift*dt;
+
+         // Relativity is -2(r.v)/c^2, whose rate is -2(v.v + r.a)/c^2
+      xvt.relcorr = ref.relcorr - 2.0*( v.dot(v) + r.dot(a) )*dt
+                                  / (C_MPS*C_MPS);
+
+      return xvt;
+
+   }  // End of method 'SatContextStore::extrapolate()'
+
+
+}  // End of namespace gpstk
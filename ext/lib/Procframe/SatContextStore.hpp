@@ -0,0 +1,308 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file SatContextStore.hpp
+ * Per-epoch cache of satellite states and Sun/Moon positions, shared by
+ * several stations and processing objects.
+ */
+
+#ifndef GPSTK_SATCONTEXTSTORE_HPP
+#define GPSTK_SATCONTEXTSTORE_HPP
+
+#include <map>
+#include <mutex>
+#include "XvtStore.hpp"
+#include "SatID.hpp"
+#include "Triple.hpp"
+#include "DataStructures.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions
+      //@{
+
+
+      /** This class caches, per epoch, the satellite states and the Sun
+       *  and Moon positions needed by modelling objects, so that they are
+       *  computed once and shared by all the stations of a network.
+       *
+       * Objects like BasicModel, ModelObs, ComputeSatPCenter, ComputeWindUp
+       * and EclipsedSatFilter each evaluate the ephemeris and the Sun
+       * position for every satellite and epoch. When many stations are
+       * processed, that work is repeated for every one of them.
+       *
+       * SatContextStore is an XvtStore<SatID> wrapping another one, so it
+       * may be given to any object taking an ephemeris. By default, satellite
+       * states are not cached: getXvt() passes straight through to the
+       * wrapped store, and results are identical to its own.
+       *
+       * Optionally, a 'grid' cell of time may be given (e.g. 0.1 s). Then
+       * satellite states are evaluated once per satellite and cell, and
+       * extrapolated from there to the requested time with a second order
+       * expansion including central gravity and the centrifugal and
+       * Coriolis accelerations of the rotating frame. As transmit times of
+       * all stations for a given epoch fall within a few tens of
+       * milliseconds, they share the same evaluation. The extrapolation
+       * error is well below a millimetre for a grid of 0.1 s, but results
+       * are no longer identical to those of the wrapped store.
+       *
+       * Sun and Moon positions are cached per epoch, and are used by
+       * ComputeSatPCenter, ComputeWindUp and EclipsedSatFilter when they
+       * are given a SatContextStore with their setSatContext() method.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   SP3EphemerisStore SP3EphList;
+       *   SP3EphList.loadFile("igs11513.sp3");
+       *
+       *      // Share one evaluation of each satellite per 0.1 s
+       *   SatContextStore context(SP3EphList, 0.1);
+       *
+       *      // One set of objects per station, sharing 'context'
+       *   BasicModel model1(nominalPos1, context);
+       *   ComputeWindUp windup1(context, nominalPos1);
+       *   windup1.setSatContext(context);
+       *
+       *   BasicModel model2(nominalPos2, context);
+       *   ComputeWindUp windup2(context, nominalPos2);
+       *   windup2.setSatContext(context);
+       *
+       *   while( ... )
+       *   {
+       *         // Optionally, evaluate all satellites in parallel first
+       *      context.fill(gRin1.header.epoch - 0.075, sats, 4);
+       *
+       *      gRin1 >> model1 >> windup1;
+       *      gRin2 >> model2 >> windup2;
+       *   }
+       * @endcode
+       *
+       * Cached data older than the retention time (300 s by default) with
+       * respect to the newest data is discarded. The caches are protected
+       * by a mutex, but the wrapped store is called without holding it, so
+       * methods may only be called concurrently from several threads, and
+       * fill() may only use more than one thread, if the getXvt() method
+       * of the wrapped store is itself safe to call concurrently.
+       */
+   class SatContextStore : public XvtStore<SatID>
+   {
+   public:
+
+
+         /** Common constructor.
+          *
+          * @param ephem      Ephemeris store to take satellite states from.
+          * @param grid       Time span, in seconds, sharing a single
+          *                   evaluation of each satellite state. Zero,
+          *                   the default, disables caching of states.
+          */
+      SatContextStore( XvtStore<SatID>& ephem,
+                       double grid = 0.0 );
+
+
+         /// Destructor
+      virtual ~SatContextStore() {};
+
+
+         /** Returns the position, velocity and clock offset of the given
+          *  satellite, extrapolated from the cached state of its grid cell,
+          *  or taken from the wrapped store if there is no grid.
+          *
+          * @param sat     Satellite.
+          * @param t       Time to look up.
+          */
+      virtual Xvt getXvt(const SatID& sat, const CommonTime& t) const
+         throw(InvalidRequest);
+
+
+         /** Evaluates the states of a set of satellites at the grid cell of
+          *  time 't', using several threads. Satellites without ephemeris
+          *  are skipped. Later calls to getXvt() near 't' only read the
+          *  cache. Does nothing if there is no grid.
+          *
+          *  With numThreads > 1, the wrapped store is called from several
+          *  threads at once, and so must be safe to use that way.
+          *
+          * @param t          Time, usually the approximate transmit time.
+          * @param sats       Satellites to evaluate.
+          * @param numThreads Number of threads to use.
+          */
+      virtual void fill( const CommonTime& t,
+                         const SatIDSet& sats,
+                         int numThreads = 1 );
+
+
+         /// Returns the position of the Sun, in ECEF, at epoch 't'.
+      virtual Triple getSunPosition(const CommonTime& t) const;
+
+
+         /** Returns the position of the Sun, in ECEF, at epoch 't', taken
+          *  from 'context' if it is not NULL, or else computed.
+          *
+          * @param context   Shared satellite context, or NULL.
+          * @param t         Epoch of interest.
+          */
+      static Triple getSunPosition( const SatContextStore* context,
+                                    const CommonTime& t );
+
+
+         /// Returns the position of the Moon, in ECEF, at epoch 't'.
+      virtual Triple getMoonPosition(const CommonTime& t) const;
+
+
+         /// Returns the grid, in seconds.
+      virtual double getGrid(void) const
+      { return grid; };
+
+
+         /// Sets the grid, in seconds, discarding cached states.
+      virtual SatContextStore& setGrid(double seconds);
+
+
+         /// Returns the retention time, in seconds.
+      virtual double getRetention(void) const
+      { return retention; };
+
+
+         /// Sets the retention time, in seconds.
+      virtual SatContextStore& setRetention(double seconds)
+      { retention = seconds; return (*this); };
+
+
+         /// Returns the wrapped ephemeris store.
+      virtual XvtStore<SatID>& getEphemeris(void) const
+      { return (*pEphemeris); };
+
+
+         /// Dumps the number of cached entries, and the wrapped store.
+      virtual void dump(std::ostream& s = std::cout, short detail = 0) const;
+
+
+         /// Edits the wrapped store, and discards cached data.
+      virtual void edit( const CommonTime& tmin,
+                         const CommonTime& tmax = CommonTime::END_OF_TIME );
+
+
+         /// Discards cached data. The wrapped store is NOT cleared.
+      virtual void clear(void);
+
+
+         /// Returns the time system of the wrapped store.
+      virtual TimeSystem getTimeSystem(void) const
+      { return pEphemeris->getTimeSystem(); };
+
+
+         /// Returns the initial time of the wrapped store.
+      virtual CommonTime getInitialTime(void) const
+      { return pEphemeris->getInitialTime(); };
+
+
+         /// Returns the final time of the wrapped store.
+      virtual CommonTime getFinalTime(void) const
+      { return pEphemeris->getFinalTime(); };
+
+
+         /// Returns true if the wrapped store provides velocity.
+      virtual bool hasVelocity(void) const
+      { return pEphemeris->hasVelocity(); };
+
+
+         /// Returns true if the wrapped store has data for 'sat'.
+      virtual bool isPresent(const SatID& sat) const
+      { return pEphemeris->isPresent(sat); };
+
+
+   private:
+
+
+         /// Satellite states at the start of a grid cell, by satellite.
+      typedef std::map<SatID, Xvt> XvtMap;
+
+
+         /// Wrapped ephemeris store.
+      XvtStore<SatID>* pEphemeris;
+
+
+         /// Time span sharing a single evaluation.
+      double grid;
+
+
+         /// Cached data older than this, in seconds, is discarded.
+      double retention;
+
+
+         /// Satellite states, by grid cell.
+      mutable std::map<CommonTime, XvtMap> xvtCache;
+
+
+         /// Sun positions, by epoch.
+      mutable std::map<CommonTime, Triple> sunCache;
+
+
+         /// Moon positions, by epoch.
+      mutable std::map<CommonTime, Triple> moonCache;
+
+
+         /// Protects the caches.
+      mutable std::mutex cacheMutex;
+
+
+         /// Returns the grid cell holding 't'.
+      CommonTime gridCell(const CommonTime& t) const;
+
+
+         /// Discards entries older than the retention time from 'cache'.
+      template <class T>
+      void prune(std::map<CommonTime, T>& cache) const;
+
+
+         /// Extrapolates 'ref', valid at 't0', to 't'.
+      static Xvt extrapolate( const Xvt& ref,
+                              const CommonTime& t0,
+                              const CommonTime& t );
+
+
+   }; // End of class 'SatContextStore'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_SATCONTEXTSTORE_HPP
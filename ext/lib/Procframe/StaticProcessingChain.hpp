@@ -0,0 +1,333 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file StaticProcessingChain.hpp
+ * This is a class to chain ProcessingClass objects at compile time.
+ */
+
+#ifndef GPSTK_STATICPROCESSINGCHAIN_HPP
+#define GPSTK_STATICPROCESSINGCHAIN_HPP
+
+#include <tuple>
+#include <type_traits>
+#include "ProcessingClass.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions
+      //@{
+
+
+      /** Tells whether class T processes each satellite independently of
+       *  the others.
+       *
+       * Such classes provide the method:
+       *
+       * @code
+       *   bool processSatellite( const CommonTime& time,
+       *                          const SatID& sat,
+       *                          typeValueMap& tvMap );
+       * @endcode
+       *
+       * which processes the data of a single satellite and returns false
+       * if that satellite must be removed from the GDS. Their Process()
+       * methods must be equivalent to calling processSatellite() for every
+       * satellite and then removing the rejected ones.
+       */
+   template <class T>
+   struct isSatelliteLocal
+   {
+      template <class U>
+      static char test( decltype( &U::processSatellite ) );
+
+      template <class U>
+      static long test(...);
+
+      static const bool value = ( sizeof(test<T>(0)) == sizeof(char) );
+   };
+
+
+
+      /** This is a class to chain ProcessingClass objects at compile time.
+       *
+       * Unlike ProcessingList, which calls the virtual Process() method of
+       * each element through a pointer, the types of the elements are known
+       * here, so their methods are called without virtual dispatch and the
+       * compiler is free to inline them.
+       *
+       * Moreover, consecutive elements that are satellite-local (see
+       * 'isSatelliteLocal') are fused: instead of each element looping over
+       * all the satellites in turn, a single loop visits each satellite and
+       * calls all those elements on it while its data is hot in cache. A
+       * satellite rejected by an element is not seen by the following ones,
+       * just as if the elements had been applied one after the other.
+       *
+       * The chain itself is a ProcessingClass, so it may be used with the
+       * ">>" operator and inserted into a ProcessingList or used as a stage
+       * of a ProcessingPipeline.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   RinexObsStream rin("ebre0300.02o");
+       *   gnssRinex gRin;
+       *
+       *   BasicModel basic(nominalPos, SP3EphList);
+       *   ComputeLC getLC;
+       *   ComputeTropModel computeTropo(neillTM);
+       *   ComputeSimpleWeights weights;
+       *
+       *      // 'getLC', 'computeTropo' and 'weights' share one loop
+       *   StaticProcessingChain< BasicModel,
+       *                          ComputeLC,
+       *                          ComputeTropModel,
+       *                          ComputeSimpleWeights >
+       *      chain(basic, getLC, computeTropo, weights);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> chain;
+       *   }
+       * @endcode
+       *
+       * The elements are NOT owned by the chain, which keeps references to
+       * them.
+       *
+       * @sa ProcessingList.hpp for the run-time equivalent.
+       */
+   template <class... Stages>
+   class StaticProcessingChain : public ProcessingClass
+   {
+   public:
+
+
+         /** Common constructor.
+          *
+          * @param stages     Processing objects, in order of application.
+          */
+      StaticProcessingChain(Stages&... stages)
+         : chain(stages...)
+      { };
+
+
+         /** Returns a gnnsSatTypeValue object, adding the new data
+          *  generated when calling this object.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssSatTypeValue& Process(gnssSatTypeValue& gData)
+         throw(ProcessingException)
+      { run<0>(gData, isStart<0>()); return gData; };
+
+
+         /** Returns a gnnsRinex object, adding the new data generated when
+          *  calling this object.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssRinex& Process(gnssRinex& gData)
+         throw(ProcessingException)
+      { run<0>(gData, isStart<0>()); return gData; };
+
+
+         /// Returns the number of processing objects in the chain.
+      static int size(void)
+      { return sizeof...(Stages); };
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const
+      { return "StaticProcessingChain"; };
+
+
+         /// Destructor
+      virtual ~StaticProcessingChain() {};
+
+
+   private:
+
+
+         /// References to the processing objects.
+      std::tuple<Stages&...> chain;
+
+
+         /// Whether the I-th processing object is satellite-local. It is
+         /// false past the end of the chain.
+      template <size_t I, bool inChain = ( I < sizeof...(Stages) )>
+      struct local
+         : std::integral_constant< bool,
+              isSatelliteLocal< typename std::tuple_element< I,
+                                   std::tuple<Stages...> >::type >::value >
+      { };
+
+      template <size_t I>
+      struct local<I, false> : std::false_type
+      { };
+
+
+         /// End (one past the last) of the run of satellite-local objects
+         /// that starts with the I-th one.
+      template <size_t I, bool isLocal = local<I>::value>
+      struct runEnd : std::integral_constant< size_t, runEnd<I+1>::value >
+      { };
+
+      template <size_t I>
+      struct runEnd<I, false> : std::integral_constant< size_t, I >
+      { };
+
+
+         /// Tag telling whether there are objects left from I on, and
+         /// whether the I-th one starts a run of satellite-local objects.
+      template <size_t I>
+      struct isStart
+         : std::integral_constant< int, ( I >= sizeof...(Stages) ) ? 0 :
+                                        ( local<I>::value ? 2 : 1 ) >
+      { };
+
+
+         /// No objects left.
+      template <size_t I, class GDS>
+      void run(GDS& gData, std::integral_constant<int,0>)
+      { };
+
+
+         /// The I-th object is applied on its own, without virtual call.
+      template <size_t I, class GDS>
+      void run(GDS& gData, std::integral_constant<int,1>)
+      {
+         typedef typename std::tuple_element< I,
+                                    std::tuple<Stages...> >::type StageType;
+
+         std::get<I>(chain).StageType::Process(gData);
+
+         run<I+1>(gData, isStart<I+1>());
+      };
+
+
+         /// Objects [I, runEnd<I>()) are applied in a single satellite loop.
+      template <size_t I, class GDS>
+      void run(GDS& gData, std::integral_constant<int,2>)
+      {
+         const size_t J( runEnd<I>::value );
+
+         try
+         {
+
+            SatIDSet satRejectedSet;
+
+               // Loop through all the satellites
+            satTypeValueMap::iterator it;
+            for( it = gData.body.begin(); it != gData.body.end(); ++it )
+            {
+               if( !runSatellite<I, J>( gData.header.epoch,
+                                       (*it).first,
+                                       (*it).second ) )
+               {
+                  satRejectedSet.insert( (*it).first );
+               }
+            }
+
+               // Remove satellites rejected by any of the objects
+            gData.body.removeSatID(satRejectedSet);
+
+         }
+         catch(Exception& u)
+         {
+               // Throw an exception if something unexpected happens
+            ProcessingException e( getClassName() + ":"
+                                   + u.what() );
+
+            GPSTK_THROW(e);
+
+         }
+
+         run<J>(gData, isStart<J>());
+      };
+
+
+         /// Apply objects [I, J) to one satellite, stopping at the first
+         /// one rejecting it.
+      template <size_t I, size_t J>
+      typename std::enable_if< (I < J), bool >::type
+      runSatellite( const CommonTime& time,
+                    const SatID& sat,
+                    typeValueMap& tvMap )
+      {
+         typedef typename std::tuple_element< I,
+                                    std::tuple<Stages...> >::type StageType;
+
+         return ( std::get<I>(chain).StageType::processSatellite( time,
+                                                                  sat,
+                                                                  tvMap )
+                  && runSatellite<I+1, J>(time, sat, tvMap) );
+      };
+
+
+         /// End of the satellite-local run.
+      template <size_t I, size_t J>
+      typename std::enable_if< (I >= J), bool >::type
+      runSatellite( const CommonTime& time,
+                    const SatID& sat,
+                    typeValueMap& tvMap )
+      { return true; };
+
+
+   }; // End of class 'StaticProcessingChain'
+
+
+
+      /** Builds a StaticProcessingChain, deducing the types of its elements.
+       *
+       * @code
+       *   auto chain( makeStaticChain(getLC, computeTropo) );
+       *   gRin >> chain;
+       * @endcode
+       *
+       * @param stages     Processing objects, in order of application.
+       */
+   template <class... Stages>
+   StaticProcessingChain<Stages...> makeStaticChain(Stages&... stages)
+   { return StaticProcessingChain<Stages...>(stages...); }
+
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_STATICPROCESSINGCHAIN_HPP
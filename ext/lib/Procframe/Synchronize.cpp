@@ -71,6 +71,50 @@ namespace gpstk
 
 
 
+      // Default capacity of the ring buffer.
+   const int Synchronize::defaultCapacity = 4;
+
+
+
+      /* Sets the capacity of the reference data ring buffer. Two
+       * epochs are enough to synchronize and interpolate; extra room
+       * is not needed. Buffered data is discarded.
+       *
+       * @param capacity      Number of reference epochs, at least 2.
+       */
+   Synchronize& Synchronize::setBufferCapacity(int capacity)
+   {
+
+      if( capacity < 2 )
+      {
+         capacity = 2;
+      }
+
+      ringBuffer.resize(capacity);
+      ringHead = 0;
+      ringCount = 0;
+
+      return (*this);
+
+   }  // End of method 'Synchronize::setBufferCapacity()'
+
+
+
+      // Resets the ring buffer and the monitoring values.
+   void Synchronize::init(void)
+   {
+
+      firstTime = true;
+      endOfStream = false;
+      ringHead = 0;
+      ringCount = 0;
+      offset = 0.0;
+      latency = 0.0;
+
+   }  // End of method 'Synchronize::init()'
+
+
+
       /* Returns a gnnsRinex object, adding the new data generated
        * when calling this object.
        *
@@ -79,11 +123,16 @@ namespace gpstk
    gnssRinex& Synchronize::Process(gnssRinex& gData)
       throw(SynchronizeException)
    {
-      CommonTime time = dynamic_cast<gnssRinex*>(pgRov1)->header.epoch;
+
+         // gnssRinex shadows the header of gnssSatTypeValue
+      gnssRinex* pRov( dynamic_cast<gnssRinex*>(pgRov1) );
+      CommonTime time( pRov != NULL ? pRov->header.epoch
+                                    : pgRov1->header.epoch );
+
       Process(time,gData);
 
       return gData;
-      
+
    }  // End of method 'Synchronize::Process()'
 
 
@@ -96,68 +145,190 @@ namespace gpstk
    gnssSatTypeValue& Synchronize::Process(gnssSatTypeValue& gData)
       throw(SynchronizeException)
    {
-      CommonTime time(pgRov1->header.epoch);
-      
+
+      gnssRinex* pRov( dynamic_cast<gnssRinex*>(pgRov1) );
+      CommonTime time( pRov != NULL ? pRov->header.epoch
+                                    : pgRov1->header.epoch );
+
       gnssRinex gRin;
       Process(time,gRin);
-      
+
       gData.header = gRin.header;
-      gData.body = gRin.body;
+      gData.body.swap(gRin.body);
 
       return gData;
 
    }  // End of method 'Synchronize::Process()'
 
 
+
    gnssRinex& Synchronize::Process(CommonTime time, gnssRinex& gData)
       throw(SynchronizeException)
    {
-      
-      if (firstTime)
-      {
-         (*pRinexRef) >> gData;      // Get data out of ref station RINEX file
-
-         gnssRinexBuffer.clear();
-         gnssRinexBuffer.push_back(gData);
 
+      if( firstTime )
+      {
+         ringHead = 0;
+         ringCount = 0;
+         endOfStream = false;
          firstTime = false;          // Mark that first data batch was read
       }
 
-      gData = gnssRinexBuffer.front();
+         // Read reference data until it reaches the rover epoch, or until
+         // the last epoch read is within tolerance of it: an epoch after
+         // the rover epoch is then needed by neither synchronization nor
+         // interpolation. Objects of the ring buffer are reused, and when
+         // it is full the oldest epoch is dropped.
+      while( !endOfStream &&
+             ( ringCount == 0 ||
+               ( ringAt(ringCount-1).header.epoch < time &&
+                 ( time - ringAt(ringCount-1).header.epoch ) > tolerance ) ) )
+      {
+         if( ringCount == ringBuffer.size() )
+         {
+            ringPop();
+         }
+
+         if( (*pRinexRef) >> ringAt(ringCount) )
+         {
+            ++ringCount;
+         }
+         else
+         {
+            endOfStream = true;
+         }
+      }
 
-      if( (gData.header.epoch > time) && 
-         (std::abs( gData.header.epoch - time ) > tolerance ))
+         // Keep only the last reference epoch before the rover epoch, and
+         // the following ones
+      while( ringCount > 1 && !( time < ringAt(1).header.epoch ) )
       {
-         // If synchronization is not possible, we issue an exception
+         ringPop();
+      }
+
+      if( ringCount == 0 )
+      {
+            // If synchronization is not possible, we issue an exception
          SynchronizeException e( "Unable to synchronize data at epoch "
             + time.asString() );
          GPSTK_THROW(e);
       }
 
-      // Check that the reference data time stamp is not less than gData's,
-      // and that tolerance is within limits. If not, keep reading.
-      // Note that if reference data time stamp is bigger, it will not
-      // enter here, "waiting" for gData to catch up.
-
-      while ( ( gData.header.epoch < time ) &&
-         (std::abs( gData.header.epoch - time ) > tolerance ) )
+         // Find the closest reference epoch. It is either the first one or
+         // the second one.
+      size_t best(0);
+      if( ringCount > 1 &&
+          std::abs( ringAt(1).header.epoch - time ) <
+          std::abs( ringAt(0).header.epoch - time ) )
       {
-         (*pRinexRef) >> gData;   // Get data out of ref station RINEX file
+         best = 1;
       }
 
+         // The caller waited for the last reference epoch read
+      double ahead( ringAt(ringCount-1).header.epoch - time );
+      latency = ( ahead > 0.0 ? ahead : 0.0 );
+
+      const gnssRinex& ref( ringAt(best) );
+      double diff( ref.header.epoch - time );
 
-      // If we couldn't synchronize data streams (i.e.: "tolerance"
-      // is not met), skip this epoch.
-      if ( std::abs( gData.header.epoch - time ) > tolerance )
+      if( std::abs(diff) <= tolerance )
       {
-         // If synchronization is not possible, we issue an exception
-         SynchronizeException e( "Unable to synchronize data at epoch "
-            + time.asString() );
-         GPSTK_THROW(e);
+            // Assignment reuses the storage already held by 'gData'
+         gData = ref;
+
+         offset = diff;
+
+         return gData;
       }
 
+         // If we couldn't synchronize data streams (i.e.: "tolerance"
+         // is not met), try to interpolate
+      if( interpolation && ringCount > 1 )
+      {
+         const gnssRinex& a( ringAt(0) );
+         const gnssRinex& b( ringAt(1) );
+
+         if( a.header.epoch < time && time < b.header.epoch &&
+             ( b.header.epoch - a.header.epoch ) <= maxInterpolationGap )
+         {
+            interpolate(a, b, time, gData);
+
+            offset = 0.0;
+
+            return gData;
+         }
+      }
+
+         // If synchronization is not possible, we issue an exception
+      SynchronizeException e( "Unable to synchronize data at epoch "
+         + time.asString() );
+      GPSTK_THROW(e);
 
-      return gData;
    }  // End of method 'Synchronize::Process(CommonTime time, gnssRinex& gData)'
 
+
+
+      // Interpolates reference data between epochs 'a' and 'b'.
+   void Synchronize::interpolate( const gnssRinex& a,
+                                  const gnssRinex& b,
+                                  const CommonTime& time,
+                                  gnssRinex& gData ) const
+   {
+
+         // Indicators can't be interpolated: the later epoch tells whether
+         // lock was lost since the former one
+      static const TypeID indicators[] = { TypeID::LLI1, TypeID::LLI2,
+                                           TypeID::LLI5, TypeID::LLI6,
+                                           TypeID::LLI7, TypeID::LLI8,
+                                           TypeID::SSI1, TypeID::SSI2,
+                                           TypeID::SSI5, TypeID::SSI6,
+                                           TypeID::SSI7, TypeID::SSI8 };
+      static const TypeIDSet indicatorSet( indicators, indicators + 12 );
+
+      double w( (time - a.header.epoch) /
+                (b.header.epoch - a.header.epoch) );
+
+      gData.header = a.header;
+      gData.header.epoch = time;
+      gData.body.clear();
+
+         // Only satellites and types present in both epochs are kept
+      for( satTypeValueMap::const_iterator ita = a.body.begin();
+           ita != a.body.end();
+           ++ita )
+      {
+         satTypeValueMap::const_iterator itb( b.body.find(ita->first) );
+         if( itb == b.body.end() )
+         {
+            continue;
+         }
+
+         typeValueMap& tvMap( gData.body[ita->first] );
+
+         for( typeValueMap::const_iterator itta = ita->second.begin();
+              itta != ita->second.end();
+              ++itta )
+         {
+            typeValueMap::const_iterator ittb(
+                                          itb->second.find(itta->first) );
+            if( ittb == itb->second.end() )
+            {
+               continue;
+            }
+
+            if( indicatorSet.find(itta->first) != indicatorSet.end() )
+            {
+               tvMap[itta->first] = ittb->second;
+            }
+            else
+            {
+               tvMap[itta->first] = itta->second
+                                  + w * ( ittb->second - itta->second );
+            }
+         }
+      }
+
+   }  // End of method 'Synchronize::interpolate()'
+
+
 }  // End of namespace gpstk
@@ -43,7 +43,7 @@
 #ifndef GPSTK_SYNCHRONIZE_HPP
 #define GPSTK_SYNCHRONIZE_HPP
 
-#include <list>
+#include <vector>
 #include "Exception.hpp"
 #include "ProcessingClass.hpp"
 
@@ -154,6 +154,21 @@ namespace gpstk
        * appropriately, usually just issuing a 'continue' statement in order to
        * process next epoch.
        *
+       * Reference epochs are kept in a fixed-capacity ring buffer whose
+       * objects are reused, so memory stays constant whatever the rates of
+       * both streams. Only the reference epochs around the current rover
+       * epoch are kept: reading stops as soon as a reference epoch at or
+       * after the rover epoch is found, and older ones are discarded.
+       *
+       * When reference data is sparser than rover data (for instance, a
+       * 30 s reference station with a 1 Hz rover), rover epochs that fall
+       * between two reference epochs may be served with reference values
+       * linearly interpolated to the rover epoch, see setInterpolation().
+       * Interpolation is off by default.
+       *
+       * getOffset(), getLatency() and getBufferDepth() allow monitoring of
+       * the synchronization.
+       *
        * @sa Decimate.hpp for another time management class.
        *
        */
@@ -164,8 +179,9 @@ namespace gpstk
          /// Default constructor
       Synchronize()
          : pRinexRef(NULL), pgRov1(NULL), tolerance(1.0),
-           firstTime(true)
-      { };
+           firstTime(true), ringBuffer(defaultCapacity),
+           interpolation(false), maxInterpolationGap(30.0)
+      { init(); };
 
 
          /** Common constructor.
@@ -177,7 +193,8 @@ namespace gpstk
       Synchronize( RinexObsStream& rinexObs,
                    gnssRinex& roverData,
                    const double tol = 1.0 )
-         : tolerance(tol), firstTime(true)
+         : tolerance(tol), firstTime(true), ringBuffer(defaultCapacity),
+           interpolation(false), maxInterpolationGap(30.0)
       { setReferenceSource(rinexObs); setRoverData(roverData); };
 
 
@@ -190,7 +207,8 @@ namespace gpstk
       Synchronize( RinexObsStream& rinexObs,
                    gnssSatTypeValue& roverData,
                    const double tol = 1.0 )
-         : tolerance(tol), firstTime(true)
+         : tolerance(tol), firstTime(true), ringBuffer(defaultCapacity),
+           interpolation(false), maxInterpolationGap(30.0)
       { setReferenceSource(rinexObs); setRoverData(roverData); };
 
 
@@ -224,6 +242,69 @@ namespace gpstk
       virtual Synchronize& setTolerance(const double tol);
 
 
+         /// Returns true if interpolation of reference data is enabled.
+      virtual bool getInterpolation(void) const
+      { return interpolation; };
+
+
+         /** Enables or disables linear interpolation of reference data.
+          *
+          * When no reference epoch is within tolerance of the rover epoch,
+          * but there are reference epochs before and after it no more than
+          * 'maxGap' seconds apart, the values common to both are linearly
+          * interpolated to the rover epoch. Loss of lock and signal
+          * strength indicators are taken from the later epoch.
+          *
+          * @param interp        Whether to interpolate.
+          * @param maxGap        Maximum time between the reference epochs
+          *                      used, in seconds.
+          *
+          * \warning Linear interpolation of raw observables over long
+          * intervals may produce errors of several meters, due to the
+          * acceleration of the satellite-receiver range. It is better
+          * suited to smooth quantities, like prefit residuals.
+          */
+      virtual Synchronize& setInterpolation( bool interp,
+                                             double maxGap = 30.0 )
+      { interpolation = interp; maxInterpolationGap = maxGap;
+        return (*this); };
+
+
+         /// Returns the capacity of the reference data ring buffer.
+      virtual int getBufferCapacity(void) const
+      { return ringBuffer.size(); };
+
+
+         /** Sets the capacity of the reference data ring buffer. Two
+          *  epochs are enough to synchronize and interpolate; extra room
+          *  is not needed. Buffered data is discarded.
+          *
+          * @param capacity      Number of reference epochs, at least 2.
+          */
+      virtual Synchronize& setBufferCapacity(int capacity);
+
+
+         /// Returns the number of reference epochs currently buffered.
+      virtual int getBufferDepth(void) const
+      { return ringCount; };
+
+
+         /** Returns the time, in seconds, from the last synchronized rover
+          *  epoch to the reference epoch given to it (negative if the
+          *  reference data is older). It is zero for interpolated data.
+          */
+      virtual double getOffset(void) const
+      { return offset; };
+
+
+         /** Returns how far, in seconds, reference data had to be read
+          *  ahead of the last synchronized rover epoch. In real time, this
+          *  is the minimum delay of the synchronized output.
+          */
+      virtual double getLatency(void) const
+      { return latency; };
+
+
          /// Returns a pointer to the RinexObsStream object of reference data.
       virtual RinexObsStream* getPtrReferenceSource(void) const
       { return pRinexRef; };
@@ -234,7 +315,7 @@ namespace gpstk
           * @param rinexObs      RinexObsStream object of reference data.
           */
       virtual Synchronize& setReferenceSource(RinexObsStream& rinexObs)
-      { pRinexRef = &rinexObs; firstTime=true; return (*this); }
+      { pRinexRef = &rinexObs; init(); return (*this); }
 
 
          /** Sets the gnssRinex that holds ROVER receiver data.
@@ -266,10 +347,6 @@ namespace gpstk
       virtual gnssRinex& Process(CommonTime time, gnssRinex& gData)
          throw(SynchronizeException);
 
-         /// gnssRinex data buffer
-      std::list<gnssRinex> gnssRinexBuffer;
-
-
          /// Pointer to input observation file stream for reference station.
       RinexObsStream* pRinexRef;
 
@@ -285,6 +362,63 @@ namespace gpstk
       bool firstTime;
 
 
+         /// Default capacity of the ring buffer.
+      static const int defaultCapacity;
+
+
+         /// Ring buffer of reference epochs, in time order.
+      std::vector<gnssRinex> ringBuffer;
+
+
+         /// Index of the oldest epoch in 'ringBuffer'.
+      size_t ringHead;
+
+
+         /// Number of epochs in 'ringBuffer'.
+      size_t ringCount;
+
+
+         /// Flag to mark that the reference stream is exhausted.
+      bool endOfStream;
+
+
+         /// Whether reference data may be interpolated.
+      bool interpolation;
+
+
+         /// Maximum time between interpolated reference epochs, in seconds.
+      double maxInterpolationGap;
+
+
+         /// Offset of the last synchronized reference data, in seconds.
+      double offset;
+
+
+         /// Read-ahead needed by the last synchronization, in seconds.
+      double latency;
+
+
+         /// Resets the ring buffer and the monitoring values.
+      void init(void);
+
+
+         /// Returns the i-th oldest epoch of the ring buffer.
+      gnssRinex& ringAt(size_t i)
+      { return ringBuffer[ (ringHead + i) % ringBuffer.size() ]; };
+
+
+         /// Discards the oldest epoch of the ring buffer.
+      void ringPop(void)
+      { ringHead = (ringHead + 1) % ringBuffer.size(); --ringCount; };
+
+
+         /// Interpolates reference data between epochs 'a' and 'b'.
+      void interpolate( const gnssRinex& a,
+                        const gnssRinex& b,
+                        const CommonTime& time,
+                        gnssRinex& gData ) const;
+
+
    }; // End of class 'Synchronize'
 
       //@}
@@ -0,0 +1,315 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "IonexStore.hpp"
+#include "CivilTime.hpp"
+#include <iostream>
+#include <sstream>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// Result of one query: the values, or whether it threw InvalidRequest.
+struct Query
+{
+   Triple value;
+   bool invalid;
+};
+
+
+class IonexStore_T
+{
+public:
+   IonexStore_T()
+         : first(CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::Any))
+   {
+         // synthetic 2-hour maps on a 12.5 x 15 degree grid, from 87.5N
+         // to 87.5S and from 180W to 180E, with a few undefined values
+      inxFile = getPathData() + getFileSep() +
+         "test_input_ionex_synthetic.15i";
+
+      unpacked.setPackedMode(false);
+      packed.loadFile(inxFile);
+      unpacked.loadFile(inxFile);
+
+         // map epochs, the last one included, and epochs between them
+      for (int k = 0; k <= 12; k++)
+         times.push_back(first + 7200.0*k);
+      for (int k = 0; k < 12; k++)
+         times.push_back(first + 7200.0*k + 1234.5);
+      times.push_back(first + 0.25);
+      times.push_back(first + 86400.0 - 0.25);
+
+         // latitudes inside the grid, on and next to its edges, and
+         // beyond them
+      const double lats[] = { 88.0, 87.5, 87.4, 80.0, 13.7, 0.0, -45.3,
+                              -87.4, -87.5, -88.0 };
+         // longitudes (degrees East, [0, 360)) on both sides of the
+         // +-180 wrap, on grid points and between them
+      const double lons[] = { 0.0, 7.5, 95.0, 179.9, 180.0, 180.1, 190.0,
+                              352.5, 359.99 };
+      for (int i = 0; i < 10; i++)
+         for (int j = 0; j < 9; j++)
+            positions.push_back(Position(lats[i], lons[j], 6821137.0,
+                                         Position::Geocentric));
+   }
+
+
+      /** Calls getIonexValue(), catching InvalidRequest. */
+   Query query(const IonexStore& store, const CommonTime& t,
+               const Position& pos, int strategy)
+   {
+      Query q;
+      q.invalid = false;
+      try
+      {
+         q.value = store.getIonexValue(t, pos, strategy);
+      }
+      catch (InvalidRequest& e)
+      {
+         q.invalid = true;
+      }
+      return q;
+   }
+
+
+      /** Position and epoch of a query, for messages. */
+   string where(const CommonTime& t, const Position& pos, int strategy)
+   {
+      ostringstream oss;
+      oss << "strategy " << strategy << " at " << CivilTime(t)
+          << " lat " << pos.theArray[0] << " lon " << pos.theArray[1];
+      return oss.str();
+   }
+
+
+      /** The maps are packed unless packing is turned off. */
+   int packTest(void)
+   {
+      TUDEF("IonexStore", "packMaps");
+      TUASSERT(packed.isPacked());
+      TUASSERT(!unpacked.isPacked());
+      TUASSERTE(CommonTime, first, packed.getInitialTime());
+      TUASSERTE(CommonTime, first + 86400.0, packed.getFinalTime());
+
+      IonexStore store;
+      store.loadFile(inxFile);
+      store.setPackedMode(false);
+      TUASSERT(!store.isPacked());
+      store.setPackedMode(true);
+      TUASSERT(store.isPacked());
+      TURETURN();
+   }
+
+
+      /** For the four strategies, getIonexValue() gives the same values
+       * with packed maps as with the individual maps, at map epochs and
+       * between them, around the +-180 degree wrap in longitude and at
+       * the latitude edges of the grid, and both throw InvalidRequest
+       * for the same queries. */
+   int valueTest(void)
+   {
+      TUDEF("IonexStore", "getIonexValue");
+      int valid = 0, invalid = 0;
+      for (int strategy = 1; strategy <= 4; strategy++)
+      {
+         for (size_t i = 0; i < times.size(); i++)
+         {
+            for (size_t j = 0; j < positions.size(); j++)
+            {
+               Query exp = query(unpacked, times[i], positions[j], strategy);
+               Query got = query(packed, times[i], positions[j], strategy);
+               string msg = where(times[i], positions[j], strategy);
+               testFramework.assert(exp.invalid == got.invalid,
+                                    "InvalidRequest mismatch, " + msg,
+                                    __LINE__);
+               if (exp.invalid || got.invalid)
+               {
+                  invalid++;
+                  continue;
+               }
+               for (int k = 0; k < 3; k++)
+                  testFramework.assert(exp.value[k] == got.value[k],
+                                       "value mismatch, " + msg, __LINE__);
+               valid++;
+            }
+         }
+      }
+         // both kinds of query were made
+      TUASSERT(valid > 1000);
+      TUASSERT(invalid > 100);
+
+         // values on grid points are the map values, in TECU
+      Position grid(13.7 - 1.2, 0.0, 6821137.0, Position::Geocentric);
+      Query q = query(packed, first + 7200.0, grid, 1);
+      TUASSERT(!q.invalid);
+      TUASSERT(q.value[0] > 0.0 && q.value[0] < 50.0);
+      TUASSERT(q.value[1] > 0.0 && q.value[1] < 10.0);
+      TUASSERTE(double, 6821137.0, q.value[2]);
+      TURETURN();
+   }
+
+
+      /** At the last epoch, both paths use the last interval, so that
+       * interpolating and nearest-map strategies give the last map. */
+   int lastEpochTest(void)
+   {
+      TUDEF("IonexStore", "getIonexValue");
+      CommonTime last(first + 86400.0);
+      Position pos(40.0, 15.0, 6821137.0, Position::Geocentric);
+      for (int strategy = 1; strategy <= 2; strategy++)
+      {
+         Query exp = query(unpacked, last, pos, strategy);
+         Query got = query(packed, last, pos, strategy);
+         TUASSERT(!exp.invalid);
+         TUASSERT(!got.invalid);
+         for (int k = 0; k < 2; k++)
+            TUASSERTE(double, exp.value[k], got.value[k]);
+      }
+      Query nearest = query(packed, last, pos, 1);
+      Query interp = query(packed, last, pos, 2);
+      for (int k = 0; k < 2; k++)
+         TUASSERTFEPS(nearest.value[k], interp.value[k], 1.e-12);
+
+         // after the last epoch there is no data
+      TUASSERT(query(packed, last + 1.0, pos, 1).invalid);
+      TUASSERT(query(unpacked, last + 1.0, pos, 1).invalid);
+      TUASSERT(query(packed, first - 1.0, pos, 1).invalid);
+      TUASSERT(query(unpacked, first - 1.0, pos, 1).invalid);
+      TURETURN();
+   }
+
+
+      /** Undefined map values (9999 in the file) raise InvalidRequest in
+       * both paths. */
+   int undefinedTest(void)
+   {
+      TUDEF("IonexStore", "getIonexValue");
+         // map 5 is undefined at 62.5S 90E, map 9 at 12.5N 180W
+      CommonTime t5(first + 4*7200.0), t9(first + 8*7200.0);
+      Position p5(-60.0, 91.0, 6821137.0, Position::Geocentric);
+      Position p9(10.0, 185.0, 6821137.0, Position::Geocentric);
+      Position p9w(10.0, 178.0, 6821137.0, Position::Geocentric);
+      TUASSERT(query(unpacked, t5, p5, 1).invalid);
+      TUASSERT(query(packed, t5, p5, 1).invalid);
+      TUASSERT(query(unpacked, t9, p9, 1).invalid);
+      TUASSERT(query(packed, t9, p9, 1).invalid);
+         // the +180 column is stored apart from the -180 one, and is
+         // defined
+      TUASSERT(!query(unpacked, t9, p9w, 1).invalid);
+      TUASSERT(!query(packed, t9, p9w, 1).invalid);
+         // the maps before are defined there
+      TUASSERT(!query(packed, t5 - 7200.0, p5, 1).invalid);
+      TUASSERT(!query(unpacked, t9 - 7200.0, p9, 1).invalid);
+      TURETURN();
+   }
+
+
+      /** getIonexValues() gives, for several positions, the values of
+       * getIonexValue() for each of them, for both paths. */
+   int valuesTest(void)
+   {
+      TUDEF("IonexStore", "getIonexValues");
+      for (int strategy = 1; strategy <= 4; strategy++)
+      {
+         for (size_t i = 0; i < times.size(); i++)
+         {
+               // the positions with a defined value
+            vector<Position> inside;
+            for (size_t j = 0; j < positions.size(); j++)
+               if (!query(unpacked, times[i], positions[j], strategy).invalid)
+                  inside.push_back(positions[j]);
+
+            vector<Triple> byPacked, byUnpacked;
+            packed.getIonexValues(times[i], inside, byPacked, strategy);
+            unpacked.getIonexValues(times[i], inside, byUnpacked, strategy);
+            TUASSERTE(size_t, inside.size(), byPacked.size());
+            TUASSERTE(size_t, inside.size(), byUnpacked.size());
+            for (size_t j = 0; j < inside.size(); j++)
+            {
+               Triple exp = unpacked.getIonexValue(times[i], inside[j],
+                                                   strategy);
+               for (int k = 0; k < 3; k++)
+               {
+                  TUASSERTE(double, exp[k], byPacked[j][k]);
+                  TUASSERTE(double, exp[k], byUnpacked[j][k]);
+               }
+            }
+         }
+      }
+
+         // a position outside the grid makes the whole call fail
+      vector<Position> outside(positions.begin(), positions.begin() + 9);
+      vector<Triple> values;
+      try
+      {
+         packed.getIonexValues(first, outside, values, 3);
+         TUFAIL("Expected InvalidRequest");
+      }
+      catch (InvalidRequest& e)
+      {
+         TUPASS("InvalidRequest");
+      }
+      TURETURN();
+   }
+
+
+   string inxFile;
+   CommonTime first;
+   IonexStore packed, unpacked;
+   vector<CommonTime> times;
+   vector<Position> positions;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   IonexStore_T testClass;
+
+   errorTotal += testClass.packTest();
+   errorTotal += testClass.valueTest();
+   errorTotal += testClass.lastEpochTest();
+   errorTotal += testClass.undefinedTest();
+   errorTotal += testClass.valuesTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,408 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <math.h>
+
+#include "ClockStability.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Tolerance of the comparisons with the direct sums
+static const double eps = 1.e-12;
+
+class ClockStability_T
+{
+public:
+   ClockStability_T()
+   {
+         // an arbitrary phase series without zeros
+      for(int i=0; i<64; i++)
+         phase.push_back(1.0 + sin(0.37*i) + 0.01*i + ((i*7919)%13)/26.0);
+   }
+
+      /** Overlapping Allan deviation summed directly.  Terms with a
+       * zero phase are gaps, except the first and last ones. */
+   static ClockStability::Point refADEV(const vector<double>& x,
+                                        unsigned long m)
+   {
+      ClockStability::Point p;
+      unsigned long N = x.size(), n = N-2*m;
+      p.m = m;
+      p.tau = m;
+      p.numGaps = 0;
+      double sum = 0;
+      for(unsigned long i=0; i<n; i++) {
+         if((x[i]==0 || x[i+m]==0 || x[i+2*m]==0) && i!=0 && i!=n-1) {
+            p.numGaps++;
+            continue;
+         }
+         double d = x[i+2*m] - 2*x[i+m] + x[i];
+         sum += d*d;
+      }
+      p.deviation = sqrt(sum/(2.0*(N-p.numGaps-2.0*m)*m*m));
+      return p;
+   }
+
+      /** Modified Allan deviation summed directly.  Within each window,
+       * terms with a zero phase are gaps except the last one and the
+       * one at i=0. */
+   static ClockStability::Point refMDEV(const vector<double>& x,
+                                        unsigned long m)
+   {
+      ClockStability::Point p;
+      unsigned long N = x.size();
+      p.m = m;
+      p.tau = m;
+      p.numGaps = 0;
+      double sum = 0;
+      for(unsigned long j=0; j<N-3*m+1; j++) {
+         double w = 0;
+         for(unsigned long i=j; i<j+m; i++) {
+            if((x[i]==0 || x[i+m]==0 || x[i+2*m]==0) && i!=0 && i!=j+m-1) {
+               p.numGaps++;
+               continue;
+            }
+            w += x[i+2*m] - 2*x[i+m] + x[i];
+         }
+         sum += w*w;
+      }
+      p.deviation = sqrt(sum/(2.0*m*m*m*m*(N-p.numGaps-3.0*m+1)));
+      return p;
+   }
+
+      /** Overlapping Hadamard deviation summed directly. */
+   static ClockStability::Point refHDEV(const vector<double>& x,
+                                        unsigned long m)
+   {
+      ClockStability::Point p;
+      unsigned long N = x.size(), n = N-3*m;
+      p.m = m;
+      p.tau = m;
+      p.numGaps = 0;
+      double sum = 0;
+      for(unsigned long i=0; i<n; i++) {
+         if((x[i]==0 || x[i+m]==0 || x[i+2*m]==0 || x[i+3*m]==0)
+            && i!=0 && i!=n-1) {
+            p.numGaps++;
+            continue;
+         }
+         double d = x[i+3*m] - 3*x[i+2*m] + 3*x[i+m] - x[i];
+         sum += d*d;
+      }
+      p.deviation = sqrt(sum/(6.0*(N-p.numGaps-3.0*m)*m*m));
+      return p;
+   }
+
+      /** Total deviation summed directly over the phase extended by
+       * reflection, x[-k] = 2x[0]-x[k] and x[N-1+k] = 2x[N-1]-x[N-1-k],
+       * stored in an array as tallandev does. */
+   static ClockStability::Point refTOTDEV(const vector<double>& x,
+                                          unsigned long m)
+   {
+      ClockStability::Point p;
+      unsigned long N = x.size(), off = N-2;
+      p.m = m;
+      p.tau = m;
+      p.numGaps = 0;
+      vector<double> ext(3*N-4);
+      for(unsigned long i=0; i<N; i++)
+         ext[off+i] = x[i];
+      for(unsigned long k=1; k<=N-2; k++) {
+         ext[off-k] = 2*x[0] - x[k];
+         ext[off+N-1+k] = 2*x[N-1] - x[N-1-k];
+      }
+      double sum = 0;
+      for(unsigned long i=off+1; i<off+N-1; i++) {
+         double d = ext[i-m] - 2*ext[i] + ext[i+m];
+         sum += d*d;
+      }
+      p.deviation = sqrt(sum/(2.0*(N-2.0)*m*m));
+      return p;
+   }
+
+      /** Count the points of a curve that differ from the direct sums. */
+   static unsigned countWrong(const vector<ClockStability::Point>& curve,
+                              ClockStability::Statistic stat,
+                              const vector<double>& x)
+   {
+      unsigned wrong = 0;
+      for(size_t i=0; i<curve.size(); i++) {
+         unsigned long m = curve[i].m;
+         ClockStability::Point exp;
+         switch(stat) {
+            case ClockStability::ADEV:   exp = refADEV(x, m); break;
+            case ClockStability::HDEV:   exp = refHDEV(x, m); break;
+            case ClockStability::TOTDEV: exp = refTOTDEV(x, m); break;
+            default:
+               exp = refMDEV(x, m);
+               if(stat == ClockStability::TDEV)
+                  exp.deviation *= exp.tau/sqrt(3.0);
+               break;
+         }
+         if(fabs(exp.deviation - curve[i].deviation) > eps ||
+            exp.tau != curve[i].tau || exp.numGaps != curve[i].numGaps)
+            wrong++;
+      }
+      return wrong;
+   }
+
+      /** Averaging factor sets and their limits. */
+   int factorsTest(void)
+   {
+      TUDEF("ClockStability", "factors");
+      ClockStability cs(phase, 1.0);
+
+      TUASSERTE(unsigned long, 64, cs.size());
+      TUASSERTE(unsigned long, 31, cs.maxFactor(ClockStability::ADEV));
+      TUASSERTE(unsigned long, 21, cs.maxFactor(ClockStability::MDEV));
+      TUASSERTE(unsigned long, 21, cs.maxFactor(ClockStability::TDEV));
+      TUASSERTE(unsigned long, 21, cs.maxFactor(ClockStability::HDEV));
+      TUASSERTE(unsigned long, 63, cs.maxFactor(ClockStability::TOTDEV));
+
+      unsigned long octave[] = { 1, 2, 4, 8, 16 };
+      unsigned long decade[] = { 1, 2, 5, 10, 20, 50 };
+      vector<unsigned long> m;
+      m = ClockStability::factors(ClockStability::Octave, 20);
+      TUASSERT(m == vector<unsigned long>(octave, octave+5));
+      m = ClockStability::factors(ClockStability::Decade, 60);
+      TUASSERT(m == vector<unsigned long>(decade, decade+6));
+      m = ClockStability::factors(ClockStability::All, 5);
+      TUASSERTE(size_t, 5, m.size());
+      TUASSERTE(unsigned long, 5, m.back());
+      m = cs.factors(ClockStability::TOTDEV, ClockStability::Octave);
+      TUASSERTE(unsigned long, 32, m.back());
+      TURETURN();
+   }
+
+      /** Every statistic over all the averaging factors matches the
+       * direct sums. */
+   int computeTest(void)
+   {
+      TUDEF("ClockStability", "compute");
+      ClockStability cs(phase, 1.0);
+      ClockStability::Statistic stats[] = {
+         ClockStability::ADEV, ClockStability::MDEV, ClockStability::HDEV,
+         ClockStability::TDEV, ClockStability::TOTDEV };
+      for(int s=0; s<5; s++) {
+         vector<ClockStability::Point> curve;
+         curve = cs.compute(stats[s], ClockStability::All);
+         TUASSERTE(size_t, cs.maxFactor(stats[s]), curve.size());
+         TUASSERTE(unsigned, 0, countWrong(curve, stats[s], phase));
+      }
+
+         // the total deviation has the same terms as ADEV at m=1
+      TUASSERTFEPS(cs.compute(ClockStability::ADEV, 1).deviation,
+                   cs.compute(ClockStability::TOTDEV, 1).deviation, eps);
+      TURETURN();
+   }
+
+      /** Zero phases are gaps, dropped from ADEV, MDEV and HDEV. */
+   int gapsTest(void)
+   {
+      TUDEF("ClockStability", "compute");
+      vector<double> x(phase);
+      x[20] = 0;
+      x[33] = 0;
+      ClockStability cs(x, 1.0);
+      ClockStability::Statistic stats[] = {
+         ClockStability::ADEV, ClockStability::MDEV, ClockStability::HDEV,
+         ClockStability::TDEV };
+      for(int s=0; s<4; s++) {
+         vector<ClockStability::Point> curve;
+         curve = cs.compute(stats[s], ClockStability::All);
+         TUASSERTE(unsigned, 0, countWrong(curve, stats[s], x));
+      }
+      TUASSERT(cs.compute(ClockStability::ADEV, 3).numGaps > 0);
+      TUASSERT(cs.compute(ClockStability::MDEV, 3).numGaps > 0);
+      TUASSERT(cs.compute(ClockStability::HDEV, 3).numGaps > 0);
+      TURETURN();
+   }
+
+      /** The right end of the series is reflected about the last
+       * point in the right order: the reflection of a linear phase is
+       * the same line, whose total deviation is 0 at every averaging
+       * factor.  tallandev used to reflect x[N-1+k] as 2x[N-1]-x[N+1-k]
+       * for k >= 3, which gave non-zero values from m=4 on. */
+   int reflectionTest(void)
+   {
+      TUDEF("ClockStability", "compute");
+      vector<double> x;
+      for(int i=0; i<40; i++)
+         x.push_back(1.0 + 0.25*i);
+      ClockStability cs(x, 1.0);
+      vector<ClockStability::Point> curve;
+      curve = cs.compute(ClockStability::TOTDEV, ClockStability::All);
+      TUASSERTE(size_t, 39, curve.size());
+      unsigned wrong = 0;
+      for(size_t i=0; i<curve.size(); i++) {
+         if(curve[i].deviation > eps)
+            wrong++;
+      }
+      TUASSERTE(unsigned, 0, wrong);
+      TURETURN();
+   }
+
+      /** StreamingStability gives the results of ClockStability for
+       * the samples added so far. */
+   int streamingTest(void)
+   {
+      TUDEF("StreamingStability", "compute");
+      unsigned long factors[] = { 1, 2, 3, 5, 8, 13, 21 };
+      vector<unsigned long> m(factors, factors+7);
+      StreamingStability ss(1.0, m);
+      ClockStability cs(phase, 1.0);
+      ClockStability::Statistic stats[] = {
+         ClockStability::ADEV, ClockStability::MDEV, ClockStability::HDEV,
+         ClockStability::TDEV };
+
+      for(int pass=0; pass<2; pass++) {
+         for(size_t i=0; i<phase.size(); i++)
+            ss.add(phase[i]);
+         TUASSERTE(unsigned long, phase.size(), ss.size());
+         for(int s=0; s<4; s++) {
+            vector<ClockStability::Point> curve = ss.compute(stats[s]);
+            vector<ClockStability::Point> exp = cs.compute(stats[s], m);
+            TUASSERTE(size_t, exp.size(), curve.size());
+            unsigned wrong = 0;
+            for(size_t i=0; i<curve.size() && i<exp.size(); i++) {
+               if(fabs(exp[i].deviation - curve[i].deviation) > eps ||
+                  exp[i].m != curve[i].m)
+                  wrong++;
+            }
+            TUASSERTE(unsigned, 0, wrong);
+         }
+            // start again from scratch
+         ss.clear();
+      }
+
+         // only the factors with enough samples are returned
+      for(int i=0; i<11; i++)
+         ss.add(phase[i]);
+      TUASSERTE(size_t, 4, ss.compute(ClockStability::ADEV).size());
+      TUASSERTE(size_t, 3, ss.compute(ClockStability::HDEV).size());
+      TURETURN();
+   }
+
+      /** Invalid input throws. */
+   int exceptionTest(void)
+   {
+      TUDEF("ClockStability", "ClockStability");
+      try {
+         ClockStability cs(vector<double>(2, 1.0), 1.0);
+         TUFAIL("Expected an exception for 2 samples");
+      }
+      catch(Exception& e) {
+         TUPASS("Exception for 2 samples");
+      }
+
+      TUCSM("compute");
+      ClockStability cs(phase, 1.0);
+      try {
+         cs.compute(ClockStability::ADEV, 0);
+         TUFAIL("Expected an exception for m=0");
+      }
+      catch(Exception& e) {
+         TUPASS("Exception for m=0");
+      }
+      try {
+         cs.compute(ClockStability::ADEV, 32);
+         TUFAIL("Expected an exception for m > maxFactor");
+      }
+      catch(Exception& e) {
+         TUPASS("Exception for m > maxFactor");
+      }
+
+      StreamingStability ss(1.0, ClockStability::Octave, 8);
+      try {
+         ss.compute(ClockStability::TOTDEV);
+         TUFAIL("Expected an exception for a streaming TOTDEV");
+      }
+      catch(Exception& e) {
+         TUPASS("Exception for a streaming TOTDEV");
+      }
+      TURETURN();
+   }
+
+      /** One ClockStability shared by several threads gives the same
+       * curves in each of them. */
+   int threadsTest(void)
+   {
+      TUDEF("ClockStability", "compute");
+      const ClockStability cs(phase, 1.0);
+      const int numThreads = 4;
+      vector<vector<ClockStability::Point> > curves(numThreads);
+      vector<thread> threads;
+      for(int t=0; t<numThreads; t++)
+         threads.push_back(thread([&cs, &curves, t]() {
+            curves[t] = cs.compute(ClockStability::TOTDEV,
+                                   ClockStability::All);
+         }));
+      for(int t=0; t<numThreads; t++)
+         threads[t].join();
+      for(int t=0; t<numThreads; t++) {
+         TUASSERTE(size_t, 63, curves[t].size());
+         TUASSERTE(unsigned, 0,
+                   countWrong(curves[t], ClockStability::TOTDEV, phase));
+      }
+      TURETURN();
+   }
+
+   vector<double> phase;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   ClockStability_T testClass;
+
+   errorTotal += testClass.factorsTest();
+   errorTotal += testClass.computeTest();
+   errorTotal += testClass.gapsTest();
+   errorTotal += testClass.reflectionTest();
+   errorTotal += testClass.streamingTest();
+   errorTotal += testClass.exceptionTest();
+   errorTotal += testClass.threadsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
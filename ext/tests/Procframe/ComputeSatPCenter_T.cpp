@@ -0,0 +1,280 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "ComputeSatPCenter.hpp"
+#include "AntexReader.hpp"
+#include "AntexStream.hpp"
+#include "AntexHeader.hpp"
+#include "AntexData.hpp"
+#include "CivilTime.hpp"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// Antex file with the antennas of G01, G02 and R01, and one receiver.
+string antexFile(void)
+{
+   return getPathData() + getFileSep() + "test_input_antex_sats.atx";
+}
+
+
+   /// Epochs of interest, covering every satellite antenna of the file.
+vector<CommonTime> testEpochs(void)
+{
+   vector<CommonTime> epochs;
+   epochs.push_back(CivilTime(2005, 1, 1, 0, 0, 0.0, TimeSystem::GPS));
+   epochs.push_back(CivilTime(2008, 6, 1, 12, 0, 0.0, TimeSystem::GPS));
+   epochs.push_back(CivilTime(2008, 12, 1, 6, 0, 0.0, TimeSystem::GPS));
+   epochs.push_back(CivilTime(2010, 3, 1, 18, 0, 0.0, TimeSystem::GPS));
+   return epochs;
+}
+
+
+   /** Satellite antenna phase correction as ComputeSatPCenter computed it
+    * from the Antenna objects of AntexReader, before satellite antennas
+    * were indexed and PCVs gridded. */
+double originalSatPCenter( AntexReader& antexReader,
+                           const SatID& satid,
+                           const CommonTime& time,
+                           const Triple& satpos,
+                           const Triple& sunPosition,
+                           const Position& nominalPos )
+{
+   Triple rk( ( (-1.0)*(satpos.unitVector()) ) );
+   Triple ri( sunPosition.unitVector() );
+   Triple rj(rk.cross(ri));
+   ri = rj.cross(rk);
+   ri = ri.unitVector();
+   Triple rxPos(nominalPos.X(), nominalPos.Y(), nominalPos.Z());
+   Triple rrho( (rxPos-satpos).unitVector() );
+
+   double nadir = std::acos( rrho.dot(rk) ) * RAD_TO_DEG;
+   nadir = (nadir>14) ? 14.0 : nadir;
+   double elev( 90.0 - nadir );
+
+   std::stringstream sat;
+   sat << (satid.system == SatID::systemGPS ? "G" : "R");
+   if( satid.id < 10 )
+   {
+      sat << "0";
+   }
+   sat << satid.id;
+   Antenna::frequencyType freq( satid.system == SatID::systemGPS ?
+                                Antenna::G01 : Antenna::R01 );
+
+   Antenna antenna( antexReader.getAntenna( sat.str(), time ) );
+   Triple satAnt( antenna.getAntennaEccentricity(freq) );
+   Triple var( antenna.getAntennaPCVariation(freq, elev) );
+   satAnt = satAnt - var;
+   Triple svAntenna( satAnt[2]*ri + satAnt[1]*rj + satAnt[0]*rk );
+
+      // corrections are an "advance" in the signal
+   return -rrho.dot(svAntenna);
+}
+
+
+class ComputeSatPCenter_T
+{
+public:
+
+      /** The gridded PCVs and the offsets of the satellite antennas of
+       * AntexData are those of the Antenna objects of AntexReader. */
+   int gridTest(void)
+   {
+      TUDEF("AntexData", "getPhaseCenterVariation");
+
+      AntexReader antexReader(antexFile());
+      AntexStream strm(antexFile().c_str());
+      AntexHeader header;
+      strm >> header;
+      TUASSERT(static_cast<bool>(strm));
+
+      int nsats(0);
+      AntexData antdata;
+      while(strm >> antdata)
+      {
+         if(!antdata.isValid() || antdata.isRxAntenna) continue;
+         nsats++;
+
+         TUASSERT(antdata.freqPCVmap.begin()->second.PCVgrid.isValid());
+
+            // the first epoch of validity picks this antenna
+         Antenna antenna(antexReader.getAntenna(antdata.serialNo,
+                                                antdata.validFrom));
+         TUASSERTE(string, antdata.serialNo, antenna.getAntennaSerial());
+         TUASSERTE(string, antdata.type, antenna.getAntennaType());
+
+         const bool isGPS(antdata.systemChar == 'G');
+         const string freq(isGPS ? "G01" : "R01");
+         Antenna::frequencyType afreq(isGPS ? Antenna::G01 : Antenna::R01);
+
+         Triple pco(antdata.getPhaseCenterOffset(freq));
+         Triple ecc(antenna.getAntennaEccentricity(afreq));
+         for(int i=0; i<3; i++)
+            TUASSERTFEPS(0.001*pco[i], ecc[2-i], 1.e-12);
+
+         for(double nadir = 0.0; nadir <= 14.0; nadir += 0.05)
+         {
+            TUASSERTFEPS(0.001*antdata.getPhaseCenterVariation(freq, 0.0, nadir),
+                   antenna.getAntennaPCVariation(afreq, 90.0-nadir)[0], 1.e-12);
+         }
+      }
+      TUASSERTE(int, 7, nsats);
+
+      TURETURN();
+   }
+
+
+      /** ComputeSatPCenter, which uses the indexed and gridded satellite
+       * antennas, gives the same corrections as the original computation
+       * with the Antenna objects of AntexReader. */
+   int processTest(void)
+   {
+      TUDEF("ComputeSatPCenter", "Process");
+
+      AntexReader antexReader(antexFile());
+      Position nominalPos(4833520.3800, 41536.8300, 4147461.2800);
+      ComputeSatPCenter svPcenter(nominalPos, antexReader);
+
+      const double radius(26560.e3);
+      vector<SatID> sats;
+      sats.push_back(SatID(1, SatID::systemGPS));
+      sats.push_back(SatID(2, SatID::systemGPS));
+      sats.push_back(SatID(1, SatID::systemGlonass));
+
+      vector<CommonTime> epochs(testEpochs());
+      int ncorr(0);
+      for(size_t k=0; k<epochs.size(); k++)
+      {
+         SunPosition sunPosition;
+         Triple sunPos(sunPosition.getPosition(epochs[k]));
+
+            // satellites at several positions in view of the station
+         for(int j=0; j<8; j++)
+         {
+            Triple up(nominalPos.unitVector());
+            Triple satPos( radius * (up + Triple(0.1*(j-4), 0.05*j, -0.03*j))
+                                    .unitVector() );
+            for(size_t i=0; i<sats.size(); i++)
+            {
+               satTypeValueMap gData;
+               gData[sats[i]][TypeID::satX] = satPos[0];
+               gData[sats[i]][TypeID::satY] = satPos[1];
+               gData[sats[i]][TypeID::satZ] = satPos[2];
+
+               bool original(true), grid(true);
+               double expected(0.0);
+               try
+               {
+                  expected = originalSatPCenter(antexReader, sats[i],
+                                    epochs[k], satPos, sunPos, nominalPos);
+               }
+               catch(ObjectNotFound&) { original = false; }
+               try { svPcenter.Process(epochs[k], gData); }
+               catch(ProcessingException&) { grid = false; }
+
+                  // the antenna is found by both, or by neither
+               TUASSERTE(bool, original, grid);
+               if(original && grid)
+               {
+                  TUASSERTFEPS(expected,
+                               gData[sats[i]][TypeID::satPCenter], 1.e-12);
+                  ncorr++;
+               }
+            }
+         }
+      }
+      TUASSERT(ncorr > 0);
+
+      TURETURN();
+   }
+
+
+      /** A satellite without an antenna valid at the epoch is an error. */
+   int missingTest(void)
+   {
+      TUDEF("ComputeSatPCenter", "Process");
+
+      AntexReader antexReader(antexFile());
+      Position nominalPos(4833520.3800, 41536.8300, 4147461.2800);
+      ComputeSatPCenter svPcenter(nominalPos, antexReader);
+
+         // G01 has no antenna from 2009/1/7 to 2009/3/23, G03 none at all
+      CommonTime gap(CivilTime(2009, 2, 1, 0, 0, 0.0, TimeSystem::GPS));
+      CommonTime ok(CivilTime(2009, 4, 1, 0, 0, 0.0, TimeSystem::GPS));
+      Triple satPos(26560.e3 * nominalPos.unitVector());
+
+      satTypeValueMap gData;
+      gData[SatID(1, SatID::systemGPS)][TypeID::satX] = satPos[0];
+      gData[SatID(1, SatID::systemGPS)][TypeID::satY] = satPos[1];
+      gData[SatID(1, SatID::systemGPS)][TypeID::satZ] = satPos[2];
+      satTypeValueMap gData3(gData);
+      gData3[SatID(3, SatID::systemGPS)] = gData[SatID(1, SatID::systemGPS)];
+      gData3.removeSatID(SatID(1, SatID::systemGPS));
+
+      try { svPcenter.Process(gap, gData); TUFAIL("Expected an exception"); }
+      catch(ProcessingException&) { TUPASS("Expected an exception"); }
+      try { svPcenter.Process(ok, gData3); TUFAIL("Expected an exception"); }
+      catch(ProcessingException&) { TUPASS("Expected an exception"); }
+      try { svPcenter.Process(ok, gData); TUPASS("Process"); }
+      catch(ProcessingException&) { TUFAIL("Unexpected exception"); }
+
+      TURETURN();
+   }
+
+};
+
+
+int main()
+{
+   int errorTotal = 0;
+   ComputeSatPCenter_T testClass;
+
+   errorTotal += testClass.gridTest();
+   errorTotal += testClass.processTest();
+   errorTotal += testClass.missingTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,696 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "GDSStream.hpp"
+#include "GDSWriter.hpp"
+#include "RinexObsStream.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <set>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// All the values of an epoch, one satellite per line. Values are
+   /// printed with enough digits to tell any two doubles apart.
+string summary(const satTypeValueMap& body)
+{
+   ostringstream oss;
+   oss << setprecision(17);
+   for (satTypeValueMap::const_iterator it = body.begin();
+        it != body.end(); ++it)
+   {
+      oss << it->first;
+      for (typeValueMap::const_iterator tv = it->second.begin();
+           tv != it->second.end(); ++tv)
+         oss << " " << tv->first << " " << tv->second;
+      oss << endl;
+   }
+   return oss.str();
+}
+
+
+   /// Whole content of a file.
+string readFile(const string& fn)
+{
+   ifstream in(fn.c_str(), ios::in | ios::binary);
+   ostringstream oss;
+   oss << in.rdbuf();
+   return oss.str();
+}
+
+
+   /// Replaces the content of a file.
+void writeFile(const string& fn, const string& data)
+{
+   ofstream out(fn.c_str(), ios::out | ios::binary | ios::trunc);
+   out.write(data.data(), data.size());
+}
+
+
+   /// One record of a GDS file: tag byte, 32-bit little-endian length and
+   /// payload.
+struct Record
+{
+   char tag;
+   string payload;
+};
+
+
+   /// Splits the content of a GDS file, after its 8-byte header, into
+   /// records.
+vector<Record> splitRecords(const string& data)
+{
+   vector<Record> records;
+   size_t pos = 8;
+   while (pos + 5 <= data.size())
+   {
+      Record r;
+      r.tag = data[pos];
+      uint32_t len = 0;
+      for (int i = 3; i >= 0; i--)
+         len = (len << 8) | static_cast<unsigned char>(data[pos+1+i]);
+      r.payload = data.substr(pos+5, len);
+      records.push_back(r);
+      pos += 5 + len;
+   }
+   return records;
+}
+
+
+   /// Joins a header and records into the content of a GDS file.
+string joinRecords(const string& header, const vector<Record>& records)
+{
+   string data(header);
+   for (size_t i = 0; i < records.size(); i++)
+   {
+      uint32_t len = records[i].payload.size();
+      data += records[i].tag;
+      for (int k = 0; k < 4; k++)
+         data += static_cast<char>((len >> (8*k)) & 0xff);
+      data += records[i].payload;
+   }
+   return data;
+}
+
+
+   /// Appends a base-128 varint, as the format stores integers.
+void putVar(string& b, uint64_t v)
+{
+   while (v >= 0x80)
+   {
+      b += static_cast<char>((v & 0x7f) | 0x80);
+      v >>= 7;
+   }
+   b += static_cast<char>(v);
+}
+
+
+   /// Reads a base-128 varint.
+uint64_t getVar(const string& b, size_t& pos)
+{
+   uint64_t v = 0;
+   for (unsigned shift = 0; pos < b.size(); shift += 7)
+   {
+      unsigned char c = b[pos++];
+      v |= static_cast<uint64_t>(c & 0x7f) << shift;
+      if (!(c & 0x80))
+         break;
+   }
+   return v;
+}
+
+
+class GDSStream_T
+{
+public:
+   GDSStream_T()
+   {
+      obsFile = getPathData() + getFileSep() + "arlm200a.15o";
+      tempDir = getPathTestTemp() + getFileSep();
+      rinexFile = tempDir + "test_output_gds_rinex.gds";
+
+         // a user-registered type, as a program extending the types
+         // would have
+      userType = TypeID::regByName("GDSSTREAMTEST", "GDSStream_T user type");
+
+      RinexObsStream rin(obsFile.c_str());
+      gnssRinex gRin;
+      while (rin >> gRin && data.size() < 60)
+      {
+         int k = data.size();
+         for (satTypeValueMap::iterator it = gRin.body.begin();
+              it != gRin.body.end(); ++it)
+            it->second[userType] = 0.1*k + it->first.id / 3.0;
+            // some epochs with a part below the millisecond, that needs
+            // the fractional second of the epoch record
+         if (k % 7 == 3)
+            gRin.header.epoch += 1.234567e-4;
+         data.push_back(gRin);
+      }
+   }
+
+
+      /** Compares two gnssRinex objects, RINEX header data included. */
+   void checkRinex(TestUtil& testFramework, const gnssRinex& exp,
+                   const gnssRinex& got)
+   {
+      TUASSERTE(CommonTime, exp.header.epoch, got.header.epoch);
+      TUASSERTE(SourceID, exp.header.source, got.header.source);
+      TUASSERTE(string, exp.header.antennaType, got.header.antennaType);
+      for (int i = 0; i < 3; i++)
+         TUASSERTE(double, exp.header.antennaPosition[i],
+                   got.header.antennaPosition[i]);
+      TUASSERTE(short, exp.header.epochFlag, got.header.epochFlag);
+      TUASSERTE(string, summary(exp.body), summary(got.body));
+   }
+
+
+      /** gnssRinex data written through GDSWriter is read back
+       * identically, epochs with a fractional millisecond and values of
+       * user-registered types included. */
+   int rinexTest(void)
+   {
+      TUDEF("GDSStream", "readGnssRinex");
+
+      {
+         GDSStream gdsOut(rinexFile.c_str(), ios::out);
+         GDSWriter writer(gdsOut);
+         for (size_t i = 0; i < data.size(); i++)
+         {
+            gnssRinex gRin(data[i]);
+            gRin >> writer;
+               // the writer leaves the data untouched
+            TUASSERTE(string, summary(data[i].body), summary(gRin.body));
+         }
+      }
+
+      GDSStream gdsIn(rinexFile.c_str());
+      TUASSERT(static_cast<bool>(gdsIn));
+      gnssRinex gRin;
+      size_t n = 0;
+      while (gdsIn >> gRin)
+      {
+         TUASSERT(n < data.size());
+         if (n >= data.size())
+            break;
+         checkRinex(testFramework, data[n], gRin);
+         TUASSERTE(CommonTime, data[n].header.epoch,
+                   gRin.gnssSatTypeValue::header.epoch);
+         n++;
+      }
+      TUASSERTE(size_t, data.size(), n);
+      TUASSERT(gRin.body.begin()->second.find(userType) !=
+               gRin.body.begin()->second.end());
+      TURETURN();
+   }
+
+
+      /** gnssSatTypeValue data written through GDSWriter is read back
+       * identically, also as gnssRinex, without the RINEX header data. */
+   int satTypeValueTest(void)
+   {
+      TUDEF("GDSStream", "readGnssSatTypeValue");
+      string fn = tempDir + "test_output_gds_stv.gds";
+
+      {
+         GDSStream gdsOut(fn.c_str(), ios::out);
+         GDSWriter writer(gdsOut);
+         for (size_t i = 0; i < data.size(); i++)
+         {
+            gnssSatTypeValue gStv;
+            gStv.header.source = data[i].header.source;
+            gStv.header.epoch = data[i].header.epoch;
+            gStv.body = data[i].body;
+            gStv >> writer;
+         }
+      }
+
+      GDSStream gdsIn(fn.c_str());
+      gnssSatTypeValue gStv;
+      size_t n = 0;
+      while (gdsIn >> gStv && n < data.size())
+      {
+         TUASSERTE(CommonTime, data[n].header.epoch, gStv.header.epoch);
+         TUASSERTE(SourceID, data[n].header.source, gStv.header.source);
+         TUASSERTE(string, summary(data[n].body), summary(gStv.body));
+         n++;
+      }
+      TUASSERTE(size_t, data.size(), n);
+
+      GDSStream gdsRinex(fn.c_str());
+      gnssRinex gRin;
+      TUASSERT(static_cast<bool>(gdsRinex >> gRin));
+      TUASSERTE(string, summary(data[0].body), summary(gRin.body));
+      TUASSERTE(string, string(""), gRin.header.antennaType);
+      TUASSERTE(short, 0, gRin.header.epochFlag);
+      TURETURN();
+   }
+
+
+      /** A gnssDataMap with two sources per epoch is read back
+       * identically, one record per epoch. Entries of the map sharing an
+       * epoch are written to a single record. */
+   int dataMapTest(void)
+   {
+      TUDEF("GDSStream", "readGnssDataMap");
+      string fn = tempDir + "test_output_gds_map.gds";
+
+      gnssDataMap gdm, split;
+      for (size_t i = 0; i < 20; i++)
+      {
+         SourceID other(data[i].header.source);
+         other.sourceName += "2";
+         sourceDataMap sdMap;
+         sdMap[data[i].header.source] = data[i].body;
+         sdMap[other] = data[i].body;
+         sdMap[other].erase(sdMap[other].begin());
+         gdm.insert(make_pair(data[i].header.epoch, sdMap));
+
+            // the same data as one entry per source
+         for (sourceDataMap::const_iterator it = sdMap.begin();
+              it != sdMap.end(); ++it)
+         {
+            sourceDataMap one;
+            one[it->first] = it->second;
+            split.insert(make_pair(data[i].header.epoch, one));
+         }
+      }
+      TUASSERTE(size_t, 40, split.size());
+
+      {
+         GDSStream gdsOut(fn.c_str(), ios::out);
+         gdsOut << gdm;
+      }
+      string splitFn = tempDir + "test_output_gds_split.gds";
+      {
+         GDSStream gdsOut(splitFn.c_str(), ios::out);
+         gdsOut << split;
+      }
+      TUASSERTE(string, readFile(fn), readFile(splitFn));
+
+      GDSStream gdsIn(fn.c_str());
+      gnssDataMap got;
+      int records = 0;
+      while (gdsIn >> got)
+         records++;
+      TUASSERTE(int, 20, records);
+      TUASSERTE(size_t, gdm.size(), got.size());
+
+      gnssDataMap::const_iterator ite = gdm.begin(), itg = got.begin();
+      for (; ite != gdm.end() && itg != got.end(); ++ite, ++itg)
+      {
+         TUASSERTE(CommonTime, ite->first, itg->first);
+         TUASSERTE(size_t, 2, itg->second.size());
+         sourceDataMap::const_iterator se = ite->second.begin(),
+            sg = itg->second.begin();
+         for (; se != ite->second.end() && sg != itg->second.end();
+              ++se, ++sg)
+         {
+            TUASSERTE(SourceID, se->first, sg->first);
+            TUASSERTE(string, summary(se->second), summary(sg->second));
+         }
+      }
+      TURETURN();
+   }
+
+
+      /** Each type, satellite, source and antenna gets one dictionary
+       * record, before the first data record using it. Types are matched
+       * by description when read, so a user type is found even with
+       * another value, or registered when unknown, and records of unknown
+       * kinds are skipped. */
+   int dictionaryTest(void)
+   {
+      TUDEF("GDSStream", "dictionary");
+
+      set<TypeID> typeSet;
+      set<SatID> satSet;
+      for (size_t i = 0; i < data.size(); i++)
+      {
+         for (satTypeValueMap::const_iterator it = data[i].body.begin();
+              it != data[i].body.end(); ++it)
+         {
+            satSet.insert(it->first);
+            for (typeValueMap::const_iterator tv = it->second.begin();
+                 tv != it->second.end(); ++tv)
+               typeSet.insert(tv->first);
+         }
+      }
+
+      string content = readFile(rinexFile);
+      vector<Record> records = splitRecords(content);
+      size_t numTypes = 0, numSats = 0, numSources = 0, numAntennas = 0,
+         numData = 0;
+      for (size_t i = 0; i < records.size(); i++)
+      {
+         switch (records[i].tag)
+         {
+            case 'T': numTypes++; break;
+            case 'S': numSats++; break;
+            case 'O': numSources++; break;
+            case 'A': numAntennas++; break;
+            case 'D': numData++; break;
+         }
+      }
+      TUASSERTE(size_t, typeSet.size(), numTypes);
+      TUASSERTE(size_t, satSet.size(), numSats);
+      TUASSERTE(size_t, 1, numSources);
+      TUASSERTE(size_t, 1, numAntennas);
+      TUASSERTE(size_t, data.size(), numData);
+         // the first data record is preceded by its dictionary records
+      TUASSERT(records[0].tag != 'D');
+
+         // the user type record, rewritten with another value and a
+         // description unknown to this program, and a record of an
+         // unknown kind
+      string header = content.substr(0, 8);
+      string newDesc = "GDSStream_T type of another program";
+      bool found = false;
+      for (size_t i = 0; i < records.size(); i++)
+      {
+         if (records[i].tag != 'T')
+            continue;
+         size_t pos = 0;
+         uint64_t idx = getVar(records[i].payload, pos);
+         getVar(records[i].payload, pos);
+         uint64_t len = getVar(records[i].payload, pos);
+         if (records[i].payload.substr(pos, len) != "GDSStream_T user type")
+            continue;
+         string payload;
+         putVar(payload, idx);
+         putVar(payload, 2*100000);    // zig-zag coded value 100000
+         putVar(payload, newDesc.size());
+         payload += newDesc;
+         records[i].payload = payload;
+         found = true;
+      }
+      TUASSERT(found);
+      Record unknown;
+      unknown.tag = 'Z';
+      unknown.payload = "future";
+      records.insert(records.begin() + 1, unknown);
+
+      string fn = tempDir + "test_output_gds_dict.gds";
+      writeFile(fn, joinRecords(header, records));
+
+      GDSStream gdsIn(fn.c_str());
+      gnssRinex gRin;
+      size_t n = 0;
+      TypeID otherType;
+      while (gdsIn >> gRin && n < data.size())
+      {
+            // same data, with the values of the user type under the type
+            // registered for the new description
+         satTypeValueMap exp(data[n].body);
+         for (satTypeValueMap::iterator it = gRin.body.begin();
+              it != gRin.body.end(); ++it)
+         {
+            for (typeValueMap::iterator tv = it->second.begin();
+                 tv != it->second.end(); ++tv)
+            {
+               if (TypeID::tStrings[tv->first.type] == newDesc)
+                  otherType = tv->first;
+            }
+         }
+         TUASSERT(otherType.type != userType.type);
+         for (satTypeValueMap::iterator it = exp.begin();
+              it != exp.end(); ++it)
+         {
+            it->second[otherType] = it->second[userType];
+            it->second.erase(userType);
+         }
+         TUASSERTE(string, summary(exp), summary(gRin.body));
+         n++;
+      }
+      TUASSERTE(size_t, data.size(), n);
+      TUASSERTE(string, newDesc, TypeID::tStrings[otherType.type]);
+
+         // reading the file again finds the type registered above, by
+         // its description
+      GDSStream gdsAgain(fn.c_str());
+      TUASSERT(static_cast<bool>(gdsAgain >> gRin));
+      TUASSERT(gRin.body.begin()->second.find(otherType) !=
+               gRin.body.begin()->second.end());
+      TURETURN();
+   }
+
+
+      /** getEpochs() lists the epochs of a multi-epoch file, and
+       * seekEpoch() positions the stream on the first epoch at or after
+       * the given one, forwards and backwards, without disturbing
+       * sequential reading. */
+   int seekTest(void)
+   {
+      TUDEF("GDSStream", "seekEpoch");
+      GDSStream gdsIn(rinexFile.c_str());
+      gnssRinex gRin;
+
+         // indexing in the middle of sequential reading
+      TUASSERT(static_cast<bool>(gdsIn >> gRin));
+      TUASSERT(static_cast<bool>(gdsIn >> gRin));
+      vector<CommonTime> epochs = gdsIn.getEpochs();
+      TUASSERTE(size_t, data.size(), epochs.size());
+      for (size_t i = 0; i < epochs.size() && i < data.size(); i++)
+         TUASSERTE(CommonTime, data[i].header.epoch, epochs[i]);
+      TUASSERT(static_cast<bool>(gdsIn >> gRin));
+      checkRinex(testFramework, data[2], gRin);
+
+      const size_t targets[] = { 45, 10, 3, 59, 0, 24 };
+      for (int k = 0; k < 6; k++)
+      {
+         size_t i = targets[k];
+         TUASSERT(gdsIn.seekEpoch(data[i].header.epoch));
+         TUASSERT(static_cast<bool>(gdsIn >> gRin));
+         checkRinex(testFramework, data[i], gRin);
+            // the next epoch follows
+         if (i+1 < data.size())
+         {
+            TUASSERT(static_cast<bool>(gdsIn >> gRin));
+            checkRinex(testFramework, data[i+1], gRin);
+         }
+      }
+
+         // an epoch between records gives the next one
+      CommonTime between = data[10].header.epoch + 0.5;
+      TUASSERT(gdsIn.seekEpoch(between));
+      TUASSERT(static_cast<bool>(gdsIn >> gRin));
+      checkRinex(testFramework, data[11], gRin);
+
+         // past the last epoch there is nothing to read
+      TUASSERT(!gdsIn.seekEpoch(data.back().header.epoch + 1.0));
+      TUASSERT(!(gdsIn >> gRin));
+
+         // and seeking back works after reaching end of file
+      TUASSERT(gdsIn.seekEpoch(data[5].header.epoch));
+      TUASSERT(static_cast<bool>(gdsIn >> gRin));
+      checkRinex(testFramework, data[5], gRin);
+      TURETURN();
+   }
+
+
+      /** Tells whether reading all of 'fn' as gnssRinex throws
+       * FFStreamError, counting the epochs read before. */
+   bool readThrows(const string& fn, size_t& n)
+   {
+      n = 0;
+      try
+      {
+         GDSStream gdsIn(fn.c_str());
+         gnssRinex gRin;
+         while (gdsIn >> gRin)
+            n++;
+      }
+      catch (FFStreamError& e)
+      {
+         return true;
+      }
+      return false;
+   }
+
+
+      /** Bad magic, unsupported versions, truncated files and lengths
+       * or indices beyond the data raise FFStreamError instead of
+       * reading as shorter files or exhausting memory. */
+   int errorTest(void)
+   {
+      TUDEF("GDSStream", "FFStreamError");
+      string content = readFile(rinexFile);
+      vector<Record> records = splitRecords(content);
+      string fn = tempDir + "test_output_gds_bad.gds";
+      size_t n;
+
+      string bad(content);
+      bad[0] = 'X';
+      writeFile(fn, bad);
+      TUASSERT(readThrows(fn, n));
+      TUASSERTE(size_t, 0, n);
+      {
+         GDSStream gdsIn(fn.c_str());
+         TUASSERT(!gdsIn);
+         try
+         {
+            gdsIn.getEpochs();
+            TUFAIL("getEpochs() should throw for a bad magic");
+         }
+         catch (FFStreamError& e)
+         {
+            TUPASS("getEpochs() throws for a bad magic");
+         }
+      }
+
+         // version 0 and a version newer than this program's
+      const uint16_t versions[] = { 0, uint16_t(GDSStream::formatVersion+1) };
+      for (int k = 0; k < 2; k++)
+      {
+         bad = content;
+         bad[4] = static_cast<char>(versions[k] & 0xff);
+         bad[5] = static_cast<char>(versions[k] >> 8);
+         writeFile(fn, bad);
+         TUASSERT(readThrows(fn, n));
+         TUASSERTE(size_t, 0, n);
+      }
+
+         // a file shorter than its header
+      writeFile(fn, content.substr(0, 5));
+      TUASSERT(readThrows(fn, n));
+      TUASSERTE(size_t, 0, n);
+
+         // the header alone is a valid, empty, file
+      writeFile(fn, content.substr(0, 8));
+      TUASSERT(!readThrows(fn, n));
+      TUASSERTE(size_t, 0, n);
+
+         // cut inside the last data record, and inside the header of the
+         // last data record: the complete epochs before are read, and the
+         // cut one raises an error
+      size_t cuts[] = { content.size() - 3,
+                        content.size() - records.back().payload.size() - 2 };
+      for (int k = 0; k < 2; k++)
+      {
+         writeFile(fn, content.substr(0, cuts[k]));
+         TUASSERT(readThrows(fn, n));
+         TUASSERTE(size_t, data.size()-1, n);
+
+         GDSStream gdsIn(fn.c_str());
+         try
+         {
+            gdsIn.seekEpoch(data[1].header.epoch);
+            TUFAIL("seekEpoch() should throw for a truncated file");
+         }
+         catch (FFStreamError& e)
+         {
+            TUPASS("seekEpoch() throws for a truncated file");
+         }
+      }
+
+         // a data record whose payload is cut short, with a consistent
+         // length, is malformed
+      vector<Record> cut(records);
+      cut.back().payload.resize(cut.back().payload.size() - 4);
+      writeFile(fn, joinRecords(content.substr(0, 8), cut));
+      TUASSERT(readThrows(fn, n));
+      TUASSERTE(size_t, data.size()-1, n);
+
+         // a record length far beyond the end of the file
+      vector<Record> head(records.begin(), records.end() - 1);
+      string huge(joinRecords(content.substr(0, 8), head));
+      huge += 'D';
+      huge += string("\xf0\xff\xff\xff", 4);
+      huge += records.back().payload;
+      writeFile(fn, huge);
+      TUASSERT(readThrows(fn, n));
+      TUASSERTE(size_t, data.size()-1, n);
+
+         // dictionary indices beyond the entries defined, up to 2^63,
+         // for each kind of entry
+      const char tags[] = { 'T', 'S', 'O', 'A' };
+      const uint64_t indices[] = { 1000, uint64_t(1) << 63 };
+      for (int t = 0; t < 4; t++)
+      {
+         for (int k = 0; k < 2; k++)
+         {
+            vector<Record> forged(records);
+            size_t before = 0, i = 0;
+            for (; i < forged.size() && forged[i].tag != tags[t]; i++)
+               if (forged[i].tag == 'D')
+                  before++;
+            TUASSERT(i < forged.size());
+            if (i == forged.size())
+               continue;
+            size_t pos = 0;
+            getVar(forged[i].payload, pos);
+            string payload;
+            putVar(payload, indices[k]);
+            forged[i].payload = payload + forged[i].payload.substr(pos);
+            writeFile(fn, joinRecords(content.substr(0, 8), forged));
+            TUASSERT(readThrows(fn, n));
+            TUASSERTE(size_t, before, n);
+         }
+      }
+      TURETURN();
+   }
+
+
+   string obsFile;
+   string tempDir;
+   string rinexFile;
+   TypeID userType;
+   vector<gnssRinex> data;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   GDSStream_T testClass;
+
+   errorTotal += testClass.rinexTest();
+   errorTotal += testClass.satTypeValueTest();
+   errorTotal += testClass.dataMapTest();
+   errorTotal += testClass.dictionaryTest();
+   errorTotal += testClass.seekTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,232 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "IonexModel.hpp"
+#include "CivilTime.hpp"
+#include <iostream>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+class IonexModel_T
+{
+public:
+   IonexModel_T()
+         : first(CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::Any))
+   {
+      string inxFile(getPathData() + getFileSep() +
+                     "test_input_ionex_synthetic.15i");
+      unpacked.setPackedMode(false);
+      packed.loadFile(inxFile);
+      unpacked.loadFile(inxFile);
+
+         // a map epoch, epochs between maps, and the last map epoch
+      times.push_back(first + 7200.0);
+      times.push_back(first + 7200.0*3 + 1234.5);
+      times.push_back(first + 7200.0*11 + 5000.0);
+      times.push_back(first + 86400.0);
+
+         // a receiver in Europe, and one whose pierce points are on both
+         // sides of the +-180 degree meridian
+      Position europe(43.5, 1.5, 200.0, Position::Geodetic);
+      Position dateLine(-17.5, 179.5, 20.0, Position::Geodetic);
+      europe.transformTo(Position::Cartesian);
+      dateLine.transformTo(Position::Cartesian);
+      receivers.push_back(europe);
+      receivers.push_back(dateLine);
+   }
+
+
+      /// Satellites in view, with their elevation and azimuth.
+   satTypeValueMap satellites(void) const
+   {
+      satTypeValueMap gData;
+      for (int prn = 1; prn <= 8; prn++)
+      {
+         SatID sat(prn, SatID::systemGPS);
+         gData[sat][TypeID::elevation] = 10.0 + 10.0*prn;
+         gData[sat][TypeID::azimuth] = 45.0*prn - 20.0;
+         gData[sat][TypeID::P1] = 2.2e7;
+      }
+      return gData;
+   }
+
+
+      /** Process() gives the same corrections with packed maps as with
+       * the individual maps, and the corrections computed satellite by
+       * satellite with getIonexValue() at each pierce point, as it did
+       * before pierce points were looked up together. */
+   int processTest(void)
+   {
+      TUDEF("IonexModel", "Process");
+      for (size_t r = 0; r < receivers.size(); r++)
+      {
+         IonexModel byPacked(receivers[r], packed, TypeID::P1, true, "SLM");
+         IonexModel byUnpacked(receivers[r], unpacked, TypeID::P1, true,
+                               "SLM");
+         for (size_t i = 0; i < times.size(); i++)
+         {
+            satTypeValueMap gPacked(satellites()), gUnpacked(satellites());
+            byPacked.Process(times[i], gPacked);
+            byUnpacked.Process(times[i], gUnpacked);
+            TUASSERTE(size_t, 8, gPacked.size());
+            TUASSERTE(size_t, 8, gUnpacked.size());
+
+            for (satTypeValueMap::const_iterator it = gPacked.begin();
+                 it != gPacked.end(); ++it)
+            {
+               double elev(it->second.getValue(TypeID::elevation));
+               double azim(it->second.getValue(TypeID::azimuth));
+
+                  // the corrections, one satellite at a time
+               Position ipp(receivers[r].getIonosphericPiercePoint(elev,
+                                                                   azim,
+                                                                   450000.0));
+               ipp.transformTo(Position::Geocentric);
+               Triple val(unpacked.getIonexValue(times[i], ipp, 3));
+               double tec(val[0]);
+               TUASSERT(tec > 0.0);
+               TUASSERTE(double, tec,
+                         it->second.getValue(TypeID::ionoTEC));
+               TUASSERTE(double, unpacked.iono_mapping_function(elev, "SLM"),
+                         it->second.getValue(TypeID::ionoMap));
+               TUASSERTE(double, unpacked.getIonoL1(elev, tec, "SLM"),
+                         it->second.getValue(TypeID::ionoL1));
+               TUASSERTE(double, unpacked.getIonoL2(elev, tec, "SLM"),
+                         it->second.getValue(TypeID::ionoL2));
+               TUASSERTE(double, unpacked.getIonoL5(elev, tec, "SLM"),
+                         it->second.getValue(TypeID::ionoL5));
+
+                  // and the same with the individual maps
+               const typeValueMap& tvm(gUnpacked(it->first));
+               TUASSERTE(double, tec, tvm.getValue(TypeID::ionoTEC));
+               TUASSERTE(double, it->second.getValue(TypeID::ionoL1),
+                         tvm.getValue(TypeID::ionoL1));
+               TUASSERTE(double, it->second.getValue(TypeID::ionoL8),
+                         tvm.getValue(TypeID::ionoL8));
+               TUASSERTE(double, it->second.getValue(TypeID::instC1),
+                         tvm.getValue(TypeID::instC1));
+            }
+         }
+      }
+      TURETURN();
+   }
+
+
+      /** Satellites without azimuth are removed, as before, and the
+       * others are modeled as if they were alone. */
+   int rejectTest(void)
+   {
+      TUDEF("IonexModel", "Process");
+      IonexModel model(receivers[0], packed);
+      satTypeValueMap all(satellites()), missing(satellites());
+      SatID sat3(3, SatID::systemGPS);
+      missing[sat3].erase(TypeID::azimuth);
+
+      model.Process(times[1], all);
+      model.Process(times[1], missing);
+      TUASSERTE(size_t, 7, missing.size());
+      TUASSERT(missing.find(sat3) == missing.end());
+      for (satTypeValueMap::const_iterator it = missing.begin();
+           it != missing.end(); ++it)
+      {
+         TUASSERTE(double, all(it->first).getValue(TypeID::ionoL1),
+                   it->second.getValue(TypeID::ionoL1));
+      }
+
+         // without maps, all the satellites are removed
+      IonexModel noMaps(receivers[0]);
+      satTypeValueMap none(satellites());
+      noMaps.Process(times[1], none);
+      TUASSERTE(size_t, 0, none.size());
+      TURETURN();
+   }
+
+
+      /** An undefined map value at a pierce point raises InvalidRequest,
+       * with packed maps and without. */
+   int undefinedTest(void)
+   {
+      TUDEF("IonexModel", "Process");
+         // map 9 is undefined at 12.5N 180W; a receiver just below it
+      Position rx(12.0, 180.5, 0.0, Position::Geodetic);
+      rx.transformTo(Position::Cartesian);
+      satTypeValueMap gData;
+      gData[SatID(1, SatID::systemGPS)][TypeID::elevation] = 89.0;
+      gData[SatID(1, SatID::systemGPS)][TypeID::azimuth] = 0.0;
+
+      IonexStore* stores[2] = { &packed, &unpacked };
+      for (int s = 0; s < 2; s++)
+      {
+         IonexModel model(rx, *stores[s]);
+         satTypeValueMap g(gData);
+         try
+         {
+            model.Process(first + 8*7200.0, g);
+            TUFAIL("Expected InvalidRequest");
+         }
+         catch (InvalidRequest& e)
+         {
+            TUPASS("InvalidRequest");
+         }
+      }
+      TURETURN();
+   }
+
+
+   CommonTime first;
+   IonexStore packed, unpacked;
+   vector<CommonTime> times;
+   vector<Position> receivers;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   IonexModel_T testClass;
+
+   errorTotal += testClass.processTest();
+   errorTotal += testClass.rejectTest();
+   errorTotal += testClass.undefinedTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
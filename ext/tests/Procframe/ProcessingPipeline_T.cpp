@@ -0,0 +1,331 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "ProcessingPipeline.hpp"
+#include "ProcessingList.hpp"
+#include "Decimate.hpp"
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace gpstk;
+
+   /// Stage that appends its digit to the value of each satellite, so
+   /// that the result tells which stages ran and in which order.
+class DigitStage : public ProcessingClass
+{
+public:
+   DigitStage(int d) : digit(d) {}
+
+   virtual gnssSatTypeValue& Process(gnssSatTypeValue& gData)
+   { Process(gData.body); return gData; }
+
+   virtual gnssRinex& Process(gnssRinex& gData)
+   { Process(gData.body); return gData; }
+
+   virtual std::string getClassName(void) const
+   { return "DigitStage"; }
+
+private:
+   void Process(satTypeValueMap& body)
+   {
+      for (satTypeValueMap::iterator it = body.begin(); it != body.end(); ++it)
+         it->second[TypeID::prefitC] = it->second[TypeID::prefitC]*10 + digit;
+   }
+
+   int digit;
+};
+
+   /// Stage that throws DecimateEpoch for every epoch whose second of
+   /// day is a multiple of 'every'.
+class DropStage : public ProcessingClass
+{
+public:
+   DropStage(int e) : every(e) {}
+
+   virtual gnssSatTypeValue& Process(gnssSatTypeValue& gData)
+   { check(gData.header.epoch); return gData; }
+
+   virtual gnssRinex& Process(gnssRinex& gData)
+   { check(gData.header.epoch); return gData; }
+
+   virtual std::string getClassName(void) const
+   { return "DropStage"; }
+
+private:
+   void check(const CommonTime& t)
+   {
+      if (static_cast<long>(t.getSecondOfDay()) % every == 0)
+      {
+         DecimateEpoch e("dropped");
+         GPSTK_THROW(e);
+      }
+   }
+
+   int every;
+};
+
+
+   /// Make the test epoch i, with three satellites.
+gnssRinex makeEpoch(int i)
+{
+   gnssRinex gRin;
+   gRin.header.epoch = CommonTime::BEGINNING_OF_TIME;
+   gRin.header.epoch.addSeconds(static_cast<double>(i));
+   for (int prn = 1; prn <= 3; prn++)
+   {
+      SatID sat(prn, SatID::systemGPS);
+      gRin.body[sat][TypeID::C1] = i;
+      gRin.body[sat][TypeID::prefitC] = prn;
+   }
+   return gRin;
+}
+
+   /// One line summarizing an output epoch, or a dropped one.
+std::string summary(const gnssRinex& gRin)
+{
+   std::ostringstream oss;
+   oss << gRin.header.epoch.getSecondOfDay();
+   for (satTypeValueMap::const_iterator it = gRin.body.begin();
+        it != gRin.body.end(); ++it)
+   {
+      oss << " " << it->first.id
+          << " " << it->second.getValue(TypeID::C1)
+          << " " << it->second.getValue(TypeID::prefitC);
+   }
+   return oss.str();
+}
+
+
+class ProcessingPipeline_T
+{
+public:
+   ProcessingPipeline_T()
+         : first(1), second(2), third(3), dropper(7)
+   {
+      serial.push_back(first);
+      serial.push_back(dropper);
+      serial.push_back(second);
+      serial.push_back(third);
+   }
+
+      /// The output of the synchronous chain, one line per epoch.
+   std::vector<std::string> reference(int count)
+   {
+      std::vector<std::string> out;
+      for (int i = 0; i < count; i++)
+      {
+         gnssRinex gRin(makeEpoch(i));
+         try
+         {
+            serial.Process(gRin);
+            out.push_back(summary(gRin));
+         }
+         catch (DecimateEpoch& d)
+         {
+            out.push_back("dropped");
+         }
+      }
+      return out;
+   }
+
+      /// Stages of the pipeline, the same objects as the serial chain.
+   void addStages(ProcessingPipeline& pipe)
+   {
+      modelling = ProcessingList();
+      modelling.push_back(first);
+      modelling.push_back(dropper);
+      pipe.addStage(modelling);
+      pipe.addStage(second);
+      pipe.addStage(third);
+   }
+
+      /// Feed and drain from one thread with exchange().
+   int exchangeTest()
+   {
+      TUDEF("ProcessingPipeline", "exchange");
+      const int count = 500;
+      std::vector<std::string> expected(reference(count)), out;
+
+      ProcessingPipeline pipe(4);
+      addStages(pipe);
+      TUASSERTE(int, 3, pipe.getNumStages());
+
+      for (int i = 0; i < count; i++)
+      {
+         gnssRinex gRin(makeEpoch(i));
+         try
+         {
+            if (pipe.exchange(gRin))
+               out.push_back(summary(gRin));
+         }
+         catch (DecimateEpoch& d)
+         {
+            out.push_back("dropped");
+         }
+         TUASSERT(pipe.getNumInFlight() <= pipe.getDepth());
+      }
+
+      TUCSM("pop");
+      pipe.finish();
+      gnssRinex gRin;
+      while (true)
+      {
+         try
+         {
+            if (!pipe.pop(gRin))
+               break;
+            out.push_back(summary(gRin));
+         }
+         catch (DecimateEpoch& d)
+         {
+            out.push_back("dropped");
+         }
+      }
+      TUASSERT(!pipe.isRunning());
+      TUASSERTE(int, 0, pipe.getNumInFlight());
+
+      TUASSERTE(size_t, expected.size(), out.size());
+      TUASSERT(out == expected);
+      TURETURN();
+   }
+
+      /// Feed from a producer thread and drain from this one.
+   int threadTest()
+   {
+      TUDEF("ProcessingPipeline", "push");
+      const int count = 5000;
+      std::vector<std::string> expected(reference(count)), out;
+
+      ProcessingPipeline pipe(8);
+      addStages(pipe);
+      pipe.start();
+
+      std::thread producer([&pipe, count]()
+         {
+            for (int i = 0; i < count; i++)
+            {
+               gnssRinex gRin(makeEpoch(i));
+               pipe.push(gRin);
+            }
+            pipe.finish();
+         });
+
+      gnssRinex gRin;
+      while (true)
+      {
+         try
+         {
+            if (!pipe.pop(gRin))
+               break;
+            out.push_back(summary(gRin));
+         }
+         catch (DecimateEpoch& d)
+         {
+            out.push_back("dropped");
+         }
+      }
+      producer.join();
+
+      TUASSERTE(size_t, expected.size(), out.size());
+      TUASSERT(out == expected);
+      TURETURN();
+   }
+
+      /// A pipeline destroyed before it is drained stops its threads.
+   int abandonTest()
+   {
+      TUDEF("ProcessingPipeline", "~ProcessingPipeline");
+      {
+         ProcessingPipeline pipe(4);
+         addStages(pipe);
+         for (int i = 1; i < 4; i++)
+         {
+            gnssRinex gRin(makeEpoch(i));
+            pipe.push(gRin);
+         }
+         TUASSERT(pipe.isRunning());
+      }
+      TUPASS("destroyed");
+
+      TUCSM("addStage");
+      ProcessingPipeline pipe(2);
+      addStages(pipe);
+      pipe.start();
+      try
+      {
+         pipe.addStage(first);
+         TUFAIL("addStage did not throw on a running pipeline");
+      }
+      catch (ProcessingException& e)
+      {
+         TUPASS("addStage threw");
+      }
+      pipe.finish();
+      gnssRinex gRin;
+      TUASSERT(!pipe.pop(gRin));
+      TURETURN();
+   }
+
+private:
+   DigitStage first, second, third;
+   DropStage dropper;
+   ProcessingList serial, modelling;
+};
+
+
+int main()
+{
+   int errorTotal = 0;
+
+   {
+      ProcessingPipeline_T testClass;
+      errorTotal += testClass.exchangeTest();
+   }
+   {
+      ProcessingPipeline_T testClass;
+      errorTotal += testClass.threadTest();
+   }
+   {
+      ProcessingPipeline_T testClass;
+      errorTotal += testClass.abandonTest();
+   }
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,300 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "SatContextStore.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "SunPosition.hpp"
+#include "ComputeSatPCenter.hpp"
+#include "AntexReader.hpp"
+#include "CivilTime.hpp"
+#include <iostream>
+#include <atomic>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// Ephemeris store counting the calls to the store it wraps.
+class CountingStore : public XvtStore<SatID>
+{
+public:
+   CountingStore(XvtStore<SatID>& ephem) : store(ephem), calls(0) {}
+
+   virtual Xvt getXvt(const SatID& sat, const CommonTime& t) const
+   { calls++; return store.getXvt(sat, t); }
+
+   virtual void dump(std::ostream& s = std::cout, short detail = 0) const
+   { store.dump(s, detail); }
+
+   virtual void edit(const CommonTime& tmin,
+                     const CommonTime& tmax = CommonTime::END_OF_TIME)
+   { store.edit(tmin, tmax); }
+
+   virtual void clear(void)
+   { store.clear(); }
+
+   virtual TimeSystem getTimeSystem(void) const
+   { return store.getTimeSystem(); }
+
+   virtual CommonTime getInitialTime(void) const
+   { return store.getInitialTime(); }
+
+   virtual CommonTime getFinalTime(void) const
+   { return store.getFinalTime(); }
+
+   virtual bool hasVelocity(void) const
+   { return store.hasVelocity(); }
+
+   virtual bool isPresent(const SatID& sat) const
+   { return store.isPresent(sat); }
+
+   XvtStore<SatID>& store;
+   mutable std::atomic<int> calls;
+};
+
+
+class SatContextStore_T
+{
+public:
+   SatContextStore_T()
+         : epoch(CivilTime(2015, 7, 19, 12, 0, 0.0, TimeSystem::GPS))
+   {
+      sp3.loadFile(getPathData() + getFileSep() +
+                   "test_input_sp3_nav_2015_200.sp3");
+      for(int prn = 1; prn <= 5; prn++)
+         sats.insert(SatID(prn, SatID::systemGPS));
+   }
+
+
+      /// Transmit time of the signal received at 'epoch' by station k.
+   CommonTime transmitTime(int k) const
+   { return epoch - (0.067 + 0.003*k); }
+
+
+      /** By default, getXvt() passes straight through to the wrapped
+       * store, and fill() caches nothing. */
+   int exactTest(void)
+   {
+      TUDEF("SatContextStore", "getXvt");
+
+      CountingStore counter(sp3);
+      SatContextStore context(counter);
+      TUASSERTE(double, 0.0, context.getGrid());
+
+      for(int pass = 0; pass < 2; pass++)
+      {
+         for(int k = 0; k < 4; k++)
+         {
+            CommonTime t(transmitTime(k));
+            for(SatIDSet::const_iterator it = sats.begin();
+                it != sats.end(); ++it)
+            {
+               Xvt exp(sp3.getXvt(*it, t)), got(context.getXvt(*it, t));
+               for(int i = 0; i < 3; i++)
+               {
+                  TUASSERTE(double, exp.x[i], got.x[i]);
+                  TUASSERTE(double, exp.v[i], got.v[i]);
+               }
+               TUASSERTE(double, exp.clkbias, got.clkbias);
+               TUASSERTE(double, exp.clkdrift, got.clkdrift);
+            }
+         }
+            // nothing is cached, so every lookup reaches the wrapped store
+         TUASSERTE(int, (pass+1)*4*static_cast<int>(sats.size()),
+                   counter.calls);
+      }
+
+      int calls(counter.calls);
+      context.fill(transmitTime(0), sats, 4);
+      TUASSERTE(int, calls, counter.calls);
+
+      TURETURN();
+   }
+
+
+      /** With a grid, the transmit times of all stations share one
+       * evaluation, and the extrapolated states stay close to the exact
+       * ones. */
+   int gridTest(void)
+   {
+      TUDEF("SatContextStore", "getXvt");
+
+      CountingStore counter(sp3);
+      SatContextStore context(counter, 0.1);
+      TUASSERTE(double, 0.1, context.getGrid());
+
+      for(int k = 0; k < 4; k++)
+      {
+         CommonTime t(transmitTime(k));
+         for(SatIDSet::const_iterator it = sats.begin();
+             it != sats.end(); ++it)
+         {
+            Xvt exp(sp3.getXvt(*it, t)), got(context.getXvt(*it, t));
+            TUASSERTFEPS(0.0, range(exp.x, got.x), 1.e-3);
+            TUASSERTFEPS(0.0, range(exp.v, got.v), 1.e-4);
+         }
+      }
+      TUASSERTE(int, static_cast<int>(sats.size()), counter.calls);
+
+         // setting the grid discards the cached states
+      context.setGrid(0.0);
+      CommonTime t(transmitTime(1));
+      SatID sat(*sats.begin());
+      Xvt exp(sp3.getXvt(sat, t)), got(context.getXvt(sat, t));
+      TUASSERTE(double, exp.x[0], got.x[0]);
+
+      TURETURN();
+   }
+
+
+      /** States evaluated by several threads are those evaluated one by
+       * one, and later lookups only read the cache. */
+   int fillTest(void)
+   {
+      TUDEF("SatContextStore", "fill");
+
+      CountingStore counter(sp3);
+      SatContextStore context(counter, 0.1), serial(sp3, 0.1);
+      SatIDSet withMissing(sats);
+      withMissing.insert(SatID(3, SatID::systemGlonass));
+
+      context.fill(transmitTime(0), withMissing, 4);
+      int filled(counter.calls);
+      TUASSERTE(int, static_cast<int>(withMissing.size()), filled);
+
+      for(int k = 0; k < 4; k++)
+      {
+         CommonTime t(transmitTime(k));
+         for(SatIDSet::const_iterator it = sats.begin();
+             it != sats.end(); ++it)
+         {
+            Xvt exp(serial.getXvt(*it, t)), got(context.getXvt(*it, t));
+            for(int i = 0; i < 3; i++)
+               TUASSERTE(double, exp.x[i], got.x[i]);
+         }
+      }
+      TUASSERTE(int, filled, counter.calls);
+
+      TURETURN();
+   }
+
+
+      /** The Sun position helper used by the processing objects takes the
+       * shared position when there is a context, and computes it when
+       * there is none; both are the same. */
+   int sunTest(void)
+   {
+      TUDEF("SatContextStore", "getSunPosition");
+
+      SatContextStore context(sp3);
+      SunPosition sunPosition;
+      Triple exp(sunPosition.getPosition(epoch));
+      Triple alone(SatContextStore::getSunPosition(NULL, epoch));
+      Triple shared(SatContextStore::getSunPosition(&context, epoch));
+      Triple cached(context.getSunPosition(epoch));
+      for(int i = 0; i < 3; i++)
+      {
+         TUASSERTE(double, exp[i], alone[i]);
+         TUASSERTE(double, exp[i], shared[i]);
+         TUASSERTE(double, exp[i], cached[i]);
+      }
+
+      TURETURN();
+   }
+
+
+      /** A processing object gives the same results with and without a
+       * shared context. */
+   int processTest(void)
+   {
+      TUDEF("SatContextStore", "ComputeSatPCenter");
+
+      AntexReader antexReader(getPathData() + getFileSep() +
+                              "test_input_antex_sats.atx");
+      Position nominalPos(4833520.3800, 41536.8300, 4147461.2800);
+      SatContextStore context(sp3);
+      ComputeSatPCenter alone(sp3, nominalPos, antexReader);
+      ComputeSatPCenter shared(context, nominalPos, antexReader);
+      shared.setSatContext(context);
+
+      satTypeValueMap gAlone, gShared;
+      gAlone[SatID(1, SatID::systemGPS)][TypeID::C1] = 0.0;
+      gAlone[SatID(2, SatID::systemGPS)][TypeID::C1] = 0.0;
+      gShared = gAlone;
+
+      alone.Process(epoch, gAlone);
+      shared.Process(epoch, gShared);
+      TUASSERTE(size_t, 2, gShared.size());
+      for(satTypeValueMap::const_iterator it = gAlone.begin();
+          it != gAlone.end(); ++it)
+      {
+         TUASSERTE(double, it->second.getValue(TypeID::satPCenter),
+                   gShared.getValue(it->first, TypeID::satPCenter));
+      }
+
+      TURETURN();
+   }
+
+private:
+
+      /// Distance between two Triples.
+   static double range(const Triple& a, const Triple& b)
+   { return (a-b).mag(); }
+
+   SP3EphemerisStore sp3;
+   SatIDSet sats;
+   CommonTime epoch;
+};
+
+
+int main()
+{
+   int errorTotal = 0;
+   SatContextStore_T testClass;
+
+   errorTotal += testClass.exactTest();
+   errorTotal += testClass.gridTest();
+   errorTotal += testClass.fillTest();
+   errorTotal += testClass.sunTest();
+   errorTotal += testClass.processTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
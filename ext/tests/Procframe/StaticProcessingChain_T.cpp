@@ -0,0 +1,284 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "StaticProcessingChain.hpp"
+#include "ProcessingList.hpp"
+#include "RinexObsStream.hpp"
+#include "SimpleFilter.hpp"
+#include "ComputeLC.hpp"
+#include "ComputePC.hpp"
+#include "ComputeMelbourneWubbena.hpp"
+#include "ComputeTropModel.hpp"
+#include "ComputeSimpleWeights.hpp"
+#include "SimpleTropModel.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Stage that gives an elevation to the satellites, except to every
+   /// fifth PRN, which the troposphere and weight stages then reject.
+class ElevationStage : public ProcessingClass
+{
+public:
+   virtual gnssSatTypeValue& Process(gnssSatTypeValue& gData)
+   { Process(gData.body); return gData; }
+
+   virtual gnssRinex& Process(gnssRinex& gData)
+   { Process(gData.body); return gData; }
+
+   virtual std::string getClassName(void) const
+   { return "ElevationStage"; }
+
+private:
+   void Process(satTypeValueMap& body)
+   {
+      for (satTypeValueMap::iterator it = body.begin(); it != body.end(); ++it)
+         if (it->first.id % 5 != 0)
+            it->second[TypeID::elevation] = 10.0 + 2.0*it->first.id;
+   }
+};
+
+
+   /// Troposphere model that fails for elevations below 30 degrees, i.e.
+   /// for the PRNs below 10 given an elevation by ElevationStage.
+class LowElevationTropModel : public SimpleTropModel
+{
+public:
+   virtual double correction(double elevation) const
+      throw(InvalidTropModel)
+   {
+      if (elevation < 30.0)
+      {
+         InvalidTropModel e("Elevation too low");
+         GPSTK_THROW(e);
+      }
+      return SimpleTropModel::correction(elevation);
+   }
+};
+
+
+   /// All the values of an epoch, one satellite per line.
+string summary(const satTypeValueMap& body)
+{
+   ostringstream oss;
+   oss << setprecision(17);
+   for (satTypeValueMap::const_iterator it = body.begin();
+        it != body.end(); ++it)
+   {
+      oss << it->first;
+      for (typeValueMap::const_iterator tv = it->second.begin();
+           tv != it->second.end(); ++tv)
+         oss << " " << tv->first << " " << tv->second;
+      oss << endl;
+   }
+   return oss.str();
+}
+
+
+class StaticProcessingChain_T
+{
+public:
+   StaticProcessingChain_T()
+         : filter(TypeID::C1), trop(tropModel)
+   {
+      obsFile = getPathData() + getFileSep() + "arlm200a.15o";
+      list.push_back(filter);
+      list.push_back(elevation);
+      list.push_back(lc);
+      list.push_back(pc);
+      list.push_back(mw);
+      list.push_back(trop);
+      list.push_back(weights);
+   }
+
+      /** Which classes are fused into satellite loops. */
+   int traitsTest(void)
+   {
+      TUDEF("StaticProcessingChain", "isSatelliteLocal");
+      TUASSERT(isSatelliteLocal<ComputeLC>::value);
+      TUASSERT(isSatelliteLocal<ComputePC>::value);
+      TUASSERT(isSatelliteLocal<ComputeMelbourneWubbena>::value);
+      TUASSERT(isSatelliteLocal<ComputeTropModel>::value);
+      TUASSERT(isSatelliteLocal<ComputeSimpleWeights>::value);
+      TUASSERT(!isSatelliteLocal<SimpleFilter>::value);
+      TUASSERT(!isSatelliteLocal<ElevationStage>::value);
+      TUASSERT(!isSatelliteLocal<ProcessingList>::value);
+      TUASSERTE(int, 7, Chain::size());
+      TURETURN();
+   }
+
+      /** A chain of real processing classes, two applied on their own
+       * and five in one satellite loop, gives the same results as a
+       * ProcessingList of the same objects, epoch by epoch. */
+   int rinexTest(void)
+   {
+      TUDEF("StaticProcessingChain", "Process");
+      Chain chain(filter, elevation, lc, pc, mw, trop, weights);
+
+      RinexObsStream rin(obsFile.c_str());
+      gnssRinex gRin;
+      int epochs = 0, rejected = 0, kept = 0;
+      while (rin >> gRin)
+      {
+         gnssRinex byList(gRin), byChain(gRin);
+         byList >> list;
+         byChain >> chain;
+         TUASSERTE(string, summary(byList.body), summary(byChain.body));
+         TUASSERTE(CommonTime, byList.header.epoch, byChain.header.epoch);
+         rejected += gRin.body.size() - byChain.body.size();
+         kept += byChain.body.size();
+         epochs++;
+      }
+      TUASSERT(epochs > 100);
+         // both paths of the chain were taken
+      TUASSERT(rejected > 0);
+      TUASSERT(kept > 0);
+      TURETURN();
+   }
+
+      /** The same holds for gnssSatTypeValue data, for a chain built by
+       * makeStaticChain(), and for a chain that is itself an element of
+       * a ProcessingList. */
+   int nestedTest(void)
+   {
+      TUDEF("StaticProcessingChain", "makeStaticChain");
+      StaticProcessingChain<ComputeLC, ComputePC, ComputeMelbourneWubbena,
+                            ComputeTropModel, ComputeSimpleWeights>
+         tail( makeStaticChain(lc, pc, mw, trop, weights) );
+      ProcessingList outer;
+      outer.push_back(filter);
+      outer.push_back(elevation);
+      outer.push_back(tail);
+
+      RinexObsStream rin(obsFile.c_str());
+      gnssRinex gRin;
+      int epochs = 0;
+      while (rin >> gRin && epochs < 20)
+      {
+         gnssSatTypeValue byList(gRin), byChain(gRin);
+         byList >> list;
+         byChain >> outer;
+         TUASSERTE(string, summary(byList.body), summary(byChain.body));
+         epochs++;
+      }
+      TUASSERTE(int, 20, epochs);
+      TURETURN();
+   }
+
+      /** When the model fails for some satellites of an epoch, the
+       * batch Process() of ComputeTropModel, used by the ProcessingList,
+       * only rejects those satellites, as the per-satellite path of the
+       * chain does. */
+   int invalidModelTest(void)
+   {
+      TUDEF("StaticProcessingChain", "Process");
+      LowElevationTropModel lowModel;
+      ComputeTropModel lowTrop(lowModel);
+      ProcessingList lowList;
+      lowList.push_back(filter);
+      lowList.push_back(elevation);
+      lowList.push_back(lowTrop);
+      StaticProcessingChain<SimpleFilter, ElevationStage, ComputeTropModel>
+         lowChain(filter, elevation, lowTrop);
+
+      RinexObsStream rin(obsFile.c_str());
+      gnssRinex gRin;
+      int epochs = 0, failing = 0, kept = 0;
+      while (rin >> gRin && epochs < 50)
+      {
+         gnssRinex byList(gRin), byChain(gRin);
+         byList >> lowList;
+         byChain >> lowChain;
+         TUASSERTE(string, summary(byList.body), summary(byChain.body));
+         for (satTypeValueMap::const_iterator it = gRin.body.begin();
+              it != gRin.body.end(); ++it)
+         {
+            bool low(it->first.id < 10);
+            if (low && it->first.id % 5 != 0)
+               failing++;
+            if (!low && it->first.id % 5 != 0 &&
+                byList.body.find(it->first) != byList.body.end())
+               kept++;
+               // the satellites the model fails for are rejected
+            if (low)
+               TUASSERT(byList.body.find(it->first) == byList.body.end());
+         }
+         epochs++;
+      }
+      TUASSERTE(int, 50, epochs);
+         // epochs mixing failing and valid satellites were seen
+      TUASSERT(failing > 0);
+      TUASSERT(kept > 0);
+      TURETURN();
+   }
+
+private:
+   typedef StaticProcessingChain<SimpleFilter, ElevationStage, ComputeLC,
+                                 ComputePC, ComputeMelbourneWubbena,
+                                 ComputeTropModel, ComputeSimpleWeights> Chain;
+
+   string obsFile;
+   SimpleFilter filter;
+   ElevationStage elevation;
+   ComputeLC lc;
+   ComputePC pc;
+   ComputeMelbourneWubbena mw;
+   SimpleTropModel tropModel;
+   ComputeTropModel trop;
+   ComputeSimpleWeights weights;
+   ProcessingList list;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   StaticProcessingChain_T testClass;
+
+   errorTotal += testClass.traitsTest();
+   errorTotal += testClass.rinexTest();
+   errorTotal += testClass.nestedTest();
+   errorTotal += testClass.invalidModelTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
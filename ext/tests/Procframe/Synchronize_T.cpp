@@ -0,0 +1,475 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include "Synchronize.hpp"
+#include "NetworkObsStreams.hpp"
+#include "CivilTime.hpp"
+#include "GNSSconstants.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// Synchronize with access to its ring buffer.
+class RingSynchronize : public Synchronize
+{
+public:
+   RingSynchronize(RinexObsStream& rinexObs, gnssRinex& roverData,
+                   const double tol = 1.0)
+         : Synchronize(rinexObs, roverData, tol)
+   {}
+
+   gnssRinex& at(size_t i)
+   { return ringAt(i); }
+
+   void pop(void)
+   { ringPop(); }
+};
+
+
+   /// A RINEX 2.11 header line, with its label at column 61.
+string headerLine(const string& content, const string& label)
+{
+   string line(content);
+   line.resize(60, ' ');
+   return line + label + "\n";
+}
+
+
+   /** Pseudorange of a satellite at t seconds into the day, linear in
+    * time so that it interpolates exactly. 'station' tells the rover
+    * (1) and the reference (0) apart. */
+double rangeC1(int station, int prn, double t)
+{ return 2.0e7 + 1.0e6*station + 1000.0*prn + 10.0*t; }
+
+
+   /** Phase of a satellite at t seconds into the day, in cycles,
+    * quadratic in time so that interpolated values differ from it. */
+double phaseL1(int station, int prn, double t)
+{ return 1.0e7*prn + 1.0e6*station + 0.01*t*t; }
+
+
+   /** Writes a RINEX 2.11 observation file of C1 and L1 with epochs every
+    * 'interval' seconds from 2015/07/19 00:00:00 to 'last' seconds.
+    * G01 and G02 are at every epoch; for the reference (station 0), G03
+    * is only at 60 s, and G01 loses lock at 60 s, with signal strength 5
+    * there and 7 elsewhere. */
+void writeObsFile(const string& fn, const string& marker, int station,
+                  int interval, int last)
+{
+   ofstream out(fn.c_str(), ios::out | ios::trunc);
+   out << headerLine("     2.11           OBSERVATION DATA    G (GPS)",
+                     "RINEX VERSION / TYPE")
+       << headerLine("Synchronize_T       GPSTk               20151018",
+                     "PGM / RUN BY / DATE")
+       << headerLine(marker, "MARKER NAME")
+       << headerLine("", "OBSERVER / AGENCY")
+       << headerLine("                    RECEIVER            1",
+                     "REC # / TYPE / VERS")
+       << headerLine("                    ANTENNA", "ANT # / TYPE")
+       << headerLine("        0.0000        0.0000        0.0000",
+                     "APPROX POSITION XYZ")
+       << headerLine("        0.0000        0.0000        0.0000",
+                     "ANTENNA: DELTA H/E/N")
+       << headerLine("     1     1", "WAVELENGTH FACT L1/2")
+       << headerLine("     2    C1    L1", "# / TYPES OF OBSERV")
+       << headerLine("  2015     7    19     0     0    0.0000000     GPS",
+                     "TIME OF FIRST OBS")
+       << headerLine("", "END OF HEADER");
+
+   char buf[100];
+   for (int t = 0; t <= last; t += interval)
+   {
+      vector<int> prns;
+      prns.push_back(1);
+      prns.push_back(2);
+      if (station == 0 && t == 60)
+         prns.push_back(3);
+
+      sprintf(buf, " 15  7 19 %2d %2d %10.7f  0%3d", t/3600, (t/60)%60,
+              double(t%60), int(prns.size()));
+      out << buf;
+      for (size_t i = 0; i < prns.size(); i++)
+      {
+         sprintf(buf, "G%02d", prns[i]);
+         out << buf;
+      }
+      out << "\n";
+
+      for (size_t i = 0; i < prns.size(); i++)
+      {
+         bool slip(station == 0 && t == 60 && prns[i] == 1);
+         sprintf(buf, "%14.3f %1d%14.3f%1d%1d\n",
+                 rangeC1(station, prns[i], t), 7,
+                 phaseL1(station, prns[i], t), slip ? 1 : 0, slip ? 5 : 7);
+         out << buf;
+      }
+   }
+}
+
+
+class Synchronize_T
+{
+public:
+   Synchronize_T()
+         : first(CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::GPS)),
+           g1(1, SatID::systemGPS), g2(2, SatID::systemGPS),
+           g3(3, SatID::systemGPS)
+   {
+         // one hour of 1 Hz rover data and of 30 s reference data
+      refFile = getPathTestTemp() + getFileSep() + "synchronize_ref.15o";
+      rovFile = getPathTestTemp() + getFileSep() + "synchronize_rov.15o";
+      writeObsFile(refFile, "REF0", 0, 30, 3600);
+      writeObsFile(rovFile, "ROV0", 1, 1, 3600);
+   }
+
+
+      /// A rover epoch t seconds into the day, without data.
+   void roverAt(gnssRinex& gRov, double t)
+   {
+      gRov.header.epoch = first + t;
+      gRov.body.clear();
+   }
+
+
+      /** Synchronizes the reference data with the rover epoch at t
+       * seconds, returning false on SynchronizeException. */
+   bool sync(Synchronize& synchro, gnssRinex& gRov, double t, gnssRinex& gRef)
+   {
+      roverAt(gRov, t);
+      try
+      {
+         gRef >> synchro;
+      }
+      catch (SynchronizeException& e)
+      {
+         return false;
+      }
+      return true;
+   }
+
+
+      /** Rover epochs within tolerance of a reference epoch get that epoch
+       * as it is in the file, with its offset; the others, without
+       * interpolation, raise SynchronizeException. No reference epoch is
+       * read past one within tolerance. */
+   int exactTest(void)
+   {
+      TUDEF("Synchronize", "Process");
+      RinexObsStream rin(refFile.c_str());
+      gnssRinex gRov, gRef;
+      Synchronize synchro(rin, gRov, 1.5);
+      TUASSERTE(double, 1.5, synchro.getTolerance());
+      TUASSERT(!synchro.getInterpolation());
+
+      int matched = 0, failed = 0;
+      for (int t = 0; t <= 120; t++)
+      {
+            // the nearest reference epoch
+         int tref = 30*((t + 15)/30);
+         if (!sync(synchro, gRov, t, gRef))
+         {
+            TUASSERT(abs(t - tref) > 1.5);
+            failed++;
+            continue;
+         }
+         matched++;
+         TUASSERT(abs(t - tref) <= 1.5);
+         TUASSERTE(CommonTime, first + double(tref), gRef.header.epoch);
+         TUASSERTE(double, double(tref - t), synchro.getOffset());
+            // the last epoch read is the one given; the one before it
+            // is kept when the rover epoch is earlier
+         TUASSERTE(double, tref > t ? double(tref - t) : 0.0,
+                   synchro.getLatency());
+         TUASSERTE(int, tref > t ? 2 : 1, synchro.getBufferDepth());
+         TUASSERTE(size_t, tref == 60 ? 3 : 2, gRef.body.size());
+         TUASSERTE(double, rangeC1(0, 2, tref),
+                   gRef.body.getValue(g2, TypeID::C1));
+            // gnssRinex holds phases in meters
+         TUASSERTE(double, phaseL1(0, 1, tref)*L1_WAVELENGTH_GPS,
+                   gRef.body.getValue(g1, TypeID::L1));
+      }
+         // two epochs at 0 s and at 120 s, and three at 30, 60 and 90 s
+      TUASSERTE(int, 13, matched);
+      TUASSERTE(int, 108, failed);
+
+         // a reference epoch just before the rover epoch, within tolerance,
+         // is given without reading the next one (30 s later)
+      RinexObsStream rin2(refFile.c_str());
+      Synchronize early(rin2, gRov, 1.5);
+      TUASSERT(sync(early, gRov, 31.0, gRef));
+      TUASSERTE(CommonTime, first + 30.0, gRef.header.epoch);
+      TUASSERTE(double, -1.0, early.getOffset());
+      TUASSERTE(double, 0.0, early.getLatency());
+      TUASSERTE(int, 1, early.getBufferDepth());
+
+         // the tolerance can't be negative
+      synchro.setTolerance(-1.0);
+      TUASSERTE(double, 1.5, synchro.getTolerance());
+      TURETURN();
+   }
+
+
+      /** With interpolation, rover epochs between reference epochs get
+       * interpolated values, checked against values computed by hand. */
+   int interpolationTest(void)
+   {
+      TUDEF("Synchronize", "Process");
+      RinexObsStream rin(refFile.c_str());
+      gnssRinex gRov, gRef;
+      Synchronize synchro(rin, gRov, 0.5);
+      synchro.setInterpolation(true);
+      TUASSERT(synchro.getInterpolation());
+
+         // 10 s, a third of the way from 0 s to 30 s: C1 is linear, and
+         // L1 of G01 is 1e7 + 0.01*t*t cycles, 0 and 9 cycles above 1e7
+         // at 0 and 30 s
+      TUASSERT(sync(synchro, gRov, 10.0, gRef));
+      TUASSERTE(CommonTime, first + 10.0, gRef.header.epoch);
+      TUASSERTE(double, 0.0, synchro.getOffset());
+      TUASSERTE(double, 20.0, synchro.getLatency());
+      TUASSERTE(size_t, 2, gRef.body.size());
+      TUASSERTFEPS(20001100.0, gRef.body.getValue(g1, TypeID::C1), 1.e-6);
+      TUASSERTFEPS(20002100.0, gRef.body.getValue(g2, TypeID::C1), 1.e-6);
+      TUASSERTFEPS(10000003.0*L1_WAVELENGTH_GPS,
+                   gRef.body.getValue(g1, TypeID::L1), 1.e-6);
+      TUASSERTFEPS(20000003.0*L1_WAVELENGTH_GPS,
+                   gRef.body.getValue(g2, TypeID::L1), 1.e-6);
+
+         // 45 s, halfway from 30 s (9 cycles) to 60 s (36 cycles). G03, only at
+         // 60 s, is left out, and the loss of lock and signal strength of
+         // G01 at 60 s are kept as they are
+      TUASSERT(sync(synchro, gRov, 45.0, gRef));
+      TUASSERTE(double, 15.0, synchro.getLatency());
+      TUASSERTE(size_t, 2, gRef.body.size());
+      TUASSERT(gRef.body.find(g3) == gRef.body.end());
+      TUASSERTFEPS(20001450.0, gRef.body.getValue(g1, TypeID::C1), 1.e-6);
+      TUASSERTFEPS(10000022.5*L1_WAVELENGTH_GPS,
+                   gRef.body.getValue(g1, TypeID::L1), 1.e-6);
+      TUASSERTE(double, 1.0, gRef.body.getValue(g1, TypeID::LLI1));
+      TUASSERTE(double, 5.0, gRef.body.getValue(g1, TypeID::SSI1));
+      TUASSERTE(double, 0.0, gRef.body.getValue(g2, TypeID::LLI1));
+      TUASSERTE(double, 7.0, gRef.body.getValue(g2, TypeID::SSI1));
+
+         // epochs within tolerance are not interpolated
+      TUASSERT(sync(synchro, gRov, 60.25, gRef));
+      TUASSERTE(CommonTime, first + 60.0, gRef.header.epoch);
+      TUASSERTE(double, -0.25, synchro.getOffset());
+      TUASSERTE(size_t, 3, gRef.body.size());
+
+         // nor are those between epochs further apart than the gap
+      synchro.setInterpolation(true, 20.0);
+      TUASSERT(!sync(synchro, gRov, 70.0, gRef));
+      TURETURN();
+   }
+
+
+      /** Rover epochs after the last reference epoch, beyond tolerance,
+       * raise SynchronizeException, with and without interpolation. */
+   int endTest(void)
+   {
+      TUDEF("Synchronize", "Process");
+      RinexObsStream rin(refFile.c_str());
+      gnssRinex gRov, gRef;
+      Synchronize synchro(rin, gRov, 0.5);
+      synchro.setInterpolation(true);
+
+      TUASSERT(sync(synchro, gRov, 3599.0, gRef));
+      TUASSERT(sync(synchro, gRov, 3600.4, gRef));
+      TUASSERTE(CommonTime, first + 3600.0, gRef.header.epoch);
+
+      roverAt(gRov, 3601.0);
+      try
+      {
+         gRef >> synchro;
+         TUFAIL("Expected SynchronizeException");
+      }
+      catch (SynchronizeException& e)
+      {
+         TUPASS("SynchronizeException");
+      }
+      TUASSERT(!sync(synchro, gRov, 3630.0, gRef));
+      TUASSERT(!sync(synchro, gRov, 7200.0, gRef));
+      TURETURN();
+   }
+
+
+      /** Over a long run, only the reference epochs around the rover
+       * epoch are buffered, and ringAt() follows the ring buffer as it
+       * wraps around. */
+   int bufferTest(void)
+   {
+      TUDEF("Synchronize", "getBufferDepth");
+      RinexObsStream rin(refFile.c_str());
+      gnssRinex gRov, gRef;
+      RingSynchronize synchro(rin, gRov, 0.5);
+      synchro.setInterpolation(true);
+      TUASSERTE(int, 4, synchro.getBufferCapacity());
+      TUASSERTE(int, 0, synchro.getBufferDepth());
+
+      int maxDepth = 0, synced = 0;
+      for (int t = 0; t < 3600; t++)
+      {
+         if (sync(synchro, gRov, t, gRef))
+            synced++;
+         maxDepth = max(maxDepth, synchro.getBufferDepth());
+
+            // the reference epoch at or before the rover epoch, and the
+            // one after it if the rover epoch is not a reference epoch
+         int before = 30*(t/30);
+         TUASSERTE(int, t == before ? 1 : 2, synchro.getBufferDepth());
+         TUASSERTE(CommonTime, first + double(before),
+                   synchro.at(0).header.epoch);
+         if (t != before)
+         {
+            TUASSERTE(CommonTime, first + double(before + 30),
+                      synchro.at(1).header.epoch);
+         }
+      }
+      TUASSERTE(int, 3600, synced);
+      TUASSERTE(int, 2, maxDepth);
+
+         // dropping the oldest epoch leaves the next one first
+      synchro.pop();
+      TUASSERTE(int, 1, synchro.getBufferDepth());
+      TUASSERTE(CommonTime, first + 3600.0, synchro.at(0).header.epoch);
+
+         // two epochs are enough; setting the capacity empties the buffer
+      synchro.setBufferCapacity(1);
+      TUASSERTE(int, 2, synchro.getBufferCapacity());
+      TUASSERTE(int, 0, synchro.getBufferDepth());
+
+         // a smaller buffer wraps around more often, with the same data
+      RinexObsStream rin2(refFile.c_str());
+      RingSynchronize small(rin2, gRov, 0.5);
+      small.setBufferCapacity(2);
+      small.setInterpolation(true);
+      gnssRinex gSmall;
+      for (int t = 0; t < 300; t += 7)
+      {
+         TUASSERT(sync(small, gRov, t, gSmall));
+         TUASSERTE(CommonTime, first + double(t), gSmall.header.epoch);
+         TUASSERTFEPS(rangeC1(0, 1, t), gSmall.body.getValue(g1, TypeID::C1),
+                      1.e-6);
+         TUASSERT(small.getBufferDepth() <= 2);
+      }
+      TURETURN();
+   }
+
+
+      /** NetworkObsStreams synchronizes the reference file with the epochs
+       * of the rover file, swapping the bodies into the gnssDataMap, and
+       * the objects it reuses don't carry data from one epoch to the
+       * next. The sparse file is interpolated, except at its own epochs. */
+   int networkTest(void)
+   {
+      TUDEF("NetworkObsStreams", "readEpochData");
+      NetworkObsStreams network;
+      TUASSERT(network.addRinexObsFile(refFile));
+      TUASSERT(network.addRinexObsFile(rovFile));
+      SourceID ref(network.sourceIDOfRinexObsFile(refFile));
+      SourceID rov(network.sourceIDOfRinexObsFile(rovFile));
+      TUASSERTE(string, "REF0", ref.sourceName);
+      TUASSERTE(string, "ROV0", rov.sourceName);
+      network.setReferenceSource(rov);
+      network.setInterpolation(true);
+         // rover epochs 1 s from a reference epoch are interpolated too
+      network.getSynchronize(ref)->setTolerance(0.5);
+
+      gnssDataMap gdsMap;
+      int epochs = 0;
+      while (network.readEpochData(gdsMap))
+      {
+            // as with addGnssRinex(), one entry per source, at the epoch
+            // of the rover file
+         CommonTime t(first + double(epochs));
+         TUASSERTE(size_t, 2, gdsMap.size());
+         TUASSERTE(size_t, 2, gdsMap.count(t));
+         satTypeValueMap rovData, refData;
+         for (gnssDataMap::const_iterator it = gdsMap.begin();
+              it != gdsMap.end(); ++it)
+         {
+            TUASSERTE(size_t, 1, it->second.size());
+            if (it->second.begin()->first == rov)
+               rovData = it->second.begin()->second;
+            else if (it->second.begin()->first == ref)
+               refData = it->second.begin()->second;
+         }
+
+         TUASSERTE(size_t, 2, rovData.size());
+         TUASSERTE(double, rangeC1(1, 1, epochs),
+                   rovData.getValue(g1, TypeID::C1));
+         TUASSERTE(size_t, epochs == 60 ? 3 : 2, refData.size());
+         TUASSERTFEPS(rangeC1(0, 2, epochs),
+                      refData.getValue(g2, TypeID::C1), 1.e-6);
+
+         Synchronize* synchro(network.getSynchronize(ref));
+         TUASSERT(synchro->getBufferDepth() <= 2);
+         TUASSERTE(double, epochs % 30 ? 30.0 - epochs % 30 : 0.0,
+                   synchro->getLatency());
+         epochs++;
+      }
+      TUASSERTE(int, 3601, epochs);
+      TURETURN();
+   }
+
+
+   CommonTime first;
+   SatID g1, g2, g3;
+   string refFile, rovFile;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   Synchronize_T testClass;
+
+   errorTotal += testClass.exactTest();
+   errorTotal += testClass.interpolationTest();
+   errorTotal += testClass.endTest();
+   errorTotal += testClass.bufferTest();
+   errorTotal += testClass.networkTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,106 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#include "EOPStore.hpp"
+#include "ProductCache.hpp"
+#include "FileUtils.hpp"
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Contents of an EOPStore loaded from an IERS file.
+string loadIERS(const string& fn, int& n)
+{
+   EOPStore store;
+   store.addIERSFile(fn);
+   n = store.size();
+   ostringstream oss;
+   store.dump(1, oss);
+   return oss.str();
+}
+
+
+   /** The EOPs of an IERS file are the same whether they are parsed or
+    * read from the product cache. */
+int cacheTest(void)
+{
+   TUDEF("EOPStore", "addIERSFile");
+   string eopFile = getPathData() + getFileSep() + "test_input_ddbase.eop";
+   string cacheDir = getPathTestTemp() + getFileSep() +
+      "test_output_eop_cache";
+   FileUtils::makeDir(cacheDir, 0755);
+   int nplain, n;
+
+   ProductCache::setDirectory(string());
+   string plain = loadIERS(eopFile, nplain);
+   TUASSERT(nplain > 0);
+
+   ProductCache::setDirectory(cacheDir);
+   string entry = ProductCache::entryFile(eopFile, "iers");
+   std::remove(entry.c_str());
+
+      // miss: the file is parsed and the entry written
+   TUASSERTE(string, plain, loadIERS(eopFile, n));
+   TUASSERTE(int, nplain, n);
+   ifstream in(entry.c_str());
+   TUASSERT(static_cast<bool>(in));
+
+      // hit: the entry is read
+   TUASSERTE(string, plain, loadIERS(eopFile, n));
+   TUASSERTE(int, nplain, n);
+
+   ProductCache::setDirectory(string());
+   TURETURN();
+}
+
+
+int main(void)
+{
+   int errorTotal = 0;
+
+   errorTotal += cacheTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
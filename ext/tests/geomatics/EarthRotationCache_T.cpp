@@ -0,0 +1,149 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <math.h>
+
+#include "EarthRotationCache.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Tolerance of the comparisons with EarthOrientation::ECEFtoInertial()
+static const double eps = 1.e-11;
+
+class EarthRotationCache_T
+{
+public:
+   EarthRotationCache_T()
+   {
+      eo.xp = 0.0349282;
+      eo.yp = 0.4833163;
+      eo.UT1mUTC = -0.072073685;
+      eo.convention = IERSConvention::IERS2010;
+   }
+
+      /** Count the epochs, n epochs every step seconds from t, where
+       * the cached rotation differs from the exact one. */
+   unsigned countWrong(EarthRotationCache& cache, EphTime t, int n,
+                       double step)
+   {
+      unsigned wrong = 0;
+      for(int k=0; k<n; k++) {
+         Matrix<double> exact(eo.ECEFtoInertial(t));
+         Matrix<double> R(cache.ECEFtoInertial(t, eo));
+         double err = 0.0;
+         for(int i=0; i<3; i++)
+            for(int j=0; j<3; j++)
+               err = max(err, fabs(exact(i,j) - R(i,j)));
+         if(err > eps)
+            wrong++;
+         t += step;
+      }
+      return wrong;
+   }
+
+      /** Several threads sharing one cache, each querying its own span
+       * of time, all get the exact rotations to within eps. */
+   int threadsTest(void)
+   {
+      TUDEF("EarthRotationCache", "ECEFtoInertial");
+      EarthRotationCache cache(IERSConvention::IERS2010);
+
+      const int numThreads = 4;
+      vector<unsigned> wrong(numThreads, 0);
+      vector<thread> threads;
+      for(int i=0; i<numThreads; i++) {
+         EphTime t(57000+40*i, 0.0, TimeSystem::UTC);
+         threads.push_back(thread([this, &cache, &wrong, i, t]() {
+            wrong[i] = countWrong(cache, t, 100, 10000.0);
+         }));
+      }
+      for(int i=0; i<numThreads; i++)
+         threads[i].join();
+      for(int i=0; i<numThreads; i++)
+         TUASSERTE(unsigned, 0, wrong[i]);
+
+      TUASSERT(cache.size() > 0);
+      TUASSERT(cache.getMaxError() <= cache.getTolerance());
+      TURETURN();
+   }
+
+      /** A copy has the grid of the original and is then independent
+       * of it. */
+   int copyTest(void)
+   {
+      TUDEF("EarthRotationCache", "EarthRotationCache");
+      EarthRotationCache cache(IERSConvention::IERS2010);
+      EphTime t(57222, 43200.0, TimeSystem::UTC);
+      TUASSERTE(unsigned, 0, countWrong(cache, t, 10, 3600.0));
+      size_t n = cache.size();
+
+      EarthRotationCache copy(cache);
+      TUASSERTE(size_t, n, copy.size());
+      TUASSERTE(double, cache.getStep(), copy.getStep());
+      TUASSERTE(unsigned, 0, countWrong(copy, t, 10, 3600.0));
+      copy.clear();
+      TUASSERTE(size_t, 0, copy.size());
+      TUASSERTE(size_t, n, cache.size());
+
+      TUCSM("operator=");
+      copy = cache;
+      TUASSERTE(size_t, n, copy.size());
+      TUASSERTE(unsigned long, cache.getNumEvaluations(),
+                copy.getNumEvaluations());
+      TURETURN();
+   }
+
+   EarthOrientation eo;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   EarthRotationCache_T testClass;
+
+   errorTotal += testClass.threadsTest();
+   errorTotal += testClass.copyTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
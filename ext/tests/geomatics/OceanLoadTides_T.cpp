@@ -0,0 +1,217 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "OceanLoadTides.hpp"
+
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Tolerance in meters of the comparisons with computeDisplacement(); the
+   /// differences are about 1e-14 m (see OceanLoadTides::computeDisplacements())
+static const double eps = 1.e-12;
+
+class OceanLoadTides_T
+{
+public:
+   OceanLoadTides_T()
+   {
+      blqFile = getPathData() + getFileSep() + "testocean.blq";
+      sites.push_back("ONSALA");
+      sites.push_back("REYKJAVIK");
+   }
+
+      /** Load the test sites from blqFile. */
+   int init(OceanLoadTides& olt)
+   {
+      vector<string> names(sites);
+      return olt.initializeSites(names, blqFile);
+   }
+
+      /** computeDisplacements() for several sites gives the same
+       * displacements as computeDisplacement() for each site. */
+   int sitesTest(void)
+   {
+      TUDEF("OceanLoadTides", "computeDisplacements");
+      OceanLoadTides olt;
+      TUASSERTE(int, 2, init(olt));
+
+      EphTime t(57222, 43200.0, TimeSystem::UTC);
+      for(int k=0; k<3; k++) {
+         vector<Triple> disp = olt.computeDisplacements(sites, t);
+         TUASSERTE(size_t, sites.size(), disp.size());
+         for(size_t i=0; i<sites.size(); i++) {
+            Triple exp = olt.computeDisplacement(sites[i], t);
+            for(int j=0; j<3; j++)
+               TUASSERTFEPS(exp[j], disp[i][j], eps);
+         }
+         t += 3600.0;
+      }
+      TURETURN();
+   }
+
+      /** computeDisplacements() for one site at several times, including
+       * times beyond the harmonics span, gives the same displacements as
+       * computeDisplacement() at each time. */
+   int timesTest(void)
+   {
+      TUDEF("OceanLoadTides", "computeDisplacements");
+      OceanLoadTides olt;
+      TUASSERTE(int, 2, init(olt));
+
+      vector<EphTime> times;
+      EphTime t(57222, 0.0, TimeSystem::UTC);
+      for(int k=0; k<3*96; k++) {
+         times.push_back(t);
+         t += 900.0;
+      }
+      for(size_t i=0; i<sites.size(); i++) {
+         vector<Triple> disp = olt.computeDisplacements(sites[i], times);
+         TUASSERTE(size_t, times.size(), disp.size());
+         for(size_t k=0; k<times.size(); k++) {
+            Triple exp = olt.computeDisplacement(sites[i], times[k]);
+            for(int j=0; j<3; j++)
+               TUASSERTFEPS(exp[j], disp[k][j], eps);
+         }
+      }
+
+      try {
+         olt.computeDisplacements(string("NOWHERE"), times);
+         TUFAIL("Expected an exception for an unknown site");
+      }
+      catch(Exception& e) {
+         TUPASS("Exception for an unknown site");
+      }
+      TURETURN();
+   }
+
+      /** computeDisplacements() stays within eps of computeDisplacement()
+       * whether the harmonics are recomputed at every time (span 0) or
+       * reused over a long span. */
+   int spanTest(void)
+   {
+      TUDEF("OceanLoadTides", "setHarmonicsSpan");
+      const double spans[] = { 0.0, 100.0 };
+      for(int s=0; s<2; s++) {
+         OceanLoadTides olt;
+         TUASSERTE(int, 2, init(olt));
+         olt.setHarmonicsSpan(spans[s]);
+         TUASSERTFE(spans[s], olt.getHarmonicsSpan());
+
+         vector<EphTime> times;
+         EphTime t(57222, 0.0, TimeSystem::UTC);
+         for(int k=0; k<200; k++) {
+            times.push_back(t);
+            t += 43200.0;
+         }
+         for(size_t i=0; i<sites.size(); i++) {
+            vector<Triple> disp = olt.computeDisplacements(sites[i], times);
+            for(size_t k=0; k<times.size(); k++) {
+               Triple exp = olt.computeDisplacement(sites[i], times[k]);
+               for(int j=0; j<3; j++)
+                  TUASSERTFEPS(exp[j], disp[k][j], eps);
+            }
+         }
+      }
+      TURETURN();
+   }
+
+      /** Reloading a site with new coefficients discards the cached
+       * harmonics of the old coefficients. */
+   int reloadTest(void)
+   {
+      TUDEF("OceanLoadTides", "initializeSites");
+      OceanLoadTides olt;
+      TUASSERTE(int, 2, init(olt));
+
+      EphTime t(57222, 43200.0, TimeSystem::UTC);
+      vector<Triple> before = olt.computeDisplacements(sites, t);
+
+         // a file giving ONSALA the coefficients of REYKJAVIK
+      string swapFile = getPathTestTemp() + getFileSep() +
+         "test_output_ocean_swap.blq";
+      ifstream in(blqFile.c_str());
+      ofstream out(swapFile.c_str());
+      string line;
+      bool skip = true;
+      while(getline(in, line)) {
+         if(line.find("REYKJAVIK") != string::npos) {
+            skip = false;
+            line = "  ONSALA";
+         }
+         if(!skip)
+            out << line << endl;
+      }
+      out.close();
+
+      vector<string> names(1, "ONSALA");
+      TUASSERTE(int, 1, olt.initializeSites(names, swapFile));
+
+      vector<Triple> after = olt.computeDisplacements(sites, t);
+      Triple exp = olt.computeDisplacement("ONSALA", t);
+      for(int j=0; j<3; j++) {
+         TUASSERTFEPS(before[1][j], after[0][j], eps);
+         TUASSERTFEPS(exp[j], after[0][j], eps);
+         TUASSERTFEPS(before[1][j], after[1][j], eps);
+      }
+      TURETURN();
+   }
+
+   string blqFile;
+   vector<string> sites;
+};
+
+
+int main(void)
+{
+   int errorTotal = 0;
+   OceanLoadTides_T testClass;
+
+   errorTotal += testClass.sitesTest();
+   errorTotal += testClass.timesTest();
+   errorTotal += testClass.spanTest();
+   errorTotal += testClass.reloadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}